@@ -0,0 +1,263 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_multi.c
+ * @brief     driver tm1637 multi source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_tm1637_multi.h"
+
+/**
+ * @brief shared interface ops
+ */
+static const tm1637_ops_t gc_ops =
+{
+    tm1637_interface_iic_init_ctx,
+    tm1637_interface_iic_deinit_ctx,
+    tm1637_interface_iic_write_cmd_custom_ctx,
+    tm1637_interface_iic_read_cmd_custom_ctx,
+    tm1637_interface_delay_ms_ctx,
+    tm1637_interface_timestamp_us_ctx,
+    tm1637_interface_lock_ctx,
+    tm1637_interface_unlock_ctx,
+};
+
+static tm1637_handle_t gs_handle[TM1637_MULTI_MAX_DISPLAY];        /**< tm1637 handles */
+static uint8_t gs_num = 0;                                         /**< opened display number */
+
+/**
+ * @brief     multi example open one display
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] *ctx points to the bus context
+ * @return    status code
+ *            - 0 success
+ *            - 1 open failed
+ * @note      none
+ */
+static uint8_t a_tm1637_multi_open(tm1637_handle_t *handle, void *ctx)
+{
+    uint8_t res;
+    
+    /* link the shared ops and the bus context */
+    DRIVER_TM1637_LINK_INIT(handle, tm1637_handle_t);
+    DRIVER_TM1637_LINK_OPS(handle, &gc_ops);
+    DRIVER_TM1637_LINK_CTX(handle, ctx);
+    DRIVER_TM1637_LINK_DEBUG_PRINT(handle, tm1637_interface_debug_print);
+    
+    /* tm1637 init */
+    res = tm1637_init(handle);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: init failed.\n");
+        
+        return 1;
+    }
+    
+    /* set default address mode */
+    res = tm1637_set_address_mode(handle, TM1637_MULTI_DEFAULT_ADDRESS_MODE);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: set address mode failed.\n");
+        (void)tm1637_deinit(handle);
+        
+        return 1;
+    }
+    
+    /* disable test mode */
+    res = tm1637_set_test_mode(handle, TM1637_BOOL_FALSE);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: set test mode failed.\n");
+        (void)tm1637_deinit(handle);
+        
+        return 1;
+    }
+    
+    /* set default pulse width */
+    res = tm1637_set_pulse_width(handle, TM1637_MULTI_DEFAULT_PULSE_WIDTH);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: set pulse width failed.\n");
+        (void)tm1637_deinit(handle);
+        
+        return 1;
+    }
+    
+    /* clear segment */
+    res = tm1637_clear_segment(handle);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: clear segment failed.\n");
+        (void)tm1637_deinit(handle);
+        
+        return 1;
+    }
+    
+    /* enable display */
+    res = tm1637_set_display(handle, TM1637_BOOL_TRUE);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: set display failed.\n");
+        (void)tm1637_deinit(handle);
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     multi example init
+ * @param[in] **ctx points to a bus context array, display i is on ctx[i]
+ * @param[in] num is the display number
+ * @return    status code
+ *            - 0 success
+ *            - 1 init failed
+ * @note      every handle shares one const ops table of the interface context hooks
+ */
+uint8_t tm1637_multi_init(void **ctx, uint8_t num)
+{
+    uint8_t i;
+    
+    if ((ctx == NULL) || (num == 0) || (num > TM1637_MULTI_MAX_DISPLAY))
+    {
+        tm1637_interface_debug_print("tm1637: display number is invalid.\n");
+        
+        return 1;
+    }
+    
+    /* open every display */
+    for (i = 0; i < num; i++)
+    {
+        if (a_tm1637_multi_open(&gs_handle[i], ctx[i]) != 0)
+        {
+            tm1637_interface_debug_print("tm1637: display %d open failed.\n", i);
+            
+            /* close the opened ones */
+            while (i != 0)
+            {
+                i--;
+                (void)tm1637_deinit(&gs_handle[i]);
+            }
+            
+            return 1;
+        }
+    }
+    gs_num = num;
+    
+    return 0;
+}
+
+/**
+ * @brief     multi example write
+ * @param[in] index is the display index
+ * @param[in] addr is the start address
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+uint8_t tm1637_multi_write(uint8_t index, uint8_t addr, uint8_t *data, uint8_t len)
+{
+    uint8_t res;
+    
+    if (index >= gs_num)
+    {
+        return 1;
+    }
+    
+    /* write segment */
+    res = tm1637_write_segment(&gs_handle[index], addr, data, len);
+    if (res != 0)
+    {
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief      multi example read
+ * @param[in]  index is the display index
+ * @param[out] *seg points to a seg buffer
+ * @param[out] *k points to a k buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       none
+ */
+uint8_t tm1637_multi_read(uint8_t index, uint8_t *seg, uint8_t *k)
+{
+    uint8_t res;
+    
+    if (index >= gs_num)
+    {
+        return 1;
+    }
+    
+    /* read segment */
+    res = tm1637_read_segment(&gs_handle[index], seg, k);
+    if (res != 0)
+    {
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  multi example deinit
+ * @return status code
+ *         - 0 success
+ *         - 1 deinit failed
+ * @note   none
+ */
+uint8_t tm1637_multi_deinit(void)
+{
+    uint8_t res;
+    uint8_t i;
+    
+    /* deinit every display */
+    res = 0;
+    for (i = 0; i < gs_num; i++)
+    {
+        if (tm1637_deinit(&gs_handle[i]) != 0)
+        {
+            res = 1;
+        }
+    }
+    gs_num = 0;
+    
+    return res;
+}
@@ -0,0 +1,113 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_multi.h
+ * @brief     driver tm1637 multi header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef DRIVER_TM1637_MULTI_H
+#define DRIVER_TM1637_MULTI_H
+
+#include "driver_tm1637_interface.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup tm1637_example_driver tm1637 example driver function
+ * @brief    tm1637 example driver modules
+ * @ingroup  tm1637_driver
+ * @{
+ */
+
+/**
+ * @brief tm1637 multi example default definition
+ */
+#define TM1637_MULTI_MAX_DISPLAY                 16                               /**< 16 displays */
+#define TM1637_MULTI_DEFAULT_ADDRESS_MODE        TM1637_ADDRESS_MODE_INC          /**< auto increment 1 mode */
+#define TM1637_MULTI_DEFAULT_PULSE_WIDTH         TM1637_PULSE_WIDTH_14_DIV_16     /**< 14/16 */
+
+/**
+ * @brief     multi example init
+ * @param[in] **ctx points to a bus context array, display i is on ctx[i]
+ * @param[in] num is the display number
+ * @return    status code
+ *            - 0 success
+ *            - 1 init failed
+ * @note      every handle shares one const ops table of the interface context hooks
+ */
+uint8_t tm1637_multi_init(void **ctx, uint8_t num);
+
+/**
+ * @brief  multi example deinit
+ * @return status code
+ *         - 0 success
+ *         - 1 deinit failed
+ * @note   none
+ */
+uint8_t tm1637_multi_deinit(void);
+
+/**
+ * @brief     multi example write
+ * @param[in] index is the display index
+ * @param[in] addr is the start address
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+uint8_t tm1637_multi_write(uint8_t index, uint8_t addr, uint8_t *data, uint8_t len);
+
+/**
+ * @brief      multi example read
+ * @param[in]  index is the display index
+ * @param[out] *seg points to a seg buffer
+ * @param[out] *k points to a k buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       none
+ */
+uint8_t tm1637_multi_read(uint8_t index, uint8_t *seg, uint8_t *k);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -90,6 +90,71 @@ uint8_t tm1637_interface_iic_read_cmd_custom(uint8_t addr, uint8_t *buf, uint16_
     return 0;
 }
 
+/**
+ * @brief  interface parallel port init
+ * @return status code
+ *         - 0 success
+ *         - 1 port init failed
+ * @note   none
+ */
+uint8_t tm1637_interface_parallel_port_init(void)
+{
+    return 0;
+}
+
+/**
+ * @brief  interface parallel port deinit
+ * @return status code
+ *         - 0 success
+ *         - 1 port deinit failed
+ * @note   none
+ */
+uint8_t tm1637_interface_parallel_port_deinit(void)
+{
+    return 0;
+}
+
+/**
+ * @brief     interface parallel clk write
+ * @param[in] level is the clock level
+ * @note      none
+ */
+void tm1637_interface_parallel_clk_write(uint8_t level)
+{
+
+}
+
+/**
+ * @brief     interface parallel dio write
+ * @param[in] mask is the dio pin mask
+ * @param[in] level is the dio pin level
+ * @note      the masked pins are open drain and set in one port write
+ */
+void tm1637_interface_parallel_dio_write(uint32_t mask, uint32_t level)
+{
+
+}
+
+/**
+ * @brief  interface parallel dio read
+ * @return port input level
+ * @note   none
+ */
+uint32_t tm1637_interface_parallel_dio_read(void)
+{
+    return 0;
+}
+
+/**
+ * @brief     interface delay us
+ * @param[in] us
+ * @note      none
+ */
+void tm1637_interface_delay_us(uint32_t us)
+{
+
+}
+
 /**
  * @brief     interface delay ms
  * @param[in] ms
@@ -100,6 +165,140 @@ void tm1637_interface_delay_ms(uint32_t ms)
 
 }
 
+/**
+ * @brief  interface timestamp us
+ * @return free running timestamp in microseconds
+ * @note   the timestamp may wrap around
+ */
+uint32_t tm1637_interface_timestamp_us(void)
+{
+    return 0;
+}
+
+/**
+ * @brief  interface lock
+ * @return status code
+ *         - 0 success
+ *         - 1 lock failed
+ * @note   it waits while another caller holds the bus and fails only when it gives up
+ */
+uint8_t tm1637_interface_lock(void)
+{
+    return 0;
+}
+
+/**
+ * @brief interface unlock
+ * @note  none
+ */
+void tm1637_interface_unlock(void)
+{
+
+}
+
+/**
+ * @brief     interface iic init with context
+ * @param[in] *ctx points to the bus context linked with DRIVER_TM1637_LINK_CTX
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic init failed
+ * @note      ctx tells which bus the handle is on, its meaning is up to the port
+ */
+uint8_t tm1637_interface_iic_init_ctx(void *ctx)
+{
+    return 0;
+}
+
+/**
+ * @brief     interface iic deinit with context
+ * @param[in] *ctx points to the bus context linked with DRIVER_TM1637_LINK_CTX
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic deinit failed
+ * @note      a bus shared by several handles should stay open until the last one closes
+ */
+uint8_t tm1637_interface_iic_deinit_ctx(void *ctx)
+{
+    return 0;
+}
+
+/**
+ * @brief     interface iic write command custom with context
+ * @param[in] *ctx points to the bus context linked with DRIVER_TM1637_LINK_CTX
+ * @param[in] addr is the iic device write address
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic write failed
+ * @note      none
+ */
+uint8_t tm1637_interface_iic_write_cmd_custom_ctx(void *ctx, uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    return 0;
+}
+
+/**
+ * @brief      interface iic read command custom with context
+ * @param[in]  *ctx points to the bus context linked with DRIVER_TM1637_LINK_CTX
+ * @param[in]  addr is the iic device write address
+ * @param[out] *buf points to a data buffer
+ * @param[in]  len is the length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 iic read failed
+ * @note       none
+ */
+uint8_t tm1637_interface_iic_read_cmd_custom_ctx(void *ctx, uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    return 0;
+}
+
+/**
+ * @brief     interface delay ms with context
+ * @param[in] *ctx points to the bus context linked with DRIVER_TM1637_LINK_CTX
+ * @param[in] ms
+ * @note      none
+ */
+void tm1637_interface_delay_ms_ctx(void *ctx, uint32_t ms)
+{
+
+}
+
+/**
+ * @brief     interface timestamp us with context
+ * @param[in] *ctx points to the bus context linked with DRIVER_TM1637_LINK_CTX
+ * @return    free running timestamp in microseconds
+ * @note      the timestamp may wrap around
+ */
+uint32_t tm1637_interface_timestamp_us_ctx(void *ctx)
+{
+    return 0;
+}
+
+/**
+ * @brief     interface lock with context
+ * @param[in] *ctx points to the bus context linked with DRIVER_TM1637_LINK_CTX
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock failed
+ * @note      handles on the same bus share one lock, it waits while another caller holds the bus
+ */
+uint8_t tm1637_interface_lock_ctx(void *ctx)
+{
+    return 0;
+}
+
+/**
+ * @brief     interface unlock with context
+ * @param[in] *ctx points to the bus context linked with DRIVER_TM1637_LINK_CTX
+ * @note      none
+ */
+void tm1637_interface_unlock_ctx(void *ctx)
+{
+
+}
+
 /**
  * @brief     interface print format data
  * @param[in] fmt is the format data
@@ -0,0 +1,397 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      linux_driver_tm1637_interface.c
+ * @brief     linux driver tm1637 interface source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_tm1637_interface.h"
+#include "delay.h"
+#include "gpio.h"
+#include "iic.h"
+#include <stdarg.h>
+#include <pthread.h>
+
+static uint8_t gs_port_user = 0;                                      /**< parallel port user number */
+static pthread_mutex_t gs_port_mutex = PTHREAD_MUTEX_INITIALIZER;     /**< parallel port user number lock */
+
+/**
+ * @brief  interface iic init
+ * @return status code
+ *         - 0 success
+ *         - 1 iic init failed
+ * @note   none
+ */
+uint8_t tm1637_interface_iic_init(void)
+{
+    return iic_init();
+}
+
+/**
+ * @brief  interface iic deinit
+ * @return status code
+ *         - 0 success
+ *         - 1 iic deinit failed
+ * @note   none
+ */
+uint8_t tm1637_interface_iic_deinit(void)
+{
+    return iic_deinit();
+}
+
+/**
+ * @brief     interface iic write command custom
+ * @param[in] addr is the iic device write address
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic write failed
+ * @note      none
+ */
+uint8_t tm1637_interface_iic_write_cmd_custom(uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    return iic_write_cmd(addr, buf, len);
+}
+
+/**
+ * @brief      interface iic read command custom
+ * @param[in]  addr is the iic device write address
+ * @param[out] *buf points to a data buffer
+ * @param[in]  len is the length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 iic read failed
+ * @note       none
+ */
+uint8_t tm1637_interface_iic_read_cmd_custom(uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    return iic_read_cmd(addr, buf, len);
+}
+
+/**
+ * @brief  interface parallel port init
+ * @return status code
+ *         - 0 success
+ *         - 1 port init failed
+ * @note   none
+ */
+uint8_t tm1637_interface_parallel_port_init(void)
+{
+    return gpio_parallel_init();
+}
+
+/**
+ * @brief  interface parallel port deinit
+ * @return status code
+ *         - 0 success
+ *         - 1 port deinit failed
+ * @note   none
+ */
+uint8_t tm1637_interface_parallel_port_deinit(void)
+{
+    return gpio_parallel_deinit();
+}
+
+/**
+ * @brief     interface parallel clk write
+ * @param[in] level is the clock level
+ * @note      none
+ */
+void tm1637_interface_parallel_clk_write(uint8_t level)
+{
+    gpio_parallel_clk_write(level);
+}
+
+/**
+ * @brief     interface parallel dio write
+ * @param[in] mask is the dio pin mask
+ * @param[in] level is the dio pin level
+ * @note      the masked pins are open drain and set in one port write
+ */
+void tm1637_interface_parallel_dio_write(uint32_t mask, uint32_t level)
+{
+    gpio_parallel_dio_write(mask, level);
+}
+
+/**
+ * @brief  interface parallel dio read
+ * @return port input level
+ * @note   none
+ */
+uint32_t tm1637_interface_parallel_dio_read(void)
+{
+    return gpio_parallel_dio_read();
+}
+
+/**
+ * @brief     interface delay us
+ * @param[in] us
+ * @note      none
+ */
+void tm1637_interface_delay_us(uint32_t us)
+{
+    delay_us(us);
+}
+
+/**
+ * @brief     interface delay ms
+ * @param[in] ms
+ * @note      none
+ */
+void tm1637_interface_delay_ms(uint32_t ms)
+{
+    delay_ms(ms);
+}
+
+/**
+ * @brief  interface timestamp us
+ * @return free running timestamp in microseconds
+ * @note   the timestamp may wrap around
+ */
+uint32_t tm1637_interface_timestamp_us(void)
+{
+    return delay_timestamp_us();
+}
+
+/**
+ * @brief  interface lock
+ * @return status code
+ *         - 0 success
+ *         - 1 lock failed
+ * @note   none
+ */
+uint8_t tm1637_interface_lock(void)
+{
+    return iic_lock();
+}
+
+/**
+ * @brief interface unlock
+ * @note  none
+ */
+void tm1637_interface_unlock(void)
+{
+    iic_unlock();
+}
+
+/**
+ * @brief     interface iic init with context
+ * @param[in] *ctx points to the bus context linked with DRIVER_TM1637_LINK_CTX
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic init failed
+ * @note      NULL means the iic port, otherwise ctx points to a uint8_t dio line of the parallel port,
+ *            the user number has its own lock because tm1637_deinit already holds the port lock
+ */
+uint8_t tm1637_interface_iic_init_ctx(void *ctx)
+{
+    if (ctx == NULL)
+    {
+        return iic_init();
+    }
+    
+    /* the first user opens the shared port */
+    (void)pthread_mutex_lock(&gs_port_mutex);
+    if (gs_port_user == 0)
+    {
+        if (gpio_parallel_init() != 0)
+        {
+            (void)pthread_mutex_unlock(&gs_port_mutex);
+            
+            return 1;
+        }
+    }
+    gs_port_user++;
+    (void)pthread_mutex_unlock(&gs_port_mutex);
+    
+    return 0;
+}
+
+/**
+ * @brief     interface iic deinit with context
+ * @param[in] *ctx points to the bus context linked with DRIVER_TM1637_LINK_CTX
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic deinit failed
+ * @note      the last user closes the shared port
+ */
+uint8_t tm1637_interface_iic_deinit_ctx(void *ctx)
+{
+    uint8_t res;
+    
+    if (ctx == NULL)
+    {
+        return iic_deinit();
+    }
+    
+    /* the last user closes the shared port */
+    (void)pthread_mutex_lock(&gs_port_mutex);
+    if (gs_port_user == 0)
+    {
+        (void)pthread_mutex_unlock(&gs_port_mutex);
+        
+        return 1;
+    }
+    gs_port_user--;
+    res = 0;
+    if (gs_port_user == 0)
+    {
+        res = gpio_parallel_deinit();
+    }
+    (void)pthread_mutex_unlock(&gs_port_mutex);
+    
+    return res;
+}
+
+/**
+ * @brief     interface iic write command custom with context
+ * @param[in] *ctx points to the bus context linked with DRIVER_TM1637_LINK_CTX
+ * @param[in] addr is the iic device write address
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic write failed
+ * @note      none
+ */
+uint8_t tm1637_interface_iic_write_cmd_custom_ctx(void *ctx, uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    if (ctx == NULL)
+    {
+        return iic_write_cmd(addr, buf, len);
+    }
+    
+    return gpio_line_write_cmd(*(uint8_t *)ctx, addr, buf, len);
+}
+
+/**
+ * @brief      interface iic read command custom with context
+ * @param[in]  *ctx points to the bus context linked with DRIVER_TM1637_LINK_CTX
+ * @param[in]  addr is the iic device write address
+ * @param[out] *buf points to a data buffer
+ * @param[in]  len is the length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 iic read failed
+ * @note       none
+ */
+uint8_t tm1637_interface_iic_read_cmd_custom_ctx(void *ctx, uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    if (ctx == NULL)
+    {
+        return iic_read_cmd(addr, buf, len);
+    }
+    
+    return gpio_line_read_cmd(*(uint8_t *)ctx, addr, buf, len);
+}
+
+/**
+ * @brief     interface delay ms with context
+ * @param[in] *ctx points to the bus context linked with DRIVER_TM1637_LINK_CTX
+ * @param[in] ms
+ * @note      none
+ */
+void tm1637_interface_delay_ms_ctx(void *ctx, uint32_t ms)
+{
+    (void)ctx;
+    
+    delay_ms(ms);
+}
+
+/**
+ * @brief     interface timestamp us with context
+ * @param[in] *ctx points to the bus context linked with DRIVER_TM1637_LINK_CTX
+ * @return    free running timestamp in microseconds
+ * @note      the timestamp may wrap around
+ */
+uint32_t tm1637_interface_timestamp_us_ctx(void *ctx)
+{
+    (void)ctx;
+    
+    return delay_timestamp_us();
+}
+
+/**
+ * @brief     interface lock with context
+ * @param[in] *ctx points to the bus context linked with DRIVER_TM1637_LINK_CTX
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock failed
+ * @note      every dio line shares the clock, so they share the port lock
+ */
+uint8_t tm1637_interface_lock_ctx(void *ctx)
+{
+    if (ctx == NULL)
+    {
+        return iic_lock();
+    }
+    
+    return gpio_parallel_lock();
+}
+
+/**
+ * @brief     interface unlock with context
+ * @param[in] *ctx points to the bus context linked with DRIVER_TM1637_LINK_CTX
+ * @note      none
+ */
+void tm1637_interface_unlock_ctx(void *ctx)
+{
+    if (ctx == NULL)
+    {
+        iic_unlock();
+    }
+    else
+    {
+        gpio_parallel_unlock();
+    }
+}
+
+/**
+ * @brief     interface print format data
+ * @param[in] fmt is the format data
+ * @note      none
+ */
+void tm1637_interface_debug_print(const char *const fmt, ...)
+{
+    char str[256];
+    uint16_t len;
+    va_list args;
+    
+    memset((char *)str, 0, sizeof(char) * 256); 
+    va_start(args, fmt);
+    vsnprintf((char *)str, 255, (char const *)fmt, args);
+    va_end(args);
+    
+    len = strlen((char *)str);
+    (void)fwrite((uint8_t *)str, 1, len, stdout);
+}
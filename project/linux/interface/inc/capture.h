@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      capture.h
+ * @brief     capture header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup capture capture function
+ * @brief    logic analyzer capture modules
+ * @{
+ */
+
+/**
+ * @brief capture format enumeration definition
+ */
+typedef enum
+{
+    CAPTURE_FORMAT_BINARY = 0x00,        /**< one byte per sample, D0 is CLK and D1 is DIO */
+    CAPTURE_FORMAT_CSV    = 0x01,        /**< one line per sample or per change with a time column */
+} capture_format_t;
+
+/**
+ * @brief capture structure definition
+ */
+typedef struct capture_s
+{
+    const uint8_t *buf;              /**< mapped file */
+    size_t size;                     /**< file size */
+    size_t dropped;                  /**< pages dropped behind the reader */
+    capture_format_t format;         /**< file format */
+    uint64_t rate_hz;                /**< sample rate */
+    uint64_t samples;                /**< read samples or lines */
+    uint64_t end_ns;                 /**< last sample time */
+    uint64_t line;                   /**< line of a csv error */
+} capture_t;
+
+/**
+ * @brief     capture open
+ * @param[in] *capture points to a capture structure
+ * @param[in] *path points to a file path, a .csv file is csv and the others are binary
+ * @param[in] rate_hz is the sample rate, 0 takes the samplerate comment of a csv file
+ * @return    status code
+ *            - 0 success
+ *            - 1 open failed
+ * @note      the file is mapped and read once from the start to the end
+ */
+uint8_t capture_open(capture_t *capture, const char *path, uint64_t rate_hz);
+
+/**
+ * @brief     capture run
+ * @param[in] *capture points to a capture structure
+ * @param[in] *edge points to a callback called at every change of CLK or DIO
+ * @param[in] *ctx points to a callback context
+ * @return    status code
+ *            - 0 success
+ *            - 1 csv line is invalid
+ *            - 4 sample rate is unknown
+ * @note      both lines start high like an idle bus, the pages behind the reader are dropped,
+ *            so a capture of any size runs in constant memory
+ */
+uint8_t capture_run(capture_t *capture, void (*edge)(void *ctx, uint64_t ns, uint8_t clk, uint8_t dio), void *ctx);
+
+/**
+ * @brief     capture close
+ * @param[in] *capture points to a capture structure
+ * @note      none
+ */
+void capture_close(capture_t *capture);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
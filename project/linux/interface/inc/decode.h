@@ -0,0 +1,158 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      decode.h
+ * @brief     decode header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef DECODE_H
+#define DECODE_H
+
+#include "timing.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup decode decode function
+ * @brief    tm1637 bus decode modules
+ * @{
+ */
+
+/**
+ * @brief decode max byte definition
+ */
+#define DECODE_MAX_BYTE        8        /**< command and 6 digits with a spare */
+
+/**
+ * @brief decode flag enumeration definition
+ */
+typedef enum
+{
+    DECODE_FLAG_NACK     = (1 << 0),        /**< the chip did not ack a byte */
+    DECODE_FLAG_PARTIAL  = (1 << 1),        /**< a byte is cut by the stop */
+    DECODE_FLAG_NO_STOP  = (1 << 2),        /**< a start or the end of the capture comes before the stop */
+    DECODE_FLAG_COMMAND  = (1 << 3),        /**< unknown command, data after a command without data or address over 5 */
+    DECODE_FLAG_OVERFLOW = (1 << 4),        /**< more bytes than the record holds */
+    DECODE_FLAG_TIMING   = (1 << 5),        /**< a timing rule fails */
+} decode_flag_t;
+
+/**
+ * @brief decode record structure definition
+ */
+typedef struct decode_record_s
+{
+    uint64_t start_ns;                  /**< start condition */
+    uint64_t end_ns;                    /**< stop condition */
+    uint32_t period_ns;                 /**< shortest clock period */
+    uint32_t bytes;                     /**< received bytes */
+    uint8_t data[DECODE_MAX_BYTE];      /**< command and payload */
+    uint8_t len;                        /**< saved bytes */
+    uint8_t ack;                        /**< ninth bit of each byte, 0 is an ack */
+    uint8_t flags;                      /**< decode flags */
+    uint8_t timing;                     /**< failed timing rule mask */
+} decode_record_t;
+
+/**
+ * @brief decode structure definition
+ */
+typedef struct decode_s
+{
+    timing_t timing;                                                   /**< timing check */
+    void (*record)(void *ctx, const decode_record_t *record);          /**< record callback */
+    void *ctx;                                                         /**< record callback context */
+    decode_record_t current;                                           /**< current record */
+    uint32_t violations[TIMING_RULE_NUM];                              /**< violations at the start */
+    uint64_t rise_ns;                                                  /**< last clock rise */
+    uint64_t records;                                                  /**< finished records */
+    uint64_t flagged;                                                  /**< records with a flag */
+    uint8_t rise_valid;                                                /**< a rise is in the current record */
+    uint8_t clk;                                                       /**< clock level */
+    uint8_t dio;                                                       /**< data level */
+    uint8_t busy;                                                      /**< between a start and a stop */
+    uint8_t bit;                                                       /**< bit index in the byte */
+    uint8_t shift;                                                     /**< shift register */
+    uint8_t sample;                                                    /**< data level at the clock rise */
+    uint8_t sampled;                                                   /**< sample valid flag */
+    uint8_t chip;                                                      /**< the chip drives the current bit */
+    uint8_t handover;                                                  /**< the next data change is driven by the chip */
+    uint8_t fixed;                                                     /**< fixed address mode */
+} decode_t;
+
+/**
+ * @brief     decode init
+ * @param[in] *decode points to a decode structure
+ * @param[in] *limit points to a timing limit structure
+ * @param[in] *record points to a record callback
+ * @param[in] *ctx points to a record callback context
+ * @note      both lines start high like an idle bus
+ */
+void decode_init(decode_t *decode, const timing_limit_t *limit,
+                 void (*record)(void *ctx, const decode_record_t *record), void *ctx);
+
+/**
+ * @brief     decode the lines
+ * @param[in] *decode points to a decode structure
+ * @param[in] ns is the timestamp
+ * @param[in] clk is the clock level
+ * @param[in] dio is the data level
+ * @note      call it at every change, a clock and data change in one sample is taken
+ *            as data before a rise and data after a fall
+ */
+void decode_edge(decode_t *decode, uint64_t ns, uint8_t clk, uint8_t dio);
+
+/**
+ * @brief     decode finish
+ * @param[in] *decode points to a decode structure
+ * @param[in] ns is the end of the capture
+ * @note      an open transaction is flushed with the no stop flag
+ */
+void decode_finish(decode_t *decode, uint64_t ns);
+
+/**
+ * @brief     decode flag name
+ * @param[in] flag is one decode flag
+ * @return    flag name
+ * @note      none
+ */
+const char *decode_flag_name(decode_flag_t flag);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,110 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      delay.h
+ * @brief     delay header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef DELAY_H
+#define DELAY_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup delay delay function
+ * @brief    delay function modules
+ * @{
+ */
+
+/**
+ * @brief     delay us
+ * @param[in] us
+ * @note      none
+ */
+void delay_us(uint32_t us);
+
+/**
+ * @brief     delay ns
+ * @param[in] ns
+ * @note      it spins, the real delay is at least the clock_gettime cost
+ */
+void delay_ns(uint32_t ns);
+
+/**
+ * @brief     delay ms
+ * @param[in] ms
+ * @note      none
+ */
+void delay_ms(uint32_t ms);
+
+/**
+ * @brief  get the timestamp
+ * @return timestamp in microseconds
+ * @note   it wraps around after about 71 minutes
+ */
+uint32_t delay_timestamp_us(void);
+
+/**
+ * @brief  get the timestamp in nanoseconds
+ * @return timestamp in nanoseconds
+ * @note   the virtual clock counts from its start
+ */
+uint64_t delay_timestamp_ns(void);
+
+/**
+ * @brief     start the virtual clock
+ * @param[in] *probe points to a probe function called at each delay ms, it may be NULL
+ * @note      the virtual time starts at 0 and every delay returns at once after moving it,
+ *            only a single thread test may use it because the other threads would see the same clock
+ */
+void delay_virtual_start(void (*probe)(uint32_t us, uint32_t ms));
+
+/**
+ * @brief  stop the virtual clock
+ * @return virtual time in microseconds
+ * @note   none
+ */
+uint64_t delay_virtual_stop(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
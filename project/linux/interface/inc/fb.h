@@ -0,0 +1,251 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      fb.h
+ * @brief     fb header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef FB_H
+#define FB_H
+
+#include "driver_tm1637.h"
+#include <stdatomic.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup fb fb function
+ * @brief    shared framebuffer function modules
+ * @{
+ */
+
+/**
+ * @brief tm1637 fb max display definition
+ */
+#ifndef TM1637_FB_MAX_DISPLAY
+    #define TM1637_FB_MAX_DISPLAY        16          /**< 16 displays */
+#endif
+
+/**
+ * @brief tm1637 fb max retry definition
+ */
+#ifndef TM1637_FB_MAX_RETRY
+    #define TM1637_FB_MAX_RETRY          1024        /**< 1024 times */
+#endif
+
+/**
+ * @brief tm1637 fb stuck poll definition
+ */
+#ifndef TM1637_FB_STUCK_POLL
+    #define TM1637_FB_STUCK_POLL         64          /**< 64 polls */
+#endif
+
+/**
+ * @brief tm1637 fb cache line definition
+ */
+#define TM1637_FB_LINE                   64                  /**< cache line size */
+
+/**
+ * @brief tm1637 fb magic definition
+ */
+#define TM1637_FB_MAGIC                  0x37363146U         /**< "F167" */
+
+/**
+ * @brief tm1637 fb display structure definition
+ * @note  it is padded by hand to one cache line
+ */
+typedef struct tm1637_fb_display_s
+{
+    atomic_uint_least32_t seq;                                                                        /**< sequence counter, odd while a client writes */
+    atomic_uint_least8_t ram[6];                                                                      /**< segment bytes */
+    atomic_uint_least8_t display;                                                                     /**< display bits, bit 3 is on and bit 0 - 2 is the pulse width */
+    uint8_t reserved[TM1637_FB_LINE - sizeof(atomic_uint_least32_t) - 7 * sizeof(atomic_uint_least8_t)];        /**< pad to a cache line */
+} tm1637_fb_display_t;
+
+/**
+ * @brief tm1637 fb structure definition
+ * @note  the header is padded to one cache line, so a page aligned mapping puts every display on its own line
+ */
+typedef struct tm1637_fb_s
+{
+    uint32_t magic;                                                 /**< magic */
+    uint32_t display_num;                                           /**< display number */
+    uint8_t reserved[TM1637_FB_LINE - 2 * sizeof(uint32_t)];        /**< pad to a cache line */
+    tm1637_fb_display_t display[TM1637_FB_MAX_DISPLAY];             /**< displays, one cache line each */
+} tm1637_fb_t;
+
+/**
+ * @brief tm1637 fb daemon structure definition
+ */
+typedef struct tm1637_fb_daemon_s
+{
+    tm1637_fb_t *fb;                                         /**< shared framebuffer */
+    tm1637_handle_t *handle[TM1637_FB_MAX_DISPLAY];          /**< handles owned by the daemon */
+    uint32_t seq[TM1637_FB_MAX_DISPLAY];                     /**< last flushed sequence */
+    uint8_t sent[TM1637_FB_MAX_DISPLAY][6];                  /**< digits sent to each chip */
+    uint8_t sent_display[TM1637_FB_MAX_DISPLAY];             /**< display bits sent to each chip */
+    uint8_t sent_valid[TM1637_FB_MAX_DISPLAY];               /**< sent state valid flag */
+    uint32_t odd_seq[TM1637_FB_MAX_DISPLAY];                 /**< last odd sequence seen by a busy snapshot */
+    uint32_t odd_poll[TM1637_FB_MAX_DISPLAY];                /**< polls the sequence stayed at odd_seq */
+    uint32_t flushed;                                        /**< flushed display counter */
+    uint32_t digits;                                         /**< sent digit counter */
+    uint32_t busy;                                           /**< busy snapshot counter */
+    uint32_t recovered;                                      /**< recovered display counter */
+} tm1637_fb_daemon_t;
+
+/**
+ * @brief     format a framebuffer
+ * @param[in] *fb points to a tm1637 fb structure
+ * @param[in] display_num is the display number
+ * @return    status code
+ *            - 0 success
+ *            - 2 fb is NULL
+ *            - 4 display_num is invalid
+ * @note      the daemon formats the shared memory before any client attaches,
+ *            every display starts blank and on with pulse width 14/16
+ */
+uint8_t tm1637_fb_format(tm1637_fb_t *fb, uint8_t display_num);
+
+/**
+ * @brief     check a framebuffer
+ * @param[in] *fb points to a tm1637 fb structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 fb is NULL
+ *            - 3 fb is not formatted
+ * @note      clients call it once after they map the shared memory
+ */
+uint8_t tm1637_fb_check(tm1637_fb_t *fb);
+
+/**
+ * @brief     write digits to a display
+ * @param[in] *fb points to a tm1637 fb structure
+ * @param[in] display is the display index
+ * @param[in] addr is the start address
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 2 fb or data is NULL
+ *            - 3 fb is not formatted
+ *            - 4 display is invalid or addr + len > 6
+ *            - 5 display is busy or the daemon took the lock back from this write
+ * @note      any process may call it, it only stores to the shared memory and never makes a syscall
+ */
+uint8_t tm1637_fb_write_segment(tm1637_fb_t *fb, uint8_t display, uint8_t addr, uint8_t *data, uint8_t len);
+
+/**
+ * @brief     set the display bits of a display
+ * @param[in] *fb points to a tm1637 fb structure
+ * @param[in] display is the display index
+ * @param[in] enable is a bool value
+ * @param[in] width is the pulse width
+ * @return    status code
+ *            - 0 success
+ *            - 2 fb is NULL
+ *            - 3 fb is not formatted
+ *            - 4 display is invalid
+ *            - 5 display is busy or the daemon took the lock back from this write
+ * @note      any process may call it
+ */
+uint8_t tm1637_fb_set_display(tm1637_fb_t *fb, uint8_t display, tm1637_bool_t enable, tm1637_pulse_width_t width);
+
+/**
+ * @brief      take a consistent snapshot of a display
+ * @param[in]  *fb points to a tm1637 fb structure
+ * @param[in]  display is the display index
+ * @param[out] *ram points to a 6 digits buffer
+ * @param[out] *bits points to a display bits buffer
+ * @param[out] *seq points to a sequence buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 fb is NULL
+ *             - 3 fb is not formatted
+ *             - 4 display is invalid
+ *             - 5 display is busy
+ * @note       none
+ */
+uint8_t tm1637_fb_read(tm1637_fb_t *fb, uint8_t display, uint8_t *ram, uint8_t *bits, uint32_t *seq);
+
+/**
+ * @brief     init the daemon
+ * @param[in] *daemon points to a tm1637 fb daemon structure
+ * @param[in] *fb points to a formatted tm1637 fb structure
+ * @param[in] **handle points to an array of initialized handles, display i is handle[i]
+ * @return    status code
+ *            - 0 success
+ *            - 2 daemon, fb or handle is NULL
+ *            - 3 fb is not formatted or a handle is not inited
+ * @note      every handle must use the auto increment address mode,
+ *            the first poll sends every display
+ */
+uint8_t tm1637_fb_daemon_init(tm1637_fb_daemon_t *daemon, tm1637_fb_t *fb, tm1637_handle_t **handle);
+
+/**
+ * @brief      flush the changed displays
+ * @param[in]  *daemon points to a tm1637 fb daemon structure
+ * @param[out] *flushed points to a flushed display number buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 flush failed
+ *             - 2 daemon is NULL
+ * @note       a display whose sequence did not move costs one load, a changed one sends the
+ *             span of its changed digits and its display bits only when they changed,
+ *             a busy or failed display is retried by the next poll, a sequence which stays at the same
+ *             odd value for TM1637_FB_STUCK_POLL polls belongs to a dead client and is made even again
+ */
+uint8_t tm1637_fb_daemon_poll(tm1637_fb_daemon_t *daemon, uint8_t *flushed);
+
+/**
+ * @brief      get the daemon statistics
+ * @param[in]  *daemon points to a tm1637 fb daemon structure
+ * @param[out] *flushed points to a flushed display counter buffer
+ * @param[out] *digits points to a sent digit counter buffer
+ * @param[out] *busy points to a busy snapshot counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 daemon is NULL
+ * @note       none
+ */
+uint8_t tm1637_fb_daemon_get_statistics(tm1637_fb_daemon_t *daemon, uint32_t *flushed, uint32_t *digits, uint32_t *busy);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
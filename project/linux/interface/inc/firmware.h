@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      firmware.h
+ * @brief     firmware header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef FIRMWARE_H
+#define FIRMWARE_H
+
+#include "driver_tm1637_link.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup firmware firmware function
+ * @brief    stm32 firmware stand-in function modules
+ * @{
+ */
+
+/**
+ * @brief firmware receive buffer length definition
+ */
+#define FIRMWARE_RX_LEN        256        /**< same as the stm32 uart rx buffer */
+
+/**
+ * @brief      firmware start
+ * @param[in]  **ctx points to a bus context array, display i is on ctx[i]
+ * @param[in]  num is the display number
+ * @param[out] *name points to a serial port name buffer
+ * @param[in]  len is the name buffer length
+ * @return     status code
+ *             - 0 success
+ *             - 1 start failed
+ * @note       a thread runs the link server of the stm32 firmware on a pty,
+ *             name is the pty slave a link client opens as its serial port
+ */
+uint8_t firmware_start(void **ctx, uint8_t num, char *name, size_t len);
+
+/**
+ * @brief  firmware stop
+ * @return status code
+ *         - 0 success
+ * @note   like the stm32 firmware the displays are never deinitialized and keep the last frame
+ */
+uint8_t firmware_stop(void);
+
+/**
+ * @brief      firmware get the link server statistics
+ * @param[out] *frames points to a good frame counter buffer
+ * @param[out] *errors points to a bad frame counter buffer
+ * @return     status code
+ *             - 0 success
+ * @note       call it after firmware_stop
+ */
+uint8_t firmware_get_statistics(uint32_t *frames, uint32_t *errors);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,241 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      gpio.h
+ * @brief     gpio header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef GPIO_H
+#define GPIO_H
+
+#include "model.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup gpio gpio function
+ * @brief    simulated gpio function modules
+ * @{
+ */
+
+/**
+ * @brief  gpio parallel port init
+ * @return status code
+ *         - 0 success
+ * @note   CLK is shared and DIO0 - DIO15 each connect to one tm1637 model
+ */
+uint8_t gpio_parallel_init(void);
+
+/**
+ * @brief  gpio parallel port deinit
+ * @return status code
+ *         - 0 success
+ * @note   none
+ */
+uint8_t gpio_parallel_deinit(void);
+
+/**
+ * @brief     gpio parallel clock write
+ * @param[in] level is the clock level
+ * @note      none
+ */
+void gpio_parallel_clk_write(uint8_t level);
+
+/**
+ * @brief     gpio parallel data write
+ * @param[in] mask is the pin mask
+ * @param[in] level is the pin level
+ * @note      all masked pins change in one write
+ */
+void gpio_parallel_dio_write(uint32_t mask, uint32_t level);
+
+/**
+ * @brief  gpio parallel data read
+ * @return port input level
+ * @note   every line is the wired and of the host and the model
+ */
+uint32_t gpio_parallel_dio_read(void);
+
+/**
+ * @brief     gpio line write command
+ * @param[in] line is the dio line
+ * @param[in] addr is the command
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      it talks to the chip on one dio line of the parallel port like the iic port does
+ */
+uint8_t gpio_line_write_cmd(uint8_t line, uint8_t addr, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief      gpio line read command
+ * @param[in]  line is the dio line
+ * @param[in]  addr is the command
+ * @param[out] *buf points to a data buffer
+ * @param[in]  len is the data length
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       it talks to the chip on one dio line of the parallel port like the iic port does
+ */
+uint8_t gpio_line_read_cmd(uint8_t line, uint8_t addr, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief  gpio parallel port lock
+ * @return status code
+ *         - 0 success
+ *         - 1 lock failed
+ * @note   every chip on the port shares the clock, so one transfer at a time,
+ *         it blocks until the holder unlocks
+ */
+uint8_t gpio_parallel_lock(void);
+
+/**
+ * @brief gpio parallel port unlock
+ * @note  none
+ */
+void gpio_parallel_unlock(void);
+
+/**
+ * @brief     gpio parallel model
+ * @param[in] line is the dio line
+ * @return    pointer to the tm1637 model on the line
+ * @note      0 <= line <= 15
+ */
+model_t *gpio_parallel_model(uint8_t line);
+
+/**
+ * @brief gpio bus chain definition
+ */
+#define GPIO_BUS_NUM         8         /**< 8 buses */
+#define GPIO_BUS_LANE        32        /**< 32 chips per bus */
+
+/**
+ * @brief  gpio bus chain init
+ * @return status code
+ *         - 0 success
+ * @note   every bus has its own clock and lanes, so buses run in parallel without a lock
+ */
+uint8_t gpio_bus_init(void);
+
+/**
+ * @brief     gpio bus write segment
+ * @param[in] *ctx points to a uint8_t bus id
+ * @param[in] lane is the chip on the bus
+ * @param[in] addr is the start address
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      it matches the fleet write_segment ops
+ */
+uint8_t gpio_bus_write_segment(void *ctx, uint16_t lane, uint8_t addr, uint8_t *data, uint8_t len);
+
+/**
+ * @brief     gpio bus write display
+ * @param[in] *ctx points to a uint8_t bus id
+ * @param[in] lane is the chip on the bus
+ * @param[in] display is the display bits
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      it matches the fleet write_display ops
+ */
+uint8_t gpio_bus_write_display(void *ctx, uint16_t lane, uint8_t display);
+
+/**
+ * @brief     gpio bus model
+ * @param[in] bus is the bus id
+ * @param[in] lane is the chip on the bus
+ * @return    pointer to the tm1637 model
+ * @note      none
+ */
+model_t *gpio_bus_model(uint8_t bus, uint16_t lane);
+
+/**
+ * @brief  gpio iic port init
+ * @return status code
+ *         - 0 success
+ * @note   SCL and SDA connect to one tm1637 model
+ */
+uint8_t gpio_iic_init(void);
+
+/**
+ * @brief     gpio iic scl write
+ * @param[in] level is the scl level
+ * @note      none
+ */
+void gpio_iic_scl_write(uint8_t level);
+
+/**
+ * @brief     gpio iic sda write
+ * @param[in] level is the sda level
+ * @note      1 releases the line
+ */
+void gpio_iic_sda_write(uint8_t level);
+
+/**
+ * @brief  gpio iic sda read
+ * @return sda level
+ * @note   none
+ */
+uint8_t gpio_iic_sda_read(void);
+
+/**
+ * @brief  gpio iic model
+ * @return pointer to the tm1637 model on the iic port
+ * @note   none
+ */
+model_t *gpio_iic_model(void);
+
+/**
+ * @brief     gpio iic set the probe
+ * @param[in] *probe points to a probe function, NULL removes it
+ * @note      the probe gets the scl, the sda driven by the host and the sda driven by the chip
+ *            after every pin write with read 0 and before every sda read with read 1
+ */
+void gpio_iic_set_probe(void (*probe)(uint8_t read, uint8_t scl, uint8_t sda, uint8_t chip));
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
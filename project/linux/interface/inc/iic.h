@@ -0,0 +1,132 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      iic.h
+ * @brief     iic header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef IIC_H
+#define IIC_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/**
+ * @defgroup iic iic function
+ * @brief    iic function modules
+ * @{
+ */
+
+/**
+ * @brief  iic bus init
+ * @return status code
+ *         - 0 success
+ * @note   SCL and SDA are the simulated iic port
+ */
+uint8_t iic_init(void);
+
+/**
+ * @brief  iic bus deinit
+ * @return status code
+ *         - 0 success
+ * @note   none
+ */
+uint8_t iic_deinit(void);
+
+/**
+ * @brief  iic bus lock
+ * @return status code
+ *         - 0 success
+ *         - 1 lock failed
+ * @note   all devices sharing the SCL and SDA pins should hold this lock for a whole transfer sequence,
+ *         it blocks until the holder unlocks
+ */
+uint8_t iic_lock(void);
+
+/**
+ * @brief iic bus unlock
+ * @note  none
+ */
+void iic_unlock(void);
+
+/**
+ * @brief     iic bus set the timing
+ * @param[in] phase_ns is the start, stop and ack phase
+ * @param[in] bit_ns is the data bit phase
+ * @note      the default is 15us and 10us like the stm32f407 port
+ */
+void iic_set_timing(uint32_t phase_ns, uint32_t bit_ns);
+
+/**
+ * @brief      iic bus get the timing
+ * @param[out] *phase_ns points to a start, stop and ack phase buffer
+ * @param[out] *bit_ns points to a data bit phase buffer
+ * @note       none
+ */
+void iic_get_timing(uint32_t *phase_ns, uint32_t *bit_ns);
+
+/**
+ * @brief     iic bus write command
+ * @param[in] addr is the iic device write address
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      addr = device_address_7bits << 1
+ */
+uint8_t iic_write_cmd(uint8_t addr, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief      iic bus read command
+ * @param[in]  addr is the iic device write address
+ * @param[out] *buf points to a data buffer
+ * @param[in]  len is the length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       addr = device_address_7bits << 1
+ */
+uint8_t iic_read_cmd(uint8_t addr, uint8_t *buf, uint16_t len);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
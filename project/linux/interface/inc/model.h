@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      model.h
+ * @brief     model header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef MODEL_H
+#define MODEL_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup model model function
+ * @brief    tm1637 pin level model modules
+ * @{
+ */
+
+/**
+ * @brief model structure definition
+ */
+typedef struct model_s
+{
+    uint8_t clk;                /**< last clock level */
+    uint8_t dio;                /**< last data level */
+    uint8_t out;                /**< data level driven by the chip, 1 releases the line */
+    uint8_t state;              /**< protocol state */
+    uint8_t bit;                /**< bit counter */
+    uint8_t shift;              /**< shift register */
+    uint8_t index;              /**< byte index in the transaction */
+    uint8_t command;            /**< first byte of the transaction */
+    uint8_t read;               /**< read mode */
+    uint8_t fixed;              /**< fixed address mode */
+    uint8_t test;               /**< test mode */
+    uint8_t addr;               /**< address register */
+    uint8_t display;            /**< display control */
+    uint8_t ram[6];             /**< display ram */
+    uint8_t key;                /**< key scan data, 0xFF means no key */
+    uint8_t ack_enable;         /**< 0 simulates a dropped out chip */
+    uint32_t bytes;             /**< received bytes */
+    uint32_t errors;            /**< protocol errors */
+} model_t;
+
+/**
+ * @brief     model init
+ * @param[in] *model points to a model structure
+ * @note      it is the power on state of the chip
+ */
+void model_init(model_t *model);
+
+/**
+ * @brief     model update
+ * @param[in] *model points to a model structure
+ * @param[in] clk is the clock line level
+ * @param[in] dio is the data line level
+ * @note      call it after every change of the lines
+ */
+void model_update(model_t *model, uint8_t clk, uint8_t dio);
+
+/**
+ * @brief     model data output
+ * @param[in] *model points to a model structure
+ * @return    data level driven by the chip, 1 releases the line
+ * @note      none
+ */
+uint8_t model_dio(model_t *model);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,203 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      pool.h
+ * @brief     pool header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+#include "driver_tm1637_fleet.h"
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup pool pool function
+ * @brief    fleet thread pool function modules
+ * @{
+ */
+
+/**
+ * @brief tm1637 pool max thread definition
+ */
+#ifndef TM1637_POOL_MAX_THREAD
+    #define TM1637_POOL_MAX_THREAD        16        /**< 16 threads */
+#endif
+
+/**
+ * @brief tm1637 pool render chunk definition
+ */
+#ifndef TM1637_POOL_CHUNK
+    #define TM1637_POOL_CHUNK             8         /**< 8 updates per render task */
+#endif
+
+/**
+ * @brief tm1637 pool max task definition
+ */
+#define TM1637_POOL_MAX_TASK        (TM1637_FLEET_MAX_MODULE / TM1637_POOL_CHUNK + 2 * TM1637_FLEET_MAX_BUS)        /**< render and flush tasks of one batch */
+
+/**
+ * @brief tm1637 pool update structure definition
+ */
+typedef struct tm1637_pool_update_s
+{
+    uint16_t module;        /**< module id */
+    uint8_t addr;           /**< start address */
+    uint8_t len;            /**< data length */
+    uint8_t data[6];        /**< digits */
+} tm1637_pool_update_t;
+
+/**
+ * @brief tm1637 pool task structure definition
+ */
+typedef struct tm1637_pool_task_s
+{
+    uint16_t start;        /**< first update in the bus order */
+    uint16_t num;          /**< update number, 0 means a bus flush */
+    uint8_t bus;           /**< bus id */
+} tm1637_pool_task_t;
+
+/**
+ * @brief tm1637 pool worker structure definition
+ */
+typedef struct tm1637_pool_worker_s
+{
+    pthread_t thread;                                  /**< worker thread */
+    pthread_mutex_t mutex;                             /**< queue mutex */
+    uint16_t task[TM1637_POOL_MAX_TASK];               /**< render deque, the owner pops the tail and thieves take the head */
+    uint32_t head;                                     /**< render deque head */
+    uint32_t tail;                                     /**< render deque tail */
+    uint16_t bus_task[TM1637_FLEET_MAX_BUS];           /**< bus queue, only the owner runs it */
+    uint32_t bus_head;                                 /**< bus queue head */
+    uint32_t bus_tail;                                 /**< bus queue tail */
+    uint32_t executed;                                 /**< executed task counter */
+    uint32_t stolen;                                   /**< stolen task counter */
+    struct tm1637_pool_s *pool;                        /**< owner pool */
+    uint8_t index;                                     /**< worker index */
+} tm1637_pool_worker_t;
+
+/**
+ * @brief tm1637 pool structure definition
+ */
+typedef struct tm1637_pool_s
+{
+    tm1637_fleet_t *fleet;                                      /**< fleet */
+    tm1637_pool_worker_t worker[TM1637_POOL_MAX_THREAD];        /**< workers */
+    tm1637_pool_task_t task[TM1637_POOL_MAX_TASK];              /**< tasks of the batch */
+    const tm1637_pool_update_t *update;                         /**< updates of the batch */
+    uint16_t order[TM1637_FLEET_MAX_MODULE];                    /**< updates sorted by bus */
+    uint16_t module[TM1637_FLEET_MAX_MODULE];                   /**< modules sorted by bus */
+    uint16_t module_start[TM1637_FLEET_MAX_BUS + 1];            /**< first module of each bus */
+    uint16_t render[TM1637_FLEET_MAX_BUS];                      /**< pending render tasks of each bus */
+    uint16_t bus_ready[TM1637_POOL_MAX_THREAD];                 /**< queued bus tasks of each worker */
+    uint16_t steal_ready;                                       /**< queued render tasks */
+    uint16_t pending;                                           /**< unfinished tasks */
+    pthread_mutex_t mutex;                                      /**< pool mutex */
+    pthread_cond_t wake;                                        /**< wake the workers */
+    pthread_cond_t done;                                        /**< batch done */
+    uint8_t status;                                             /**< batch status */
+    uint8_t stop;                                               /**< stop flag */
+    uint8_t thread_num;                                         /**< thread number */
+    uint8_t inited;                                             /**< inited flag */
+} tm1637_pool_t;
+
+/**
+ * @brief     start the pool
+ * @param[in] *pool points to a tm1637 pool structure
+ * @param[in] *fleet points to an initialized tm1637 fleet structure
+ * @param[in] thread_num is the worker number
+ * @return    status code
+ *            - 0 success
+ *            - 1 thread create failed
+ *            - 2 pool or fleet is NULL
+ *            - 4 thread_num is invalid
+ * @note      bus b belongs to worker b % thread_num, workers without a bus only steal render work
+ */
+uint8_t tm1637_pool_init(tm1637_pool_t *pool, tm1637_fleet_t *fleet, uint8_t thread_num);
+
+/**
+ * @brief     update many modules and flush every bus
+ * @param[in] *pool points to a tm1637 pool structure
+ * @param[in] *update points to an update array
+ * @param[in] num is the update number
+ * @return    status code
+ *            - 0 success
+ *            - 1 flush failed
+ *            - 2 pool is NULL
+ *            - 3 pool is not inited
+ *            - 4 update is invalid
+ *            - 5 module is updated twice
+ * @note      render tasks write the updates into the fleet and may be stolen by any idle worker,
+ *            the flush of a bus runs on its owner after the last render task of the bus,
+ *            the call returns when every bus is flushed and num 0 only flushes
+ */
+uint8_t tm1637_pool_update(tm1637_pool_t *pool, const tm1637_pool_update_t *update, uint16_t num);
+
+/**
+ * @brief      get the statistics of a worker
+ * @param[in]  *pool points to a tm1637 pool structure
+ * @param[in]  worker is the worker index
+ * @param[out] *executed points to an executed task counter buffer
+ * @param[out] *stolen points to a stolen task counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 pool is NULL
+ *             - 3 pool is not inited
+ *             - 4 worker is invalid
+ * @note       call it between batches
+ */
+uint8_t tm1637_pool_get_statistics(tm1637_pool_t *pool, uint8_t worker, uint32_t *executed, uint32_t *stolen);
+
+/**
+ * @brief     stop the pool
+ * @param[in] *pool points to a tm1637 pool structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 pool is NULL
+ *            - 3 pool is not inited
+ * @note      it joins every worker
+ */
+uint8_t tm1637_pool_deinit(tm1637_pool_t *pool);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
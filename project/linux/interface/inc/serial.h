@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      serial.h
+ * @brief     serial header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef SERIAL_H
+#define SERIAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup serial serial function
+ * @brief    serial port function modules
+ * @{
+ */
+
+/**
+ * @brief      serial open
+ * @param[in]  *name points to a serial device name like "/dev/ttyACM0"
+ * @param[in]  baud is the baud rate
+ * @param[out] *fd points to a file descriptor buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 open failed
+ * @note       the port runs raw with 8 data bits, 1 stop bit and no parity
+ */
+uint8_t serial_open(const char *name, uint32_t baud, int *fd);
+
+/**
+ * @brief     serial close
+ * @param[in] fd is the file descriptor
+ * @return    status code
+ *            - 0 success
+ *            - 1 close failed
+ * @note      none
+ */
+uint8_t serial_close(int fd);
+
+/**
+ * @brief     serial write
+ * @param[in] *ctx points to a file descriptor
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      it returns after all bytes are written
+ */
+uint8_t serial_write(void *ctx, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief      serial read
+ * @param[in]  *ctx points to a file descriptor
+ * @param[out] *buf points to a data buffer
+ * @param[in]  len is the buffer length
+ * @param[in]  timeout_ms is the timeout in ms
+ * @return     length of the read data
+ * @note       it returns the bytes already received, 0 means timeout
+ */
+uint16_t serial_read(void *ctx, uint8_t *buf, uint16_t len, uint32_t timeout_ms);
+
+/**
+ * @brief      serial pty open
+ * @param[out] *fd points to a master file descriptor buffer
+ * @param[out] *name points to a slave name buffer
+ * @param[in]  len is the name buffer length
+ * @return     status code
+ *             - 0 success
+ *             - 1 open failed
+ * @note       the slave is a serial port stand-in, open it with serial_open
+ */
+uint8_t serial_pty_open(int *fd, char *name, size_t len);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
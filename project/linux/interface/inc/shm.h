@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      shm.h
+ * @brief     shm header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef SHM_H
+#define SHM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup shm shm function
+ * @brief    shared memory function modules
+ * @{
+ */
+
+/**
+ * @brief      shm create
+ * @param[in]  *name points to a shared memory name like "/tm1637"
+ * @param[in]  size is the shared memory size
+ * @param[out] **addr points to a mapped address buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 create failed
+ * @note       an old object with the same name is replaced, the memory starts zeroed
+ */
+uint8_t shm_create(const char *name, size_t size, void **addr);
+
+/**
+ * @brief      shm attach
+ * @param[in]  *name points to a shared memory name like "/tm1637"
+ * @param[in]  size is the shared memory size
+ * @param[out] **addr points to a mapped address buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 attach failed
+ * @note       none
+ */
+uint8_t shm_attach(const char *name, size_t size, void **addr);
+
+/**
+ * @brief     shm detach
+ * @param[in] *addr points to a mapped address
+ * @param[in] size is the shared memory size
+ * @return    status code
+ *            - 0 success
+ *            - 1 detach failed
+ * @note      none
+ */
+uint8_t shm_detach(void *addr, size_t size);
+
+/**
+ * @brief     shm remove
+ * @param[in] *name points to a shared memory name
+ * @return    status code
+ *            - 0 success
+ *            - 1 remove failed
+ * @note      mapped clients keep their mapping until they detach
+ */
+uint8_t shm_remove(const char *name);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,166 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      timing.h
+ * @brief     timing header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup timing timing function
+ * @brief    tm1637 pin timing check modules
+ * @{
+ */
+
+/**
+ * @brief timing rule enumeration definition
+ */
+typedef enum
+{
+    TIMING_RULE_CLK_HIGH   = 0x00,        /**< clock high width */
+    TIMING_RULE_CLK_LOW    = 0x01,        /**< clock low width */
+    TIMING_RULE_CLK_PERIOD = 0x02,        /**< clock period from rise to rise */
+    TIMING_RULE_SETUP      = 0x03,        /**< data change to clock rise */
+    TIMING_RULE_HOLD       = 0x04,        /**< clock fall to data change */
+    TIMING_RULE_START_STOP = 0x05,        /**< clock rise to a start or a stop */
+    TIMING_RULE_START_HOLD = 0x06,        /**< start or stop to clock fall */
+    TIMING_RULE_SAMPLE     = 0x07,        /**< clock fall to the host sample */
+    TIMING_RULE_NUM        = 0x08,        /**< rule number */
+} timing_rule_t;
+
+/**
+ * @brief timing limit structure definition
+ */
+typedef struct timing_limit_s
+{
+    uint32_t min_ns[TIMING_RULE_NUM];        /**< min time of each rule */
+} timing_limit_t;
+
+/**
+ * @brief timing rule statistics structure definition
+ */
+typedef struct timing_stat_s
+{
+    uint32_t checks;             /**< checked edges */
+    uint32_t violations;         /**< edges under the limit */
+    uint64_t min_ns;             /**< shortest measured time */
+} timing_stat_t;
+
+/**
+ * @brief timing structure definition
+ */
+typedef struct timing_s
+{
+    timing_limit_t limit;                                                                  /**< limits */
+    void (*report)(uint64_t ns, timing_rule_t rule, uint64_t measured_ns, uint32_t min_ns);   /**< violation callback */
+    timing_stat_t stat[TIMING_RULE_NUM];                                                   /**< rule statistics */
+    uint64_t rise_ns;                                                                      /**< last clock rise */
+    uint64_t fall_ns;                                                                      /**< last clock fall */
+    uint64_t dio_ns;                                                                       /**< last data change */
+    uint64_t high_dio_ns;                                                                  /**< last data change while the clock is high */
+    uint8_t valid;                                                                         /**< timestamp valid mask */
+    uint8_t clk;                                                                           /**< clock level */
+    uint8_t dio;                                                                           /**< data level */
+} timing_t;
+
+/**
+ * @brief      timing get the tm1637 datasheet limits
+ * @param[out] *limit points to a timing limit structure
+ * @note       clock width 400ns, 500kHz clock, setup and hold 100ns, output delay 300ns,
+ *             the datasheet gives no start and stop time, so they take the 100ns of setup and hold
+ */
+void timing_limit_default(timing_limit_t *limit);
+
+/**
+ * @brief     timing init
+ * @param[in] *timing points to a timing structure
+ * @param[in] *limit points to a timing limit structure
+ * @param[in] *report points to a violation callback, it may be NULL
+ * @note      both lines start high like an idle bus
+ */
+void timing_init(timing_t *timing, const timing_limit_t *limit,
+                 void (*report)(uint64_t ns, timing_rule_t rule, uint64_t measured_ns, uint32_t min_ns));
+
+/**
+ * @brief     timing check the lines
+ * @param[in] *timing points to a timing structure
+ * @param[in] ns is the timestamp
+ * @param[in] clk is the clock level
+ * @param[in] dio is the data level driven by the host
+ * @note      call it at every change, the timestamps must not go back,
+ *            the chip output is checked by timing_sample because it only has to be stable when the host reads it
+ */
+void timing_edge(timing_t *timing, uint64_t ns, uint8_t clk, uint8_t dio);
+
+/**
+ * @brief     timing follow a data change driven by the chip
+ * @param[in] *timing points to a timing structure
+ * @param[in] ns is the timestamp
+ * @param[in] dio is the data level
+ * @note      a capture only has the bus level, the ack and the key bits are not held by the host,
+ *            so the hold rule is skipped and the setup rule still applies at the next clock rise
+ */
+void timing_chip_edge(timing_t *timing, uint64_t ns, uint8_t dio);
+
+/**
+ * @brief     timing check a host sample
+ * @param[in] *timing points to a timing structure
+ * @param[in] ns is the timestamp
+ * @note      the chip output settles an output delay after the clock falls
+ */
+void timing_sample(timing_t *timing, uint64_t ns);
+
+/**
+ * @brief     timing rule name
+ * @param[in] rule is the timing rule
+ * @return    rule name
+ * @note      none
+ */
+const char *timing_rule_name(timing_rule_t rule);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
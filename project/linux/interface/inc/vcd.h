@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      vcd.h
+ * @brief     vcd header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef VCD_H
+#define VCD_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup vcd vcd function
+ * @brief    value change dump function modules
+ * @{
+ */
+
+/**
+ * @brief vcd max signal definition
+ */
+#define VCD_MAX_SIGNAL        8        /**< 8 signals */
+
+/**
+ * @brief vcd structure definition
+ */
+typedef struct vcd_s
+{
+    FILE *fp;                              /**< output file */
+    uint64_t ns;                           /**< last written timestamp */
+    uint8_t wires;                         /**< wire number */
+    uint8_t events;                        /**< event number */
+    uint8_t level[VCD_MAX_SIGNAL];         /**< last written wire level */
+    uint8_t time_valid;                    /**< timestamp written flag */
+    uint32_t changes;                      /**< written changes */
+} vcd_t;
+
+/**
+ * @brief     vcd open
+ * @param[in] *vcd points to a vcd structure
+ * @param[in] *path points to a file path
+ * @param[in] **wire points to the wire names
+ * @param[in] wires is the wire number
+ * @param[in] **event points to the event names
+ * @param[in] events is the event number
+ * @return    status code
+ *            - 0 success
+ *            - 1 open failed
+ *            - 2 too many signals
+ * @note      the time scale is 1ns and all wires start high like an idle bus
+ */
+uint8_t vcd_open(vcd_t *vcd, const char *path, const char *const *wire, uint8_t wires,
+                 const char *const *event, uint8_t events);
+
+/**
+ * @brief     vcd change a wire
+ * @param[in] *vcd points to a vcd structure
+ * @param[in] ns is the timestamp
+ * @param[in] index is the wire index
+ * @param[in] level is the wire level
+ * @note      only a new level is written
+ */
+void vcd_change(vcd_t *vcd, uint64_t ns, uint8_t index, uint8_t level);
+
+/**
+ * @brief     vcd trigger an event
+ * @param[in] *vcd points to a vcd structure
+ * @param[in] ns is the timestamp
+ * @param[in] index is the event index
+ * @note      none
+ */
+void vcd_trigger(vcd_t *vcd, uint64_t ns, uint8_t index);
+
+/**
+ * @brief     vcd close
+ * @param[in] *vcd points to a vcd structure
+ * @param[in] ns is the end timestamp
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+uint8_t vcd_close(vcd_t *vcd, uint64_t ns);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
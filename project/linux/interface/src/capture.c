@@ -0,0 +1,497 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      capture.c
+ * @brief     capture source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "capture.h"
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief capture chunk size definition
+ */
+#define CAPTURE_CHUNK        (16 * 1024 * 1024)        /**< 16MB */
+
+/**
+ * @brief     capture sample time
+ * @param[in] index is the sample index
+ * @param[in] rate_hz is the sample rate
+ * @return    sample time in nanoseconds
+ * @note      none
+ */
+static inline uint64_t a_capture_ns(uint64_t index, uint64_t rate_hz)
+{
+    return (index / rate_hz) * 1000000000ULL + ((index % rate_hz) * 1000000000ULL) / rate_hz;
+}
+
+/**
+ * @brief     capture drop the read pages
+ * @param[in] *capture points to a capture structure
+ * @param[in] pos is the read position
+ * @note      the mapping is private and read only, so the pages are read again if touched
+ */
+static void a_capture_drop(capture_t *capture, size_t pos)
+{
+    size_t end = pos - (pos % CAPTURE_CHUNK);
+    
+    if (end > capture->dropped)
+    {
+        (void)madvise((void *)(capture->buf + capture->dropped), end - capture->dropped, MADV_DONTNEED);
+        capture->dropped = end;
+    }
+}
+
+/**
+ * @brief      capture parse a decimal number
+ * @param[in]  *p points to a text
+ * @param[in]  *end points to the text end
+ * @param[in]  scale is the power of ten of the result unit
+ * @param[out] *value points to a value buffer
+ * @return     points to the first unused char, NULL if there is no digit
+ * @note       it takes a sign, a fraction and an exponent, scale 9 gives nanoseconds from seconds
+ */
+static const uint8_t *a_capture_decimal(const uint8_t *p, const uint8_t *end, int32_t scale, int64_t *value)
+{
+    uint64_t mantissa = 0;
+    uint8_t digits = 0;
+    uint8_t negative = 0;
+    int32_t power = scale;
+    int32_t exponent = 0;
+    uint8_t exponent_negative = 0;
+    
+    if ((p < end) && ((*p == '-') || (*p == '+')))
+    {
+        negative = (*p == '-') ? 1 : 0;
+        p++;
+    }
+    while ((p < end) && (*p >= '0') && (*p <= '9'))
+    {
+        if (mantissa < 100000000000000000ULL)
+        {
+            mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+        }
+        else
+        {
+            power++;
+        }
+        digits++;
+        p++;
+    }
+    if ((p < end) && (*p == '.'))
+    {
+        p++;
+        while ((p < end) && (*p >= '0') && (*p <= '9'))
+        {
+            if (mantissa < 100000000000000000ULL)
+            {
+                mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+                power--;
+            }
+            digits++;
+            p++;
+        }
+    }
+    if (digits == 0)
+    {
+        return NULL;
+    }
+    if ((p < end) && ((*p == 'e') || (*p == 'E')))
+    {
+        p++;
+        if ((p < end) && ((*p == '-') || (*p == '+')))
+        {
+            exponent_negative = (*p == '-') ? 1 : 0;
+            p++;
+        }
+        while ((p < end) && (*p >= '0') && (*p <= '9'))
+        {
+            if (exponent < 1000)
+            {
+                exponent = exponent * 10 + (int32_t)(*p - '0');
+            }
+            p++;
+        }
+        power += (exponent_negative != 0) ? -exponent : exponent;
+    }
+    
+    /* scale to the unit */
+    while ((power > 0) && (mantissa != 0))
+    {
+        mantissa *= 10;
+        power--;
+    }
+    while (power < 0)
+    {
+        mantissa /= 10;
+        power++;
+    }
+    *value = (negative != 0) ? -(int64_t)mantissa : (int64_t)mantissa;
+    
+    return p;
+}
+
+/**
+ * @brief     capture run a binary file
+ * @param[in] *capture points to a capture structure
+ * @param[in] *edge points to a callback called at every change of CLK or DIO
+ * @param[in] *ctx points to a callback context
+ * @return    status code
+ *            - 0 success
+ *            - 4 sample rate is unknown
+ * @note      eight unchanged samples are skipped in one compare
+ */
+static uint8_t a_capture_binary(capture_t *capture, void (*edge)(void *ctx, uint64_t ns, uint8_t clk, uint8_t dio), void *ctx)
+{
+    const uint64_t mask = 0x0303030303030303ULL;
+    uint64_t pattern;
+    uint64_t word;
+    size_t i = 0;
+    size_t end;
+    uint8_t last = 0x03;
+    uint8_t level;
+    
+    if (capture->rate_hz == 0)
+    {
+        return 4;
+    }
+    pattern = mask;
+    while (i < capture->size)
+    {
+        end = (capture->size - i > CAPTURE_CHUNK) ? (i + CAPTURE_CHUNK) : capture->size;
+        while (i < end)
+        {
+            /* skip eight unchanged samples */
+            if (end - i >= 8)
+            {
+                memcpy(&word, &capture->buf[i], 8);
+                if (((word ^ pattern) & mask) == 0)
+                {
+                    i += 8;
+                    
+                    continue;
+                }
+            }
+            level = capture->buf[i] & 0x03;
+            if (level != last)
+            {
+                edge(ctx, a_capture_ns(i, capture->rate_hz), level & 0x01, (level >> 1) & 0x01);
+                last = level;
+                pattern = 0x0101010101010101ULL * last;
+            }
+            i++;
+        }
+        a_capture_drop(capture, i);
+    }
+    capture->samples = capture->size;
+    capture->end_ns = (capture->size != 0) ? a_capture_ns(capture->size - 1, capture->rate_hz) : 0;
+    
+    return 0;
+}
+
+/**
+ * @brief     capture read a samplerate comment
+ * @param[in] *capture points to a capture structure
+ * @param[in] *p points to a comment line
+ * @param[in] *end points to the line end
+ * @note      it takes lines like "; Samplerate: 4 MHz" from sigrok
+ */
+static void a_capture_rate(capture_t *capture, const uint8_t *p, const uint8_t *end)
+{
+    const char key[] = "Samplerate:";
+    size_t len = sizeof(key) - 1;
+    int32_t scale = 0;
+    int64_t value;
+    
+    while ((p + len <= end) && (memcmp(p, key, len) != 0))
+    {
+        p++;
+    }
+    if (p + len > end)
+    {
+        return;
+    }
+    p += len;
+    while ((p < end) && (*p == ' '))
+    {
+        p++;
+    }
+    if ((p < end) && (*p >= '0') && (*p <= '9'))
+    {
+        const uint8_t *q = p;
+        
+        /* the unit follows the number */
+        while ((q < end) && (((*q >= '0') && (*q <= '9')) || (*q == '.') || (*q == ' ')))
+        {
+            q++;
+        }
+        if (q < end)
+        {
+            scale = (*q == 'k') ? 3 : ((*q == 'M') ? 6 : ((*q == 'G') ? 9 : 0));
+        }
+        if ((a_capture_decimal(p, end, scale, &value) != NULL) && (value > 0))
+        {
+            capture->rate_hz = (uint64_t)value;
+        }
+    }
+}
+
+/**
+ * @brief     capture run a csv file
+ * @param[in] *capture points to a capture structure
+ * @param[in] *edge points to a callback called at every change of CLK or DIO
+ * @param[in] *ctx points to a callback context
+ * @return    status code
+ *            - 0 success
+ *            - 1 csv line is invalid
+ *            - 4 sample rate is unknown
+ * @note      ';' and '#' lines are comments, a header whose first column starts with "Time" means
+ *            a time column in seconds, the next two columns are CLK and DIO
+ */
+static uint8_t a_capture_csv(capture_t *capture, void (*edge)(void *ctx, uint64_t ns, uint8_t clk, uint8_t dio), void *ctx)
+{
+    const uint8_t *p = capture->buf;
+    const uint8_t *end = capture->buf + capture->size;
+    const uint8_t *eol;
+    int64_t first = 0;
+    int64_t t;
+    int64_t v[2];
+    uint64_t ns = 0;
+    uint8_t header = 0;
+    uint8_t time = 0;
+    uint8_t first_valid = 0;
+    uint8_t last = 0x03;
+    uint8_t level;
+    uint8_t i;
+    
+    capture->line = 0;
+    while (p < end)
+    {
+        eol = memchr(p, '\n', (size_t)(end - p));
+        if (eol == NULL)
+        {
+            eol = end;
+        }
+        capture->line++;
+        
+        /* comments, empty lines and the header */
+        if ((*p == ';') || (*p == '#'))
+        {
+            a_capture_rate(capture, p, eol);
+            p = (eol < end) ? (eol + 1) : end;
+            
+            continue;
+        }
+        if ((*p == '\r') || (*p == '\n') || (p == eol))
+        {
+            p = (eol < end) ? (eol + 1) : end;
+            
+            continue;
+        }
+        if (((*p < '0') || (*p > '9')) && (*p != '-') && (*p != '+') && (*p != '.'))
+        {
+            if (header != 0)
+            {
+                return 1;
+            }
+            header = 1;
+            if (*p == '"')
+            {
+                p++;
+            }
+            time = ((end - p >= 4) && ((memcmp(p, "Time", 4) == 0) || (memcmp(p, "time", 4) == 0))) ? 1 : 0;
+            p = (eol < end) ? (eol + 1) : end;
+            
+            continue;
+        }
+        
+        /* the time column or the sample index */
+        if (time != 0)
+        {
+            p = a_capture_decimal(p, eol, 9, &t);
+            if ((p == NULL) || (p >= eol) || (*p != ','))
+            {
+                return 1;
+            }
+            p++;
+            if (first_valid == 0)
+            {
+                first = t;
+                first_valid = 1;
+            }
+            if (t - first < (int64_t)ns)
+            {
+                return 1;
+            }
+            ns = (uint64_t)(t - first);
+        }
+        else
+        {
+            if (capture->rate_hz == 0)
+            {
+                return 4;
+            }
+            ns = a_capture_ns(capture->samples, capture->rate_hz);
+        }
+        
+        /* clk and dio */
+        for (i = 0; i < 2; i++)
+        {
+            while ((p < eol) && (*p == ' '))
+            {
+                p++;
+            }
+            p = a_capture_decimal(p, eol, 0, &v[i]);
+            if (p == NULL)
+            {
+                return 1;
+            }
+            while ((p < eol) && (*p == ' '))
+            {
+                p++;
+            }
+            if ((i == 0) && ((p >= eol) || (*p != ',')))
+            {
+                return 1;
+            }
+            p++;
+        }
+        level = (uint8_t)(((v[0] != 0) ? 0x01 : 0x00) | ((v[1] != 0) ? 0x02 : 0x00));
+        if (level != last)
+        {
+            edge(ctx, ns, level & 0x01, (level >> 1) & 0x01);
+            last = level;
+        }
+        capture->samples++;
+        p = (eol < end) ? (eol + 1) : end;
+        a_capture_drop(capture, (size_t)(eol - capture->buf));
+    }
+    capture->end_ns = ns;
+    
+    return 0;
+}
+
+/**
+ * @brief     capture open
+ * @param[in] *capture points to a capture structure
+ * @param[in] *path points to a file path, a .csv file is csv and the others are binary
+ * @param[in] rate_hz is the sample rate, 0 takes the samplerate comment of a csv file
+ * @return    status code
+ *            - 0 success
+ *            - 1 open failed
+ * @note      the file is mapped and read once from the start to the end
+ */
+uint8_t capture_open(capture_t *capture, const char *path, uint64_t rate_hz)
+{
+    int fd;
+    void *p;
+    struct stat st;
+    size_t len = strlen(path);
+    
+    memset(capture, 0, sizeof(capture_t));
+    capture->rate_hz = rate_hz;
+    capture->format = ((len >= 4) && (strcmp(path + len - 4, ".csv") == 0)) ? CAPTURE_FORMAT_CSV : CAPTURE_FORMAT_BINARY;
+    
+    /* map the whole file */
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return 1;
+    }
+    if (fstat(fd, &st) != 0)
+    {
+        (void)close(fd);
+        
+        return 1;
+    }
+    capture->size = (size_t)st.st_size;
+    if (capture->size == 0)
+    {
+        (void)close(fd);
+        
+        return 0;
+    }
+    p = mmap(NULL, capture->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    (void)close(fd);
+    if (p == MAP_FAILED)
+    {
+        return 1;
+    }
+    (void)madvise(p, capture->size, MADV_SEQUENTIAL);
+    capture->buf = p;
+    
+    return 0;
+}
+
+/**
+ * @brief     capture run
+ * @param[in] *capture points to a capture structure
+ * @param[in] *edge points to a callback called at every change of CLK or DIO
+ * @param[in] *ctx points to a callback context
+ * @return    status code
+ *            - 0 success
+ *            - 1 csv line is invalid
+ *            - 4 sample rate is unknown
+ * @note      both lines start high like an idle bus, the pages behind the reader are dropped,
+ *            so a capture of any size runs in constant memory
+ */
+uint8_t capture_run(capture_t *capture, void (*edge)(void *ctx, uint64_t ns, uint8_t clk, uint8_t dio), void *ctx)
+{
+    if (capture->format == CAPTURE_FORMAT_CSV)
+    {
+        return a_capture_csv(capture, edge, ctx);
+    }
+    else
+    {
+        return a_capture_binary(capture, edge, ctx);
+    }
+}
+
+/**
+ * @brief     capture close
+ * @param[in] *capture points to a capture structure
+ * @note      none
+ */
+void capture_close(capture_t *capture)
+{
+    if (capture->buf != NULL)
+    {
+        (void)munmap((void *)capture->buf, capture->size);
+        capture->buf = NULL;
+    }
+}
@@ -0,0 +1,420 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      decode.c
+ * @brief     decode source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "decode.h"
+#include <string.h>
+
+/**
+ * @brief     decode check a key byte
+ * @param[in] *decode points to a decode structure
+ * @param[in] index is the byte index
+ * @return    1 if the chip sends the byte
+ * @note      the byte after a read data command is the key data
+ */
+static uint8_t a_decode_key(decode_t *decode, uint32_t index)
+{
+    return ((index != 0) && ((decode->current.data[0] & 0xC2) == 0x42)) ? 1 : 0;
+}
+
+/**
+ * @brief     decode begin a record
+ * @param[in] *decode points to a decode structure
+ * @param[in] ns is the timestamp
+ * @note      none
+ */
+static void a_decode_begin(decode_t *decode, uint64_t ns)
+{
+    uint8_t i;
+    
+    memset(&decode->current, 0, sizeof(decode_record_t));
+    decode->current.start_ns = ns;
+    for (i = 0; i < TIMING_RULE_NUM; i++)
+    {
+        decode->violations[i] = decode->timing.stat[i].violations;
+    }
+    decode->busy = 1;
+    decode->bit = 0;
+    decode->shift = 0;
+    decode->sampled = 0;
+    decode->chip = 0;
+    decode->handover = 0;
+    decode->rise_valid = 0;
+}
+
+/**
+ * @brief     decode end a record
+ * @param[in] *decode points to a decode structure
+ * @param[in] ns is the timestamp
+ * @param[in] flags is the extra flags
+ * @note      none
+ */
+static void a_decode_end(decode_t *decode, uint64_t ns, uint8_t flags)
+{
+    decode_record_t *record = &decode->current;
+    uint8_t i;
+    
+    record->end_ns = ns;
+    record->flags |= flags;
+    if (decode->bit != 0)
+    {
+        record->flags |= DECODE_FLAG_PARTIAL;
+    }
+    for (i = 0; i < TIMING_RULE_NUM; i++)
+    {
+        if (decode->timing.stat[i].violations != decode->violations[i])
+        {
+            record->timing |= (uint8_t)(1 << i);
+        }
+    }
+    if (record->timing != 0)
+    {
+        record->flags |= DECODE_FLAG_TIMING;
+    }
+    decode->records++;
+    if (record->flags != 0)
+    {
+        decode->flagged++;
+    }
+    decode->busy = 0;
+    decode->chip = 0;
+    decode->handover = 0;
+    if (decode->record != NULL)
+    {
+        decode->record(decode->ctx, record);
+    }
+}
+
+/**
+ * @brief     decode save a byte
+ * @param[in] *decode points to a decode structure
+ * @param[in] byte is the received byte
+ * @param[in] ack is the ninth bit
+ * @note      none
+ */
+static void a_decode_byte(decode_t *decode, uint8_t byte, uint8_t ack)
+{
+    decode_record_t *record = &decode->current;
+    uint32_t index = record->bytes;
+    uint32_t addr;
+    
+    if (record->len < DECODE_MAX_BYTE)
+    {
+        record->data[record->len] = byte;
+        record->ack |= (uint8_t)(ack << record->len);
+        record->len++;
+    }
+    else
+    {
+        record->flags |= DECODE_FLAG_OVERFLOW;
+    }
+    
+    /* the host acks the key data, the chip acks the others */
+    if ((a_decode_key(decode, index) == 0) && (ack != 0))
+    {
+        record->flags |= DECODE_FLAG_NACK;
+    }
+    if (index == 0)
+    {
+        switch (byte & 0xC0)
+        {
+            /* data command */
+            case 0x40 :
+            {
+                decode->fixed = (byte >> 2) & 0x01;
+                
+                break;
+            }
+            
+            /* display and address command */
+            case 0x80 :
+            case 0xC0 :
+            {
+                break;
+            }
+            
+            /* unknown command */
+            default :
+            {
+                record->flags |= DECODE_FLAG_COMMAND;
+                
+                break;
+            }
+        }
+    }
+    else if (a_decode_key(decode, index) != 0)
+    {
+        /* one key byte */
+        if (index != 1)
+        {
+            record->flags |= DECODE_FLAG_COMMAND;
+        }
+    }
+    else if ((record->data[0] & 0xC0) == 0xC0)
+    {
+        /* only the address command carries digits */
+        addr = (uint32_t)(record->data[0] & 0x07) + ((decode->fixed != 0) ? 0 : (index - 1));
+        if (addr > 5)
+        {
+            record->flags |= DECODE_FLAG_COMMAND;
+        }
+    }
+    else
+    {
+        record->flags |= DECODE_FLAG_COMMAND;
+    }
+    record->bytes++;
+}
+
+/**
+ * @brief     decode a data change
+ * @param[in] *decode points to a decode structure
+ * @param[in] ns is the timestamp
+ * @param[in] dio is the data level
+ * @note      none
+ */
+static void a_decode_data(decode_t *decode, uint64_t ns, uint8_t dio)
+{
+    if (decode->clk == 0)
+    {
+        /* data, the chip drives its bits and the first change after it hands the line back */
+        if ((decode->busy != 0) && ((decode->chip != 0) || (decode->handover != 0)))
+        {
+            timing_chip_edge(&decode->timing, ns, dio);
+            decode->handover = 0;
+        }
+        else
+        {
+            timing_edge(&decode->timing, ns, 0, dio);
+        }
+    }
+    else
+    {
+        /* start or stop */
+        timing_edge(&decode->timing, ns, 1, dio);
+        if (dio == 0)
+        {
+            if (decode->busy != 0)
+            {
+                a_decode_end(decode, ns, DECODE_FLAG_NO_STOP);
+            }
+            a_decode_begin(decode, ns);
+        }
+        else if (decode->busy != 0)
+        {
+            a_decode_end(decode, ns, 0);
+        }
+        else
+        {
+            /* a stop on an idle bus */
+        }
+    }
+    decode->dio = dio;
+}
+
+/**
+ * @brief     decode a clock edge
+ * @param[in] *decode points to a decode structure
+ * @param[in] ns is the timestamp
+ * @param[in] clk is the clock level
+ * @note      a bit is sampled at the rise and kept at the fall, so the clock of a stop adds no bit
+ */
+static void a_decode_clock(decode_t *decode, uint64_t ns, uint8_t clk)
+{
+    uint8_t chip;
+    
+    timing_edge(&decode->timing, ns, clk, decode->dio);
+    decode->clk = clk;
+    if (decode->busy == 0)
+    {
+        decode->sampled = 0;
+        
+        return;
+    }
+    if (clk != 0)
+    {
+        if ((decode->rise_valid != 0) &&
+            ((decode->current.period_ns == 0) || ((ns - decode->rise_ns) < decode->current.period_ns)))
+        {
+            decode->current.period_ns = (uint32_t)(ns - decode->rise_ns);
+        }
+        decode->rise_ns = ns;
+        decode->rise_valid = 1;
+        decode->sample = decode->dio;
+        decode->sampled = 1;
+        if (decode->chip != 0)
+        {
+            timing_sample(&decode->timing, ns);
+        }
+        
+        return;
+    }
+    if (decode->sampled == 0)
+    {
+        return;
+    }
+    decode->sampled = 0;
+    if (decode->bit < 8)
+    {
+        decode->shift |= (uint8_t)(decode->sample << decode->bit);
+        decode->bit++;
+    }
+    else
+    {
+        a_decode_byte(decode, decode->shift, decode->sample);
+        decode->bit = 0;
+        decode->shift = 0;
+    }
+    
+    /* the owner of the next bit */
+    if (decode->bit == 8)
+    {
+        chip = (a_decode_key(decode, decode->current.bytes) != 0) ? 0 : 1;
+    }
+    else
+    {
+        chip = a_decode_key(decode, decode->current.bytes);
+    }
+    decode->handover = ((decode->chip != 0) && (chip == 0)) ? 1 : 0;
+    decode->chip = chip;
+}
+
+/**
+ * @brief     decode init
+ * @param[in] *decode points to a decode structure
+ * @param[in] *limit points to a timing limit structure
+ * @param[in] *record points to a record callback
+ * @param[in] *ctx points to a record callback context
+ * @note      both lines start high like an idle bus
+ */
+void decode_init(decode_t *decode, const timing_limit_t *limit,
+                 void (*record)(void *ctx, const decode_record_t *record), void *ctx)
+{
+    memset(decode, 0, sizeof(decode_t));
+    timing_init(&decode->timing, limit, NULL);
+    decode->record = record;
+    decode->ctx = ctx;
+    decode->clk = 1;
+    decode->dio = 1;
+}
+
+/**
+ * @brief     decode the lines
+ * @param[in] *decode points to a decode structure
+ * @param[in] ns is the timestamp
+ * @param[in] clk is the clock level
+ * @param[in] dio is the data level
+ * @note      call it at every change, a clock and data change in one sample is taken
+ *            as data before a rise and data after a fall
+ */
+void decode_edge(decode_t *decode, uint64_t ns, uint8_t clk, uint8_t dio)
+{
+    clk = (clk != 0) ? 1 : 0;
+    dio = (dio != 0) ? 1 : 0;
+    if ((clk != decode->clk) && (clk == 0))
+    {
+        a_decode_clock(decode, ns, 0);
+        if (dio != decode->dio)
+        {
+            a_decode_data(decode, ns, dio);
+        }
+    }
+    else
+    {
+        if (dio != decode->dio)
+        {
+            a_decode_data(decode, ns, dio);
+        }
+        if (clk != decode->clk)
+        {
+            a_decode_clock(decode, ns, 1);
+        }
+    }
+}
+
+/**
+ * @brief     decode finish
+ * @param[in] *decode points to a decode structure
+ * @param[in] ns is the end of the capture
+ * @note      an open transaction is flushed with the no stop flag
+ */
+void decode_finish(decode_t *decode, uint64_t ns)
+{
+    if (decode->busy != 0)
+    {
+        a_decode_end(decode, ns, DECODE_FLAG_NO_STOP);
+    }
+}
+
+/**
+ * @brief     decode flag name
+ * @param[in] flag is one decode flag
+ * @return    flag name
+ * @note      none
+ */
+const char *decode_flag_name(decode_flag_t flag)
+{
+    switch (flag)
+    {
+        case DECODE_FLAG_NACK :
+        {
+            return "nack";
+        }
+        case DECODE_FLAG_PARTIAL :
+        {
+            return "partial";
+        }
+        case DECODE_FLAG_NO_STOP :
+        {
+            return "no_stop";
+        }
+        case DECODE_FLAG_COMMAND :
+        {
+            return "command";
+        }
+        case DECODE_FLAG_OVERFLOW :
+        {
+            return "overflow";
+        }
+        case DECODE_FLAG_TIMING :
+        {
+            return "timing";
+        }
+        default :
+        {
+            return "unknown";
+        }
+    }
+}
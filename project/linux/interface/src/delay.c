@@ -0,0 +1,191 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      delay.c
+ * @brief     delay source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "delay.h"
+#include <time.h>
+
+static uint8_t gs_virtual = 0;                                  /**< virtual clock flag */
+static uint64_t gs_virtual_ns = 0;                              /**< virtual time in nanoseconds */
+static void (*gs_probe)(uint32_t us, uint32_t ms) = NULL;       /**< delay probe */
+
+/**
+ * @brief  get the monotonic time
+ * @return time in nanoseconds
+ * @note   none
+ */
+static uint64_t a_delay_now_ns(void)
+{
+    struct timespec ts;
+    
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief     delay ns
+ * @param[in] ns
+ * @note      it spins, the real delay is at least the clock_gettime cost
+ */
+void delay_ns(uint32_t ns)
+{
+    uint64_t start;
+    
+    /* a virtual delay only moves the clock */
+    if (gs_virtual != 0)
+    {
+        gs_virtual_ns += ns;
+        
+        return;
+    }
+    
+    start = a_delay_now_ns();
+    while ((a_delay_now_ns() - start) < ns)
+    {
+        /* spin */
+    }
+}
+
+/**
+ * @brief     delay us
+ * @param[in] us
+ * @note      it spins because sleeping has a much longer latency than a clock period
+ */
+void delay_us(uint32_t us)
+{
+    uint64_t start;
+    
+    /* a virtual delay only moves the clock */
+    if (gs_virtual != 0)
+    {
+        gs_virtual_ns += (uint64_t)us * 1000ULL;
+        
+        return;
+    }
+    
+    start = a_delay_now_ns();
+    while ((a_delay_now_ns() - start) < (uint64_t)us * 1000ULL)
+    {
+        /* spin */
+    }
+}
+
+/**
+ * @brief     delay ms
+ * @param[in] ms
+ * @note      none
+ */
+void delay_ms(uint32_t ms)
+{
+    struct timespec ts;
+    
+    /* a virtual delay shows the probe the state it holds, then moves the clock */
+    if (gs_virtual != 0)
+    {
+        if (gs_probe != NULL)
+        {
+            gs_probe((uint32_t)(gs_virtual_ns / 1000ULL), ms);
+        }
+        gs_virtual_ns += (uint64_t)ms * 1000000ULL;
+        
+        return;
+    }
+    
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (long)(ms % 1000) * 1000000L;
+    while (nanosleep(&ts, &ts) != 0)
+    {
+        /* interrupted, sleep the rest */
+    }
+}
+
+/**
+ * @brief  get the timestamp
+ * @return timestamp in microseconds
+ * @note   it wraps around after about 71 minutes
+ */
+uint32_t delay_timestamp_us(void)
+{
+    if (gs_virtual != 0)
+    {
+        return (uint32_t)(gs_virtual_ns / 1000ULL);
+    }
+    
+    return (uint32_t)(a_delay_now_ns() / 1000ULL);
+}
+
+/**
+ * @brief  get the timestamp in nanoseconds
+ * @return timestamp in nanoseconds
+ * @note   the virtual clock counts from its start
+ */
+uint64_t delay_timestamp_ns(void)
+{
+    if (gs_virtual != 0)
+    {
+        return gs_virtual_ns;
+    }
+    
+    return a_delay_now_ns();
+}
+
+/**
+ * @brief     start the virtual clock
+ * @param[in] *probe points to a probe function called at each delay ms, it may be NULL
+ * @note      the virtual time starts at 0 and every delay returns at once after moving it,
+ *            only a single thread test may use it because the other threads would see the same clock
+ */
+void delay_virtual_start(void (*probe)(uint32_t us, uint32_t ms))
+{
+    gs_virtual_ns = 0;
+    gs_probe = probe;
+    gs_virtual = 1;
+}
+
+/**
+ * @brief  stop the virtual clock
+ * @return virtual time in microseconds
+ * @note   none
+ */
+uint64_t delay_virtual_stop(void)
+{
+    gs_virtual = 0;
+    gs_probe = NULL;
+    
+    return gs_virtual_ns / 1000ULL;
+}
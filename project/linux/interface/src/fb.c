@@ -0,0 +1,504 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      fb.c
+ * @brief     fb source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "fb.h"
+#include <string.h>
+
+/**
+ * @brief      lock a display for writing
+ * @param[in]  *d points to a tm1637 fb display structure
+ * @param[out] *seq points to the even sequence before the write
+ * @return     status code
+ *             - 0 success
+ *             - 5 display is busy
+ * @note       the odd sequence tells the daemon and the other clients that a write is in progress
+ */
+static uint8_t a_tm1637_fb_lock(tm1637_fb_display_t *d, uint32_t *seq)
+{
+    uint_least32_t s;
+    uint32_t retry;
+
+    for (retry = 0; retry < TM1637_FB_MAX_RETRY; retry++)                                        /* loop */
+    {
+        s = atomic_load_explicit(&d->seq, memory_order_relaxed);                                  /* get seq */
+        if (((s & 1) == 0) &&
+            atomic_compare_exchange_weak_explicit(&d->seq, &s, s + 1,
+                                                  memory_order_acquire, memory_order_relaxed))    /* make it odd */
+        {
+            *seq = (uint32_t)s;                                                                   /* save seq */
+
+            return 0;                                                                             /* success return 0 */
+        }
+    }
+
+    return 5;                                                                                     /* return error */
+}
+
+/**
+ * @brief      unlock a display after writing
+ * @param[in]  *d points to a tm1637 fb display structure
+ * @param[in]  seq is the even sequence before the write
+ * @return     status code
+ *             - 0 success
+ *             - 5 the daemon took the lock back
+ * @note       the daemon makes a sequence that stays odd even again, a writer that was that slow
+ *             does not publish and the client writes again
+ */
+static uint8_t a_tm1637_fb_unlock(tm1637_fb_display_t *d, uint32_t seq)
+{
+    uint_least32_t s;
+
+    s = seq + 1;                                                                                  /* locked seq */
+    if (atomic_compare_exchange_strong_explicit(&d->seq, &s, seq + 2,
+                                                memory_order_release, memory_order_relaxed) == 0) /* publish */
+    {
+        return 5;                                                                                 /* return error */
+    }
+
+    return 0;                                                                                     /* success return 0 */
+}
+
+/**
+ * @brief     format a framebuffer
+ * @param[in] *fb points to a tm1637 fb structure
+ * @param[in] display_num is the display number
+ * @return    status code
+ *            - 0 success
+ *            - 2 fb is NULL
+ *            - 4 display_num is invalid
+ * @note      the daemon formats the shared memory before any client attaches,
+ *            every display starts blank and on with pulse width 14/16
+ */
+uint8_t tm1637_fb_format(tm1637_fb_t *fb, uint8_t display_num)
+{
+    uint8_t i;
+    uint8_t j;
+
+    if (fb == NULL)                                                                               /* check fb */
+    {
+        return 2;                                                                                 /* return error */
+    }
+    if ((display_num == 0) || (display_num > TM1637_FB_MAX_DISPLAY))                              /* check display_num */
+    {
+        return 4;                                                                                 /* return error */
+    }
+
+    fb->magic = 0;                                                                                /* not ready yet */
+    fb->display_num = display_num;                                                                /* set display_num */
+    for (i = 0; i < TM1637_FB_MAX_DISPLAY; i++)                                                   /* loop all displays */
+    {
+        atomic_init(&fb->display[i].seq, 0);                                                      /* init seq */
+        for (j = 0; j < 6; j++)                                                                   /* loop all digits */
+        {
+            atomic_init(&fb->display[i].ram[j], 0);                                               /* blank */
+        }
+        atomic_init(&fb->display[i].display, (1 << 3) | TM1637_PULSE_WIDTH_14_DIV_16);            /* on */
+    }
+    atomic_thread_fence(memory_order_release);                                                    /* publish the layout */
+    fb->magic = TM1637_FB_MAGIC;                                                                  /* set magic */
+
+    return 0;                                                                                     /* success return 0 */
+}
+
+/**
+ * @brief     check a framebuffer
+ * @param[in] *fb points to a tm1637 fb structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 fb is NULL
+ *            - 3 fb is not formatted
+ * @note      clients call it once after they map the shared memory
+ */
+uint8_t tm1637_fb_check(tm1637_fb_t *fb)
+{
+    if (fb == NULL)                                                                               /* check fb */
+    {
+        return 2;                                                                                 /* return error */
+    }
+    if ((fb->magic != TM1637_FB_MAGIC) || (fb->display_num == 0) ||
+        (fb->display_num > TM1637_FB_MAX_DISPLAY))                                                /* check the layout */
+    {
+        return 3;                                                                                 /* return error */
+    }
+
+    return 0;                                                                                     /* success return 0 */
+}
+
+/**
+ * @brief     write digits to a display
+ * @param[in] *fb points to a tm1637 fb structure
+ * @param[in] display is the display index
+ * @param[in] addr is the start address
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 2 fb or data is NULL
+ *            - 3 fb is not formatted
+ *            - 4 display is invalid or addr + len > 6
+ *            - 5 display is busy or the daemon took the lock back from this write
+ * @note      any process may call it, it only stores to the shared memory and never makes a syscall
+ */
+uint8_t tm1637_fb_write_segment(tm1637_fb_t *fb, uint8_t display, uint8_t addr, uint8_t *data, uint8_t len)
+{
+    tm1637_fb_display_t *d;
+    uint32_t seq;
+    uint8_t res;
+    uint8_t i;
+
+    if ((fb == NULL) || (data == NULL))                                                           /* check fb and data */
+    {
+        return 2;                                                                                 /* return error */
+    }
+    res = tm1637_fb_check(fb);                                                                    /* check the layout */
+    if (res != 0)                                                                                 /* check the result */
+    {
+        return res;                                                                               /* return error */
+    }
+    if ((display >= fb->display_num) || (addr + len > 6))                                         /* check display and range */
+    {
+        return 4;                                                                                 /* return error */
+    }
+
+    d = &fb->display[display];                                                                    /* display */
+    if (a_tm1637_fb_lock(d, &seq) != 0)                                                           /* lock the display */
+    {
+        return 5;                                                                                 /* return error */
+    }
+    for (i = 0; i < len; i++)                                                                     /* loop all digits */
+    {
+        atomic_store_explicit(&d->ram[addr + i], data[i], memory_order_relaxed);                  /* store the digit */
+    }
+
+    return a_tm1637_fb_unlock(d, seq);                                                            /* publish */
+}
+
+/**
+ * @brief     set the display bits of a display
+ * @param[in] *fb points to a tm1637 fb structure
+ * @param[in] display is the display index
+ * @param[in] enable is a bool value
+ * @param[in] width is the pulse width
+ * @return    status code
+ *            - 0 success
+ *            - 2 fb is NULL
+ *            - 3 fb is not formatted
+ *            - 4 display is invalid
+ *            - 5 display is busy or the daemon took the lock back from this write
+ * @note      any process may call it
+ */
+uint8_t tm1637_fb_set_display(tm1637_fb_t *fb, uint8_t display, tm1637_bool_t enable, tm1637_pulse_width_t width)
+{
+    tm1637_fb_display_t *d;
+    uint32_t seq;
+    uint8_t res;
+
+    res = tm1637_fb_check(fb);                                                                    /* check the layout */
+    if (res != 0)                                                                                 /* check the result */
+    {
+        return res;                                                                               /* return error */
+    }
+    if (display >= fb->display_num)                                                               /* check display */
+    {
+        return 4;                                                                                 /* return error */
+    }
+
+    d = &fb->display[display];                                                                    /* display */
+    if (a_tm1637_fb_lock(d, &seq) != 0)                                                           /* lock the display */
+    {
+        return 5;                                                                                 /* return error */
+    }
+    atomic_store_explicit(&d->display, (uint8_t)(((enable & 0x01) << 3) | (width & 0x07)),
+                          memory_order_relaxed);                                                  /* store the display bits */
+
+    return a_tm1637_fb_unlock(d, seq);                                                            /* publish */
+}
+
+/**
+ * @brief      take a consistent snapshot of a display
+ * @param[in]  *fb points to a tm1637 fb structure
+ * @param[in]  display is the display index
+ * @param[out] *ram points to a 6 digits buffer
+ * @param[out] *bits points to a display bits buffer
+ * @param[out] *seq points to a sequence buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 fb is NULL
+ *             - 3 fb is not formatted
+ *             - 4 display is invalid
+ *             - 5 display is busy
+ * @note       none
+ */
+uint8_t tm1637_fb_read(tm1637_fb_t *fb, uint8_t display, uint8_t *ram, uint8_t *bits, uint32_t *seq)
+{
+    tm1637_fb_display_t *d;
+    uint_least32_t s1;
+    uint_least32_t s2;
+    uint32_t retry;
+    uint8_t res;
+    uint8_t i;
+
+    res = tm1637_fb_check(fb);                                                                    /* check the layout */
+    if (res != 0)                                                                                 /* check the result */
+    {
+        return res;                                                                               /* return error */
+    }
+    if (display >= fb->display_num)                                                               /* check display */
+    {
+        return 4;                                                                                 /* return error */
+    }
+
+    d = &fb->display[display];                                                                    /* display */
+    for (retry = 0; retry < TM1637_FB_MAX_RETRY; retry++)                                         /* loop */
+    {
+        s1 = atomic_load_explicit(&d->seq, memory_order_acquire);                                 /* get seq */
+        if ((s1 & 1) != 0)                                                                        /* a client is writing */
+        {
+            continue;                                                                             /* try again */
+        }
+        for (i = 0; i < 6; i++)                                                                   /* loop all digits */
+        {
+            ram[i] = atomic_load_explicit(&d->ram[i], memory_order_relaxed);                      /* copy the digit */
+        }
+        *bits = atomic_load_explicit(&d->display, memory_order_relaxed);                          /* copy the display bits */
+        atomic_thread_fence(memory_order_acquire);                                                /* copy before the check */
+        s2 = atomic_load_explicit(&d->seq, memory_order_relaxed);                                 /* get seq again */
+        if (s1 == s2)                                                                             /* no write in between */
+        {
+            *seq = (uint32_t)s1;                                                                  /* set seq */
+
+            return 0;                                                                             /* success return 0 */
+        }
+    }
+
+    return 5;                                                                                     /* return error */
+}
+
+/**
+ * @brief     init the daemon
+ * @param[in] *daemon points to a tm1637 fb daemon structure
+ * @param[in] *fb points to a formatted tm1637 fb structure
+ * @param[in] **handle points to an array of initialized handles, display i is handle[i]
+ * @return    status code
+ *            - 0 success
+ *            - 2 daemon, fb or handle is NULL
+ *            - 3 fb is not formatted or a handle is not inited
+ * @note      every handle must use the auto increment address mode,
+ *            the first poll sends every display
+ */
+uint8_t tm1637_fb_daemon_init(tm1637_fb_daemon_t *daemon, tm1637_fb_t *fb, tm1637_handle_t **handle)
+{
+    uint8_t i;
+
+    if ((daemon == NULL) || (fb == NULL) || (handle == NULL))                                     /* check daemon, fb and handle */
+    {
+        return 2;                                                                                 /* return error */
+    }
+    if (tm1637_fb_check(fb) != 0)                                                                 /* check the layout */
+    {
+        return 3;                                                                                 /* return error */
+    }
+    for (i = 0; i < fb->display_num; i++)                                                         /* check all handles */
+    {
+        if ((handle[i] == NULL) || (handle[i]->inited != 1))                                      /* check handle initialization */
+        {
+            return 3;                                                                             /* return error */
+        }
+    }
+
+    memset(daemon, 0, sizeof(tm1637_fb_daemon_t));                                                /* clear the daemon */
+    daemon->fb = fb;                                                                              /* set fb */
+    for (i = 0; i < fb->display_num; i++)                                                         /* loop all displays */
+    {
+        daemon->handle[i] = handle[i];                                                            /* set handle */
+        daemon->seq[i] = 0xFFFFFFFFU;                                                             /* never seen, odd seq is never published */
+    }
+
+    return 0;                                                                                     /* success return 0 */
+}
+
+/**
+ * @brief      flush the changed displays
+ * @param[in]  *daemon points to a tm1637 fb daemon structure
+ * @param[out] *flushed points to a flushed display number buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 flush failed
+ *             - 2 daemon is NULL
+ * @note       a display whose sequence did not move costs one load, a changed one sends the
+ *             span of its changed digits and its display bits only when they changed,
+ *             a busy or failed display is retried by the next poll, a sequence which stays at the same
+ *             odd value for TM1637_FB_STUCK_POLL polls belongs to a dead client and is made even again
+ */
+uint8_t tm1637_fb_daemon_poll(tm1637_fb_daemon_t *daemon, uint8_t *flushed)
+{
+    tm1637_handle_t *handle;
+    uint8_t ram[6];
+    uint8_t bits;
+    uint8_t first;
+    uint8_t last;
+    uint8_t count;
+    uint8_t res;
+    uint8_t i;
+    uint32_t seq;
+    uint_least32_t seq_odd;
+
+    if (daemon == NULL)                                                                           /* check daemon */
+    {
+        return 2;                                                                                 /* return error */
+    }
+
+    res = 0;                                                                                      /* init 0 */
+    count = 0;                                                                                    /* init 0 */
+    for (i = 0; i < daemon->fb->display_num; i++)                                                 /* loop all displays */
+    {
+        seq = (uint32_t)atomic_load_explicit(&daemon->fb->display[i].seq,
+                                             memory_order_relaxed);                               /* peek seq */
+        if (seq == daemon->seq[i])                                                                /* unchanged */
+        {
+            continue;                                                                             /* next display */
+        }
+        if (tm1637_fb_read(daemon->fb, i, ram, &bits, &seq) != 0)                                 /* take a snapshot */
+        {
+            daemon->busy++;                                                                       /* busy + 1 */
+            if (((seq & 1) == 0) || (seq != daemon->odd_seq[i]))                                  /* a new write */
+            {
+                daemon->odd_seq[i] = seq;                                                         /* save seq */
+                daemon->odd_poll[i] = 0;                                                          /* init 0 */
+            }
+            else
+            {
+                daemon->odd_poll[i]++;                                                            /* poll + 1 */
+            }
+            if (((seq & 1) != 0) && (daemon->odd_poll[i] + 1 >= TM1637_FB_STUCK_POLL))            /* the writer is dead */
+            {
+                seq_odd = seq;                                                                    /* odd seq */
+                if (atomic_compare_exchange_strong_explicit(&daemon->fb->display[i].seq,
+                                                            &seq_odd, seq_odd + 1,
+                                                            memory_order_acq_rel,
+                                                            memory_order_relaxed) != 0)           /* take the lock back */
+                {
+                    daemon->recovered++;                                                          /* recovered + 1 */
+                }
+                daemon->odd_poll[i] = 0;                                                          /* init 0 */
+            }
+
+            continue;                                                                             /* next poll */
+        }
+        daemon->odd_poll[i] = 0;                                                                  /* init 0 */
+        handle = daemon->handle[i];                                                               /* display handle */
+        if ((daemon->sent_valid[i] == 0) || (bits != daemon->sent_display[i]))                    /* display bits changed */
+        {
+            if (tm1637_set_pulse_width(handle, (tm1637_pulse_width_t)(bits & 0x07)) != 0)         /* set pulse width */
+            {
+                res = 1;                                                                          /* keep the others going */
+
+                continue;                                                                         /* next display */
+            }
+            if (tm1637_set_display(handle, (tm1637_bool_t)((bits >> 3) & 0x01)) != 0)            /* set display */
+            {
+                res = 1;                                                                          /* keep the others going */
+
+                continue;                                                                         /* next display */
+            }
+            daemon->sent_display[i] = bits;                                                       /* sent */
+        }
+        first = 0;                                                                                /* init 0 */
+        last = 0;                                                                                 /* init 0 */
+        if (daemon->sent_valid[i] == 0)                                                           /* nothing sent yet */
+        {
+            last = 6;                                                                             /* whole frame */
+        }
+        else
+        {
+            while ((first < 6) && (ram[first] == daemon->sent[i][first]))                         /* find the first */
+            {
+                first++;                                                                          /* next */
+            }
+            last = 6;                                                                             /* init 6 */
+            while ((last > first) && (ram[last - 1] == daemon->sent[i][last - 1]))                /* find the last */
+            {
+                last--;                                                                           /* previous */
+            }
+        }
+        if (last > first)                                                                         /* digits changed */
+        {
+            if (tm1637_write_segment(handle, first, &ram[first], (uint8_t)(last - first)) != 0)   /* write the span */
+            {
+                res = 1;                                                                          /* keep the others going */
+
+                continue;                                                                         /* next display */
+            }
+            memcpy(&daemon->sent[i][first], &ram[first], last - first);                           /* remember the sent digits */
+            daemon->digits += (uint32_t)(last - first);                                           /* count the digits */
+        }
+        daemon->sent_valid[i] = 1;                                                                /* sent state valid */
+        daemon->seq[i] = seq;                                                                     /* flushed up to seq */
+        daemon->flushed++;                                                                        /* flushed + 1 */
+        count++;                                                                                  /* count + 1 */
+    }
+    if (flushed != NULL)                                                                          /* check flushed */
+    {
+        *flushed = count;                                                                         /* set flushed */
+    }
+
+    return res;                                                                                   /* return the result */
+}
+
+/**
+ * @brief      get the daemon statistics
+ * @param[in]  *daemon points to a tm1637 fb daemon structure
+ * @param[out] *flushed points to a flushed display counter buffer
+ * @param[out] *digits points to a sent digit counter buffer
+ * @param[out] *busy points to a busy snapshot counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 daemon is NULL
+ * @note       none
+ */
+uint8_t tm1637_fb_daemon_get_statistics(tm1637_fb_daemon_t *daemon, uint32_t *flushed, uint32_t *digits, uint32_t *busy)
+{
+    if (daemon == NULL)                                                                           /* check daemon */
+    {
+        return 2;                                                                                 /* return error */
+    }
+
+    *flushed = daemon->flushed;                                                                   /* get flushed */
+    *digits = daemon->digits;                                                                     /* get digits */
+    *busy = daemon->busy;                                                                         /* get busy */
+
+    return 0;                                                                                     /* success return 0 */
+}
@@ -0,0 +1,224 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      firmware.c
+ * @brief     firmware source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "firmware.h"
+#include "serial.h"
+#include "driver_tm1637_interface.h"
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+/**
+ * @brief shared interface ops
+ */
+static const tm1637_ops_t gc_ops =
+{
+    tm1637_interface_iic_init_ctx,
+    tm1637_interface_iic_deinit_ctx,
+    tm1637_interface_iic_write_cmd_custom_ctx,
+    tm1637_interface_iic_read_cmd_custom_ctx,
+    tm1637_interface_delay_ms_ctx,
+    tm1637_interface_timestamp_us_ctx,
+    tm1637_interface_lock_ctx,
+    tm1637_interface_unlock_ctx,
+};
+
+static tm1637_handle_t gs_handle[16];                /**< tm1637 handles */
+static tm1637_handle_t *gs_handle_list[16];          /**< tm1637 handle list */
+static tm1637_link_server_t gs_server;               /**< link server */
+static int gs_master;                                /**< pty master */
+static int gs_slave;                                 /**< pty slave kept open */
+static pthread_t gs_thread;                          /**< firmware thread */
+static atomic_int gs_stop;                           /**< stop flag */
+
+/**
+ * @brief     firmware close the opened displays
+ * @param[in] num is the opened display number
+ * @note      none
+ */
+static void a_firmware_close(uint8_t num)
+{
+    while (num != 0)
+    {
+        num--;
+        (void)tm1637_deinit(&gs_handle[num]);
+    }
+}
+
+/**
+ * @brief     firmware main loop
+ * @param[in] *arg is unused
+ * @return    NULL
+ * @note      one chunk is what uart_read of the stm32 firmware returns
+ */
+static void *a_firmware_run(void *arg)
+{
+    uint8_t buf[FIRMWARE_RX_LEN];
+    struct pollfd pfd;
+    ssize_t n;
+    size_t len;
+    
+    (void)arg;
+    pfd.fd = gs_master;
+    pfd.events = POLLIN;
+    while (atomic_load(&gs_stop) == 0)
+    {
+        if ((poll(&pfd, 1, 10) <= 0) || ((pfd.revents & POLLIN) == 0))
+        {
+            continue;
+        }
+        
+        /* like uart_read, collect until the line is idle for 1 ms */
+        len = 0;
+        do
+        {
+            n = read(gs_master, &buf[len], sizeof(buf) - len);
+            if (n > 0)
+            {
+                len += (size_t)n;
+            }
+        } while ((len < sizeof(buf)) && (poll(&pfd, 1, 1) > 0) && ((pfd.revents & POLLIN) != 0));
+        if (len != 0)
+        {
+            (void)tm1637_link_server_input(&gs_server, buf, (uint16_t)len);
+        }
+    }
+    
+    return NULL;
+}
+
+/**
+ * @brief      firmware start
+ * @param[in]  **ctx points to a bus context array, display i is on ctx[i]
+ * @param[in]  num is the display number
+ * @param[out] *name points to a serial port name buffer
+ * @param[in]  len is the name buffer length
+ * @return     status code
+ *             - 0 success
+ *             - 1 start failed
+ * @note       a thread runs the link server of the stm32 firmware on a pty,
+ *             name is the pty slave a link client opens as its serial port
+ */
+uint8_t firmware_start(void **ctx, uint8_t num, char *name, size_t len)
+{
+    uint8_t i;
+    
+    if ((num == 0) || (num > 16))
+    {
+        return 1;
+    }
+    
+    /* the firmware owns every display */
+    for (i = 0; i < num; i++)
+    {
+        DRIVER_TM1637_LINK_INIT(&gs_handle[i], tm1637_handle_t);
+        DRIVER_TM1637_LINK_OPS(&gs_handle[i], &gc_ops);
+        DRIVER_TM1637_LINK_CTX(&gs_handle[i], ctx[i]);
+        DRIVER_TM1637_LINK_DEBUG_PRINT(&gs_handle[i], tm1637_interface_debug_print);
+        if (tm1637_init(&gs_handle[i]) != 0)
+        {
+            a_firmware_close(i);
+            
+            return 1;
+        }
+        if (tm1637_set_address_mode(&gs_handle[i], TM1637_ADDRESS_MODE_INC) != 0)
+        {
+            a_firmware_close(i + 1);
+            
+            return 1;
+        }
+        gs_handle_list[i] = &gs_handle[i];
+    }
+    
+    /* the pty stands in for the usb uart */
+    if (serial_pty_open(&gs_master, name, len) != 0)
+    {
+        a_firmware_close(num);
+        
+        return 1;
+    }
+    if (serial_open(name, 115200, &gs_slave) != 0)
+    {
+        (void)close(gs_master);
+        a_firmware_close(num);
+        
+        return 1;
+    }
+    (void)tm1637_link_server_init(&gs_server, gs_handle_list, num, serial_write, &gs_master);
+    
+    /* run the firmware */
+    atomic_store(&gs_stop, 0);
+    if (pthread_create(&gs_thread, NULL, a_firmware_run, NULL) != 0)
+    {
+        (void)serial_close(gs_slave);
+        (void)close(gs_master);
+        a_firmware_close(num);
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  firmware stop
+ * @return status code
+ *         - 0 success
+ * @note   like the stm32 firmware the displays are never deinitialized and keep the last frame
+ */
+uint8_t firmware_stop(void)
+{
+    atomic_store(&gs_stop, 1);
+    (void)pthread_join(gs_thread, NULL);
+    (void)serial_close(gs_slave);
+    (void)close(gs_master);
+    
+    return 0;
+}
+
+/**
+ * @brief      firmware get the link server statistics
+ * @param[out] *frames points to a good frame counter buffer
+ * @param[out] *errors points to a bad frame counter buffer
+ * @return     status code
+ *             - 0 success
+ * @note       call it after firmware_stop
+ */
+uint8_t firmware_get_statistics(uint32_t *frames, uint32_t *errors)
+{
+    return tm1637_link_server_get_statistics(&gs_server, frames, errors);
+}
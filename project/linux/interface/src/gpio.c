@@ -0,0 +1,671 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      gpio.c
+ * @brief     gpio source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "gpio.h"
+#include "delay.h"
+#include <pthread.h>
+#include <string.h>
+
+/**
+ * @brief gpio port definition
+ */
+#define GPIO_PARALLEL_LINE        16        /**< 16 dio lines */
+
+static model_t gs_parallel_model[GPIO_PARALLEL_LINE];        /**< parallel port models */
+static uint32_t gs_parallel_dio = 0xFFFFFFFFU;               /**< parallel port output register */
+static uint8_t gs_parallel_clk = 1;                          /**< parallel port clock */
+static uint8_t gs_parallel_power = 0;                        /**< parallel port models powered flag */
+static model_t gs_iic_model;                                 /**< iic port model */
+static uint8_t gs_iic_sda = 1;                               /**< iic port sda output */
+static uint8_t gs_iic_scl = 1;                               /**< iic port scl output */
+static uint8_t gs_iic_power = 0;                             /**< iic port model powered flag */
+static pthread_mutex_t gs_parallel_lock = PTHREAD_MUTEX_INITIALIZER;        /**< parallel port lock */
+static model_t gs_bus_model[GPIO_BUS_NUM][GPIO_BUS_LANE];                   /**< bus chain models */
+static void (*gs_iic_probe)(uint8_t read, uint8_t scl, uint8_t sda, uint8_t chip) = NULL;        /**< iic port probe */
+
+/**
+ * @brief gpio parallel port update
+ * @note  none
+ */
+static void a_gpio_parallel_update(void)
+{
+    uint8_t i;
+    
+    for (i = 0; i < GPIO_PARALLEL_LINE; i++)
+    {
+        model_update(&gs_parallel_model[i], gs_parallel_clk,
+                     ((gs_parallel_dio >> i) & 0x01) & model_dio(&gs_parallel_model[i]));
+    }
+}
+
+/**
+ * @brief  gpio parallel port init
+ * @return status code
+ *         - 0 success
+ * @note   CLK is shared and DIO0 - DIO15 each connect to one tm1637 model
+ */
+uint8_t gpio_parallel_init(void)
+{
+    uint8_t i;
+    
+    /* the chips keep their ram across host inits */
+    if (gs_parallel_power == 0)
+    {
+        for (i = 0; i < GPIO_PARALLEL_LINE; i++)
+        {
+            model_init(&gs_parallel_model[i]);
+        }
+        gs_parallel_power = 1;
+    }
+    gs_parallel_dio = 0xFFFFFFFFU;
+    gs_parallel_clk = 1;
+    
+    return 0;
+}
+
+/**
+ * @brief  gpio parallel port deinit
+ * @return status code
+ *         - 0 success
+ * @note   none
+ */
+uint8_t gpio_parallel_deinit(void)
+{
+    return 0;
+}
+
+/**
+ * @brief     gpio parallel clock write
+ * @param[in] level is the clock level
+ * @note      none
+ */
+void gpio_parallel_clk_write(uint8_t level)
+{
+    gs_parallel_clk = (level != 0) ? 1 : 0;
+    a_gpio_parallel_update();
+}
+
+/**
+ * @brief     gpio parallel data write
+ * @param[in] mask is the pin mask
+ * @param[in] level is the pin level
+ * @note      all masked pins change in one write
+ */
+void gpio_parallel_dio_write(uint32_t mask, uint32_t level)
+{
+    gs_parallel_dio = (gs_parallel_dio & ~mask) | (level & mask);
+    a_gpio_parallel_update();
+}
+
+/**
+ * @brief  gpio parallel data read
+ * @return port input level
+ * @note   every line is the wired and of the host and the model
+ */
+uint32_t gpio_parallel_dio_read(void)
+{
+    uint32_t level;
+    uint8_t i;
+    
+    level = gs_parallel_dio;
+    for (i = 0; i < GPIO_PARALLEL_LINE; i++)
+    {
+        if (model_dio(&gs_parallel_model[i]) == 0)
+        {
+            level &= ~(1U << i);
+        }
+    }
+    
+    return level;
+}
+
+/**
+ * @brief     gpio parallel model
+ * @param[in] line is the dio line
+ * @return    pointer to the tm1637 model on the line
+ * @note      0 <= line <= 15
+ */
+model_t *gpio_parallel_model(uint8_t line)
+{
+    return &gs_parallel_model[line % GPIO_PARALLEL_LINE];
+}
+
+/**
+ * @brief  gpio parallel port lock
+ * @return status code
+ *         - 0 success
+ *         - 1 lock failed
+ * @note   every chip on the port shares the clock, so one transfer at a time,
+ *         it blocks until the holder unlocks
+ */
+uint8_t gpio_parallel_lock(void)
+{
+    if (pthread_mutex_lock(&gs_parallel_lock) != 0)
+    {
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief gpio parallel port unlock
+ * @note  none
+ */
+void gpio_parallel_unlock(void)
+{
+    (void)pthread_mutex_unlock(&gs_parallel_lock);
+}
+
+/**
+ * @brief     gpio line send start
+ * @param[in] mask is the line mask
+ * @note      the other lines stay released, so their chips never see a start
+ */
+static void a_gpio_line_start(uint32_t mask)
+{
+    gpio_parallel_dio_write(mask, 0xFFFFFFFFU);
+    gpio_parallel_clk_write(1);
+    delay_us(4);
+    gpio_parallel_dio_write(mask, 0);
+    delay_us(4);
+    gpio_parallel_clk_write(0);
+    delay_us(4);
+}
+
+/**
+ * @brief     gpio line send stop
+ * @param[in] mask is the line mask
+ * @note      none
+ */
+static void a_gpio_line_stop(uint32_t mask)
+{
+    gpio_parallel_dio_write(mask, 0);
+    delay_us(4);
+    gpio_parallel_clk_write(1);
+    delay_us(4);
+    gpio_parallel_dio_write(mask, 0xFFFFFFFFU);
+    delay_us(4);
+}
+
+/**
+ * @brief     gpio line wait ack
+ * @param[in] mask is the line mask
+ * @return    status code
+ *            - 0 success
+ *            - 1 no ack
+ * @note      none
+ */
+static uint8_t a_gpio_line_wait_ack(uint32_t mask)
+{
+    uint32_t res;
+    
+    gpio_parallel_dio_write(mask, 0xFFFFFFFFU);
+    delay_us(4);
+    gpio_parallel_clk_write(1);
+    delay_us(4);
+    res = gpio_parallel_dio_read() & mask;
+    gpio_parallel_clk_write(0);
+    delay_us(4);
+    if (res != 0)
+    {
+        a_gpio_line_stop(mask);
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     gpio line send a byte
+ * @param[in] mask is the line mask
+ * @param[in] txd is the sent byte
+ * @note      msb first like the iic port
+ */
+static void a_gpio_line_send_byte(uint32_t mask, uint8_t txd)
+{
+    uint8_t t;
+    
+    gpio_parallel_clk_write(0);
+    for (t = 0; t < 8; t++)
+    {
+        gpio_parallel_dio_write(mask, ((txd & 0x80) != 0) ? 0xFFFFFFFFU : 0);
+        txd <<= 1;
+        delay_us(2);
+        gpio_parallel_clk_write(1);
+        delay_us(2);
+        gpio_parallel_clk_write(0);
+        delay_us(2);
+    }
+}
+
+/**
+ * @brief     gpio line read a byte
+ * @param[in] mask is the line mask
+ * @param[in] ack is the ack flag
+ * @return    read byte
+ * @note      msb first like the iic port
+ */
+static uint8_t a_gpio_line_read_byte(uint32_t mask, uint8_t ack)
+{
+    uint8_t i;
+    uint8_t receive = 0;
+    
+    gpio_parallel_dio_write(mask, 0xFFFFFFFFU);
+    for (i = 0; i < 8; i++)
+    {
+        gpio_parallel_clk_write(0);
+        delay_us(2);
+        gpio_parallel_clk_write(1);
+        receive <<= 1;
+        if ((gpio_parallel_dio_read() & mask) != 0)
+        {
+            receive++;
+        }
+        delay_us(2);
+    }
+    gpio_parallel_clk_write(0);
+    delay_us(4);
+    gpio_parallel_dio_write(mask, (ack != 0) ? 0 : 0xFFFFFFFFU);
+    delay_us(4);
+    gpio_parallel_clk_write(1);
+    delay_us(4);
+    gpio_parallel_clk_write(0);
+    delay_us(4);
+    
+    return receive;
+}
+
+/**
+ * @brief     gpio line write command
+ * @param[in] line is the dio line
+ * @param[in] addr is the command
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      it talks to the chip on one dio line of the parallel port like the iic port does
+ */
+uint8_t gpio_line_write_cmd(uint8_t line, uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    uint32_t mask;
+    uint16_t i;
+    
+    mask = 1U << (line % GPIO_PARALLEL_LINE);
+    
+    /* send a start */
+    a_gpio_line_start(mask);
+    
+    /* send the command */
+    a_gpio_line_send_byte(mask, addr);
+    if (a_gpio_line_wait_ack(mask) != 0)
+    {
+        return 1;
+    }
+    
+    /* write the data */
+    for (i = 0; i < len; i++)
+    {
+        a_gpio_line_send_byte(mask, buf[i]);
+        if (a_gpio_line_wait_ack(mask) != 0)
+        {
+            return 1;
+        }
+    }
+    
+    /* send a stop */
+    a_gpio_line_stop(mask);
+    
+    return 0;
+}
+
+/**
+ * @brief      gpio line read command
+ * @param[in]  line is the dio line
+ * @param[in]  addr is the command
+ * @param[out] *buf points to a data buffer
+ * @param[in]  len is the data length
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       it talks to the chip on one dio line of the parallel port like the iic port does
+ */
+uint8_t gpio_line_read_cmd(uint8_t line, uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    uint32_t mask;
+    
+    mask = 1U << (line % GPIO_PARALLEL_LINE);
+    
+    /* send a start */
+    a_gpio_line_start(mask);
+    
+    /* send the command */
+    a_gpio_line_send_byte(mask, addr);
+    if (a_gpio_line_wait_ack(mask) != 0)
+    {
+        return 1;
+    }
+    
+    /* read the data */
+    while (len != 0)
+    {
+        /* the last byte gets a nack */
+        *buf = a_gpio_line_read_byte(mask, (len == 1) ? 0 : 1);
+        len--;
+        buf++;
+    }
+    
+    /* send a stop */
+    a_gpio_line_stop(mask);
+    
+    return 0;
+}
+
+/**
+ * @brief bus pin pair structure definition
+ */
+typedef struct gpio_bus_pin_s
+{
+    model_t *model;        /**< chip on the pin pair */
+    uint8_t clk;           /**< clock output */
+    uint8_t dio;           /**< data output */
+} gpio_bus_pin_t;
+
+/**
+ * @brief     gpio bus pin write
+ * @param[in] *pin points to a bus pin pair structure
+ * @param[in] clk is the clock level
+ * @param[in] dio is the data level
+ * @note      the data line is the wired and of the host and the chip
+ */
+static void a_gpio_bus_write(gpio_bus_pin_t *pin, uint8_t clk, uint8_t dio)
+{
+    pin->clk = clk;
+    pin->dio = dio;
+    model_update(pin->model, clk, dio & model_dio(pin->model));
+    delay_us(1);
+}
+
+/**
+ * @brief     gpio bus send a byte and wait the ack
+ * @param[in] *pin points to a bus pin pair structure
+ * @param[in] txd is the sent byte
+ * @return    status code
+ *            - 0 success
+ *            - 1 no ack
+ * @note      lsb first on the wire like the chip expects
+ */
+static uint8_t a_gpio_bus_send_byte(gpio_bus_pin_t *pin, uint8_t txd)
+{
+    uint8_t t;
+    uint8_t ack;
+    
+    for (t = 0; t < 8; t++)
+    {
+        a_gpio_bus_write(pin, 0, (txd >> t) & 0x01);
+        a_gpio_bus_write(pin, 1, pin->dio);
+    }
+    a_gpio_bus_write(pin, 0, 1);
+    a_gpio_bus_write(pin, 1, 1);
+    ack = model_dio(pin->model);
+    a_gpio_bus_write(pin, 0, 1);
+    
+    return (ack != 0) ? 1 : 0;
+}
+
+/**
+ * @brief     gpio bus send a command
+ * @param[in] *pin points to a bus pin pair structure
+ * @param[in] *buf points to a command and its data
+ * @param[in] len is the byte number
+ * @return    status code
+ *            - 0 success
+ *            - 1 no ack
+ * @note      none
+ */
+static uint8_t a_gpio_bus_command(gpio_bus_pin_t *pin, uint8_t *buf, uint8_t len)
+{
+    uint8_t i;
+    uint8_t res;
+    
+    /* send a start */
+    a_gpio_bus_write(pin, 1, 1);
+    a_gpio_bus_write(pin, 1, 0);
+    
+    /* send the bytes */
+    res = 0;
+    for (i = 0; (i < len) && (res == 0); i++)
+    {
+        res = a_gpio_bus_send_byte(pin, buf[i]);
+    }
+    
+    /* send a stop */
+    a_gpio_bus_write(pin, 0, 0);
+    a_gpio_bus_write(pin, 1, 0);
+    a_gpio_bus_write(pin, 1, 1);
+    
+    return res;
+}
+
+/**
+ * @brief  gpio bus chain init
+ * @return status code
+ *         - 0 success
+ * @note   every bus has its own clock and lanes, so buses run in parallel without a lock
+ */
+uint8_t gpio_bus_init(void)
+{
+    uint8_t b;
+    uint8_t l;
+    
+    for (b = 0; b < GPIO_BUS_NUM; b++)
+    {
+        for (l = 0; l < GPIO_BUS_LANE; l++)
+        {
+            model_init(&gs_bus_model[b][l]);
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     gpio bus write segment
+ * @param[in] *ctx points to a uint8_t bus id
+ * @param[in] lane is the chip on the bus
+ * @param[in] addr is the start address
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      it matches the fleet write_segment ops
+ */
+uint8_t gpio_bus_write_segment(void *ctx, uint16_t lane, uint8_t addr, uint8_t *data, uint8_t len)
+{
+    gpio_bus_pin_t pin;
+    uint8_t buf[7];
+    
+    if ((ctx == NULL) || (*(uint8_t *)ctx >= GPIO_BUS_NUM) || (lane >= GPIO_BUS_LANE) || (len > 6))
+    {
+        return 1;
+    }
+    pin.model = &gs_bus_model[*(uint8_t *)ctx][lane];
+    pin.clk = 1;
+    pin.dio = 1;
+    
+    /* auto increment data command */
+    buf[0] = 0x40;
+    if (a_gpio_bus_command(&pin, buf, 1) != 0)
+    {
+        return 1;
+    }
+    
+    /* address command and the digits */
+    buf[0] = (uint8_t)(0xC0 | addr);
+    memcpy(&buf[1], data, len);
+    
+    return a_gpio_bus_command(&pin, buf, (uint8_t)(len + 1));
+}
+
+/**
+ * @brief     gpio bus write display
+ * @param[in] *ctx points to a uint8_t bus id
+ * @param[in] lane is the chip on the bus
+ * @param[in] display is the display bits
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      it matches the fleet write_display ops
+ */
+uint8_t gpio_bus_write_display(void *ctx, uint16_t lane, uint8_t display)
+{
+    gpio_bus_pin_t pin;
+    uint8_t buf[1];
+    
+    if ((ctx == NULL) || (*(uint8_t *)ctx >= GPIO_BUS_NUM) || (lane >= GPIO_BUS_LANE))
+    {
+        return 1;
+    }
+    pin.model = &gs_bus_model[*(uint8_t *)ctx][lane];
+    pin.clk = 1;
+    pin.dio = 1;
+    
+    /* display command */
+    buf[0] = (uint8_t)(0x80 | (display & 0x0F));
+    
+    return a_gpio_bus_command(&pin, buf, 1);
+}
+
+/**
+ * @brief     gpio bus model
+ * @param[in] bus is the bus id
+ * @param[in] lane is the chip on the bus
+ * @return    pointer to the tm1637 model
+ * @note      none
+ */
+model_t *gpio_bus_model(uint8_t bus, uint16_t lane)
+{
+    return &gs_bus_model[bus % GPIO_BUS_NUM][lane % GPIO_BUS_LANE];
+}
+
+/**
+ * @brief  gpio iic port init
+ * @return status code
+ *         - 0 success
+ * @note   SCL and SDA connect to one tm1637 model
+ */
+uint8_t gpio_iic_init(void)
+{
+    /* the chip keeps its ram across host inits */
+    if (gs_iic_power == 0)
+    {
+        model_init(&gs_iic_model);
+        gs_iic_power = 1;
+    }
+    gs_iic_sda = 1;
+    gs_iic_scl = 1;
+    
+    return 0;
+}
+
+/**
+ * @brief     gpio iic scl write
+ * @param[in] level is the scl level
+ * @note      none
+ */
+void gpio_iic_scl_write(uint8_t level)
+{
+    gs_iic_scl = (level != 0) ? 1 : 0;
+    model_update(&gs_iic_model, gs_iic_scl, gs_iic_sda & model_dio(&gs_iic_model));
+    if (gs_iic_probe != NULL)
+    {
+        gs_iic_probe(0, gs_iic_scl, gs_iic_sda, model_dio(&gs_iic_model));
+    }
+}
+
+/**
+ * @brief     gpio iic sda write
+ * @param[in] level is the sda level
+ * @note      1 releases the line
+ */
+void gpio_iic_sda_write(uint8_t level)
+{
+    gs_iic_sda = (level != 0) ? 1 : 0;
+    model_update(&gs_iic_model, gs_iic_scl, gs_iic_sda & model_dio(&gs_iic_model));
+    if (gs_iic_probe != NULL)
+    {
+        gs_iic_probe(0, gs_iic_scl, gs_iic_sda, model_dio(&gs_iic_model));
+    }
+}
+
+/**
+ * @brief  gpio iic sda read
+ * @return sda level
+ * @note   none
+ */
+uint8_t gpio_iic_sda_read(void)
+{
+    if (gs_iic_probe != NULL)
+    {
+        gs_iic_probe(1, gs_iic_scl, gs_iic_sda, model_dio(&gs_iic_model));
+    }
+    
+    return gs_iic_sda & model_dio(&gs_iic_model);
+}
+
+/**
+ * @brief  gpio iic model
+ * @return pointer to the tm1637 model on the iic port
+ * @note   none
+ */
+model_t *gpio_iic_model(void)
+{
+    return &gs_iic_model;
+}
+
+/**
+ * @brief     gpio iic set the probe
+ * @param[in] *probe points to a probe function, NULL removes it
+ * @note      the probe gets the scl, the sda driven by the host and the sda driven by the chip
+ *            after every pin write with read 0 and before every sda read with read 1
+ */
+void gpio_iic_set_probe(void (*probe)(uint8_t read, uint8_t scl, uint8_t sda, uint8_t chip))
+{
+    gs_iic_probe = probe;
+}
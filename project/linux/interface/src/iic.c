@@ -0,0 +1,336 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      iic.c
+ * @brief     iic source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "iic.h"
+#include "gpio.h"
+#include "delay.h"
+#include <pthread.h>
+
+/**
+ * @brief iic gpio operate definition
+ */
+#define IIC_SCL(level)    gpio_iic_scl_write(level)
+#define IIC_SDA(level)    gpio_iic_sda_write(level)
+#define READ_SDA          gpio_iic_sda_read()
+
+static pthread_mutex_t gs_lock = PTHREAD_MUTEX_INITIALIZER;        /**< bus lock */
+static uint32_t gs_phase_ns = 15000;                               /**< start, stop and ack phase */
+static uint32_t gs_bit_ns = 10000;                                 /**< data bit phase */
+
+/**
+ * @brief  iic bus init
+ * @return status code
+ *         - 0 success
+ * @note   SCL and SDA are the simulated iic port
+ */
+uint8_t iic_init(void)
+{
+    (void)gpio_iic_init();
+    
+    /* set sda high */
+    IIC_SDA(1);
+    
+    /* set scl high */
+    IIC_SCL(1);
+    
+    return 0;
+}
+
+/**
+ * @brief  iic bus deinit
+ * @return status code
+ *         - 0 success
+ * @note   none
+ */
+uint8_t iic_deinit(void)
+{
+    return 0;
+}
+
+/**
+ * @brief  iic bus lock
+ * @return status code
+ *         - 0 success
+ *         - 1 lock failed
+ * @note   all devices sharing the SCL and SDA pins should hold this lock for a whole transfer sequence,
+ *         it blocks until the holder unlocks
+ */
+uint8_t iic_lock(void)
+{
+    if (pthread_mutex_lock(&gs_lock) != 0)
+    {
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief iic bus unlock
+ * @note  none
+ */
+void iic_unlock(void)
+{
+    (void)pthread_mutex_unlock(&gs_lock);
+}
+
+/**
+ * @brief     iic bus set the timing
+ * @param[in] phase_ns is the start, stop and ack phase
+ * @param[in] bit_ns is the data bit phase
+ * @note      the default is 15us and 10us like the stm32f407 port
+ */
+void iic_set_timing(uint32_t phase_ns, uint32_t bit_ns)
+{
+    gs_phase_ns = phase_ns;
+    gs_bit_ns = bit_ns;
+}
+
+/**
+ * @brief      iic bus get the timing
+ * @param[out] *phase_ns points to a start, stop and ack phase buffer
+ * @param[out] *bit_ns points to a data bit phase buffer
+ * @note       none
+ */
+void iic_get_timing(uint32_t *phase_ns, uint32_t *bit_ns)
+{
+    *phase_ns = gs_phase_ns;
+    *bit_ns = gs_bit_ns;
+}
+
+/**
+ * @brief iic bus send start
+ * @note  the edges are the same as the stm32f407 port, sda goes back high after scl is low
+ */
+static void a_iic_start(void)
+{
+    IIC_SCL(1);
+    delay_ns(gs_phase_ns);
+    IIC_SDA(0);
+    delay_ns(gs_phase_ns);
+    IIC_SCL(0);
+    delay_ns(gs_phase_ns);
+    IIC_SDA(1);
+    delay_ns(gs_phase_ns);
+}
+
+/**
+ * @brief iic bus send stop
+ * @note  none
+ */
+static void a_iic_stop(void)
+{
+    IIC_SDA(0);
+    delay_ns(gs_phase_ns);
+    IIC_SCL(1);
+    delay_ns(gs_phase_ns);
+    IIC_SDA(1);
+    delay_ns(gs_phase_ns);
+}
+
+/**
+ * @brief  iic wait ack
+ * @return status code
+ *         - 0 get ack
+ *         - 1 no ack
+ * @note   none
+ */
+static uint8_t a_iic_wait_ack(void)
+{
+    uint8_t res;
+    
+    IIC_SDA(1);
+    delay_ns(gs_phase_ns);
+    IIC_SCL(1);
+    delay_ns(gs_phase_ns);
+    res = READ_SDA;
+    IIC_SCL(0);
+    delay_ns(gs_phase_ns);
+    if (res != 0)
+    {
+        a_iic_stop();
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     iic bus send ack or nack
+ * @param[in] level is 0 for ack and 1 for nack
+ * @note      none
+ */
+static void a_iic_ack(uint8_t level)
+{
+    IIC_SCL(0);
+    delay_ns(gs_phase_ns);
+    IIC_SDA(level);
+    delay_ns(gs_phase_ns);
+    IIC_SCL(1);
+    delay_ns(gs_phase_ns);
+    IIC_SCL(0);
+    delay_ns(gs_phase_ns);
+}
+
+/**
+ * @brief     iic send one byte
+ * @param[in] txd is the sent byte
+ * @note      none
+ */
+static void a_iic_send_byte(uint8_t txd)
+{
+    uint8_t t;
+    
+    IIC_SCL(0);
+    for (t = 0; t < 8; t++)
+    {
+        IIC_SDA((txd & 0x80) >> 7);
+        txd <<= 1;
+        delay_ns(gs_bit_ns);
+        IIC_SCL(1);
+        delay_ns(gs_bit_ns);
+        IIC_SCL(0);
+        delay_ns(gs_bit_ns);
+    }
+}
+
+/**
+ * @brief     iic read one byte
+ * @param[in] ack is the sent ack
+ * @return    read byte
+ * @note      none
+ */
+static uint8_t a_iic_read_byte(uint8_t ack)
+{
+    uint8_t i;
+    uint8_t receive = 0;
+    
+    IIC_SDA(1);
+    for (i = 0; i < 8; i++)
+    {
+        IIC_SCL(0);
+        delay_ns(gs_bit_ns);
+        IIC_SCL(1);
+        receive <<= 1;
+        if (READ_SDA != 0)
+        {
+            receive++;
+        }
+        delay_ns(gs_bit_ns);
+    }
+    a_iic_ack((ack != 0) ? 0 : 1);
+    
+    return receive;
+}
+
+/**
+ * @brief     iic bus write command
+ * @param[in] addr is the iic device write address
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      addr = device_address_7bits << 1
+ */
+uint8_t iic_write_cmd(uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    uint16_t i;
+    
+    /* send a start */
+    a_iic_start();
+    
+    /* send the write addr */
+    a_iic_send_byte(addr);
+    if (a_iic_wait_ack() != 0)
+    {
+        return 1;
+    }
+    
+    /* write the data */
+    for (i = 0; i < len; i++)
+    {
+        /* send one byte */
+        a_iic_send_byte(buf[i]);
+        if (a_iic_wait_ack() != 0)
+        {
+            return 1;
+        }
+    }
+    
+    /* send a stop */
+    a_iic_stop();
+    
+    return 0;
+}
+
+/**
+ * @brief      iic bus read command
+ * @param[in]  addr is the iic device write address
+ * @param[out] *buf points to a data buffer
+ * @param[in]  len is the length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       addr = device_address_7bits << 1
+ */
+uint8_t iic_read_cmd(uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    /* send a start */
+    a_iic_start();
+    
+    /* send the read addr */
+    a_iic_send_byte(addr);
+    if (a_iic_wait_ack() != 0)
+    {
+        return 1;
+    }
+    
+    /* read the data */
+    while (len != 0)
+    {
+        /* the last byte gets a nack */
+        *buf = a_iic_read_byte((len == 1) ? 0 : 1);
+        len--;
+        buf++;
+    }
+    
+    /* send a stop */
+    a_iic_stop();
+    
+    return 0;
+}
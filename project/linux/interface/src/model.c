@@ -0,0 +1,232 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      model.c
+ * @brief     model source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "model.h"
+#include <string.h>
+
+/**
+ * @brief model state definition
+ */
+#define MODEL_STATE_IDLE        0        /**< wait for a start */
+#define MODEL_STATE_RECEIVE     1        /**< receive a byte */
+#define MODEL_STATE_ACK         2        /**< drive the ack */
+#define MODEL_STATE_KEY         3        /**< send the key data */
+#define MODEL_STATE_DONE        4        /**< wait for a stop */
+
+/**
+ * @brief     model init
+ * @param[in] *model points to a model structure
+ * @note      it is the power on state of the chip
+ */
+void model_init(model_t *model)
+{
+    memset(model, 0, sizeof(model_t));
+    model->clk = 1;
+    model->dio = 1;
+    model->out = 1;
+    model->key = 0xFF;
+    model->ack_enable = 1;
+}
+
+/**
+ * @brief     model byte process
+ * @param[in] *model points to a model structure
+ * @param[in] byte is the received byte
+ * @note      none
+ */
+static void a_model_byte(model_t *model, uint8_t byte)
+{
+    model->bytes++;
+    if (model->index == 0)
+    {
+        model->command = byte;
+        switch (byte & 0xC0)
+        {
+            /* data command */
+            case 0x40 :
+            {
+                model->read = (byte >> 1) & 0x01;
+                model->fixed = (byte >> 2) & 0x01;
+                model->test = (byte >> 3) & 0x01;
+                
+                break;
+            }
+            
+            /* display command */
+            case 0x80 :
+            {
+                model->display = byte & 0x0F;
+                
+                break;
+            }
+            
+            /* address command */
+            case 0xC0 :
+            {
+                model->addr = byte & 0x07;
+                
+                break;
+            }
+            
+            /* unknown command */
+            default :
+            {
+                model->errors++;
+                
+                break;
+            }
+        }
+    }
+    else
+    {
+        /* only the address command carries data */
+        if (((model->command & 0xC0) != 0xC0) || (model->addr > 5))
+        {
+            model->errors++;
+        }
+        else
+        {
+            model->ram[model->addr] = byte;
+            if (model->fixed == 0)
+            {
+                model->addr++;
+            }
+        }
+    }
+    model->index++;
+}
+
+/**
+ * @brief     model update
+ * @param[in] *model points to a model structure
+ * @param[in] clk is the clock line level
+ * @param[in] dio is the data line level
+ * @note      call it after every change of the lines
+ */
+void model_update(model_t *model, uint8_t clk, uint8_t dio)
+{
+    clk = (clk != 0) ? 1 : 0;
+    dio = (dio != 0) ? 1 : 0;
+    if ((clk == 1) && (model->clk == 1) && (dio != model->dio))
+    {
+        if (dio == 0)
+        {
+            /* start */
+            model->state = MODEL_STATE_RECEIVE;
+            model->bit = 0;
+            model->shift = 0;
+            model->index = 0;
+            model->out = 1;
+        }
+        else
+        {
+            /* stop, the clock of the stop itself is sampled as a partial bit */
+            model->state = MODEL_STATE_IDLE;
+            model->out = 1;
+        }
+    }
+    else if ((clk == 1) && (model->clk == 0))
+    {
+        /* rising edge, sample lsb first */
+        if ((model->state == MODEL_STATE_RECEIVE) && (model->bit < 8))
+        {
+            model->shift |= (uint8_t)(dio << model->bit);
+            model->bit++;
+        }
+    }
+    else if ((clk == 0) && (model->clk == 1))
+    {
+        /* falling edge, drive the line */
+        if ((model->state == MODEL_STATE_RECEIVE) && (model->bit == 8))
+        {
+            a_model_byte(model, model->shift);
+            model->bit = 0;
+            model->shift = 0;
+            model->state = MODEL_STATE_ACK;
+            model->out = (model->ack_enable != 0) ? 0 : 1;
+        }
+        else if (model->state == MODEL_STATE_ACK)
+        {
+            if ((model->index == 1) && ((model->command & 0xC0) == 0x40) && (model->read != 0))
+            {
+                /* key data lsb first */
+                model->state = MODEL_STATE_KEY;
+                model->bit = 0;
+                model->out = model->key & 0x01;
+            }
+            else
+            {
+                model->state = MODEL_STATE_RECEIVE;
+                model->out = 1;
+            }
+        }
+        else if (model->state == MODEL_STATE_KEY)
+        {
+            model->bit++;
+            if (model->bit < 8)
+            {
+                model->out = (model->key >> model->bit) & 0x01;
+            }
+            else
+            {
+                model->bit = 0;
+                model->state = MODEL_STATE_DONE;
+                model->out = 1;
+            }
+        }
+        else
+        {
+            /* nothing to do */
+        }
+    }
+    else
+    {
+        /* nothing changed */
+    }
+    model->clk = clk;
+    model->dio = dio & model->out;
+}
+
+/**
+ * @brief     model data output
+ * @param[in] *model points to a model structure
+ * @return    data level driven by the chip, 1 releases the line
+ * @note      none
+ */
+uint8_t model_dio(model_t *model)
+{
+    return model->out;
+}
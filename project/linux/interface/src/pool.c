@@ -0,0 +1,532 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      pool.c
+ * @brief     pool source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "pool.h"
+#include <string.h>
+
+/**
+ * @brief     queue a task on a worker
+ * @param[in] *pool points to a tm1637 pool structure
+ * @param[in] worker is the worker index
+ * @param[in] t is the task index
+ * @note      flush tasks go to the bus queue, render tasks go to the deque
+ */
+static void a_tm1637_pool_push(tm1637_pool_t *pool, uint8_t worker, uint16_t t)
+{
+    tm1637_pool_worker_t *w;
+
+    w = &pool->worker[worker];                                                            /* worker */
+    (void)pthread_mutex_lock(&w->mutex);                                                  /* lock the queues */
+    if (pool->task[t].num == 0)                                                           /* bus work */
+    {
+        w->bus_task[w->bus_tail % TM1637_FLEET_MAX_BUS] = t;                              /* push to the bus queue */
+        w->bus_tail++;                                                                    /* tail + 1 */
+    }
+    else
+    {
+        w->task[w->tail % TM1637_POOL_MAX_TASK] = t;                                      /* push to the deque */
+        w->tail++;                                                                        /* tail + 1 */
+    }
+    (void)pthread_mutex_unlock(&w->mutex);                                                /* unlock the queues */
+
+    (void)pthread_mutex_lock(&pool->mutex);                                               /* lock the pool */
+    if (pool->task[t].num == 0)                                                           /* bus work */
+    {
+        pool->bus_ready[worker]++;                                                        /* only the owner may take it */
+    }
+    else
+    {
+        pool->steal_ready++;                                                              /* anyone may take it */
+    }
+    (void)pthread_cond_broadcast(&pool->wake);                                            /* wake the workers */
+    (void)pthread_mutex_unlock(&pool->mutex);                                             /* unlock the pool */
+}
+
+/**
+ * @brief      take a task
+ * @param[in]  *pool points to a tm1637 pool structure
+ * @param[in]  worker is the worker index
+ * @param[out] *t points to a task index buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 pool stops
+ * @note       own bus work first, then the own deque tail, then the head of the other deques
+ */
+static uint8_t a_tm1637_pool_take(tm1637_pool_t *pool, uint8_t worker, uint16_t *t)
+{
+    tm1637_pool_worker_t *w;
+    tm1637_pool_worker_t *v;
+    uint8_t bus_work;
+    uint8_t i;
+
+    w = &pool->worker[worker];                                                            /* worker */
+    (void)pthread_mutex_lock(&pool->mutex);                                               /* lock the pool */
+    while ((pool->stop == 0) && (pool->bus_ready[worker] == 0) && (pool->steal_ready == 0))   /* nothing to do */
+    {
+        (void)pthread_cond_wait(&pool->wake, &pool->mutex);                               /* sleep */
+    }
+    if (pool->bus_ready[worker] != 0)                                                     /* own bus work */
+    {
+        pool->bus_ready[worker]--;                                                        /* reserve it */
+        bus_work = 1;                                                                     /* set bus work */
+    }
+    else if (pool->steal_ready != 0)                                                      /* render work */
+    {
+        pool->steal_ready--;                                                              /* reserve one */
+        bus_work = 0;                                                                     /* set render work */
+    }
+    else
+    {
+        (void)pthread_mutex_unlock(&pool->mutex);                                         /* unlock the pool */
+
+        return 1;                                                                         /* stop */
+    }
+    (void)pthread_mutex_unlock(&pool->mutex);                                             /* unlock the pool */
+
+    if (bus_work != 0)                                                                    /* bus work */
+    {
+        (void)pthread_mutex_lock(&w->mutex);                                              /* lock the queues */
+        *t = w->bus_task[w->bus_head % TM1637_FLEET_MAX_BUS];                             /* pop the head */
+        w->bus_head++;                                                                    /* head + 1 */
+        (void)pthread_mutex_unlock(&w->mutex);                                            /* unlock the queues */
+
+        return 0;                                                                         /* success return 0 */
+    }
+    while (1)                                                                             /* the reserved task is queued somewhere */
+    {
+        (void)pthread_mutex_lock(&w->mutex);                                              /* lock the own deque */
+        if (w->tail != w->head)                                                           /* own work */
+        {
+            w->tail--;                                                                    /* tail - 1 */
+            *t = w->task[w->tail % TM1637_POOL_MAX_TASK];                                 /* pop the tail */
+            (void)pthread_mutex_unlock(&w->mutex);                                        /* unlock the own deque */
+
+            return 0;                                                                     /* success return 0 */
+        }
+        (void)pthread_mutex_unlock(&w->mutex);                                            /* unlock the own deque */
+        for (i = 1; i < pool->thread_num; i++)                                            /* loop the other workers */
+        {
+            v = &pool->worker[(worker + i) % pool->thread_num];                           /* victim */
+            (void)pthread_mutex_lock(&v->mutex);                                          /* lock the victim deque */
+            if (v->tail != v->head)                                                       /* victim has work */
+            {
+                *t = v->task[v->head % TM1637_POOL_MAX_TASK];                             /* take the oldest */
+                v->head++;                                                                /* head + 1 */
+                (void)pthread_mutex_unlock(&v->mutex);                                    /* unlock the victim deque */
+                w->stolen++;                                                              /* stolen + 1 */
+
+                return 0;                                                                 /* success return 0 */
+            }
+            (void)pthread_mutex_unlock(&v->mutex);                                        /* unlock the victim deque */
+        }
+    }
+}
+
+/**
+ * @brief     run a task
+ * @param[in] *pool points to a tm1637 pool structure
+ * @param[in] worker is the worker index
+ * @param[in] t is the task index
+ * @note      none
+ */
+static void a_tm1637_pool_run(tm1637_pool_t *pool, uint8_t worker, uint16_t t)
+{
+    const tm1637_pool_task_t *task;
+    const tm1637_pool_update_t *u;
+    tm1637_fleet_t *fleet;
+    uint16_t i;
+    uint16_t m;
+    uint8_t bus;
+    uint8_t res;
+
+    task = &pool->task[t];                                                                /* task */
+    fleet = pool->fleet;                                                                  /* fleet */
+    bus = task->bus;                                                                      /* bus */
+    res = 0;                                                                              /* init 0 */
+    if (task->num != 0)                                                                   /* render work */
+    {
+        for (i = task->start; i < task->start + task->num; i++)                           /* loop the updates */
+        {
+            u = &pool->update[pool->order[i]];                                            /* update */
+            (void)tm1637_fleet_write_segment(fleet, u->module, u->addr,
+                                             (uint8_t *)u->data, u->len);                 /* checked before */
+        }
+    }
+    else
+    {
+        for (i = pool->module_start[bus]; i < pool->module_start[bus + 1]; i++)           /* loop the bus modules */
+        {
+            m = pool->module[i];                                                          /* module */
+            if ((fleet->changed[m] != 0) || (fleet->config[m] != fleet->config_sent[m]))  /* dirty */
+            {
+                if (tm1637_fleet_flush_module(fleet, m) != 0)                             /* flush the module */
+                {
+                    res = 1;                                                              /* keep the others going */
+                }
+            }
+        }
+    }
+
+    pool->worker[worker].executed++;                                                      /* executed + 1 */
+    (void)pthread_mutex_lock(&pool->mutex);                                               /* lock the pool */
+    if (res != 0)                                                                         /* check the result */
+    {
+        pool->status = 1;                                                                 /* flush failed */
+    }
+    if (task->num != 0)                                                                   /* render work */
+    {
+        pool->render[bus]--;                                                              /* one less */
+        if (pool->render[bus] == 0)                                                       /* bus is rendered */
+        {
+            (void)pthread_mutex_unlock(&pool->mutex);                                     /* unlock the pool */
+            a_tm1637_pool_push(pool, bus % pool->thread_num,
+                               (uint16_t)(TM1637_POOL_MAX_TASK - TM1637_FLEET_MAX_BUS + bus));   /* flush on the owner */
+            (void)pthread_mutex_lock(&pool->mutex);                                       /* lock the pool */
+        }
+    }
+    pool->pending--;                                                                      /* one less */
+    if (pool->pending == 0)                                                               /* batch done */
+    {
+        (void)pthread_cond_signal(&pool->done);                                           /* wake the caller */
+    }
+    (void)pthread_mutex_unlock(&pool->mutex);                                             /* unlock the pool */
+}
+
+/**
+ * @brief     worker thread
+ * @param[in] *arg points to a tm1637 pool worker structure
+ * @return    NULL
+ * @note      none
+ */
+static void *a_tm1637_pool_worker(void *arg)
+{
+    tm1637_pool_worker_t *w;
+    uint16_t t;
+
+    w = (tm1637_pool_worker_t *)arg;                                                      /* worker */
+    while (a_tm1637_pool_take(w->pool, w->index, &t) == 0)                                /* take a task */
+    {
+        a_tm1637_pool_run(w->pool, w->index, t);                                          /* run it */
+    }
+
+    return NULL;                                                                          /* exit */
+}
+
+/**
+ * @brief     start the pool
+ * @param[in] *pool points to a tm1637 pool structure
+ * @param[in] *fleet points to an initialized tm1637 fleet structure
+ * @param[in] thread_num is the worker number
+ * @return    status code
+ *            - 0 success
+ *            - 1 thread create failed
+ *            - 2 pool or fleet is NULL
+ *            - 4 thread_num is invalid
+ * @note      bus b belongs to worker b % thread_num, workers without a bus only steal render work
+ */
+uint8_t tm1637_pool_init(tm1637_pool_t *pool, tm1637_fleet_t *fleet, uint8_t thread_num)
+{
+    uint8_t i;
+
+    if ((pool == NULL) || (fleet == NULL))                                                /* check pool and fleet */
+    {
+        return 2;                                                                         /* return error */
+    }
+    if ((thread_num == 0) || (thread_num > TM1637_POOL_MAX_THREAD))                       /* check thread_num */
+    {
+        fleet->debug_print("tm1637: thread_num is invalid.\n");                           /* thread_num is invalid */
+
+        return 4;                                                                         /* return error */
+    }
+
+    memset(pool, 0, sizeof(tm1637_pool_t));                                               /* clear the pool */
+    pool->fleet = fleet;                                                                  /* set fleet */
+    pool->thread_num = thread_num;                                                        /* set thread_num */
+    (void)pthread_mutex_init(&pool->mutex, NULL);                                         /* init the pool mutex */
+    (void)pthread_cond_init(&pool->wake, NULL);                                           /* init the wake condition */
+    (void)pthread_cond_init(&pool->done, NULL);                                           /* init the done condition */
+    for (i = 0; i < thread_num; i++)                                                      /* init all queues first */
+    {
+        pool->worker[i].pool = pool;                                                      /* set pool */
+        pool->worker[i].index = i;                                                        /* set index */
+        (void)pthread_mutex_init(&pool->worker[i].mutex, NULL);                           /* init the queue mutex */
+    }
+    for (i = 0; i < thread_num; i++)                                                      /* start all workers */
+    {
+        if (pthread_create(&pool->worker[i].thread, NULL,
+                           a_tm1637_pool_worker, &pool->worker[i]) != 0)                  /* create the thread */
+        {
+            fleet->debug_print("tm1637: thread create failed.\n");                        /* thread create failed */
+            (void)pthread_mutex_lock(&pool->mutex);                                       /* lock the pool */
+            pool->stop = 1;                                                               /* stop */
+            (void)pthread_cond_broadcast(&pool->wake);                                    /* wake the workers */
+            (void)pthread_mutex_unlock(&pool->mutex);                                     /* unlock the pool */
+            while (i != 0)                                                                /* join the started workers */
+            {
+                i--;                                                                      /* previous */
+                (void)pthread_join(pool->worker[i].thread, NULL);                         /* join */
+            }
+
+            return 1;                                                                     /* return error */
+        }
+    }
+    pool->inited = 1;                                                                     /* flag inited */
+
+    return 0;                                                                             /* success return 0 */
+}
+
+/**
+ * @brief     update many modules and flush every bus
+ * @param[in] *pool points to a tm1637 pool structure
+ * @param[in] *update points to an update array
+ * @param[in] num is the update number
+ * @return    status code
+ *            - 0 success
+ *            - 1 flush failed
+ *            - 2 pool is NULL
+ *            - 3 pool is not inited
+ *            - 4 update is invalid
+ *            - 5 module is updated twice
+ * @note      render tasks write the updates into the fleet and may be stolen by any idle worker,
+ *            the flush of a bus runs on its owner after the last render task of the bus,
+ *            the call returns when every bus is flushed and num 0 only flushes
+ */
+uint8_t tm1637_pool_update(tm1637_pool_t *pool, const tm1637_pool_update_t *update, uint16_t num)
+{
+    uint64_t seen[TM1637_FLEET_MAX_MODULE / 64];
+    uint16_t count[TM1637_FLEET_MAX_BUS + 1];
+    uint16_t pos[TM1637_FLEET_MAX_BUS];
+    tm1637_fleet_t *fleet;
+    uint16_t render_num;
+    uint16_t i;
+    uint16_t m;
+    uint16_t n;
+    uint8_t b;
+    uint8_t res;
+
+    if (pool == NULL)                                                                     /* check pool */
+    {
+        return 2;                                                                         /* return error */
+    }
+    if (pool->inited != 1)                                                                /* check pool initialization */
+    {
+        return 3;                                                                         /* return error */
+    }
+    fleet = pool->fleet;                                                                  /* fleet */
+    if ((num != 0) && (update == NULL))                                                   /* check update */
+    {
+        fleet->debug_print("tm1637: update is invalid.\n");                               /* update is invalid */
+
+        return 4;                                                                         /* return error */
+    }
+
+    memset(seen, 0, sizeof(seen));                                                        /* clear the seen bitmap */
+    memset(count, 0, sizeof(count));                                                      /* clear the counters */
+    for (i = 0; i < num; i++)                                                             /* check all updates */
+    {
+        m = update[i].module;                                                             /* module */
+        if ((m >= fleet->module_num) || (update[i].len == 0) ||
+            (update[i].addr + update[i].len > 6))                                         /* check module and range */
+        {
+            fleet->debug_print("tm1637: update %d is invalid.\n", i);                     /* update is invalid */
+
+            return 4;                                                                     /* return error */
+        }
+        if ((seen[m / 64] & ((uint64_t)1 << (m % 64))) != 0)                              /* render tasks must own their modules */
+        {
+            fleet->debug_print("tm1637: module %d is updated twice.\n", m);               /* module is updated twice */
+
+            return 5;                                                                     /* return error */
+        }
+        seen[m / 64] |= (uint64_t)1 << (m % 64);                                          /* seen */
+        count[fleet->bus[m] + 1]++;                                                       /* count the bus */
+    }
+    for (b = 0; b < fleet->bus_num; b++)                                                  /* prefix sum */
+    {
+        count[b + 1] += count[b];                                                         /* first update of the next bus */
+        pos[b] = count[b];                                                                /* fill position */
+    }
+    for (i = 0; i < num; i++)                                                             /* sort the updates by bus */
+    {
+        pool->order[pos[fleet->bus[update[i].module]]++] = i;                             /* keep the order in a bus */
+    }
+
+    memset(pool->module_start, 0, sizeof(pool->module_start));                            /* clear the module counters */
+    for (m = 0; m < fleet->module_num; m++)                                               /* count the modules of each bus */
+    {
+        pool->module_start[fleet->bus[m] + 1]++;                                          /* count the bus */
+    }
+    for (b = 0; b < fleet->bus_num; b++)                                                  /* prefix sum */
+    {
+        pool->module_start[b + 1] += pool->module_start[b];                               /* first module of the next bus */
+        pos[b] = pool->module_start[b];                                                   /* fill position */
+    }
+    for (m = 0; m < fleet->module_num; m++)                                               /* sort the modules by bus */
+    {
+        pool->module[pos[fleet->bus[m]]++] = m;                                           /* keep the id order */
+    }
+
+    render_num = 0;                                                                       /* init 0 */
+    for (b = 0; b < fleet->bus_num; b++)                                                  /* split each bus into chunks */
+    {
+        pool->render[b] = 0;                                                              /* init 0 */
+        for (i = count[b]; i < count[b + 1]; i += n)                                      /* loop the bus updates */
+        {
+            n = count[b + 1] - i;                                                         /* remaining updates */
+            if (n > TM1637_POOL_CHUNK)                                                    /* check the chunk */
+            {
+                n = TM1637_POOL_CHUNK;                                                    /* one chunk */
+            }
+            pool->task[render_num].start = i;                                             /* set start */
+            pool->task[render_num].num = n;                                               /* set num */
+            pool->task[render_num].bus = b;                                               /* set bus */
+            pool->render[b]++;                                                            /* render + 1 */
+            render_num++;                                                                 /* task + 1 */
+        }
+        pool->task[TM1637_POOL_MAX_TASK - TM1637_FLEET_MAX_BUS + b].start = 0;            /* flush task start */
+        pool->task[TM1637_POOL_MAX_TASK - TM1637_FLEET_MAX_BUS + b].num = 0;              /* flush task */
+        pool->task[TM1637_POOL_MAX_TASK - TM1637_FLEET_MAX_BUS + b].bus = b;              /* flush task bus */
+    }
+
+    (void)pthread_mutex_lock(&pool->mutex);                                               /* lock the pool */
+    pool->update = update;                                                                /* set update */
+    pool->status = 0;                                                                     /* init 0 */
+    pool->pending = (uint16_t)(render_num + fleet->bus_num);                              /* all tasks */
+    (void)pthread_mutex_unlock(&pool->mutex);                                             /* unlock the pool */
+    for (b = 0; b < fleet->bus_num; b++)                                                  /* buses without updates */
+    {
+        if (pool->render[b] == 0)                                                         /* nothing to render */
+        {
+            a_tm1637_pool_push(pool, b % pool->thread_num,
+                               (uint16_t)(TM1637_POOL_MAX_TASK - TM1637_FLEET_MAX_BUS + b));   /* flush on the owner */
+        }
+    }
+    for (i = 0; i < render_num; i++)                                                      /* queue the render tasks */
+    {
+        a_tm1637_pool_push(pool, pool->task[i].bus % pool->thread_num, i);                /* on the bus owner first */
+    }
+
+    (void)pthread_mutex_lock(&pool->mutex);                                               /* lock the pool */
+    while (pool->pending != 0)                                                            /* wait for the batch */
+    {
+        (void)pthread_cond_wait(&pool->done, &pool->mutex);                               /* sleep */
+    }
+    res = pool->status;                                                                   /* get the status */
+    (void)pthread_mutex_unlock(&pool->mutex);                                             /* unlock the pool */
+
+    return res;                                                                           /* return the result */
+}
+
+/**
+ * @brief      get the statistics of a worker
+ * @param[in]  *pool points to a tm1637 pool structure
+ * @param[in]  worker is the worker index
+ * @param[out] *executed points to an executed task counter buffer
+ * @param[out] *stolen points to a stolen task counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 pool is NULL
+ *             - 3 pool is not inited
+ *             - 4 worker is invalid
+ * @note       call it between batches
+ */
+uint8_t tm1637_pool_get_statistics(tm1637_pool_t *pool, uint8_t worker, uint32_t *executed, uint32_t *stolen)
+{
+    if (pool == NULL)                                                                     /* check pool */
+    {
+        return 2;                                                                         /* return error */
+    }
+    if (pool->inited != 1)                                                                /* check pool initialization */
+    {
+        return 3;                                                                         /* return error */
+    }
+    if (worker >= pool->thread_num)                                                       /* check worker */
+    {
+        pool->fleet->debug_print("tm1637: worker is invalid.\n");                         /* worker is invalid */
+
+        return 4;                                                                         /* return error */
+    }
+
+    *executed = pool->worker[worker].executed;                                            /* get executed */
+    *stolen = pool->worker[worker].stolen;                                                /* get stolen */
+
+    return 0;                                                                             /* success return 0 */
+}
+
+/**
+ * @brief     stop the pool
+ * @param[in] *pool points to a tm1637 pool structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 pool is NULL
+ *            - 3 pool is not inited
+ * @note      it joins every worker
+ */
+uint8_t tm1637_pool_deinit(tm1637_pool_t *pool)
+{
+    uint8_t i;
+
+    if (pool == NULL)                                                                     /* check pool */
+    {
+        return 2;                                                                         /* return error */
+    }
+    if (pool->inited != 1)                                                                /* check pool initialization */
+    {
+        return 3;                                                                         /* return error */
+    }
+
+    (void)pthread_mutex_lock(&pool->mutex);                                               /* lock the pool */
+    pool->stop = 1;                                                                       /* stop */
+    (void)pthread_cond_broadcast(&pool->wake);                                            /* wake the workers */
+    (void)pthread_mutex_unlock(&pool->mutex);                                             /* unlock the pool */
+    for (i = 0; i < pool->thread_num; i++)                                                /* join all workers */
+    {
+        (void)pthread_join(pool->worker[i].thread, NULL);                                 /* join */
+    }
+    for (i = 0; i < TM1637_POOL_MAX_THREAD; i++)                                          /* destroy all queue mutexes */
+    {
+        if (pool->worker[i].pool != NULL)                                                 /* inited queue */
+        {
+            (void)pthread_mutex_destroy(&pool->worker[i].mutex);                          /* destroy */
+        }
+    }
+    (void)pthread_cond_destroy(&pool->done);                                              /* destroy the done condition */
+    (void)pthread_cond_destroy(&pool->wake);                                              /* destroy the wake condition */
+    (void)pthread_mutex_destroy(&pool->mutex);                                            /* destroy the pool mutex */
+    pool->inited = 0;                                                                     /* flag closed */
+
+    return 0;                                                                             /* success return 0 */
+}
@@ -0,0 +1,250 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      serial.c
+ * @brief     serial source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#define _GNU_SOURCE
+
+#include "serial.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+/**
+ * @brief     serial get the speed of a baud rate
+ * @param[in] baud is the baud rate
+ * @return    termios speed
+ * @note      unknown rates fall back to 115200
+ */
+static speed_t a_serial_speed(uint32_t baud)
+{
+    switch (baud)
+    {
+        case 9600 :
+        {
+            return B9600;
+        }
+        case 57600 :
+        {
+            return B57600;
+        }
+        case 230400 :
+        {
+            return B230400;
+        }
+        case 460800 :
+        {
+            return B460800;
+        }
+        case 921600 :
+        {
+            return B921600;
+        }
+        default :
+        {
+            return B115200;
+        }
+    }
+}
+
+/**
+ * @brief      serial open
+ * @param[in]  *name points to a serial device name like "/dev/ttyACM0"
+ * @param[in]  baud is the baud rate
+ * @param[out] *fd points to a file descriptor buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 open failed
+ * @note       the port runs raw with 8 data bits, 1 stop bit and no parity
+ */
+uint8_t serial_open(const char *name, uint32_t baud, int *fd)
+{
+    int f;
+    struct termios tio;
+    
+    /* open the port */
+    f = open(name, O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (f < 0)
+    {
+        return 1;
+    }
+    
+    /* raw mode, no echo and no line editing */
+    if (tcgetattr(f, &tio) != 0)
+    {
+        (void)close(f);
+        
+        return 1;
+    }
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    (void)cfsetspeed(&tio, a_serial_speed(baud));
+    if (tcsetattr(f, TCSANOW, &tio) != 0)
+    {
+        (void)close(f);
+        
+        return 1;
+    }
+    (void)tcflush(f, TCIOFLUSH);
+    *fd = f;
+    
+    return 0;
+}
+
+/**
+ * @brief     serial close
+ * @param[in] fd is the file descriptor
+ * @return    status code
+ *            - 0 success
+ *            - 1 close failed
+ * @note      none
+ */
+uint8_t serial_close(int fd)
+{
+    if (close(fd) != 0)
+    {
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     serial write
+ * @param[in] *ctx points to a file descriptor
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      it returns after all bytes are written
+ */
+uint8_t serial_write(void *ctx, uint8_t *buf, uint16_t len)
+{
+    int fd = *(int *)ctx;
+    ssize_t n;
+    
+    while (len != 0)
+    {
+        n = write(fd, buf, len);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            
+            return 1;
+        }
+        buf += n;
+        len = (uint16_t)(len - n);
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief      serial read
+ * @param[in]  *ctx points to a file descriptor
+ * @param[out] *buf points to a data buffer
+ * @param[in]  len is the buffer length
+ * @param[in]  timeout_ms is the timeout in ms
+ * @return     length of the read data
+ * @note       it returns the bytes already received, 0 means timeout
+ */
+uint16_t serial_read(void *ctx, uint8_t *buf, uint16_t len, uint32_t timeout_ms)
+{
+    struct pollfd pfd;
+    ssize_t n;
+    
+    pfd.fd = *(int *)ctx;
+    pfd.events = POLLIN;
+    
+    /* wait for the first byte */
+    while (1)
+    {
+        n = poll(&pfd, 1, (int)timeout_ms);
+        if ((n < 0) && (errno == EINTR))
+        {
+            continue;
+        }
+        if ((n <= 0) || ((pfd.revents & POLLIN) == 0))
+        {
+            return 0;
+        }
+        n = read(pfd.fd, buf, len);
+        if ((n < 0) && (errno == EINTR))
+        {
+            continue;
+        }
+        
+        return (n < 0) ? 0 : (uint16_t)n;
+    }
+}
+
+/**
+ * @brief      serial pty open
+ * @param[out] *fd points to a master file descriptor buffer
+ * @param[out] *name points to a slave name buffer
+ * @param[in]  len is the name buffer length
+ * @return     status code
+ *             - 0 success
+ *             - 1 open failed
+ * @note       the slave is a serial port stand-in, open it with serial_open
+ */
+uint8_t serial_pty_open(int *fd, char *name, size_t len)
+{
+    int f;
+    
+    /* a new pseudo terminal pair */
+    f = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (f < 0)
+    {
+        return 1;
+    }
+    if ((grantpt(f) != 0) || (unlockpt(f) != 0) || (ptsname_r(f, name, len) != 0))
+    {
+        (void)close(f);
+        
+        return 1;
+    }
+    *fd = f;
+    
+    return 0;
+}
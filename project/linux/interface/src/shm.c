@@ -0,0 +1,157 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      shm.c
+ * @brief     shm source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "shm.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief      shm create
+ * @param[in]  *name points to a shared memory name like "/tm1637"
+ * @param[in]  size is the shared memory size
+ * @param[out] **addr points to a mapped address buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 create failed
+ * @note       an old object with the same name is replaced, the memory starts zeroed
+ */
+uint8_t shm_create(const char *name, size_t size, void **addr)
+{
+    int fd;
+    void *p;
+    
+    /* drop the old object */
+    (void)shm_unlink(name);
+    
+    /* create a new one */
+    fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0666);
+    if (fd < 0)
+    {
+        return 1;
+    }
+    if (ftruncate(fd, (off_t)size) != 0)
+    {
+        (void)close(fd);
+        (void)shm_unlink(name);
+        
+        return 1;
+    }
+    
+    /* map it, the mapping keeps the object alive */
+    p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    (void)close(fd);
+    if (p == MAP_FAILED)
+    {
+        (void)shm_unlink(name);
+        
+        return 1;
+    }
+    *addr = p;
+    
+    return 0;
+}
+
+/**
+ * @brief      shm attach
+ * @param[in]  *name points to a shared memory name like "/tm1637"
+ * @param[in]  size is the shared memory size
+ * @param[out] **addr points to a mapped address buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 attach failed
+ * @note       none
+ */
+uint8_t shm_attach(const char *name, size_t size, void **addr)
+{
+    int fd;
+    void *p;
+    struct stat st;
+    
+    /* open the object */
+    fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0)
+    {
+        return 1;
+    }
+    
+    /* the daemon sizes it before formatting */
+    if ((fstat(fd, &st) != 0) || ((size_t)st.st_size < size))
+    {
+        (void)close(fd);
+        
+        return 1;
+    }
+    p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    (void)close(fd);
+    if (p == MAP_FAILED)
+    {
+        return 1;
+    }
+    *addr = p;
+    
+    return 0;
+}
+
+/**
+ * @brief     shm detach
+ * @param[in] *addr points to a mapped address
+ * @param[in] size is the shared memory size
+ * @return    status code
+ *            - 0 success
+ *            - 1 detach failed
+ * @note      none
+ */
+uint8_t shm_detach(void *addr, size_t size)
+{
+    return (munmap(addr, size) != 0) ? 1 : 0;
+}
+
+/**
+ * @brief     shm remove
+ * @param[in] *name points to a shared memory name
+ * @return    status code
+ *            - 0 success
+ *            - 1 remove failed
+ * @note      mapped clients keep their mapping until they detach
+ */
+uint8_t shm_remove(const char *name)
+{
+    return (shm_unlink(name) != 0) ? 1 : 0;
+}
@@ -0,0 +1,241 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      timing.c
+ * @brief     timing source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "timing.h"
+#include <string.h>
+
+/**
+ * @brief timing valid mask definition
+ */
+#define TIMING_VALID_RISE        (1 << 0)        /**< rise_ns is valid */
+#define TIMING_VALID_FALL        (1 << 1)        /**< fall_ns is valid */
+#define TIMING_VALID_DIO         (1 << 2)        /**< dio_ns is valid */
+#define TIMING_VALID_HIGH        (1 << 3)        /**< high_dio_ns is valid */
+
+/**
+ * @brief timing rule name table
+ */
+static const char *const gsc_name[TIMING_RULE_NUM] =
+{
+    "clk_high", "clk_low", "clk_period", "setup", "hold", "start_stop", "start_hold", "sample",
+};
+
+/**
+ * @brief     timing check one rule
+ * @param[in] *timing points to a timing structure
+ * @param[in] ns is the timestamp
+ * @param[in] rule is the timing rule
+ * @param[in] measured_ns is the measured time
+ * @note      none
+ */
+static void a_timing_check(timing_t *timing, uint64_t ns, timing_rule_t rule, uint64_t measured_ns)
+{
+    timing_stat_t *stat = &timing->stat[rule];
+    
+    if ((stat->checks == 0) || (measured_ns < stat->min_ns))
+    {
+        stat->min_ns = measured_ns;
+    }
+    stat->checks++;
+    if (measured_ns < timing->limit.min_ns[rule])
+    {
+        stat->violations++;
+        if (timing->report != NULL)
+        {
+            timing->report(ns, rule, measured_ns, timing->limit.min_ns[rule]);
+        }
+    }
+}
+
+/**
+ * @brief      timing get the tm1637 datasheet limits
+ * @param[out] *limit points to a timing limit structure
+ * @note       clock width 400ns, 500kHz clock, setup and hold 100ns, output delay 300ns,
+ *             the datasheet gives no start and stop time, so they take the 100ns of setup and hold
+ */
+void timing_limit_default(timing_limit_t *limit)
+{
+    limit->min_ns[TIMING_RULE_CLK_HIGH] = 400;
+    limit->min_ns[TIMING_RULE_CLK_LOW] = 400;
+    limit->min_ns[TIMING_RULE_CLK_PERIOD] = 2000;
+    limit->min_ns[TIMING_RULE_SETUP] = 100;
+    limit->min_ns[TIMING_RULE_HOLD] = 100;
+    limit->min_ns[TIMING_RULE_START_STOP] = 100;
+    limit->min_ns[TIMING_RULE_START_HOLD] = 100;
+    limit->min_ns[TIMING_RULE_SAMPLE] = 300;
+}
+
+/**
+ * @brief     timing init
+ * @param[in] *timing points to a timing structure
+ * @param[in] *limit points to a timing limit structure
+ * @param[in] *report points to a violation callback, it may be NULL
+ * @note      both lines start high like an idle bus
+ */
+void timing_init(timing_t *timing, const timing_limit_t *limit,
+                 void (*report)(uint64_t ns, timing_rule_t rule, uint64_t measured_ns, uint32_t min_ns))
+{
+    memset(timing, 0, sizeof(timing_t));
+    timing->limit = *limit;
+    timing->report = report;
+    timing->clk = 1;
+    timing->dio = 1;
+}
+
+/**
+ * @brief     timing check the lines
+ * @param[in] *timing points to a timing structure
+ * @param[in] ns is the timestamp
+ * @param[in] clk is the clock level
+ * @param[in] dio is the data level driven by the host
+ * @note      call it at every change, the timestamps must not go back,
+ *            the chip output is checked by timing_sample because it only has to be stable when the host reads it
+ */
+void timing_edge(timing_t *timing, uint64_t ns, uint8_t clk, uint8_t dio)
+{
+    clk = (clk != 0) ? 1 : 0;
+    dio = (dio != 0) ? 1 : 0;
+    
+    /* a data change while the clock is low is data, while it is high it is a start or a stop */
+    if (dio != timing->dio)
+    {
+        if (timing->clk == 0)
+        {
+            if ((timing->valid & TIMING_VALID_FALL) != 0)
+            {
+                a_timing_check(timing, ns, TIMING_RULE_HOLD, ns - timing->fall_ns);
+            }
+        }
+        else
+        {
+            if ((timing->valid & TIMING_VALID_RISE) != 0)
+            {
+                a_timing_check(timing, ns, TIMING_RULE_START_STOP, ns - timing->rise_ns);
+            }
+            timing->high_dio_ns = ns;
+            timing->valid |= TIMING_VALID_HIGH;
+        }
+        timing->dio = dio;
+        timing->dio_ns = ns;
+        timing->valid |= TIMING_VALID_DIO;
+    }
+    
+    /* clock edges */
+    if (clk != timing->clk)
+    {
+        if (clk != 0)
+        {
+            if ((timing->valid & TIMING_VALID_FALL) != 0)
+            {
+                a_timing_check(timing, ns, TIMING_RULE_CLK_LOW, ns - timing->fall_ns);
+            }
+            if ((timing->valid & TIMING_VALID_RISE) != 0)
+            {
+                a_timing_check(timing, ns, TIMING_RULE_CLK_PERIOD, ns - timing->rise_ns);
+            }
+            if ((timing->valid & TIMING_VALID_DIO) != 0)
+            {
+                a_timing_check(timing, ns, TIMING_RULE_SETUP, ns - timing->dio_ns);
+            }
+            timing->rise_ns = ns;
+            timing->valid |= TIMING_VALID_RISE;
+            timing->valid &= (uint8_t)(~TIMING_VALID_HIGH);
+        }
+        else
+        {
+            if ((timing->valid & TIMING_VALID_RISE) != 0)
+            {
+                a_timing_check(timing, ns, TIMING_RULE_CLK_HIGH, ns - timing->rise_ns);
+            }
+            if ((timing->valid & TIMING_VALID_HIGH) != 0)
+            {
+                a_timing_check(timing, ns, TIMING_RULE_START_HOLD, ns - timing->high_dio_ns);
+            }
+            timing->fall_ns = ns;
+            timing->valid |= TIMING_VALID_FALL;
+        }
+        timing->clk = clk;
+    }
+}
+
+/**
+ * @brief     timing follow a data change driven by the chip
+ * @param[in] *timing points to a timing structure
+ * @param[in] ns is the timestamp
+ * @param[in] dio is the data level
+ * @note      a capture only has the bus level, the ack and the key bits are not held by the host,
+ *            so the hold rule is skipped and the setup rule still applies at the next clock rise
+ */
+void timing_chip_edge(timing_t *timing, uint64_t ns, uint8_t dio)
+{
+    dio = (dio != 0) ? 1 : 0;
+    if (dio != timing->dio)
+    {
+        timing->dio = dio;
+        timing->dio_ns = ns;
+        timing->valid |= TIMING_VALID_DIO;
+    }
+}
+
+/**
+ * @brief     timing check a host sample
+ * @param[in] *timing points to a timing structure
+ * @param[in] ns is the timestamp
+ * @note      the chip output settles an output delay after the clock falls
+ */
+void timing_sample(timing_t *timing, uint64_t ns)
+{
+    if ((timing->valid & TIMING_VALID_FALL) != 0)
+    {
+        a_timing_check(timing, ns, TIMING_RULE_SAMPLE, ns - timing->fall_ns);
+    }
+}
+
+/**
+ * @brief     timing rule name
+ * @param[in] rule is the timing rule
+ * @return    rule name
+ * @note      none
+ */
+const char *timing_rule_name(timing_rule_t rule)
+{
+    if (rule >= TIMING_RULE_NUM)
+    {
+        return "unknown";
+    }
+    
+    return gsc_name[rule];
+}
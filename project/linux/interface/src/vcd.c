@@ -0,0 +1,177 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      vcd.c
+ * @brief     vcd source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "vcd.h"
+#include <string.h>
+
+/**
+ * @brief     vcd write the timestamp
+ * @param[in] *vcd points to a vcd structure
+ * @param[in] ns is the timestamp
+ * @note      a timestamp is only written when it changes
+ */
+static void a_vcd_time(vcd_t *vcd, uint64_t ns)
+{
+    if ((vcd->time_valid == 0) || (ns != vcd->ns))
+    {
+        fprintf(vcd->fp, "#%llu\n", (unsigned long long)ns);
+        vcd->ns = ns;
+        vcd->time_valid = 1;
+    }
+}
+
+/**
+ * @brief     vcd open
+ * @param[in] *vcd points to a vcd structure
+ * @param[in] *path points to a file path
+ * @param[in] **wire points to the wire names
+ * @param[in] wires is the wire number
+ * @param[in] **event points to the event names
+ * @param[in] events is the event number
+ * @return    status code
+ *            - 0 success
+ *            - 1 open failed
+ *            - 2 too many signals
+ * @note      the time scale is 1ns and all wires start high like an idle bus
+ */
+uint8_t vcd_open(vcd_t *vcd, const char *path, const char *const *wire, uint8_t wires,
+                 const char *const *event, uint8_t events)
+{
+    uint8_t i;
+    
+    /* the identifiers are one printable character each */
+    if (wires + events > VCD_MAX_SIGNAL)
+    {
+        return 2;
+    }
+    memset(vcd, 0, sizeof(vcd_t));
+    vcd->fp = fopen(path, "w");
+    if (vcd->fp == NULL)
+    {
+        return 1;
+    }
+    vcd->wires = wires;
+    vcd->events = events;
+    
+    /* header */
+    fprintf(vcd->fp, "$version libdriver tm1637 $end\n");
+    fprintf(vcd->fp, "$timescale 1ns $end\n");
+    fprintf(vcd->fp, "$scope module tm1637 $end\n");
+    for (i = 0; i < wires; i++)
+    {
+        fprintf(vcd->fp, "$var wire 1 %c %s $end\n", '!' + i, wire[i]);
+    }
+    for (i = 0; i < events; i++)
+    {
+        fprintf(vcd->fp, "$var event 1 %c %s $end\n", '!' + wires + i, event[i]);
+    }
+    fprintf(vcd->fp, "$upscope $end\n");
+    fprintf(vcd->fp, "$enddefinitions $end\n");
+    
+    /* initial levels */
+    fprintf(vcd->fp, "#0\n$dumpvars\n");
+    for (i = 0; i < wires; i++)
+    {
+        vcd->level[i] = 1;
+        fprintf(vcd->fp, "1%c\n", '!' + i);
+    }
+    fprintf(vcd->fp, "$end\n");
+    vcd->time_valid = 1;
+    
+    return 0;
+}
+
+/**
+ * @brief     vcd change a wire
+ * @param[in] *vcd points to a vcd structure
+ * @param[in] ns is the timestamp
+ * @param[in] index is the wire index
+ * @param[in] level is the wire level
+ * @note      only a new level is written
+ */
+void vcd_change(vcd_t *vcd, uint64_t ns, uint8_t index, uint8_t level)
+{
+    level = (level != 0) ? 1 : 0;
+    if ((index >= vcd->wires) || (vcd->level[index] == level))
+    {
+        return;
+    }
+    a_vcd_time(vcd, ns);
+    fprintf(vcd->fp, "%u%c\n", level, '!' + index);
+    vcd->level[index] = level;
+    vcd->changes++;
+}
+
+/**
+ * @brief     vcd trigger an event
+ * @param[in] *vcd points to a vcd structure
+ * @param[in] ns is the timestamp
+ * @param[in] index is the event index
+ * @note      none
+ */
+void vcd_trigger(vcd_t *vcd, uint64_t ns, uint8_t index)
+{
+    if (index >= vcd->events)
+    {
+        return;
+    }
+    a_vcd_time(vcd, ns);
+    fprintf(vcd->fp, "1%c\n", '!' + vcd->wires + index);
+}
+
+/**
+ * @brief     vcd close
+ * @param[in] *vcd points to a vcd structure
+ * @param[in] ns is the end timestamp
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+uint8_t vcd_close(vcd_t *vcd, uint64_t ns)
+{
+    uint8_t res;
+    
+    a_vcd_time(vcd, ns);
+    res = (ferror(vcd->fp) != 0) ? 1 : 0;
+    if (fclose(vcd->fp) != 0)
+    {
+        res = 1;
+    }
+    vcd->fp = NULL;
+    
+    return res;
+}
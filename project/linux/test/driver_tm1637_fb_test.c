@@ -0,0 +1,413 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_fb_test.c
+ * @brief     driver tm1637 fb test source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+ 
+#include "driver_tm1637_fb_test.h"
+#include <stddef.h>
+
+/**
+ * @brief shared interface ops
+ */
+static const tm1637_ops_t gc_ops =
+{
+    tm1637_interface_iic_init_ctx,
+    tm1637_interface_iic_deinit_ctx,
+    tm1637_interface_iic_write_cmd_custom_ctx,
+    tm1637_interface_iic_read_cmd_custom_ctx,
+    tm1637_interface_delay_ms_ctx,
+    tm1637_interface_timestamp_us_ctx,
+    tm1637_interface_lock_ctx,
+    tm1637_interface_unlock_ctx,
+};
+
+static tm1637_handle_t gs_handle[TM1637_FB_MAX_DISPLAY];                /**< tm1637 handles */
+static tm1637_handle_t *gs_handle_list[TM1637_FB_MAX_DISPLAY];          /**< tm1637 handle list */
+static tm1637_fb_daemon_t gs_daemon;                                    /**< tm1637 fb daemon */
+static uint32_t gs_digits;                                              /**< checked digit counter */
+static const uint8_t gsc_number[] = {TM1637_NUMBER_0, TM1637_NUMBER_1, TM1637_NUMBER_2,
+                                     TM1637_NUMBER_3, TM1637_NUMBER_4, TM1637_NUMBER_5,
+                                     TM1637_NUMBER_6, TM1637_NUMBER_7, TM1637_NUMBER_8,
+                                     TM1637_NUMBER_9};                  /**< number table */
+
+/**
+ * @brief     fb test close the opened displays
+ * @param[in] num is the opened display number
+ * @note      none
+ */
+static void a_tm1637_fb_test_close(uint8_t num)
+{
+    while (num != 0)
+    {
+        num--;
+        (void)tm1637_deinit(&gs_handle[num]);
+    }
+}
+
+/**
+ * @brief     fb test poll and check
+ * @param[in] flushed is the expected flushed display number
+ * @param[in] digits is the expected sent digit number
+ * @return    status code
+ *            - 0 success
+ *            - 1 check failed
+ * @note      none
+ */
+static uint8_t a_tm1637_fb_test_poll(uint8_t flushed, uint32_t digits)
+{
+    uint8_t res;
+    uint8_t count;
+    uint32_t total;
+    uint32_t sent;
+    uint32_t busy;
+    
+    /* flush */
+    res = tm1637_fb_daemon_poll(&gs_daemon, &count);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: daemon poll failed.\n");
+        
+        return 1;
+    }
+    (void)tm1637_fb_daemon_get_statistics(&gs_daemon, &total, &sent, &busy);
+    if ((count != flushed) || (sent - gs_digits != digits))
+    {
+        tm1637_interface_debug_print("tm1637: flushed %d displays %d digits, expect %d displays %d digits.\n",
+                                     count, sent - gs_digits, flushed, digits);
+        
+        return 1;
+    }
+    gs_digits = sent;
+    
+    return 0;
+}
+
+/**
+ * @brief     fb test
+ * @param[in] *fb points to the framebuffer of the daemon
+ * @param[in] *client points to the same framebuffer as a client maps it
+ * @param[in] **ctx points to a bus context array, display i is on ctx[i]
+ * @param[in] num is the display number
+ * @param[in] times is the test times
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      client may be fb itself or a second mapping of the same shared memory,
+ *            display i finally shows (times - 1 + i + digit) % 10
+ */
+uint8_t tm1637_fb_test(tm1637_fb_t *fb, tm1637_fb_t *client, void **ctx, uint8_t num, uint32_t times)
+{
+    uint8_t res;
+    uint8_t i;
+    uint8_t j;
+    uint8_t data[6];
+    uint32_t t;
+    uint32_t start;
+    uint32_t us;
+    tm1637_info_t info;
+    
+    /* check the param */
+    if ((fb == NULL) || (client == NULL) || (ctx == NULL) || (num == 0) || (num > TM1637_FB_MAX_DISPLAY))
+    {
+        tm1637_interface_debug_print("tm1637: param is invalid.\n");
+        
+        return 1;
+    }
+    
+    /* get information */
+    res = tm1637_info(&info);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: get info failed.\n");
+        
+        return 1;
+    }
+    else
+    {
+        /* print chip info */
+        tm1637_interface_debug_print("tm1637: chip is %s.\n", info.chip_name);
+        tm1637_interface_debug_print("tm1637: manufacturer is %s.\n", info.manufacturer_name);
+        tm1637_interface_debug_print("tm1637: interface is %s.\n", info.interface);
+        tm1637_interface_debug_print("tm1637: driver version is %d.%d.\n", info.driver_version / 1000, (info.driver_version % 1000) / 100);
+        tm1637_interface_debug_print("tm1637: min supply voltage is %0.1fV.\n", info.supply_voltage_min_v);
+        tm1637_interface_debug_print("tm1637: max supply voltage is %0.1fV.\n", info.supply_voltage_max_v);
+        tm1637_interface_debug_print("tm1637: max current is %0.2fmA.\n", info.max_current_ma);
+        tm1637_interface_debug_print("tm1637: max temperature is %0.1fC.\n", info.temperature_max);
+        tm1637_interface_debug_print("tm1637: min temperature is %0.1fC.\n", info.temperature_min);
+    }
+    
+    /* start fb test */
+    tm1637_interface_debug_print("tm1637: start fb test.\n");
+    
+    /* every display owns one cache line */
+    if ((sizeof(tm1637_fb_display_t) != TM1637_FB_LINE) || (offsetof(tm1637_fb_t, display) != TM1637_FB_LINE))
+    {
+        tm1637_interface_debug_print("tm1637: fb layout is %d bytes at %d, expect %d bytes at %d.\n",
+                                     (int)sizeof(tm1637_fb_display_t), (int)offsetof(tm1637_fb_t, display),
+                                     TM1637_FB_LINE, TM1637_FB_LINE);
+        
+        return 1;
+    }
+    
+    /* the daemon owns every handle */
+    for (i = 0; i < num; i++)
+    {
+        DRIVER_TM1637_LINK_INIT(&gs_handle[i], tm1637_handle_t);
+        DRIVER_TM1637_LINK_OPS(&gs_handle[i], &gc_ops);
+        DRIVER_TM1637_LINK_CTX(&gs_handle[i], ctx[i]);
+        DRIVER_TM1637_LINK_DEBUG_PRINT(&gs_handle[i], tm1637_interface_debug_print);
+        res = tm1637_init(&gs_handle[i]);
+        if (res != 0)
+        {
+            tm1637_interface_debug_print("tm1637: display %d init failed.\n", i);
+            a_tm1637_fb_test_close(i);
+            
+            return 1;
+        }
+        res = tm1637_set_address_mode(&gs_handle[i], TM1637_ADDRESS_MODE_INC);
+        if (res != 0)
+        {
+            tm1637_interface_debug_print("tm1637: display %d set address mode failed.\n", i);
+            a_tm1637_fb_test_close(i + 1);
+            
+            return 1;
+        }
+        gs_handle_list[i] = &gs_handle[i];
+    }
+    
+    /* format the framebuffer and attach the client */
+    res = tm1637_fb_format(fb, num);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: fb format failed.\n");
+        a_tm1637_fb_test_close(num);
+        
+        return 1;
+    }
+    res = tm1637_fb_check(client);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: client fb check failed.\n");
+        a_tm1637_fb_test_close(num);
+        
+        return 1;
+    }
+    res = tm1637_fb_daemon_init(&gs_daemon, fb, gs_handle_list);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: daemon init failed.\n");
+        a_tm1637_fb_test_close(num);
+        
+        return 1;
+    }
+    gs_digits = 0;
+    
+    /* the first poll sends every display */
+    tm1637_interface_debug_print("tm1637: first poll test.\n");
+    if (a_tm1637_fb_test_poll(num, 6 * num) != 0)
+    {
+        a_tm1637_fb_test_close(num);
+        
+        return 1;
+    }
+    
+    /* nothing moved, nothing is sent */
+    tm1637_interface_debug_print("tm1637: idle poll test.\n");
+    if (a_tm1637_fb_test_poll(0, 0) != 0)
+    {
+        a_tm1637_fb_test_close(num);
+        
+        return 1;
+    }
+    start = tm1637_interface_timestamp_us();
+    for (t = 0; t < 10000; t++)
+    {
+        (void)tm1637_fb_daemon_poll(&gs_daemon, NULL);
+    }
+    us = tm1637_interface_timestamp_us() - start;
+    tm1637_interface_debug_print("tm1637: 10000 idle polls of %d displays in %dus.\n", num, us);
+    
+    /* one digit sends one digit */
+    tm1637_interface_debug_print("tm1637: one digit test.\n");
+    data[0] = gsc_number[8];
+    res = tm1637_fb_write_segment(client, 0, 3, data, 1);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: fb write segment failed.\n");
+        a_tm1637_fb_test_close(num);
+        
+        return 1;
+    }
+    if (a_tm1637_fb_test_poll(1, 1) != 0)
+    {
+        a_tm1637_fb_test_close(num);
+        
+        return 1;
+    }
+    
+    /* same digits only move the sequence */
+    res = tm1637_fb_write_segment(client, 0, 3, data, 1);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: fb write segment failed.\n");
+        a_tm1637_fb_test_close(num);
+        
+        return 1;
+    }
+    if (a_tm1637_fb_test_poll(1, 0) != 0)
+    {
+        a_tm1637_fb_test_close(num);
+        
+        return 1;
+    }
+    
+    /* the display bits go without digits */
+    tm1637_interface_debug_print("tm1637: display bits test.\n");
+    res = tm1637_fb_set_display(client, num - 1, TM1637_BOOL_TRUE, TM1637_PULSE_WIDTH_1_DIV_16);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: fb set display failed.\n");
+        a_tm1637_fb_test_close(num);
+        
+        return 1;
+    }
+    if (a_tm1637_fb_test_poll(1, 0) != 0)
+    {
+        a_tm1637_fb_test_close(num);
+        
+        return 1;
+    }
+    
+    /* a client dies in the middle of a write */
+    tm1637_interface_debug_print("tm1637: dead writer test.\n");
+    (void)atomic_fetch_add(&client->display[0].seq, 1);
+    atomic_store(&client->display[0].ram[3], gsc_number[5]);
+    res = tm1637_fb_write_segment(client, 0, 3, data, 1);
+    if (res != 5)
+    {
+        tm1637_interface_debug_print("tm1637: fb write segment got %d instead of busy.\n", res);
+        a_tm1637_fb_test_close(num);
+        
+        return 1;
+    }
+    for (t = 0; t < TM1637_FB_STUCK_POLL - 1; t++)
+    {
+        if (a_tm1637_fb_test_poll(0, 0) != 0)
+        {
+            a_tm1637_fb_test_close(num);
+            
+            return 1;
+        }
+    }
+    if (gs_daemon.recovered != 0)
+    {
+        tm1637_interface_debug_print("tm1637: daemon recovered after %d polls.\n", TM1637_FB_STUCK_POLL - 1);
+        a_tm1637_fb_test_close(num);
+        
+        return 1;
+    }
+    
+    /* the daemon takes the lock back and sends what the client left */
+    if (a_tm1637_fb_test_poll(0, 0) != 0)
+    {
+        a_tm1637_fb_test_close(num);
+        
+        return 1;
+    }
+    if (gs_daemon.recovered != 1)
+    {
+        tm1637_interface_debug_print("tm1637: daemon recovered %d displays, expect 1.\n", gs_daemon.recovered);
+        a_tm1637_fb_test_close(num);
+        
+        return 1;
+    }
+    if (a_tm1637_fb_test_poll(1, 1) != 0)
+    {
+        a_tm1637_fb_test_close(num);
+        
+        return 1;
+    }
+    
+    /* the other clients write again */
+    res = tm1637_fb_write_segment(client, 0, 3, data, 1);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: fb write segment failed.\n");
+        a_tm1637_fb_test_close(num);
+        
+        return 1;
+    }
+    if (a_tm1637_fb_test_poll(1, 1) != 0)
+    {
+        a_tm1637_fb_test_close(num);
+        
+        return 1;
+    }
+    
+    /* whole frames */
+    tm1637_interface_debug_print("tm1637: frame test.\n");
+    for (t = 0; t < times; t++)
+    {
+        for (i = 0; i < num; i++)
+        {
+            for (j = 0; j < 6; j++)
+            {
+                data[j] = gsc_number[(t + i + j) % 10];
+            }
+            res = tm1637_fb_write_segment(client, i, 0, data, 6);
+            if (res != 0)
+            {
+                tm1637_interface_debug_print("tm1637: fb write segment failed.\n");
+                a_tm1637_fb_test_close(num);
+                
+                return 1;
+            }
+        }
+        
+        /* every digit moves */
+        if (a_tm1637_fb_test_poll(num, 6 * num) != 0)
+        {
+            a_tm1637_fb_test_close(num);
+            
+            return 1;
+        }
+    }
+    tm1637_interface_debug_print("tm1637: check daemon ok.\n");
+    
+    /* finish fb test */
+    tm1637_interface_debug_print("tm1637: finish fb test.\n");
+    a_tm1637_fb_test_close(num);
+    
+    return 0;
+}
@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_fb_test.h
+ * @brief     driver tm1637 fb test header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef DRIVER_TM1637_FB_TEST_H
+#define DRIVER_TM1637_FB_TEST_H
+
+#include "driver_tm1637_interface.h"
+#include "fb.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @addtogroup tm1637_test_driver
+ * @{
+ */
+
+/**
+ * @brief     fb test
+ * @param[in] *fb points to the framebuffer of the daemon
+ * @param[in] *client points to the same framebuffer as a client maps it
+ * @param[in] **ctx points to a bus context array, display i is on ctx[i]
+ * @param[in] num is the display number
+ * @param[in] times is the test times
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      client may be fb itself or a second mapping of the same shared memory,
+ *            display i finally shows (times - 1 + i + digit) % 10
+ */
+uint8_t tm1637_fb_test(tm1637_fb_t *fb, tm1637_fb_t *client, void **ctx, uint8_t num, uint32_t times);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
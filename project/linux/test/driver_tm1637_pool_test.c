@@ -0,0 +1,286 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_pool_test.c
+ * @brief     driver tm1637 pool test source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+ 
+#include "driver_tm1637_pool_test.h"
+
+static tm1637_fleet_t gs_fleet;                                                       /**< tm1637 fleet */
+static tm1637_pool_t gs_pool;                                                         /**< tm1637 pool */
+static tm1637_pool_update_t gs_update[TM1637_FLEET_MAX_MODULE];                       /**< batch */
+static uint16_t gs_module[TM1637_FLEET_MAX_BUS][TM1637_FLEET_MAX_MODULE];             /**< module id of each lane */
+static const uint8_t gsc_number[] = {TM1637_NUMBER_0, TM1637_NUMBER_1, TM1637_NUMBER_2,
+                                     TM1637_NUMBER_3, TM1637_NUMBER_4, TM1637_NUMBER_5,
+                                     TM1637_NUMBER_6, TM1637_NUMBER_7, TM1637_NUMBER_8,
+                                     TM1637_NUMBER_9};                                /**< number table */
+
+/**
+ * @brief     pool test check the fleet
+ * @param[in] module_num is the module number
+ * @return    status code
+ *            - 0 success
+ *            - 1 check failed
+ * @note      every digit must be sent after a batch
+ */
+static uint8_t a_tm1637_pool_test_check(uint16_t module_num)
+{
+    uint16_t m;
+    uint8_t j;
+    
+    for (m = 0; m < module_num; m++)
+    {
+        if ((gs_fleet.changed[m] != 0) || (gs_fleet.config[m] != gs_fleet.config_sent[m]))
+        {
+            tm1637_interface_debug_print("tm1637: module %d is still dirty.\n", m);
+            
+            return 1;
+        }
+        for (j = 0; j < 6; j++)
+        {
+            if (gs_fleet.sent[m][j] != gs_fleet.ram[m][j])
+            {
+                tm1637_interface_debug_print("tm1637: module %d digit %d is not sent.\n", m, j);
+                
+                return 1;
+            }
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     pool test
+ * @param[in] *ops points to the bus ops
+ * @param[in] **ctx points to a bus context array
+ * @param[in] bus_num is the bus number
+ * @param[in] lane_num is the module number on each bus
+ * @param[in] max_thread is the max thread number
+ * @param[in] times is the batch number of each thread number
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      it runs 1 to max_thread workers, lane l on bus b finally shows (times - 1 + b + l + digit) % 10
+ */
+uint8_t tm1637_pool_test(const tm1637_fleet_ops_t *ops, void **ctx, uint8_t bus_num, uint16_t lane_num,
+                         uint8_t max_thread, uint32_t times)
+{
+    uint8_t res;
+    uint8_t t;
+    uint8_t b;
+    uint8_t w;
+    uint8_t j;
+    uint16_t l;
+    uint16_t num;
+    uint32_t r;
+    uint32_t start;
+    uint32_t us;
+    uint32_t executed;
+    uint32_t stolen;
+    uint32_t stolen_total;
+    tm1637_info_t info;
+    
+    /* check the param */
+    if ((ops == NULL) || (ctx == NULL) || (bus_num == 0) || (bus_num > TM1637_FLEET_MAX_BUS) ||
+        (lane_num == 0) || ((uint32_t)bus_num * lane_num > TM1637_FLEET_MAX_MODULE) ||
+        (max_thread == 0) || (max_thread > TM1637_POOL_MAX_THREAD) || (times == 0))
+    {
+        tm1637_interface_debug_print("tm1637: param is invalid.\n");
+        
+        return 1;
+    }
+    
+    /* get information */
+    res = tm1637_info(&info);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: get info failed.\n");
+        
+        return 1;
+    }
+    else
+    {
+        /* print chip info */
+        tm1637_interface_debug_print("tm1637: chip is %s.\n", info.chip_name);
+        tm1637_interface_debug_print("tm1637: manufacturer is %s.\n", info.manufacturer_name);
+        tm1637_interface_debug_print("tm1637: interface is %s.\n", info.interface);
+        tm1637_interface_debug_print("tm1637: driver version is %d.%d.\n", info.driver_version / 1000, (info.driver_version % 1000) / 100);
+        tm1637_interface_debug_print("tm1637: min supply voltage is %0.1fV.\n", info.supply_voltage_min_v);
+        tm1637_interface_debug_print("tm1637: max supply voltage is %0.1fV.\n", info.supply_voltage_max_v);
+        tm1637_interface_debug_print("tm1637: max current is %0.2fmA.\n", info.max_current_ma);
+        tm1637_interface_debug_print("tm1637: max temperature is %0.1fC.\n", info.temperature_max);
+        tm1637_interface_debug_print("tm1637: min temperature is %0.1fC.\n", info.temperature_min);
+    }
+    
+    /* start pool test */
+    tm1637_interface_debug_print("tm1637: start pool test.\n");
+    tm1637_interface_debug_print("tm1637: %d buses with %d modules each.\n", bus_num, lane_num);
+    
+    for (t = 1; t <= max_thread; t++)
+    {
+        /* init the fleet */
+        res = tm1637_fleet_init(&gs_fleet, tm1637_interface_debug_print);
+        if (res != 0)
+        {
+            tm1637_interface_debug_print("tm1637: fleet init failed.\n");
+            
+            return 1;
+        }
+        for (b = 0; b < bus_num; b++)
+        {
+            uint8_t id;
+            
+            res = tm1637_fleet_add_bus(&gs_fleet, ops, ctx[b], &id);
+            if (res != 0)
+            {
+                tm1637_interface_debug_print("tm1637: fleet add bus failed.\n");
+                
+                return 1;
+            }
+        }
+        
+        /* interleave the buses so the pool has to sort the batch */
+        for (l = 0; l < lane_num; l++)
+        {
+            for (b = 0; b < bus_num; b++)
+            {
+                res = tm1637_fleet_add_module(&gs_fleet, b, l, &gs_module[b][l]);
+                if (res != 0)
+                {
+                    tm1637_interface_debug_print("tm1637: fleet add module failed.\n");
+                    
+                    return 1;
+                }
+            }
+        }
+        
+        /* start the pool */
+        res = tm1637_pool_init(&gs_pool, &gs_fleet, t);
+        if (res != 0)
+        {
+            tm1637_interface_debug_print("tm1637: pool init failed.\n");
+            
+            return 1;
+        }
+        
+        /* a module twice in one batch is rejected */
+        if (t == 1)
+        {
+            gs_update[0].module = 0;
+            gs_update[0].addr = 0;
+            gs_update[0].len = 1;
+            gs_update[0].data[0] = gsc_number[0];
+            gs_update[1] = gs_update[0];
+            res = tm1637_pool_update(&gs_pool, gs_update, 2);
+            if (res != 5)
+            {
+                tm1637_interface_debug_print("tm1637: duplicate module is not rejected.\n");
+                (void)tm1637_pool_deinit(&gs_pool);
+                
+                return 1;
+            }
+            tm1637_interface_debug_print("tm1637: check duplicate module ok.\n");
+        }
+        
+        /* send the display and clear */
+        res = tm1637_pool_update(&gs_pool, NULL, 0);
+        if (res != 0)
+        {
+            tm1637_interface_debug_print("tm1637: pool update failed.\n");
+            (void)tm1637_pool_deinit(&gs_pool);
+            
+            return 1;
+        }
+        
+        us = 0;
+        for (r = 0; r < times; r++)
+        {
+            /* every module changes every digit */
+            num = 0;
+            for (b = 0; b < bus_num; b++)
+            {
+                for (l = 0; l < lane_num; l++)
+                {
+                    gs_update[num].module = gs_module[b][l];
+                    gs_update[num].addr = 0;
+                    gs_update[num].len = 6;
+                    for (j = 0; j < 6; j++)
+                    {
+                        gs_update[num].data[j] = gsc_number[(r + b + l + j) % 10];
+                    }
+                    num++;
+                }
+            }
+            
+            /* run the batch */
+            start = tm1637_interface_timestamp_us();
+            res = tm1637_pool_update(&gs_pool, gs_update, num);
+            us += tm1637_interface_timestamp_us() - start;
+            if (res != 0)
+            {
+                tm1637_interface_debug_print("tm1637: pool update failed.\n");
+                (void)tm1637_pool_deinit(&gs_pool);
+                
+                return 1;
+            }
+            
+            /* check the fleet */
+            if (a_tm1637_pool_test_check(num) != 0)
+            {
+                (void)tm1637_pool_deinit(&gs_pool);
+                
+                return 1;
+            }
+        }
+        
+        /* get the statistics */
+        stolen_total = 0;
+        for (w = 0; w < t; w++)
+        {
+            (void)tm1637_pool_get_statistics(&gs_pool, w, &executed, &stolen);
+            stolen_total += stolen;
+        }
+        (void)tm1637_pool_deinit(&gs_pool);
+        
+        /* output */
+        tm1637_interface_debug_print("tm1637: %d threads %d batches in %dus, %d modules/s, %d tasks stolen.\n",
+                                     t, times, us, (us != 0) ? (uint32_t)((uint64_t)num * times * 1000000 / us) : 0,
+                                     stolen_total);
+    }
+    
+    /* finish pool test */
+    tm1637_interface_debug_print("tm1637: finish pool test.\n");
+    
+    return 0;
+}
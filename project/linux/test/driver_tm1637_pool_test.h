@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_pool_test.h
+ * @brief     driver tm1637 pool test header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef DRIVER_TM1637_POOL_TEST_H
+#define DRIVER_TM1637_POOL_TEST_H
+
+#include "driver_tm1637_interface.h"
+#include "pool.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @addtogroup tm1637_test_driver
+ * @{
+ */
+
+/**
+ * @brief     pool test
+ * @param[in] *ops points to the bus ops
+ * @param[in] **ctx points to a bus context array
+ * @param[in] bus_num is the bus number
+ * @param[in] lane_num is the module number on each bus
+ * @param[in] max_thread is the max thread number
+ * @param[in] times is the batch number of each thread number
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      it runs 1 to max_thread workers, lane l on bus b finally shows (times - 1 + b + l + digit) % 10
+ */
+uint8_t tm1637_pool_test(const tm1637_fleet_ops_t *ops, void **ctx, uint8_t bus_num, uint16_t lane_num,
+                         uint8_t max_thread, uint32_t times);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,590 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_stress_test.c
+ * @brief     driver tm1637 stress test source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_tm1637_stress_test.h"
+#include <pthread.h>
+
+/**
+ * @brief stress test call type definition
+ */
+#define STRESS_CALL_WRITE_SEGMENT        0        /**< tm1637_write_segment */
+#define STRESS_CALL_SET_PULSE_WIDTH      1        /**< tm1637_set_pulse_width */
+#define STRESS_CALL_SET_DISPLAY          2        /**< tm1637_set_display */
+#define STRESS_CALL_READ_SEGMENT         3        /**< tm1637_read_segment */
+
+/**
+ * @brief stress test call structure definition
+ */
+typedef struct stress_call_s
+{
+    uint8_t type;           /**< call type */
+    uint8_t addr;           /**< start address */
+    uint8_t len;            /**< data length */
+    uint8_t value;          /**< pulse width or display flag */
+    uint8_t data[6];        /**< segment data */
+} stress_call_t;
+
+/**
+ * @brief stress test display structure definition
+ */
+typedef struct stress_display_s
+{
+    void *bus;                                           /**< bus context */
+    tm1637_handle_t handle;                              /**< shared handle */
+    uint8_t seg;                                         /**< key seg read before the threads */
+    uint8_t k;                                           /**< key k read before the threads */
+    uint8_t conf;                                        /**< reference display control */
+    uint8_t ram[6];                                      /**< reference ram */
+    uint32_t count;                                      /**< logged call number, only changed under the lock */
+    stress_call_t log[TM1637_STRESS_TEST_MAX_LOG];       /**< calls in lock order */
+} stress_display_t;
+
+/**
+ * @brief stress test thread structure definition
+ */
+typedef struct stress_thread_s
+{
+    pthread_t thread;            /**< thread */
+    uint32_t seed;               /**< random seed */
+    uint32_t calls;              /**< call number */
+    stress_call_t call;          /**< running call */
+    uint64_t wait_us;            /**< time spent waiting for the lock */
+    uint8_t failed;              /**< failed flag */
+} stress_thread_t;
+
+static stress_display_t gs_display[TM1637_STRESS_TEST_MAX_DISPLAY];        /**< displays */
+static stress_thread_t gs_thread[TM1637_STRESS_TEST_MAX_THREAD];           /**< threads */
+static uint8_t gs_num;                                                     /**< display number */
+static pthread_key_t gs_key;                                               /**< running thread key */
+
+/**
+ * @brief     stress test iic init
+ * @param[in] *ctx points to a stress display
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic init failed
+ * @note      none
+ */
+static uint8_t a_stress_iic_init(void *ctx)
+{
+    return tm1637_interface_iic_init_ctx(((stress_display_t *)ctx)->bus);
+}
+
+/**
+ * @brief     stress test iic deinit
+ * @param[in] *ctx points to a stress display
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic deinit failed
+ * @note      none
+ */
+static uint8_t a_stress_iic_deinit(void *ctx)
+{
+    return tm1637_interface_iic_deinit_ctx(((stress_display_t *)ctx)->bus);
+}
+
+/**
+ * @brief     stress test iic write
+ * @param[in] *ctx points to a stress display
+ * @param[in] addr is the command
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+static uint8_t a_stress_iic_write(void *ctx, uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    return tm1637_interface_iic_write_cmd_custom_ctx(((stress_display_t *)ctx)->bus, addr, buf, len);
+}
+
+/**
+ * @brief      stress test iic read
+ * @param[in]  *ctx points to a stress display
+ * @param[in]  addr is the command
+ * @param[out] *buf points to a data buffer
+ * @param[in]  len is the data length
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       none
+ */
+static uint8_t a_stress_iic_read(void *ctx, uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    return tm1637_interface_iic_read_cmd_custom_ctx(((stress_display_t *)ctx)->bus, addr, buf, len);
+}
+
+/**
+ * @brief     stress test delay ms
+ * @param[in] *ctx points to a stress display
+ * @param[in] ms is the delay time
+ * @note      none
+ */
+static void a_stress_delay_ms(void *ctx, uint32_t ms)
+{
+    tm1637_interface_delay_ms_ctx(((stress_display_t *)ctx)->bus, ms);
+}
+
+/**
+ * @brief     stress test timestamp
+ * @param[in] *ctx points to a stress display
+ * @return    timestamp in microseconds
+ * @note      none
+ */
+static uint32_t a_stress_timestamp_us(void *ctx)
+{
+    return tm1637_interface_timestamp_us_ctx(((stress_display_t *)ctx)->bus);
+}
+
+/**
+ * @brief     stress test lock
+ * @param[in] *ctx points to a stress display
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock failed
+ * @note      the core takes the lock once per call, so the log order under it is the serialised order
+ */
+static uint8_t a_stress_lock(void *ctx)
+{
+    stress_display_t *display = (stress_display_t *)ctx;
+    stress_thread_t *self = (stress_thread_t *)pthread_getspecific(gs_key);
+    uint32_t start;
+    
+    start = tm1637_interface_timestamp_us_ctx(display->bus);
+    if (tm1637_interface_lock_ctx(display->bus) != 0)
+    {
+        return 1;
+    }
+    if (self != NULL)
+    {
+        self->wait_us += tm1637_interface_timestamp_us_ctx(display->bus) - start;
+        if (display->count < TM1637_STRESS_TEST_MAX_LOG)
+        {
+            display->log[display->count] = self->call;
+        }
+        display->count++;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     stress test unlock
+ * @param[in] *ctx points to a stress display
+ * @note      none
+ */
+static void a_stress_unlock(void *ctx)
+{
+    tm1637_interface_unlock_ctx(((stress_display_t *)ctx)->bus);
+}
+
+/**
+ * @brief stress test interface ops
+ */
+static const tm1637_ops_t gc_ops =
+{
+    a_stress_iic_init,
+    a_stress_iic_deinit,
+    a_stress_iic_write,
+    a_stress_iic_read,
+    a_stress_delay_ms,
+    a_stress_timestamp_us,
+    a_stress_lock,
+    a_stress_unlock,
+};
+
+/**
+ * @brief         stress test random
+ * @param[in,out] *seed points to a random seed
+ * @return        random number
+ * @note          xorshift32, every thread has its own seed
+ */
+static uint32_t a_stress_random(uint32_t *seed)
+{
+    uint32_t x = *seed;
+    
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *seed = x;
+    
+    return x;
+}
+
+/**
+ * @brief     stress test thread
+ * @param[in] *arg points to a stress thread
+ * @return    NULL
+ * @note      each call picks a random display and a random api
+ */
+static void *a_stress_thread(void *arg)
+{
+    stress_thread_t *self = (stress_thread_t *)arg;
+    stress_display_t *display;
+    uint8_t res;
+    uint8_t seg;
+    uint8_t k;
+    uint8_t i;
+    uint32_t n;
+    uint32_t r;
+    
+    (void)pthread_setspecific(gs_key, self);
+    for (n = 0; n < self->calls; n++)
+    {
+        r = a_stress_random(&self->seed);
+        display = &gs_display[r % gs_num];
+        r = a_stress_random(&self->seed);
+        switch (r % 10)
+        {
+            case 0 :
+            case 1 :
+            case 2 :
+            case 3 :
+            case 4 :
+            {
+                self->call.type = STRESS_CALL_WRITE_SEGMENT;
+                self->call.addr = (uint8_t)((r >> 8) % 6);
+                self->call.len = (uint8_t)(1 + (r >> 16) % (6 - self->call.addr));
+                for (i = 0; i < self->call.len; i++)
+                {
+                    self->call.data[i] = (uint8_t)a_stress_random(&self->seed);
+                }
+                res = tm1637_write_segment(&display->handle, self->call.addr, self->call.data, self->call.len);
+                
+                break;
+            }
+            case 5 :
+            case 6 :
+            {
+                self->call.type = STRESS_CALL_SET_PULSE_WIDTH;
+                self->call.value = (uint8_t)((r >> 8) % 8);
+                res = tm1637_set_pulse_width(&display->handle, (tm1637_pulse_width_t)self->call.value);
+                
+                break;
+            }
+            case 7 :
+            case 8 :
+            {
+                self->call.type = STRESS_CALL_SET_DISPLAY;
+                self->call.value = (uint8_t)((r >> 8) % 2);
+                res = tm1637_set_display(&display->handle, (tm1637_bool_t)self->call.value);
+                
+                break;
+            }
+            default :
+            {
+                self->call.type = STRESS_CALL_READ_SEGMENT;
+                res = tm1637_read_segment(&display->handle, &seg, &k);
+                if ((res == 0) && ((seg != display->seg) || (k != display->k)))
+                {
+                    res = 1;
+                }
+                
+                break;
+            }
+        }
+        if (res != 0)
+        {
+            self->failed = 1;
+            
+            return NULL;
+        }
+    }
+    
+    return NULL;
+}
+
+/**
+ * @brief  stress test close the displays
+ * @note   none
+ */
+static void a_stress_close(void)
+{
+    while (gs_num != 0)
+    {
+        gs_num--;
+        (void)tm1637_deinit(&gs_display[gs_num].handle);
+    }
+}
+
+/**
+ * @brief     stress test replay the log and check the chip
+ * @param[in] *state points to a chip state function
+ * @return    status code
+ *            - 0 success
+ *            - 1 check failed
+ * @note      none
+ */
+static uint8_t a_stress_check(uint8_t (*state)(void *ctx, uint8_t *display, uint8_t *ram, uint32_t *errors))
+{
+    stress_display_t *display;
+    stress_call_t *call;
+    uint8_t i;
+    uint8_t conf;
+    uint8_t ram[6];
+    uint32_t l;
+    uint32_t errors;
+    
+    for (i = 0; i < gs_num; i++)
+    {
+        display = &gs_display[i];
+        if (display->count > TM1637_STRESS_TEST_MAX_LOG)
+        {
+            tm1637_interface_debug_print("tm1637: display %d log is full.\n", i);
+            
+            return 1;
+        }
+        
+        /* replay the calls one by one in the lock order */
+        for (l = 0; l < display->count; l++)
+        {
+            call = &display->log[l];
+            if (call->type == STRESS_CALL_WRITE_SEGMENT)
+            {
+                memcpy(&display->ram[call->addr], call->data, call->len);
+            }
+            else if (call->type == STRESS_CALL_SET_PULSE_WIDTH)
+            {
+                display->conf = (uint8_t)((display->conf & ~0x07) | call->value);
+            }
+            else if (call->type == STRESS_CALL_SET_DISPLAY)
+            {
+                display->conf = (uint8_t)((display->conf & ~0x08) | (call->value << 3));
+            }
+            else
+            {
+                /* reading changes nothing */
+            }
+        }
+        display->count = 0;
+        
+        /* the chip must show the serialised result */
+        if (state(display->bus, &conf, ram, &errors) != 0)
+        {
+            tm1637_interface_debug_print("tm1637: display %d get state failed.\n", i);
+            
+            return 1;
+        }
+        if (((conf & 0x0F) != display->conf) || (memcmp(ram, display->ram, 6) != 0) || (errors != 0))
+        {
+            tm1637_interface_debug_print("tm1637: display %d is 0x%02X errors %d, the serialised reference is 0x%02X.\n",
+                                         i, conf, errors, display->conf);
+            
+            return 1;
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     stress test
+ * @param[in] **ctx points to a bus context array, display i is on ctx[i]
+ * @param[in] num is the display number
+ * @param[in] *state points to a function reading the display control, the ram and the protocol errors of the chip behind ctx
+ * @param[in] max_thread is the max thread number
+ * @param[in] times is the call number of each thread in a round divided by 64
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      it runs 1 to max_thread threads on the same shared handles, every call is logged under the handle lock
+ *            and the log replayed in that order must give the display control and the ram read back from the chip
+ */
+uint8_t tm1637_stress_test(void **ctx, uint8_t num,
+                           uint8_t (*state)(void *ctx, uint8_t *display, uint8_t *ram, uint32_t *errors),
+                           uint8_t max_thread, uint32_t times)
+{
+    uint8_t res;
+    uint8_t i;
+    uint8_t t;
+    uint8_t w;
+    uint8_t failed;
+    uint32_t calls;
+    uint32_t start;
+    uint32_t us;
+    uint64_t wait_us;
+    tm1637_info_t info;
+    
+    /* check the param */
+    if ((ctx == NULL) || (num == 0) || (num > TM1637_STRESS_TEST_MAX_DISPLAY) || (state == NULL) ||
+        (max_thread == 0) || (max_thread > TM1637_STRESS_TEST_MAX_THREAD) || (times == 0) ||
+        ((uint64_t)times * 64 * max_thread > TM1637_STRESS_TEST_MAX_LOG))
+    {
+        tm1637_interface_debug_print("tm1637: param is invalid.\n");
+        
+        return 1;
+    }
+    
+    /* get information */
+    res = tm1637_info(&info);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: get info failed.\n");
+        
+        return 1;
+    }
+    else
+    {
+        /* print chip info */
+        tm1637_interface_debug_print("tm1637: chip is %s.\n", info.chip_name);
+        tm1637_interface_debug_print("tm1637: manufacturer is %s.\n", info.manufacturer_name);
+        tm1637_interface_debug_print("tm1637: interface is %s.\n", info.interface);
+        tm1637_interface_debug_print("tm1637: driver version is %d.%d.\n", info.driver_version / 1000, (info.driver_version % 1000) / 100);
+        tm1637_interface_debug_print("tm1637: min supply voltage is %0.1fV.\n", info.supply_voltage_min_v);
+        tm1637_interface_debug_print("tm1637: max supply voltage is %0.1fV.\n", info.supply_voltage_max_v);
+        tm1637_interface_debug_print("tm1637: max current is %0.2fmA.\n", info.max_current_ma);
+        tm1637_interface_debug_print("tm1637: max temperature is %0.1fC.\n", info.temperature_max);
+        tm1637_interface_debug_print("tm1637: min temperature is %0.1fC.\n", info.temperature_min);
+    }
+    
+    /* start stress test */
+    tm1637_interface_debug_print("tm1637: start stress test.\n");
+    if (pthread_key_create(&gs_key, NULL) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: create thread key failed.\n");
+        
+        return 1;
+    }
+    
+    /* open every display and set a known state before the threads */
+    for (gs_num = 0; gs_num < num; gs_num++)
+    {
+        stress_display_t *display = &gs_display[gs_num];
+        
+        display->bus = ctx[gs_num];
+        display->count = 0;
+        DRIVER_TM1637_LINK_INIT(&display->handle, tm1637_handle_t);
+        DRIVER_TM1637_LINK_OPS(&display->handle, &gc_ops);
+        DRIVER_TM1637_LINK_CTX(&display->handle, display);
+        DRIVER_TM1637_LINK_DEBUG_PRINT(&display->handle, tm1637_interface_debug_print);
+        if (tm1637_init(&display->handle) != 0)
+        {
+            tm1637_interface_debug_print("tm1637: init failed.\n");
+            a_stress_close();
+            (void)pthread_key_delete(gs_key);
+            
+            return 1;
+        }
+        memset(display->ram, 0, 6);
+        display->conf = 0x08 | TM1637_PULSE_WIDTH_14_DIV_16;
+        if ((tm1637_set_address_mode(&display->handle, TM1637_ADDRESS_MODE_INC) != 0) ||
+            (tm1637_write_segment(&display->handle, 0, display->ram, 6) != 0) ||
+            (tm1637_set_pulse_width(&display->handle, TM1637_PULSE_WIDTH_14_DIV_16) != 0) ||
+            (tm1637_set_display(&display->handle, TM1637_BOOL_TRUE) != 0) ||
+            (tm1637_read_segment(&display->handle, &display->seg, &display->k) != 0))
+        {
+            tm1637_interface_debug_print("tm1637: set the start state failed.\n");
+            gs_num++;
+            a_stress_close();
+            (void)pthread_key_delete(gs_key);
+            
+            return 1;
+        }
+    }
+    
+    for (t = 1; t <= max_thread; t++)
+    {
+        /* every thread makes the same number of calls */
+        calls = times * 64;
+        failed = 0;
+        start = tm1637_interface_timestamp_us();
+        for (w = 0; w < t; w++)
+        {
+            gs_thread[w].seed = 0x9E3779B9U * (uint32_t)(t * TM1637_STRESS_TEST_MAX_THREAD + w + 1);
+            gs_thread[w].calls = calls;
+            gs_thread[w].wait_us = 0;
+            gs_thread[w].failed = 0;
+            if (pthread_create(&gs_thread[w].thread, NULL, a_stress_thread, &gs_thread[w]) != 0)
+            {
+                tm1637_interface_debug_print("tm1637: create thread failed.\n");
+                failed = 1;
+                
+                break;
+            }
+        }
+        wait_us = 0;
+        for (i = 0; i < w; i++)
+        {
+            (void)pthread_join(gs_thread[i].thread, NULL);
+            failed |= gs_thread[i].failed;
+            wait_us += gs_thread[i].wait_us;
+        }
+        us = tm1637_interface_timestamp_us() - start;
+        if (failed != 0)
+        {
+            tm1637_interface_debug_print("tm1637: %d threads call failed.\n", t);
+            a_stress_close();
+            (void)pthread_key_delete(gs_key);
+            
+            return 1;
+        }
+        
+        /* every call took the lock once */
+        calls = 0;
+        for (i = 0; i < gs_num; i++)
+        {
+            calls += gs_display[i].count;
+        }
+        if (calls != times * 64 * t)
+        {
+            tm1637_interface_debug_print("tm1637: %d locked calls instead of %d.\n", calls, times * 64 * t);
+            a_stress_close();
+            (void)pthread_key_delete(gs_key);
+            
+            return 1;
+        }
+        if (a_stress_check(state) != 0)
+        {
+            a_stress_close();
+            (void)pthread_key_delete(gs_key);
+            
+            return 1;
+        }
+        us = (us != 0) ? us : 1;
+        tm1637_interface_debug_print("tm1637: %d threads %d calls in %dus, %d calls/s, %d%% of the thread time waits for the lock.\n",
+                                     t, calls, us, (uint32_t)((uint64_t)calls * 1000000 / us),
+                                     (uint32_t)(wait_us * 100 / ((uint64_t)us * t)));
+    }
+    tm1637_interface_debug_print("tm1637: check %d displays against the serialised calls ok.\n", gs_num);
+    
+    /* finish stress test */
+    a_stress_close();
+    (void)pthread_key_delete(gs_key);
+    tm1637_interface_debug_print("tm1637: finish stress test.\n");
+    
+    return 0;
+}
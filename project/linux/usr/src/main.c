@@ -0,0 +1,2036 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      main.c
+ * @brief     main source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_tm1637_write_test.h"
+#include "driver_tm1637_read_test.h"
+#include "driver_tm1637_parallel_test.h"
+#include "driver_tm1637_group_test.h"
+#include "driver_tm1637_fleet_test.h"
+#include "driver_tm1637_diff_test.h"
+#include "driver_tm1637_multi_test.h"
+#include "driver_tm1637_pool_test.h"
+#include "driver_tm1637_fb_test.h"
+#include "driver_tm1637_link_test.h"
+#include "driver_tm1637_remote_test.h"
+#include "driver_tm1637_ring_test.h"
+#include "driver_tm1637_stress_test.h"
+#include "driver_tm1637_trace_test.h"
+#include "driver_tm1637_scheduler_test.h"
+#include "driver_tm1637_mailbox_test.h"
+#include "driver_tm1637_queue_test.h"
+#include "driver_tm1637_vdisplay_test.h"
+#include "driver_tm1637_basic.h"
+#include "driver_tm1637_multi.h"
+#include "gpio.h"
+#include "shm.h"
+#include "serial.h"
+#include "firmware.h"
+#include "delay.h"
+#include "iic.h"
+#include "timing.h"
+#include "vcd.h"
+#include "decode.h"
+#include "capture.h"
+#include <getopt.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/**
+ * @brief timeline snapshot structure definition
+ */
+typedef struct timeline_s
+{
+    uint32_t us;             /**< virtual timestamp */
+    uint32_t ms;             /**< delay length */
+    uint8_t display;         /**< display control */
+    uint8_t ram[6];          /**< display ram */
+} timeline_t;
+
+static timeline_t gs_timeline[64];        /**< iic model timeline */
+static uint8_t gs_timeline_len;           /**< timeline length */
+static vcd_t gs_vcd;                      /**< iic port waveform */
+static timing_t gs_timing;                /**< iic port timing check */
+static uint32_t gs_report_len;            /**< printed violations */
+
+/**
+ * @brief capture writer structure definition
+ */
+typedef struct capture_writer_s
+{
+    FILE *bin;                  /**< binary file */
+    FILE *csv;                  /**< csv file */
+    uint64_t index;             /**< next binary sample */
+    uint64_t period_ns;         /**< binary sample period */
+    uint64_t delay_ns;          /**< chip output delay */
+    uint64_t pending_ns;        /**< chip output change time */
+    uint8_t pending;            /**< chip output change valid */
+    uint8_t chip;               /**< chip output on the bus */
+    uint8_t chip_next;          /**< chip output after the delay */
+    uint8_t scl;                /**< host clock */
+    uint8_t sda;                /**< host data */
+    uint8_t level;              /**< written bus level */
+    uint32_t starts;            /**< host start conditions */
+    uint8_t buf[4096];          /**< binary fill buffer */
+} capture_writer_t;
+
+/**
+ * @brief capture check structure definition
+ */
+typedef struct capture_check_s
+{
+    uint64_t records;           /**< decoded records */
+    uint64_t nack;              /**< records with a missing ack */
+    uint64_t timing;            /**< records with a timing flag */
+    uint64_t flagged;           /**< records with any flag */
+    uint64_t written;           /**< bytes received by the chip */
+    uint32_t hash;              /**< hash of the records */
+    uint8_t digit[6];           /**< last digits */
+    uint8_t key;                /**< last key */
+    uint8_t print;              /**< print every record */
+} capture_check_t;
+
+static capture_writer_t gs_writer;        /**< iic port capture writer */
+static uint8_t gs_number[] =
+{
+    TM1637_NUMBER_0, TM1637_NUMBER_1, TM1637_NUMBER_2, TM1637_NUMBER_3, TM1637_NUMBER_4,
+    TM1637_NUMBER_5, TM1637_NUMBER_6, TM1637_NUMBER_7, TM1637_NUMBER_8, TM1637_NUMBER_9,
+};                                        /**< number table */
+
+/**
+ * @brief     timeline probe
+ * @param[in] us is the virtual timestamp
+ * @param[in] ms is the delay length
+ * @note      it saves what the iic model shows during the delay and presses the next key
+ */
+static void a_timeline_probe(uint32_t us, uint32_t ms)
+{
+    model_t *model = gpio_iic_model();
+
+    if (gs_timeline_len < 64)
+    {
+        gs_timeline[gs_timeline_len].us = us;
+        gs_timeline[gs_timeline_len].ms = ms;
+        gs_timeline[gs_timeline_len].display = model->display;
+        memcpy(gs_timeline[gs_timeline_len].ram, model->ram, 6);
+    }
+    model->key = (uint8_t)(0xE0 | ((gs_timeline_len % 4) << 3) | (gs_timeline_len % 8));
+    gs_timeline_len++;
+}
+
+/**
+ * @brief      stress state
+ * @param[in]  *ctx is the bus context, NULL is the iic port and the others point to a parallel line
+ * @param[out] *display points to a display control buffer
+ * @param[out] *ram points to a display ram buffer
+ * @param[out] *errors points to a protocol error counter buffer
+ * @return     status code
+ *             - 0 success
+ * @note       none
+ */
+static uint8_t a_stress_state(void *ctx, uint8_t *display, uint8_t *ram, uint32_t *errors)
+{
+    model_t *model = (ctx == NULL) ? gpio_iic_model() : gpio_parallel_model(*(uint8_t *)ctx);
+
+    *display = model->display;
+    memcpy(ram, model->ram, 6);
+    *errors = model->errors;
+
+    return 0;
+}
+
+/**
+ * @brief      setup displays
+ * @param[out] **ctx points to a bus context buffer
+ * @param[out] *line points to a parallel line buffer
+ * @param[in]  modules is the display number
+ * @note       display 0 is on the iic port and the others are on the parallel lines,
+ *             every model gets its own key
+ */
+static void a_setup_displays(void **ctx, uint8_t *line, uint8_t modules)
+{
+    uint8_t m;
+
+    (void)gpio_iic_init();
+    (void)gpio_parallel_init();
+    ctx[0] = NULL;
+    gpio_iic_model()->key = 0xEF;
+    for (m = 1; m < modules; m++)
+    {
+        line[m - 1] = m - 1;
+        ctx[m] = &line[m - 1];
+        gpio_parallel_model(m - 1)->key = (uint8_t)(0xE0 | ((m % 4) << 3) | (m % 8));
+    }
+}
+
+/**
+ * @brief     check models
+ * @param[in] **ctx points to the bus contexts, NULL is the iic port and the others point to a parallel line
+ * @param[in] modules is the display number
+ * @param[in] times is the test times
+ * @param[in] display_on is the expected display bit
+ * @param[in] mask is the checked display control bits, 0x08 is the display bit and 0x0F adds the 14/16 pulse width
+ * @return    status code
+ *            - 0 success
+ *            - 1 check failed
+ * @note      display m shows the numbers from times - 1 + m
+ */
+static uint8_t a_check_models(void **ctx, uint8_t modules, uint32_t times, uint8_t display_on, uint8_t mask)
+{
+    uint8_t expect = (uint8_t)(((display_on != 0) ? 0x08 : 0x00) | TM1637_PULSE_WIDTH_14_DIV_16);
+    uint8_t m;
+    uint8_t i;
+
+    for (m = 0; m < modules; m++)
+    {
+        model_t *model = (ctx[m] == NULL) ? gpio_iic_model() : gpio_parallel_model(*(uint8_t *)ctx[m]);
+
+        for (i = 0; i < 6; i++)
+        {
+            if (model->ram[i] != gs_number[(times - 1 + m + i) % 10])
+            {
+                tm1637_interface_debug_print("tm1637: display %d digit %d mismatch.\n", m, i);
+
+                return 1;
+            }
+        }
+        if (((model->display & mask) != (expect & mask)) || (model->errors != 0))
+        {
+            tm1637_interface_debug_print("tm1637: display %d display 0x%02X errors %d.\n", m, model->display, model->errors);
+
+            return 1;
+        }
+    }
+    tm1637_interface_debug_print("tm1637: check %d displays ok.\n", modules);
+
+    return 0;
+}
+
+/**
+ * @brief     vcd probe
+ * @param[in] read is 1 before a host sample and 0 after a pin write
+ * @param[in] scl is the clock level
+ * @param[in] sda is the data level driven by the host
+ * @param[in] chip is the data level driven by the chip
+ * @note      it dumps the iic port and checks the host timing
+ */
+static void a_vcd_probe(uint8_t read, uint8_t scl, uint8_t sda, uint8_t chip)
+{
+    uint64_t ns = delay_timestamp_ns();
+
+    if (read != 0)
+    {
+        vcd_trigger(&gs_vcd, ns, 0);
+        timing_sample(&gs_timing, ns);
+
+        return;
+    }
+    vcd_change(&gs_vcd, ns, 0, scl);
+    vcd_change(&gs_vcd, ns, 1, sda & chip);
+    vcd_change(&gs_vcd, ns, 2, sda);
+    vcd_change(&gs_vcd, ns, 3, chip);
+    timing_edge(&gs_timing, ns, scl, sda);
+}
+
+/**
+ * @brief     timing report
+ * @param[in] ns is the timestamp
+ * @param[in] rule is the timing rule
+ * @param[in] measured_ns is the measured time
+ * @param[in] min_ns is the limit
+ * @note      it prints the first 8 violations
+ */
+static void a_timing_report(uint64_t ns, timing_rule_t rule, uint64_t measured_ns, uint32_t min_ns)
+{
+    if (gs_report_len < 8)
+    {
+        tm1637_interface_debug_print("tm1637: at %lluns %s is %lluns under %uns.\n",
+                                     (unsigned long long)ns, timing_rule_name(rule),
+                                     (unsigned long long)measured_ns, min_ns);
+    }
+    gs_report_len++;
+}
+
+/**
+ * @brief     timing print
+ * @param[in] *timing points to a timing structure
+ * @return    timing violations
+ * @note      it prints the margin of every checked rule
+ */
+static uint32_t a_timing_print(timing_t *timing)
+{
+    const char *const limit_name[] = {"datasheet", "datasheet", "500kHz", "datasheet",
+                                      "datasheet", "assumed", "assumed", "datasheet"};
+    uint32_t violations = 0;
+    uint8_t i;
+
+    tm1637_interface_debug_print("tm1637: rule        checks  min(ns)  limit(ns)  margin(ns)  violations\n");
+    for (i = 0; i < TIMING_RULE_NUM; i++)
+    {
+        timing_stat_t *stat = &timing->stat[i];
+
+        if (stat->checks == 0)
+        {
+            continue;
+        }
+        tm1637_interface_debug_print("tm1637: %-10s  %6u  %7llu  %9u  %10lld  %10u  %s\n",
+                                     timing_rule_name((timing_rule_t)i), stat->checks,
+                                     (unsigned long long)stat->min_ns, timing->limit.min_ns[i],
+                                     (long long)stat->min_ns - (long long)timing->limit.min_ns[i],
+                                     stat->violations, limit_name[i]);
+        violations += stat->violations;
+    }
+
+    return violations;
+}
+
+/**
+ * @brief     capture writer level
+ * @param[in] ns is the timestamp
+ * @note      it writes a csv line when the bus level changes
+ */
+static void a_capture_level(uint64_t ns)
+{
+    uint8_t level = (uint8_t)(gs_writer.scl | ((gs_writer.sda & gs_writer.chip) << 1));
+
+    if (level != gs_writer.level)
+    {
+        gs_writer.level = level;
+        fprintf(gs_writer.csv, "%llu.%09llu,%u,%u\n", (unsigned long long)(ns / 1000000000ULL),
+                (unsigned long long)(ns % 1000000000ULL), level & 0x01, (level >> 1) & 0x01);
+    }
+}
+
+/**
+ * @brief     capture writer fill
+ * @param[in] ns is the timestamp
+ * @note      it writes the binary samples before ns and applies a due chip output on the way
+ */
+static void a_capture_fill(uint64_t ns)
+{
+    uint64_t until;
+    uint64_t n;
+    uint32_t len;
+
+    while (1)
+    {
+        /* stop at a chip output change inside the span */
+        until = ((gs_writer.pending != 0) && (gs_writer.pending_ns <= ns)) ? gs_writer.pending_ns : ns;
+        while (gs_writer.index * gs_writer.period_ns < until)
+        {
+            n = (until - gs_writer.index * gs_writer.period_ns + gs_writer.period_ns - 1) / gs_writer.period_ns;
+            len = (n > sizeof(gs_writer.buf)) ? (uint32_t)sizeof(gs_writer.buf) : (uint32_t)n;
+            memset(gs_writer.buf, gs_writer.level, len);
+            (void)fwrite(gs_writer.buf, 1, len, gs_writer.bin);
+            gs_writer.index += len;
+        }
+        if ((gs_writer.pending == 0) || (gs_writer.pending_ns > ns))
+        {
+            break;
+        }
+
+        /* the chip output reaches the bus */
+        gs_writer.pending = 0;
+        gs_writer.chip = gs_writer.chip_next;
+        a_capture_level(until);
+    }
+}
+
+/**
+ * @brief     capture writer probe
+ * @param[in] read is 1 before a host sample and 0 after a pin write
+ * @param[in] scl is the clock level
+ * @param[in] sda is the data level driven by the host
+ * @param[in] chip is the data level driven by the chip
+ * @note      it records the bus like a logic analyzer, the chip output comes after its output delay
+ */
+static void a_capture_probe(uint8_t read, uint8_t scl, uint8_t sda, uint8_t chip)
+{
+    uint64_t ns = delay_timestamp_ns();
+
+    if (read != 0)
+    {
+        return;
+    }
+    a_capture_fill(ns);
+    if ((scl != 0) && (gs_writer.scl != 0) && (gs_writer.sda != 0) && (sda == 0))
+    {
+        gs_writer.starts++;
+    }
+    gs_writer.scl = scl;
+    gs_writer.sda = sda;
+    if (chip != gs_writer.chip_next)
+    {
+        gs_writer.chip_next = chip;
+        gs_writer.pending = 1;
+        gs_writer.pending_ns = ns + gs_writer.delay_ns;
+    }
+    a_capture_level(ns);
+}
+
+/**
+ * @brief     capture edge
+ * @param[in] *ctx points to a decode structure
+ * @param[in] ns is the timestamp
+ * @param[in] clk is the clock level
+ * @param[in] dio is the data level
+ * @note      none
+ */
+static void a_capture_edge(void *ctx, uint64_t ns, uint8_t clk, uint8_t dio)
+{
+    decode_edge((decode_t *)ctx, ns, clk, dio);
+}
+
+/**
+ * @brief     capture record
+ * @param[in] *ctx points to a capture check structure
+ * @param[in] *record points to a decode record structure
+ * @note      print 1 prints the flagged records and 2 prints all
+ */
+static void a_capture_record(void *ctx, const decode_record_t *record)
+{
+    capture_check_t *check = (capture_check_t *)ctx;
+    char data[DECODE_MAX_BYTE * 3 + 1];
+    char flags[128];
+    uint16_t len;
+    uint8_t read;
+    uint8_t i;
+
+    /* count */
+    read = ((record->len != 0) && ((record->data[0] & 0xC2) == 0x42)) ? 1 : 0;
+    check->records++;
+    check->nack += ((record->flags & DECODE_FLAG_NACK) != 0) ? 1 : 0;
+    check->timing += ((record->flags & DECODE_FLAG_TIMING) != 0) ? 1 : 0;
+    check->flagged += (record->flags != 0) ? 1 : 0;
+    check->written += (read != 0) ? 1 : record->bytes;
+    if ((record->len == 7) && ((record->data[0] & 0xC0) == 0xC0))
+    {
+        memcpy(check->digit, &record->data[1], 6);
+    }
+    if ((read != 0) && (record->len >= 2))
+    {
+        check->key = record->data[1];
+    }
+
+    /* fnv-1a of what the bus carried */
+    for (i = 0; i < record->len; i++)
+    {
+        check->hash = (check->hash ^ record->data[i]) * 16777619U;
+    }
+    check->hash = (check->hash ^ record->ack) * 16777619U;
+    check->hash = (check->hash ^ record->flags) * 16777619U;
+
+    /* print */
+    if ((check->print == 0) || ((check->print == 1) && (record->flags == 0)))
+    {
+        return;
+    }
+    len = 0;
+    for (i = 0; i < record->len; i++)
+    {
+        len += (uint16_t)snprintf(&data[len], sizeof(data) - len, (i == 0) ? "%02X" : " %02X", record->data[i]);
+    }
+    data[len] = '\0';
+    len = (uint16_t)snprintf(flags, sizeof(flags), "%s", (record->flags == 0) ? " ok" : "");
+    for (i = 0; i < 8; i++)
+    {
+        if ((record->flags & (1 << i)) != 0)
+        {
+            len += (uint16_t)snprintf(&flags[len], sizeof(flags) - len, " %s", decode_flag_name((decode_flag_t)(1 << i)));
+        }
+    }
+    for (i = 0; i < TIMING_RULE_NUM; i++)
+    {
+        if ((record->timing & (1 << i)) != 0)
+        {
+            len += (uint16_t)snprintf(&flags[len], sizeof(flags) - len, " %s", timing_rule_name((timing_rule_t)i));
+        }
+    }
+    tm1637_interface_debug_print("tm1637: at %lluns for %lluns period %uns data %s ack 0x%02X%s.\n",
+                                 (unsigned long long)record->start_ns,
+                                 (unsigned long long)(record->end_ns - record->start_ns),
+                                 record->period_ns, data, record->ack, flags);
+}
+
+/**
+ * @brief     trace file write
+ * @param[in] *file points to a file
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+static uint8_t a_trace_write(void *file, const char *buf, uint16_t len)
+{
+    if (fwrite(buf, 1, len, (FILE *)file) != len)
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief     tm1637 full function
+ * @param[in] argc is arg numbers
+ * @param[in] **argv is the arg address
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ *            - 5 param is invalid
+ * @note      none
+ */
+uint8_t tm1637(uint8_t argc, char **argv)
+{
+    int c;
+    int longindex = 0;
+    char short_options[] = "hipe:t:";
+    struct option long_options[] =
+    {
+        {"help", no_argument, NULL, 'h'},
+        {"information", no_argument, NULL, 'i'},
+        {"port", no_argument, NULL, 'p'},
+        {"example", required_argument, NULL, 'e'},
+        {"test", required_argument, NULL, 't'},
+        {"addr", required_argument, NULL, 1},
+        {"num", required_argument, NULL, 2},
+        {"times", required_argument, NULL, 3},
+        {"modules", required_argument, NULL, 4},
+        {"threads", required_argument, NULL, 5},
+        {"display", required_argument, NULL, 6},
+        {"device", required_argument, NULL, 7},
+        {"clock", required_argument, NULL, 8},
+        {"file", required_argument, NULL, 9},
+        {"timing", required_argument, NULL, 10},
+        {"rate", required_argument, NULL, 11},
+        {NULL, 0, NULL, 0},
+    };
+    char type[33] = "unknown";
+    uint8_t addr = 0;
+    uint8_t num = 0;
+    uint32_t times = 3;
+    uint8_t modules = 16;
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    uint8_t display = 0;
+    char device[64] = "/dev/ttyACM0";
+    uint8_t virtual_clock = 1;
+    char file[256] = "";
+    uint32_t phase_ns = 15000;
+    uint32_t bit_ns = 10000;
+    uint64_t rate = 0;
+    uint8_t bus[GPIO_BUS_NUM];
+    uint8_t m;
+    uint8_t i;
+    uint8_t line[16];
+    uint8_t key[16];
+    void *ctx[16];
+    uint16_t l;
+
+    /* if no params */
+    if (argc == 1)
+    {
+        /* goto the help */
+        goto help;
+    }
+
+    /* init 0 */
+    optind = 0;
+
+    /* parse */
+    do
+    {
+        /* parse the args */
+        c = getopt_long(argc, argv, short_options, long_options, &longindex);
+
+        /* judge the result */
+        switch (c)
+        {
+            /* help */
+            case 'h' :
+            {
+                /* set the type */
+                memset(type, 0, sizeof(char) * 33);
+                snprintf(type, 32, "h");
+
+                break;
+            }
+
+            /* information */
+            case 'i' :
+            {
+                /* set the type */
+                memset(type, 0, sizeof(char) * 33);
+                snprintf(type, 32, "i");
+
+                break;
+            }
+
+            /* port */
+            case 'p' :
+            {
+                /* set the type */
+                memset(type, 0, sizeof(char) * 33);
+                snprintf(type, 32, "p");
+
+                break;
+            }
+
+            /* example */
+            case 'e' :
+            {
+                /* set the type */
+                memset(type, 0, sizeof(char) * 33);
+                snprintf(type, 32, "e_%s", optarg);
+
+                break;
+            }
+
+            /* test */
+            case 't' :
+            {
+                /* set the type */
+                memset(type, 0, sizeof(char) * 33);
+                snprintf(type, 32, "t_%s", optarg);
+
+                break;
+            }
+
+            /* addr */
+            case 1 :
+            {
+                /* set the address */
+                addr = atol(optarg);
+                if (addr > 7)
+                {
+                    return 1;
+                }
+
+                break;
+            }
+
+            /* num */
+            case 2 :
+            {
+                /* set the number */
+                num = atol(optarg);
+                if (num > 9)
+                {
+                    return 1;
+                }
+
+                break;
+            }
+
+            /* running times */
+            case 3 :
+            {
+                /* set the times */
+                times = atol(optarg);
+
+                break;
+            }
+
+            /* module number */
+            case 4 :
+            {
+                /* set the module number */
+                modules = atol(optarg);
+                if ((modules == 0) || (modules > 16))
+                {
+                    return 1;
+                }
+
+                break;
+            }
+
+            /* thread number */
+            case 5 :
+            {
+                /* set the thread number */
+                threads = atol(optarg);
+                if ((threads <= 0) || (threads > TM1637_POOL_MAX_THREAD))
+                {
+                    return 1;
+                }
+
+                break;
+            }
+
+            /* display index */
+            case 6 :
+            {
+                /* set the display index */
+                display = atol(optarg);
+
+                break;
+            }
+
+            /* serial device */
+            case 7 :
+            {
+                /* set the serial device */
+                memset(device, 0, sizeof(char) * 64);
+                strncpy(device, optarg, 63);
+
+                break;
+            }
+
+            /* clock */
+            case 8 :
+            {
+                /* set the clock */
+                if (strcmp("virtual", optarg) == 0)
+                {
+                    virtual_clock = 1;
+                }
+                else if (strcmp("real", optarg) == 0)
+                {
+                    virtual_clock = 0;
+                }
+                else
+                {
+                    return 5;
+                }
+
+                break;
+            }
+
+            /* output file */
+            case 9 :
+            {
+                /* set the output file */
+                memset(file, 0, sizeof(char) * 256);
+                strncpy(file, optarg, 255);
+
+                break;
+            }
+
+            /* timing */
+            case 10 :
+            {
+                char *end;
+
+                /* set the iic phase and bit time */
+                phase_ns = (uint32_t)strtoul(optarg, &end, 10);
+                if ((end == optarg) || (*end != ','))
+                {
+                    return 5;
+                }
+                bit_ns = (uint32_t)strtoul(end + 1, &end, 10);
+                if (*end != '\0')
+                {
+                    return 5;
+                }
+
+                break;
+            }
+
+            /* sample rate */
+            case 11 :
+            {
+                char *end;
+
+                /* set the capture sample rate */
+                rate = (uint64_t)strtoull(optarg, &end, 10);
+                if ((end == optarg) || (*end != '\0') || (rate == 0))
+                {
+                    return 5;
+                }
+
+                break;
+            }
+
+            /* the end */
+            case -1 :
+            {
+                break;
+            }
+
+            /* others */
+            default :
+            {
+                return 5;
+            }
+        }
+    } while (c != -1);
+
+    /* run the function */
+    if (strcmp("t_write", type) == 0)
+    {
+        const uint32_t ms[7] = {5000, 5000, 3000, 3000, 3000, 3000, 3000};
+        const uint8_t conf[7] = {0x08 | TM1637_PULSE_WIDTH_14_DIV_16, 0x08 | TM1637_PULSE_WIDTH_14_DIV_16,
+                                 0x08 | TM1637_PULSE_WIDTH_12_DIV_16, 0x08 | TM1637_PULSE_WIDTH_10_DIV_16,
+                                 0x08 | TM1637_PULSE_WIDTH_2_DIV_16, TM1637_PULSE_WIDTH_2_DIV_16,
+                                 0x08 | TM1637_PULSE_WIDTH_14_DIV_16};
+        const uint8_t first[7] = {0, 1, 1, 1, 1, 1, 1};
+        uint8_t res;
+        uint32_t start;
+        uint64_t us;
+
+        /* run the write test, the virtual clock skips the delays and the probe saves what each one shows */
+        gs_timeline_len = 0;
+        start = delay_timestamp_us();
+        if (virtual_clock != 0)
+        {
+            delay_virtual_start(a_timeline_probe);
+        }
+        res = tm1637_write_test();
+        us = (virtual_clock != 0) ? delay_virtual_stop() : 0;
+        if (res != 0)
+        {
+            return 1;
+        }
+        if (virtual_clock == 0)
+        {
+            return 0;
+        }
+        tm1637_interface_debug_print("tm1637: %dms of virtual time in %dus.\n",
+                                     (uint32_t)(us / 1000), delay_timestamp_us() - start);
+
+        /* check the display at every delay */
+        if (gs_timeline_len != 7)
+        {
+            tm1637_interface_debug_print("tm1637: %d delays instead of 7.\n", gs_timeline_len);
+
+            return 1;
+        }
+        for (m = 0; m < 7; m++)
+        {
+            tm1637_interface_debug_print("tm1637: at %dms for %dms display 0x%02X ram %02X %02X %02X %02X %02X %02X.\n",
+                                         gs_timeline[m].us / 1000, gs_timeline[m].ms, gs_timeline[m].display,
+                                         gs_timeline[m].ram[0], gs_timeline[m].ram[1], gs_timeline[m].ram[2],
+                                         gs_timeline[m].ram[3], gs_timeline[m].ram[4], gs_timeline[m].ram[5]);
+            if ((gs_timeline[m].ms != ms[m]) || ((gs_timeline[m].display & 0x0F) != conf[m]) ||
+                ((m != 0) && ((gs_timeline[m].us - gs_timeline[m - 1].us) < ms[m - 1] * 1000)))
+            {
+                tm1637_interface_debug_print("tm1637: delay %d mismatch.\n", m);
+
+                return 1;
+            }
+            for (i = 0; i < 6; i++)
+            {
+                if (gs_timeline[m].ram[i] != gs_number[first[m] + i])
+                {
+                    tm1637_interface_debug_print("tm1637: delay %d digit %d mismatch.\n", m, i);
+
+                    return 1;
+                }
+            }
+        }
+        if (gpio_iic_model()->errors != 0)
+        {
+            tm1637_interface_debug_print("tm1637: iic model errors %d.\n", gpio_iic_model()->errors);
+
+            return 1;
+        }
+        tm1637_interface_debug_print("tm1637: check 7 delays ok.\n");
+
+        return 0;
+    }
+    else if (strcmp("t_read", type) == 0)
+    {
+        uint8_t res;
+        uint32_t start;
+        uint64_t us;
+
+        /* run the read test, the probe presses a different key before every read */
+        gs_timeline_len = 0;
+        start = delay_timestamp_us();
+        if (virtual_clock != 0)
+        {
+            delay_virtual_start(a_timeline_probe);
+        }
+        res = tm1637_read_test(times);
+        us = (virtual_clock != 0) ? delay_virtual_stop() : 0;
+        if (res != 0)
+        {
+            return 1;
+        }
+        if (virtual_clock == 0)
+        {
+            return 0;
+        }
+        tm1637_interface_debug_print("tm1637: %dms of virtual time in %dus.\n",
+                                     (uint32_t)(us / 1000), delay_timestamp_us() - start);
+
+        /* check the delays */
+        if ((gs_timeline_len != times) || (gpio_iic_model()->errors != 0))
+        {
+            tm1637_interface_debug_print("tm1637: %d delays iic model errors %d.\n", gs_timeline_len, gpio_iic_model()->errors);
+
+            return 1;
+        }
+        tm1637_interface_debug_print("tm1637: check %d delays ok.\n", times);
+
+        return 0;
+    }
+    else if (strcmp("t_scheduler", type) == 0)
+    {
+        uint8_t res;
+
+        /* run the scheduler test, the virtual clock makes every deadline exact */
+        if (virtual_clock != 0)
+        {
+            delay_virtual_start(NULL);
+        }
+        res = tm1637_scheduler_test();
+        if (virtual_clock != 0)
+        {
+            (void)delay_virtual_stop();
+        }
+        if (res != 0)
+        {
+            return 1;
+        }
+        if (gpio_iic_model()->errors != 0)
+        {
+            tm1637_interface_debug_print("tm1637: iic model errors %d.\n", gpio_iic_model()->errors);
+
+            return 1;
+        }
+
+        return 0;
+    }
+    else if (strcmp("t_mailbox", type) == 0)
+    {
+        /* run the mailbox test */
+        if (tm1637_mailbox_test(times) != 0)
+        {
+            return 1;
+        }
+        if (gpio_iic_model()->errors != 0)
+        {
+            tm1637_interface_debug_print("tm1637: iic model errors %d.\n", gpio_iic_model()->errors);
+
+            return 1;
+        }
+
+        return 0;
+    }
+    else if (strcmp("t_queue", type) == 0)
+    {
+        /* run the queue test */
+        if (tm1637_queue_test(times) != 0)
+        {
+            return 1;
+        }
+        if (gpio_iic_model()->errors != 0)
+        {
+            tm1637_interface_debug_print("tm1637: iic model errors %d.\n", gpio_iic_model()->errors);
+
+            return 1;
+        }
+
+        return 0;
+    }
+    else if (strcmp("t_vdisplay", type) == 0)
+    {
+        /* run the vdisplay test */
+        if (tm1637_vdisplay_test() != 0)
+        {
+            return 1;
+        }
+        if (gpio_iic_model()->errors != 0)
+        {
+            tm1637_interface_debug_print("tm1637: iic model errors %d.\n", gpio_iic_model()->errors);
+
+            return 1;
+        }
+
+        return 0;
+    }
+    else if (strcmp("t_diff", type) == 0)
+    {
+        /* run the diff test */
+        if (tm1637_diff_test(times) != 0)
+        {
+            return 1;
+        }
+
+        return 0;
+    }
+    else if (strcmp("t_ring", type) == 0)
+    {
+        /* run the ring test */
+        if (tm1637_ring_test(times) != 0)
+        {
+            return 1;
+        }
+
+        return 0;
+    }
+    else if (strcmp("t_parallel", type) == 0)
+    {
+        /* press a different key on every model */
+        (void)gpio_parallel_init();
+        for (m = 0; m < modules; m++)
+        {
+            line[m] = m;
+            ctx[m] = &line[m];
+            key[m] = (uint8_t)(0xE0 | ((m % 4) << 3) | (m % 8));
+            gpio_parallel_model(m)->key = key[m];
+        }
+
+        /* run the parallel test */
+        if (tm1637_parallel_test(modules, times, key) != 0)
+        {
+            return 1;
+        }
+
+        /* check the ram of every model */
+        if (a_check_models(ctx, modules, times, 1, 0x0F) != 0)
+        {
+            return 1;
+        }
+
+        return 0;
+    }
+    else if (strcmp("t_group", type) == 0)
+    {
+        /* run the group test on the parallel lines */
+        (void)gpio_parallel_init();
+        if (tm1637_group_test() != 0)
+        {
+            return 1;
+        }
+
+        /* module 3 is in no group */
+        for (m = 0; m < 4; m++)
+        {
+            model_t *model = gpio_parallel_model(m);
+
+            if ((model->errors != 0) || ((m == 3) && (model->bytes != 0)))
+            {
+                tm1637_interface_debug_print("tm1637: module %d bytes %d errors %d.\n", m, model->bytes, model->errors);
+
+                return 1;
+            }
+        }
+
+        return 0;
+    }
+    else if (strcmp("t_fleet", type) == 0)
+    {
+        /* run the fleet test */
+        if (tm1637_fleet_test(times) != 0)
+        {
+            return 1;
+        }
+
+        return 0;
+    }
+    else if (strcmp("t_multi", type) == 0)
+    {
+        /* display 0 on the iic port and the others on the parallel lines */
+        a_setup_displays(ctx, line, modules);
+
+        /* run the multi test */
+        if (tm1637_multi_test(ctx, modules, times) != 0)
+        {
+            return 1;
+        }
+
+        /* check the ram of every model */
+        if (a_check_models(ctx, modules, times, 0, 0x08) != 0)
+        {
+            return 1;
+        }
+
+        return 0;
+    }
+    else if (strcmp("t_stress", type) == 0)
+    {
+        /* display 0 on the iic port and the others on the parallel lines, which share one port lock */
+        a_setup_displays(ctx, line, modules);
+
+        /* one thread per core by default */
+        if ((threads <= 0) || (threads > TM1637_STRESS_TEST_MAX_THREAD))
+        {
+            threads = (threads <= 0) ? 1 : TM1637_STRESS_TEST_MAX_THREAD;
+        }
+
+        /* run the stress test */
+        if (tm1637_stress_test(ctx, modules, a_stress_state, (uint8_t)threads, times) != 0)
+        {
+            return 1;
+        }
+
+        return 0;
+    }
+    else if (strcmp("t_trace", type) == 0)
+    {
+        FILE *fp;
+        uint8_t res;
+
+        /* display 0 on the iic port and the others on the parallel lines */
+        a_setup_displays(ctx, line, modules);
+
+        /* open the trace file */
+        if (file[0] == '\0')
+        {
+            strncpy(file, "tm1637_trace.json", 255);
+        }
+        fp = fopen(file, "w");
+        if (fp == NULL)
+        {
+            tm1637_interface_debug_print("tm1637: open %s failed.\n", file);
+
+            return 1;
+        }
+
+        /* run the trace test, the virtual clock models a 100kHz bus */
+        res = tm1637_trace_test(ctx, modules, (virtual_clock != 0) ? 10 : 0, times, a_trace_write, fp);
+        if (fclose(fp) != 0)
+        {
+            res = 1;
+        }
+        if (res != 0)
+        {
+            return 1;
+        }
+        tm1637_interface_debug_print("tm1637: trace saved to %s.\n", file);
+
+        return 0;
+    }
+    else if (strcmp("t_vcd", type) == 0)
+    {
+        const char *const wire[] = {"clk", "dio", "dio_host", "dio_chip"};
+        const char *const event[] = {"sample"};
+        timing_limit_t limit;
+        uint32_t violations;
+        uint8_t res;
+        uint8_t seg;
+        uint8_t k;
+
+        /* dump the iic port and check every edge */
+        if (file[0] == '\0')
+        {
+            strncpy(file, "tm1637.vcd", 255);
+        }
+        (void)gpio_iic_init();
+        gpio_iic_model()->key = 0xEF;
+        if (vcd_open(&gs_vcd, file, wire, 4, event, 1) != 0)
+        {
+            tm1637_interface_debug_print("tm1637: open %s failed.\n", file);
+
+            return 1;
+        }
+        timing_limit_default(&limit);
+        timing_init(&gs_timing, &limit, a_timing_report);
+        gs_report_len = 0;
+        iic_set_timing(phase_ns, bit_ns);
+        tm1637_interface_debug_print("tm1637: iic phase %uns and bit %uns.\n", phase_ns, bit_ns);
+
+        /* run the basic flow on the virtual clock */
+        delay_virtual_start(NULL);
+        gpio_iic_set_probe(a_vcd_probe);
+        res = tm1637_basic_init();
+        if (res == 0)
+        {
+            res = tm1637_basic_write(0, gs_number, 6);
+        }
+        if (res == 0)
+        {
+            res = tm1637_basic_read(&seg, &k);
+        }
+        if (res == 0)
+        {
+            res = tm1637_basic_display_on();
+        }
+        if (res == 0)
+        {
+            res = tm1637_basic_deinit();
+        }
+        gpio_iic_set_probe(NULL);
+        if (vcd_close(&gs_vcd, delay_timestamp_ns()) != 0)
+        {
+            res = 1;
+        }
+        (void)delay_virtual_stop();
+        iic_set_timing(15000, 10000);
+        if (res != 0)
+        {
+            tm1637_interface_debug_print("tm1637: basic flow failed.\n");
+
+            return 1;
+        }
+        if ((memcmp(gpio_iic_model()->ram, gs_number, 6) != 0) || (gpio_iic_model()->errors != 0))
+        {
+            tm1637_interface_debug_print("tm1637: iic model mismatch with %d errors.\n", gpio_iic_model()->errors);
+
+            return 1;
+        }
+        tm1637_interface_debug_print("tm1637: %d changes saved to %s.\n", gs_vcd.changes, file);
+
+        /* print the margin of every rule */
+        violations = a_timing_print(&gs_timing);
+        if (violations != 0)
+        {
+            tm1637_interface_debug_print("tm1637: %d timing violations.\n", violations);
+
+            return 1;
+        }
+        tm1637_interface_debug_print("tm1637: timing check ok.\n");
+
+        return 0;
+    }
+    else if (strcmp("t_capture", type) == 0)
+    {
+        capture_check_t check[2];
+        timing_limit_t limit;
+        decode_t decode;
+        capture_t capture;
+        char path[2][264];
+        const char *const format[] = {"binary", "csv"};
+        uint32_t clean;
+        uint32_t fast;
+        uint32_t start;
+        uint32_t t;
+        uint8_t res;
+        uint8_t seg;
+        uint8_t k;
+
+        /* record the iic port like a 4MHz logic analyzer, the chip output comes 200ns after the clock */
+        if (file[0] == '\0')
+        {
+            strncpy(file, "tm1637_capture", 255);
+        }
+        (void)snprintf(path[0], 264, "%s.bin", file);
+        (void)snprintf(path[1], 264, "%s.csv", file);
+        memset(&gs_writer, 0, sizeof(capture_writer_t));
+        gs_writer.bin = fopen(path[0], "wb");
+        gs_writer.csv = fopen(path[1], "w");
+        if ((gs_writer.bin == NULL) || (gs_writer.csv == NULL))
+        {
+            tm1637_interface_debug_print("tm1637: open %s failed.\n", file);
+            if (gs_writer.bin != NULL)
+            {
+                (void)fclose(gs_writer.bin);
+            }
+            if (gs_writer.csv != NULL)
+            {
+                (void)fclose(gs_writer.csv);
+            }
+
+            return 1;
+        }
+        gs_writer.period_ns = 250;
+        gs_writer.delay_ns = 200;
+        gs_writer.scl = 1;
+        gs_writer.sda = 1;
+        gs_writer.chip = 1;
+        gs_writer.chip_next = 1;
+        gs_writer.level = 0x03;
+        fprintf(gs_writer.csv, "; D0 is CLK and D1 is DIO\nTime [s],D0,D1\n0.000000000,1,1\n");
+        (void)gpio_iic_init();
+        gpio_iic_model()->key = 0xEF;
+        delay_virtual_start(NULL);
+        gpio_iic_set_probe(a_capture_probe);
+
+        /* clean rounds with a 10ms refresh gap */
+        res = 0;
+        for (t = 0; t < times; t++)
+        {
+            res |= tm1637_basic_init();
+            res |= tm1637_basic_write(0, gs_number, 6);
+            res |= tm1637_basic_read(&seg, &k);
+            res |= tm1637_basic_display_on();
+            res |= tm1637_basic_deinit();
+            delay_ms(10);
+        }
+        clean = gs_writer.starts;
+
+        /* a chip that drops out misses the ack */
+        res |= tm1637_basic_init();
+        gpio_iic_model()->ack_enable = 0;
+        res |= (tm1637_basic_write(0, gs_number, 6) == 0) ? 1 : 0;
+        gpio_iic_model()->ack_enable = 1;
+        res |= tm1637_basic_deinit();
+        delay_ms(10);
+
+        /* a round four times faster than the 500kHz limit */
+        fast = gs_writer.starts;
+        iic_set_timing(500, 250);
+        res |= tm1637_basic_init();
+        res |= tm1637_basic_write(0, gs_number, 6);
+        res |= tm1637_basic_read(&seg, &k);
+        res |= tm1637_basic_display_on();
+        res |= tm1637_basic_deinit();
+        iic_set_timing(15000, 10000);
+        fast = gs_writer.starts - fast;
+        delay_ms(10);
+        gpio_iic_set_probe(NULL);
+        a_capture_fill(delay_timestamp_ns());
+        (void)delay_virtual_stop();
+        if ((fclose(gs_writer.bin) != 0) || (fclose(gs_writer.csv) != 0) || (res != 0))
+        {
+            tm1637_interface_debug_print("tm1637: capture failed.\n");
+
+            return 1;
+        }
+        tm1637_interface_debug_print("tm1637: %d transactions, %d in the clean rounds and %d in the fast round.\n",
+                                     gs_writer.starts, clean, fast);
+
+        /* decode both files in one pass each */
+        timing_limit_default(&limit);
+        for (t = 0; t < 2; t++)
+        {
+            uint32_t us;
+
+            memset(&check[t], 0, sizeof(capture_check_t));
+            check[t].hash = 2166136261U;
+            check[t].print = (t == 0) ? 1 : 0;
+            decode_init(&decode, &limit, a_capture_record, &check[t]);
+            if (capture_open(&capture, path[t], 4000000) != 0)
+            {
+                tm1637_interface_debug_print("tm1637: open %s failed.\n", path[t]);
+
+                return 1;
+            }
+            start = delay_timestamp_us();
+            res = capture_run(&capture, a_capture_edge, &decode);
+            decode_finish(&decode, capture.end_ns);
+            us = delay_timestamp_us() - start;
+            capture_close(&capture);
+            if (res != 0)
+            {
+                tm1637_interface_debug_print("tm1637: decode %s failed at line %llu.\n",
+                                             path[t], (unsigned long long)capture.line);
+
+                return 1;
+            }
+            tm1637_interface_debug_print("tm1637: %s %llu bytes %llu samples in %uus, %lluMB/s.\n",
+                                         format[t], (unsigned long long)capture.size,
+                                         (unsigned long long)capture.samples, us,
+                                         (unsigned long long)capture.size / ((us != 0) ? us : 1));
+            tm1637_interface_debug_print("tm1637: %s %llu records, %llu without ack, %llu timing, %llu flagged.\n",
+                                         format[t], (unsigned long long)check[t].records,
+                                         (unsigned long long)check[t].nack,
+                                         (unsigned long long)check[t].timing,
+                                         (unsigned long long)check[t].flagged);
+            if (t == 0)
+            {
+                (void)a_timing_print(&decode.timing);
+            }
+
+            /* every transaction with the bytes the model got */
+            if ((check[t].records != gs_writer.starts) || (check[t].nack != 1) ||
+                (check[t].timing != fast) || (check[t].flagged != 1 + fast) ||
+                (check[t].written != gpio_iic_model()->bytes) ||
+                (memcmp(check[t].digit, gs_number, 6) != 0) || (check[t].key != 0xEF))
+            {
+                tm1637_interface_debug_print("tm1637: %s decode mismatch.\n", format[t]);
+
+                return 1;
+            }
+        }
+        if (check[0].hash != check[1].hash)
+        {
+            tm1637_interface_debug_print("tm1637: binary and csv records differ.\n");
+
+            return 1;
+        }
+        tm1637_interface_debug_print("tm1637: check capture decode ok.\n");
+
+        return 0;
+    }
+    else if (strcmp("t_pool", type) == 0)
+    {
+        const tm1637_fleet_ops_t ops = {gpio_bus_write_segment, gpio_bus_write_display};
+
+        /* one worker per core by default */
+        if ((threads <= 0) || (threads > TM1637_POOL_MAX_THREAD))
+        {
+            threads = (threads <= 0) ? 1 : TM1637_POOL_MAX_THREAD;
+        }
+
+        /* every bus is its own pin pair chain */
+        (void)gpio_bus_init();
+        for (m = 0; m < GPIO_BUS_NUM; m++)
+        {
+            bus[m] = m;
+            ctx[m] = &bus[m];
+        }
+
+        /* run the pool test */
+        if (tm1637_pool_test(&ops, ctx, GPIO_BUS_NUM, GPIO_BUS_LANE, (uint8_t)threads, times) != 0)
+        {
+            return 1;
+        }
+
+        /* check the ram of every model */
+        for (m = 0; m < GPIO_BUS_NUM; m++)
+        {
+            for (l = 0; l < GPIO_BUS_LANE; l++)
+            {
+                model_t *model = gpio_bus_model(m, l);
+
+                for (i = 0; i < 6; i++)
+                {
+                    if (model->ram[i] != gs_number[(times - 1 + m + l + i) % 10])
+                    {
+                        tm1637_interface_debug_print("tm1637: bus %d lane %d digit %d mismatch.\n", m, l, i);
+
+                        return 1;
+                    }
+                }
+                if ((model->display != 0x0F) || (model->errors != 0))
+                {
+                    tm1637_interface_debug_print("tm1637: bus %d lane %d display 0x%02X errors %d.\n", m, l, model->display, model->errors);
+
+                    return 1;
+                }
+            }
+        }
+        tm1637_interface_debug_print("tm1637: check %d models ok.\n", GPIO_BUS_NUM * GPIO_BUS_LANE);
+
+        return 0;
+    }
+    else if (strcmp("t_fb", type) == 0)
+    {
+        tm1637_fb_t *fb;
+        tm1637_fb_t *client;
+        uint8_t res;
+
+        /* the daemon and the client map the same shared memory at two addresses */
+        if (shm_create("/tm1637_test", sizeof(tm1637_fb_t), (void **)&fb) != 0)
+        {
+            tm1637_interface_debug_print("tm1637: shm create failed.\n");
+
+            return 1;
+        }
+        if (shm_attach("/tm1637_test", sizeof(tm1637_fb_t), (void **)&client) != 0)
+        {
+            tm1637_interface_debug_print("tm1637: shm attach failed.\n");
+            (void)shm_detach(fb, sizeof(tm1637_fb_t));
+            (void)shm_remove("/tm1637_test");
+
+            return 1;
+        }
+
+        /* display 0 on the iic port and the others on the parallel lines */
+        a_setup_displays(ctx, line, modules);
+
+        /* run the fb test */
+        res = tm1637_fb_test(fb, client, ctx, modules, times);
+        (void)shm_detach(client, sizeof(tm1637_fb_t));
+        (void)shm_detach(fb, sizeof(tm1637_fb_t));
+        (void)shm_remove("/tm1637_test");
+        if (res != 0)
+        {
+            return 1;
+        }
+
+        /* check the ram of every model */
+        if (a_check_models(ctx, modules, times, 0, 0x08) != 0)
+        {
+            return 1;
+        }
+
+        return 0;
+    }
+    else if (strcmp("t_link", type) == 0)
+    {
+        char name[64];
+        int fd;
+        uint8_t res;
+        uint32_t frames;
+        uint32_t errors;
+
+        /* display 0 on the iic port and the others on the parallel lines */
+        a_setup_displays(ctx, line, modules);
+
+        /* the firmware stand-in serves the displays on a pty */
+        if (firmware_start(ctx, modules, name, sizeof(name)) != 0)
+        {
+            tm1637_interface_debug_print("tm1637: firmware start failed.\n");
+
+            return 1;
+        }
+        if (serial_open(name, 115200, &fd) != 0)
+        {
+            tm1637_interface_debug_print("tm1637: open %s failed.\n", name);
+            (void)firmware_stop();
+
+            return 1;
+        }
+
+        /* run the link test */
+        res = tm1637_link_test(serial_write, serial_read, &fd, FIRMWARE_RX_LEN, modules, times);
+        (void)serial_close(fd);
+        (void)firmware_stop();
+        if (res != 0)
+        {
+            return 1;
+        }
+        (void)firmware_get_statistics(&frames, &errors);
+        tm1637_interface_debug_print("tm1637: firmware frames %d errors %d.\n", frames, errors);
+
+        /* check the ram of every model, the displays stay on */
+        if (a_check_models(ctx, modules, times, 1, 0x0F) != 0)
+        {
+            return 1;
+        }
+
+        return 0;
+    }
+    else if (strcmp("t_remote", type) == 0)
+    {
+        char name[64];
+        int fd;
+        uint8_t res;
+
+        /* display 0 on the iic port and the others on the parallel lines */
+        a_setup_displays(ctx, line, modules);
+
+        /* the firmware stand-in bridges the displays on a pty */
+        if (firmware_start(ctx, modules, name, sizeof(name)) != 0)
+        {
+            tm1637_interface_debug_print("tm1637: firmware start failed.\n");
+
+            return 1;
+        }
+        if (serial_open(name, 115200, &fd) != 0)
+        {
+            tm1637_interface_debug_print("tm1637: open %s failed.\n", name);
+            (void)firmware_stop();
+
+            return 1;
+        }
+
+        /* run the remote test */
+        res = tm1637_remote_test(serial_write, serial_read, &fd, FIRMWARE_RX_LEN, modules, times);
+        (void)serial_close(fd);
+        (void)firmware_stop();
+        if (res != 0)
+        {
+            return 1;
+        }
+
+        /* check the ram of every model, the remote deinit turned the displays off */
+        if (a_check_models(ctx, modules, times, 0, 0x0F) != 0)
+        {
+            return 1;
+        }
+
+        return 0;
+    }
+    else if (strcmp("e_init", type) == 0)
+    {
+        uint8_t res;
+
+        /* init */
+        res = tm1637_basic_init();
+        if (res != 0)
+        {
+            return 1;
+        }
+
+        /* output */
+        tm1637_interface_debug_print("tm1637: init.\n");
+
+        return 0;
+    }
+    else if (strcmp("e_deinit", type) == 0)
+    {
+        uint8_t res;
+
+        /* deinit */
+        res = tm1637_basic_deinit();
+        if (res != 0)
+        {
+            return 1;
+        }
+
+        /* output */
+        tm1637_interface_debug_print("tm1637: deinit.\n");
+
+        return 0;
+    }
+    else if (strcmp("e_write", type) == 0)
+    {
+        uint8_t res;
+
+        /* init */
+        res = tm1637_basic_init();
+        if (res != 0)
+        {
+            return 1;
+        }
+
+        /* write */
+        res = tm1637_basic_write(addr, &gs_number[num], 1);
+        if (res != 0)
+        {
+            (void)tm1637_basic_deinit();
+
+            return 1;
+        }
+        (void)tm1637_basic_deinit();
+
+        /* output */
+        tm1637_interface_debug_print("tm1637: write address %d number %d.\n", addr, num);
+
+        return 0;
+    }
+    else if (strcmp("e_read", type) == 0)
+    {
+        uint8_t res;
+        uint8_t seg;
+        uint8_t k;
+
+        /* init */
+        res = tm1637_basic_init();
+        if (res != 0)
+        {
+            return 1;
+        }
+
+        /* read */
+        res = tm1637_basic_read(&seg, &k);
+        if (res != 0)
+        {
+            (void)tm1637_basic_deinit();
+
+            return 1;
+        }
+        (void)tm1637_basic_deinit();
+
+        /* output */
+        tm1637_interface_debug_print("tm1637: seg: 0x%02X.\n", seg);
+        tm1637_interface_debug_print("tm1637: k: 0x%02X.\n", k);
+
+        return 0;
+    }
+    else if (strcmp("e_on", type) == 0)
+    {
+        uint8_t res;
+
+        /* init */
+        res = tm1637_basic_init();
+        if (res != 0)
+        {
+            return 1;
+        }
+
+        /* on */
+        res = tm1637_basic_display_on();
+        if (res != 0)
+        {
+            (void)tm1637_basic_deinit();
+
+            return 1;
+        }
+        (void)tm1637_basic_deinit();
+
+        /* output */
+        tm1637_interface_debug_print("tm1637: display on.\n");
+
+        return 0;
+    }
+    else if (strcmp("e_off", type) == 0)
+    {
+        uint8_t res;
+
+        /* init */
+        res = tm1637_basic_init();
+        if (res != 0)
+        {
+            return 1;
+        }
+
+        /* off */
+        res = tm1637_basic_display_off();
+        if (res != 0)
+        {
+            (void)tm1637_basic_deinit();
+
+            return 1;
+        }
+        (void)tm1637_basic_deinit();
+
+        /* output */
+        tm1637_interface_debug_print("tm1637: display off.\n");
+
+        return 0;
+    }
+    else if (strcmp("e_multi", type) == 0)
+    {
+        uint8_t res;
+
+        /* display 0 on the iic port and the others on the parallel lines */
+        a_setup_displays(ctx, line, modules);
+
+        /* init */
+        res = tm1637_multi_init(ctx, modules);
+        if (res != 0)
+        {
+            return 1;
+        }
+
+        /* write */
+        for (m = 0; m < modules; m++)
+        {
+            res = tm1637_multi_write(m, addr, &gs_number[(num + m) % 10], 1);
+            if (res != 0)
+            {
+                (void)tm1637_multi_deinit();
+
+                return 1;
+            }
+        }
+        (void)tm1637_multi_deinit();
+
+        /* output */
+        tm1637_interface_debug_print("tm1637: write %d displays address %d from number %d.\n", modules, addr, num);
+
+        return 0;
+    }
+    else if (strcmp("e_fb", type) == 0)
+    {
+        tm1637_fb_t *fb;
+        uint8_t res;
+
+        /* attach the framebuffer of tm1637d */
+        if (shm_attach("/tm1637", sizeof(tm1637_fb_t), (void **)&fb) != 0)
+        {
+            tm1637_interface_debug_print("tm1637: tm1637d is not running.\n");
+
+            return 1;
+        }
+        res = tm1637_fb_check(fb);
+        if (res != 0)
+        {
+            (void)shm_detach(fb, sizeof(tm1637_fb_t));
+
+            return 1;
+        }
+
+        /* write, tm1637d flushes it */
+        res = tm1637_fb_write_segment(fb, display, addr, &gs_number[num], 1);
+        (void)shm_detach(fb, sizeof(tm1637_fb_t));
+        if (res != 0)
+        {
+            return 1;
+        }
+
+        /* output */
+        tm1637_interface_debug_print("tm1637: fb display %d address %d number %d.\n", display, addr, num);
+
+        return 0;
+    }
+    else if (strcmp("e_link", type) == 0)
+    {
+        tm1637_link_client_t client;
+        int fd;
+        uint8_t res;
+
+        /* the stm32 board runs the link server on its shell uart */
+        if (serial_open(device, 115200, &fd) != 0)
+        {
+            tm1637_interface_debug_print("tm1637: open %s failed.\n", device);
+
+            return 1;
+        }
+        (void)tm1637_link_client_init(&client, serial_write, serial_read, &fd, 256);
+
+        /* write and wait for the response */
+        res = tm1637_link_client_write_segment(&client, display, addr, &gs_number[num], 1);
+        if (res == 0)
+        {
+            res = tm1637_link_client_sync(&client);
+        }
+        (void)serial_close(fd);
+        if (res != 0)
+        {
+            tm1637_interface_debug_print("tm1637: link write failed.\n");
+
+            return 1;
+        }
+
+        /* output */
+        tm1637_interface_debug_print("tm1637: link display %d address %d number %d.\n", display, addr, num);
+
+        return 0;
+    }
+    else if (strcmp("e_remote", type) == 0)
+    {
+        const tm1637_ops_t ops =
+        {
+            tm1637_remote_iic_init,
+            tm1637_remote_iic_deinit,
+            tm1637_remote_iic_write_cmd_custom,
+            tm1637_remote_iic_read_cmd_custom,
+            tm1637_interface_delay_ms_ctx,
+            tm1637_interface_timestamp_us_ctx,
+            NULL,
+            NULL,
+        };
+        tm1637_link_client_t client;
+        tm1637_remote_t remote;
+        tm1637_handle_t handle;
+        int fd;
+        uint8_t res;
+
+        /* the stm32 board bridges its displays on the shell uart */
+        if (serial_open(device, 115200, &fd) != 0)
+        {
+            tm1637_interface_debug_print("tm1637: open %s failed.\n", device);
+
+            return 1;
+        }
+        (void)tm1637_link_client_init(&client, serial_write, serial_read, &fd, 256);
+        (void)tm1637_remote_init(&remote, &client, display);
+
+        /* the usual driver calls, the writes are pipelined */
+        DRIVER_TM1637_LINK_INIT(&handle, tm1637_handle_t);
+        DRIVER_TM1637_LINK_OPS(&handle, &ops);
+        DRIVER_TM1637_LINK_CTX(&handle, &remote);
+        DRIVER_TM1637_LINK_DEBUG_PRINT(&handle, tm1637_interface_debug_print);
+        res = tm1637_init(&handle);
+        if (res == 0)
+        {
+            res = tm1637_set_address_mode(&handle, TM1637_ADDRESS_MODE_INC);
+        }
+        if (res == 0)
+        {
+            res = tm1637_set_display(&handle, TM1637_BOOL_TRUE);
+        }
+        if (res == 0)
+        {
+            res = tm1637_write_segment(&handle, addr, &gs_number[num], 1);
+        }
+        if (res == 0)
+        {
+            res = tm1637_remote_sync(&remote);
+        }
+        (void)serial_close(fd);
+        if (res != 0)
+        {
+            tm1637_interface_debug_print("tm1637: remote write failed.\n");
+
+            return 1;
+        }
+
+        /* output */
+        tm1637_interface_debug_print("tm1637: remote display %d address %d number %d.\n", display, addr, num);
+
+        return 0;
+    }
+    else if (strcmp("e_decode", type) == 0)
+    {
+        capture_check_t check;
+        timing_limit_t limit;
+        decode_t decode;
+        capture_t capture;
+        uint8_t res;
+
+        /* map the capture */
+        if (file[0] == '\0')
+        {
+            return 5;
+        }
+        if (capture_open(&capture, file, rate) != 0)
+        {
+            tm1637_interface_debug_print("tm1637: open %s failed.\n", file);
+
+            return 1;
+        }
+
+        /* one record per transaction */
+        memset(&check, 0, sizeof(capture_check_t));
+        check.print = 2;
+        timing_limit_default(&limit);
+        decode_init(&decode, &limit, a_capture_record, &check);
+        res = capture_run(&capture, a_capture_edge, &decode);
+        decode_finish(&decode, capture.end_ns);
+        capture_close(&capture);
+        if (res == 4)
+        {
+            tm1637_interface_debug_print("tm1637: sample rate is unknown.\n");
+
+            return 1;
+        }
+        else if (res != 0)
+        {
+            tm1637_interface_debug_print("tm1637: line %llu is invalid.\n", (unsigned long long)capture.line);
+
+            return 1;
+        }
+        else
+        {
+            tm1637_interface_debug_print("tm1637: %llu samples %llu records %llu flagged.\n",
+                                         (unsigned long long)capture.samples,
+                                         (unsigned long long)check.records,
+                                         (unsigned long long)check.flagged);
+            (void)a_timing_print(&decode.timing);
+        }
+
+        return 0;
+    }
+    else if (strcmp("h", type) == 0)
+    {
+        help:
+        tm1637_interface_debug_print("Usage:\n");
+        tm1637_interface_debug_print("  tm1637 (-i | --information)\n");
+        tm1637_interface_debug_print("  tm1637 (-h | --help)\n");
+        tm1637_interface_debug_print("  tm1637 (-p | --port)\n");
+        tm1637_interface_debug_print("  tm1637 (-t write | --test=write) [--clock=<virtual | real>]\n");
+        tm1637_interface_debug_print("  tm1637 (-t read | --test=read) [--times=<num>] [--clock=<virtual | real>]\n");
+        tm1637_interface_debug_print("  tm1637 (-t scheduler | --test=scheduler) [--clock=<virtual | real>]\n");
+        tm1637_interface_debug_print("  tm1637 (-t mailbox | --test=mailbox) [--times=<num>]\n");
+        tm1637_interface_debug_print("  tm1637 (-t queue | --test=queue) [--times=<num>]\n");
+        tm1637_interface_debug_print("  tm1637 (-t vdisplay | --test=vdisplay)\n");
+        tm1637_interface_debug_print("  tm1637 (-t parallel | --test=parallel) [--modules=<num>] [--times=<num>]\n");
+        tm1637_interface_debug_print("  tm1637 (-t group | --test=group)\n");
+        tm1637_interface_debug_print("  tm1637 (-t fleet | --test=fleet) [--times=<num>]\n");
+        tm1637_interface_debug_print("  tm1637 (-t diff | --test=diff) [--times=<num>]\n");
+        tm1637_interface_debug_print("  tm1637 (-t multi | --test=multi) [--modules=<num>] [--times=<num>]\n");
+        tm1637_interface_debug_print("  tm1637 (-t pool | --test=pool) [--threads=<num>] [--times=<num>]\n");
+        tm1637_interface_debug_print("  tm1637 (-t fb | --test=fb) [--modules=<num>] [--times=<num>]\n");
+        tm1637_interface_debug_print("  tm1637 (-t link | --test=link) [--modules=<num>] [--times=<num>]\n");
+        tm1637_interface_debug_print("  tm1637 (-t remote | --test=remote) [--modules=<num>] [--times=<num>]\n");
+        tm1637_interface_debug_print("  tm1637 (-t ring | --test=ring) [--times=<num>]\n");
+        tm1637_interface_debug_print("  tm1637 (-t stress | --test=stress) [--modules=<num>] [--threads=<num>] [--times=<num>]\n");
+        tm1637_interface_debug_print("  tm1637 (-t trace | --test=trace) [--modules=<num>] [--times=<num>] [--clock=<virtual | real>]\n");
+        tm1637_interface_debug_print("         [--file=<path>]\n");
+        tm1637_interface_debug_print("  tm1637 (-t vcd | --test=vcd) [--file=<path>] [--timing=<phase_ns>,<bit_ns>]\n");
+        tm1637_interface_debug_print("  tm1637 (-t capture | --test=capture) [--times=<num>] [--file=<path>]\n");
+        tm1637_interface_debug_print("  tm1637 (-e init | --example=init)\n");
+        tm1637_interface_debug_print("  tm1637 (-e deinit | --example=deinit)\n");
+        tm1637_interface_debug_print("  tm1637 (-e on | --example=on)\n");
+        tm1637_interface_debug_print("  tm1637 (-e off | --example=off)\n");
+        tm1637_interface_debug_print("  tm1637 (-e write | --example=write) [--addr=<address>]\n");
+        tm1637_interface_debug_print("         [--num=<0 | 1 | 2 | 3 | 4 | 5 | 6 | 7 | 8 | 9>]\n");
+        tm1637_interface_debug_print("  tm1637 (-e read | --example=read)\n");
+        tm1637_interface_debug_print("  tm1637 (-e multi | --example=multi) [--modules=<num>] [--addr=<address>]\n");
+        tm1637_interface_debug_print("         [--num=<0 | 1 | 2 | 3 | 4 | 5 | 6 | 7 | 8 | 9>]\n");
+        tm1637_interface_debug_print("  tm1637 (-e fb | --example=fb) [--display=<index>] [--addr=<address>]\n");
+        tm1637_interface_debug_print("         [--num=<0 | 1 | 2 | 3 | 4 | 5 | 6 | 7 | 8 | 9>]\n");
+        tm1637_interface_debug_print("  tm1637 (-e link | --example=link) [--device=<path>] [--display=<index>] [--addr=<address>]\n");
+        tm1637_interface_debug_print("         [--num=<0 | 1 | 2 | 3 | 4 | 5 | 6 | 7 | 8 | 9>]\n");
+        tm1637_interface_debug_print("  tm1637 (-e remote | --example=remote) [--device=<path>] [--display=<index>] [--addr=<address>]\n");
+        tm1637_interface_debug_print("         [--num=<0 | 1 | 2 | 3 | 4 | 5 | 6 | 7 | 8 | 9>]\n");
+        tm1637_interface_debug_print("  tm1637 (-e decode | --example=decode) --file=<path> [--rate=<hz>]\n");
+        tm1637_interface_debug_print("\n");
+        tm1637_interface_debug_print("Options:\n");
+        tm1637_interface_debug_print("      --addr=<address>                   Set the start address and the range is 0-7.([default: 0])\n");
+        tm1637_interface_debug_print("  -e <init | deinit | write | read | on | off | multi | fb | link | remote | decode>, --example=<init | deinit | write | read | on | off | multi | fb | link | remote | decode>\n");
+        tm1637_interface_debug_print("                                         Run the driver example.\n");
+        tm1637_interface_debug_print("      --clock=<virtual | real>           Set the delay clock of the write, read and scheduler test or the trace bus time.([default: virtual])\n");
+        tm1637_interface_debug_print("      --device=<path>                    Set the serial device of the stm32 board.([default: /dev/ttyACM0])\n");
+        tm1637_interface_debug_print("      --display=<index>                  Set the tm1637d, link or remote display index.([default: 0])\n");
+        tm1637_interface_debug_print("      --file=<path>                      Set the chrome trace file of the trace test, the waveform file of the vcd test, the capture file prefix of the capture test or the capture of decode.([default: tm1637_trace.json, tm1637.vcd or tm1637_capture])\n");
+        tm1637_interface_debug_print("  -h, --help                             Show the help.\n");
+        tm1637_interface_debug_print("  -i, --information                      Show the chip information.\n");
+        tm1637_interface_debug_print("  -p, --port                             Display the pin connections of the current board.\n");
+        tm1637_interface_debug_print("      --rate=<hz>                        Set the sample rate of a binary capture or a csv capture without a time column.\n");
+        tm1637_interface_debug_print("      --modules=<num>                    Set the parallel module or display number and the range is 1-16.([default: 16])\n");
+        tm1637_interface_debug_print("      --num=<0 | 1 | 2 | 3 | 4 | 5 | 6 | 7 | 8 | 9>([default: 0])\n");
+        tm1637_interface_debug_print("                                         Set display number.\n");
+        tm1637_interface_debug_print("  -t <read | write | scheduler | mailbox | queue | vdisplay | parallel | group | fleet | diff | multi | pool | fb | link | remote | ring | stress | trace | vcd | capture>, --test=<read | write | scheduler | mailbox | queue | vdisplay | parallel | group | fleet | diff | multi | pool | fb | link | remote | ring | stress | trace | vcd | capture>.\n");
+        tm1637_interface_debug_print("                                         Run the driver test.\n");
+        tm1637_interface_debug_print("      --threads=<num>                    Set the max pool or stress thread number and the range is 1-16.([default: core number])\n");
+        tm1637_interface_debug_print("      --times=<num>                      Set the running times.([default: 3])\n");
+        tm1637_interface_debug_print("      --timing=<phase_ns>,<bit_ns>       Set the iic start, stop and ack phase and the data bit phase of the vcd test.([default: 15000,10000])\n");
+
+        return 0;
+    }
+    else if (strcmp("i", type) == 0)
+    {
+        tm1637_info_t info;
+
+        /* print tm1637 info */
+        tm1637_info(&info);
+        tm1637_interface_debug_print("tm1637: chip is %s.\n", info.chip_name);
+        tm1637_interface_debug_print("tm1637: manufacturer is %s.\n", info.manufacturer_name);
+        tm1637_interface_debug_print("tm1637: interface is %s.\n", info.interface);
+        tm1637_interface_debug_print("tm1637: driver version is %d.%d.\n", info.driver_version / 1000, (info.driver_version % 1000) / 100);
+        tm1637_interface_debug_print("tm1637: min supply voltage is %0.1fV.\n", info.supply_voltage_min_v);
+        tm1637_interface_debug_print("tm1637: max supply voltage is %0.1fV.\n", info.supply_voltage_max_v);
+        tm1637_interface_debug_print("tm1637: max current is %0.2fmA.\n", info.max_current_ma);
+        tm1637_interface_debug_print("tm1637: max temperature is %0.1fC.\n", info.temperature_max);
+        tm1637_interface_debug_print("tm1637: min temperature is %0.1fC.\n", info.temperature_min);
+
+        return 0;
+    }
+    else if (strcmp("p", type) == 0)
+    {
+        /* print pin connection */
+        tm1637_interface_debug_print("tm1637: IIC interface SCL and SDA connected to the simulated iic port.\n");
+        tm1637_interface_debug_print("tm1637: PARALLEL interface CLK and DIO0-DIO15 connected to the simulated parallel port.\n");
+
+        return 0;
+    }
+    else
+    {
+        return 5;
+    }
+}
+
+/**
+ * @brief     main function
+ * @param[in] argc is arg numbers
+ * @param[in] **argv is the arg address
+ * @return    status code
+ *             - 0 success
+ * @note      none
+ */
+int main(int argc, char **argv)
+{
+    uint8_t res;
+
+    res = tm1637((uint8_t)argc, argv);
+    if (res == 0)
+    {
+        /* run success */
+    }
+    else if (res == 1)
+    {
+        tm1637_interface_debug_print("tm1637: run failed.\n");
+    }
+    else if (res == 5)
+    {
+        tm1637_interface_debug_print("tm1637: param is invalid.\n");
+    }
+    else
+    {
+        tm1637_interface_debug_print("tm1637: unknown status code.\n");
+    }
+
+    return res;
+}
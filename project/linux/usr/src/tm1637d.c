@@ -0,0 +1,308 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      tm1637d.c
+ * @brief     tm1637 display daemon source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "fb.h"
+#include "driver_tm1637_interface.h"
+#include "shm.h"
+#include <getopt.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief shared interface ops
+ */
+static const tm1637_ops_t gc_ops =
+{
+    tm1637_interface_iic_init_ctx,
+    tm1637_interface_iic_deinit_ctx,
+    tm1637_interface_iic_write_cmd_custom_ctx,
+    tm1637_interface_iic_read_cmd_custom_ctx,
+    tm1637_interface_delay_ms_ctx,
+    tm1637_interface_timestamp_us_ctx,
+    tm1637_interface_lock_ctx,
+    tm1637_interface_unlock_ctx,
+};
+
+static tm1637_handle_t gs_handle[TM1637_FB_MAX_DISPLAY];              /**< tm1637 handles */
+static tm1637_handle_t *gs_handle_list[TM1637_FB_MAX_DISPLAY];        /**< tm1637 handle list */
+static tm1637_fb_daemon_t gs_daemon;                                  /**< tm1637 fb daemon */
+static volatile sig_atomic_t gs_stop = 0;                             /**< stop flag */
+
+/**
+ * @brief     signal handler
+ * @param[in] sig is the signal
+ * @note      none
+ */
+static void a_tm1637d_signal(int sig)
+{
+    (void)sig;
+    gs_stop = 1;
+}
+
+/**
+ * @brief     close the opened displays
+ * @param[in] num is the opened display number
+ * @note      none
+ */
+static void a_tm1637d_close(uint8_t num)
+{
+    while (num != 0)
+    {
+        num--;
+        (void)tm1637_deinit(&gs_handle[num]);
+    }
+}
+
+/**
+ * @brief     open the displays
+ * @param[in] num is the display number
+ * @return    status code
+ *            - 0 success
+ *            - 1 open failed
+ * @note      display 0 is on the iic port and display i is on the parallel line i - 1
+ */
+static uint8_t a_tm1637d_open(uint8_t num)
+{
+    static uint8_t line[TM1637_FB_MAX_DISPLAY];
+    uint8_t i;
+    
+    for (i = 0; i < num; i++)
+    {
+        /* link the shared ops and the bus context */
+        line[i] = (uint8_t)(i - 1);
+        DRIVER_TM1637_LINK_INIT(&gs_handle[i], tm1637_handle_t);
+        DRIVER_TM1637_LINK_OPS(&gs_handle[i], &gc_ops);
+        DRIVER_TM1637_LINK_CTX(&gs_handle[i], (i == 0) ? NULL : &line[i]);
+        DRIVER_TM1637_LINK_DEBUG_PRINT(&gs_handle[i], tm1637_interface_debug_print);
+        
+        /* init the chip once for every client */
+        if ((tm1637_init(&gs_handle[i]) != 0) ||
+            (tm1637_set_address_mode(&gs_handle[i], TM1637_ADDRESS_MODE_INC) != 0) ||
+            (tm1637_set_test_mode(&gs_handle[i], TM1637_BOOL_FALSE) != 0))
+        {
+            tm1637_interface_debug_print("tm1637d: display %d init failed.\n", i);
+            a_tm1637d_close((gs_handle[i].inited == 1) ? (uint8_t)(i + 1) : i);
+            
+            return 1;
+        }
+        gs_handle_list[i] = &gs_handle[i];
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     main function
+ * @param[in] argc is arg numbers
+ * @param[in] **argv is the arg address
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ *            - 5 param is invalid
+ * @note      tm1637d owns every handle and flushes the shared framebuffer until SIGINT or SIGTERM
+ */
+int main(int argc, char **argv)
+{
+    int c;
+    int longindex = 0;
+    char short_options[] = "hv";
+    struct option long_options[] =
+    {
+        {"help", no_argument, NULL, 'h'},
+        {"verbose", no_argument, NULL, 'v'},
+        {"name", required_argument, NULL, 1},
+        {"displays", required_argument, NULL, 2},
+        {"period", required_argument, NULL, 3},
+        {"times", required_argument, NULL, 4},
+        {NULL, 0, NULL, 0},
+    };
+    char name[33] = "/tm1637";
+    uint8_t displays = 1;
+    uint32_t period = 10;
+    uint32_t times = 0;
+    uint32_t t;
+    uint8_t verbose = 0;
+    uint8_t flushed;
+    uint32_t total;
+    uint32_t digits;
+    uint32_t busy;
+    tm1637_fb_t *fb;
+    struct sigaction sa;
+    
+    /* parse */
+    do
+    {
+        c = getopt_long(argc, argv, short_options, long_options, &longindex);
+        switch (c)
+        {
+            /* help */
+            case 'h' :
+            {
+                tm1637_interface_debug_print("Usage:\n");
+                tm1637_interface_debug_print("  tm1637d [--name=<shm>] [--displays=<num>] [--period=<ms>] [--times=<num>] [-v | --verbose]\n");
+                tm1637_interface_debug_print("\n");
+                tm1637_interface_debug_print("Options:\n");
+                tm1637_interface_debug_print("      --displays=<num>                   Set the display number and the range is 1-16.([default: 1])\n");
+                tm1637_interface_debug_print("  -h, --help                             Show the help.\n");
+                tm1637_interface_debug_print("      --name=<shm>                       Set the shared framebuffer name.([default: /tm1637])\n");
+                tm1637_interface_debug_print("      --period=<ms>                      Set the poll period.([default: 10])\n");
+                tm1637_interface_debug_print("      --times=<num>                      Set the poll times, 0 runs until SIGINT or SIGTERM.([default: 0])\n");
+                tm1637_interface_debug_print("  -v, --verbose                          Print every flush.\n");
+                
+                return 0;
+            }
+            
+            /* verbose */
+            case 'v' :
+            {
+                verbose = 1;
+                
+                break;
+            }
+            
+            /* shared memory name */
+            case 1 :
+            {
+                memset(name, 0, sizeof(char) * 33);
+                snprintf(name, 32, "%s", optarg);
+                
+                break;
+            }
+            
+            /* display number */
+            case 2 :
+            {
+                displays = (uint8_t)atol(optarg);
+                if ((displays == 0) || (displays > TM1637_FB_MAX_DISPLAY))
+                {
+                    tm1637_interface_debug_print("tm1637d: param is invalid.\n");
+                    
+                    return 5;
+                }
+                
+                break;
+            }
+            
+            /* poll period */
+            case 3 :
+            {
+                period = (uint32_t)atol(optarg);
+                
+                break;
+            }
+            
+            /* poll times */
+            case 4 :
+            {
+                times = (uint32_t)atol(optarg);
+                
+                break;
+            }
+            
+            /* the end */
+            case -1 :
+            {
+                break;
+            }
+            
+            /* others */
+            default :
+            {
+                tm1637_interface_debug_print("tm1637d: param is invalid.\n");
+                
+                return 5;
+            }
+        }
+    } while (c != -1);
+    
+    /* stop on SIGINT and SIGTERM */
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = a_tm1637d_signal;
+    (void)sigaction(SIGINT, &sa, NULL);
+    (void)sigaction(SIGTERM, &sa, NULL);
+    
+    /* own the bus */
+    if (a_tm1637d_open(displays) != 0)
+    {
+        return 1;
+    }
+    
+    /* publish the framebuffer */
+    if (shm_create(name, sizeof(tm1637_fb_t), (void **)&fb) != 0)
+    {
+        tm1637_interface_debug_print("tm1637d: shm create failed.\n");
+        a_tm1637d_close(displays);
+        
+        return 1;
+    }
+    (void)tm1637_fb_format(fb, displays);
+    if (tm1637_fb_daemon_init(&gs_daemon, fb, gs_handle_list) != 0)
+    {
+        tm1637_interface_debug_print("tm1637d: daemon init failed.\n");
+        (void)shm_detach(fb, sizeof(tm1637_fb_t));
+        (void)shm_remove(name);
+        a_tm1637d_close(displays);
+        
+        return 1;
+    }
+    tm1637_interface_debug_print("tm1637d: %d displays on %s.\n", displays, name);
+    
+    /* flush the diffs */
+    for (t = 0; (gs_stop == 0) && ((times == 0) || (t < times)); t++)
+    {
+        if (tm1637_fb_daemon_poll(&gs_daemon, &flushed) != 0)
+        {
+            tm1637_interface_debug_print("tm1637d: flush failed, retry in the next poll.\n");
+        }
+        if ((verbose != 0) && (flushed != 0))
+        {
+            tm1637_interface_debug_print("tm1637d: flushed %d displays.\n", flushed);
+        }
+        tm1637_interface_delay_ms(period);
+    }
+    
+    /* output */
+    (void)tm1637_fb_daemon_get_statistics(&gs_daemon, &total, &digits, &busy);
+    tm1637_interface_debug_print("tm1637d: flushed %d displays, %d digits, %d busy snapshots.\n", total, digits, busy);
+    
+    /* release the bus */
+    (void)shm_detach(fb, sizeof(tm1637_fb_t));
+    (void)shm_remove(name);
+    a_tm1637d_close(displays);
+    
+    return 0;
+}
@@ -71,6 +71,13 @@ void delay_us(uint32_t us);
  */
 void delay_ms(uint32_t ms);
 
+/**
+ * @brief  get the timestamp
+ * @return timestamp in microseconds
+ * @note   it wraps around after about 71 minutes
+ */
+uint32_t delay_timestamp_us(void);
+
 /**
  * @}
  */
@@ -0,0 +1,140 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      gpio.h
+ * @brief     gpio header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2022-11-11
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2022/11/11  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef GPIO_H
+#define GPIO_H
+
+#include "stm32f4xx_hal.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/**
+ * @defgroup gpio gpio function
+ * @brief    gpio function modules
+ * @{
+ */
+
+/**
+ * @brief  gpio parallel port init
+ * @return status code
+ *         - 0 success
+ * @note   CLK is PB10 and DIO0 - DIO15 are PE0 - PE15
+ */
+uint8_t gpio_parallel_init(void);
+
+/**
+ * @brief  gpio parallel port deinit
+ * @return status code
+ *         - 0 success
+ * @note   none
+ */
+uint8_t gpio_parallel_deinit(void);
+
+/**
+ * @brief     gpio parallel clock write
+ * @param[in] level is the clock level
+ * @note      none
+ */
+void gpio_parallel_clk_write(uint8_t level);
+
+/**
+ * @brief     gpio parallel data write
+ * @param[in] mask is the pin mask
+ * @param[in] level is the pin level
+ * @note      all masked pins change in one BSRR write
+ */
+void gpio_parallel_dio_write(uint32_t mask, uint32_t level);
+
+/**
+ * @brief  gpio parallel data read
+ * @return port input level
+ * @note   all pins are read in one IDR read
+ */
+uint32_t gpio_parallel_dio_read(void);
+
+/**
+ * @brief     gpio line write command
+ * @param[in] line is the dio line
+ * @param[in] addr is the command
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      it talks to the chip on one dio line of the parallel port like the iic port does
+ */
+uint8_t gpio_line_write_cmd(uint8_t line, uint8_t addr, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief      gpio line read command
+ * @param[in]  line is the dio line
+ * @param[in]  addr is the command
+ * @param[out] *buf points to a data buffer
+ * @param[in]  len is the data length
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       it talks to the chip on one dio line of the parallel port like the iic port does
+ */
+uint8_t gpio_line_read_cmd(uint8_t line, uint8_t addr, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief  gpio parallel port lock
+ * @return status code
+ *         - 0 success
+ *         - 1 lock timeout
+ * @note   every chip on the port shares the clock, so one transfer at a time,
+ *         it waits for the holder, an interrupt which preempted the holder can only time out
+ */
+uint8_t gpio_parallel_lock(void);
+
+/**
+ * @brief gpio parallel port unlock
+ * @note  none
+ */
+void gpio_parallel_unlock(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -65,6 +65,22 @@ uint8_t iic_init(void);
  */
 uint8_t iic_deinit(void);
 
+/**
+ * @brief  iic bus lock
+ * @return status code
+ *         - 0 success
+ *         - 1 lock timeout
+ * @note   all devices sharing the SCL and SDA pins should hold this lock for a whole transfer sequence,
+ *         it waits for the holder, an interrupt which preempted the holder can only time out
+ */
+uint8_t iic_lock(void);
+
+/**
+ * @brief iic bus unlock
+ * @note  none
+ */
+void iic_unlock(void);
+
 /**
  * @brief     iic bus write command
  * @param[in] addr is the iic device write address
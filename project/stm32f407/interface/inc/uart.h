@@ -55,6 +55,11 @@ extern "C"{
 #define UART_MAX_LEN        256        /**< uart max len */
 #define UART2_MAX_LEN       512        /**< uart2 max len */
 
+/**
+ * @brief uart tx ring length definition
+ */
+#define UART_TX_LEN         4096       /**< uart tx ring len, a power of two which holds the whole help text */
+
 /**
  * @brief     uart init with 8 data bits, 1 stop bit and no parity
  * @param[in] baud is the baud rate
@@ -81,10 +86,31 @@ uint8_t uart_deinit(void);
  * @return    status code
  *            - 0 success
  *            - 1 write failed
- * @note      none
+ * @note      it copies the data to the tx ring and waits only while the ring is full, the dma sends it
+ *            in the background, so link frames and shell output are never lost, only the main loop may call it
  */
 uint8_t uart_write(uint8_t *buf, uint16_t len);
 
+/**
+ * @brief     uart write data or drop it
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      it copies the data to the tx ring and returns at once, a message which does not fit the ring
+ *            is dropped and counted, it is for the debug print only, only the main loop may call it
+ */
+uint8_t uart_write_drop(uint8_t *buf, uint16_t len);
+
+/**
+ * @brief      uart get the tx statistics
+ * @param[out] *written points to a written message counter buffer
+ * @param[out] *dropped points to a dropped message counter buffer
+ * @note       none
+ */
+void uart_get_tx_statistics(uint32_t *written, uint32_t *dropped);
+
 /**
  * @brief      uart read data
  * @param[out] *buf points to a data buffer
@@ -117,9 +143,16 @@ uint16_t uart_print(const char *const fmt, ...);
  */
 UART_HandleTypeDef* uart_get_handle(void);
 
+/**
+ * @brief  uart get the tx dma handle
+ * @return points to a dma handle
+ * @note   none
+ */
+DMA_HandleTypeDef* uart_get_tx_dma_handle(void);
+
 /**
  * @brief uart set tx done
- * @note  none
+ * @note  it runs in the usart1 irq when a dma transfer is finished
  */
 void uart_set_tx_done(void);
 
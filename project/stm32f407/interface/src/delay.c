@@ -107,3 +107,25 @@ void delay_ms(uint32_t ms)
     /* use the hal delay */
     HAL_Delay(ms);
 }
+
+/**
+ * @brief  get the timestamp
+ * @return timestamp in microseconds
+ * @note   it wraps around after about 71 minutes
+ */
+uint32_t delay_timestamp_us(void)
+{
+    uint32_t tick;
+    uint32_t val;
+    uint32_t load;
+    
+    /* read tick and systick value until the tick is stable */
+    do
+    {
+        tick = HAL_GetTick();
+        val = SysTick->VAL;
+    } while (tick != HAL_GetTick());
+    load = SysTick->LOAD;
+    
+    return tick * 1000 + (load - val) / gs_fac_us;
+}
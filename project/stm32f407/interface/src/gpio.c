@@ -0,0 +1,391 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      gpio.c
+ * @brief     gpio source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2022-11-11
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2022/11/11  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "gpio.h"
+#include "delay.h"
+
+/**
+ * @brief gpio port definition
+ */
+#define GPIO_PARALLEL_LINE                16            /**< 16 dio lines */
+#define GPIO_PARALLEL_LOCK_TIMEOUT_US     100000        /**< max lock wait, longer than any api call */
+
+static volatile uint8_t gs_parallel_lock = 0;        /**< parallel port lock flag */
+
+/**
+ * @brief  gpio parallel port init
+ * @return status code
+ *         - 0 success
+ * @note   CLK is PB10 and DIO0 - DIO15 are PE0 - PE15
+ */
+uint8_t gpio_parallel_init(void)
+{
+    GPIO_InitTypeDef GPIO_Initure;
+    
+    /* enable gpio clock */
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_GPIOE_CLK_ENABLE();
+    
+    /* clock gpio init */
+    GPIO_Initure.Pin = GPIO_PIN_10;
+    GPIO_Initure.Mode = GPIO_MODE_OUTPUT_PP;
+    GPIO_Initure.Pull = GPIO_PULLUP;
+    GPIO_Initure.Speed = GPIO_SPEED_FREQ_HIGH;
+    HAL_GPIO_Init(GPIOB, &GPIO_Initure);
+    
+    /* data gpio init, open drain so that the chips can ack */
+    GPIO_Initure.Pin = GPIO_PIN_All;
+    GPIO_Initure.Mode = GPIO_MODE_OUTPUT_OD;
+    GPIO_Initure.Pull = GPIO_PULLUP;
+    GPIO_Initure.Speed = GPIO_SPEED_FREQ_HIGH;
+    HAL_GPIO_Init(GPIOE, &GPIO_Initure);
+    
+    /* release all lines */
+    GPIOE->BSRR = 0x0000FFFFU;
+    GPIOB->BSRR = GPIO_PIN_10;
+    
+    return 0;
+}
+
+/**
+ * @brief  gpio parallel port deinit
+ * @return status code
+ *         - 0 success
+ * @note   none
+ */
+uint8_t gpio_parallel_deinit(void)
+{
+    /* gpio deinit */
+    HAL_GPIO_DeInit(GPIOB, GPIO_PIN_10);
+    HAL_GPIO_DeInit(GPIOE, GPIO_PIN_All);
+    
+    return 0;
+}
+
+/**
+ * @brief     gpio parallel clock write
+ * @param[in] level is the clock level
+ * @note      none
+ */
+void gpio_parallel_clk_write(uint8_t level)
+{
+    if (level != 0)
+    {
+        GPIOB->BSRR = GPIO_PIN_10;
+    }
+    else
+    {
+        GPIOB->BSRR = (uint32_t)GPIO_PIN_10 << 16;
+    }
+}
+
+/**
+ * @brief     gpio parallel data write
+ * @param[in] mask is the pin mask
+ * @param[in] level is the pin level
+ * @note      all masked pins change in one BSRR write
+ */
+void gpio_parallel_dio_write(uint32_t mask, uint32_t level)
+{
+    mask &= 0xFFFFU;
+    
+    /* set the high bits and reset the low bits at once */
+    GPIOE->BSRR = (level & mask) | ((~level & mask) << 16);
+}
+
+/**
+ * @brief  gpio parallel data read
+ * @return port input level
+ * @note   all pins are read in one IDR read
+ */
+uint32_t gpio_parallel_dio_read(void)
+{
+    return GPIOE->IDR & 0xFFFFU;
+}
+
+/**
+ * @brief  gpio parallel port lock
+ * @return status code
+ *         - 0 success
+ *         - 1 lock timeout
+ * @note   every chip on the port shares the clock, so one transfer at a time,
+ *         it waits for the holder, an interrupt which preempted the holder can only time out
+ */
+uint8_t gpio_parallel_lock(void)
+{
+    uint32_t start;
+    
+    start = delay_timestamp_us();
+    while (1)
+    {
+        /* take the lock flag when it is free */
+        if (__LDREXB(&gs_parallel_lock) == 0)
+        {
+            if (__STREXB(1, &gs_parallel_lock) == 0)
+            {
+                __DMB();
+                
+                return 0;
+            }
+        }
+        else
+        {
+            __CLREX();
+        }
+        
+        /* give up when the holder never releases it */
+        if ((delay_timestamp_us() - start) >= GPIO_PARALLEL_LOCK_TIMEOUT_US)
+        {
+            return 1;
+        }
+    }
+}
+
+/**
+ * @brief gpio parallel port unlock
+ * @note  none
+ */
+void gpio_parallel_unlock(void)
+{
+    __DMB();
+    gs_parallel_lock = 0;
+}
+
+/**
+ * @brief     gpio line send start
+ * @param[in] mask is the line mask
+ * @note      the other lines stay released, so their chips never see a start
+ */
+static void a_gpio_line_start(uint32_t mask)
+{
+    gpio_parallel_dio_write(mask, 0xFFFFFFFFU);
+    gpio_parallel_clk_write(1);
+    delay_us(4);
+    gpio_parallel_dio_write(mask, 0);
+    delay_us(4);
+    gpio_parallel_clk_write(0);
+    delay_us(4);
+}
+
+/**
+ * @brief     gpio line send stop
+ * @param[in] mask is the line mask
+ * @note      none
+ */
+static void a_gpio_line_stop(uint32_t mask)
+{
+    gpio_parallel_dio_write(mask, 0);
+    delay_us(4);
+    gpio_parallel_clk_write(1);
+    delay_us(4);
+    gpio_parallel_dio_write(mask, 0xFFFFFFFFU);
+    delay_us(4);
+}
+
+/**
+ * @brief     gpio line wait ack
+ * @param[in] mask is the line mask
+ * @return    status code
+ *            - 0 success
+ *            - 1 no ack
+ * @note      none
+ */
+static uint8_t a_gpio_line_wait_ack(uint32_t mask)
+{
+    uint32_t res;
+    
+    gpio_parallel_dio_write(mask, 0xFFFFFFFFU);
+    delay_us(4);
+    gpio_parallel_clk_write(1);
+    delay_us(4);
+    res = gpio_parallel_dio_read() & mask;
+    gpio_parallel_clk_write(0);
+    delay_us(4);
+    if (res != 0)
+    {
+        a_gpio_line_stop(mask);
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     gpio line send a byte
+ * @param[in] mask is the line mask
+ * @param[in] txd is the sent byte
+ * @note      msb first like the iic port
+ */
+static void a_gpio_line_send_byte(uint32_t mask, uint8_t txd)
+{
+    uint8_t t;
+    
+    gpio_parallel_clk_write(0);
+    for (t = 0; t < 8; t++)
+    {
+        gpio_parallel_dio_write(mask, ((txd & 0x80) != 0) ? 0xFFFFFFFFU : 0);
+        txd <<= 1;
+        delay_us(2);
+        gpio_parallel_clk_write(1);
+        delay_us(2);
+        gpio_parallel_clk_write(0);
+        delay_us(2);
+    }
+}
+
+/**
+ * @brief     gpio line read a byte
+ * @param[in] mask is the line mask
+ * @param[in] ack is the ack flag
+ * @return    read byte
+ * @note      msb first like the iic port
+ */
+static uint8_t a_gpio_line_read_byte(uint32_t mask, uint8_t ack)
+{
+    uint8_t i;
+    uint8_t receive = 0;
+    
+    gpio_parallel_dio_write(mask, 0xFFFFFFFFU);
+    for (i = 0; i < 8; i++)
+    {
+        gpio_parallel_clk_write(0);
+        delay_us(2);
+        gpio_parallel_clk_write(1);
+        receive <<= 1;
+        if ((gpio_parallel_dio_read() & mask) != 0)
+        {
+            receive++;
+        }
+        delay_us(2);
+    }
+    gpio_parallel_clk_write(0);
+    delay_us(4);
+    gpio_parallel_dio_write(mask, (ack != 0) ? 0 : 0xFFFFFFFFU);
+    delay_us(4);
+    gpio_parallel_clk_write(1);
+    delay_us(4);
+    gpio_parallel_clk_write(0);
+    delay_us(4);
+    
+    return receive;
+}
+
+/**
+ * @brief     gpio line write command
+ * @param[in] line is the dio line
+ * @param[in] addr is the command
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      it talks to the chip on one dio line of the parallel port like the iic port does
+ */
+uint8_t gpio_line_write_cmd(uint8_t line, uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    uint32_t mask;
+    uint16_t i;
+    
+    mask = 1U << (line % GPIO_PARALLEL_LINE);
+    
+    /* send a start */
+    a_gpio_line_start(mask);
+    
+    /* send the command */
+    a_gpio_line_send_byte(mask, addr);
+    if (a_gpio_line_wait_ack(mask) != 0)
+    {
+        return 1;
+    }
+    
+    /* write the data */
+    for (i = 0; i < len; i++)
+    {
+        a_gpio_line_send_byte(mask, buf[i]);
+        if (a_gpio_line_wait_ack(mask) != 0)
+        {
+            return 1;
+        }
+    }
+    
+    /* send a stop */
+    a_gpio_line_stop(mask);
+    
+    return 0;
+}
+
+/**
+ * @brief      gpio line read command
+ * @param[in]  line is the dio line
+ * @param[in]  addr is the command
+ * @param[out] *buf points to a data buffer
+ * @param[in]  len is the data length
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       it talks to the chip on one dio line of the parallel port like the iic port does
+ */
+uint8_t gpio_line_read_cmd(uint8_t line, uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    uint32_t mask;
+    
+    mask = 1U << (line % GPIO_PARALLEL_LINE);
+    
+    /* send a start */
+    a_gpio_line_start(mask);
+    
+    /* send the command */
+    a_gpio_line_send_byte(mask, addr);
+    if (a_gpio_line_wait_ack(mask) != 0)
+    {
+        return 1;
+    }
+    
+    /* read the data */
+    while (len != 0)
+    {
+        /* the last byte gets a nack */
+        *buf = a_gpio_line_read_byte(mask, (len == 1) ? 0 : 1);
+        len--;
+        buf++;
+    }
+    
+    /* send a stop */
+    a_gpio_line_stop(mask);
+    
+    return 0;
+}
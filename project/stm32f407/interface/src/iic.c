@@ -57,6 +57,13 @@
 #define IIC_SDA           PBout(9)
 #define READ_SDA          PBin(9)
 
+/**
+ * @brief iic lock definition
+ */
+#define IIC_LOCK_TIMEOUT_US    100000        /**< max lock wait, longer than any api call */
+
+static volatile uint8_t gs_lock = 0;        /**< bus lock flag */
+
 /**
  * @brief  iic bus init
  * @return status code
@@ -100,6 +107,54 @@ uint8_t iic_deinit(void)
     return 0;
 }
 
+/**
+ * @brief  iic bus lock
+ * @return status code
+ *         - 0 success
+ *         - 1 lock timeout
+ * @note   all devices sharing the SCL and SDA pins should hold this lock for a whole transfer sequence,
+ *         it waits for the holder, an interrupt which preempted the holder can only time out
+ */
+uint8_t iic_lock(void)
+{
+    uint32_t start;
+    
+    start = delay_timestamp_us();
+    while (1)
+    {
+        /* take the lock flag when it is free */
+        if (__LDREXB(&gs_lock) == 0)
+        {
+            if (__STREXB(1, &gs_lock) == 0)
+            {
+                __DMB();
+                
+                return 0;
+            }
+        }
+        else
+        {
+            __CLREX();
+        }
+        
+        /* give up when the holder never releases it */
+        if ((delay_timestamp_us() - start) >= IIC_LOCK_TIMEOUT_US)
+        {
+            return 1;
+        }
+    }
+}
+
+/**
+ * @brief iic bus unlock
+ * @note  none
+ */
+void iic_unlock(void)
+{
+    __DMB();
+    gs_lock = 0;
+}
+
 /**
  * @brief iic bus send start
  * @note  none
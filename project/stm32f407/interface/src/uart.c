@@ -35,6 +35,7 @@
  */
 
 #include "uart.h"
+#include "driver_tm1637_ring.h"
 #include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
@@ -43,10 +44,13 @@
  * @brief uart1 var definition
  */
 UART_HandleTypeDef g_uart_handle;              /**< uart handle */
+DMA_HandleTypeDef g_uart_tx_dma_handle;        /**< uart tx dma handle */
 uint8_t g_uart_rx_buffer[UART_MAX_LEN];        /**< uart rx buffer */
 uint8_t g_uart_buffer;                         /**< uart one buffer */
 volatile uint16_t g_uart_point;                /**< uart rx point */
-volatile uint8_t g_uart_tx_done;               /**< uart tx done flag */
+uint8_t g_uart_tx_buffer[UART_TX_LEN];         /**< uart tx ring buffer */
+tm1637_ring_t g_uart_tx_ring;                  /**< uart tx ring */
+volatile uint16_t g_uart_tx_len;               /**< uart tx dma length, 0 means idle */
 
 /**
  * @brief uart2 var definition
@@ -67,6 +71,10 @@ volatile uint8_t g_uart2_tx_done;                /**< uart2 tx done flag */
  */
 uint8_t uart_init(uint32_t baud)
 {
+    /* init the tx ring */
+    (void)tm1637_ring_init(&g_uart_tx_ring, g_uart_tx_buffer, UART_TX_LEN);
+    g_uart_tx_len = 0;
+
     g_uart_handle.Instance = USART1;
     g_uart_handle.Init.BaudRate = baud;
     g_uart_handle.Init.WordLength = UART_WORDLENGTH_8B;
@@ -100,6 +108,15 @@ uint8_t uart_init(uint32_t baud)
  */
 uint8_t uart_deinit(void)
 {
+    uint16_t timeout = 1000;
+
+    /* wait for the queued data */
+    while ((g_uart_tx_len != 0) && (timeout != 0))
+    {
+        HAL_Delay(1);
+        timeout--;
+    }
+
     /* uart deinit */
     if (HAL_UART_DeInit(&g_uart_handle) != HAL_OK)
     {
@@ -109,6 +126,45 @@ uint8_t uart_deinit(void)
     return 0;
 }
 
+/**
+ * @brief uart send the oldest queued part by the dma
+ * @note  call it with the usart1 irq masked or from the tx done callback
+ */
+static void a_uart_tx_start(void)
+{
+    uint8_t *data;
+    uint32_t len;
+
+    /* the contiguous part up to the end of the ring, the tx done callback sends the rest */
+    (void)tm1637_ring_peek(&g_uart_tx_ring, &data, &len);
+    g_uart_tx_len = (uint16_t)len;
+    if (len == 0)
+    {
+        return;
+    }
+
+    /* transmit */
+    if (HAL_UART_Transmit_DMA(&g_uart_handle, data, (uint16_t)len) != HAL_OK)
+    {
+        /* keep the data, the next write retries */
+        g_uart_tx_len = 0;
+    }
+}
+
+/**
+ * @brief uart start the dma if it is idle
+ * @note  a dma error leaves the handle ready without the tx done callback
+ */
+static void a_uart_tx_kick(void)
+{
+    HAL_NVIC_DisableIRQ(USART1_IRQn);
+    if ((g_uart_tx_len == 0) || (g_uart_handle.gState == HAL_UART_STATE_READY))
+    {
+        a_uart_tx_start();
+    }
+    HAL_NVIC_EnableIRQ(USART1_IRQn);
+}
+
 /**
  * @brief     uart write data
  * @param[in] *buf points to a data buffer
@@ -116,39 +172,93 @@ uint8_t uart_deinit(void)
  * @return    status code
  *            - 0 success
  *            - 1 write failed
- * @note      none
+ * @note      it copies the data to the tx ring and waits only while the ring is full, the dma sends it
+ *            in the background, so link frames and shell output are never lost, only the main loop may call it
  */
 uint8_t uart_write(uint8_t *buf, uint16_t len)
 {
+    uint32_t used;
+    uint32_t part;
     uint16_t timeout = 1000;
 
-    /* set tx done 0 */
-    g_uart_tx_done = 0;
-
-    /* transmit */
-    if (HAL_UART_Transmit_IT(&g_uart_handle, (uint8_t *)buf, len) != HAL_OK)
+    while (len != 0)
     {
-        return 1;
+        /* wait for the dma to free some room */
+        (void)tm1637_ring_get_used(&g_uart_tx_ring, &used);
+        if (used >= UART_TX_LEN)
+        {
+            if (timeout == 0)
+            {
+                return 1;
+            }
+            a_uart_tx_kick();
+            HAL_Delay(1);
+            timeout--;
+
+            continue;
+        }
+
+        /* queue the part which fits */
+        part = UART_TX_LEN - used;
+        if (part > len)
+        {
+            part = len;
+        }
+        if (tm1637_ring_write(&g_uart_tx_ring, buf, part) != 0)
+        {
+            return 1;
+        }
+        a_uart_tx_kick();
+        buf += part;
+        len -= (uint16_t)part;
+        timeout = 1000;
     }
 
-    /* wait for events */
-    while ((g_uart_tx_done == 0) && (timeout != 0))
-    {
-        HAL_Delay(1);
-        timeout--;
-    }
+    return 0;
+}
 
-    /* check the timeout */
-    if (timeout != 0)
+/**
+ * @brief     uart write data or drop it
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      it copies the data to the tx ring and returns at once, a message which does not fit the ring
+ *            is dropped and counted, it is for the debug print only, only the main loop may call it
+ */
+uint8_t uart_write_drop(uint8_t *buf, uint16_t len)
+{
+    uint8_t res;
+
+    /* queue the data */
+    res = tm1637_ring_write(&g_uart_tx_ring, buf, len);
+
+    /* start the dma */
+    a_uart_tx_kick();
+
+    /* check the result */
+    if (res != 0)
     {
-        return 0;
+        return 1;
     }
     else
     {
-        return 1;
+        return 0;
     }
 }
 
+/**
+ * @brief      uart get the tx statistics
+ * @param[out] *written points to a written message counter buffer
+ * @param[out] *dropped points to a dropped message counter buffer
+ * @note       none
+ */
+void uart_get_tx_statistics(uint32_t *written, uint32_t *dropped)
+{
+    (void)tm1637_ring_get_statistics(&g_uart_tx_ring, written, dropped);
+}
+
 /**
  * @brief      uart read data
  * @param[out] *buf points to a data buffer
@@ -170,12 +280,14 @@ uint16_t uart_read(uint8_t *buf, uint16_t len)
         goto start;
     }
 
-    /* copy the data */
+    /* copy the data, a byte received between the copy and the clear is kept back by the masked irq */
+    HAL_NVIC_DisableIRQ(USART1_IRQn);
     read_len = (len < g_uart_point) ? len : g_uart_point;
     memcpy(buf, g_uart_rx_buffer, read_len);
 
     /* clear the buffer */
     g_uart_point = 0;
+    HAL_NVIC_EnableIRQ(USART1_IRQn);
 
     return read_len;
 }
@@ -371,6 +483,16 @@ UART_HandleTypeDef* uart_get_handle(void)
     return &g_uart_handle;
 }
 
+/**
+ * @brief  uart get the tx dma handle
+ * @return points to a dma handle
+ * @note   none
+ */
+DMA_HandleTypeDef* uart_get_tx_dma_handle(void)
+{
+    return &g_uart_tx_dma_handle;
+}
+
 /**
  * @brief  uart2 get the handle
  * @return points to a uart handle
@@ -383,11 +505,13 @@ UART_HandleTypeDef* uart2_get_handle(void)
 
 /**
  * @brief uart set tx done
- * @note  none
+ * @note  it runs in the usart1 irq when a dma transfer is finished
  */
 void uart_set_tx_done(void)
 {
-    g_uart_tx_done = 1;
+    /* release the sent bytes and send the next part */
+    (void)tm1637_ring_consume(&g_uart_tx_ring, g_uart_tx_len);
+    a_uart_tx_start();
 }
 
 /**
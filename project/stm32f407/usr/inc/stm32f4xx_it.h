@@ -108,6 +108,12 @@ void SysTick_Handler(void);
  */
 void USART1_IRQHandler(void);
 
+/**
+ * @brief dma2 stream7 irq handler
+ * @note  none
+ */
+void DMA2_Stream7_IRQHandler(void);
+
 /**
  * @brief usart2 irq handler
  * @note  none
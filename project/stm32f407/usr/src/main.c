@@ -36,7 +36,12 @@
 
 #include "driver_tm1637_write_test.h"
 #include "driver_tm1637_read_test.h"
+#include "driver_tm1637_parallel_test.h"
+#include "driver_tm1637_diff_test.h"
+#include "driver_tm1637_multi_test.h"
 #include "driver_tm1637_basic.h"
+#include "driver_tm1637_multi.h"
+#include "driver_tm1637_link.h"
 #include "shell.h"
 #include "clock.h"
 #include "delay.h"
@@ -50,6 +55,28 @@
 uint8_t g_buf[256];             /**< uart buffer */
 volatile uint16_t g_len;        /**< uart buffer length */
 
+/**
+ * @brief link var definition
+ */
+#define LINK_DISPLAY_NUM        16                          /**< display 0 on the iic port and 1 - 15 on the parallel lines */
+static const tm1637_ops_t gc_link_ops =
+{
+    tm1637_interface_iic_init_ctx,
+    tm1637_interface_iic_deinit_ctx,
+    tm1637_interface_iic_write_cmd_custom_ctx,
+    tm1637_interface_iic_read_cmd_custom_ctx,
+    tm1637_interface_delay_ms_ctx,
+    tm1637_interface_timestamp_us_ctx,
+    tm1637_interface_lock_ctx,
+    tm1637_interface_unlock_ctx,
+};                                                          /**< shared interface ops */
+static tm1637_handle_t gs_link_handle[LINK_DISPLAY_NUM];    /**< link handles */
+static tm1637_handle_t *gs_link_list[LINK_DISPLAY_NUM];     /**< link handle list */
+static uint8_t gs_link_line[LINK_DISPLAY_NUM];              /**< link parallel lines */
+static tm1637_link_server_t gs_link;                        /**< link server */
+static uint8_t gs_link_inited;                              /**< link inited flag, 0 is not opened, 1 is ready and 2 is failed */
+static uint8_t gs_link_active;                              /**< link traffic flag */
+
 /**
  * @brief     tm1637 full function
  * @param[in] argc is arg numbers
@@ -75,12 +102,17 @@ uint8_t tm1637(uint8_t argc, char **argv)
         {"addr", required_argument, NULL, 1},
         {"num", required_argument, NULL, 2},
         {"times", required_argument, NULL, 3},
+        {"modules", required_argument, NULL, 4},
         {NULL, 0, NULL, 0},
     };
     char type[33] = "unknown";
     uint8_t addr = 0;
     uint8_t num = 0;
     uint32_t times = 3;
+    uint8_t modules = 16;
+    uint8_t m;
+    uint8_t line[16];
+    void *ctx[16];
     uint8_t number[] = {TM1637_NUMBER_0, TM1637_NUMBER_1, TM1637_NUMBER_2,
                         TM1637_NUMBER_3, TM1637_NUMBER_4, TM1637_NUMBER_5,
                         TM1637_NUMBER_6, TM1637_NUMBER_7, TM1637_NUMBER_8, TM1637_NUMBER_9};
@@ -189,6 +221,19 @@ uint8_t tm1637(uint8_t argc, char **argv)
                 break;
             }
 
+            /* module number */
+            case 4 :
+            {
+                /* set the module number */
+                modules = atol(optarg);
+                if ((modules == 0) || (modules > 16))
+                {
+                    return 1;
+                }
+
+                break;
+            }
+
             /* the end */
             case -1 :
             {
@@ -224,6 +269,44 @@ uint8_t tm1637(uint8_t argc, char **argv)
 
         return 0;
     }
+    else if (strcmp("t_diff", type) == 0)
+    {
+        /* run the diff test */
+        if (tm1637_diff_test(times) != 0)
+        {
+            return 1;
+        }
+
+        return 0;
+    }
+    else if (strcmp("t_parallel", type) == 0)
+    {
+        /* run the parallel test */
+        if (tm1637_parallel_test(modules, times, NULL) != 0)
+        {
+            return 1;
+        }
+
+        return 0;
+    }
+    else if (strcmp("t_multi", type) == 0)
+    {
+        /* display 0 on the iic port and the others on the parallel lines */
+        ctx[0] = NULL;
+        for (m = 1; m < modules; m++)
+        {
+            line[m - 1] = m - 1;
+            ctx[m] = &line[m - 1];
+        }
+
+        /* run the multi test */
+        if (tm1637_multi_test(ctx, modules, times) != 0)
+        {
+            return 1;
+        }
+
+        return 0;
+    }
     else if (strcmp("e_init", type) == 0)
     {
         uint8_t res;
@@ -323,6 +406,43 @@ uint8_t tm1637(uint8_t argc, char **argv)
 
         return 0;
     }
+    else if (strcmp("e_multi", type) == 0)
+    {
+        uint8_t res;
+
+        /* display 0 on the iic port and the others on the parallel lines */
+        ctx[0] = NULL;
+        for (m = 1; m < modules; m++)
+        {
+            line[m - 1] = m - 1;
+            ctx[m] = &line[m - 1];
+        }
+
+        /* init */
+        res = tm1637_multi_init(ctx, modules);
+        if (res != 0)
+        {
+            return 1;
+        }
+
+        /* write */
+        for (m = 0; m < modules; m++)
+        {
+            res = tm1637_multi_write(m, addr, &number[(num + m) % 10], 1);
+            if (res != 0)
+            {
+                (void)tm1637_multi_deinit();
+
+                return 1;
+            }
+        }
+        (void)tm1637_multi_deinit();
+
+        /* output */
+        tm1637_interface_debug_print("tm1637: write %d displays address %d from number %d.\n", modules, addr, num);
+
+        return 0;
+    }
     else if (strcmp("h", type) == 0)
     {
         help:
@@ -332,6 +452,9 @@ uint8_t tm1637(uint8_t argc, char **argv)
         tm1637_interface_debug_print("  tm1637 (-p | --port)\n");
         tm1637_interface_debug_print("  tm1637 (-t write | --test=write)\n");
         tm1637_interface_debug_print("  tm1637 (-t read | --test=read) [--times=<num>]\n");
+        tm1637_interface_debug_print("  tm1637 (-t parallel | --test=parallel) [--modules=<num>] [--times=<num>]\n");
+        tm1637_interface_debug_print("  tm1637 (-t diff | --test=diff) [--times=<num>]\n");
+        tm1637_interface_debug_print("  tm1637 (-t multi | --test=multi) [--modules=<num>] [--times=<num>]\n");
         tm1637_interface_debug_print("  tm1637 (-e init | --example=init)\n");
         tm1637_interface_debug_print("  tm1637 (-e deinit | --example=deinit)\n");
         tm1637_interface_debug_print("  tm1637 (-e on | --example=on)\n");
@@ -339,17 +462,20 @@ uint8_t tm1637(uint8_t argc, char **argv)
         tm1637_interface_debug_print("  tm1637 (-e write | --example=write) [--addr=<address>]\n");
         tm1637_interface_debug_print("         [--num=<0 | 1 | 2 | 3 | 4 | 5 | 6 | 7 | 8 | 9>]\n");
         tm1637_interface_debug_print("  tm1637 (-e read | --example=read)\n");
+        tm1637_interface_debug_print("  tm1637 (-e multi | --example=multi) [--modules=<num>] [--addr=<address>]\n");
+        tm1637_interface_debug_print("         [--num=<0 | 1 | 2 | 3 | 4 | 5 | 6 | 7 | 8 | 9>]\n");
         tm1637_interface_debug_print("\n");
         tm1637_interface_debug_print("Options:\n");
         tm1637_interface_debug_print("      --addr=<address>                   Set the start address and the range is 0-7.([default: 0])\n");
-        tm1637_interface_debug_print("  -e <init | deinit | write | read | on | off>, --example=<init | deinit | write | read | on | off>\n");
+        tm1637_interface_debug_print("  -e <init | deinit | write | read | on | off | multi>, --example=<init | deinit | write | read | on | off | multi>\n");
         tm1637_interface_debug_print("                                         Run the driver example.\n");
         tm1637_interface_debug_print("  -h, --help                             Show the help.\n");
         tm1637_interface_debug_print("  -i, --information                      Show the chip information.\n");
         tm1637_interface_debug_print("  -p, --port                             Display the pin connections of the current board.\n");
+        tm1637_interface_debug_print("      --modules=<num>                    Set the parallel module or display number and the range is 1-16.([default: 16])\n");
         tm1637_interface_debug_print("      --num=<0 | 1 | 2 | 3 | 4 | 5 | 6 | 7 | 8 | 9>([default: 0])\n");
         tm1637_interface_debug_print("                                         Set display number.\n");
-        tm1637_interface_debug_print("  -t <read | write>, --test=<read | write>.\n");
+        tm1637_interface_debug_print("  -t <read | write | parallel | diff | multi>, --test=<read | write | parallel | diff | multi>.\n");
         tm1637_interface_debug_print("                                         Run the driver test.\n");
         tm1637_interface_debug_print("      --times=<num>                      Set the running times.([default: 3])\n");
 
@@ -378,6 +504,8 @@ uint8_t tm1637(uint8_t argc, char **argv)
         /* print pin connection */
         tm1637_interface_debug_print("tm1637: IIC interface SCL connected to GPIOB PIN8.\n");
         tm1637_interface_debug_print("tm1637: IIC interface SDA connected to GPIOB PIN9.\n");
+        tm1637_interface_debug_print("tm1637: PARALLEL interface CLK connected to GPIOB PIN10.\n");
+        tm1637_interface_debug_print("tm1637: PARALLEL interface DIO0-DIO15 connected to GPIOE PIN0-PIN15.\n");
 
         return 0;
     }
@@ -387,6 +515,82 @@ uint8_t tm1637(uint8_t argc, char **argv)
     }
 }
 
+/**
+ * @brief     link write the responses
+ * @param[in] *ctx is unused
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+static uint8_t a_link_write(void *ctx, uint8_t *buf, uint16_t len)
+{
+    (void)ctx;
+
+    return uart_write(buf, len);
+}
+
+/**
+ * @brief  link init the displays and the server
+ * @return status code
+ *         - 0 success
+ *         - 1 init failed
+ * @note   it runs once at the first link frame, a display that does not answer is closed
+ *         and the server answers TM1637_LINK_STATUS_FAILED for it
+ */
+static uint8_t a_link_init(void)
+{
+    uint8_t i;
+
+    gs_link_inited = 2;
+    for (i = 0; i < LINK_DISPLAY_NUM; i++)
+    {
+        DRIVER_TM1637_LINK_INIT(&gs_link_handle[i], tm1637_handle_t);
+        DRIVER_TM1637_LINK_OPS(&gs_link_handle[i], &gc_link_ops);
+        if (i == 0)
+        {
+            DRIVER_TM1637_LINK_CTX(&gs_link_handle[i], NULL);
+        }
+        else
+        {
+            gs_link_line[i] = i - 1;
+            DRIVER_TM1637_LINK_CTX(&gs_link_handle[i], &gs_link_line[i]);
+        }
+        DRIVER_TM1637_LINK_DEBUG_PRINT(&gs_link_handle[i], tm1637_interface_debug_print);
+        gs_link_list[i] = &gs_link_handle[i];
+        if (tm1637_init(&gs_link_handle[i]) != 0)
+        {
+            continue;
+        }
+        if (tm1637_set_address_mode(&gs_link_handle[i], TM1637_ADDRESS_MODE_INC) != 0)
+        {
+            /* a missing display never acks the power down, so close its bus by hand */
+            if (tm1637_deinit(&gs_link_handle[i]) != 0)
+            {
+                (void)gc_link_ops.iic_deinit(gs_link_handle[i].ctx);
+                DRIVER_TM1637_LINK_INIT(&gs_link_handle[i], tm1637_handle_t);
+            }
+        }
+    }
+    if (tm1637_link_server_init(&gs_link, gs_link_list, LINK_DISPLAY_NUM, a_link_write, NULL) != 0)
+    {
+        for (i = 0; i < LINK_DISPLAY_NUM; i++)
+        {
+            if ((gs_link_handle[i].inited == 1) && (tm1637_deinit(&gs_link_handle[i]) != 0))
+            {
+                (void)gc_link_ops.iic_deinit(gs_link_handle[i].ctx);
+            }
+        }
+
+        return 1;
+    }
+    gs_link_inited = 1;
+
+    return 0;
+}
+
 /**
  * @brief main function
  * @note  none
@@ -415,6 +619,30 @@ int main(void)
         g_len = uart_read(g_buf, 256);
         if (g_len != 0)
         {
+            uint8_t pending = 0;
+
+            /* binary link frames start with a byte no shell command has */
+            if (gs_link_inited == 1)
+            {
+                (void)tm1637_link_server_get_pending(&gs_link, &pending);
+            }
+            if ((g_buf[0] == TM1637_LINK_SOF) || (pending != 0))
+            {
+                /* the displays are opened once, never per frame */
+                if (gs_link_inited == 0)
+                {
+                    (void)a_link_init();
+                }
+                if (gs_link_inited == 1)
+                {
+                    (void)tm1637_link_server_input(&gs_link, g_buf, g_len);
+                }
+                gs_link_active = 1;
+
+                continue;
+            }
+            gs_link_active = 0;
+
             /* run shell */
             res = shell_parse((char *)g_buf, g_len);
             if (res == 0)
@@ -447,6 +675,8 @@ int main(void)
             }
             uart_flush();
         }
-        delay_ms(100);
+
+        /* the link host streams, keep the polling fast */
+        delay_ms((gs_link_active != 0) ? 1 : 100);
     }
 }
@@ -35,6 +35,7 @@
  */
 
 #include "stm32f4xx_hal.h"
+#include "uart.h"
 
 /** 
  * @defgroup msp HAL_MSP_Private_Functions
@@ -67,6 +68,7 @@ void HAL_MspDeInit(void)
 void HAL_UART_MspInit(UART_HandleTypeDef *huart)
 {
     GPIO_InitTypeDef GPIO_InitStruct;
+    DMA_HandleTypeDef *hdma;
     
     if (huart->Instance == USART1)
     {
@@ -87,7 +89,27 @@ void HAL_UART_MspInit(UART_HandleTypeDef *huart)
         GPIO_InitStruct.Alternate = GPIO_AF7_USART1;
         HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
         
-        /* enable nvic */
+        /* enable dma2 clock */
+        __HAL_RCC_DMA2_CLK_ENABLE();
+        
+        /* usart1 tx is dma2 stream7 channel4 */
+        hdma = uart_get_tx_dma_handle();
+        hdma->Instance = DMA2_Stream7;
+        hdma->Init.Channel = DMA_CHANNEL_4;
+        hdma->Init.Direction = DMA_MEMORY_TO_PERIPH;
+        hdma->Init.PeriphInc = DMA_PINC_DISABLE;
+        hdma->Init.MemInc = DMA_MINC_ENABLE;
+        hdma->Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+        hdma->Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+        hdma->Init.Mode = DMA_NORMAL;
+        hdma->Init.Priority = DMA_PRIORITY_LOW;
+        hdma->Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+        (void)HAL_DMA_Init(hdma);
+        __HAL_LINKDMA(huart, hdmatx, *hdma);
+        
+        /* enable nvic, the dma irq has the usart1 priority so the two never preempt each other */
+        HAL_NVIC_SetPriority(DMA2_Stream7_IRQn, 1, 0);
+        HAL_NVIC_EnableIRQ(DMA2_Stream7_IRQn);
         HAL_NVIC_SetPriority(USART1_IRQn, 1, 0);
         HAL_NVIC_EnableIRQ(USART1_IRQn);
     }
@@ -131,7 +153,11 @@ void HAL_UART_MspDeInit(UART_HandleTypeDef* huart)
         /* uart gpio deinit */
         HAL_GPIO_DeInit(GPIOA, GPIO_PIN_9 | GPIO_PIN_10);
         
+        /* dma deinit */
+        (void)HAL_DMA_DeInit(huart->hdmatx);
+        
         /* disable nvic */
+        HAL_NVIC_DisableIRQ(DMA2_Stream7_IRQn);
         HAL_NVIC_DisableIRQ(USART1_IRQn);
     }
     if (huart->Instance == USART2)
@@ -155,6 +155,15 @@ void USART1_IRQHandler(void)
     HAL_UART_IRQHandler(uart_get_handle());
 }  
 
+/**
+ * @brief dma2 stream7 irq handler
+ * @note  none
+ */
+void DMA2_Stream7_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(uart_get_tx_dma_handle());
+}
+
 /**
  * @brief usart2 irq handler
  * @note  none
@@ -55,6 +55,19 @@
 #define TM1637_COMMAND_DISPLAY        (2 << 6)        /**< display and control command setting */
 #define TM1637_COMMAND_ADDRESS        (3 << 6)        /**< address command setting */
 
+/**
+ * @brief scheduler default latency target definition
+ */
+#define TM1637_SCHEDULER_DEFAULT_CONFIG_US         1000         /**< configuration commands 1ms */
+#define TM1637_SCHEDULER_DEFAULT_KEY_US            20000        /**< key reads 20ms */
+#define TM1637_SCHEDULER_DEFAULT_DISPLAY_US        50000        /**< display data 50ms */
+
+/**
+ * @brief pacer default definition
+ */
+#define TM1637_PACER_DEFAULT_FPS        50         /**< 50 frames per second */
+#define TM1637_PACER_DEFAULT_SHARE      100        /**< 100% bus time share */
+
 /**
  * @brief     high low shift
  * @param[in] data is the input data
@@ -65,598 +78,2659 @@ static uint8_t a_high_low_shift(uint8_t data)
 {
     uint8_t output;
 
-    output = (data << 4) | (data >> 4);                              /* part 1 */
-    output = ((output << 2) & 0xCC) | ((output >> 2) & 0x33);        /* part 2 */
-    output = ((output << 1) & 0xAA) | ((output >> 1) & 0x55);        /* part 3 */
+    output = (data << 4) | (data >> 4);                              /* part 1 */
+    output = ((output << 2) & 0xCC) | ((output >> 2) & 0x33);        /* part 2 */
+    output = ((output << 1) & 0xAA) | ((output >> 1) & 0x55);        /* part 3 */
+
+    return output;                                                   /* return output */
+}
+
+/**
+ * @brief     link iic init
+ * @param[in] *handle points to a tm1637 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic init failed
+ * @note      none
+ */
+static uint8_t a_tm1637_link_iic_init(tm1637_handle_t *handle)
+{
+    if (handle->ops == NULL)                                         /* function pointers */
+    {
+        return DRIVER_TM1637_LINK_TARGET(handle)->iic_init();        /* iic init */
+    }
+
+    return handle->ops->iic_init(handle->ctx);                       /* iic init */
+}
+
+/**
+ * @brief     link iic deinit
+ * @param[in] *handle points to a tm1637 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic deinit failed
+ * @note      none
+ */
+static uint8_t a_tm1637_link_iic_deinit(tm1637_handle_t *handle)
+{
+    if (handle->ops == NULL)                                           /* function pointers */
+    {
+        return DRIVER_TM1637_LINK_TARGET(handle)->iic_deinit();        /* iic deinit */
+    }
+
+    return handle->ops->iic_deinit(handle->ctx);                       /* iic deinit */
+}
+
+/**
+ * @brief     link iic write command custom
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] addr is the command
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the buffer length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+static uint8_t a_tm1637_link_iic_write(tm1637_handle_t *handle, uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    if (handle->ops == NULL)                                                                   /* function pointers */
+    {
+        return DRIVER_TM1637_LINK_TARGET(handle)->iic_write_cmd_custom(addr, buf, len);        /* write data */
+    }
+
+    return handle->ops->iic_write_cmd_custom(handle->ctx, addr, buf, len);                     /* write data */
+}
+
+/**
+ * @brief      link iic read command custom
+ * @param[in]  *handle points to a tm1637 handle structure
+ * @param[in]  addr is the command
+ * @param[out] *buf points to a data buffer
+ * @param[in]  len is the buffer length
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       none
+ */
+static uint8_t a_tm1637_link_iic_read(tm1637_handle_t *handle, uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    if (handle->ops == NULL)                                                                  /* function pointers */
+    {
+        return DRIVER_TM1637_LINK_TARGET(handle)->iic_read_cmd_custom(addr, buf, len);        /* read data */
+    }
+
+    return handle->ops->iic_read_cmd_custom(handle->ctx, addr, buf, len);                     /* read data */
+}
+
+/**
+ * @brief     link timestamp us
+ * @param[in] *handle points to a tm1637 handle structure
+ * @return    timestamp in microseconds
+ * @note      none
+ */
+static uint32_t a_tm1637_link_timestamp_us(tm1637_handle_t *handle)
+{
+    if (handle->ops == NULL)                                             /* function pointers */
+    {
+        return DRIVER_TM1637_LINK_TARGET(handle)->timestamp_us();        /* get timestamp */
+    }
+
+    return handle->ops->timestamp_us(handle->ctx);                       /* get timestamp */
+}
+
+/**
+ * @brief     check the linked timestamp us
+ * @param[in] *handle points to a tm1637 handle structure
+ * @return    1 when timestamp_us is linked, otherwise 0
+ * @note      none
+ */
+static uint8_t a_tm1637_link_has_timestamp_us(tm1637_handle_t *handle)
+{
+    if (handle->ops == NULL)                                                             /* function pointers */
+    {
+        return (DRIVER_TM1637_LINK_TARGET(handle)->timestamp_us != NULL) ? 1 : 0;        /* check timestamp_us */
+    }
+
+    return (handle->ops->timestamp_us != NULL) ? 1 : 0;                                  /* check timestamp_us */
+}
+
+/**
+ * @brief     get the attached scheduler
+ * @param[in] *handle points to a tm1637 handle structure
+ * @return    pointer to the scheduler, NULL when no scheduler is attached
+ * @note      it is always NULL when TM1637_SCHEDULER_FUNCTION is 0
+ */
+static tm1637_scheduler_t *a_tm1637_get_scheduler(tm1637_handle_t *handle)
+{
+#if (TM1637_SCHEDULER_FUNCTION == 1)
+    return handle->scheduler;        /* get scheduler */
+#else
+    (void)handle;                    /* not used */
+
+    return NULL;                     /* no scheduler */
+#endif
+}
+
+/**
+ * @brief     get the trace state
+ * @param[in] *handle points to a tm1637 handle structure
+ * @return    pointer to the trace state, NULL when the handle is not traced
+ * @note      it is always NULL when TM1637_TRACE_FUNCTION is 0
+ */
+static tm1637_trace_state_t *a_tm1637_get_trace(tm1637_handle_t *handle)
+{
+#if (TM1637_TRACE_FUNCTION == 1)
+    return handle->trace;        /* get trace */
+#else
+    (void)handle;                /* not used */
+
+    return NULL;                 /* no trace */
+#endif
+}
+
+/**
+ * @brief     trace a bus transaction
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] type is the trace type
+ * @param[in] cmd is the command byte
+ * @param[in] len is the payload length
+ * @param[in] res is the transaction result
+ * @param[in] start_us is the start timestamp
+ * @note      none
+ */
+static void a_tm1637_trace_bus(tm1637_handle_t *handle, uint8_t type, uint8_t cmd, uint16_t len, uint8_t res, uint32_t start_us)
+{
+    tm1637_trace_state_t *trace = a_tm1637_get_trace(handle);
+    tm1637_trace_event_t event;
+
+    event.name = trace->name;                                     /* api name */
+    event.start_us = start_us;                                    /* set start */
+    event.end_us = a_tm1637_link_timestamp_us(handle);            /* set end */
+    event.wait_us = 0;                                            /* no wait */
+    event.type = type;                                            /* set type */
+    event.cmd = cmd;                                              /* set command */
+    event.len = (uint8_t)len;                                     /* set length */
+    event.res = res;                                              /* set result */
+    trace->callback(trace->ctx, &event);                          /* run the callback */
+}
+
+/**
+ * @brief     iic write
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] cmd is the set command
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the buffer length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+static uint8_t a_tm1637_write(tm1637_handle_t *handle, uint8_t cmd, uint8_t *buf, uint16_t len)
+{
+    tm1637_trace_state_t *trace = a_tm1637_get_trace(handle);
+    uint8_t inner_buffer[16];
+    uint8_t res;
+    uint16_t i;
+    uint32_t start_us = 0;
+
+    if (len > 16)                                                                              /* check len */
+    {
+        return 1;                                                                              /* return error */
+    }
+    for (i = 0; i < len; i++)                                                                  /* loop all */
+    {
+        inner_buffer[i] = a_high_low_shift(buf[i]);                                            /* shift */
+    }
+    if (trace != NULL)                                                                         /* check trace */
+    {
+        start_us = a_tm1637_link_timestamp_us(handle);                                         /* save start */
+    }
+    res = a_tm1637_link_iic_write(handle, a_high_low_shift(cmd), inner_buffer, len);           /* write data */
+    if (trace != NULL)                                                                         /* check trace */
+    {
+        a_tm1637_trace_bus(handle, TM1637_TRACE_TYPE_WRITE, cmd, len, res, start_us);          /* trace the transaction */
+    }
+    if (res != 0)                                                                              /* check the result */
+    {
+        return 1;                                                                              /* return error */
+    }
+
+    return 0;                                                                                  /* success return 0 */
+}
+
+/**
+ * @brief      iic read
+ * @param[in]  *handle points to a tm1637 handle structure
+ * @param[in]  cmd is the set command
+ * @param[out] *buf points to a data buffer
+ * @param[in]  len is the buffer length
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       none
+ */
+static uint8_t a_tm1637_read(tm1637_handle_t *handle, uint8_t cmd, uint8_t *buf, uint16_t len)
+{
+    tm1637_trace_state_t *trace = a_tm1637_get_trace(handle);
+    uint8_t res;
+    uint16_t i;
+    uint32_t start_us = 0;
+
+    if (trace != NULL)                                                                      /* check trace */
+    {
+        start_us = a_tm1637_link_timestamp_us(handle);                                      /* save start */
+    }
+    res = a_tm1637_link_iic_read(handle, a_high_low_shift(cmd), buf, len);                  /* read data */
+    if (trace != NULL)                                                                      /* check trace */
+    {
+        a_tm1637_trace_bus(handle, TM1637_TRACE_TYPE_READ, cmd, len, res, start_us);        /* trace the transaction */
+    }
+    if (res != 0)                                                                           /* check the result */
+    {
+        return 1;                                                                           /* return error */
+    }
+    for (i = 0; i < len; i++)                                                               /* loop all */
+    {
+        buf[i] = a_high_low_shift(buf[i]);                                                  /* shift */
+    }
+
+    return 0;                                                                               /* success return 0 */
+}
+
+/**
+ * @brief     invalidate the scheduler data command
+ * @param[in] *handle points to a tm1637 handle structure
+ * @note      called whenever the chip may have left the write data mode
+ */
+static void a_tm1637_scheduler_invalidate(tm1637_handle_t *handle)
+{
+    tm1637_scheduler_t *scheduler = a_tm1637_get_scheduler(handle);
+
+    if (scheduler != NULL)                          /* check scheduler */
+    {
+        scheduler->data_cmd_valid = 0;              /* resend data command */
+    }
+}
+
+/**
+ * @brief     sync the scheduler ram copy after a direct write
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] addr is the start address
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @note      the direct write is the latest value, so the queued digits it covers are dropped
+ */
+static void a_tm1637_scheduler_sync(tm1637_handle_t *handle, uint8_t addr, uint8_t *data, uint8_t len)
+{
+    tm1637_scheduler_t *scheduler = a_tm1637_get_scheduler(handle);
+
+    if ((scheduler == NULL) || (len == 0))                                  /* check scheduler */
+    {
+        return;                                                             /* return */
+    }
+    memcpy(&scheduler->ram[addr], data, len);                               /* copy data */
+    scheduler->dirty &= (uint8_t)(~(((1 << len) - 1) << addr));             /* clear dirty */
+    scheduler->data_cmd_valid = 1;                                          /* write mode is set */
+    if (scheduler->dirty == 0)                                              /* nothing queued */
+    {
+        scheduler->pending &= (uint8_t)(~(1 << TM1637_SCHEDULER_CLASS_DISPLAY));    /* clear pending */
+        scheduler->commit = 0;                                              /* clear commit */
+    }
+}
+
+/**
+ * @brief     mark a scheduler class pending
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] cls is the scheduler class
+ * @note      the pending timestamp is kept when the class is already pending
+ */
+static void a_tm1637_scheduler_mark(tm1637_handle_t *handle, uint8_t cls)
+{
+    tm1637_scheduler_t *scheduler = a_tm1637_get_scheduler(handle);
+
+    if ((scheduler->pending & (1 << cls)) == 0)                                       /* not pending */
+    {
+        scheduler->pending_since_us[cls] = a_tm1637_link_timestamp_us(handle);        /* save timestamp */
+        scheduler->pending |= (uint8_t)(1 << cls);                                    /* set pending */
+    }
+}
+
+/**
+ * @brief     keep a queued display conf behind a direct write
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] mask is the display conf bits the direct write changed
+ * @note      the caller holds the lock, the queued conf keeps its other bits,
+ *            so the next config slot never sends an older value of these bits
+ */
+static void a_tm1637_scheduler_follow(tm1637_handle_t *handle, uint8_t mask)
+{
+    tm1637_scheduler_t *scheduler = a_tm1637_get_scheduler(handle);
+
+    if ((scheduler != NULL) && ((scheduler->pending & (1 << TM1637_SCHEDULER_CLASS_CONFIG)) != 0))        /* a conf is queued */
+    {
+        scheduler->display_conf = (uint8_t)((scheduler->display_conf & ~mask) |
+                                            (handle->display_conf & mask));                               /* take the new bits */
+    }
+}
+
+/**
+ * @brief     finish one scheduled transaction
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] cls is the scheduler class
+ * @param[in] done is the class finished flag
+ * @note      a deadline miss is counted when the class finishes later than its latency target
+ */
+static void a_tm1637_scheduler_done(tm1637_handle_t *handle, uint8_t cls, uint8_t done)
+{
+    tm1637_scheduler_t *scheduler = a_tm1637_get_scheduler(handle);
+    uint32_t elapsed;
+
+    scheduler->served[cls]++;                                                                   /* served++ */
+    if (done != 0)                                                                              /* class finished */
+    {
+        scheduler->pending &= (uint8_t)(~(1 << cls));                                           /* clear pending */
+        if (cls == TM1637_SCHEDULER_CLASS_DISPLAY)                                              /* display data */
+        {
+            scheduler->commit = 0;                                                              /* clear commit */
+        }
+        elapsed = a_tm1637_link_timestamp_us(handle) - scheduler->pending_since_us[cls];        /* get latency */
+        if (elapsed > scheduler->latency_target_us[cls])                                        /* check target */
+        {
+            scheduler->deadline_miss[cls]++;                                                    /* miss++ */
+        }
+    }
+}
+
+/**
+ * @brief     lock the pacer
+ * @param[in] *pacer points to a tm1637 pacer structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock failed
+ * @note      a pacer without a lock is used from one context only
+ */
+static uint8_t a_tm1637_pacer_lock(tm1637_pacer_t *pacer)
+{
+    if (pacer->lock != NULL)                 /* check lock */
+    {
+        return pacer->lock();                /* lock */
+    }
+
+    return 0;                                /* success return 0 */
+}
+
+/**
+ * @brief     unlock the pacer
+ * @param[in] *pacer points to a tm1637 pacer structure
+ * @note      none
+ */
+static void a_tm1637_pacer_unlock(tm1637_pacer_t *pacer)
+{
+    if (pacer->unlock != NULL)               /* check unlock */
+    {
+        pacer->unlock();                     /* unlock */
+    }
+}
+
+/**
+ * @brief     check the display data is ready to flush
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] now is the current timestamp
+ * @return    1 if ready, 0 if still coalescing or paced
+ * @note      once a flush fires it stays committed until all dirty digits are sent,
+ *            the pacer is read under its own lock and a failed pacer lock waits like a spent frame
+ */
+static uint8_t a_tm1637_scheduler_ready(tm1637_handle_t *handle, uint32_t now)
+{
+    tm1637_scheduler_t *scheduler = a_tm1637_get_scheduler(handle);
+    tm1637_pacer_t *pacer = scheduler->pacer;
+    uint32_t frame = 0;
+
+    if (scheduler->commit != 0)                                                          /* flush in progress */
+    {
+        return 1;                                                                        /* ready */
+    }
+    if (pacer != NULL)                                                                   /* paced */
+    {
+        if (a_tm1637_pacer_lock(pacer) != 0)                                             /* lock the pacer */
+        {
+            return 0;                                                                    /* wait */
+        }
+        frame = pacer->frame;                                                            /* get the frame */
+        if (scheduler->frame == frame)                                                   /* already flushed in this frame */
+        {
+            a_tm1637_pacer_unlock(pacer);                                                /* unlock the pacer */
+
+            return 0;                                                                    /* wait for the next frame */
+        }
+        if (pacer->bus_us >= pacer->budget_us)                                           /* out of bus time */
+        {
+            if (pacer->limited == 0)                                                     /* first time in this frame */
+            {
+                pacer->limited = 1;                                                      /* flag limited */
+                pacer->over_budget++;                                                    /* over_budget++ */
+            }
+            a_tm1637_pacer_unlock(pacer);                                                /* unlock the pacer */
+
+            return 0;                                                                    /* wait for the next frame */
+        }
+        a_tm1637_pacer_unlock(pacer);                                                    /* unlock the pacer */
+    }
+    if (scheduler->window_us != 0)                                                       /* write combining */
+    {
+        if (((now - scheduler->last_write_us) < scheduler->window_us) &&
+            ((scheduler->max_stale_us == 0) ||
+             ((now - scheduler->pending_since_us[TM1637_SCHEDULER_CLASS_DISPLAY]) <
+              scheduler->max_stale_us)))                                                 /* window open and not stale */
+        {
+            return 0;                                                                    /* still coalescing */
+        }
+    }
+    scheduler->commit = 1;                                                               /* commit */
+    if (pacer != NULL)                                                                   /* paced */
+    {
+        scheduler->frame = frame;                                                        /* flushed in this frame */
+    }
+
+    return 1;                                                                            /* ready */
+}
+
+/**
+ * @brief     pick the scheduler class with the earliest deadline
+ * @param[in] *handle points to a tm1637 handle structure
+ * @return    scheduler class, 0xFF if no class is ready
+ * @note      ties are broken by the class priority, coalescing display data is skipped
+ */
+static uint8_t a_tm1637_scheduler_pick(tm1637_handle_t *handle)
+{
+    tm1637_scheduler_t *scheduler = a_tm1637_get_scheduler(handle);
+    uint32_t now;
+    int32_t slack;
+    int32_t best_slack = 0;
+    uint8_t best = 0xFF;
+    uint8_t i;
+
+    now = a_tm1637_link_timestamp_us(handle);                                       /* get now */
+    for (i = 0; i < 3; i++)                                                         /* loop all classes */
+    {
+        if ((scheduler->pending & (1 << i)) != 0)                                   /* pending */
+        {
+            if ((i == TM1637_SCHEDULER_CLASS_DISPLAY) &&
+                (a_tm1637_scheduler_ready(handle, now) == 0))                       /* still coalescing */
+            {
+                continue;                                                           /* skip */
+            }
+            slack = (int32_t)(scheduler->pending_since_us[i] +
+                              scheduler->latency_target_us[i] - now);               /* time to deadline */
+            if ((best == 0xFF) || (slack < best_slack))                             /* earlier deadline */
+            {
+                best = i;                                                           /* save class */
+                best_slack = slack;                                                 /* save slack */
+            }
+        }
+    }
+
+    return best;                                                                    /* return class */
+}
+
+/**
+ * @brief     run one display data transaction
+ * @param[in] *handle points to a tm1637 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the data command is only sent when the chip may have left the write mode,
+ *            then each contiguous run of dirty digits is one transaction
+ */
+static uint8_t a_tm1637_scheduler_display(tm1637_handle_t *handle)
+{
+    tm1637_scheduler_t *scheduler = a_tm1637_get_scheduler(handle);
+    uint8_t cmd;
+    uint8_t start;
+    uint8_t len;
+
+    if (scheduler->data_cmd_valid == 0)                                                 /* data command lost */
+    {
+        cmd = TM1637_COMMAND_DATA | handle->data_conf;                                  /* set the command */
+        if (a_tm1637_write(handle, cmd, NULL, 0) != 0)                                  /* write the command */
+        {
+            return 1;                                                                   /* return error */
+        }
+        scheduler->data_cmd_valid = 1;                                                  /* flag valid */
+        a_tm1637_scheduler_done(handle, TM1637_SCHEDULER_CLASS_DISPLAY, 0);             /* one transaction */
+
+        return 0;                                                                       /* success return 0 */
+    }
+
+    start = 0;                                                                          /* init 0 */
+    while ((scheduler->dirty & (1 << start)) == 0)                                      /* find the first dirty */
+    {
+        start++;                                                                        /* next */
+    }
+    len = 1;                                                                            /* one digit */
+    if ((handle->data_conf & (1 << 2)) == 0)                                            /* auto increment 1 mode */
+    {
+        while (((start + len) < 6) && ((scheduler->dirty & (1 << (start + len))) != 0)) /* extend the run */
+        {
+            len++;                                                                      /* len++ */
+        }
+    }
+    cmd = TM1637_COMMAND_ADDRESS | start;                                               /* set the command */
+    if (a_tm1637_write(handle, cmd, &scheduler->ram[start], len) != 0)                  /* write the run */
+    {
+        return 1;                                                                       /* return error */
+    }
+    scheduler->dirty &= (uint8_t)(~(((1 << len) - 1) << start));                        /* clear the run */
+    a_tm1637_scheduler_done(handle, TM1637_SCHEDULER_CLASS_DISPLAY,
+                            (scheduler->dirty == 0) ? 1 : 0);                           /* one transaction */
+
+    return 0;                                                                           /* success return 0 */
+}
+
+/**
+ * @brief     run one scheduled transaction
+ * @param[in] *handle points to a tm1637 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ * @note      the caller holds the lock
+ */
+static uint8_t a_tm1637_scheduler_step(tm1637_handle_t *handle)
+{
+    tm1637_scheduler_t *scheduler = a_tm1637_get_scheduler(handle);
+    uint32_t start;
+    uint8_t cls;
+    uint8_t cmd;
+    uint8_t data;
+
+    if (scheduler->pending == 0)                                                 /* no work */
+    {
+        return 0;                                                                /* success return 0 */
+    }
+
+    cls = a_tm1637_scheduler_pick(handle);                                       /* pick the class */
+    start = a_tm1637_link_timestamp_us(handle);                                  /* save start */
+    if (cls == 0xFF)                                                             /* nothing is ready */
+    {
+        return 0;                                                                /* success return 0 */
+    }
+    else if (cls == TM1637_SCHEDULER_CLASS_CONFIG)                               /* configuration commands */
+    {
+        cmd = TM1637_COMMAND_DISPLAY | scheduler->display_conf;                  /* set the command */
+        if (a_tm1637_write(handle, cmd, NULL, 0) != 0)                           /* write the command */
+        {
+            return 1;                                                            /* return error */
+        }
+        handle->display_conf = scheduler->display_conf;                          /* apply display conf */
+        a_tm1637_scheduler_done(handle, cls, 1);                                 /* class finished */
+    }
+    else if (cls == TM1637_SCHEDULER_CLASS_KEY)                                  /* key reads */
+    {
+        cmd = TM1637_COMMAND_DATA | handle->data_conf | (1 << 1);                /* set the command */
+        scheduler->data_cmd_valid = 0;                                           /* chip leaves write mode */
+        if (a_tm1637_read(handle, cmd, &data, 1) != 0)                           /* read the command */
+        {
+            return 1;                                                            /* return error */
+        }
+        scheduler->seg = data & 0x7;                                             /* get seg */
+        scheduler->k = (data >> 3) & 0x03;                                       /* get k */
+        scheduler->key_ready = 1;                                                /* flag ready */
+        a_tm1637_scheduler_done(handle, cls, 1);                                 /* class finished */
+    }
+    else                                                                         /* display data */
+    {
+        if (a_tm1637_scheduler_display(handle) != 0)                             /* run display */
+        {
+            return 1;                                                            /* return error */
+        }
+    }
+    start = a_tm1637_link_timestamp_us(handle) - start;                          /* get the bus time */
+    if (start > scheduler->transaction_us)                                       /* longer transaction */
+    {
+        scheduler->transaction_us = start;                                       /* follow at once */
+    }
+    else                                                                         /* shorter transaction */
+    {
+        scheduler->transaction_us -= (scheduler->transaction_us - start) / 8;    /* decay by 1/8 of the gap */
+    }
+    if (scheduler->pacer != NULL)                                                /* paced */
+    {
+        if (a_tm1637_pacer_lock(scheduler->pacer) != 0)                          /* lock the pacer */
+        {
+            return 1;                                                            /* return error */
+        }
+        scheduler->pacer->bus_us += start;                                       /* account the bus time */
+        a_tm1637_pacer_unlock(scheduler->pacer);                                 /* unlock the pacer */
+    }
+
+    return 0;                                                                    /* success return 0 */
+}
+
+/**
+ * @brief     count the remaining scheduled transactions
+ * @param[in] *handle points to a tm1637 handle structure
+ * @return    remaining transaction number
+ * @note      none
+ */
+static uint8_t a_tm1637_scheduler_remaining(tm1637_handle_t *handle)
+{
+    tm1637_scheduler_t *scheduler = a_tm1637_get_scheduler(handle);
+    uint8_t remaining = 0;
+    uint8_t i;
+
+    if ((scheduler->pending & (1 << TM1637_SCHEDULER_CLASS_CONFIG)) != 0)             /* configuration commands */
+    {
+        remaining++;                                                                  /* one command */
+    }
+    if ((scheduler->pending & (1 << TM1637_SCHEDULER_CLASS_KEY)) != 0)                /* key reads */
+    {
+        remaining++;                                                                  /* one read */
+    }
+    if ((scheduler->pending & (1 << TM1637_SCHEDULER_CLASS_DISPLAY)) != 0)            /* display data */
+    {
+        if (scheduler->data_cmd_valid == 0)                                           /* data command lost */
+        {
+            remaining++;                                                              /* one data command */
+        }
+        for (i = 0; i < 6; i++)                                                       /* loop all digits */
+        {
+            if (((scheduler->dirty & (1 << i)) != 0) &&
+                ((i == 0) || ((handle->data_conf & (1 << 2)) != 0) ||
+                 ((scheduler->dirty & (1 << (i - 1))) == 0)))                         /* a run starts here */
+            {
+                remaining++;                                                          /* one run */
+            }
+        }
+    }
+
+    return remaining;                                                                 /* return remaining */
+}
+
+/**
+ * @brief     merge digits into the scheduler ram copy
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] addr is the start address
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @note      the caller holds the lock, the latest value wins
+ */
+static void a_tm1637_scheduler_merge(tm1637_handle_t *handle, uint8_t addr, uint8_t *data, uint8_t len)
+{
+    tm1637_scheduler_t *scheduler = a_tm1637_get_scheduler(handle);
+
+    memcpy(&scheduler->ram[addr], data, len);                               /* merge into the ram copy */
+    scheduler->dirty |= (uint8_t)(((1 << len) - 1) << addr);                /* set dirty */
+    a_tm1637_scheduler_mark(handle, TM1637_SCHEDULER_CLASS_DISPLAY);        /* mark pending */
+    scheduler->last_write_us = a_tm1637_link_timestamp_us(handle);          /* restart the window */
+}
+
+/**
+ * @brief     flush all dirty digits
+ * @param[in] *handle points to a tm1637 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 flush failed
+ * @note      the caller holds the lock, other due classes may be served on the way
+ */
+static uint8_t a_tm1637_scheduler_flush(tm1637_handle_t *handle)
+{
+    tm1637_scheduler_t *scheduler = a_tm1637_get_scheduler(handle);
+
+    while ((scheduler->pending & (1 << TM1637_SCHEDULER_CLASS_DISPLAY)) != 0)        /* until sent */
+    {
+        scheduler->commit = 1;                                                       /* commit */
+        if (a_tm1637_scheduler_step(handle) != 0)                                    /* run one transaction */
+        {
+            return 1;                                                                /* return error */
+        }
+    }
+
+    return 0;                                                                        /* success return 0 */
+}
+
+/**
+ * @brief     check the display data is combined
+ * @param[in] *handle points to a tm1637 handle structure
+ * @return    1 if merged into the display ram copy, 0 if written at once
+ * @note      none
+ */
+static uint8_t a_tm1637_scheduler_combining(tm1637_handle_t *handle)
+{
+    tm1637_scheduler_t *scheduler = a_tm1637_get_scheduler(handle);
+
+    if ((scheduler != NULL) &&
+        ((scheduler->window_us != 0) || (scheduler->pacer != NULL)))                        /* write combining or paced */
+    {
+        return 1;                                                                           /* combined */
+    }
+
+    return 0;                                                                               /* written at once */
+}
+
+/**
+ * @brief     flush the merged digits once they are ready
+ * @param[in] *handle points to a tm1637 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 flush failed
+ * @note      the caller holds the lock, the digits wait in the ram copy while the window is open
+ */
+static uint8_t a_tm1637_scheduler_settle(tm1637_handle_t *handle)
+{
+    if (a_tm1637_scheduler_ready(handle, a_tm1637_link_timestamp_us(handle)) != 0)        /* deadline reached */
+    {
+        return a_tm1637_scheduler_flush(handle);                                           /* flush */
+    }
+
+    return 0;                                                                              /* success return 0 */
+}
+
+/**
+ * @brief     lock the bus
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] *name points to the api name
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock failed
+ * @note      the lock is optional and held for a whole api call
+ */
+static uint8_t a_tm1637_lock(tm1637_handle_t *handle, const char *name)
+{
+    tm1637_trace_state_t *trace = a_tm1637_get_trace(handle);
+    uint8_t res;
+    uint32_t start_us = 0;
+
+    if (trace != NULL)                                                                 /* check trace */
+    {
+        start_us = a_tm1637_link_timestamp_us(handle);                                 /* save wait start */
+    }
+    res = 0;                                                                           /* init 0 */
+    if (handle->ops == NULL)                                                           /* function pointers */
+    {
+        if (DRIVER_TM1637_LINK_TARGET(handle)->lock != NULL)                           /* check lock */
+        {
+            res = DRIVER_TM1637_LINK_TARGET(handle)->lock();                           /* lock */
+        }
+    }
+    else if (handle->ops->lock != NULL)                                                /* check lock */
+    {
+        res = handle->ops->lock(handle->ctx);                                          /* lock */
+    }
+    if (res != 0)                                                                      /* check the result */
+    {
+        handle->debug_print("tm1637: lock failed.\n");                                 /* lock failed */
+
+        return 1;                                                                      /* return error */
+    }
+    if (trace != NULL)                                                                 /* check trace */
+    {
+        trace->name = name;                                                            /* save api name */
+        trace->start_us = a_tm1637_link_timestamp_us(handle);                          /* save api start */
+        trace->wait_us = trace->start_us - start_us;                                   /* save lock wait */
+    }
+
+    return 0;                                                                          /* success return 0 */
+}
+
+/**
+ * @brief     unlock the bus
+ * @param[in] *handle points to a tm1637 handle structure
+ * @note      a traced api call is reported before the lock is released
+ */
+static void a_tm1637_unlock(tm1637_handle_t *handle)
+{
+    tm1637_trace_state_t *trace = a_tm1637_get_trace(handle);
+    tm1637_trace_event_t event;
+
+    if (trace != NULL)                                            /* check trace */
+    {
+        event.name = trace->name;                                 /* api name */
+        event.start_us = trace->start_us;                         /* set start */
+        event.end_us = a_tm1637_link_timestamp_us(handle);        /* set end */
+        event.wait_us = trace->wait_us;                           /* set lock wait */
+        event.type = TM1637_TRACE_TYPE_API;                       /* set type */
+        event.cmd = 0;                                            /* no command */
+        event.len = 0;                                            /* no payload */
+        event.res = 0;                                            /* no result */
+        trace->callback(trace->ctx, &event);                      /* run the callback */
+    }
+    if (handle->ops == NULL)                                      /* function pointers */
+    {
+        if (DRIVER_TM1637_LINK_TARGET(handle)->unlock != NULL)    /* check unlock */
+        {
+            DRIVER_TM1637_LINK_TARGET(handle)->unlock();          /* unlock */
+        }
+
+        return;                                                   /* return */
+    }
+    if (handle->ops->unlock != NULL)                              /* check unlock */
+    {
+        handle->ops->unlock(handle->ctx);                         /* unlock */
+    }
+}
+
+/**
+ * @brief     write the display ram
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] addr is the start address
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the caller holds the lock, the data command is skipped while the chip is known to be in the write mode
+ */
+static uint8_t a_tm1637_write_ram(tm1637_handle_t *handle, uint8_t addr, uint8_t *data, uint8_t len)
+{
+    tm1637_scheduler_t *scheduler = a_tm1637_get_scheduler(handle);
+    uint8_t i;
+    uint8_t cmd;
+
+    if ((scheduler == NULL) || (scheduler->data_cmd_valid == 0))                    /* data command lost */
+    {
+        cmd = TM1637_COMMAND_DATA | handle->data_conf;                  /* set the command */
+        if (a_tm1637_write(handle, cmd, NULL, 0) != 0)                  /* write the command */
+        {
+            return 1;                                                   /* return error */
+        }
+    }
+    if ((handle->data_conf & (1 << 2)) != 0)                            /* fixed address mode */
+    {
+        for (i = 0; i < len; i++)                                       /* loop all */
+        {
+            cmd = TM1637_COMMAND_ADDRESS | (addr + i);                  /* set the command */
+            if (a_tm1637_write(handle, cmd, &data[i], 1) != 0)          /* write the command */
+            {
+                return 1;                                               /* return error */
+            }
+        }
+    }
+    else                                                                /* auto increment 1 mode */
+    {
+        cmd = TM1637_COMMAND_ADDRESS | addr;                            /* set the command */
+        if (a_tm1637_write(handle, cmd, data, len) != 0)                /* write the command */
+        {
+            return 1;                                                   /* return error */
+        }
+    }
+    a_tm1637_scheduler_sync(handle, addr, data, len);                   /* sync the ram copy */
+
+    return 0;                                                           /* success return 0 */
+}
+
+/**
+ * @brief     write the masked digits of the display ram
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] *data points to a 6 digits frame buffer
+ * @param[in] mask is the digit mask
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the caller holds the lock, the data command is skipped while the chip is known to be in the write mode
+ */
+static uint8_t a_tm1637_write_ram_mask(tm1637_handle_t *handle, uint8_t *data, uint8_t mask)
+{
+    tm1637_scheduler_t *scheduler = a_tm1637_get_scheduler(handle);
+    uint8_t cmd;
+    uint8_t start;
+    uint8_t len;
+
+    if ((scheduler == NULL) || (scheduler->data_cmd_valid == 0))                         /* data command lost */
+    {
+        cmd = TM1637_COMMAND_DATA | handle->data_conf;                                   /* set the command */
+        if (a_tm1637_write(handle, cmd, NULL, 0) != 0)                                   /* write the command */
+        {
+            return 1;                                                                    /* return error */
+        }
+    }
+    start = 0;                                                                           /* init 0 */
+    while (start < 6)                                                                    /* loop all digits */
+    {
+        if ((mask & (1 << start)) == 0)                                                  /* not selected */
+        {
+            start++;                                                                     /* next */
+
+            continue;                                                                    /* continue */
+        }
+        len = 1;                                                                         /* one digit */
+        if ((handle->data_conf & (1 << 2)) == 0)                                         /* auto increment 1 mode */
+        {
+            while (((start + len) < 6) && ((mask & (1 << (start + len))) != 0))          /* extend the run */
+            {
+                len++;                                                                   /* len++ */
+            }
+        }
+        cmd = TM1637_COMMAND_ADDRESS | start;                                            /* set the command */
+        if (a_tm1637_write(handle, cmd, &data[start], len) != 0)                         /* write the run */
+        {
+            return 1;                                                                    /* return error */
+        }
+        a_tm1637_scheduler_sync(handle, start, &data[start], len);                       /* sync the ram copy */
+        start += len;                                                                    /* next run */
+    }
+
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief     initialize the chip
+ * @param[in] *handle points to a tm1637 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic initialization failed
+ *            - 2 handle is NULL
+ *            - 3 linked functions is NULL
+ * @note      none
+ */
+uint8_t tm1637_init(tm1637_handle_t *handle)
+{
+    if (handle == NULL)                                                            /* check handle */
+    {
+        return 2;                                                                  /* return error */
+    }
+    if (handle->debug_print == NULL)                                               /* check debug_print */
+    {
+        return 3;                                                                  /* return error */
+    }
+    if (handle->ops != NULL)                                                       /* shared ops */
+    {
+        if ((handle->ops->iic_init == NULL) || (handle->ops->iic_deinit == NULL) ||
+            (handle->ops->iic_write_cmd_custom == NULL) ||
+            (handle->ops->iic_read_cmd_custom == NULL) ||
+            (handle->ops->delay_ms == NULL))                                       /* check ops */
+        {
+            handle->debug_print("tm1637: ops is incomplete.\n");                   /* ops is incomplete */
+
+            return 3;                                                              /* return error */
+        }
+        if ((handle->ops->lock == NULL) != (handle->ops->unlock == NULL))          /* check lock and unlock */
+        {
+            handle->debug_print("tm1637: lock or unlock is null.\n");              /* lock or unlock is null */
+
+            return 3;                                                              /* return error */
+        }
+    }
+    else
+    {
+#if (TM1637_LINK_FUNCTION == 1)
+        tm1637_handle_t *link = handle;
+#else
+        tm1637_link_t *link = (tm1637_link_t *)handle->ctx;
+
+        if (handle->ctx == NULL)                                                   /* check link */
+        {
+            handle->debug_print("tm1637: link is null.\n");                        /* link is null */
+
+            return 3;                                                              /* return error */
+        }
+#endif
+        if (link->iic_init == NULL)                                                /* check iic_init */
+        {
+            handle->debug_print("tm1637: iic_init is null.\n");                    /* iic_init is null */
+
+            return 3;                                                              /* return error */
+        }
+        if (link->iic_deinit == NULL)                                              /* check iic_deinit */
+        {
+            handle->debug_print("tm1637: iic_deinit is null.\n");                  /* iic_deinit is null */
+
+            return 3;                                                              /* return error */
+        }
+        if (link->iic_write_cmd_custom == NULL)                                    /* check iic_write_cmd_custom */
+        {
+            handle->debug_print("tm1637: iic_write_cmd_custom is null.\n");        /* iic_write_cmd_custom is null */
+
+            return 3;                                                              /* return error */
+        }
+        if (link->iic_read_cmd_custom == NULL)                                     /* check iic_read_cmd_custom */
+        {
+            handle->debug_print("tm1637: iic_read_cmd_custom is null.\n");         /* iic_read_cmd_custom is null */
+
+            return 3;                                                              /* return error */
+        }
+        if (link->delay_ms == NULL)                                                /* check delay_ms */
+        {
+            handle->debug_print("tm1637: delay_ms is null.\n");                    /* delay_ms is null */
+
+            return 3;                                                              /* return error */
+        }
+        if ((link->lock == NULL) != (link->unlock == NULL))                        /* check lock and unlock */
+        {
+            handle->debug_print("tm1637: lock or unlock is null.\n");              /* lock or unlock is null */
+
+            return 3;                                                              /* return error */
+        }
+    }
+
+    if (a_tm1637_link_iic_init(handle) != 0)                                       /* iic init */
+    {
+        handle->debug_print("tm1637: iic init failed.\n");                         /* iic init failed */
+
+        return 4;                                                                  /* return error */
+    }
+    handle->data_conf = 0x00;                                                      /* init 0 */
+    handle->display_conf = 0x00;                                                   /* init 0  */
+#if (TM1637_SCHEDULER_FUNCTION == 1)
+    handle->scheduler = NULL;                                                      /* no scheduler */
+#endif
+#if (TM1637_TRACE_FUNCTION == 1)
+    handle->trace = NULL;                                                          /* no trace */
+#endif
+    handle->inited = 1;                                                            /* flag inited */
+
+    return 0;                                                                      /* success return 0 */
+}
+
+/**
+ * @brief     close the chip
+ * @param[in] *handle points to a tm1637 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic deinit failed or lock failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 power down failed
+ * @note      the iic deinit runs with the lock held, so no other caller sees a closed bus
+ */
+uint8_t tm1637_deinit(tm1637_handle_t *handle)
+{
+    uint8_t res;
+    uint8_t cmd;
+    uint8_t conf;
+
+    if (handle == NULL)                                         /* check handle */
+    {
+        return 2;                                               /* return error */
+    }
+    if (handle->inited != 1)                                    /* check handle initialization */
+    {
+        return 3;                                               /* return error */
+    }
+
+    if (a_tm1637_lock(handle, __func__) != 0)                   /* lock */
+    {
+        return 1;                                               /* return error */
+    }
+    conf = handle->display_conf & ~(1 << 3);                    /* clear settings */
+    cmd = TM1637_COMMAND_DISPLAY | conf;                        /* set the command */
+    if (a_tm1637_write(handle, cmd, NULL, 0) != 0)              /* write the command */
+    {
+        a_tm1637_unlock(handle);                                /* unlock */
+        handle->debug_print("tm1637: power down failed.\n");    /* power down failed */
+
+        return 4;                                               /* return error */
+    }
+    handle->display_conf = conf;                                /* save display conf */
+    res = a_tm1637_link_iic_deinit(handle);                     /* close iic */
+    if (res != 0)                                               /* check the result */
+    {
+        a_tm1637_unlock(handle);                                /* unlock */
+        handle->debug_print("tm1637: iic deinit failed.\n");    /* iic deinit failed */
+
+        return 1;                                               /* return error */
+    }
+#if (TM1637_SCHEDULER_FUNCTION == 1)
+    handle->scheduler = NULL;                                   /* detach scheduler */
+#endif
+    a_tm1637_unlock(handle);                                    /* unlock */
+#if (TM1637_TRACE_FUNCTION == 1)
+    handle->trace = NULL;                                       /* stop trace */
+#endif
+    handle->inited = 0;                                         /* flag close */
+
+    return 0;                                                   /* success return 0 */
+}
+
+/**
+ * @brief     set pulse width
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] width is the pulse width
+ * @return    status code
+ *            - 0 success
+ *            - 1 set pulse width failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      a conf queued on the scheduler takes the new width
+ */
+uint8_t tm1637_set_pulse_width(tm1637_handle_t *handle, tm1637_pulse_width_t width)
+{
+    uint8_t cmd;
+    uint8_t conf;
+
+    if (handle == NULL)                                         /* check handle */
+    {
+        return 2;                                               /* return error */
+    }
+    if (handle->inited != 1)                                    /* check handle initialization */
+    {
+        return 3;                                               /* return error */
+    }
+
+    if (a_tm1637_lock(handle, __func__) != 0)                   /* lock */
+    {
+        return 1;                                               /* return error */
+    }
+    conf = handle->display_conf & ~(7 << 0);                    /* clear settings */
+    conf |= width;                                              /* set display conf */
+    cmd = TM1637_COMMAND_DISPLAY | conf;                        /* set the command */
+    if (a_tm1637_write(handle, cmd, NULL, 0) != 0)              /* write the command */
+    {
+        a_tm1637_unlock(handle);                                /* unlock */
+        handle->debug_print("tm1637: write failed.\n");         /* write failed */
+
+        return 1;                                               /* return error */
+    }
+    handle->display_conf = conf;                                /* publish the new conf */
+    a_tm1637_scheduler_follow(handle, 7 << 0);                  /* update a queued conf */
+    a_tm1637_unlock(handle);                                    /* unlock */
+
+    return 0;                                                   /* success return 0 */
+}
+
+/**
+ * @brief      get pulse width
+ * @param[in]  *handle points to a tm1637 handle structure
+ * @param[out] *width points to a pulse width buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t tm1637_get_pulse_width(tm1637_handle_t *handle, tm1637_pulse_width_t *width)
+{
+    if (handle == NULL)                                                 /* check handle */
+    {
+        return 2;                                                       /* return error */
+    }
+    if (handle->inited != 1)                                            /* check handle initialization */
+    {
+        return 3;                                                       /* return error */
+    }
+
+    *width = (tm1637_pulse_width_t)(handle->display_conf & 0x7);        /* get width */
+
+    return 0;                                                           /* success return 0 */
+}
+
+/**
+ * @brief     enable or disable display
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] enable is a bool value
+ * @return    status code
+ *            - 0 success
+ *            - 1 set display failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      a conf queued on the scheduler takes the new display bit
+ */
+uint8_t tm1637_set_display(tm1637_handle_t *handle, tm1637_bool_t enable)
+{
+    uint8_t cmd;
+    uint8_t conf;
+
+    if (handle == NULL)                                         /* check handle */
+    {
+        return 2;                                               /* return error */
+    }
+    if (handle->inited != 1)                                    /* check handle initialization */
+    {
+        return 3;                                               /* return error */
+    }
+
+    if (a_tm1637_lock(handle, __func__) != 0)                   /* lock */
+    {
+        return 1;                                               /* return error */
+    }
+    conf = handle->display_conf & ~(1 << 3);                    /* clear settings */
+    conf |= enable << 3;                                        /* set display conf */
+    cmd = TM1637_COMMAND_DISPLAY | conf;                        /* set the command */
+    if (a_tm1637_write(handle, cmd, NULL, 0) != 0)              /* write the command */
+    {
+        a_tm1637_unlock(handle);                                /* unlock */
+        handle->debug_print("tm1637: write failed.\n");         /* write failed */
+
+        return 1;                                               /* return error */
+    }
+    handle->display_conf = conf;                                /* publish the new conf */
+    a_tm1637_scheduler_follow(handle, 1 << 3);                  /* update a queued conf */
+    a_tm1637_unlock(handle);                                    /* unlock */
+
+    return 0;                                                   /* success return 0 */
+}
+
+/**
+ * @brief      get display status
+ * @param[in]  *handle points to a tm1637 handle structure
+ * @param[out] *enable points to a bool value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t tm1637_get_display(tm1637_handle_t *handle, tm1637_bool_t *enable)
+{
+    if (handle == NULL)                                                 /* check handle */
+    {
+        return 2;                                                       /* return error */
+    }
+    if (handle->inited != 1)                                            /* check handle initialization */
+    {
+        return 3;                                                       /* return error */
+    }
+
+    *enable = (tm1637_bool_t)((handle->display_conf >> 3) & 0x01);      /* get bool */
+
+    return 0;                                                           /* success return 0 */
+}
+
+/**
+ * @brief     set address mode
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] mode is the address mode
+ * @return    status code
+ *            - 0 success
+ *            - 1 set address mode failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      none
+ */
+uint8_t tm1637_set_address_mode(tm1637_handle_t *handle, tm1637_address_mode_t mode)
+{
+    uint8_t cmd;
+    uint8_t conf;
+
+    if (handle == NULL)                                         /* check handle */
+    {
+        return 2;                                               /* return error */
+    }
+    if (handle->inited != 1)                                    /* check handle initialization */
+    {
+        return 3;                                               /* return error */
+    }
+
+    if (a_tm1637_lock(handle, __func__) != 0)                   /* lock */
+    {
+        return 1;                                               /* return error */
+    }
+    conf = handle->data_conf & ~(1 << 2);                       /* clear settings */
+    conf |= mode << 2;                                          /* set address mode */
+    cmd = TM1637_COMMAND_DATA | conf;                           /* set the command */
+    if (a_tm1637_write(handle, cmd, NULL, 0) != 0)              /* write the command */
+    {
+        a_tm1637_unlock(handle);                                /* unlock */
+        handle->debug_print("tm1637: write failed.\n");         /* write failed */
+
+        return 1;                                               /* return error */
+    }
+    handle->data_conf = conf;                                   /* publish the new conf */
+    a_tm1637_unlock(handle);                                    /* unlock */
+
+    return 0;                                                   /* success return 0 */
+}
+
+/**
+ * @brief      get address mode
+ * @param[in]  *handle points to a tm1637 handle structure
+ * @param[out] *mode points to an address mode buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t tm1637_get_address_mode(tm1637_handle_t *handle, tm1637_address_mode_t *mode)
+{
+    if (handle == NULL)                                                      /* check handle */
+    {
+        return 2;                                                            /* return error */
+    }
+    if (handle->inited != 1)                                                 /* check handle initialization */
+    {
+        return 3;                                                            /* return error */
+    }
+
+    *mode = (tm1637_address_mode_t)((handle->data_conf >> 2) & 0x01);        /* get address mode */
+
+    return 0;                                                                /* success return 0 */
+}
+
+/**
+ * @brief     enable or disable test mode
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] enable is a bool value
+ * @return    status code
+ *            - 0 success
+ *            - 1 set test mode failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      none
+ */
+uint8_t tm1637_set_test_mode(tm1637_handle_t *handle, tm1637_bool_t enable)
+{
+    uint8_t cmd;
+    uint8_t conf;
+
+    if (handle == NULL)                                         /* check handle */
+    {
+        return 2;                                               /* return error */
+    }
+    if (handle->inited != 1)                                    /* check handle initialization */
+    {
+        return 3;                                               /* return error */
+    }
+
+    if (a_tm1637_lock(handle, __func__) != 0)                   /* lock */
+    {
+        return 1;                                               /* return error */
+    }
+    conf = handle->data_conf & ~(1 << 3);                       /* clear settings */
+    conf |= enable << 3;                                        /* set test mode */
+    cmd = TM1637_COMMAND_DATA | conf;                           /* set the command */
+    if (a_tm1637_write(handle, cmd, NULL, 0) != 0)              /* write the command */
+    {
+        a_tm1637_unlock(handle);                                /* unlock */
+        handle->debug_print("tm1637: write failed.\n");         /* write failed */
+
+        return 1;                                               /* return error */
+    }
+    handle->data_conf = conf;                                   /* publish the new conf */
+    a_tm1637_unlock(handle);                                    /* unlock */
+
+    return 0;                                                   /* success return 0 */
+}
+
+/**
+ * @brief      get test mode status
+ * @param[in]  *handle points to a tm1637 handle structure
+ * @param[out] *enable points to a bool value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t tm1637_get_test_mode(tm1637_handle_t *handle, tm1637_bool_t *enable)
+{
+    if (handle == NULL)                                                /* check handle */
+    {
+        return 2;                                                      /* return error */
+    }
+    if (handle->inited != 1)                                           /* check handle initialization */
+    {
+        return 3;                                                      /* return error */
+    }
+
+    *enable = (tm1637_bool_t)((handle->data_conf >> 3) & 0x01);        /* get test mode */
+
+    return 0;                                                          /* success return 0 */
+}
+
+/**
+ * @brief     write segment
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] addr is the start address
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write segment failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 addr + len > 6
+ * @note      with write combining or a pacer the digits are only merged into the display ram copy and nothing
+ *            reaches the chip until the application calls tm1637_scheduler_run, tm1637_flush_step or
+ *            tm1637_scheduler_commit, only a later write past max_stale_us flushes on its own
+ */
+uint8_t tm1637_write_segment(tm1637_handle_t *handle, uint8_t addr, uint8_t *data, uint8_t len)
+{
+    if (handle == NULL)                                                               /* check handle */
+    {
+        return 2;                                                                     /* return error */
+    }
+    if (handle->inited != 1)                                                          /* check handle initialization */
+    {
+        return 3;                                                                     /* return error */
+    }
+    if (addr + len > 6)                                                               /* check range */
+    {
+        handle->debug_print("tm1637: addr + len > 6.\n");                             /* addr + len > 6 */
+
+        return 4;                                                                     /* return error */
+    }
+
+    if (a_tm1637_lock(handle, __func__) != 0)                                         /* lock */
+    {
+        return 1;                                                                     /* return error */
+    }
+    if ((len != 0) && (a_tm1637_scheduler_combining(handle) != 0))                    /* write combining or paced */
+    {
+        a_tm1637_scheduler_merge(handle, addr, data, len);                            /* merge into the ram copy */
+        if (a_tm1637_scheduler_settle(handle) != 0)                                   /* flush once ready */
+        {
+            a_tm1637_unlock(handle);                                                  /* unlock */
+            handle->debug_print("tm1637: write failed.\n");                           /* write failed */
+
+            return 1;                                                                 /* return error */
+        }
+        a_tm1637_unlock(handle);                                                      /* unlock */
+
+        return 0;                                                                     /* success return 0 */
+    }
+    if (a_tm1637_write_ram(handle, addr, data, len) != 0)                             /* write the ram */
+    {
+        a_tm1637_unlock(handle);                                                      /* unlock */
+        handle->debug_print("tm1637: write failed.\n");                               /* write failed */
+
+        return 1;                                                                     /* return error */
+    }
+    a_tm1637_unlock(handle);                                                          /* unlock */
+
+    return 0;                                                                         /* success return 0 */
+}
+
+/**
+ * @brief     write the masked digits of a frame
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] *data points to a 6 digits frame buffer
+ * @param[in] mask is the digit mask, bit n selects data[n]
+ * @return    status code
+ *            - 0 success
+ *            - 1 write segment failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 mask is invalid
+ * @note      the data command is sent once and each contiguous run of the mask is one burst
+ *            in the auto increment 1 mode, with write combining or a pacer it is merged like tm1637_write_segment
+ */
+uint8_t tm1637_write_segment_mask(tm1637_handle_t *handle, uint8_t *data, uint8_t mask)
+{
+    uint8_t i;
+
+    if (handle == NULL)                                                 /* check handle */
+    {
+        return 2;                                                       /* return error */
+    }
+    if (handle->inited != 1)                                            /* check handle initialization */
+    {
+        return 3;                                                       /* return error */
+    }
+    if (mask > 0x3F)                                                    /* check mask */
+    {
+        handle->debug_print("tm1637: mask is invalid.\n");              /* mask is invalid */
+
+        return 4;                                                       /* return error */
+    }
+    if (mask == 0)                                                      /* nothing to write */
+    {
+        return 0;                                                       /* success return 0 */
+    }
+
+    if (a_tm1637_lock(handle, __func__) != 0)                           /* lock */
+    {
+        return 1;                                                       /* return error */
+    }
+    if (a_tm1637_scheduler_combining(handle) != 0)                      /* write combining or paced */
+    {
+        for (i = 0; i < 6; i++)                                         /* loop all digits */
+        {
+            if ((mask & (1 << i)) != 0)                                 /* selected */
+            {
+                a_tm1637_scheduler_merge(handle, i, &data[i], 1);       /* merge into the ram copy */
+            }
+        }
+        if (a_tm1637_scheduler_settle(handle) != 0)                     /* flush once ready */
+        {
+            a_tm1637_unlock(handle);                                    /* unlock */
+            handle->debug_print("tm1637: write failed.\n");             /* write failed */
+
+            return 1;                                                   /* return error */
+        }
+        a_tm1637_unlock(handle);                                        /* unlock */
+
+        return 0;                                                       /* success return 0 */
+    }
+    if (a_tm1637_write_ram_mask(handle, data, mask) != 0)               /* write the ram */
+    {
+        a_tm1637_unlock(handle);                                        /* unlock */
+        handle->debug_print("tm1637: write failed.\n");                 /* write failed */
+
+        return 1;                                                       /* return error */
+    }
+    a_tm1637_unlock(handle);                                            /* unlock */
+
+    return 0;                                                           /* success return 0 */
+}
+
+/**
+ * @brief     clear segment
+ * @param[in] *handle points to a tm1637 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 clear segment failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      with write combining or a pacer it is merged like tm1637_write_segment
+ */
+uint8_t tm1637_clear_segment(tm1637_handle_t *handle)
+{
+    uint8_t data[6] = {0};
+
+    if (handle == NULL)                                                 /* check handle */
+    {
+        return 2;                                                       /* return error */
+    }
+    if (handle->inited != 1)                                            /* check handle initialization */
+    {
+        return 3;                                                       /* return error */
+    }
+
+    if (a_tm1637_lock(handle, __func__) != 0)                           /* lock */
+    {
+        return 1;                                                       /* return error */
+    }
+    if (a_tm1637_scheduler_combining(handle) != 0)                      /* write combining or paced */
+    {
+        a_tm1637_scheduler_merge(handle, 0, data, 6);                   /* merge into the ram copy */
+        if (a_tm1637_scheduler_settle(handle) != 0)                     /* flush once ready */
+        {
+            a_tm1637_unlock(handle);                                    /* unlock */
+            handle->debug_print("tm1637: write failed.\n");             /* write failed */
+
+            return 1;                                                   /* return error */
+        }
+        a_tm1637_unlock(handle);                                        /* unlock */
+
+        return 0;                                                       /* success return 0 */
+    }
+    if (a_tm1637_write_ram(handle, 0, data, 6) != 0)                    /* write the ram */
+    {
+        a_tm1637_unlock(handle);                                        /* unlock */
+        handle->debug_print("tm1637: write failed.\n");                 /* write failed */
+
+        return 1;                                                       /* return error */
+    }
+    a_tm1637_unlock(handle);                                            /* unlock */
+
+    return 0;                                                           /* success return 0 */
+}
+
+/**
+ * @brief      read segment
+ * @param[in]  *handle points to a tm1637 handle structure
+ * @param[out] *seg points to a seg buffer
+ * @param[out] *k points to a k buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read segment failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t tm1637_read_segment(tm1637_handle_t *handle, uint8_t *seg, uint8_t *k)
+{
+    uint8_t cmd;
+    uint8_t data;
+
+    if (handle == NULL)                                              /* check handle */
+    {
+        return 2;                                                    /* return error */
+    }
+    if (handle->inited != 1)                                         /* check handle initialization */
+    {
+        return 3;                                                    /* return error */
+    }
+
+    if (a_tm1637_lock(handle, __func__) != 0)                        /* lock */
+    {
+        return 1;                                                    /* return error */
+    }
+    cmd = TM1637_COMMAND_DATA | handle->data_conf | (1 << 1);        /* set the command */
+    a_tm1637_scheduler_invalidate(handle);                           /* chip leaves write mode */
+    if (a_tm1637_read(handle, cmd, &data, 1) != 0)                   /* read the command */
+    {
+        a_tm1637_unlock(handle);                                     /* unlock */
+        handle->debug_print("tm1637: read failed.\n");               /* read failed */
+
+        return 1;                                                    /* return error */
+    }
+    a_tm1637_unlock(handle);                                         /* unlock */
+    *seg = data & 0x7;                                               /* get seg */
+    *k = (data >> 3) & 0x03;                                         /* get k */
+
+    return 0;                                                        /* success return 0 */
+}
+
+/**
+ * @brief     attach a scheduler to the handle
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] *scheduler points to a tm1637 scheduler structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock failed
+ *            - 2 handle or scheduler is NULL
+ *            - 3 handle is not initialized
+ *            - 4 timestamp_us is NULL
+ *            - 5 scheduler is disabled
+ * @note      the scheduler serves configuration commands, key reads and display data by the earliest deadline,
+ *            one bus transaction per call of tm1637_scheduler_run, TM1637_SCHEDULER_FUNCTION 0 disables it
+ */
+uint8_t tm1637_scheduler_init(tm1637_handle_t *handle, tm1637_scheduler_t *scheduler)
+{
+    if ((handle == NULL) || (scheduler == NULL))                                                               /* check handle */
+    {
+        return 2;                                                                                              /* return error */
+    }
+    if (handle->inited != 1)                                                                                   /* check handle initialization */
+    {
+        return 3;                                                                                              /* return error */
+    }
+    if (a_tm1637_link_has_timestamp_us(handle) == 0)                                                           /* check timestamp_us */
+    {
+        handle->debug_print("tm1637: timestamp_us is null.\n");                                                /* timestamp_us is null */
+
+        return 4;                                                                                              /* return error */
+    }
+#if (TM1637_SCHEDULER_FUNCTION == 0)
+    handle->debug_print("tm1637: scheduler is disabled.\n");                                                   /* scheduler is disabled */
+
+    return 5;                                                                                                  /* return error */
+#else
+
+    memset(scheduler, 0, sizeof(tm1637_scheduler_t));                                                          /* clear the scheduler */
+    scheduler->latency_target_us[TM1637_SCHEDULER_CLASS_CONFIG] = TM1637_SCHEDULER_DEFAULT_CONFIG_US;          /* set config target */
+    scheduler->latency_target_us[TM1637_SCHEDULER_CLASS_KEY] = TM1637_SCHEDULER_DEFAULT_KEY_US;                /* set key target */
+    scheduler->latency_target_us[TM1637_SCHEDULER_CLASS_DISPLAY] = TM1637_SCHEDULER_DEFAULT_DISPLAY_US;        /* set display target */
+    if (a_tm1637_lock(handle, __func__) != 0)                                                                  /* lock */
+    {
+        return 1;                                                                                              /* return error */
+    }
+    scheduler->display_conf = handle->display_conf;                                                            /* copy display conf */
+    handle->scheduler = scheduler;                                                                             /* attach */
+    a_tm1637_unlock(handle);                                                                                   /* unlock */
+
+    return 0;                                                                                                  /* success return 0 */
+#endif
+}
+
+/**
+ * @brief     detach the scheduler from the handle
+ * @param[in] *handle points to a tm1637 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 scheduler is not attached
+ * @note      pending work is dropped
+ */
+uint8_t tm1637_scheduler_deinit(tm1637_handle_t *handle)
+{
+    tm1637_scheduler_t *scheduler;
+
+    if (handle == NULL)                              /* check handle */
+    {
+        return 2;                                    /* return error */
+    }
+    if (handle->inited != 1)                         /* check handle initialization */
+    {
+        return 3;                                    /* return error */
+    }
+    scheduler = a_tm1637_get_scheduler(handle);      /* get scheduler */
+    if (scheduler == NULL)                           /* check scheduler */
+    {
+        return 4;                                    /* return error */
+    }
+
+    if (a_tm1637_lock(handle, __func__) != 0)        /* lock */
+    {
+        return 1;                                    /* return error */
+    }
+#if (TM1637_SCHEDULER_FUNCTION == 1)
+    handle->scheduler = NULL;                        /* detach */
+#endif
+    a_tm1637_unlock(handle);                         /* unlock */
+
+    return 0;                                        /* success return 0 */
+}
+
+/**
+ * @brief     set the max latency target of a scheduler class
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] cls is the scheduler class
+ * @param[in] us is the max latency in microseconds
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 scheduler is not attached
+ *            - 5 class is invalid
+ * @note      none
+ */
+uint8_t tm1637_scheduler_set_latency_target(tm1637_handle_t *handle, tm1637_scheduler_class_t cls, uint32_t us)
+{
+    tm1637_scheduler_t *scheduler;
+
+    if (handle == NULL)                                          /* check handle */
+    {
+        return 2;                                                /* return error */
+    }
+    if (handle->inited != 1)                                     /* check handle initialization */
+    {
+        return 3;                                                /* return error */
+    }
+    scheduler = a_tm1637_get_scheduler(handle);                  /* get scheduler */
+    if (scheduler == NULL)                                       /* check scheduler */
+    {
+        return 4;                                                /* return error */
+    }
+    if (cls > TM1637_SCHEDULER_CLASS_DISPLAY)                    /* check class */
+    {
+        handle->debug_print("tm1637: class is invalid.\n");      /* class is invalid */
+
+        return 5;                                                /* return error */
+    }
+
+    if (a_tm1637_lock(handle, __func__) != 0)                    /* lock */
+    {
+        return 1;                                                /* return error */
+    }
+    scheduler->latency_target_us[cls] = us;                      /* set target */
+    a_tm1637_unlock(handle);                                     /* unlock */
+
+    return 0;                                                    /* success return 0 */
+}
+
+/**
+ * @brief      get the max latency target of a scheduler class
+ * @param[in]  *handle points to a tm1637 handle structure
+ * @param[in]  cls is the scheduler class
+ * @param[out] *us points to a microseconds buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 scheduler is not attached
+ *             - 5 class is invalid
+ * @note       none
+ */
+uint8_t tm1637_scheduler_get_latency_target(tm1637_handle_t *handle, tm1637_scheduler_class_t cls, uint32_t *us)
+{
+    tm1637_scheduler_t *scheduler;
+
+    if (handle == NULL)                                          /* check handle */
+    {
+        return 2;                                                /* return error */
+    }
+    if (handle->inited != 1)                                     /* check handle initialization */
+    {
+        return 3;                                                /* return error */
+    }
+    scheduler = a_tm1637_get_scheduler(handle);                  /* get scheduler */
+    if (scheduler == NULL)                                       /* check scheduler */
+    {
+        return 4;                                                /* return error */
+    }
+    if (cls > TM1637_SCHEDULER_CLASS_DISPLAY)                    /* check class */
+    {
+        handle->debug_print("tm1637: class is invalid.\n");      /* class is invalid */
+
+        return 5;                                                /* return error */
+    }
 
-    return output;                                                   /* return output */
+    *us = scheduler->latency_target_us[cls];                     /* get target */
+
+    return 0;                                                    /* success return 0 */
 }
 
 /**
- * @brief     iic write
+ * @brief     set the write combining deadlines
  * @param[in] *handle points to a tm1637 handle structure
- * @param[in] cmd is the set command
- * @param[in] *buf points to a data buffer
- * @param[in] len is the buffer length
+ * @param[in] window_us is the coalescing window in microseconds, 0 disables write combining
+ * @param[in] max_stale_us is the max staleness in microseconds, 0 means unlimited
  * @return    status code
  *            - 0 success
- *            - 1 write failed
- * @note      none
+ *            - 1 lock failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 scheduler is not attached
+ *            - 5 max_stale_us is shorter than window_us
+ * @note      when enabled, tm1637_write_segment, tm1637_write_segment_mask and tm1637_clear_segment only update
+ *            the display ram copy and nothing reaches the chip until the application calls tm1637_scheduler_run
+ *            or tm1637_flush_step after no write arrived for window_us, or calls tm1637_scheduler_commit,
+ *            a write arriving after the oldest digit waited max_stale_us flushes on its own
  */
-static uint8_t a_tm1637_write(tm1637_handle_t *handle, uint8_t cmd, uint8_t *buf, uint16_t len)
+uint8_t tm1637_scheduler_set_write_combining(tm1637_handle_t *handle, uint32_t window_us, uint32_t max_stale_us)
 {
-    uint8_t inner_buffer[16];
-    uint16_t i;
+    tm1637_scheduler_t *scheduler;
 
-    if (len > 16)                                                                       /* check len */
+    if (handle == NULL)                                                           /* check handle */
     {
-        return 1;                                                                       /* return error */
+        return 2;                                                                 /* return error */
     }
-    for (i = 0; i < len; i++)                                                           /* loop all */
+    if (handle->inited != 1)                                                      /* check handle initialization */
     {
-        inner_buffer[i] = a_high_low_shift(buf[i]);                                     /* shift */
+        return 3;                                                                 /* return error */
     }
-    if (handle->iic_write_cmd_custom(a_high_low_shift(cmd), inner_buffer, len) != 0)    /* write data */
+    scheduler = a_tm1637_get_scheduler(handle);                                   /* get scheduler */
+    if (scheduler == NULL)                                                        /* check scheduler */
     {
-        return 1;                                                                       /* return error */
+        return 4;                                                                 /* return error */
     }
+    if ((max_stale_us != 0) && (max_stale_us < window_us))                        /* check max stale */
+    {
+        handle->debug_print("tm1637: max_stale_us is shorter than window_us.\n"); /* max_stale_us is shorter than window_us */
 
-    return 0;                                                                           /* success return 0 */
+        return 5;                                                                 /* return error */
+    }
+
+    if (a_tm1637_lock(handle, __func__) != 0)                                     /* lock */
+    {
+        return 1;                                                                 /* return error */
+    }
+    scheduler->window_us = window_us;                                             /* set window */
+    scheduler->max_stale_us = max_stale_us;                                       /* set max stale */
+    a_tm1637_unlock(handle);                                                      /* unlock */
+
+    return 0;                                                                     /* success return 0 */
 }
 
 /**
- * @brief      iic read
+ * @brief      get the write combining deadlines
  * @param[in]  *handle points to a tm1637 handle structure
- * @param[in]  cmd is the set command
- * @param[out] *buf points to a data buffer
- * @param[in]  len is the buffer length
+ * @param[out] *window_us points to a coalescing window buffer
+ * @param[out] *max_stale_us points to a max staleness buffer
  * @return     status code
  *             - 0 success
- *             - 1 read failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 scheduler is not attached
  * @note       none
  */
-static uint8_t a_tm1637_read(tm1637_handle_t *handle, uint8_t cmd, uint8_t *buf, uint16_t len)
+uint8_t tm1637_scheduler_get_write_combining(tm1637_handle_t *handle, uint32_t *window_us, uint32_t *max_stale_us)
 {
-    uint16_t i;
+    tm1637_scheduler_t *scheduler;
 
-    if (handle->iic_read_cmd_custom(a_high_low_shift(cmd), buf, len) != 0)    /* read data */
+    if (handle == NULL)                                     /* check handle */
+    {
+        return 2;                                           /* return error */
+    }
+    if (handle->inited != 1)                                /* check handle initialization */
     {
-        return 1;                                                             /* return error */
+        return 3;                                           /* return error */
     }
-    for (i = 0; i < len; i++)                                                 /* loop all */
+    scheduler = a_tm1637_get_scheduler(handle);             /* get scheduler */
+    if (scheduler == NULL)                                  /* check scheduler */
     {
-        buf[i] = a_high_low_shift(buf[i]);                                    /* shift */
+        return 4;                                           /* return error */
     }
 
-    return 0;                                                                 /* success return 0 */
+    *window_us = scheduler->window_us;                      /* get window */
+    *max_stale_us = scheduler->max_stale_us;                /* get max stale */
+
+    return 0;                                               /* success return 0 */
 }
 
 /**
- * @brief     initialize the chip
+ * @brief     commit the combined writes
  * @param[in] *handle points to a tm1637 handle structure
  * @return    status code
  *            - 0 success
- *            - 1 iic initialization failed
+ *            - 1 commit failed
  *            - 2 handle is NULL
- *            - 3 linked functions is NULL
- * @note      none
+ *            - 3 handle is not initialized
+ *            - 4 scheduler is not attached
+ * @note      all dirty digits are sent before this function returns
  */
-uint8_t tm1637_init(tm1637_handle_t *handle)
+uint8_t tm1637_scheduler_commit(tm1637_handle_t *handle)
 {
-    if (handle == NULL)                                                     /* check handle */
+    tm1637_scheduler_t *scheduler;
+
+    if (handle == NULL)                                             /* check handle */
     {
-        return 2;                                                           /* return error */
+        return 2;                                                   /* return error */
     }
-    if (handle->debug_print == NULL)                                        /* check debug_print */
+    if (handle->inited != 1)                                        /* check handle initialization */
     {
-        return 3;                                                           /* return error */
+        return 3;                                                   /* return error */
     }
-    if (handle->iic_init == NULL)                                           /* check iic_init */
+    scheduler = a_tm1637_get_scheduler(handle);                     /* get scheduler */
+    if (scheduler == NULL)                                          /* check scheduler */
     {
-        handle->debug_print("tm1637: iic_init is null.\n");                 /* iic_init is null */
+        return 4;                                                   /* return error */
+    }
 
-        return 3;                                                           /* return error */
+    if (a_tm1637_lock(handle, __func__) != 0)                       /* lock */
+    {
+        return 1;                                                   /* return error */
     }
-    if (handle->iic_deinit == NULL)                                         /* check iic_deinit */
+    if (a_tm1637_scheduler_flush(handle) != 0)                      /* flush */
     {
-        handle->debug_print("tm1637: iic_deinit is null.\n");               /* iic_deinit is null */
+        a_tm1637_unlock(handle);                                    /* unlock */
+        handle->debug_print("tm1637: commit failed.\n");            /* commit failed */
 
-        return 3;                                                           /* return error */
+        return 1;                                                   /* return error */
     }
-    if (handle->iic_write_cmd_custom == NULL)                               /* check iic_write_cmd_custom */
-    {
-        handle->debug_print("tm1637: iic_write_cmd_custom is null.\n");     /* iic_write_cmd_custom is null */
+    a_tm1637_unlock(handle);                                        /* unlock */
+
+    return 0;                                                       /* success return 0 */
+}
+
+/**
+ * @brief     queue a segment write
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] addr is the start address
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 scheduler is not attached
+ *            - 5 addr + len > 6
+ * @note      queued digits are merged into the display ram copy, the latest value wins
+ */
+uint8_t tm1637_scheduler_write_segment(tm1637_handle_t *handle, uint8_t addr, uint8_t *data, uint8_t len)
+{
+    tm1637_scheduler_t *scheduler;
 
-        return 3;                                                           /* return error */
+    if (handle == NULL)                                                        /* check handle */
+    {
+        return 2;                                                              /* return error */
     }
-    if (handle->iic_read_cmd_custom == NULL)                                /* check iic_read_cmd_custom */
+    if (handle->inited != 1)                                                   /* check handle initialization */
     {
-        handle->debug_print("tm1637: iic_read_cmd_custom is null.\n");      /* iic_read_cmd_custom is null */
-
-        return 3;                                                           /* return error */
+        return 3;                                                              /* return error */
     }
-    if (handle->delay_ms == NULL)                                           /* check delay_ms */
+    scheduler = a_tm1637_get_scheduler(handle);                                /* get scheduler */
+    if (scheduler == NULL)                                                     /* check scheduler */
     {
-        handle->debug_print("tm1637: delay_ms is null.\n");                 /* delay_ms is null */
-
-        return 3;                                                           /* return error */
+        return 4;                                                              /* return error */
     }
+    if (addr + len > 6)                                                        /* check range */
+    {
+        handle->debug_print("tm1637: addr + len > 6.\n");                      /* addr + len > 6 */
 
-    if (handle->iic_init() != 0)                                            /* iic init */
+        return 5;                                                              /* return error */
+    }
+    if (len == 0)                                                              /* nothing to write */
     {
-        handle->debug_print("tm1637: iic init failed.\n");                  /* iic init failed */
+        return 0;                                                              /* success return 0 */
+    }
 
-        return 4;                                                           /* return error */
+    if (a_tm1637_lock(handle, __func__) != 0)                                  /* lock */
+    {
+        return 1;                                                              /* return error */
     }
-    handle->data_conf = 0x00;                                               /* init 0 */
-    handle->display_conf = 0x00;                                            /* init 0  */
-    handle->inited = 1;                                                     /* flag inited */
+    a_tm1637_scheduler_merge(handle, addr, data, len);                         /* merge into the ram copy */
+    a_tm1637_unlock(handle);                                                   /* unlock */
 
-    return 0;                                                               /* success return 0 */
+    return 0;                                                                  /* success return 0 */
 }
 
 /**
- * @brief     close the chip
+ * @brief     queue a key read
  * @param[in] *handle points to a tm1637 handle structure
  * @return    status code
  *            - 0 success
- *            - 1 iic deinit failed
+ *            - 1 lock failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- *            - 4 power down failed
- * @note      none
+ *            - 4 scheduler is not attached
+ * @note      the result is fetched by tm1637_scheduler_get_key
  */
-uint8_t tm1637_deinit(tm1637_handle_t *handle)
+uint8_t tm1637_scheduler_read_segment(tm1637_handle_t *handle)
 {
-    uint8_t res;
-    uint8_t cmd;
+    tm1637_scheduler_t *scheduler;
 
-    if (handle == NULL)                                         /* check handle */
+    if (handle == NULL)                                                 /* check handle */
     {
-        return 2;                                               /* return error */
+        return 2;                                                       /* return error */
     }
-    if (handle->inited != 1)                                    /* check handle initialization */
+    if (handle->inited != 1)                                            /* check handle initialization */
     {
-        return 3;                                               /* return error */
+        return 3;                                                       /* return error */
+    }
+    scheduler = a_tm1637_get_scheduler(handle);                         /* get scheduler */
+    if (scheduler == NULL)                                              /* check scheduler */
+    {
+        return 4;                                                       /* return error */
     }
 
-    handle->display_conf &= ~(1 << 3);                          /* clear settings */
-    cmd = TM1637_COMMAND_DISPLAY | handle->display_conf;        /* set the command */
-    if (a_tm1637_write(handle, cmd, NULL, 0) != 0)              /* write the command */
+    if (a_tm1637_lock(handle, __func__) != 0)                       /* lock */
     {
-        handle->debug_print("tm1637: power down failed.\n");    /* power down failed */
+        return 1;                                                   /* return error */
+    }
+    a_tm1637_scheduler_mark(handle, TM1637_SCHEDULER_CLASS_KEY);        /* mark pending */
+    a_tm1637_unlock(handle);                                        /* unlock */
 
-        return 4;                                               /* return error */
+    return 0;                                                           /* success return 0 */
+}
+
+/**
+ * @brief      get the last key read result
+ * @param[in]  *handle points to a tm1637 handle structure
+ * @param[out] *seg points to a seg buffer
+ * @param[out] *k points to a k buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 lock failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 scheduler is not attached
+ *             - 5 no new key result
+ * @note       none
+ */
+uint8_t tm1637_scheduler_get_key(tm1637_handle_t *handle, uint8_t *seg, uint8_t *k)
+{
+    tm1637_scheduler_t *scheduler;
+
+    if (handle == NULL)                              /* check handle */
+    {
+        return 2;                                    /* return error */
+    }
+    if (handle->inited != 1)                         /* check handle initialization */
+    {
+        return 3;                                    /* return error */
+    }
+    scheduler = a_tm1637_get_scheduler(handle);      /* get scheduler */
+    if (scheduler == NULL)                           /* check scheduler */
+    {
+        return 4;                                    /* return error */
     }
 
-    res = handle->iic_deinit();                                 /* close iic */
-    if (res != 0)                                               /* check the result */
+    if (a_tm1637_lock(handle, __func__) != 0)        /* lock */
     {
-        handle->debug_print("tm1637: iic deinit failed.\n");    /* iic deinit failed */
+        return 1;                                    /* return error */
+    }
+    if (scheduler->key_ready == 0)                   /* check key ready */
+    {
+        a_tm1637_unlock(handle);                     /* unlock */
 
-        return 1;                                               /* return error */
+        return 5;                                    /* return error */
     }
-    handle->inited = 0;                                         /* flag close */
+    *seg = scheduler->seg;                           /* get seg */
+    *k = scheduler->k;                               /* get k */
+    scheduler->key_ready = 0;                        /* clear ready */
+    a_tm1637_unlock(handle);                         /* unlock */
 
-    return 0;                                                   /* success return 0 */
+    return 0;                                        /* success return 0 */
 }
 
 /**
- * @brief     set pulse width
+ * @brief     queue a pulse width change
  * @param[in] *handle points to a tm1637 handle structure
  * @param[in] width is the pulse width
  * @return    status code
  *            - 0 success
- *            - 1 set pulse width failed
+ *            - 1 lock failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
+ *            - 4 scheduler is not attached
  * @note      none
  */
-uint8_t tm1637_set_pulse_width(tm1637_handle_t *handle, tm1637_pulse_width_t width)
+uint8_t tm1637_scheduler_set_pulse_width(tm1637_handle_t *handle, tm1637_pulse_width_t width)
 {
-    uint8_t cmd;
+    tm1637_scheduler_t *scheduler;
 
-    if (handle == NULL)                                         /* check handle */
+    if (handle == NULL)                                                            /* check handle */
     {
-        return 2;                                               /* return error */
+        return 2;                                                                  /* return error */
     }
-    if (handle->inited != 1)                                    /* check handle initialization */
+    if (handle->inited != 1)                                                       /* check handle initialization */
     {
-        return 3;                                               /* return error */
+        return 3;                                                                  /* return error */
+    }
+    scheduler = a_tm1637_get_scheduler(handle);                                    /* get scheduler */
+    if (scheduler == NULL)                                                         /* check scheduler */
+    {
+        return 4;                                                                  /* return error */
     }
 
-    handle->display_conf &= ~(7 << 0);                          /* clear settings */
-    handle->display_conf |= width;                              /* set display conf */
-    cmd = TM1637_COMMAND_DISPLAY | handle->display_conf;        /* set the command */
-    if (a_tm1637_write(handle, cmd, NULL, 0) != 0)              /* write the command */
+    if (a_tm1637_lock(handle, __func__) != 0)                                  /* lock */
     {
-        handle->debug_print("tm1637: write failed.\n");         /* write failed */
+        return 1;                                                              /* return error */
+    }
+    if ((scheduler->pending & (1 << TM1637_SCHEDULER_CLASS_CONFIG)) == 0)          /* nothing queued */
+    {
+        scheduler->display_conf = handle->display_conf;                            /* start from the current conf */
+    }
+    scheduler->display_conf &= ~(7 << 0);                                          /* clear settings */
+    scheduler->display_conf |= width;                                              /* set display conf */
+    a_tm1637_scheduler_mark(handle, TM1637_SCHEDULER_CLASS_CONFIG);                /* mark pending */
+    a_tm1637_unlock(handle);                                                   /* unlock */
 
-        return 1;                                               /* return error */
+    return 0;                                                                      /* success return 0 */
+}
+
+/**
+ * @brief     queue a display enable or disable
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] enable is a bool value
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 scheduler is not attached
+ * @note      none
+ */
+uint8_t tm1637_scheduler_set_display(tm1637_handle_t *handle, tm1637_bool_t enable)
+{
+    tm1637_scheduler_t *scheduler;
+
+    if (handle == NULL)                                                            /* check handle */
+    {
+        return 2;                                                                  /* return error */
+    }
+    if (handle->inited != 1)                                                       /* check handle initialization */
+    {
+        return 3;                                                                  /* return error */
+    }
+    scheduler = a_tm1637_get_scheduler(handle);                                    /* get scheduler */
+    if (scheduler == NULL)                                                         /* check scheduler */
+    {
+        return 4;                                                                  /* return error */
     }
 
-    return 0;                                                   /* success return 0 */
+    if (a_tm1637_lock(handle, __func__) != 0)                                  /* lock */
+    {
+        return 1;                                                              /* return error */
+    }
+    if ((scheduler->pending & (1 << TM1637_SCHEDULER_CLASS_CONFIG)) == 0)          /* nothing queued */
+    {
+        scheduler->display_conf = handle->display_conf;                            /* start from the current conf */
+    }
+    scheduler->display_conf &= ~(1 << 3);                                          /* clear settings */
+    scheduler->display_conf |= enable << 3;                                        /* set display conf */
+    a_tm1637_scheduler_mark(handle, TM1637_SCHEDULER_CLASS_CONFIG);                /* mark pending */
+    a_tm1637_unlock(handle);                                                   /* unlock */
+
+    return 0;                                                                      /* success return 0 */
 }
 
 /**
- * @brief      get pulse width
+ * @brief      run one scheduled bus transaction
  * @param[in]  *handle points to a tm1637 handle structure
- * @param[out] *width points to a pulse width buffer
+ * @param[out] *pending points to a pending class mask buffer
  * @return     status code
  *             - 0 success
+ *             - 1 run failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
- * @note       none
+ *             - 4 scheduler is not attached
+ * @note       bit n of pending is set when class n still has work after this call
  */
-uint8_t tm1637_get_pulse_width(tm1637_handle_t *handle, tm1637_pulse_width_t *width)
+uint8_t tm1637_scheduler_run(tm1637_handle_t *handle, uint8_t *pending)
 {
-    if (handle == NULL)                                                 /* check handle */
+    tm1637_scheduler_t *scheduler;
+
+    if (handle == NULL)                                            /* check handle */
     {
-        return 2;                                                       /* return error */
+        return 2;                                                  /* return error */
     }
-    if (handle->inited != 1)                                            /* check handle initialization */
+    if (handle->inited != 1)                                       /* check handle initialization */
     {
-        return 3;                                                       /* return error */
+        return 3;                                                  /* return error */
+    }
+    scheduler = a_tm1637_get_scheduler(handle);                    /* get scheduler */
+    if (scheduler == NULL)                                         /* check scheduler */
+    {
+        return 4;                                                  /* return error */
     }
 
-    *width = (tm1637_pulse_width_t)(handle->display_conf & 0x7);        /* get width */
+    if (a_tm1637_lock(handle, __func__) != 0)                      /* lock */
+    {
+        return 1;                                                  /* return error */
+    }
+    if (a_tm1637_scheduler_step(handle) != 0)                      /* run one transaction */
+    {
+        a_tm1637_unlock(handle);                                   /* unlock */
+        handle->debug_print("tm1637: run failed.\n");              /* run failed */
 
-    return 0;                                                           /* success return 0 */
+        return 1;                                                  /* return error */
+    }
+    if (pending != NULL)                                           /* check pending */
+    {
+        *pending = scheduler->pending;                             /* get pending */
+    }
+    a_tm1637_unlock(handle);                                       /* unlock */
+
+    return 0;                                                      /* success return 0 */
 }
 
 /**
- * @brief     enable or disable display
- * @param[in] *handle points to a tm1637 handle structure
- * @param[in] enable is a bool value
- * @return    status code
- *            - 0 success
- *            - 1 set display failed
- *            - 2 handle is NULL
- *            - 3 handle is not initialized
- * @note      none
+ * @brief      run the scheduled transactions that fit in a time budget
+ * @param[in]  *handle points to a tm1637 handle structure
+ * @param[in]  budget_us is the execution budget in microseconds
+ * @param[out] *remaining points to a remaining transaction counter buffer, NULL is allowed
+ * @return     status code
+ *             - 0 success
+ *             - 1 flush step failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 scheduler is not attached
+ * @note       only whole transactions are run and the next call resumes with the next one, the first ready
+ *             transaction always runs so a budget shorter than one transaction still makes progress,
+ *             a further one is started only when the recent transaction time still fits, it follows
+ *             a longer transaction at once and decays towards shorter ones,
+ *             remaining also counts work held back by write combining or the pacer
  */
-uint8_t tm1637_set_display(tm1637_handle_t *handle, tm1637_bool_t enable)
+uint8_t tm1637_flush_step(tm1637_handle_t *handle, uint32_t budget_us, uint8_t *remaining)
 {
-    uint8_t cmd;
+    tm1637_scheduler_t *scheduler;
+    uint32_t start;
+    uint32_t served;
+    uint8_t first;
 
-    if (handle == NULL)                                         /* check handle */
+    if (handle == NULL)                                                                                  /* check handle */
     {
-        return 2;                                               /* return error */
+        return 2;                                                                                        /* return error */
     }
-    if (handle->inited != 1)                                    /* check handle initialization */
+    if (handle->inited != 1)                                                                             /* check handle initialization */
     {
-        return 3;                                               /* return error */
+        return 3;                                                                                        /* return error */
+    }
+    scheduler = a_tm1637_get_scheduler(handle);                                                          /* get scheduler */
+    if (scheduler == NULL)                                                                               /* check scheduler */
+    {
+        return 4;                                                                                        /* return error */
+    }
+
+    if (a_tm1637_lock(handle, __func__) != 0)                                                            /* lock */
+    {
+        return 1;                                                                                        /* return error */
+    }
+    start = a_tm1637_link_timestamp_us(handle);                                                          /* save start */
+    first = 1;                                                                                           /* first transaction */
+    while (scheduler->pending != 0)                                                                      /* work left */
+    {
+        if ((first == 0) &&
+            ((a_tm1637_link_timestamp_us(handle) - start + scheduler->transaction_us) > budget_us))      /* does not fit */
+        {
+            break;                                                                                       /* break */
+        }
+        first = 0;                                                                                       /* not the first */
+        served = scheduler->served[0] + scheduler->served[1] + scheduler->served[2];                     /* save served */
+        if (a_tm1637_scheduler_step(handle) != 0)                                                        /* run one transaction */
+        {
+            a_tm1637_unlock(handle);                                                                     /* unlock */
+            handle->debug_print("tm1637: flush step failed.\n");                                         /* flush step failed */
+
+            return 1;                                                                                    /* return error */
+        }
+        if (served == (scheduler->served[0] + scheduler->served[1] + scheduler->served[2]))              /* nothing was ready */
+        {
+            break;                                                                                       /* break */
+        }
+    }
+    if (remaining != NULL)                                                                               /* check remaining */
+    {
+        *remaining = a_tm1637_scheduler_remaining(handle);                                               /* get remaining */
+    }
+    a_tm1637_unlock(handle);                                                                             /* unlock */
+
+    return 0;                                                                                            /* success return 0 */
+}
+
+/**
+ * @brief      get the scheduler statistics of a class
+ * @param[in]  *handle points to a tm1637 handle structure
+ * @param[in]  cls is the scheduler class
+ * @param[out] *served points to a served transaction counter buffer
+ * @param[out] *miss points to a deadline miss counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 scheduler is not attached
+ *             - 5 class is invalid
+ * @note       none
+ */
+uint8_t tm1637_scheduler_get_statistics(tm1637_handle_t *handle, tm1637_scheduler_class_t cls, uint32_t *served, uint32_t *miss)
+{
+    tm1637_scheduler_t *scheduler;
+
+    if (handle == NULL)                                          /* check handle */
+    {
+        return 2;                                                /* return error */
     }
+    if (handle->inited != 1)                                     /* check handle initialization */
+    {
+        return 3;                                                /* return error */
+    }
+    scheduler = a_tm1637_get_scheduler(handle);                  /* get scheduler */
+    if (scheduler == NULL)                                       /* check scheduler */
+    {
+        return 4;                                                /* return error */
+    }
+    if (cls > TM1637_SCHEDULER_CLASS_DISPLAY)                    /* check class */
+    {
+        handle->debug_print("tm1637: class is invalid.\n");      /* class is invalid */
+
+        return 5;                                                /* return error */
+    }
+
+    *served = scheduler->served[cls];                            /* get served */
+    *miss = scheduler->deadline_miss[cls];                       /* get miss */
+
+    return 0;                                                    /* success return 0 */
+}
+
+/**
+ * @brief     update the pacer bus time budget
+ * @param[in] *pacer points to a tm1637 pacer structure
+ * @note      none
+ */
+static void a_tm1637_pacer_budget(tm1637_pacer_t *pacer)
+{
+    pacer->budget_us = (uint32_t)(((uint64_t)pacer->period_us * pacer->share) / 100);        /* share of the period */
+}
 
-    handle->display_conf &= ~(1 << 3);                          /* clear settings */
-    handle->display_conf |= enable << 3;                        /* set display conf */
-    cmd = TM1637_COMMAND_DISPLAY | handle->display_conf;        /* set the command */
-    if (a_tm1637_write(handle, cmd, NULL, 0) != 0)              /* write the command */
+/**
+ * @brief     initialize a pacer
+ * @param[in] *pacer points to a tm1637 pacer structure
+ * @param[in] *timestamp_us points to a timestamp_us function
+ * @param[in] *vsync points to a vsync callback, NULL means no callback
+ * @return    status code
+ *            - 0 success
+ *            - 2 pacer or timestamp_us is NULL
+ * @note      one pacer is shared by all displays on a bus, the default is 50 fps and 100% bus time share,
+ *            it has no lock until tm1637_pacer_set_lock is called
+ */
+uint8_t tm1637_pacer_init(tm1637_pacer_t *pacer, uint32_t (*timestamp_us)(void), void (*vsync)(uint32_t frame))
+{
+    if ((pacer == NULL) || (timestamp_us == NULL))                   /* check pacer */
     {
-        handle->debug_print("tm1637: write failed.\n");         /* write failed */
-
-        return 1;                                               /* return error */
+        return 2;                                                    /* return error */
     }
 
-    return 0;                                                   /* success return 0 */
+    memset(pacer, 0, sizeof(tm1637_pacer_t));                        /* clear the pacer */
+    pacer->timestamp_us = timestamp_us;                              /* set timestamp_us */
+    pacer->vsync = vsync;                                            /* set vsync */
+    pacer->period_us = 1000000 / TM1637_PACER_DEFAULT_FPS;           /* set default period */
+    pacer->share = TM1637_PACER_DEFAULT_SHARE;                       /* set default share */
+    a_tm1637_pacer_budget(pacer);                                    /* update budget */
+    pacer->frame_start_us = timestamp_us();                          /* first frame starts now */
+
+    return 0;                                                        /* success return 0 */
 }
 
 /**
- * @brief      get display status
- * @param[in]  *handle points to a tm1637 handle structure
- * @param[out] *enable points to a bool value buffer
- * @return     status code
- *             - 0 success
- *             - 2 handle is NULL
- *             - 3 handle is not initialized
- * @note       none
+ * @brief     set the pacer lock
+ * @param[in] *pacer points to a tm1637 pacer structure
+ * @param[in] *lock points to a lock function, NULL means no lock
+ * @param[in] *unlock points to an unlock function, NULL means no lock
+ * @return    status code
+ *            - 0 success
+ *            - 2 pacer is NULL
+ *            - 4 only one of lock and unlock is NULL
+ * @note      the pacer lock is taken inside the handle lock of every paced display and by the pacer functions,
+ *            it is required once tm1637_pacer_tick or the paced displays run in more than one task,
+ *            without it the pacer and all its displays must be used from one context
  */
-uint8_t tm1637_get_display(tm1637_handle_t *handle, tm1637_bool_t *enable)
+uint8_t tm1637_pacer_set_lock(tm1637_pacer_t *pacer, uint8_t (*lock)(void), void (*unlock)(void))
 {
-    if (handle == NULL)                                                 /* check handle */
+    if (pacer == NULL)                                  /* check pacer */
     {
-        return 2;                                                       /* return error */
+        return 2;                                       /* return error */
     }
-    if (handle->inited != 1)                                            /* check handle initialization */
+    if ((lock == NULL) != (unlock == NULL))             /* check the pair */
     {
-        return 3;                                                       /* return error */
+        return 4;                                       /* return error */
     }
 
-    *enable = (tm1637_bool_t)((handle->display_conf >> 3) & 0x01);      /* get bool */
+    pacer->lock = lock;                                 /* set lock */
+    pacer->unlock = unlock;                             /* set unlock */
 
-    return 0;                                                           /* success return 0 */
+    return 0;                                           /* success return 0 */
 }
 
 /**
- * @brief     set address mode
- * @param[in] *handle points to a tm1637 handle structure
- * @param[in] mode is the address mode
+ * @brief     set the max frame rate
+ * @param[in] *pacer points to a tm1637 pacer structure
+ * @param[in] fps is the max frames per second
  * @return    status code
  *            - 0 success
- *            - 1 set address mode failed
- *            - 2 handle is NULL
- *            - 3 handle is not initialized
- * @note      none
+ *            - 1 lock failed
+ *            - 2 pacer is NULL
+ *            - 4 fps is invalid
+ * @note      1 <= fps <= 1000
  */
-uint8_t tm1637_set_address_mode(tm1637_handle_t *handle, tm1637_address_mode_t mode)
+uint8_t tm1637_pacer_set_fps(tm1637_pacer_t *pacer, uint16_t fps)
 {
-    uint8_t cmd;
-
-    if (handle == NULL)                                         /* check handle */
+    if (pacer == NULL)                                  /* check pacer */
     {
-        return 2;                                               /* return error */
+        return 2;                                       /* return error */
     }
-    if (handle->inited != 1)                                    /* check handle initialization */
+    if ((fps == 0) || (fps > 1000))                     /* check fps */
     {
-        return 3;                                               /* return error */
+        return 4;                                       /* return error */
     }
 
-    handle->data_conf &= ~(1 << 2);                             /* clear settings */
-    handle->data_conf |= mode << 2;                             /* set address mode */
-    cmd = TM1637_COMMAND_DATA | handle->data_conf;              /* set the command */
-    if (a_tm1637_write(handle, cmd, NULL, 0) != 0)              /* write the command */
+    if (a_tm1637_pacer_lock(pacer) != 0)                /* lock */
     {
-        handle->debug_print("tm1637: write failed.\n");         /* write failed */
-
-        return 1;                                               /* return error */
+        return 1;                                       /* return error */
     }
+    pacer->period_us = 1000000 / fps;                   /* set period */
+    a_tm1637_pacer_budget(pacer);                       /* update budget */
+    a_tm1637_pacer_unlock(pacer);                       /* unlock */
 
-    return 0;                                                   /* success return 0 */
+    return 0;                                           /* success return 0 */
 }
 
 /**
- * @brief      get address mode
- * @param[in]  *handle points to a tm1637 handle structure
- * @param[out] *mode points to an address mode buffer
+ * @brief      get the max frame rate
+ * @param[in]  *pacer points to a tm1637 pacer structure
+ * @param[out] *fps points to a frames per second buffer
  * @return     status code
  *             - 0 success
- *             - 2 handle is NULL
- *             - 3 handle is not initialized
+ *             - 2 pacer is NULL
  * @note       none
  */
-uint8_t tm1637_get_address_mode(tm1637_handle_t *handle, tm1637_address_mode_t *mode)
+uint8_t tm1637_pacer_get_fps(tm1637_pacer_t *pacer, uint16_t *fps)
 {
-    if (handle == NULL)                                                      /* check handle */
+    if (pacer == NULL)                                  /* check pacer */
     {
-        return 2;                                                            /* return error */
-    }
-    if (handle->inited != 1)                                                 /* check handle initialization */
-    {
-        return 3;                                                            /* return error */
+        return 2;                                       /* return error */
     }
 
-    *mode = (tm1637_address_mode_t)((handle->data_conf >> 2) & 0x01);        /* get address mode */
+    *fps = (uint16_t)(1000000 / pacer->period_us);      /* get fps */
 
-    return 0;                                                                /* success return 0 */
+    return 0;                                           /* success return 0 */
 }
 
 /**
- * @brief     enable or disable test mode
- * @param[in] *handle points to a tm1637 handle structure
- * @param[in] enable is a bool value
+ * @brief     set the max bus time share
+ * @param[in] *pacer points to a tm1637 pacer structure
+ * @param[in] percent is the max share of each frame period the displays may spend on the bus
  * @return    status code
  *            - 0 success
- *            - 1 set test mode failed
- *            - 2 handle is NULL
- *            - 3 handle is not initialized
- * @note      none
+ *            - 1 lock failed
+ *            - 2 pacer is NULL
+ *            - 4 percent is invalid
+ * @note      1 <= percent <= 100
  */
-uint8_t tm1637_set_test_mode(tm1637_handle_t *handle, tm1637_bool_t enable)
+uint8_t tm1637_pacer_set_bus_share(tm1637_pacer_t *pacer, uint8_t percent)
 {
-    uint8_t cmd;
-
-    if (handle == NULL)                                         /* check handle */
+    if (pacer == NULL)                                  /* check pacer */
     {
-        return 2;                                               /* return error */
+        return 2;                                       /* return error */
     }
-    if (handle->inited != 1)                                    /* check handle initialization */
+    if ((percent == 0) || (percent > 100))              /* check percent */
     {
-        return 3;                                               /* return error */
+        return 4;                                       /* return error */
     }
 
-    handle->data_conf &= ~(1 << 3);                             /* clear settings */
-    handle->data_conf |= enable << 3;                           /* set test mode */
-    cmd = TM1637_COMMAND_DATA | handle->data_conf;              /* set the command */
-    if (a_tm1637_write(handle, cmd, NULL, 0) != 0)              /* write the command */
+    if (a_tm1637_pacer_lock(pacer) != 0)                /* lock */
     {
-        handle->debug_print("tm1637: write failed.\n");         /* write failed */
-
-        return 1;                                               /* return error */
+        return 1;                                       /* return error */
     }
+    pacer->share = percent;                             /* set share */
+    a_tm1637_pacer_budget(pacer);                       /* update budget */
+    a_tm1637_pacer_unlock(pacer);                       /* unlock */
 
-    return 0;                                                   /* success return 0 */
+    return 0;                                           /* success return 0 */
 }
 
 /**
- * @brief      get test mode status
- * @param[in]  *handle points to a tm1637 handle structure
- * @param[out] *enable points to a bool value buffer
+ * @brief      get the max bus time share
+ * @param[in]  *pacer points to a tm1637 pacer structure
+ * @param[out] *percent points to a percent buffer
  * @return     status code
  *             - 0 success
- *             - 2 handle is NULL
- *             - 3 handle is not initialized
+ *             - 2 pacer is NULL
  * @note       none
  */
-uint8_t tm1637_get_test_mode(tm1637_handle_t *handle, tm1637_bool_t *enable)
+uint8_t tm1637_pacer_get_bus_share(tm1637_pacer_t *pacer, uint8_t *percent)
 {
-    if (handle == NULL)                                                /* check handle */
-    {
-        return 2;                                                      /* return error */
-    }
-    if (handle->inited != 1)                                           /* check handle initialization */
+    if (pacer == NULL)                                  /* check pacer */
     {
-        return 3;                                                      /* return error */
+        return 2;                                       /* return error */
     }
 
-    *enable = (tm1637_bool_t)((handle->data_conf >> 3) & 0x01);        /* get test mode */
+    *percent = pacer->share;                            /* get share */
 
-    return 0;                                                          /* success return 0 */
+    return 0;                                           /* success return 0 */
 }
 
 /**
- * @brief     write segment
- * @param[in] *handle points to a tm1637 handle structure
- * @param[in] addr is the start address
- * @param[in] *data points to a data buffer
- * @param[in] len is the data length
- * @return    status code
- *            - 0 success
- *            - 1 write segment failed
- *            - 2 handle is NULL
- *            - 3 handle is not initialized
- *            - 4 addr + len > 6
- * @note      none
+ * @brief      advance the pacer
+ * @param[in]  *pacer points to a tm1637 pacer structure
+ * @param[out] *frame points to a frame number buffer, NULL is allowed
+ * @return     status code
+ *             - 0 success
+ *             - 1 lock failed
+ *             - 2 pacer is NULL
+ * @note       call it from the main loop or a timer, when a frame period has elapsed a new frame begins,
+ *             the vsync callback is called and every paced display may flush once more, the vsync
+ *             callback runs after the pacer lock is released so it may write the paced displays
  */
-uint8_t tm1637_write_segment(tm1637_handle_t *handle, uint8_t addr, uint8_t *data, uint8_t len)
+uint8_t tm1637_pacer_tick(tm1637_pacer_t *pacer, uint32_t *frame)
 {
-    uint8_t i;
-    uint8_t cmd;
+    uint32_t now;
+    uint32_t current;
+    uint8_t started = 0;
 
-    if (handle == NULL)                                                 /* check handle */
+    if (pacer == NULL)                                                      /* check pacer */
     {
-        return 2;                                                       /* return error */
+        return 2;                                                           /* return error */
     }
-    if (handle->inited != 1)                                            /* check handle initialization */
+
+    if (a_tm1637_pacer_lock(pacer) != 0)                                    /* lock */
     {
-        return 3;                                                       /* return error */
+        return 1;                                                           /* return error */
     }
-    if (addr + len > 6)                                                 /* check range */
+    now = pacer->timestamp_us();                                            /* get now */
+    if ((now - pacer->frame_start_us) >= pacer->period_us)                  /* frame elapsed */
     {
-        handle->debug_print("tm1637: addr + len > 6.\n");               /* addr + len > 6 */
-
-        return 4;                                                       /* return error */
+        pacer->frame_start_us += pacer->period_us;                          /* next frame */
+        if ((now - pacer->frame_start_us) >= pacer->period_us)              /* fell behind */
+        {
+            pacer->frame_start_us = now;                                    /* resync, missed frames are merged */
+        }
+        pacer->bus_us = 0;                                                  /* reset bus time */
+        pacer->limited = 0;                                                 /* clear limited */
+        pacer->frame++;                                                     /* frame++ */
+        started = 1;                                                        /* a new frame */
     }
-
-    cmd = TM1637_COMMAND_DATA | handle->data_conf;                      /* set the command */
-    if (a_tm1637_write(handle, cmd, NULL, 0) != 0)                      /* write the command */
+    current = pacer->frame;                                                 /* get frame */
+    a_tm1637_pacer_unlock(pacer);                                           /* unlock */
+    if ((started != 0) && (pacer->vsync != NULL))                           /* check vsync */
     {
-        handle->debug_print("tm1637: write failed.\n");                 /* write failed */
-
-        return 1;                                                       /* return error */
+        pacer->vsync(current);                                              /* run vsync */
     }
-    if ((handle->data_conf & (1 << 2)) != 0)                            /* fixed address mode */
+    if (frame != NULL)                                                      /* check frame */
     {
-        for (i = 0; i < len; i++)                                       /* loop all */
-        {
-            cmd = TM1637_COMMAND_ADDRESS | (addr + i);                  /* set the command */
-            if (a_tm1637_write(handle, cmd, &data[i], 1) != 0)          /* write the command */
-            {
-                handle->debug_print("tm1637: write failed.\n");         /* write failed */
-
-                return 1;                                               /* return error */
-            }
-        }
+        *frame = current;                                                   /* get frame */
     }
-    else                                                                /* auto increment 1 mode */
+
+    return 0;                                                               /* success return 0 */
+}
+
+/**
+ * @brief      get the pacer statistics
+ * @param[in]  *pacer points to a tm1637 pacer structure
+ * @param[out] *frames points to a frame counter buffer
+ * @param[out] *over_budget points to an over budget frame counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 lock failed
+ *             - 2 pacer is NULL
+ * @note       none
+ */
+uint8_t tm1637_pacer_get_statistics(tm1637_pacer_t *pacer, uint32_t *frames, uint32_t *over_budget)
+{
+    if (pacer == NULL)                                  /* check pacer */
     {
-        cmd = TM1637_COMMAND_ADDRESS | addr;                            /* set the command */
-        if (a_tm1637_write(handle, cmd, data, len) != 0)                /* write the command */
-        {
-            handle->debug_print("tm1637: write failed.\n");             /* write failed */
+        return 2;                                       /* return error */
+    }
 
-            return 1;                                                   /* return error */
-        }
+    if (a_tm1637_pacer_lock(pacer) != 0)                /* lock */
+    {
+        return 1;                                       /* return error */
     }
+    *frames = pacer->frame;                             /* get frames */
+    *over_budget = pacer->over_budget;                  /* get over budget */
+    a_tm1637_pacer_unlock(pacer);                       /* unlock */
 
-    return 0;                                                           /* success return 0 */
+    return 0;                                           /* success return 0 */
 }
 
 /**
- * @brief     clear segment
+ * @brief     attach a pacer to the scheduler
  * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] *pacer points to an initialized tm1637 pacer structure, NULL detaches
  * @return    status code
  *            - 0 success
- *            - 1 clear segment failed
+ *            - 1 lock failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ *            - 4 scheduler is not attached
+ * @note      a paced display sends its display data at most once per frame and within the bus time budget,
+ *            tm1637_write_segment is merged into the display ram copy so faster frames fold into the next flush
  */
-uint8_t tm1637_clear_segment(tm1637_handle_t *handle)
+uint8_t tm1637_scheduler_set_pacer(tm1637_handle_t *handle, tm1637_pacer_t *pacer)
 {
-    uint8_t i;
-    uint8_t cmd;
-    uint8_t data[6] = {0};
+    tm1637_scheduler_t *scheduler;
 
-    if (handle == NULL)                                                 /* check handle */
+    if (handle == NULL)                                       /* check handle */
     {
-        return 2;                                                       /* return error */
+        return 2;                                             /* return error */
     }
-    if (handle->inited != 1)                                            /* check handle initialization */
+    if (handle->inited != 1)                                  /* check handle initialization */
     {
-        return 3;                                                       /* return error */
+        return 3;                                             /* return error */
     }
-
-    cmd = TM1637_COMMAND_DATA | handle->data_conf;                      /* set the command */
-    if (a_tm1637_write(handle, cmd, NULL, 0) != 0)                      /* write the command */
+    scheduler = a_tm1637_get_scheduler(handle);               /* get scheduler */
+    if (scheduler == NULL)                                    /* check scheduler */
     {
-        handle->debug_print("tm1637: write failed.\n");                 /* write failed */
-
-        return 1;                                                       /* return error */
+        return 4;                                             /* return error */
     }
-    if ((handle->data_conf & (1 << 2)) != 0)                            /* fixed address mode */
-    {
-        for (i = 0; i < 6; i++)                                         /* loop all */
-        {
-            cmd = TM1637_COMMAND_ADDRESS | i;                           /* set the command */
-            if (a_tm1637_write(handle, cmd, data + i, 1) != 0)          /* write the command */
-            {
-                handle->debug_print("tm1637: write failed.\n");         /* write failed */
 
-                return 1;                                               /* return error */
-            }
-        }
+    if (a_tm1637_lock(handle, __func__) != 0)                 /* lock */
+    {
+        return 1;                                             /* return error */
     }
-    else                                                                /* auto increment 1 mode */
+    if (pacer != NULL)                                        /* attach */
     {
-        cmd = TM1637_COMMAND_ADDRESS;                                   /* set the command */
-        if (a_tm1637_write(handle, cmd, data, 6) != 0)                  /* write the command */
+        if (a_tm1637_pacer_lock(pacer) != 0)                  /* lock the pacer */
         {
-            handle->debug_print("tm1637: write failed.\n");             /* write failed */
+            a_tm1637_unlock(handle);                          /* unlock */
 
-            return 1;                                                   /* return error */
+            return 1;                                         /* return error */
         }
+        scheduler->frame = pacer->frame - 1;                  /* may flush in the current frame */
+        a_tm1637_pacer_unlock(pacer);                         /* unlock the pacer */
     }
+    scheduler->pacer = pacer;                                 /* set pacer */
+    a_tm1637_unlock(handle);                                  /* unlock */
 
-    return 0;                                                           /* success return 0 */
-}
-
-/**
- * @brief      read segment
- * @param[in]  *handle points to a tm1637 handle structure
- * @param[out] *seg points to a seg buffer
- * @param[out] *k points to a k buffer
- * @return     status code
- *             - 0 success
- *             - 1 read segment failed
- *             - 2 handle is NULL
- *             - 3 handle is not initialized
- * @note       none
- */
-uint8_t tm1637_read_segment(tm1637_handle_t *handle, uint8_t *seg, uint8_t *k)
-{
-    uint8_t cmd;
-    uint8_t data;
-
-    if (handle == NULL)                                              /* check handle */
-    {
-        return 2;                                                    /* return error */
-    }
-    if (handle->inited != 1)                                         /* check handle initialization */
-    {
-        return 3;                                                    /* return error */
-    }
-
-    cmd = TM1637_COMMAND_DATA | handle->data_conf | (1 << 1);        /* set the command */
-    if (a_tm1637_read(handle, cmd, &data, 1) != 0)                   /* read the command */
-    {
-        handle->debug_print("tm1637: read failed.\n");               /* read failed */
-
-        return 1;                                                    /* return error */
-    }
-    *seg = data & 0x7;                                               /* get seg */
-    *k = (data >> 3) & 0x03;                                         /* get k */
-
-    return 0;                                                        /* success return 0 */
+    return 0;                                                 /* success return 0 */
 }
 
 /**
@@ -683,12 +2757,19 @@ uint8_t tm1637_set_reg(tm1637_handle_t *handle, uint8_t cmd, uint8_t *data, uint
         return 3;                                              /* return error */
     }
 
+    if (a_tm1637_lock(handle, __func__) != 0)                  /* lock */
+    {
+        return 1;                                              /* return error */
+    }
+    a_tm1637_scheduler_invalidate(handle);                     /* unknown chip mode */
     if (a_tm1637_write(handle, cmd, data, len) != 0)           /* write the command */
     {
+        a_tm1637_unlock(handle);                               /* unlock */
         handle->debug_print("tm1637: write failed.\n");        /* write failed */
 
         return 1;                                              /* return error */
     }
+    a_tm1637_unlock(handle);                                   /* unlock */
 
     return 0;                                                  /* success return 0 */
 }
@@ -717,16 +2798,86 @@ uint8_t tm1637_get_reg(tm1637_handle_t *handle, uint8_t cmd, uint8_t *data, uint
         return 3;                                             /* return error */
     }
 
+    if (a_tm1637_lock(handle, __func__) != 0)                 /* lock */
+    {
+        return 1;                                             /* return error */
+    }
+    a_tm1637_scheduler_invalidate(handle);                    /* unknown chip mode */
     if (a_tm1637_read(handle, cmd, data, len) != 0)           /* read the command */
     {
+        a_tm1637_unlock(handle);                              /* unlock */
         handle->debug_print("tm1637: read failed.\n");        /* read failed */
 
         return 1;                                             /* return error */
     }
+    a_tm1637_unlock(handle);                                  /* unlock */
 
     return 0;                                                 /* success return 0 */
 }
 
+/**
+ * @brief     set the trace callback
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] *state points to a tm1637 trace state structure, it may be NULL when trace is NULL
+ * @param[in] *trace points to a trace callback, NULL stops the trace
+ * @param[in] *ctx is the trace context
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle or state is NULL
+ *            - 3 handle is not initialized
+ *            - 4 timestamp_us is NULL
+ *            - 5 trace is disabled
+ * @note      the callback gets every bus transaction and then its api call when the lock is released,
+ *            it runs with the lock held, set it before the handle is shared with other tasks,
+ *            the state is kept by the caller, so a handle which is never traced only holds a pointer
+ */
+uint8_t tm1637_set_trace(tm1637_handle_t *handle, tm1637_trace_state_t *state,
+                         void (*trace)(void *ctx, const tm1637_trace_event_t *event), void *ctx)
+{
+    if (handle == NULL)                                                          /* check handle */
+    {
+        return 2;                                                                /* return error */
+    }
+    if (handle->inited != 1)                                                     /* check handle initialization */
+    {
+        return 3;                                                                /* return error */
+    }
+    if ((trace != NULL) && (a_tm1637_link_has_timestamp_us(handle) == 0))        /* check timestamp_us */
+    {
+        handle->debug_print("tm1637: timestamp_us is null.\n");                  /* timestamp_us is null */
+
+        return 4;                                                                /* return error */
+    }
+
+#if (TM1637_TRACE_FUNCTION == 1)
+    handle->trace = NULL;                                                        /* stop the old trace */
+#endif
+    if (trace == NULL)                                                           /* stop only */
+    {
+        return 0;                                                                /* success return 0 */
+    }
+#if (TM1637_TRACE_FUNCTION == 0)
+    (void)state;                                                                 /* not used */
+    (void)ctx;                                                                   /* not used */
+    handle->debug_print("tm1637: trace is disabled.\n");                         /* trace is disabled */
+
+    return 5;                                                                    /* return error */
+#else
+    if (state == NULL)                                                           /* check state */
+    {
+        return 2;                                                                /* return error */
+    }
+    state->callback = trace;                                                     /* save callback */
+    state->ctx = ctx;                                                            /* save context */
+    state->name = "";                                                            /* no api yet */
+    state->start_us = 0;                                                         /* init 0 */
+    state->wait_us = 0;                                                          /* init 0 */
+    handle->trace = state;                                                       /* save state */
+
+    return 0;                                                                    /* success return 0 */
+#endif
+}
+
 /**
  * @brief      get chip's information
  * @param[out] *info points to a tm1637 info structure
@@ -56,6 +56,33 @@ extern "C"{
  * @{
  */
 
+/**
+ * @brief tm1637 link function definition
+ * @note  1 keeps the per handle function pointers linked by the DRIVER_TM1637_LINK_* macros,
+ *        0 saves eight pointers in every handle, a handle then links a shared const ops table or
+ *        keeps the DRIVER_TM1637_LINK_* functions in a tm1637_link_t linked by DRIVER_TM1637_LINK_FUNCTION
+ */
+#ifndef TM1637_LINK_FUNCTION
+    #define TM1637_LINK_FUNCTION        1        /**< keep the function pointers */
+#endif
+
+/**
+ * @brief tm1637 scheduler function definition
+ * @note  0 drops the scheduler pointer from every handle, the scheduler api is still built and
+ *        tm1637_scheduler_init returns 5
+ */
+#ifndef TM1637_SCHEDULER_FUNCTION
+    #define TM1637_SCHEDULER_FUNCTION        1        /**< keep the scheduler */
+#endif
+
+/**
+ * @brief tm1637 trace function definition
+ * @note  0 drops the trace pointer from every handle, tm1637_set_trace returns 5 for a callback
+ */
+#ifndef TM1637_TRACE_FUNCTION
+    #define TM1637_TRACE_FUNCTION        1        /**< keep the trace */
+#endif
+
 /**
  * @brief tm1637 address mode enumeration definition
  */
@@ -106,17 +133,158 @@ typedef enum
     TM1637_NUMBER_9 = 0x6F,        /**< 9 */
 } tm1637_number_t;
 
+/**
+ * @brief tm1637 scheduler class enumeration definition
+ */
+typedef enum
+{
+    TM1637_SCHEDULER_CLASS_CONFIG  = 0x00,        /**< configuration commands */
+    TM1637_SCHEDULER_CLASS_KEY     = 0x01,        /**< key reads */
+    TM1637_SCHEDULER_CLASS_DISPLAY = 0x02,        /**< display data */
+} tm1637_scheduler_class_t;
+
+/**
+ * @brief tm1637 trace type enumeration definition
+ */
+typedef enum
+{
+    TM1637_TRACE_TYPE_API   = 0x00,        /**< api call */
+    TM1637_TRACE_TYPE_WRITE = 0x01,        /**< bus write */
+    TM1637_TRACE_TYPE_READ  = 0x02,        /**< bus read */
+} tm1637_trace_type_t;
+
+/**
+ * @brief tm1637 pacer structure definition
+ */
+typedef struct tm1637_pacer_s
+{
+    uint32_t (*timestamp_us)(void);        /**< point to a timestamp_us function address */
+    void (*vsync)(uint32_t frame);         /**< point to a vsync callback address */
+    uint8_t (*lock)(void);                 /**< point to a lock function address */
+    void (*unlock)(void);                  /**< point to an unlock function address */
+    uint32_t period_us;                    /**< frame period */
+    uint32_t budget_us;                    /**< bus time budget of each frame */
+    uint32_t frame_start_us;               /**< current frame start timestamp */
+    uint32_t bus_us;                       /**< bus time used in the current frame */
+    uint32_t frame;                        /**< current frame number */
+    uint32_t over_budget;                  /**< frames that ran out of bus time */
+    uint8_t share;                         /**< bus time share in percent */
+    uint8_t limited;                       /**< current frame ran out of bus time flag */
+} tm1637_pacer_t;
+
+/**
+ * @brief tm1637 scheduler structure definition
+ */
+typedef struct tm1637_scheduler_s
+{
+    uint32_t latency_target_us[3];        /**< max latency target of each class */
+    uint32_t pending_since_us[3];         /**< pending timestamp of each class */
+    uint32_t deadline_miss[3];            /**< deadline miss counter of each class */
+    uint32_t served[3];                   /**< served transaction counter of each class */
+    uint32_t window_us;                   /**< write combining window, 0 means disabled */
+    uint32_t max_stale_us;                /**< write combining max staleness, 0 means unlimited */
+    uint32_t last_write_us;               /**< last combined write timestamp */
+    tm1637_pacer_t *pacer;                /**< shared pacer, NULL means not paced */
+    uint32_t frame;                       /**< last flushed pacer frame */
+    uint32_t transaction_us;              /**< recent transaction time, a decaying max */
+    uint8_t pending;                      /**< pending class mask */
+    uint8_t display_conf;                 /**< queued display configure */
+    uint8_t ram[6];                       /**< display ram copy */
+    uint8_t dirty;                        /**< dirty digit mask */
+    uint8_t data_cmd_valid;               /**< data command valid flag */
+    uint8_t commit;                       /**< display flush committed flag */
+    uint8_t key_ready;                    /**< key ready flag */
+    uint8_t seg;                          /**< last read seg */
+    uint8_t k;                            /**< last read k */
+} tm1637_scheduler_t;
+
+/**
+ * @brief tm1637 trace event structure definition
+ */
+typedef struct tm1637_trace_event_s
+{
+    const char *name;         /**< api name */
+    uint32_t start_us;        /**< start timestamp */
+    uint32_t end_us;          /**< end timestamp */
+    uint32_t wait_us;         /**< lock wait of an api call */
+    uint8_t type;             /**< trace type */
+    uint8_t cmd;              /**< command byte of a bus transaction */
+    uint8_t len;              /**< payload length of a bus transaction */
+    uint8_t res;              /**< result of a bus transaction */
+} tm1637_trace_event_t;
+
+/**
+ * @brief tm1637 trace state structure definition
+ */
+typedef struct tm1637_trace_state_s
+{
+    void (*callback)(void *ctx, const tm1637_trace_event_t *event);        /**< trace callback */
+    void *ctx;                                                             /**< trace context */
+    const char *name;                                                      /**< traced api name */
+    uint32_t start_us;                                                     /**< traced api start timestamp */
+    uint32_t wait_us;                                                      /**< traced api lock wait */
+} tm1637_trace_state_t;
+
+/**
+ * @brief tm1637 ops structure definition
+ * @note  it is meant to be a const table in flash shared by every handle on the same kind of bus,
+ *        ctx tells the callbacks which bus or device they serve, timestamp_us, lock and unlock are optional
+ */
+typedef struct tm1637_ops_s
+{
+    uint8_t (*iic_init)(void *ctx);                                                              /**< point to an iic_init function address */
+    uint8_t (*iic_deinit)(void *ctx);                                                            /**< point to an iic_deinit function address */
+    uint8_t (*iic_write_cmd_custom)(void *ctx, uint8_t addr, uint8_t *buf, uint16_t len);        /**< point to an iic_write_cmd_custom function address */
+    uint8_t (*iic_read_cmd_custom)(void *ctx, uint8_t addr, uint8_t *buf, uint16_t len);         /**< point to an iic_read_cmd_custom function address */
+    void (*delay_ms)(void *ctx, uint32_t ms);                                                    /**< point to a delay_ms function address */
+    uint32_t (*timestamp_us)(void *ctx);                                                         /**< point to a timestamp_us function address */
+    uint8_t (*lock)(void *ctx);                                                                  /**< point to a lock function address */
+    void (*unlock)(void *ctx);                                                                   /**< point to an unlock function address */
+} tm1637_ops_t;
+
+#if (TM1637_LINK_FUNCTION == 0)
+/**
+ * @brief tm1637 link structure definition
+ * @note  it keeps the functions of the DRIVER_TM1637_LINK_* macros out of the handle,
+ *        only a handle linked by DRIVER_TM1637_LINK_FUNCTION needs one
+ */
+typedef struct tm1637_link_s
+{
+    uint8_t (*iic_init)(void);                                                        /**< point to an iic_init function address */
+    uint8_t (*iic_deinit)(void);                                                      /**< point to an iic_deinit function address */
+    uint8_t (*iic_write_cmd_custom)(uint8_t addr, uint8_t *buf, uint16_t len);        /**< point to an iic_write_cmd_custom function address */
+    uint8_t (*iic_read_cmd_custom)(uint8_t addr, uint8_t *buf, uint16_t len);         /**< point to an iic_read_cmd_custom function address */
+    void (*delay_ms)(uint32_t ms);                                                    /**< point to a delay_ms function address */
+    uint32_t (*timestamp_us)(void);                                                   /**< point to a timestamp_us function address */
+    uint8_t (*lock)(void);                                                            /**< point to a lock function address */
+    void (*unlock)(void);                                                             /**< point to an unlock function address */
+} tm1637_link_t;
+#endif
+
 /**
  * @brief tm1637 handle structure definition
  */
 typedef struct tm1637_handle_s
 {
+#if (TM1637_LINK_FUNCTION == 1)
     uint8_t (*iic_init)(void);                                                        /**< point to an iic_init function address */
     uint8_t (*iic_deinit)(void);                                                      /**< point to an iic_deinit function address */
     uint8_t (*iic_write_cmd_custom)(uint8_t addr, uint8_t *buf, uint16_t len);        /**< point to an iic_write_cmd_custom function address */
     uint8_t (*iic_read_cmd_custom)(uint8_t addr, uint8_t *buf, uint16_t len);         /**< point to an iic_read_cmd_custom function address */
     void (*delay_ms)(uint32_t ms);                                                    /**< point to a delay_ms function address */
+    uint32_t (*timestamp_us)(void);                                                   /**< point to a timestamp_us function address */
+    uint8_t (*lock)(void);                                                            /**< point to a lock function address */
+    void (*unlock)(void);                                                             /**< point to an unlock function address */
+#endif
     void (*debug_print)(const char *const fmt, ...);                                  /**< point to a debug_print function address */
+    const tm1637_ops_t *ops;                                                          /**< shared ops, NULL means the function pointers */
+    void *ctx;                                                                        /**< ops context, the tm1637_link_t of a handle without ops */
+#if (TM1637_SCHEDULER_FUNCTION == 1)
+    tm1637_scheduler_t *scheduler;                                                    /**< scheduler */
+#endif
+#if (TM1637_TRACE_FUNCTION == 1)
+    tm1637_trace_state_t *trace;                                                      /**< trace state, NULL means not traced */
+#endif
     uint8_t inited;                                                                   /**< inited flag */
     uint8_t display_conf;                                                             /**< display configure */
     uint8_t data_conf;                                                                /**< data configure */
@@ -157,13 +325,41 @@ typedef struct tm1637_info_s
  */
 #define DRIVER_TM1637_LINK_INIT(HANDLE, STRUCTURE)                  memset(HANDLE, 0, sizeof(STRUCTURE))
 
+#if (TM1637_LINK_FUNCTION == 1)
+
+/**
+ * @brief     get the function pointers of a handle
+ * @param[in] HANDLE points to a tm1637 handle structure
+ * @note      the handle keeps them itself
+ */
+#define DRIVER_TM1637_LINK_TARGET(HANDLE)                          (HANDLE)
+
+#else
+
+/**
+ * @brief     link a tm1637_link_t to keep the functions of the DRIVER_TM1637_LINK_* macros
+ * @param[in] HANDLE points to a tm1637 handle structure
+ * @param[in] LINK points to a tm1637 link structure
+ * @note      link it right after DRIVER_TM1637_LINK_INIT, it is the ctx of a handle without ops
+ */
+#define DRIVER_TM1637_LINK_FUNCTION(HANDLE, LINK)                  (HANDLE)->ctx = memset(LINK, 0, sizeof(tm1637_link_t))
+
+/**
+ * @brief     get the function pointers of a handle
+ * @param[in] HANDLE points to a tm1637 handle structure
+ * @note      the tm1637_link_t linked by DRIVER_TM1637_LINK_FUNCTION keeps them
+ */
+#define DRIVER_TM1637_LINK_TARGET(HANDLE)                          ((tm1637_link_t *)((HANDLE)->ctx))
+
+#endif
+
 /**
  * @brief     link iic_init function
  * @param[in] HANDLE points to a tm1637 handle structure
  * @param[in] FUC points to an iic_init function address
  * @note      none
  */
-#define DRIVER_TM1637_LINK_IIC_INIT(HANDLE, FUC)                   (HANDLE)->iic_init = FUC
+#define DRIVER_TM1637_LINK_IIC_INIT(HANDLE, FUC)                   DRIVER_TM1637_LINK_TARGET(HANDLE)->iic_init = FUC
 
 /**
  * @brief     link iic_deinit function
@@ -171,7 +367,7 @@ typedef struct tm1637_info_s
  * @param[in] FUC points to an iic_deinit function address
  * @note      none
  */
-#define DRIVER_TM1637_LINK_IIC_DEINIT(HANDLE, FUC)                 (HANDLE)->iic_deinit = FUC
+#define DRIVER_TM1637_LINK_IIC_DEINIT(HANDLE, FUC)                 DRIVER_TM1637_LINK_TARGET(HANDLE)->iic_deinit = FUC
 
 /**
  * @brief     link iic_write_cmd_custom function
@@ -179,7 +375,7 @@ typedef struct tm1637_info_s
  * @param[in] FUC points to an iic_write_cmd_custom function address
  * @note      none
  */
-#define DRIVER_TM1637_LINK_IIC_WRITE_COMMAND_CUSTOM(HANDLE, FUC)   (HANDLE)->iic_write_cmd_custom = FUC
+#define DRIVER_TM1637_LINK_IIC_WRITE_COMMAND_CUSTOM(HANDLE, FUC)   DRIVER_TM1637_LINK_TARGET(HANDLE)->iic_write_cmd_custom = FUC
 
 /**
  * @brief     link iic_read_cmd_custom function
@@ -187,7 +383,7 @@ typedef struct tm1637_info_s
  * @param[in] FUC points to an iic_read_cmd_custom function address
  * @note      none
  */
-#define DRIVER_TM1637_LINK_IIC_READ_COMMAND_CUSTOM(HANDLE, FUC)    (HANDLE)->iic_read_cmd_custom = FUC
+#define DRIVER_TM1637_LINK_IIC_READ_COMMAND_CUSTOM(HANDLE, FUC)    DRIVER_TM1637_LINK_TARGET(HANDLE)->iic_read_cmd_custom = FUC
 
 /**
  * @brief     link delay_ms function
@@ -195,7 +391,7 @@ typedef struct tm1637_info_s
  * @param[in] FUC points to a delay_ms function address
  * @note      none
  */
-#define DRIVER_TM1637_LINK_DELAY_MS(HANDLE, FUC)                   (HANDLE)->delay_ms = FUC
+#define DRIVER_TM1637_LINK_DELAY_MS(HANDLE, FUC)                   DRIVER_TM1637_LINK_TARGET(HANDLE)->delay_ms = FUC
 
 /**
  * @brief     link debug_print function
@@ -205,6 +401,46 @@ typedef struct tm1637_info_s
  */
 #define DRIVER_TM1637_LINK_DEBUG_PRINT(HANDLE, FUC)                (HANDLE)->debug_print = FUC
 
+/**
+ * @brief     link timestamp_us function
+ * @param[in] HANDLE points to a tm1637 handle structure
+ * @param[in] FUC points to a timestamp_us function address
+ * @note      only the scheduler needs this function
+ */
+#define DRIVER_TM1637_LINK_TIMESTAMP_US(HANDLE, FUC)               DRIVER_TM1637_LINK_TARGET(HANDLE)->timestamp_us = FUC
+
+/**
+ * @brief     link lock function
+ * @param[in] HANDLE points to a tm1637 handle structure
+ * @param[in] FUC points to a lock function address
+ * @note      optional, it is held for a whole api call and may arbitrate a bus shared with other devices
+ */
+#define DRIVER_TM1637_LINK_LOCK(HANDLE, FUC)                       DRIVER_TM1637_LINK_TARGET(HANDLE)->lock = FUC
+
+/**
+ * @brief     link unlock function
+ * @param[in] HANDLE points to a tm1637 handle structure
+ * @param[in] FUC points to an unlock function address
+ * @note      optional, it must be linked together with the lock function
+ */
+#define DRIVER_TM1637_LINK_UNLOCK(HANDLE, FUC)                     DRIVER_TM1637_LINK_TARGET(HANDLE)->unlock = FUC
+
+/**
+ * @brief     link a shared ops table
+ * @param[in] HANDLE points to a tm1637 handle structure
+ * @param[in] OPS points to a const tm1637 ops structure
+ * @note      the ops table replaces the linked function pointers, debug_print is still linked by itself
+ */
+#define DRIVER_TM1637_LINK_OPS(HANDLE, OPS)                        (HANDLE)->ops = OPS
+
+/**
+ * @brief     link the ops context
+ * @param[in] HANDLE points to a tm1637 handle structure
+ * @param[in] CTX points to the ops context
+ * @note      every ops callback gets it as the first argument
+ */
+#define DRIVER_TM1637_LINK_CTX(HANDLE, CTX)                        (HANDLE)->ctx = CTX
+
 /**
  * @}
  */
@@ -243,11 +479,11 @@ uint8_t tm1637_init(tm1637_handle_t *handle);
  * @param[in] *handle points to a tm1637 handle structure
  * @return    status code
  *            - 0 success
- *            - 1 iic deinit failed
+ *            - 1 iic deinit failed or lock failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
  *            - 4 power down failed
- * @note      none
+ * @note      the iic deinit runs with the lock held, so no other caller sees a closed bus
  */
 uint8_t tm1637_deinit(tm1637_handle_t *handle);
 
@@ -259,7 +495,7 @@ uint8_t tm1637_deinit(tm1637_handle_t *handle);
  *            - 1 clear segment failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      with write combining or a pacer it is merged like tm1637_write_segment
  */
 uint8_t tm1637_clear_segment(tm1637_handle_t *handle);
 
@@ -275,10 +511,28 @@ uint8_t tm1637_clear_segment(tm1637_handle_t *handle);
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
  *            - 4 addr + len > 6
- * @note      none
+ * @note      with write combining or a pacer the digits are only merged into the display ram copy and nothing
+ *            reaches the chip until the application calls tm1637_scheduler_run, tm1637_flush_step or
+ *            tm1637_scheduler_commit, only a later write past max_stale_us flushes on its own
  */
 uint8_t tm1637_write_segment(tm1637_handle_t *handle, uint8_t addr, uint8_t *data, uint8_t len);
 
+/**
+ * @brief     write the masked digits of a frame
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] *data points to a 6 digits frame buffer
+ * @param[in] mask is the digit mask, bit n selects data[n]
+ * @return    status code
+ *            - 0 success
+ *            - 1 write segment failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 mask is invalid
+ * @note      the data command is sent once and each contiguous run of the mask is one burst
+ *            in the auto increment 1 mode, with write combining or a pacer it is merged like tm1637_write_segment
+ */
+uint8_t tm1637_write_segment_mask(tm1637_handle_t *handle, uint8_t *data, uint8_t mask);
+
 /**
  * @brief      read segment
  * @param[in]  *handle points to a tm1637 handle structure
@@ -302,7 +556,7 @@ uint8_t tm1637_read_segment(tm1637_handle_t *handle, uint8_t *seg, uint8_t *k);
  *            - 1 set pulse width failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      a conf queued on the scheduler takes the new width
  */
 uint8_t tm1637_set_pulse_width(tm1637_handle_t *handle, tm1637_pulse_width_t width);
 
@@ -327,7 +581,7 @@ uint8_t tm1637_get_pulse_width(tm1637_handle_t *handle, tm1637_pulse_width_t *wi
  *            - 1 set display failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      a conf queued on the scheduler takes the new display bit
  */
 uint8_t tm1637_set_display(tm1637_handle_t *handle, tm1637_bool_t enable);
 
@@ -393,6 +647,364 @@ uint8_t tm1637_set_test_mode(tm1637_handle_t *handle, tm1637_bool_t enable);
  */
 uint8_t tm1637_get_test_mode(tm1637_handle_t *handle, tm1637_bool_t *enable);
 
+/**
+ * @}
+ */
+
+/**
+ * @defgroup tm1637_scheduler_driver tm1637 scheduler driver function
+ * @brief    tm1637 scheduler driver modules
+ * @ingroup  tm1637_driver
+ * @{
+ */
+
+/**
+ * @brief     attach a scheduler to the handle
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] *scheduler points to a tm1637 scheduler structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock failed
+ *            - 2 handle or scheduler is NULL
+ *            - 3 handle is not initialized
+ *            - 4 timestamp_us is NULL
+ *            - 5 scheduler is disabled
+ * @note      the scheduler serves configuration commands, key reads and display data by the earliest deadline,
+ *            one bus transaction per call of tm1637_scheduler_run, TM1637_SCHEDULER_FUNCTION 0 disables it
+ */
+uint8_t tm1637_scheduler_init(tm1637_handle_t *handle, tm1637_scheduler_t *scheduler);
+
+/**
+ * @brief     detach the scheduler from the handle
+ * @param[in] *handle points to a tm1637 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 scheduler is not attached
+ * @note      pending work is dropped
+ */
+uint8_t tm1637_scheduler_deinit(tm1637_handle_t *handle);
+
+/**
+ * @brief     set the max latency target of a scheduler class
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] cls is the scheduler class
+ * @param[in] us is the max latency in microseconds
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 scheduler is not attached
+ *            - 5 class is invalid
+ * @note      none
+ */
+uint8_t tm1637_scheduler_set_latency_target(tm1637_handle_t *handle, tm1637_scheduler_class_t cls, uint32_t us);
+
+/**
+ * @brief      get the max latency target of a scheduler class
+ * @param[in]  *handle points to a tm1637 handle structure
+ * @param[in]  cls is the scheduler class
+ * @param[out] *us points to a microseconds buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 scheduler is not attached
+ *             - 5 class is invalid
+ * @note       none
+ */
+uint8_t tm1637_scheduler_get_latency_target(tm1637_handle_t *handle, tm1637_scheduler_class_t cls, uint32_t *us);
+
+/**
+ * @brief     set the write combining deadlines
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] window_us is the coalescing window in microseconds, 0 disables write combining
+ * @param[in] max_stale_us is the max staleness in microseconds, 0 means unlimited
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 scheduler is not attached
+ *            - 5 max_stale_us is shorter than window_us
+ * @note      when enabled, tm1637_write_segment, tm1637_write_segment_mask and tm1637_clear_segment only update
+ *            the display ram copy and nothing reaches the chip until the application calls tm1637_scheduler_run
+ *            or tm1637_flush_step after no write arrived for window_us, or calls tm1637_scheduler_commit,
+ *            a write arriving after the oldest digit waited max_stale_us flushes on its own
+ */
+uint8_t tm1637_scheduler_set_write_combining(tm1637_handle_t *handle, uint32_t window_us, uint32_t max_stale_us);
+
+/**
+ * @brief      get the write combining deadlines
+ * @param[in]  *handle points to a tm1637 handle structure
+ * @param[out] *window_us points to a coalescing window buffer
+ * @param[out] *max_stale_us points to a max staleness buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 scheduler is not attached
+ * @note       none
+ */
+uint8_t tm1637_scheduler_get_write_combining(tm1637_handle_t *handle, uint32_t *window_us, uint32_t *max_stale_us);
+
+/**
+ * @brief     commit the combined writes
+ * @param[in] *handle points to a tm1637 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 commit failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 scheduler is not attached
+ * @note      all dirty digits are sent before this function returns
+ */
+uint8_t tm1637_scheduler_commit(tm1637_handle_t *handle);
+
+/**
+ * @brief     queue a segment write
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] addr is the start address
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 scheduler is not attached
+ *            - 5 addr + len > 6
+ * @note      queued digits are merged into the display ram copy, the latest value wins
+ */
+uint8_t tm1637_scheduler_write_segment(tm1637_handle_t *handle, uint8_t addr, uint8_t *data, uint8_t len);
+
+/**
+ * @brief     queue a key read
+ * @param[in] *handle points to a tm1637 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 scheduler is not attached
+ * @note      the result is fetched by tm1637_scheduler_get_key
+ */
+uint8_t tm1637_scheduler_read_segment(tm1637_handle_t *handle);
+
+/**
+ * @brief      get the last key read result
+ * @param[in]  *handle points to a tm1637 handle structure
+ * @param[out] *seg points to a seg buffer
+ * @param[out] *k points to a k buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 lock failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 scheduler is not attached
+ *             - 5 no new key result
+ * @note       none
+ */
+uint8_t tm1637_scheduler_get_key(tm1637_handle_t *handle, uint8_t *seg, uint8_t *k);
+
+/**
+ * @brief     queue a pulse width change
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] width is the pulse width
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 scheduler is not attached
+ * @note      none
+ */
+uint8_t tm1637_scheduler_set_pulse_width(tm1637_handle_t *handle, tm1637_pulse_width_t width);
+
+/**
+ * @brief     queue a display enable or disable
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] enable is a bool value
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 scheduler is not attached
+ * @note      none
+ */
+uint8_t tm1637_scheduler_set_display(tm1637_handle_t *handle, tm1637_bool_t enable);
+
+/**
+ * @brief      run one scheduled bus transaction
+ * @param[in]  *handle points to a tm1637 handle structure
+ * @param[out] *pending points to a pending class mask buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 run failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 scheduler is not attached
+ * @note       bit n of pending is set when class n still has work after this call
+ */
+uint8_t tm1637_scheduler_run(tm1637_handle_t *handle, uint8_t *pending);
+
+/**
+ * @brief      run the scheduled transactions that fit in a time budget
+ * @param[in]  *handle points to a tm1637 handle structure
+ * @param[in]  budget_us is the execution budget in microseconds
+ * @param[out] *remaining points to a remaining transaction counter buffer, NULL is allowed
+ * @return     status code
+ *             - 0 success
+ *             - 1 flush step failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 scheduler is not attached
+ * @note       only whole transactions are run and the next call resumes with the next one, the first ready
+ *             transaction always runs so a budget shorter than one transaction still makes progress,
+ *             a further one is started only when the recent transaction time still fits, it follows
+ *             a longer transaction at once and decays towards shorter ones,
+ *             remaining also counts work held back by write combining or the pacer
+ */
+uint8_t tm1637_flush_step(tm1637_handle_t *handle, uint32_t budget_us, uint8_t *remaining);
+
+/**
+ * @brief      get the scheduler statistics of a class
+ * @param[in]  *handle points to a tm1637 handle structure
+ * @param[in]  cls is the scheduler class
+ * @param[out] *served points to a served transaction counter buffer
+ * @param[out] *miss points to a deadline miss counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 scheduler is not attached
+ *             - 5 class is invalid
+ * @note       none
+ */
+uint8_t tm1637_scheduler_get_statistics(tm1637_handle_t *handle, tm1637_scheduler_class_t cls, uint32_t *served, uint32_t *miss);
+
+/**
+ * @brief     initialize a pacer
+ * @param[in] *pacer points to a tm1637 pacer structure
+ * @param[in] *timestamp_us points to a timestamp_us function
+ * @param[in] *vsync points to a vsync callback, NULL means no callback
+ * @return    status code
+ *            - 0 success
+ *            - 2 pacer or timestamp_us is NULL
+ * @note      one pacer is shared by all displays on a bus, the default is 50 fps and 100% bus time share,
+ *            it has no lock until tm1637_pacer_set_lock is called
+ */
+uint8_t tm1637_pacer_init(tm1637_pacer_t *pacer, uint32_t (*timestamp_us)(void), void (*vsync)(uint32_t frame));
+
+/**
+ * @brief     set the pacer lock
+ * @param[in] *pacer points to a tm1637 pacer structure
+ * @param[in] *lock points to a lock function, NULL means no lock
+ * @param[in] *unlock points to an unlock function, NULL means no lock
+ * @return    status code
+ *            - 0 success
+ *            - 2 pacer is NULL
+ *            - 4 only one of lock and unlock is NULL
+ * @note      the pacer lock is taken inside the handle lock of every paced display and by the pacer functions,
+ *            it is required once tm1637_pacer_tick or the paced displays run in more than one task,
+ *            without it the pacer and all its displays must be used from one context
+ */
+uint8_t tm1637_pacer_set_lock(tm1637_pacer_t *pacer, uint8_t (*lock)(void), void (*unlock)(void));
+
+/**
+ * @brief     set the max frame rate
+ * @param[in] *pacer points to a tm1637 pacer structure
+ * @param[in] fps is the max frames per second
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock failed
+ *            - 2 pacer is NULL
+ *            - 4 fps is invalid
+ * @note      1 <= fps <= 1000
+ */
+uint8_t tm1637_pacer_set_fps(tm1637_pacer_t *pacer, uint16_t fps);
+
+/**
+ * @brief      get the max frame rate
+ * @param[in]  *pacer points to a tm1637 pacer structure
+ * @param[out] *fps points to a frames per second buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 pacer is NULL
+ * @note       none
+ */
+uint8_t tm1637_pacer_get_fps(tm1637_pacer_t *pacer, uint16_t *fps);
+
+/**
+ * @brief     set the max bus time share
+ * @param[in] *pacer points to a tm1637 pacer structure
+ * @param[in] percent is the max share of each frame period the displays may spend on the bus
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock failed
+ *            - 2 pacer is NULL
+ *            - 4 percent is invalid
+ * @note      1 <= percent <= 100
+ */
+uint8_t tm1637_pacer_set_bus_share(tm1637_pacer_t *pacer, uint8_t percent);
+
+/**
+ * @brief      get the max bus time share
+ * @param[in]  *pacer points to a tm1637 pacer structure
+ * @param[out] *percent points to a percent buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 pacer is NULL
+ * @note       none
+ */
+uint8_t tm1637_pacer_get_bus_share(tm1637_pacer_t *pacer, uint8_t *percent);
+
+/**
+ * @brief      advance the pacer
+ * @param[in]  *pacer points to a tm1637 pacer structure
+ * @param[out] *frame points to a frame number buffer, NULL is allowed
+ * @return     status code
+ *             - 0 success
+ *             - 1 lock failed
+ *             - 2 pacer is NULL
+ * @note       call it from the main loop or a timer, when a frame period has elapsed a new frame begins,
+ *             the vsync callback is called and every paced display may flush once more, the vsync
+ *             callback runs after the pacer lock is released so it may write the paced displays
+ */
+uint8_t tm1637_pacer_tick(tm1637_pacer_t *pacer, uint32_t *frame);
+
+/**
+ * @brief      get the pacer statistics
+ * @param[in]  *pacer points to a tm1637 pacer structure
+ * @param[out] *frames points to a frame counter buffer
+ * @param[out] *over_budget points to an over budget frame counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 lock failed
+ *             - 2 pacer is NULL
+ * @note       none
+ */
+uint8_t tm1637_pacer_get_statistics(tm1637_pacer_t *pacer, uint32_t *frames, uint32_t *over_budget);
+
+/**
+ * @brief     attach a pacer to the scheduler
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] *pacer points to an initialized tm1637 pacer structure, NULL detaches
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 scheduler is not attached
+ * @note      a paced display sends its display data at most once per frame and within the bus time budget,
+ *            tm1637_write_segment is merged into the display ram copy so faster frames fold into the next flush
+ */
+uint8_t tm1637_scheduler_set_pacer(tm1637_handle_t *handle, tm1637_pacer_t *pacer);
+
 /**
  * @}
  */
@@ -434,6 +1046,25 @@ uint8_t tm1637_set_reg(tm1637_handle_t *handle, uint8_t cmd, uint8_t *data, uint
  */
 uint8_t tm1637_get_reg(tm1637_handle_t *handle, uint8_t cmd, uint8_t *data, uint8_t len);
 
+/**
+ * @brief     set the trace callback
+ * @param[in] *handle points to a tm1637 handle structure
+ * @param[in] *state points to a tm1637 trace state structure, it may be NULL when trace is NULL
+ * @param[in] *trace points to a trace callback, NULL stops the trace
+ * @param[in] *ctx is the trace context
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle or state is NULL
+ *            - 3 handle is not initialized
+ *            - 4 timestamp_us is NULL
+ *            - 5 trace is disabled
+ * @note      the callback gets every bus transaction and then its api call when the lock is released,
+ *            it runs with the lock held, set it before the handle is shared with other tasks,
+ *            the state is kept by the caller, so a handle which is never traced only holds a pointer
+ */
+uint8_t tm1637_set_trace(tm1637_handle_t *handle, tm1637_trace_state_t *state,
+                         void (*trace)(void *ctx, const tm1637_trace_event_t *event), void *ctx);
+
 /**
  * @}
  */
@@ -0,0 +1,367 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_diff.c
+ * @brief     driver tm1637 diff source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_tm1637_diff.h"
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief diff block definition
+ */
+#define TM1637_DIFF_BLOCK_MODULE        16             /**< 16 modules, 96 bytes */
+#define TM1637_DIFF_BLOCK_BYTE          (16 * 6)       /**< 3 avx2, 6 sse2 or 12 portable words */
+
+/**
+ * @brief run table, entry mask is {run number, addr 0, len 0, addr 1, len 1} with runs closer than TM1637_DIFF_MERGE_GAP digits merged
+ */
+static const uint8_t gc_tm1637_diff_run[64][5] =
+{
+    {0, 0, 0, 0, 0}, {1, 0, 1, 0, 0}, {1, 1, 1, 0, 0}, {1, 0, 2, 0, 0},
+    {1, 2, 1, 0, 0}, {1, 0, 3, 0, 0}, {1, 1, 2, 0, 0}, {1, 0, 3, 0, 0},
+    {1, 3, 1, 0, 0}, {1, 0, 4, 0, 0}, {1, 1, 3, 0, 0}, {1, 0, 4, 0, 0},
+    {1, 2, 2, 0, 0}, {1, 0, 4, 0, 0}, {1, 1, 3, 0, 0}, {1, 0, 4, 0, 0},
+    {1, 4, 1, 0, 0}, {2, 0, 1, 4, 1}, {1, 1, 4, 0, 0}, {1, 0, 5, 0, 0},
+    {1, 2, 3, 0, 0}, {1, 0, 5, 0, 0}, {1, 1, 4, 0, 0}, {1, 0, 5, 0, 0},
+    {1, 3, 2, 0, 0}, {1, 0, 5, 0, 0}, {1, 1, 4, 0, 0}, {1, 0, 5, 0, 0},
+    {1, 2, 3, 0, 0}, {1, 0, 5, 0, 0}, {1, 1, 4, 0, 0}, {1, 0, 5, 0, 0},
+    {1, 5, 1, 0, 0}, {2, 0, 1, 5, 1}, {2, 1, 1, 5, 1}, {2, 0, 2, 5, 1},
+    {1, 2, 4, 0, 0}, {1, 0, 6, 0, 0}, {1, 1, 5, 0, 0}, {1, 0, 6, 0, 0},
+    {1, 3, 3, 0, 0}, {1, 0, 6, 0, 0}, {1, 1, 5, 0, 0}, {1, 0, 6, 0, 0},
+    {1, 2, 4, 0, 0}, {1, 0, 6, 0, 0}, {1, 1, 5, 0, 0}, {1, 0, 6, 0, 0},
+    {1, 4, 2, 0, 0}, {2, 0, 1, 4, 2}, {1, 1, 5, 0, 0}, {1, 0, 6, 0, 0},
+    {1, 2, 4, 0, 0}, {1, 0, 6, 0, 0}, {1, 1, 5, 0, 0}, {1, 0, 6, 0, 0},
+    {1, 3, 3, 0, 0}, {1, 0, 6, 0, 0}, {1, 1, 5, 0, 0}, {1, 0, 6, 0, 0},
+    {1, 2, 4, 0, 0}, {1, 0, 6, 0, 0}, {1, 1, 5, 0, 0}, {1, 0, 6, 0, 0}
+};
+
+#if !defined(__AVX2__) && !defined(__SSE2__)
+/**
+ * @brief     get the changed bytes of 8 bytes
+ * @param[in] *a points to 8 bytes
+ * @param[in] *b points to 8 bytes
+ * @return    bit i is set when byte i differs
+ * @note      none
+ */
+static uint8_t a_tm1637_diff_word(const uint8_t *a, const uint8_t *b)
+{
+    uint64_t x;
+    uint64_t y;
+
+    memcpy(&x, a, 8);                                                                   /* unaligned safe load */
+    memcpy(&y, b, 8);                                                                   /* unaligned safe load */
+    x ^= y;                                                                             /* non zero bytes changed */
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    x = __builtin_bswap64(x);                                                           /* memory order */
+#endif
+    x = (x | ((x & 0x7F7F7F7F7F7F7F7FULL) + 0x7F7F7F7F7F7F7F7FULL)) &
+        0x8080808080808080ULL;                                                          /* high bit of each changed byte */
+
+    return (uint8_t)(((x >> 7) * 0x0102040810204080ULL) >> 56);                         /* gather */
+}
+#endif
+
+/**
+ * @brief      get the changed digits of one block
+ * @param[in]  *frame points to 96 bytes of the new framebuffer
+ * @param[in]  *sent points to 96 bytes of the sent framebuffer
+ * @param[out] *mask points to a 16 modules changed digit bitmap buffer
+ * @return     0 when the block is clean, otherwise 1
+ * @note       none
+ */
+static uint8_t a_tm1637_diff_block(const uint8_t *frame, const uint8_t *sent, uint8_t *mask)
+{
+    uint64_t lo;
+    uint64_t hi;
+    uint8_t i;
+#if defined(__AVX2__)
+    uint32_t m[3];
+
+    for (i = 0; i < 3; i++)                                                             /* 32 bytes at a time */
+    {
+        m[i] = ~(uint32_t)_mm256_movemask_epi8(
+                   _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(frame + i * 32)),
+                                     _mm256_loadu_si256((const __m256i *)(sent + i * 32))));    /* changed bytes */
+    }
+    lo = m[0] | ((uint64_t)(m[1] & 0xFFFF) << 32);                                      /* modules 0 - 7 */
+    hi = (m[1] >> 16) | ((uint64_t)m[2] << 16);                                         /* modules 8 - 15 */
+#elif defined(__SSE2__)
+    uint64_t m[6];
+
+    for (i = 0; i < 6; i++)                                                             /* 16 bytes at a time */
+    {
+        m[i] = (uint16_t)~_mm_movemask_epi8(
+                   _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(frame + i * 16)),
+                                  _mm_loadu_si128((const __m128i *)(sent + i * 16))));  /* changed bytes */
+    }
+    lo = m[0] | (m[1] << 16) | (m[2] << 32);                                            /* modules 0 - 7 */
+    hi = m[3] | (m[4] << 16) | (m[5] << 32);                                            /* modules 8 - 15 */
+#else
+    lo = 0;                                                                             /* init 0 */
+    hi = 0;                                                                             /* init 0 */
+    for (i = 0; i < 6; i++)                                                             /* 8 bytes at a time */
+    {
+        lo |= (uint64_t)a_tm1637_diff_word(frame + i * 8, sent + i * 8) << (i * 8);     /* modules 0 - 7 */
+        hi |= (uint64_t)a_tm1637_diff_word(frame + 48 + i * 8, sent + 48 + i * 8) << (i * 8);    /* modules 8 - 15 */
+    }
+#endif
+    if ((lo | hi) == 0)                                                                 /* check the block */
+    {
+        memset(mask, 0, TM1637_DIFF_BLOCK_MODULE);                                      /* clean */
+
+        return 0;                                                                       /* return clean */
+    }
+    for (i = 0; i < 8; i++)                                                             /* split at the 6 grid boundaries */
+    {
+        mask[i] = (uint8_t)((lo >> (i * 6)) & 0x3F);                                    /* module i */
+        mask[i + 8] = (uint8_t)((hi >> (i * 6)) & 0x3F);                                /* module i + 8 */
+    }
+
+    return 1;                                                                           /* return dirty */
+}
+
+/**
+ * @brief     get the changed digits of one module
+ * @param[in] *frame points to 6 bytes of the new framebuffer
+ * @param[in] *sent points to 6 bytes of the sent framebuffer
+ * @return    changed digit bitmap
+ * @note      none
+ */
+static uint8_t a_tm1637_diff_module(const uint8_t *frame, const uint8_t *sent)
+{
+    uint8_t i;
+    uint8_t mask;
+
+    mask = 0;                                                        /* init 0 */
+    for (i = 0; i < 6; i++)                                          /* loop all digits */
+    {
+        if (frame[i] != sent[i])                                     /* check the digit */
+        {
+            mask |= (uint8_t)(1 << i);                               /* changed */
+        }
+    }
+
+    return mask;                                                     /* return the bitmap */
+}
+
+/**
+ * @brief      find the changed digits of a framebuffer
+ * @param[in]  *frame points to the new framebuffer with 6 digits per module
+ * @param[in]  *sent points to the sent framebuffer with 6 digits per module
+ * @param[in]  modules is the module number
+ * @param[out] *mask points to a changed digit bitmap buffer with one byte per module
+ * @return     status code
+ *             - 0 success
+ *             - 2 frame, sent or mask is NULL
+ * @note       it compares 32 bytes at a time with avx2, 16 bytes with sse2 and 8 bytes in portable c
+ */
+uint8_t tm1637_diff_mask(const uint8_t *frame, const uint8_t *sent, uint16_t modules, uint8_t *mask)
+{
+    uint32_t m;
+
+    if ((frame == NULL) || (sent == NULL) || (mask == NULL))                                       /* check the buffers */
+    {
+        return 2;                                                                                  /* return error */
+    }
+
+    for (m = 0; m + TM1637_DIFF_BLOCK_MODULE <= modules; m += TM1637_DIFF_BLOCK_MODULE)            /* whole blocks */
+    {
+        (void)a_tm1637_diff_block(frame + m * 6, sent + m * 6, mask + m);                          /* 16 modules */
+    }
+    for (; m < modules; m++)                                                                       /* the rest */
+    {
+        mask[m] = a_tm1637_diff_module(frame + m * 6, sent + m * 6);                               /* one module */
+    }
+
+    return 0;                                                                                      /* success return 0 */
+}
+
+/**
+ * @brief      find the dirty runs of a framebuffer
+ * @param[in]  *frame points to the new framebuffer with 6 digits per module
+ * @param[in]  *sent points to the sent framebuffer with 6 digits per module
+ * @param[in]  modules is the module number
+ * @param[out] *run points to a run buffer
+ * @param[in]  max is the run buffer size
+ * @param[out] *run_num points to a run number buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 frame, sent, run or run_num is NULL
+ *             - 4 run buffer is too small
+ * @note       a run never crosses a module, runs closer than TM1637_DIFF_MERGE_GAP digits are merged,
+ *             one module has at most 2 runs
+ */
+uint8_t tm1637_diff_scan(const uint8_t *frame, const uint8_t *sent, uint16_t modules, tm1637_diff_run_t *run, uint32_t max, uint32_t *run_num)
+{
+    uint32_t m;
+    uint32_t num;
+    uint8_t mask[TM1637_DIFF_BLOCK_MODULE];
+    const uint8_t *entry;
+    uint8_t count;
+    uint8_t i;
+    uint8_t j;
+
+    if ((frame == NULL) || (sent == NULL) || (run == NULL) || (run_num == NULL))                   /* check the buffers */
+    {
+        return 2;                                                                                  /* return error */
+    }
+
+    num = 0;                                                                                       /* init 0 */
+    for (m = 0; m < modules; m += count)                                                           /* loop all blocks */
+    {
+        if (m + TM1637_DIFF_BLOCK_MODULE <= modules)                                               /* whole block */
+        {
+            count = TM1637_DIFF_BLOCK_MODULE;                                                      /* 16 modules */
+            if (a_tm1637_diff_block(frame + m * 6, sent + m * 6, mask) == 0)                       /* clean block */
+            {
+                continue;                                                                          /* skip */
+            }
+        }
+        else
+        {
+            count = 1;                                                                             /* one module */
+            mask[0] = a_tm1637_diff_module(frame + m * 6, sent + m * 6);                           /* the rest */
+        }
+        for (i = 0; i < count; i++)                                                                /* loop the block */
+        {
+            if (mask[i] == 0)                                                                      /* clean module */
+            {
+                continue;                                                                          /* skip */
+            }
+            entry = gc_tm1637_diff_run[mask[i]];                                                   /* runs of the module */
+            for (j = 0; j < entry[0]; j++)                                                         /* loop all runs */
+            {
+                if (num >= max)                                                                    /* check the buffer */
+                {
+                    *run_num = num;                                                                /* set the found runs */
+
+                    return 4;                                                                      /* return error */
+                }
+                run[num].module = (uint16_t)(m + i);                                               /* set module */
+                run[num].addr = entry[1 + j * 2];                                                  /* set addr */
+                run[num].len = entry[2 + j * 2];                                                   /* set len */
+                num++;                                                                             /* run number + 1 */
+            }
+        }
+    }
+    *run_num = num;                                                                                /* set the run number */
+
+    return 0;                                                                                      /* success return 0 */
+}
+
+/**
+ * @brief      send the dirty runs of a framebuffer
+ * @param[in]  *frame points to the new framebuffer with 6 digits per module
+ * @param[in]  *sent points to the sent framebuffer with 6 digits per module
+ * @param[in]  modules is the module number
+ * @param[in]  *transmit points to a transmit function address
+ * @param[in]  *ctx points to the transmit context
+ * @param[out] *run_num points to a sent run number buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 transmit failed
+ *             - 2 frame, sent, transmit or run_num is NULL
+ * @note       each run goes to the transmit path as soon as it is found and is copied to sent when it succeeds,
+ *             a failed run stays dirty and the others keep going,
+ *             tm1637_fleet_ops_t write_segment has the same shape as transmit
+ */
+uint8_t tm1637_diff_transmit(const uint8_t *frame, uint8_t *sent, uint16_t modules, uint8_t (*transmit)(void *ctx, uint16_t module, uint8_t addr, uint8_t *data, uint8_t len), void *ctx, uint32_t *run_num)
+{
+    uint32_t m;
+    uint32_t num;
+    uint8_t mask[TM1637_DIFF_BLOCK_MODULE];
+    uint8_t data[6];
+    const uint8_t *entry;
+    uint8_t addr;
+    uint8_t len;
+    uint8_t *s;
+    uint8_t count;
+    uint8_t res;
+    uint8_t i;
+    uint8_t j;
+
+    if ((frame == NULL) || (sent == NULL) || (transmit == NULL) || (run_num == NULL))              /* check the buffers */
+    {
+        return 2;                                                                                  /* return error */
+    }
+
+    res = 0;                                                                                       /* init 0 */
+    num = 0;                                                                                       /* init 0 */
+    for (m = 0; m < modules; m += count)                                                           /* loop all blocks */
+    {
+        if (m + TM1637_DIFF_BLOCK_MODULE <= modules)                                               /* whole block */
+        {
+            count = TM1637_DIFF_BLOCK_MODULE;                                                      /* 16 modules */
+            if (a_tm1637_diff_block(frame + m * 6, sent + m * 6, mask) == 0)                       /* clean block */
+            {
+                continue;                                                                          /* skip */
+            }
+        }
+        else
+        {
+            count = 1;                                                                             /* one module */
+            mask[0] = a_tm1637_diff_module(frame + m * 6, sent + m * 6);                           /* the rest */
+        }
+        for (i = 0; i < count; i++)                                                                /* loop the block */
+        {
+            if (mask[i] == 0)                                                                      /* clean module */
+            {
+                continue;                                                                          /* skip */
+            }
+            s = sent + (m + i) * 6;                                                                /* sent digits */
+            entry = gc_tm1637_diff_run[mask[i]];                                                   /* runs of the module */
+            for (j = 0; j < entry[0]; j++)                                                         /* loop all runs */
+            {
+                addr = entry[1 + j * 2];                                                           /* run addr */
+                len = entry[2 + j * 2];                                                            /* run len */
+                memcpy(data, frame + (m + i) * 6 + addr, len);                                     /* copy the run */
+                if (transmit(ctx, (uint16_t)(m + i), addr, data, len) != 0)                        /* send the run */
+                {
+                    res = 1;                                                                       /* keep the others going */
+
+                    continue;                                                                      /* next run */
+                }
+                memcpy(s + addr, data, len);                                                       /* remember the sent digits */
+                num++;                                                                             /* run number + 1 */
+            }
+        }
+    }
+    *run_num = num;                                                                                /* set the run number */
+
+    return res;                                                                                    /* return the result */
+}
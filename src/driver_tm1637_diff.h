@@ -0,0 +1,126 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_diff.h
+ * @brief     driver tm1637 diff header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef DRIVER_TM1637_DIFF_H
+#define DRIVER_TM1637_DIFF_H
+
+#include "driver_tm1637.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup tm1637_diff_driver tm1637 diff driver function
+ * @brief    tm1637 frame diff driver modules
+ * @ingroup  tm1637_driver
+ * @{
+ */
+
+/**
+ * @brief tm1637 diff merge gap definition
+ * @note  a new transmission costs a start, a stop and two command bytes, so sending up to two unchanged digits is cheaper,
+ *        the run table in the source file is built for this gap
+ */
+#define TM1637_DIFF_MERGE_GAP        2        /**< 2 digits */
+
+/**
+ * @brief tm1637 diff run structure definition
+ */
+typedef struct tm1637_diff_run_s
+{
+    uint16_t module;        /**< module index */
+    uint8_t addr;           /**< first digit address */
+    uint8_t len;            /**< digit number */
+} tm1637_diff_run_t;
+
+/**
+ * @brief      find the changed digits of a framebuffer
+ * @param[in]  *frame points to the new framebuffer with 6 digits per module
+ * @param[in]  *sent points to the sent framebuffer with 6 digits per module
+ * @param[in]  modules is the module number
+ * @param[out] *mask points to a changed digit bitmap buffer with one byte per module
+ * @return     status code
+ *             - 0 success
+ *             - 2 frame, sent or mask is NULL
+ * @note       it compares 32 bytes at a time with avx2, 16 bytes with sse2 and 8 bytes in portable c
+ */
+uint8_t tm1637_diff_mask(const uint8_t *frame, const uint8_t *sent, uint16_t modules, uint8_t *mask);
+
+/**
+ * @brief      find the dirty runs of a framebuffer
+ * @param[in]  *frame points to the new framebuffer with 6 digits per module
+ * @param[in]  *sent points to the sent framebuffer with 6 digits per module
+ * @param[in]  modules is the module number
+ * @param[out] *run points to a run buffer
+ * @param[in]  max is the run buffer size
+ * @param[out] *run_num points to a run number buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 frame, sent, run or run_num is NULL
+ *             - 4 run buffer is too small
+ * @note       a run never crosses a module, runs closer than TM1637_DIFF_MERGE_GAP digits are merged,
+ *             one module has at most 2 runs
+ */
+uint8_t tm1637_diff_scan(const uint8_t *frame, const uint8_t *sent, uint16_t modules, tm1637_diff_run_t *run, uint32_t max, uint32_t *run_num);
+
+/**
+ * @brief      send the dirty runs of a framebuffer
+ * @param[in]  *frame points to the new framebuffer with 6 digits per module
+ * @param[in]  *sent points to the sent framebuffer with 6 digits per module
+ * @param[in]  modules is the module number
+ * @param[in]  *transmit points to a transmit function address
+ * @param[in]  *ctx points to the transmit context
+ * @param[out] *run_num points to a sent run number buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 transmit failed
+ *             - 2 frame, sent, transmit or run_num is NULL
+ * @note       each run goes to the transmit path as soon as it is found and is copied to sent when it succeeds,
+ *             a failed run stays dirty and the others keep going,
+ *             tm1637_fleet_ops_t write_segment has the same shape as transmit
+ */
+uint8_t tm1637_diff_transmit(const uint8_t *frame, uint8_t *sent, uint16_t modules, uint8_t (*transmit)(void *ctx, uint16_t module, uint8_t addr, uint8_t *data, uint8_t len), void *ctx, uint32_t *run_num);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,651 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_fleet.c
+ * @brief     driver tm1637 fleet source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_tm1637_fleet.h"
+#if defined(TM1637_FLEET_SSE2)
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief fleet swar mask definition
+ */
+#define TM1637_FLEET_LOW7         0x7F7F7F7F7F7F7F7FULL        /**< low 7 bits of each byte */
+#define TM1637_FLEET_HIGH         0x8080808080808080ULL        /**< high bit of each byte */
+#define TM1637_FLEET_ONES         0x0101010101010101ULL        /**< low bit of each byte */
+#define TM1637_FLEET_BITS         0x8040201008040201ULL        /**< bit k of byte k */
+#define TM1637_FLEET_GATHER       0x0102040810204080ULL        /**< gather low bits into the top byte */
+
+/**
+ * @brief     parallel ops write segment
+ * @param[in] *ctx points to a tm1637 parallel structure
+ * @param[in] lane is the module index on the parallel bus
+ * @param[in] addr is the start address
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+static uint8_t a_tm1637_fleet_parallel_write_segment(void *ctx, uint16_t lane, uint8_t addr, uint8_t *data, uint8_t len)
+{
+    if (lane >= TM1637_PARALLEL_MAX_MODULE)                                                                     /* check lane */
+    {
+        return 1;                                                                                               /* return error */
+    }
+
+    return (tm1637_parallel_broadcast_segment((tm1637_parallel_t *)ctx, (uint16_t)(1U << lane),
+                                              addr, data, len, NULL) != 0) ? 1 : 0;                             /* one module */
+}
+
+/**
+ * @brief     parallel ops write display
+ * @param[in] *ctx points to a tm1637 parallel structure
+ * @param[in] lane is the module index on the parallel bus
+ * @param[in] display is the display bits
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+static uint8_t a_tm1637_fleet_parallel_write_display(void *ctx, uint16_t lane, uint8_t display)
+{
+    if (lane >= TM1637_PARALLEL_MAX_MODULE)                                                                     /* check lane */
+    {
+        return 1;                                                                                               /* return error */
+    }
+
+    return (tm1637_parallel_broadcast_display((tm1637_parallel_t *)ctx, (uint16_t)(1U << lane),
+                                              (tm1637_bool_t)((display >> 3) & 0x01),
+                                              (tm1637_pulse_width_t)(display & 0x07), NULL) != 0) ? 1 : 0;     /* one module */
+}
+
+/**
+ * @brief tm1637 fleet parallel bus ops, ctx is a tm1637_parallel_t and lane is the module index on it
+ */
+const tm1637_fleet_ops_t gc_tm1637_fleet_parallel_ops =
+{
+    a_tm1637_fleet_parallel_write_segment,
+    a_tm1637_fleet_parallel_write_display,
+};
+
+/**
+ * @brief     count the set bits
+ * @param[in] x is the word
+ * @return    set bit number
+ * @note      none
+ */
+static uint8_t a_tm1637_fleet_popcount(uint64_t x)
+{
+    x = x - ((x >> 1) & 0x5555555555555555ULL);                                   /* 2 bit sums */
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);         /* 4 bit sums */
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;                                   /* 8 bit sums */
+
+    return (uint8_t)((x * TM1637_FLEET_ONES) >> 56);                              /* add all bytes */
+}
+
+#if !defined(TM1637_FLEET_SSE2)
+/**
+ * @brief     load 8 bytes
+ * @param[in] *p points to 8 bytes
+ * @return    byte i of memory is byte i of the word
+ * @note      none
+ */
+static uint64_t a_tm1637_fleet_load(const uint8_t *p)
+{
+    uint64_t x;
+
+    memcpy(&x, p, 8);                                                             /* unaligned safe load */
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    x = __builtin_bswap64(x);                                                     /* memory order */
+#endif
+
+    return x;                                                                     /* return the word */
+}
+
+/**
+ * @brief     store 8 bytes
+ * @param[in] *p points to 8 bytes
+ * @param[in] x is the word, byte i of the word is byte i of memory
+ * @note      none
+ */
+static void a_tm1637_fleet_store(uint8_t *p, uint64_t x)
+{
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    x = __builtin_bswap64(x);                                                     /* memory order */
+#endif
+    memcpy(p, &x, 8);                                                             /* unaligned safe store */
+}
+#endif
+
+/**
+ * @brief     flush one module
+ * @param[in] *fleet points to a tm1637 fleet structure
+ * @param[in] m is the module id
+ * @return    status code
+ *            - 0 success
+ *            - 1 flush failed
+ * @note      it only touches the state of the module, a failed module stays dirty
+ */
+static uint8_t a_tm1637_fleet_flush_module(tm1637_fleet_t *fleet, uint16_t m)
+{
+    const tm1637_fleet_bus_t *b;
+    uint8_t changed;
+    uint8_t first;
+    uint8_t last;
+
+    b = &fleet->buses[fleet->bus[m]];                                                    /* module bus */
+    if (fleet->config[m] != fleet->config_sent[m])                                       /* check the display */
+    {
+        if (b->ops->write_display(b->ctx, fleet->lane[m], fleet->config[m]) != 0)        /* write the display */
+        {
+            fleet->debug_print("tm1637: module %d write display failed.\n", m);          /* write display failed */
+
+            return 1;                                                                    /* return error */
+        }
+        fleet->config_sent[m] = fleet->config[m];                                        /* sent */
+    }
+    changed = fleet->changed[m];                                                         /* changed digits */
+    if (changed == 0)                                                                    /* check the digits */
+    {
+        return 0;                                                                        /* success return 0 */
+    }
+    first = 0;                                                                           /* init 0 */
+    while ((changed & (1 << first)) == 0)                                                /* find the first */
+    {
+        first++;                                                                         /* next */
+    }
+    last = 5;                                                                            /* init 5 */
+    while ((changed & (1 << last)) == 0)                                                 /* find the last */
+    {
+        last--;                                                                          /* previous */
+    }
+    if (b->ops->write_segment(b->ctx, fleet->lane[m], first, &fleet->ram[m][first],
+                              (uint8_t)(last - first + 1)) != 0)                         /* write the digits */
+    {
+        fleet->debug_print("tm1637: module %d write segment failed.\n", m);              /* write segment failed */
+
+        return 1;                                                                        /* return error */
+    }
+    memcpy(&fleet->sent[m][first], &fleet->ram[m][first], last - first + 1);             /* remember the sent digits */
+    fleet->sent_mask[m] |= (uint8_t)(((1 << (last + 1)) - 1) & ~((1 << first) - 1));     /* known sent digits */
+    fleet->changed[m] = 0;                                                               /* sent */
+
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief     initialize the fleet
+ * @param[in] *fleet points to a tm1637 fleet structure
+ * @param[in] *debug_print points to a debug_print function address
+ * @return    status code
+ *            - 0 success
+ *            - 2 fleet or debug_print is NULL
+ * @note      none
+ */
+uint8_t tm1637_fleet_init(tm1637_fleet_t *fleet, void (*debug_print)(const char *const fmt, ...))
+{
+    if ((fleet == NULL) || (debug_print == NULL))        /* check fleet and debug_print */
+    {
+        return 2;                                        /* return error */
+    }
+
+    memset(fleet, 0, sizeof(tm1637_fleet_t));            /* clear the fleet */
+    fleet->debug_print = debug_print;                    /* set debug_print */
+
+    return 0;                                            /* success return 0 */
+}
+
+/**
+ * @brief      add a bus to the fleet
+ * @param[in]  *fleet points to a tm1637 fleet structure
+ * @param[in]  *ops points to a shared transport ops table
+ * @param[in]  *ctx points to the transport context
+ * @param[out] *bus points to a bus id buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 fleet or ops is NULL
+ *             - 5 fleet has no free bus
+ * @note       many buses may share one const ops table
+ */
+uint8_t tm1637_fleet_add_bus(tm1637_fleet_t *fleet, const tm1637_fleet_ops_t *ops, void *ctx, uint8_t *bus)
+{
+    if ((fleet == NULL) || (ops == NULL))                                /* check fleet and ops */
+    {
+        return 2;                                                        /* return error */
+    }
+    if (fleet->bus_num >= TM1637_FLEET_MAX_BUS)                          /* check the free bus */
+    {
+        fleet->debug_print("tm1637: fleet has no free bus.\n");          /* fleet has no free bus */
+
+        return 5;                                                        /* return error */
+    }
+
+    fleet->buses[fleet->bus_num].ops = ops;                              /* set ops */
+    fleet->buses[fleet->bus_num].ctx = ctx;                              /* set ctx */
+    *bus = fleet->bus_num;                                               /* set bus id */
+    fleet->bus_num++;                                                    /* bus number + 1 */
+
+    return 0;                                                            /* success return 0 */
+}
+
+/**
+ * @brief      add a module to the fleet
+ * @param[in]  *fleet points to a tm1637 fleet structure
+ * @param[in]  bus is the bus id
+ * @param[in]  lane is the lane of the module on the bus
+ * @param[out] *module points to a module id buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 fleet is NULL
+ *             - 4 bus is invalid
+ *             - 5 fleet is full
+ * @note       the first flush sends the whole frame and the display
+ */
+uint8_t tm1637_fleet_add_module(tm1637_fleet_t *fleet, uint8_t bus, uint16_t lane, uint16_t *module)
+{
+    uint16_t i;
+
+    if (fleet == NULL)                                                                  /* check fleet */
+    {
+        return 2;                                                                       /* return error */
+    }
+    if (bus >= fleet->bus_num)                                                          /* check bus */
+    {
+        fleet->debug_print("tm1637: bus is invalid.\n");                                /* bus is invalid */
+
+        return 4;                                                                       /* return error */
+    }
+    if (fleet->module_num >= TM1637_FLEET_MAX_MODULE)                                   /* check the free module */
+    {
+        fleet->debug_print("tm1637: fleet is full.\n");                                 /* fleet is full */
+
+        return 5;                                                                       /* return error */
+    }
+
+    i = fleet->module_num;                                                              /* new module id */
+    fleet->bus[i] = bus;                                                                /* set bus */
+    fleet->lane[i] = lane;                                                              /* set lane */
+    fleet->changed[i] = 0x3F;                                                           /* send all digits first */
+    fleet->sent_mask[i] = 0;                                                            /* sent digits unknown */
+    fleet->config[i] = (uint8_t)((1 << 3) | TM1637_PULSE_WIDTH_14_DIV_16);              /* display on */
+    fleet->config_sent[i] = 0xFF;                                                       /* display bits unknown */
+    *module = i;                                                                        /* set module id */
+    fleet->module_num++;                                                                /* module number + 1 */
+
+    return 0;                                                                           /* success return 0 */
+}
+
+/**
+ * @brief     write digits to a module
+ * @param[in] *fleet points to a tm1637 fleet structure
+ * @param[in] module is the module id
+ * @param[in] addr is the start address
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 2 fleet is NULL
+ *            - 4 module is invalid or addr + len > 6
+ * @note      it never touches the bus, a digit equal to the sent one is not changed any more
+ */
+uint8_t tm1637_fleet_write_segment(tm1637_fleet_t *fleet, uint16_t module, uint8_t addr, uint8_t *data, uint8_t len)
+{
+    uint8_t i;
+    uint8_t pos;
+
+    if (fleet == NULL)                                                                  /* check fleet */
+    {
+        return 2;                                                                       /* return error */
+    }
+    if ((module >= fleet->module_num) || (addr + len > 6))                              /* check module and range */
+    {
+        fleet->debug_print("tm1637: module is invalid or addr + len > 6.\n");           /* module is invalid or addr + len > 6 */
+
+        return 4;                                                                       /* return error */
+    }
+
+    for (i = 0; i < len; i++)                                                           /* loop all digits */
+    {
+        pos = addr + i;                                                                 /* digit address */
+        fleet->ram[module][pos] = data[i];                                              /* keep the latest */
+        if ((data[i] != fleet->sent[module][pos]) ||
+            ((fleet->sent_mask[module] & (1 << pos)) == 0))                             /* check the sent digit */
+        {
+            fleet->changed[module] |= (uint8_t)(1 << pos);                              /* changed */
+        }
+        else
+        {
+            fleet->changed[module] &= (uint8_t)~(1 << pos);                             /* back to the sent value */
+        }
+    }
+
+    return 0;                                                                           /* success return 0 */
+}
+
+/**
+ * @brief     write a whole framebuffer to the fleet
+ * @param[in] *fleet points to a tm1637 fleet structure
+ * @param[in] *frame points to a framebuffer with 6 digits per module in module id order
+ * @return    status code
+ *            - 0 success
+ *            - 2 fleet or frame is NULL
+ * @note      it never touches the bus, the diff kernel marks the digits that differ from the sent ones
+ *            and the others are not changed any more
+ */
+uint8_t tm1637_fleet_write_frame(tm1637_fleet_t *fleet, const uint8_t *frame)
+{
+    uint8_t mask[TM1637_FLEET_MAX_MODULE];
+    uint16_t i;
+
+    if ((fleet == NULL) || (frame == NULL))                                             /* check fleet and frame */
+    {
+        return 2;                                                                       /* return error */
+    }
+
+    (void)tm1637_diff_mask(frame, &fleet->sent[0][0], fleet->module_num, mask);         /* changed digits */
+    memcpy(fleet->ram, frame, (size_t)fleet->module_num * 6);                           /* keep the latest */
+    for (i = 0; i < fleet->module_num; i++)                                             /* loop all modules */
+    {
+        fleet->changed[i] = (uint8_t)(mask[i] | (~fleet->sent_mask[i] & 0x3F));         /* changed or never sent */
+    }
+
+    return 0;                                                                           /* success return 0 */
+}
+
+/**
+ * @brief     set the display of a module
+ * @param[in] *fleet points to a tm1637 fleet structure
+ * @param[in] module is the module id
+ * @param[in] enable is a bool value
+ * @param[in] width is the pulse width
+ * @return    status code
+ *            - 0 success
+ *            - 2 fleet is NULL
+ *            - 4 module is invalid
+ * @note      it never touches the bus
+ */
+uint8_t tm1637_fleet_set_display(tm1637_fleet_t *fleet, uint16_t module, tm1637_bool_t enable, tm1637_pulse_width_t width)
+{
+    if (fleet == NULL)                                                                  /* check fleet */
+    {
+        return 2;                                                                       /* return error */
+    }
+    if (module >= fleet->module_num)                                                    /* check module */
+    {
+        fleet->debug_print("tm1637: module is invalid.\n");                             /* module is invalid */
+
+        return 4;                                                                       /* return error */
+    }
+
+    fleet->config[module] = (uint8_t)(((enable & 0x01) << 3) | (width & 0x07));         /* set the display bits */
+
+    return 0;                                                                           /* success return 0 */
+}
+
+/**
+ * @brief     set the pulse width of many modules at once
+ * @param[in] *fleet points to a tm1637 fleet structure
+ * @param[in] *select points to a module bitmap with TM1637_FLEET_MAX_MODULE / 64 words, NULL means all modules
+ * @param[in] width is the pulse width
+ * @return    status code
+ *            - 0 success
+ *            - 2 fleet is NULL
+ * @note      it rewrites the config array 16 modules at a time and never touches the bus
+ */
+uint8_t tm1637_fleet_set_brightness(tm1637_fleet_t *fleet, const uint64_t *select, tm1637_pulse_width_t width)
+{
+    uint16_t i;
+    uint16_t bits;
+#if defined(TM1637_FLEET_SSE2)
+    __m128i x;
+    __m128i mask;
+    __m128i bit;
+    __m128i value;
+#else
+    uint64_t mask;
+    uint64_t value;
+    uint8_t half;
+#endif
+
+    if (fleet == NULL)                                                                               /* check fleet */
+    {
+        return 2;                                                                                    /* return error */
+    }
+
+#if defined(TM1637_FLEET_SSE2)
+    bit = _mm_set_epi8((char)0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+                       (char)0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);                        /* bit k of byte k */
+    value = _mm_set1_epi8((char)(width & 0x07));                                                     /* new pulse width */
+#else
+    value = (uint64_t)(width & 0x07) * TM1637_FLEET_ONES;                                            /* new pulse width */
+#endif
+    for (i = 0; i < fleet->module_num; i += 16)                                                      /* 16 modules at a time */
+    {
+        bits = (select != NULL) ? (uint16_t)(select[i / 64] >> (i % 64)) : 0xFFFF;                   /* selected modules */
+        if (fleet->module_num - i < 16)                                                              /* the last block */
+        {
+            bits &= (uint16_t)((1U << (fleet->module_num - i)) - 1);                                 /* valid modules only */
+        }
+        if (bits == 0)                                                                               /* nothing selected */
+        {
+            continue;                                                                                /* skip */
+        }
+#if defined(TM1637_FLEET_SSE2)
+        mask = _mm_unpacklo_epi64(_mm_set1_epi8((char)(bits & 0xFF)),
+                                  _mm_set1_epi8((char)(bits >> 8)));                                 /* one bit for each byte */
+        mask = _mm_cmpeq_epi8(_mm_and_si128(mask, bit), bit);                                        /* spread to byte masks */
+        mask = _mm_and_si128(mask, _mm_set1_epi8(0x07));                                             /* pulse width bits only */
+        x = _mm_loadu_si128((const __m128i *)&fleet->config[i]);                                     /* load 16 config bytes */
+        x = _mm_or_si128(_mm_andnot_si128(mask, x), _mm_and_si128(mask, value));                     /* blend */
+        _mm_storeu_si128((__m128i *)&fleet->config[i], x);                                           /* store */
+#else
+        for (half = 0; half < 2; half++)                                                             /* two words of 8 modules */
+        {
+            mask = ((uint64_t)((bits >> (half * 8)) & 0xFF) * TM1637_FLEET_ONES) & TM1637_FLEET_BITS;/* bit k of byte k */
+            mask = ((mask | ((mask & TM1637_FLEET_LOW7) + TM1637_FLEET_LOW7)) &
+                    TM1637_FLEET_HIGH) >> 7;                                                         /* 1 in each selected byte */
+            mask *= 0x07;                                                                            /* pulse width bits only */
+            a_tm1637_fleet_store(&fleet->config[i + half * 8],
+                                 (a_tm1637_fleet_load(&fleet->config[i + half * 8]) & ~mask) |
+                                 (value & mask));                                                    /* blend */
+        }
+#endif
+    }
+
+    return 0;                                                                                        /* success return 0 */
+}
+
+/**
+ * @brief      find the dirty modules
+ * @param[in]  *fleet points to a tm1637 fleet structure
+ * @param[out] *dirty points to a module bitmap with TM1637_FLEET_MAX_MODULE / 64 words
+ * @param[out] *count points to a dirty module number buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 fleet is NULL
+ * @note       a module is dirty when a digit changed or its display bits differ from the sent ones,
+ *             it compares 16 modules at a time
+ */
+uint8_t tm1637_fleet_scan_dirty(tm1637_fleet_t *fleet, uint64_t *dirty, uint16_t *count)
+{
+    uint16_t i;
+    uint16_t bits;
+    uint16_t total;
+#if defined(TM1637_FLEET_SSE2)
+    __m128i clean;
+#else
+    uint64_t x;
+    uint8_t half;
+#endif
+
+    if (fleet == NULL)                                                                               /* check fleet */
+    {
+        return 2;                                                                                    /* return error */
+    }
+
+    memset(dirty, 0, sizeof(uint64_t) * (TM1637_FLEET_MAX_MODULE / 64));                             /* clear the bitmap */
+    total = 0;                                                                                       /* init 0 */
+    for (i = 0; i < fleet->module_num; i += 16)                                                      /* 16 modules at a time */
+    {
+#if defined(TM1637_FLEET_SSE2)
+        clean = _mm_and_si128(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)&fleet->changed[i]),
+                                             _mm_setzero_si128()),
+                              _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)&fleet->config[i]),
+                                             _mm_loadu_si128((const __m128i *)&fleet->config_sent[i]))); /* clean modules */
+        bits = (uint16_t)~_mm_movemask_epi8(clean);                                                  /* dirty modules */
+#else
+        bits = 0;                                                                                    /* init 0 */
+        for (half = 0; half < 2; half++)                                                             /* two words of 8 modules */
+        {
+            x = a_tm1637_fleet_load(&fleet->changed[i + half * 8]) |
+                (a_tm1637_fleet_load(&fleet->config[i + half * 8]) ^
+                 a_tm1637_fleet_load(&fleet->config_sent[i + half * 8]));                            /* non zero bytes are dirty */
+            x = (x | ((x & TM1637_FLEET_LOW7) + TM1637_FLEET_LOW7)) & TM1637_FLEET_HIGH;             /* high bit of each dirty byte */
+            bits |= (uint16_t)((((x >> 7) * TM1637_FLEET_GATHER) >> 56) << (half * 8));              /* gather */
+        }
+#endif
+        if (fleet->module_num - i < 16)                                                              /* the last block */
+        {
+            bits &= (uint16_t)((1U << (fleet->module_num - i)) - 1);                                 /* valid modules only */
+        }
+        dirty[i / 64] |= (uint64_t)bits << (i % 64);                                                 /* set the bitmap */
+        total += a_tm1637_fleet_popcount(bits);                                                      /* count */
+    }
+    *count = total;                                                                                  /* set count */
+
+    return 0;                                                                                        /* success return 0 */
+}
+
+/**
+ * @brief     flush the dirty modules
+ * @param[in] *fleet points to a tm1637 fleet structure
+ * @param[in] bus is the bus id, TM1637_FLEET_BUS_ALL flushes every bus
+ * @return    status code
+ *            - 0 success
+ *            - 1 flush failed
+ *            - 2 fleet is NULL
+ * @note      each dirty module gets its display bits and the span of its changed digits,
+ *            a failed module stays dirty and the others keep going
+ */
+uint8_t tm1637_fleet_flush(tm1637_fleet_t *fleet, uint8_t bus)
+{
+    uint64_t dirty[TM1637_FLEET_MAX_MODULE / 64];
+    uint64_t word;
+    uint16_t count;
+    uint16_t m;
+    uint16_t w;
+    uint8_t res;
+
+    if (fleet == NULL)                                                                               /* check fleet */
+    {
+        return 2;                                                                                    /* return error */
+    }
+
+    (void)tm1637_fleet_scan_dirty(fleet, dirty, &count);                                             /* find the dirty modules */
+    res = 0;                                                                                         /* init 0 */
+    for (w = 0; (w < TM1637_FLEET_MAX_MODULE / 64) && (count != 0); w++)                             /* loop all words */
+    {
+        word = dirty[w];                                                                             /* dirty word */
+        while (word != 0)                                                                            /* loop all dirty modules */
+        {
+            m = (uint16_t)(w * 64 + (a_tm1637_fleet_popcount((word & (~word + 1)) - 1)));            /* lowest dirty module */
+            word &= word - 1;                                                                        /* clear it */
+            count--;                                                                                 /* one less */
+            if ((bus != TM1637_FLEET_BUS_ALL) && (fleet->bus[m] != bus))                             /* other bus */
+            {
+                continue;                                                                            /* skip */
+            }
+            if (a_tm1637_fleet_flush_module(fleet, m) != 0)                                          /* flush the module */
+            {
+                res = 1;                                                                             /* keep the others going */
+            }
+        }
+    }
+
+    return res;                                                                                      /* return the result */
+}
+
+/**
+ * @brief     flush one module
+ * @param[in] *fleet points to a tm1637 fleet structure
+ * @param[in] module is the module id
+ * @return    status code
+ *            - 0 success
+ *            - 1 flush failed
+ *            - 2 fleet is NULL
+ *            - 4 module is invalid
+ * @note      it only reads and writes the state of this module, so threads that own
+ *            different buses may flush their own modules at the same time
+ */
+uint8_t tm1637_fleet_flush_module(tm1637_fleet_t *fleet, uint16_t module)
+{
+    if (fleet == NULL)                                             /* check fleet */
+    {
+        return 2;                                                  /* return error */
+    }
+    if (module >= fleet->module_num)                               /* check module */
+    {
+        fleet->debug_print("tm1637: module is invalid.\n");        /* module is invalid */
+
+        return 4;                                                  /* return error */
+    }
+
+    return a_tm1637_fleet_flush_module(fleet, module);             /* flush the module */
+}
+
+/**
+ * @brief      get the fleet memory footprint
+ * @param[in]  *fleet points to a tm1637 fleet structure
+ * @param[out] *per_module points to a bytes per module buffer
+ * @param[out] *total points to a total bytes buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 fleet is NULL
+ * @note       per_module counts the module arrays only, total is the whole structure
+ */
+uint8_t tm1637_fleet_get_footprint(tm1637_fleet_t *fleet, uint32_t *per_module, uint32_t *total)
+{
+    if (fleet == NULL)                                                     /* check fleet */
+    {
+        return 2;                                                          /* return error */
+    }
+
+    *per_module = (uint32_t)TM1637_FLEET_MODULE_FOOTPRINT;                 /* bytes per module */
+    *total = (uint32_t)sizeof(tm1637_fleet_t);                             /* whole structure */
+
+    return 0;                                                              /* success return 0 */
+}
@@ -0,0 +1,288 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_fleet.h
+ * @brief     driver tm1637 fleet header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef DRIVER_TM1637_FLEET_H
+#define DRIVER_TM1637_FLEET_H
+
+#include "driver_tm1637_parallel.h"
+#include "driver_tm1637_diff.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup tm1637_fleet_driver tm1637 fleet driver function
+ * @brief    tm1637 fleet driver modules
+ * @ingroup  tm1637_driver
+ * @{
+ */
+
+/**
+ * @brief tm1637 fleet size definition
+ */
+#ifndef TM1637_FLEET_MAX_MODULE
+    #define TM1637_FLEET_MAX_MODULE        256        /**< 256 modules, a multiple of 64 */
+#endif
+#ifndef TM1637_FLEET_MAX_BUS
+    #define TM1637_FLEET_MAX_BUS           8          /**< 8 buses */
+#endif
+#define TM1637_FLEET_ALIGN                 64         /**< cache line size */
+#define TM1637_FLEET_BUS_ALL               0xFF       /**< all buses */
+#if ((TM1637_FLEET_MAX_MODULE % 64) != 0) || (TM1637_FLEET_MAX_MODULE == 0)
+    #error "TM1637_FLEET_MAX_MODULE must be a multiple of 64"
+#endif
+
+/**
+ * @brief tm1637 fleet alignment definition
+ * @note  every module array is a multiple of 64 bytes, so aligning the first one aligns them all
+ */
+#if defined(__GNUC__) || defined(__clang__) || defined(__CC_ARM) || defined(__ICCARM__)
+    #define TM1637_FLEET_ALIGNED           __attribute__((aligned(TM1637_FLEET_ALIGN)))        /**< cache line aligned */
+#else
+    #define TM1637_FLEET_ALIGNED                                                               /**< natural alignment, the kernels load unaligned */
+#endif
+
+/**
+ * @brief tm1637 fleet kernel definition
+ */
+#if defined(__SSE2__) && !defined(TM1637_FLEET_NO_SSE2)
+    #define TM1637_FLEET_SSE2              1          /**< sse2 kernels, define TM1637_FLEET_NO_SSE2 for the swar ones */
+#endif
+
+/**
+ * @brief tm1637 fleet transport ops structure definition
+ */
+typedef struct tm1637_fleet_ops_s
+{
+    uint8_t (*write_segment)(void *ctx, uint16_t lane, uint8_t addr, uint8_t *data, uint8_t len);        /**< write digits to the module on a lane */
+    uint8_t (*write_display)(void *ctx, uint16_t lane, uint8_t display);                                 /**< write the display bits to the module on a lane */
+} tm1637_fleet_ops_t;
+
+/**
+ * @brief tm1637 fleet bus structure definition
+ */
+typedef struct tm1637_fleet_bus_s
+{
+    const tm1637_fleet_ops_t *ops;        /**< shared transport ops */
+    void *ctx;                            /**< transport context */
+} tm1637_fleet_bus_t;
+
+/**
+ * @brief tm1637 fleet structure definition
+ * @note  every per module field is a contiguous cache line aligned array so that scans touch only the bytes they need,
+ *        the arrays are multiples of 64 bytes and need no padding between them
+ */
+typedef struct tm1637_fleet_s
+{
+    uint8_t changed[TM1637_FLEET_MAX_MODULE] TM1637_FLEET_ALIGNED;        /**< changed digit bitmap of each module */
+    uint8_t config[TM1637_FLEET_MAX_MODULE];                              /**< display bits of each module */
+    uint8_t config_sent[TM1637_FLEET_MAX_MODULE];                         /**< display bits sent to each module */
+    uint8_t sent_mask[TM1637_FLEET_MAX_MODULE];                           /**< known sent digit bitmap of each module */
+    uint8_t bus[TM1637_FLEET_MAX_MODULE];                                 /**< bus of each module */
+    uint16_t lane[TM1637_FLEET_MAX_MODULE];                               /**< lane of each module on its bus */
+    uint8_t ram[TM1637_FLEET_MAX_MODULE][6];                              /**< latest digits of each module */
+    uint8_t sent[TM1637_FLEET_MAX_MODULE][6];                             /**< digits sent to each module */
+    tm1637_fleet_bus_t buses[TM1637_FLEET_MAX_BUS];                       /**< buses */
+    void (*debug_print)(const char *const fmt, ...);                      /**< point to a debug_print function address */
+    uint16_t module_num;                                                  /**< module number */
+    uint8_t bus_num;                                                      /**< bus number */
+} tm1637_fleet_t;
+
+/**
+ * @brief tm1637 fleet per module memory footprint definition
+ */
+#define TM1637_FLEET_MODULE_FOOTPRINT        (5 * sizeof(uint8_t) + sizeof(uint16_t) + 2 * 6 * sizeof(uint8_t))        /**< bytes per module */
+
+/**
+ * @brief tm1637 fleet parallel bus ops, ctx is a tm1637_parallel_t and lane is the module index on it
+ */
+extern const tm1637_fleet_ops_t gc_tm1637_fleet_parallel_ops;
+
+/**
+ * @brief     initialize the fleet
+ * @param[in] *fleet points to a tm1637 fleet structure
+ * @param[in] *debug_print points to a debug_print function address
+ * @return    status code
+ *            - 0 success
+ *            - 2 fleet or debug_print is NULL
+ * @note      none
+ */
+uint8_t tm1637_fleet_init(tm1637_fleet_t *fleet, void (*debug_print)(const char *const fmt, ...));
+
+/**
+ * @brief      add a bus to the fleet
+ * @param[in]  *fleet points to a tm1637 fleet structure
+ * @param[in]  *ops points to a shared transport ops table
+ * @param[in]  *ctx points to the transport context
+ * @param[out] *bus points to a bus id buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 fleet or ops is NULL
+ *             - 5 fleet has no free bus
+ * @note       many buses may share one const ops table
+ */
+uint8_t tm1637_fleet_add_bus(tm1637_fleet_t *fleet, const tm1637_fleet_ops_t *ops, void *ctx, uint8_t *bus);
+
+/**
+ * @brief      add a module to the fleet
+ * @param[in]  *fleet points to a tm1637 fleet structure
+ * @param[in]  bus is the bus id
+ * @param[in]  lane is the lane of the module on the bus
+ * @param[out] *module points to a module id buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 fleet is NULL
+ *             - 4 bus is invalid
+ *             - 5 fleet is full
+ * @note       the first flush sends the whole frame and the display
+ */
+uint8_t tm1637_fleet_add_module(tm1637_fleet_t *fleet, uint8_t bus, uint16_t lane, uint16_t *module);
+
+/**
+ * @brief     write digits to a module
+ * @param[in] *fleet points to a tm1637 fleet structure
+ * @param[in] module is the module id
+ * @param[in] addr is the start address
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 2 fleet is NULL
+ *            - 4 module is invalid or addr + len > 6
+ * @note      it never touches the bus, a digit equal to the sent one is not changed any more
+ */
+uint8_t tm1637_fleet_write_segment(tm1637_fleet_t *fleet, uint16_t module, uint8_t addr, uint8_t *data, uint8_t len);
+
+/**
+ * @brief     write a whole framebuffer to the fleet
+ * @param[in] *fleet points to a tm1637 fleet structure
+ * @param[in] *frame points to a framebuffer with 6 digits per module in module id order
+ * @return    status code
+ *            - 0 success
+ *            - 2 fleet or frame is NULL
+ * @note      it never touches the bus, the diff kernel marks the digits that differ from the sent ones
+ *            and the others are not changed any more
+ */
+uint8_t tm1637_fleet_write_frame(tm1637_fleet_t *fleet, const uint8_t *frame);
+
+/**
+ * @brief     set the display of a module
+ * @param[in] *fleet points to a tm1637 fleet structure
+ * @param[in] module is the module id
+ * @param[in] enable is a bool value
+ * @param[in] width is the pulse width
+ * @return    status code
+ *            - 0 success
+ *            - 2 fleet is NULL
+ *            - 4 module is invalid
+ * @note      it never touches the bus
+ */
+uint8_t tm1637_fleet_set_display(tm1637_fleet_t *fleet, uint16_t module, tm1637_bool_t enable, tm1637_pulse_width_t width);
+
+/**
+ * @brief     set the pulse width of many modules at once
+ * @param[in] *fleet points to a tm1637 fleet structure
+ * @param[in] *select points to a module bitmap with TM1637_FLEET_MAX_MODULE / 64 words, NULL means all modules
+ * @param[in] width is the pulse width
+ * @return    status code
+ *            - 0 success
+ *            - 2 fleet is NULL
+ * @note      it rewrites the config array 16 modules at a time and never touches the bus
+ */
+uint8_t tm1637_fleet_set_brightness(tm1637_fleet_t *fleet, const uint64_t *select, tm1637_pulse_width_t width);
+
+/**
+ * @brief      find the dirty modules
+ * @param[in]  *fleet points to a tm1637 fleet structure
+ * @param[out] *dirty points to a module bitmap with TM1637_FLEET_MAX_MODULE / 64 words
+ * @param[out] *count points to a dirty module number buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 fleet is NULL
+ * @note       a module is dirty when a digit changed or its display bits differ from the sent ones,
+ *             it compares 16 modules at a time
+ */
+uint8_t tm1637_fleet_scan_dirty(tm1637_fleet_t *fleet, uint64_t *dirty, uint16_t *count);
+
+/**
+ * @brief     flush the dirty modules
+ * @param[in] *fleet points to a tm1637 fleet structure
+ * @param[in] bus is the bus id, TM1637_FLEET_BUS_ALL flushes every bus
+ * @return    status code
+ *            - 0 success
+ *            - 1 flush failed
+ *            - 2 fleet is NULL
+ * @note      each dirty module gets its display bits and the span of its changed digits,
+ *            a failed module stays dirty and the others keep going
+ */
+uint8_t tm1637_fleet_flush(tm1637_fleet_t *fleet, uint8_t bus);
+
+/**
+ * @brief     flush one module
+ * @param[in] *fleet points to a tm1637 fleet structure
+ * @param[in] module is the module id
+ * @return    status code
+ *            - 0 success
+ *            - 1 flush failed
+ *            - 2 fleet is NULL
+ *            - 4 module is invalid
+ * @note      it only reads and writes the state of this module, so threads that own
+ *            different buses may flush their own modules at the same time
+ */
+uint8_t tm1637_fleet_flush_module(tm1637_fleet_t *fleet, uint16_t module);
+
+/**
+ * @brief      get the fleet memory footprint
+ * @param[in]  *fleet points to a tm1637 fleet structure
+ * @param[out] *per_module points to a bytes per module buffer
+ * @param[out] *total points to a total bytes buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 fleet is NULL
+ * @note       per_module counts the module arrays only, total is the whole structure
+ */
+uint8_t tm1637_fleet_get_footprint(tm1637_fleet_t *fleet, uint32_t *per_module, uint32_t *total);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,316 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_group.c
+ * @brief     driver tm1637 group source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_tm1637_group.h"
+
+/**
+ * @brief     initialize a broadcast group
+ * @param[in] *group points to a tm1637 group structure
+ * @param[in] *parallel points to an initialized tm1637 parallel structure
+ * @param[in] members is the member module mask
+ * @return    status code
+ *            - 0 success
+ *            - 2 group or parallel is NULL
+ *            - 3 parallel is not initialized
+ *            - 4 members is invalid
+ * @note      the first flush sends the whole frame and the display, which is on at 14/16 until tm1637_group_set_display,
+ *            several groups may share one parallel bus
+ */
+uint8_t tm1637_group_init(tm1637_group_t *group, tm1637_parallel_t *parallel, uint16_t members)
+{
+    if ((group == NULL) || (parallel == NULL))                         /* check group and parallel */
+    {
+        return 2;                                                      /* return error */
+    }
+    if (parallel->inited != 1)                                         /* check parallel initialization */
+    {
+        return 3;                                                      /* return error */
+    }
+    if ((members & ~parallel->module_mask) != 0)                       /* check members */
+    {
+        parallel->debug_print("tm1637: members is invalid.\n");        /* members is invalid */
+
+        return 4;                                                      /* return error */
+    }
+
+    memset(group, 0, sizeof(tm1637_group_t));                          /* clear the group */
+    group->parallel = parallel;                                        /* set parallel */
+    group->members = members;                                          /* set members */
+    group->changed = 0x3F;                                             /* send the whole frame first */
+    group->display = 0x08 | TM1637_PULSE_WIDTH_14_DIV_16;              /* display on at 14/16 */
+    group->display_changed = 1;                                        /* send the display first */
+
+    return 0;                                                          /* success return 0 */
+}
+
+/**
+ * @brief     add a member to the group
+ * @param[in] *group points to a tm1637 group structure
+ * @param[in] module is the module index on the parallel bus
+ * @return    status code
+ *            - 0 success
+ *            - 2 group is NULL
+ *            - 4 module is invalid
+ * @note      the next flush sends the whole frame and the display so that the new member catches up,
+ *            adding a dropped member back clears its dropped flag
+ */
+uint8_t tm1637_group_add_member(tm1637_group_t *group, uint8_t module)
+{
+    if (group == NULL)                                                     /* check group */
+    {
+        return 2;                                                          /* return error */
+    }
+    if (module >= group->parallel->modules)                                /* check module */
+    {
+        group->parallel->debug_print("tm1637: module is invalid.\n");      /* module is invalid */
+
+        return 4;                                                          /* return error */
+    }
+
+    group->members |= (uint16_t)(1U << module);                            /* join */
+    group->dropped &= (uint16_t)~(1U << module);                           /* clear the dropped flag */
+    group->sent_mask = 0;                                                  /* the new member knows nothing */
+    group->changed = 0x3F;                                                 /* resend all digits */
+    group->display_changed = 1;                                            /* resend the display */
+
+    return 0;                                                              /* success return 0 */
+}
+
+/**
+ * @brief     remove a member from the group
+ * @param[in] *group points to a tm1637 group structure
+ * @param[in] module is the module index on the parallel bus
+ * @return    status code
+ *            - 0 success
+ *            - 2 group is NULL
+ *            - 4 module is invalid
+ * @note      the removed module keeps showing its last digits
+ */
+uint8_t tm1637_group_remove_member(tm1637_group_t *group, uint8_t module)
+{
+    if (group == NULL)                                                     /* check group */
+    {
+        return 2;                                                          /* return error */
+    }
+    if (module >= group->parallel->modules)                                /* check module */
+    {
+        group->parallel->debug_print("tm1637: module is invalid.\n");      /* module is invalid */
+
+        return 4;                                                          /* return error */
+    }
+
+    group->members &= (uint16_t)~(1U << module);                           /* leave */
+    group->dropped &= (uint16_t)~(1U << module);                           /* forget the dropped flag */
+
+    return 0;                                                              /* success return 0 */
+}
+
+/**
+ * @brief      get the group members
+ * @param[in]  *group points to a tm1637 group structure
+ * @param[out] *members points to a member module mask buffer
+ * @param[out] *dropped points to a dropped module mask buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 group is NULL
+ * @note       none
+ */
+uint8_t tm1637_group_get_members(tm1637_group_t *group, uint16_t *members, uint16_t *dropped)
+{
+    if (group == NULL)                  /* check group */
+    {
+        return 2;                       /* return error */
+    }
+
+    *members = group->members;          /* get members */
+    *dropped = group->dropped;          /* get dropped */
+
+    return 0;                           /* success return 0 */
+}
+
+/**
+ * @brief     write digits to the group
+ * @param[in] *group points to a tm1637 group structure
+ * @param[in] addr is the start address
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 2 group is NULL
+ *            - 4 addr + len > 6
+ * @note      it never touches the bus, digits equal to the sent ones are not marked changed
+ */
+uint8_t tm1637_group_write_segment(tm1637_group_t *group, uint8_t addr, uint8_t *data, uint8_t len)
+{
+    uint8_t i;
+    uint8_t pos;
+
+    if (group == NULL)                                                         /* check group */
+    {
+        return 2;                                                              /* return error */
+    }
+    if (addr + len > 6)                                                        /* check range */
+    {
+        group->parallel->debug_print("tm1637: addr + len > 6.\n");             /* addr + len > 6 */
+
+        return 4;                                                              /* return error */
+    }
+
+    for (i = 0; i < len; i++)                                                  /* loop all digits */
+    {
+        pos = addr + i;                                                        /* digit address */
+        group->ram[pos] = data[i];                                             /* keep the latest */
+        if ((group->ram[pos] != group->sent[pos]) ||
+            ((group->sent_mask & (1 << pos)) == 0))                            /* check the sent digit */
+        {
+            group->changed |= (uint8_t)(1 << pos);                             /* changed */
+        }
+        else
+        {
+            group->changed &= (uint8_t)~(1 << pos);                            /* back to the sent value */
+        }
+    }
+
+    return 0;                                                                  /* success return 0 */
+}
+
+/**
+ * @brief     set the display of the group
+ * @param[in] *group points to a tm1637 group structure
+ * @param[in] enable is a bool value
+ * @param[in] width is the pulse width
+ * @return    status code
+ *            - 0 success
+ *            - 2 group is NULL
+ * @note      it never touches the bus
+ */
+uint8_t tm1637_group_set_display(tm1637_group_t *group, tm1637_bool_t enable, tm1637_pulse_width_t width)
+{
+    uint8_t display;
+
+    if (group == NULL)                                                 /* check group */
+    {
+        return 2;                                                      /* return error */
+    }
+
+    display = (uint8_t)(((enable & 0x01) << 3) | (width & 0x07));     /* set the display bits */
+    if (display != group->display)                                     /* check the sent display */
+    {
+        group->display = display;                                      /* set display */
+        group->display_changed = 1;                                    /* changed */
+    }
+
+    return 0;                                                          /* success return 0 */
+}
+
+/**
+ * @brief      flush the changes to all members in one transmission
+ * @param[in]  *group points to a tm1637 group structure
+ * @param[out] *dropped points to a newly dropped module mask buffer, NULL is allowed
+ * @return     status code
+ *             - 0 success
+ *             - 1 a member dropped out
+ *             - 2 group is NULL
+ *             - 3 parallel is not initialized
+ * @note       a member whose dio line stays released during an ack is dropped from the group,
+ *             chips sharing one dio line ack as a wired and so a dropout shows only when all of them stop acking
+ */
+uint8_t tm1637_group_flush(tm1637_group_t *group, uint16_t *dropped)
+{
+    uint16_t drop;
+    uint16_t nack;
+    uint8_t first;
+    uint8_t last;
+
+    if (group == NULL)                                                                    /* check group */
+    {
+        return 2;                                                                         /* return error */
+    }
+    if (group->parallel->inited != 1)                                                     /* check parallel initialization */
+    {
+        return 3;                                                                         /* return error */
+    }
+
+    drop = 0;                                                                             /* init 0 */
+    if ((group->display_changed != 0) && (group->members != 0))                           /* check the display */
+    {
+        nack = 0;                                                                         /* init 0 */
+        (void)tm1637_parallel_broadcast_display(group->parallel, group->members,
+                                                (tm1637_bool_t)((group->display >> 3) & 0x01),
+                                                (tm1637_pulse_width_t)(group->display & 0x07),
+                                                &nack);                                   /* one transmission */
+        group->transmissions++;                                                           /* count */
+        group->display_changed = 0;                                                       /* sent */
+        drop |= nack;                                                                     /* wired and ack check */
+        group->members &= (uint16_t)~nack;                                                /* drop the silent members */
+    }
+    if ((group->changed != 0) && (group->members != 0))                                   /* check the digits */
+    {
+        first = 0;                                                                        /* init 0 */
+        while ((group->changed & (1 << first)) == 0)                                      /* find the first */
+        {
+            first++;                                                                      /* next */
+        }
+        last = 5;                                                                         /* init 5 */
+        while ((group->changed & (1 << last)) == 0)                                       /* find the last */
+        {
+            last--;                                                                       /* previous */
+        }
+        nack = 0;                                                                         /* init 0 */
+        (void)tm1637_parallel_broadcast_segment(group->parallel, group->members, first,
+                                                &group->ram[first], (uint8_t)(last - first + 1),
+                                                &nack);                                   /* one transmission */
+        group->transmissions++;                                                           /* count */
+        memcpy(&group->sent[first], &group->ram[first], last - first + 1);                /* remember the sent digits */
+        group->sent_mask |= (uint8_t)(((1 << (last + 1)) - 1) & ~((1 << first) - 1));    /* known sent digits */
+        group->changed = 0;                                                               /* sent */
+        drop |= nack;                                                                     /* wired and ack check */
+        group->members &= (uint16_t)~nack;                                                /* drop the silent members */
+    }
+    group->dropped |= drop;                                                               /* remember the dropouts */
+    if (dropped != NULL)                                                                  /* check dropped */
+    {
+        *dropped = drop;                                                                  /* set dropped */
+    }
+    if (drop != 0)                                                                        /* check the dropouts */
+    {
+        group->parallel->debug_print("tm1637: group member 0x%04X dropped out.\n", drop); /* dropped out */
+
+        return 1;                                                                         /* return error */
+    }
+
+    return 0;                                                                             /* success return 0 */
+}
@@ -0,0 +1,170 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_group.h
+ * @brief     driver tm1637 group header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef DRIVER_TM1637_GROUP_H
+#define DRIVER_TM1637_GROUP_H
+
+#include "driver_tm1637_parallel.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup tm1637_group_driver tm1637 group driver function
+ * @brief    tm1637 broadcast group driver modules
+ * @ingroup  tm1637_driver
+ * @{
+ */
+
+/**
+ * @brief tm1637 group structure definition
+ */
+typedef struct tm1637_group_s
+{
+    tm1637_parallel_t *parallel;        /**< parallel bus of the members */
+    uint16_t members;                   /**< member module mask */
+    uint16_t dropped;                   /**< members that stopped acking */
+    uint8_t ram[6];                     /**< latest digits */
+    uint8_t sent[6];                    /**< digits sent to the members */
+    uint8_t sent_mask;                  /**< known sent digit mask */
+    uint8_t changed;                    /**< changed digit mask */
+    uint8_t display;                    /**< display command bits */
+    uint8_t display_changed;            /**< display changed flag */
+    uint32_t transmissions;             /**< transmission counter */
+} tm1637_group_t;
+
+/**
+ * @brief     initialize a broadcast group
+ * @param[in] *group points to a tm1637 group structure
+ * @param[in] *parallel points to an initialized tm1637 parallel structure
+ * @param[in] members is the member module mask
+ * @return    status code
+ *            - 0 success
+ *            - 2 group or parallel is NULL
+ *            - 3 parallel is not initialized
+ *            - 4 members is invalid
+ * @note      the first flush sends the whole frame and the display, which is on at 14/16 until tm1637_group_set_display,
+ *            several groups may share one parallel bus
+ */
+uint8_t tm1637_group_init(tm1637_group_t *group, tm1637_parallel_t *parallel, uint16_t members);
+
+/**
+ * @brief     add a member to the group
+ * @param[in] *group points to a tm1637 group structure
+ * @param[in] module is the module index on the parallel bus
+ * @return    status code
+ *            - 0 success
+ *            - 2 group is NULL
+ *            - 4 module is invalid
+ * @note      the next flush sends the whole frame and the display so that the new member catches up,
+ *            adding a dropped member back clears its dropped flag
+ */
+uint8_t tm1637_group_add_member(tm1637_group_t *group, uint8_t module);
+
+/**
+ * @brief     remove a member from the group
+ * @param[in] *group points to a tm1637 group structure
+ * @param[in] module is the module index on the parallel bus
+ * @return    status code
+ *            - 0 success
+ *            - 2 group is NULL
+ *            - 4 module is invalid
+ * @note      the removed module keeps showing its last digits
+ */
+uint8_t tm1637_group_remove_member(tm1637_group_t *group, uint8_t module);
+
+/**
+ * @brief      get the group members
+ * @param[in]  *group points to a tm1637 group structure
+ * @param[out] *members points to a member module mask buffer
+ * @param[out] *dropped points to a dropped module mask buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 group is NULL
+ * @note       none
+ */
+uint8_t tm1637_group_get_members(tm1637_group_t *group, uint16_t *members, uint16_t *dropped);
+
+/**
+ * @brief     write digits to the group
+ * @param[in] *group points to a tm1637 group structure
+ * @param[in] addr is the start address
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 2 group is NULL
+ *            - 4 addr + len > 6
+ * @note      it never touches the bus, digits equal to the sent ones are not marked changed
+ */
+uint8_t tm1637_group_write_segment(tm1637_group_t *group, uint8_t addr, uint8_t *data, uint8_t len);
+
+/**
+ * @brief     set the display of the group
+ * @param[in] *group points to a tm1637 group structure
+ * @param[in] enable is a bool value
+ * @param[in] width is the pulse width
+ * @return    status code
+ *            - 0 success
+ *            - 2 group is NULL
+ * @note      it never touches the bus
+ */
+uint8_t tm1637_group_set_display(tm1637_group_t *group, tm1637_bool_t enable, tm1637_pulse_width_t width);
+
+/**
+ * @brief      flush the changes to all members in one transmission
+ * @param[in]  *group points to a tm1637 group structure
+ * @param[out] *dropped points to a newly dropped module mask buffer, NULL is allowed
+ * @return     status code
+ *             - 0 success
+ *             - 1 a member dropped out
+ *             - 2 group is NULL
+ *             - 3 parallel is not initialized
+ * @note       a member whose dio line stays released during an ack is dropped from the group,
+ *             chips sharing one dio line ack as a wired and so a dropout shows only when all of them stop acking
+ */
+uint8_t tm1637_group_flush(tm1637_group_t *group, uint16_t *dropped);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,1133 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_link.c
+ * @brief     driver tm1637 link source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_tm1637_link.h"
+
+/**
+ * @brief decoder state definition
+ */
+#define TM1637_LINK_STATE_SOF            0        /**< hunt for sof */
+#define TM1637_LINK_STATE_SEQ            1        /**< seq */
+#define TM1637_LINK_STATE_COMMAND        2        /**< command */
+#define TM1637_LINK_STATE_LEN            3        /**< len */
+#define TM1637_LINK_STATE_PAYLOAD        4        /**< payload */
+#define TM1637_LINK_STATE_CRC_H          5        /**< crc high byte */
+#define TM1637_LINK_STATE_CRC_L          6        /**< crc low byte */
+
+/**
+ * @brief response status definition
+ */
+#define TM1637_LINK_STATUS_OK             0        /**< success */
+#define TM1637_LINK_STATUS_FAILED         1        /**< driver call failed */
+#define TM1637_LINK_STATUS_DISPLAY        4        /**< display is invalid */
+#define TM1637_LINK_STATUS_PAYLOAD        5        /**< payload is invalid */
+#define TM1637_LINK_STATUS_COMMAND        6        /**< command is unknown */
+
+/**
+ * @brief crc16 ccitt nibble table
+ */
+static const uint16_t gsc_tm1637_link_crc_table[16] =
+{
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+/**
+ * @brief     update a crc16 ccitt with one byte
+ * @param[in] crc is the current crc
+ * @param[in] byte is the next byte
+ * @return    new crc
+ * @note      polynomial 0x1021, the init value is 0xFFFF
+ */
+static uint16_t a_tm1637_link_crc(uint16_t crc, uint8_t byte)
+{
+    crc = (uint16_t)((crc << 4) ^ gsc_tm1637_link_crc_table[((crc >> 12) ^ (byte >> 4)) & 0x0F]);         /* high nibble */
+    crc = (uint16_t)((crc << 4) ^ gsc_tm1637_link_crc_table[((crc >> 12) ^ (byte & 0x0F)) & 0x0F]);       /* low nibble */
+
+    return crc;                                                                                           /* return crc */
+}
+
+/**
+ * @brief      pack a link frame
+ * @param[out] *buf points to a frame buffer with TM1637_LINK_MAX_FRAME bytes
+ * @param[out] *size points to a frame size buffer
+ * @param[in]  seq is the frame sequence
+ * @param[in]  command is the frame command
+ * @param[in]  *payload points to a payload buffer
+ * @param[in]  len is the payload length
+ * @return     status code
+ *             - 0 success
+ *             - 2 buf or size is NULL
+ *             - 4 len is over TM1637_LINK_MAX_PAYLOAD
+ * @note       the frame is sof, seq, command, len, payload and crc16 ccitt of seq to payload in big endian
+ */
+uint8_t tm1637_link_pack(uint8_t *buf, uint16_t *size, uint8_t seq, uint8_t command, uint8_t *payload, uint8_t len)
+{
+    uint16_t crc;
+    uint8_t i;
+
+    if ((buf == NULL) || (size == NULL))                            /* check buf */
+    {
+        return 2;                                                   /* return error */
+    }
+    if (len > TM1637_LINK_MAX_PAYLOAD)                              /* check len */
+    {
+        return 4;                                                   /* return error */
+    }
+
+    buf[0] = TM1637_LINK_SOF;                                       /* set sof */
+    buf[1] = seq;                                                   /* set seq */
+    buf[2] = command;                                               /* set command */
+    buf[3] = len;                                                   /* set len */
+    crc = 0xFFFF;                                                   /* init crc */
+    crc = a_tm1637_link_crc(crc, seq);                              /* crc seq */
+    crc = a_tm1637_link_crc(crc, command);                          /* crc command */
+    crc = a_tm1637_link_crc(crc, len);                              /* crc len */
+    for (i = 0; i < len; i++)                                       /* copy payload */
+    {
+        buf[4 + i] = payload[i];                                    /* set payload */
+        crc = a_tm1637_link_crc(crc, payload[i]);                   /* crc payload */
+    }
+    buf[4 + len] = (uint8_t)(crc >> 8);                             /* set crc high byte */
+    buf[5 + len] = (uint8_t)(crc & 0xFF);                           /* set crc low byte */
+    *size = (uint16_t)(len + 6);                                    /* set size */
+
+    return 0;                                                       /* success return 0 */
+}
+
+/**
+ * @brief     initialize a link decoder
+ * @param[in] *decoder points to a tm1637 link decoder structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 decoder is NULL
+ * @note      none
+ */
+uint8_t tm1637_link_decoder_init(tm1637_link_decoder_t *decoder)
+{
+    if (decoder == NULL)                                /* check decoder */
+    {
+        return 2;                                       /* return error */
+    }
+
+    decoder->state = TM1637_LINK_STATE_SOF;             /* hunt for sof */
+    decoder->len = 0;                                   /* init 0 */
+    decoder->pos = 0;                                   /* init 0 */
+    decoder->frames = 0;                                /* init 0 */
+    decoder->errors = 0;                                /* init 0 */
+
+    return 0;                                           /* success return 0 */
+}
+
+/**
+ * @brief     feed one byte to a link decoder
+ * @param[in] *decoder points to a tm1637 link decoder structure
+ * @param[in] byte is the received byte
+ * @return    status code
+ *            - 0 frame is not complete
+ *            - 1 a good frame is in seq, command, len and payload
+ * @note      a bad crc or length drops the frame and the decoder hunts for the next sof
+ */
+uint8_t tm1637_link_decode(tm1637_link_decoder_t *decoder, uint8_t byte)
+{
+    uint16_t crc;
+    uint8_t i;
+
+    switch (decoder->state)
+    {
+        case TM1637_LINK_STATE_SOF :
+        {
+            if (byte == TM1637_LINK_SOF)                                      /* check sof */
+            {
+                decoder->state = TM1637_LINK_STATE_SEQ;                       /* next */
+            }
+
+            return 0;                                                         /* not complete */
+        }
+        case TM1637_LINK_STATE_SEQ :
+        {
+            decoder->seq = byte;                                              /* save seq */
+            decoder->state = TM1637_LINK_STATE_COMMAND;                       /* next */
+
+            return 0;                                                         /* not complete */
+        }
+        case TM1637_LINK_STATE_COMMAND :
+        {
+            decoder->command = byte;                                          /* save command */
+            decoder->state = TM1637_LINK_STATE_LEN;                           /* next */
+
+            return 0;                                                         /* not complete */
+        }
+        case TM1637_LINK_STATE_LEN :
+        {
+            if (byte > TM1637_LINK_MAX_PAYLOAD)                               /* check len */
+            {
+                decoder->errors++;                                            /* errors++ */
+                decoder->state = TM1637_LINK_STATE_SOF;                       /* resync */
+
+                return 0;                                                     /* not complete */
+            }
+            decoder->len = byte;                                              /* save len */
+            decoder->pos = 0;                                                 /* init 0 */
+            decoder->state = (byte == 0) ? TM1637_LINK_STATE_CRC_H :
+                                           TM1637_LINK_STATE_PAYLOAD;         /* next */
+
+            return 0;                                                         /* not complete */
+        }
+        case TM1637_LINK_STATE_PAYLOAD :
+        {
+            decoder->payload[decoder->pos] = byte;                            /* save payload */
+            decoder->pos++;                                                   /* pos++ */
+            if (decoder->pos == decoder->len)                                 /* check the end */
+            {
+                decoder->state = TM1637_LINK_STATE_CRC_H;                     /* next */
+            }
+
+            return 0;                                                         /* not complete */
+        }
+        case TM1637_LINK_STATE_CRC_H :
+        {
+            decoder->crc = (uint16_t)(byte << 8);                             /* save crc high byte */
+            decoder->state = TM1637_LINK_STATE_CRC_L;                         /* next */
+
+            return 0;                                                         /* not complete */
+        }
+        default :
+        {
+            decoder->crc |= byte;                                             /* save crc low byte */
+            decoder->state = TM1637_LINK_STATE_SOF;                           /* hunt for the next sof */
+            crc = 0xFFFF;                                                     /* init crc */
+            crc = a_tm1637_link_crc(crc, decoder->seq);                       /* crc seq */
+            crc = a_tm1637_link_crc(crc, decoder->command);                   /* crc command */
+            crc = a_tm1637_link_crc(crc, decoder->len);                       /* crc len */
+            for (i = 0; i < decoder->len; i++)                                /* loop payload */
+            {
+                crc = a_tm1637_link_crc(crc, decoder->payload[i]);            /* crc payload */
+            }
+            if (crc != decoder->crc)                                          /* check crc */
+            {
+                decoder->errors++;                                            /* errors++ */
+
+                return 0;                                                     /* drop the frame */
+            }
+            decoder->frames++;                                                /* frames++ */
+
+            return 1;                                                         /* complete */
+        }
+    }
+}
+
+/**
+ * @brief     initialize a link server
+ * @param[in] *server points to a tm1637 link server structure
+ * @param[in] **handle points to an initialized tm1637 handle list
+ * @param[in] num is the handle number
+ * @param[in] *write points to a byte write function address
+ * @param[in] *ctx is the write context
+ * @return    status code
+ *            - 0 success
+ *            - 2 server, handle or write is NULL
+ *            - 4 num is invalid
+ * @note      every handle should be in the increase address mode, a handle which is not inited,
+ *            such as a display that is not fitted, answers TM1637_LINK_STATUS_FAILED
+ */
+uint8_t tm1637_link_server_init(tm1637_link_server_t *server, tm1637_handle_t **handle, uint8_t num,
+                                uint8_t (*write)(void *ctx, uint8_t *buf, uint16_t len), void *ctx)
+{
+    if ((server == NULL) || (handle == NULL) || (write == NULL))        /* check server */
+    {
+        return 2;                                                       /* return error */
+    }
+    if (num == 0)                                                       /* check num */
+    {
+        return 4;                                                       /* return error */
+    }
+
+    server->handle = handle;                                            /* save handle list */
+    server->handle_num = num;                                           /* save handle number */
+    server->write = write;                                              /* save write */
+    server->ctx = ctx;                                                  /* save ctx */
+    server->batch_len = 0;                                              /* init 0 */
+    (void)tm1637_link_decoder_init(&server->decoder);                   /* init decoder */
+
+    return 0;                                                           /* success return 0 */
+}
+
+/**
+ * @brief     run one decoded request
+ * @param[in] *server points to a tm1637 link server structure
+ * @param[in] *reply points to a reply buffer with 17 bytes, reply[0] is the status
+ * @return    reply length
+ * @note      none
+ */
+static uint8_t a_tm1637_link_server_run(tm1637_link_server_t *server, uint8_t *reply)
+{
+    tm1637_link_decoder_t *decoder = &server->decoder;
+    uint8_t *payload = decoder->payload;
+    uint8_t len = decoder->len;
+    uint8_t num;
+    uint8_t pos;
+    uint8_t i;
+
+    if (len == 0)                                                                                  /* every request names a display */
+    {
+        reply[0] = TM1637_LINK_STATUS_PAYLOAD;                                                     /* payload is invalid */
+
+        return 1;                                                                                  /* return the status */
+    }
+    if (payload[0] >= server->handle_num)                                                          /* check display */
+    {
+        reply[0] = TM1637_LINK_STATUS_DISPLAY;                                                     /* display is invalid */
+
+        return 1;                                                                                  /* return the status */
+    }
+
+    reply[0] = TM1637_LINK_STATUS_OK;                                                              /* init ok */
+    switch (decoder->command)
+    {
+        case TM1637_LINK_COMMAND_WRITE_SEGMENT :
+        {
+            if ((len < 3) || (payload[1] + (len - 2) > 6))                                         /* check addr and data */
+            {
+                reply[0] = TM1637_LINK_STATUS_PAYLOAD;                                             /* payload is invalid */
+            }
+            else if (tm1637_write_segment(server->handle[payload[0]], payload[1],
+                                          &payload[2], (uint8_t)(len - 2)) != 0)                   /* write segment */
+            {
+                reply[0] = TM1637_LINK_STATUS_FAILED;                                              /* failed */
+            }
+
+            return 1;                                                                              /* return the status */
+        }
+        case TM1637_LINK_COMMAND_WRITE_FRAME :
+        {
+            num = (uint8_t)((len - 1) / 6);                                                        /* display number */
+            if ((num == 0) || ((len - 1) % 6 != 0))                                                /* check frames */
+            {
+                reply[0] = TM1637_LINK_STATUS_PAYLOAD;                                             /* payload is invalid */
+
+                return 1;                                                                          /* return the status */
+            }
+            if (payload[0] + num > server->handle_num)                                             /* check the last display */
+            {
+                reply[0] = TM1637_LINK_STATUS_DISPLAY;                                             /* display is invalid */
+
+                return 1;                                                                          /* return the status */
+            }
+            for (i = 0; i < num; i++)                                                              /* loop all displays */
+            {
+                if (tm1637_write_segment(server->handle[payload[0] + i], 0,
+                                         &payload[1 + i * 6], 6) != 0)                             /* write the frame */
+                {
+                    reply[0] = TM1637_LINK_STATUS_FAILED;                                          /* failed */
+                }
+            }
+
+            return 1;                                                                              /* return the status */
+        }
+        case TM1637_LINK_COMMAND_SET_DISPLAY :
+        {
+            if ((len != 3) || (payload[2] > TM1637_PULSE_WIDTH_14_DIV_16))                         /* check width */
+            {
+                reply[0] = TM1637_LINK_STATUS_PAYLOAD;                                             /* payload is invalid */
+            }
+            else if ((tm1637_set_pulse_width(server->handle[payload[0]],
+                                             (tm1637_pulse_width_t)payload[2]) != 0) ||
+                     (tm1637_set_display(server->handle[payload[0]],
+                                         (payload[1] != 0) ? TM1637_BOOL_TRUE : TM1637_BOOL_FALSE) != 0)) /* set display */
+            {
+                reply[0] = TM1637_LINK_STATUS_FAILED;                                              /* failed */
+            }
+
+            return 1;                                                                              /* return the status */
+        }
+        case TM1637_LINK_COMMAND_READ_KEY :
+        {
+            if (len != 1)                                                                          /* check len */
+            {
+                reply[0] = TM1637_LINK_STATUS_PAYLOAD;                                             /* payload is invalid */
+
+                return 1;                                                                          /* return the status */
+            }
+            if (tm1637_read_segment(server->handle[payload[0]], &reply[1], &reply[2]) != 0)        /* read segment */
+            {
+                reply[0] = TM1637_LINK_STATUS_FAILED;                                              /* failed */
+
+                return 1;                                                                          /* return the status */
+            }
+
+            return 3;                                                                              /* status, seg and k */
+        }
+        case TM1637_LINK_COMMAND_SET_REG :
+        {
+            for (pos = 0; pos < len; pos = (uint8_t)(pos + 3 + payload[pos + 2]))                  /* loop all entries */
+            {
+                if ((pos + 3 > len) || (payload[pos + 2] > 16) ||
+                    (pos + 3 + payload[pos + 2] > len))                                            /* check the entry */
+                {
+                    reply[0] = TM1637_LINK_STATUS_PAYLOAD;                                         /* payload is invalid */
+
+                    return 1;                                                                      /* return the status */
+                }
+                if (payload[pos] >= server->handle_num)                                            /* check display */
+                {
+                    reply[0] = TM1637_LINK_STATUS_DISPLAY;                                         /* display is invalid */
+
+                    return 1;                                                                      /* return the status */
+                }
+                if (tm1637_set_reg(server->handle[payload[pos]], payload[pos + 1],
+                                   &payload[pos + 3], payload[pos + 2]) != 0)                      /* write the register */
+                {
+                    reply[0] = TM1637_LINK_STATUS_FAILED;                                          /* failed */
+
+                    return 1;                                                                      /* later entries are skipped */
+                }
+            }
+
+            return 1;                                                                              /* return the status */
+        }
+        case TM1637_LINK_COMMAND_GET_REG :
+        {
+            if ((len != 3) || (payload[2] > 16))                                                   /* check len */
+            {
+                reply[0] = TM1637_LINK_STATUS_PAYLOAD;                                             /* payload is invalid */
+
+                return 1;                                                                          /* return the status */
+            }
+            if (tm1637_get_reg(server->handle[payload[0]], payload[1], &reply[1], payload[2]) != 0) /* read the register */
+            {
+                reply[0] = TM1637_LINK_STATUS_FAILED;                                              /* failed */
+
+                return 1;                                                                          /* return the status */
+            }
+
+            return (uint8_t)(1 + payload[2]);                                                      /* status and data */
+        }
+        default :
+        {
+            reply[0] = TM1637_LINK_STATUS_COMMAND;                                                 /* command is unknown */
+
+            return 1;                                                                              /* return the status */
+        }
+    }
+}
+
+/**
+ * @brief     run the received bytes
+ * @param[in] *server points to a tm1637 link server structure
+ * @param[in] *buf points to a received byte buffer
+ * @param[in] len is the buffer length
+ * @return    status code
+ *            - 0 success
+ *            - 1 response write failed
+ *            - 2 server or buf is NULL
+ * @note      frames may be split at any byte, every good frame runs in order and gets one response,
+ *            the responses of one call go out in as few writes as possible
+ */
+uint8_t tm1637_link_server_input(tm1637_link_server_t *server, uint8_t *buf, uint16_t len)
+{
+    uint8_t res;
+    uint8_t reply[17];
+    uint8_t reply_len;
+    uint16_t size;
+    uint16_t i;
+
+    if ((server == NULL) || (buf == NULL))                                                         /* check server */
+    {
+        return 2;                                                                                  /* return error */
+    }
+
+    res = 0;                                                                                       /* init 0 */
+    for (i = 0; i < len; i++)                                                                      /* loop all bytes */
+    {
+        if (tm1637_link_decode(&server->decoder, buf[i]) == 0)                                     /* not a frame yet */
+        {
+            continue;                                                                              /* next */
+        }
+        if ((server->decoder.command & TM1637_LINK_RESPONSE) != 0)                                 /* ignore echoed responses */
+        {
+            continue;                                                                              /* next */
+        }
+        reply_len = a_tm1637_link_server_run(server, reply);                                       /* run the request */
+        if (server->batch_len + reply_len + 6 > TM1637_LINK_BATCH_LEN)                             /* batch is full */
+        {
+            if (server->write(server->ctx, server->batch, server->batch_len) != 0)                 /* write the batch */
+            {
+                res = 1;                                                                           /* write failed */
+            }
+            server->batch_len = 0;                                                                 /* clear the batch */
+        }
+        (void)tm1637_link_pack(&server->batch[server->batch_len], &size, server->decoder.seq,
+                               (uint8_t)(server->decoder.command | TM1637_LINK_RESPONSE),
+                               reply, reply_len);                                                  /* pack the response */
+        server->batch_len += size;                                                                 /* append */
+    }
+    if (server->batch_len != 0)                                                                    /* responses left */
+    {
+        if (server->write(server->ctx, server->batch, server->batch_len) != 0)                     /* write the batch */
+        {
+            res = 1;                                                                               /* write failed */
+        }
+        server->batch_len = 0;                                                                     /* clear the batch */
+    }
+
+    return res;                                                                                    /* return the result */
+}
+
+/**
+ * @brief      get the link server receive state
+ * @param[in]  *server points to a tm1637 link server structure
+ * @param[out] *pending points to a pending flag buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 server is NULL
+ * @note       pending is 1 while a frame is partly received, the next bytes belong to the link
+ */
+uint8_t tm1637_link_server_get_pending(tm1637_link_server_t *server, uint8_t *pending)
+{
+    if (server == NULL)                                                                     /* check server */
+    {
+        return 2;                                                                           /* return error */
+    }
+
+    *pending = (server->decoder.state != TM1637_LINK_STATE_SOF) ? 1 : 0;                    /* get pending */
+
+    return 0;                                                                               /* success return 0 */
+}
+
+/**
+ * @brief      get the link server statistics
+ * @param[in]  *server points to a tm1637 link server structure
+ * @param[out] *frames points to a good frame counter buffer
+ * @param[out] *errors points to a bad frame counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 server is NULL
+ * @note       none
+ */
+uint8_t tm1637_link_server_get_statistics(tm1637_link_server_t *server, uint32_t *frames, uint32_t *errors)
+{
+    if (server == NULL)                                    /* check server */
+    {
+        return 2;                                          /* return error */
+    }
+
+    *frames = server->decoder.frames;                      /* get frames */
+    *errors = server->decoder.errors;                      /* get errors */
+
+    return 0;                                              /* success return 0 */
+}
+
+/**
+ * @brief     initialize a link client
+ * @param[in] *client points to a tm1637 link client structure
+ * @param[in] *write points to a byte write function address
+ * @param[in] *read points to a byte read function address, it returns 0 after timeout_ms without data
+ * @param[in] *ctx is the transport context
+ * @param[in] window is the max in flight byte number
+ * @return    status code
+ *            - 0 success
+ *            - 2 client, write or read is NULL
+ *            - 4 window is smaller than TM1637_LINK_MAX_FRAME
+ * @note      window must not exceed the receive buffer of the server
+ */
+uint8_t tm1637_link_client_init(tm1637_link_client_t *client,
+                                uint8_t (*write)(void *ctx, uint8_t *buf, uint16_t len),
+                                uint16_t (*read)(void *ctx, uint8_t *buf, uint16_t len, uint32_t timeout_ms),
+                                void *ctx, uint16_t window)
+{
+    if ((client == NULL) || (write == NULL) || (read == NULL))        /* check client */
+    {
+        return 2;                                                     /* return error */
+    }
+    if (window < TM1637_LINK_MAX_FRAME)                               /* check window */
+    {
+        return 4;                                                     /* return error */
+    }
+
+    client->write = write;                                            /* save write */
+    client->read = read;                                              /* save read */
+    client->ctx = ctx;                                                /* save ctx */
+    client->window = window;                                          /* save window */
+    client->batch_len = 0;                                            /* init 0 */
+    client->seq = 0;                                                  /* init 0 */
+    client->ack = 0;                                                  /* init 0 */
+    client->inflight = 0;                                             /* init 0 */
+    client->inflight_len = 0;                                         /* init 0 */
+    client->open = 0xFFFF;                                            /* no open frame */
+    client->status = 0;                                               /* init 0 */
+    client->wait_done = 1;                                            /* no read is awaited */
+    client->sent = 0;                                                 /* init 0 */
+    client->acked = 0;                                                /* init 0 */
+    client->errors = 0;                                               /* init 0 */
+    (void)tm1637_link_decoder_init(&client->decoder);                 /* init decoder */
+
+    return 0;                                                         /* success return 0 */
+}
+
+/**
+ * @brief     link client forget all in flight frames
+ * @param[in] *client points to a tm1637 link client structure
+ * @note      none
+ */
+static void a_tm1637_link_client_drop(tm1637_link_client_t *client)
+{
+    client->errors += client->inflight;                  /* every in flight frame is lost */
+    client->inflight = 0;                                /* init 0 */
+    client->inflight_len = 0;                            /* init 0 */
+    client->ack = client->seq;                           /* nothing is awaited */
+    client->batch_len = 0;                               /* clear the batch */
+    client->open = 0xFFFF;                               /* no open frame */
+    if (client->status == 0)                             /* keep the first status */
+    {
+        client->status = 1;                              /* link failed */
+    }
+}
+
+/**
+ * @brief     link client finish the open set reg frame
+ * @param[in] *client points to a tm1637 link client structure
+ * @note      the crc is written when no more entries join the frame
+ */
+static void a_tm1637_link_client_close(tm1637_link_client_t *client)
+{
+    uint16_t crc;
+    uint16_t i;
+
+    if (client->open == 0xFFFF)                                             /* no open frame */
+    {
+        return;                                                             /* return */
+    }
+    crc = 0xFFFF;                                                           /* init crc */
+    for (i = client->open + 1; i < client->batch_len; i++)                  /* seq to payload */
+    {
+        crc = a_tm1637_link_crc(crc, client->batch[i]);                     /* crc */
+    }
+    client->batch[client->batch_len] = (uint8_t)(crc >> 8);                 /* set crc high byte */
+    client->batch[client->batch_len + 1] = (uint8_t)(crc & 0xFF);           /* set crc low byte */
+    client->batch_len += 2;                                                 /* append */
+    client->open = 0xFFFF;                                                  /* no open frame */
+}
+
+/**
+ * @brief     link client write the batch
+ * @param[in] *client points to a tm1637 link client structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+static uint8_t a_tm1637_link_client_send(tm1637_link_client_t *client)
+{
+    a_tm1637_link_client_close(client);                                            /* finish the open frame */
+    if (client->batch_len == 0)                                                    /* nothing queued */
+    {
+        return 0;                                                                  /* success return 0 */
+    }
+    if (client->write(client->ctx, client->batch, client->batch_len) != 0)         /* write the batch */
+    {
+        a_tm1637_link_client_drop(client);                                         /* drop all */
+
+        return 1;                                                                  /* return error */
+    }
+    client->batch_len = 0;                                                         /* clear the batch */
+
+    return 0;                                                                      /* success return 0 */
+}
+
+/**
+ * @brief     link client receive the responses
+ * @param[in] *client points to a tm1637 link client structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 timeout
+ * @note      responses come in request order, a skipped sequence is a lost frame
+ */
+static uint8_t a_tm1637_link_client_receive(tm1637_link_client_t *client)
+{
+    tm1637_link_decoder_t *decoder = &client->decoder;
+    uint8_t buf[64];
+    uint16_t len;
+    uint16_t i;
+
+    len = client->read(client->ctx, buf, 64, TM1637_LINK_TIMEOUT);                                 /* read the bytes */
+    if (len == 0)                                                                                  /* timeout */
+    {
+        a_tm1637_link_client_drop(client);                                                         /* drop all */
+
+        return 1;                                                                                  /* return error */
+    }
+    for (i = 0; i < len; i++)                                                                      /* loop all bytes */
+    {
+        if (tm1637_link_decode(decoder, buf[i]) == 0)                                              /* not a frame yet */
+        {
+            continue;                                                                              /* next */
+        }
+        if (((decoder->command & TM1637_LINK_RESPONSE) == 0) || (decoder->len == 0) ||
+            ((uint8_t)(decoder->seq - client->ack) >= client->inflight))                           /* not an awaited response */
+        {
+            client->errors++;                                                                      /* errors++ */
+
+            continue;                                                                              /* next */
+        }
+        while (client->ack != decoder->seq)                                                        /* skipped responses */
+        {
+            client->inflight_len -= client->size[client->ack % TM1637_LINK_MAX_INFLIGHT];          /* release */
+            client->inflight--;                                                                    /* inflight-- */
+            client->ack++;                                                                         /* next */
+            client->errors++;                                                                      /* lost */
+            if (client->status == 0)                                                               /* keep the first status */
+            {
+                client->status = 1;                                                                /* link failed */
+            }
+        }
+        client->inflight_len -= client->size[client->ack % TM1637_LINK_MAX_INFLIGHT];              /* release */
+        client->inflight--;                                                                        /* inflight-- */
+        client->ack++;                                                                             /* next */
+        client->acked++;                                                                           /* acked++ */
+        if ((client->wait_done == 0) && (decoder->seq == client->wait))                            /* the awaited read */
+        {
+            client->reply_len = (decoder->len > 17) ? 17 : decoder->len;                           /* save length */
+            memcpy(client->reply, decoder->payload, client->reply_len);                            /* save payload */
+            client->wait_done = 1;                                                                 /* done */
+        }
+        else if (decoder->payload[0] != 0)                                                         /* command failed */
+        {
+            client->errors++;                                                                      /* errors++ */
+            if (client->status == 0)                                                               /* keep the first status */
+            {
+                client->status = decoder->payload[0];                                              /* save status */
+            }
+        }
+    }
+
+    return 0;                                                                                      /* success return 0 */
+}
+
+/**
+ * @brief     link client queue a request
+ * @param[in] *client points to a tm1637 link client structure
+ * @param[in] command is the request command
+ * @param[in] *payload points to a payload buffer
+ * @param[in] len is the payload length
+ * @param[in] open is 1 when later set reg entries may join the frame
+ * @return    status code
+ *            - 0 success
+ *            - 1 link failed
+ * @note      it waits for responses while the window is full
+ */
+static uint8_t a_tm1637_link_client_queue(tm1637_link_client_t *client, uint8_t command,
+                                          uint8_t *payload, uint8_t len, uint8_t open)
+{
+    uint16_t size;
+    uint16_t pos;
+
+    a_tm1637_link_client_close(client);                                                            /* finish the open frame */
+    size = (uint16_t)(len + 6);                                                                    /* frame size */
+    while ((client->inflight_len + size > client->window) ||
+           (client->inflight == TM1637_LINK_MAX_INFLIGHT))                                         /* window is full */
+    {
+        if (a_tm1637_link_client_send(client) != 0)                                                /* send the batch */
+        {
+            return 1;                                                                              /* return error */
+        }
+        if (a_tm1637_link_client_receive(client) != 0)                                             /* wait for responses */
+        {
+            return 1;                                                                              /* return error */
+        }
+    }
+    if (client->batch_len + size > TM1637_LINK_BATCH_LEN)                                          /* batch is full */
+    {
+        if (a_tm1637_link_client_send(client) != 0)                                                /* send the batch */
+        {
+            return 1;                                                                              /* return error */
+        }
+    }
+    pos = client->batch_len;                                                                       /* frame position */
+    (void)tm1637_link_pack(&client->batch[pos], &size, client->seq, command, payload, len);        /* pack the request */
+    client->batch_len += size;                                                                     /* append */
+    if (open != 0)                                                                                 /* entries may join */
+    {
+        client->batch_len -= 2;                                                                    /* the crc comes at close */
+        client->open = pos;                                                                        /* save the position */
+    }
+    client->size[client->seq % TM1637_LINK_MAX_INFLIGHT] = (uint8_t)size;                          /* save size */
+    client->inflight++;                                                                            /* inflight++ */
+    client->inflight_len += size;                                                                  /* inflight_len += size */
+    client->seq++;                                                                                 /* next */
+    client->sent++;                                                                                /* sent++ */
+
+    return 0;                                                                                      /* success return 0 */
+}
+
+/**
+ * @brief     queue a segment write
+ * @param[in] *client points to a tm1637 link client structure
+ * @param[in] display is the display index
+ * @param[in] addr is the start address
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 link failed
+ *            - 2 client or data is NULL
+ *            - 4 addr + len > 6
+ * @note      the write is pipelined, its result is reported by tm1637_link_client_sync
+ */
+uint8_t tm1637_link_client_write_segment(tm1637_link_client_t *client, uint8_t display, uint8_t addr, uint8_t *data, uint8_t len)
+{
+    uint8_t payload[8];
+
+    if ((client == NULL) || (data == NULL))                                                            /* check client */
+    {
+        return 2;                                                                                      /* return error */
+    }
+    if ((len == 0) || (addr + len > 6))                                                                /* check len */
+    {
+        return 4;                                                                                      /* return error */
+    }
+
+    payload[0] = display;                                                                              /* set display */
+    payload[1] = addr;                                                                                 /* set addr */
+    memcpy(&payload[2], data, len);                                                                    /* copy data */
+
+    return a_tm1637_link_client_queue(client, TM1637_LINK_COMMAND_WRITE_SEGMENT, payload,
+                                      (uint8_t)(len + 2), 0);                                             /* queue the request */
+}
+
+/**
+ * @brief     queue a bulk frame write
+ * @param[in] *client points to a tm1637 link client structure
+ * @param[in] display is the start display index
+ * @param[in] num is the display number
+ * @param[in] *data points to a data buffer with 6 bytes per display
+ * @return    status code
+ *            - 0 success
+ *            - 1 link failed
+ *            - 2 client or data is NULL
+ *            - 4 num is invalid
+ * @note      one link frame carries up to (TM1637_LINK_MAX_PAYLOAD - 1) / 6 displays
+ */
+uint8_t tm1637_link_client_write_frame(tm1637_link_client_t *client, uint8_t display, uint8_t num, uint8_t *data)
+{
+    uint8_t payload[TM1637_LINK_MAX_PAYLOAD];
+
+    if ((client == NULL) || (data == NULL))                                                            /* check client */
+    {
+        return 2;                                                                                      /* return error */
+    }
+    if ((num == 0) || (num > (TM1637_LINK_MAX_PAYLOAD - 1) / 6))                                       /* check num */
+    {
+        return 4;                                                                                      /* return error */
+    }
+
+    payload[0] = display;                                                                              /* set display */
+    memcpy(&payload[1], data, num * 6);                                                                /* copy frames */
+
+    return a_tm1637_link_client_queue(client, TM1637_LINK_COMMAND_WRITE_FRAME, payload,
+                                      (uint8_t)(1 + num * 6), 0);                                         /* queue the request */
+}
+
+/**
+ * @brief     queue a display setting
+ * @param[in] *client points to a tm1637 link client structure
+ * @param[in] display is the display index
+ * @param[in] enable is a bool value
+ * @param[in] width is the pulse width
+ * @return    status code
+ *            - 0 success
+ *            - 1 link failed
+ *            - 2 client is NULL
+ * @note      the width sets the brightness
+ */
+uint8_t tm1637_link_client_set_display(tm1637_link_client_t *client, uint8_t display, tm1637_bool_t enable, tm1637_pulse_width_t width)
+{
+    uint8_t payload[3];
+
+    if (client == NULL)                                                                                /* check client */
+    {
+        return 2;                                                                                      /* return error */
+    }
+
+    payload[0] = display;                                                                              /* set display */
+    payload[1] = (uint8_t)enable;                                                                      /* set enable */
+    payload[2] = (uint8_t)width;                                                                       /* set width */
+
+    return a_tm1637_link_client_queue(client, TM1637_LINK_COMMAND_SET_DISPLAY, payload, 3, 0);            /* queue the request */
+}
+
+/**
+ * @brief     link client run a request and wait for its response
+ * @param[in] *client points to a tm1637 link client structure
+ * @param[in] command is the request command
+ * @param[in] *payload points to a payload buffer
+ * @param[in] len is the payload length
+ * @return    status code
+ *            - 0 success, the response is in reply
+ *            - 1 link failed or the response status is not 0
+ * @note      the queued commands go out first and their responses are handled on the way
+ */
+static uint8_t a_tm1637_link_client_request(tm1637_link_client_t *client, uint8_t command, uint8_t *payload, uint8_t len)
+{
+    client->wait_done = 1;                                                                             /* nothing is awaited yet */
+    if (a_tm1637_link_client_queue(client, command, payload, len, 0) != 0)                             /* queue the request */
+    {
+        return 1;                                                                                      /* return error */
+    }
+    client->wait = (uint8_t)(client->seq - 1);                                                         /* await this sequence */
+    client->wait_done = 0;                                                                             /* not done */
+    if (a_tm1637_link_client_send(client) != 0)                                                        /* send the batch */
+    {
+        return 1;                                                                                      /* return error */
+    }
+    while ((client->wait_done == 0) &&
+           ((uint8_t)(client->wait - client->ack) < client->inflight))                                 /* still in flight */
+    {
+        if (a_tm1637_link_client_receive(client) != 0)                                                 /* wait for responses */
+        {
+            return 1;                                                                                  /* return error */
+        }
+    }
+    if ((client->wait_done == 0) || (client->reply[0] != 0))                                           /* lost or failed */
+    {
+        client->wait_done = 1;                                                                         /* stop waiting */
+
+        return 1;                                                                                      /* return error */
+    }
+
+    return 0;                                                                                          /* success return 0 */
+}
+
+/**
+ * @brief      read the key of a display
+ * @param[in]  *client points to a tm1637 link client structure
+ * @param[in]  display is the display index
+ * @param[out] *seg points to a seg buffer
+ * @param[out] *k points to a k buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 link or read failed
+ *             - 2 client, seg or k is NULL
+ * @note       the queued commands go out before the read and the call blocks for its response
+ */
+uint8_t tm1637_link_client_read_key(tm1637_link_client_t *client, uint8_t display, uint8_t *seg, uint8_t *k)
+{
+    if ((client == NULL) || (seg == NULL) || (k == NULL))                                              /* check client */
+    {
+        return 2;                                                                                      /* return error */
+    }
+
+    if ((a_tm1637_link_client_request(client, TM1637_LINK_COMMAND_READ_KEY, &display, 1) != 0) ||
+        (client->reply_len != 3))                                                                      /* read key */
+    {
+        return 1;                                                                                      /* return error */
+    }
+    *seg = client->reply[1];                                                                           /* get seg */
+    *k = client->reply[2];                                                                             /* get k */
+
+    return 0;                                                                                          /* success return 0 */
+}
+
+/**
+ * @brief     queue a register write
+ * @param[in] *client points to a tm1637 link client structure
+ * @param[in] display is the display index
+ * @param[in] cmd is the chip command
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 link failed
+ *            - 2 client is NULL
+ *            - 4 len is over 16
+ * @note      the write is pipelined and joins the last queued set reg frame while it has room,
+ *            so back to back writes of any display share one link frame and one response
+ */
+uint8_t tm1637_link_client_set_reg(tm1637_link_client_t *client, uint8_t display, uint8_t cmd, uint8_t *data, uint8_t len)
+{
+    uint8_t entry[19];
+    uint16_t size;
+
+    if ((client == NULL) || ((data == NULL) && (len != 0)))                                            /* check client */
+    {
+        return 2;                                                                                      /* return error */
+    }
+    if (len > 16)                                                                                      /* check len */
+    {
+        return 4;                                                                                      /* return error */
+    }
+
+    entry[0] = display;                                                                                /* set display */
+    entry[1] = cmd;                                                                                    /* set cmd */
+    entry[2] = len;                                                                                    /* set len */
+    if (len != 0)                                                                                      /* check len */
+    {
+        memcpy(&entry[3], data, len);                                                                  /* copy data */
+    }
+    size = (uint16_t)(3 + len);                                                                        /* entry size */
+    if ((client->open != 0xFFFF) &&
+        (client->batch[client->open + 3] + size <= TM1637_LINK_MAX_PAYLOAD) &&
+        (client->batch_len + size + 2 <= TM1637_LINK_BATCH_LEN) &&
+        (client->inflight_len + size <= client->window))                                               /* the open frame has room */
+    {
+        memcpy(&client->batch[client->batch_len], entry, size);                                        /* append the entry */
+        client->batch[client->open + 3] = (uint8_t)(client->batch[client->open + 3] + size);           /* update len */
+        client->batch_len += size;                                                                     /* batch_len += size */
+        client->size[(uint8_t)(client->seq - 1) % TM1637_LINK_MAX_INFLIGHT] =
+            (uint8_t)(client->size[(uint8_t)(client->seq - 1) % TM1637_LINK_MAX_INFLIGHT] + size);     /* grow the frame */
+        client->inflight_len += size;                                                                  /* inflight_len += size */
+
+        return 0;                                                                                      /* success return 0 */
+    }
+
+    return a_tm1637_link_client_queue(client, TM1637_LINK_COMMAND_SET_REG, entry, (uint8_t)size, 1);   /* open a new frame */
+}
+
+/**
+ * @brief      read a register
+ * @param[in]  *client points to a tm1637 link client structure
+ * @param[in]  display is the display index
+ * @param[in]  cmd is the chip command
+ * @param[out] *data points to a data buffer
+ * @param[in]  len is the data length
+ * @return     status code
+ *             - 0 success
+ *             - 1 link or read failed
+ *             - 2 client or data is NULL
+ *             - 4 len is over 16
+ * @note       the queued commands go out before the read and the call blocks for its response
+ */
+uint8_t tm1637_link_client_get_reg(tm1637_link_client_t *client, uint8_t display, uint8_t cmd, uint8_t *data, uint8_t len)
+{
+    uint8_t payload[3];
+
+    if ((client == NULL) || (data == NULL))                                                            /* check client */
+    {
+        return 2;                                                                                      /* return error */
+    }
+    if (len > 16)                                                                                      /* check len */
+    {
+        return 4;                                                                                      /* return error */
+    }
+
+    payload[0] = display;                                                                              /* set display */
+    payload[1] = cmd;                                                                                  /* set cmd */
+    payload[2] = len;                                                                                  /* set len */
+    if ((a_tm1637_link_client_request(client, TM1637_LINK_COMMAND_GET_REG, payload, 3) != 0) ||
+        (client->reply_len != len + 1))                                                                /* read the register */
+    {
+        return 1;                                                                                      /* return error */
+    }
+    memcpy(data, &client->reply[1], len);                                                              /* copy data */
+
+    return 0;                                                                                          /* success return 0 */
+}
+
+/**
+ * @brief     send the queued commands
+ * @param[in] *client points to a tm1637 link client structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 link failed
+ *            - 2 client is NULL
+ * @note      it does not wait for the responses
+ */
+uint8_t tm1637_link_client_flush(tm1637_link_client_t *client)
+{
+    if (client == NULL)                                         /* check client */
+    {
+        return 2;                                               /* return error */
+    }
+
+    return a_tm1637_link_client_send(client);                   /* send the batch */
+}
+
+/**
+ * @brief     send the queued commands and wait for all responses
+ * @param[in] *client points to a tm1637 link client structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 link failed or a command failed since the last sync
+ *            - 2 client is NULL
+ * @note      none
+ */
+uint8_t tm1637_link_client_sync(tm1637_link_client_t *client)
+{
+    uint8_t res;
+
+    if (client == NULL)                                                /* check client */
+    {
+        return 2;                                                      /* return error */
+    }
+
+    (void)a_tm1637_link_client_send(client);                           /* send the batch */
+    while (client->inflight != 0)                                      /* wait for all responses */
+    {
+        if (a_tm1637_link_client_receive(client) != 0)                 /* receive */
+        {
+            break;                                                     /* break */
+        }
+    }
+    res = (client->status != 0) ? 1 : 0;                               /* get the result */
+    client->status = 0;                                                /* clear the status */
+
+    return res;                                                        /* return the result */
+}
+
+/**
+ * @brief      get the link client statistics
+ * @param[in]  *client points to a tm1637 link client structure
+ * @param[out] *sent points to a sent frame counter buffer
+ * @param[out] *acked points to an acknowledged frame counter buffer
+ * @param[out] *errors points to an error counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 client is NULL
+ * @note       errors counts failed responses, lost frames, timeouts and bad received frames
+ */
+uint8_t tm1637_link_client_get_statistics(tm1637_link_client_t *client, uint32_t *sent, uint32_t *acked, uint32_t *errors)
+{
+    if (client == NULL)                                            /* check client */
+    {
+        return 2;                                                  /* return error */
+    }
+
+    *sent = client->sent;                                          /* get sent */
+    *acked = client->acked;                                        /* get acked */
+    *errors = client->errors + client->decoder.errors;             /* get errors */
+
+    return 0;                                                      /* success return 0 */
+}
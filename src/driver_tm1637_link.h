@@ -0,0 +1,436 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_link.h
+ * @brief     driver tm1637 link header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef DRIVER_TM1637_LINK_H
+#define DRIVER_TM1637_LINK_H
+
+#include "driver_tm1637.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup tm1637_link_driver tm1637 link driver function
+ * @brief    tm1637 link driver modules
+ * @ingroup  tm1637_driver
+ * @{
+ */
+
+/**
+ * @brief tm1637 link max payload definition
+ */
+#ifndef TM1637_LINK_MAX_PAYLOAD
+    #define TM1637_LINK_MAX_PAYLOAD        100         /**< one start display and 16 frames */
+#endif
+
+/**
+ * @brief tm1637 link max in flight frame definition
+ */
+#ifndef TM1637_LINK_MAX_INFLIGHT
+    #define TM1637_LINK_MAX_INFLIGHT       32          /**< 32 frames */
+#endif
+
+/**
+ * @brief tm1637 link batch buffer length definition
+ */
+#ifndef TM1637_LINK_BATCH_LEN
+    #define TM1637_LINK_BATCH_LEN          256         /**< 256 bytes */
+#endif
+
+/**
+ * @brief tm1637 link response timeout definition
+ */
+#ifndef TM1637_LINK_TIMEOUT
+    #define TM1637_LINK_TIMEOUT            1000        /**< 1000 ms */
+#endif
+
+/**
+ * @brief tm1637 link frame definition
+ */
+#define TM1637_LINK_SOF                    0xA5                                   /**< start of frame, never a shell character */
+#define TM1637_LINK_MAX_FRAME              (TM1637_LINK_MAX_PAYLOAD + 6)          /**< sof, seq, command, len, payload and crc */
+#define TM1637_LINK_RESPONSE               0x80                                   /**< response command flag */
+
+/**
+ * @brief tm1637 link command enumeration definition
+ */
+typedef enum
+{
+    TM1637_LINK_COMMAND_WRITE_SEGMENT = 0x01,        /**< display, addr and 1 - 6 segment bytes */
+    TM1637_LINK_COMMAND_WRITE_FRAME   = 0x02,        /**< start display and 6 segment bytes per display */
+    TM1637_LINK_COMMAND_SET_DISPLAY   = 0x03,        /**< display, enable and pulse width */
+    TM1637_LINK_COMMAND_READ_KEY      = 0x04,        /**< display, the response carries seg and k */
+    TM1637_LINK_COMMAND_SET_REG       = 0x05,        /**< entries of display, cmd, len and 0 - 16 data bytes */
+    TM1637_LINK_COMMAND_GET_REG       = 0x06,        /**< display, cmd and len, the response carries len data bytes */
+} tm1637_link_command_t;
+
+/**
+ * @brief tm1637 link decoder structure definition
+ */
+typedef struct tm1637_link_decoder_s
+{
+    uint8_t state;                                     /**< decoder state */
+    uint8_t seq;                                       /**< frame sequence */
+    uint8_t command;                                   /**< frame command */
+    uint8_t len;                                       /**< payload length */
+    uint8_t pos;                                       /**< payload position */
+    uint8_t payload[TM1637_LINK_MAX_PAYLOAD];          /**< payload */
+    uint16_t crc;                                      /**< received crc */
+    uint32_t frames;                                   /**< good frame counter */
+    uint32_t errors;                                   /**< crc and length error counter */
+} tm1637_link_decoder_t;
+
+/**
+ * @brief tm1637 link server structure definition
+ */
+typedef struct tm1637_link_server_s
+{
+    tm1637_handle_t **handle;                                     /**< tm1637 handle list */
+    uint8_t handle_num;                                           /**< tm1637 handle number */
+    uint8_t (*write)(void *ctx, uint8_t *buf, uint16_t len);      /**< point to a byte write function address */
+    void *ctx;                                                    /**< write context */
+    tm1637_link_decoder_t decoder;                                /**< request decoder */
+    uint8_t batch[TM1637_LINK_BATCH_LEN];                         /**< batched responses */
+    uint16_t batch_len;                                           /**< batched response length */
+} tm1637_link_server_t;
+
+/**
+ * @brief tm1637 link client structure definition
+ */
+typedef struct tm1637_link_client_s
+{
+    uint8_t (*write)(void *ctx, uint8_t *buf, uint16_t len);                         /**< point to a byte write function address */
+    uint16_t (*read)(void *ctx, uint8_t *buf, uint16_t len, uint32_t timeout_ms);    /**< point to a byte read function address */
+    void *ctx;                                                                       /**< transport context */
+    tm1637_link_decoder_t decoder;                                                   /**< response decoder */
+    uint8_t batch[TM1637_LINK_BATCH_LEN];                                            /**< batched requests */
+    uint16_t batch_len;                                                              /**< batched request length */
+    uint8_t size[TM1637_LINK_MAX_INFLIGHT];                                          /**< in flight frame sizes */
+    uint8_t seq;                                                                     /**< next sequence */
+    uint8_t ack;                                                                     /**< oldest unacknowledged sequence */
+    uint8_t inflight;                                                                /**< in flight frame number */
+    uint16_t inflight_len;                                                           /**< in flight byte number */
+    uint16_t window;                                                                 /**< max in flight byte number */
+    uint16_t open;                                                                   /**< offset of the set reg frame still taking entries */
+    uint8_t status;                                                                  /**< first failed response status */
+    uint8_t wait;                                                                    /**< awaited read sequence */
+    uint8_t wait_done;                                                               /**< awaited response flag */
+    uint8_t reply[17];                                                               /**< awaited response payload */
+    uint8_t reply_len;                                                               /**< awaited response payload length */
+    uint32_t sent;                                                                   /**< sent frame counter */
+    uint32_t acked;                                                                  /**< acknowledged frame counter */
+    uint32_t errors;                                                                 /**< failed, lost and timed out frame counter */
+} tm1637_link_client_t;
+
+/**
+ * @}
+ */
+
+/**
+ * @defgroup tm1637_link_frame tm1637 link frame function
+ * @brief    tm1637 link frame modules
+ * @ingroup  tm1637_link_driver
+ * @{
+ */
+
+/**
+ * @brief      pack a link frame
+ * @param[out] *buf points to a frame buffer with TM1637_LINK_MAX_FRAME bytes
+ * @param[out] *size points to a frame size buffer
+ * @param[in]  seq is the frame sequence
+ * @param[in]  command is the frame command
+ * @param[in]  *payload points to a payload buffer
+ * @param[in]  len is the payload length
+ * @return     status code
+ *             - 0 success
+ *             - 2 buf or size is NULL
+ *             - 4 len is over TM1637_LINK_MAX_PAYLOAD
+ * @note       the frame is sof, seq, command, len, payload and crc16 ccitt of seq to payload in big endian
+ */
+uint8_t tm1637_link_pack(uint8_t *buf, uint16_t *size, uint8_t seq, uint8_t command, uint8_t *payload, uint8_t len);
+
+/**
+ * @brief     initialize a link decoder
+ * @param[in] *decoder points to a tm1637 link decoder structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 decoder is NULL
+ * @note      none
+ */
+uint8_t tm1637_link_decoder_init(tm1637_link_decoder_t *decoder);
+
+/**
+ * @brief     feed one byte to a link decoder
+ * @param[in] *decoder points to a tm1637 link decoder structure
+ * @param[in] byte is the received byte
+ * @return    status code
+ *            - 0 frame is not complete
+ *            - 1 a good frame is in seq, command, len and payload
+ * @note      a bad crc or length drops the frame and the decoder hunts for the next sof
+ */
+uint8_t tm1637_link_decode(tm1637_link_decoder_t *decoder, uint8_t byte);
+
+/**
+ * @}
+ */
+
+/**
+ * @defgroup tm1637_link_server tm1637 link server function
+ * @brief    tm1637 link server modules
+ * @ingroup  tm1637_link_driver
+ * @{
+ */
+
+/**
+ * @brief     initialize a link server
+ * @param[in] *server points to a tm1637 link server structure
+ * @param[in] **handle points to an initialized tm1637 handle list
+ * @param[in] num is the handle number
+ * @param[in] *write points to a byte write function address
+ * @param[in] *ctx is the write context
+ * @return    status code
+ *            - 0 success
+ *            - 2 server, handle or write is NULL
+ *            - 4 num is invalid
+ * @note      every handle should be in the increase address mode, a handle which is not inited,
+ *            such as a display that is not fitted, answers TM1637_LINK_STATUS_FAILED
+ */
+uint8_t tm1637_link_server_init(tm1637_link_server_t *server, tm1637_handle_t **handle, uint8_t num,
+                                uint8_t (*write)(void *ctx, uint8_t *buf, uint16_t len), void *ctx);
+
+/**
+ * @brief     run the received bytes
+ * @param[in] *server points to a tm1637 link server structure
+ * @param[in] *buf points to a received byte buffer
+ * @param[in] len is the buffer length
+ * @return    status code
+ *            - 0 success
+ *            - 1 response write failed
+ *            - 2 server or buf is NULL
+ * @note      frames may be split at any byte, every good frame runs in order and gets one response,
+ *            the responses of one call go out in as few writes as possible
+ */
+uint8_t tm1637_link_server_input(tm1637_link_server_t *server, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief      get the link server receive state
+ * @param[in]  *server points to a tm1637 link server structure
+ * @param[out] *pending points to a pending flag buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 server is NULL
+ * @note       pending is 1 while a frame is partly received, the next bytes belong to the link
+ */
+uint8_t tm1637_link_server_get_pending(tm1637_link_server_t *server, uint8_t *pending);
+
+/**
+ * @brief      get the link server statistics
+ * @param[in]  *server points to a tm1637 link server structure
+ * @param[out] *frames points to a good frame counter buffer
+ * @param[out] *errors points to a bad frame counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 server is NULL
+ * @note       none
+ */
+uint8_t tm1637_link_server_get_statistics(tm1637_link_server_t *server, uint32_t *frames, uint32_t *errors);
+
+/**
+ * @}
+ */
+
+/**
+ * @defgroup tm1637_link_client tm1637 link client function
+ * @brief    tm1637 link client modules
+ * @ingroup  tm1637_link_driver
+ * @{
+ */
+
+/**
+ * @brief     initialize a link client
+ * @param[in] *client points to a tm1637 link client structure
+ * @param[in] *write points to a byte write function address
+ * @param[in] *read points to a byte read function address, it returns 0 after timeout_ms without data
+ * @param[in] *ctx is the transport context
+ * @param[in] window is the max in flight byte number
+ * @return    status code
+ *            - 0 success
+ *            - 2 client, write or read is NULL
+ *            - 4 window is smaller than TM1637_LINK_MAX_FRAME
+ * @note      window must not exceed the receive buffer of the server
+ */
+uint8_t tm1637_link_client_init(tm1637_link_client_t *client,
+                                uint8_t (*write)(void *ctx, uint8_t *buf, uint16_t len),
+                                uint16_t (*read)(void *ctx, uint8_t *buf, uint16_t len, uint32_t timeout_ms),
+                                void *ctx, uint16_t window);
+
+/**
+ * @brief     queue a segment write
+ * @param[in] *client points to a tm1637 link client structure
+ * @param[in] display is the display index
+ * @param[in] addr is the start address
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 link failed
+ *            - 2 client or data is NULL
+ *            - 4 addr + len > 6
+ * @note      the write is pipelined, its result is reported by tm1637_link_client_sync
+ */
+uint8_t tm1637_link_client_write_segment(tm1637_link_client_t *client, uint8_t display, uint8_t addr, uint8_t *data, uint8_t len);
+
+/**
+ * @brief     queue a bulk frame write
+ * @param[in] *client points to a tm1637 link client structure
+ * @param[in] display is the start display index
+ * @param[in] num is the display number
+ * @param[in] *data points to a data buffer with 6 bytes per display
+ * @return    status code
+ *            - 0 success
+ *            - 1 link failed
+ *            - 2 client or data is NULL
+ *            - 4 num is invalid
+ * @note      one link frame carries up to (TM1637_LINK_MAX_PAYLOAD - 1) / 6 displays
+ */
+uint8_t tm1637_link_client_write_frame(tm1637_link_client_t *client, uint8_t display, uint8_t num, uint8_t *data);
+
+/**
+ * @brief     queue a display setting
+ * @param[in] *client points to a tm1637 link client structure
+ * @param[in] display is the display index
+ * @param[in] enable is a bool value
+ * @param[in] width is the pulse width
+ * @return    status code
+ *            - 0 success
+ *            - 1 link failed
+ *            - 2 client is NULL
+ * @note      the width sets the brightness
+ */
+uint8_t tm1637_link_client_set_display(tm1637_link_client_t *client, uint8_t display, tm1637_bool_t enable, tm1637_pulse_width_t width);
+
+/**
+ * @brief      read the key of a display
+ * @param[in]  *client points to a tm1637 link client structure
+ * @param[in]  display is the display index
+ * @param[out] *seg points to a seg buffer
+ * @param[out] *k points to a k buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 link or read failed
+ *             - 2 client, seg or k is NULL
+ * @note       the queued commands go out before the read and the call blocks for its response
+ */
+uint8_t tm1637_link_client_read_key(tm1637_link_client_t *client, uint8_t display, uint8_t *seg, uint8_t *k);
+
+/**
+ * @brief     queue a register write
+ * @param[in] *client points to a tm1637 link client structure
+ * @param[in] display is the display index
+ * @param[in] cmd is the chip command
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 link failed
+ *            - 2 client is NULL
+ *            - 4 len is over 16
+ * @note      the write is pipelined and joins the last queued set reg frame while it has room,
+ *            so back to back writes of any display share one link frame and one response
+ */
+uint8_t tm1637_link_client_set_reg(tm1637_link_client_t *client, uint8_t display, uint8_t cmd, uint8_t *data, uint8_t len);
+
+/**
+ * @brief      read a register
+ * @param[in]  *client points to a tm1637 link client structure
+ * @param[in]  display is the display index
+ * @param[in]  cmd is the chip command
+ * @param[out] *data points to a data buffer
+ * @param[in]  len is the data length
+ * @return     status code
+ *             - 0 success
+ *             - 1 link or read failed
+ *             - 2 client or data is NULL
+ *             - 4 len is over 16
+ * @note       the queued commands go out before the read and the call blocks for its response
+ */
+uint8_t tm1637_link_client_get_reg(tm1637_link_client_t *client, uint8_t display, uint8_t cmd, uint8_t *data, uint8_t len);
+
+/**
+ * @brief     send the queued commands
+ * @param[in] *client points to a tm1637 link client structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 link failed
+ *            - 2 client is NULL
+ * @note      it does not wait for the responses
+ */
+uint8_t tm1637_link_client_flush(tm1637_link_client_t *client);
+
+/**
+ * @brief     send the queued commands and wait for all responses
+ * @param[in] *client points to a tm1637 link client structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 link failed or a command failed since the last sync
+ *            - 2 client is NULL
+ * @note      none
+ */
+uint8_t tm1637_link_client_sync(tm1637_link_client_t *client);
+
+/**
+ * @brief      get the link client statistics
+ * @param[in]  *client points to a tm1637 link client structure
+ * @param[out] *sent points to a sent frame counter buffer
+ * @param[out] *acked points to an acknowledged frame counter buffer
+ * @param[out] *errors points to an error counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 client is NULL
+ * @note       errors counts failed responses, lost frames, timeouts and bad received frames
+ */
+uint8_t tm1637_link_client_get_statistics(tm1637_link_client_t *client, uint32_t *sent, uint32_t *acked, uint32_t *errors);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
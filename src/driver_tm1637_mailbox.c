@@ -0,0 +1,258 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_mailbox.c
+ * @brief     driver tm1637 mailbox source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+
+#include "driver_tm1637_mailbox.h"
+
+/**
+ * @brief mailbox state definition
+ */
+#define STATE_LATEST_MASK         (7 << 0)                        /**< latest slot mask */
+#define STATE_FRESH               (1 << 3)                        /**< latest slot is not taken yet */
+#define STATE_READING_SHIFT       4                               /**< reading slot shift */
+#define STATE_READING_MASK        (7 << STATE_READING_SHIFT)      /**< reading slot mask */
+#define STATE_READING_NONE        7                               /**< flusher reads no slot */
+#define STATE_CLAIM(i)            (1 << (7 + (i)))                /**< slot claimed by a producer */
+#define STATE_GENERATION_SHIFT    16                              /**< generation shift */
+
+/**
+ * @brief     initialize the mailbox
+ * @param[in] *mailbox points to a tm1637 mailbox structure
+ * @param[in] *handle points to an initialized tm1637 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 mailbox or handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the first flush sends the whole frame
+ */
+uint8_t tm1637_mailbox_init(tm1637_mailbox_t *mailbox, tm1637_handle_t *handle)
+{
+    if ((mailbox == NULL) || (handle == NULL))                                                 /* check mailbox */
+    {
+        return 2;                                                                              /* return error */
+    }
+    if (handle->inited != 1)                                                                   /* check handle initialization */
+    {
+        return 3;                                                                              /* return error */
+    }
+
+    memset(mailbox->slot, 0, sizeof(mailbox->slot));                                           /* clear the slots */
+    memset(mailbox->frame, 0, sizeof(mailbox->frame));                                         /* clear the frame */
+    memset(mailbox->sent, 0, sizeof(mailbox->sent));                                           /* clear the sent frame */
+    mailbox->sent_valid = 0;                                                                   /* sent frame is unknown */
+    mailbox->handle = handle;                                                                  /* save handle */
+    atomic_init(&mailbox->state, STATE_READING_NONE << STATE_READING_SHIFT);                   /* slot 0 is the latest */
+    atomic_init(&mailbox->published, 0);                                                       /* init 0 */
+    atomic_init(&mailbox->dropped, 0);                                                         /* init 0 */
+
+    return 0;                                                                                  /* success return 0 */
+}
+
+/**
+ * @brief     publish digits to the mailbox
+ * @param[in] *mailbox points to a tm1637 mailbox structure
+ * @param[in] addr is the start address
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 2 mailbox is NULL
+ *            - 4 addr + len > 6
+ * @note      up to TM1637_MAILBOX_MAX_PRODUCER tasks may call this function at the same time, it never touches
+ *            the bus and never fails, a single producer finishes in a bounded number of steps and with more
+ *            producers a retry only happens when another one published, len 6 publishes a whole frame
+ *            and the other digits keep their latest value
+ */
+uint8_t tm1637_mailbox_publish(tm1637_mailbox_t *mailbox, uint8_t addr, uint8_t *data, uint8_t len)
+{
+    uint_least32_t state;
+    uint_least32_t next;
+    uint_least32_t generation;
+    uint8_t slot;
+    uint8_t i;
+
+    if (mailbox == NULL)                                                                        /* check mailbox */
+    {
+        return 2;                                                                               /* return error */
+    }
+    if (addr + len > 6)                                                                         /* check range */
+    {
+        return 4;                                                                               /* return error */
+    }
+
+    /* claim a slot which is neither the latest nor read by the flusher, the other producers hold at most
+       TM1637_MAILBOX_MAX_PRODUCER - 1 slots so one is always free and the flusher changes the state
+       at most twice per published frame, a lone producer never retries without bound */
+    state = atomic_load(&mailbox->state);                                                       /* get state */
+    while (1)                                                                                   /* loop */
+    {
+        slot = 0xFF;                                                                            /* no slot */
+        for (i = 0; i < TM1637_MAILBOX_SLOT; i++)                                               /* loop all slots */
+        {
+            if ((i != (state & STATE_LATEST_MASK)) &&
+                (i != ((state & STATE_READING_MASK) >> STATE_READING_SHIFT)) &&
+                ((state & STATE_CLAIM(i)) == 0))                                                /* free slot */
+            {
+                slot = i;                                                                       /* save slot */
+
+                break;                                                                          /* break */
+            }
+        }
+        if (slot == 0xFF)                                                                       /* more than max producers */
+        {
+            state = atomic_load(&mailbox->state);                                               /* reload */
+
+            continue;                                                                           /* retry */
+        }
+        if (atomic_compare_exchange_strong(&mailbox->state, &state, state | STATE_CLAIM(slot))) /* claim */
+        {
+            state |= STATE_CLAIM(slot);                                                         /* claimed */
+
+            break;                                                                              /* break */
+        }
+    }
+
+    /* merge into the latest frame and publish, redo the merge if another producer published first */
+    while (1)                                                                                   /* loop */
+    {
+        generation = state >> STATE_GENERATION_SHIFT;                                           /* save generation */
+        memcpy(mailbox->slot[slot].ram, mailbox->slot[state & STATE_LATEST_MASK].ram, 6);       /* copy the latest frame */
+        memcpy(&mailbox->slot[slot].ram[addr], data, len);                                      /* apply the digits */
+        do
+        {
+            next = state & ~(uint_least32_t)(STATE_LATEST_MASK | STATE_CLAIM(slot));           /* release the claim */
+            next |= slot | STATE_FRESH;                                                         /* set the latest slot */
+            next += (uint_least32_t)1 << STATE_GENERATION_SHIFT;                                /* generation++ */
+            if (atomic_compare_exchange_strong(&mailbox->state, &state, next))                 /* publish */
+            {
+                if ((state & STATE_FRESH) != 0)                                                 /* the flusher missed it */
+                {
+                    atomic_fetch_add(&mailbox->dropped, 1);                                     /* dropped++ */
+                }
+                atomic_fetch_add(&mailbox->published, 1);                                       /* published++ */
+
+                return 0;                                                                       /* success return 0 */
+            }
+        } while ((state >> STATE_GENERATION_SHIFT) == generation);                              /* only flags changed */
+    }
+}
+
+/**
+ * @brief     flush the newest frame
+ * @param[in] *mailbox points to a tm1637 mailbox structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 flush failed
+ *            - 2 mailbox is NULL
+ * @note      only one flusher task may call this function, it sends the digits changed since the last flush
+ */
+uint8_t tm1637_mailbox_flush(tm1637_mailbox_t *mailbox)
+{
+    uint_least32_t state;
+    uint_least32_t next;
+    uint8_t start;
+    uint8_t len;
+
+    if (mailbox == NULL)                                                                        /* check mailbox */
+    {
+        return 2;                                                                               /* return error */
+    }
+
+    /* take the latest slot, producers never claim it while the flusher reads it */
+    state = atomic_load(&mailbox->state);                                                       /* get state */
+    while ((state & STATE_FRESH) != 0)                                                          /* a new frame */
+    {
+        next = state & ~(uint_least32_t)(STATE_FRESH | STATE_READING_MASK);                     /* clear fresh */
+        next |= (state & STATE_LATEST_MASK) << STATE_READING_SHIFT;                             /* set reading */
+        if (atomic_compare_exchange_weak(&mailbox->state, &state, next))                        /* take */
+        {
+            memcpy(mailbox->frame, mailbox->slot[state & STATE_LATEST_MASK].ram, 6);            /* copy the frame */
+            atomic_fetch_or(&mailbox->state, STATE_READING_NONE << STATE_READING_SHIFT);        /* release */
+
+            break;                                                                              /* break */
+        }
+    }
+
+    /* send each changed run */
+    start = 0;                                                                                  /* init 0 */
+    while (start < 6)                                                                           /* loop all digits */
+    {
+        if ((mailbox->sent_valid != 0) && (mailbox->frame[start] == mailbox->sent[start]))      /* not changed */
+        {
+            start++;                                                                            /* next */
+
+            continue;                                                                           /* continue */
+        }
+        len = 1;                                                                                /* one digit */
+        while (((start + len) < 6) &&
+               ((mailbox->sent_valid == 0) || (mailbox->frame[start + len] != mailbox->sent[start + len])))    /* extend the run */
+        {
+            len++;                                                                              /* len++ */
+        }
+        if (tm1637_write_segment(mailbox->handle, start, &mailbox->frame[start], len) != 0)    /* write segment */
+        {
+            return 1;                                                                           /* return error */
+        }
+        memcpy(&mailbox->sent[start], &mailbox->frame[start], len);                             /* save the sent digits */
+        start += len;                                                                           /* next run */
+    }
+    mailbox->sent_valid = 1;                                                                    /* sent frame is known */
+
+    return 0;                                                                                   /* success return 0 */
+}
+
+/**
+ * @brief      get the mailbox statistics
+ * @param[in]  *mailbox points to a tm1637 mailbox structure
+ * @param[out] *published points to a published frame counter buffer
+ * @param[out] *dropped points to a dropped frame counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 mailbox is NULL
+ * @note       a frame is dropped when a newer frame replaces it before the flusher takes it
+ */
+uint8_t tm1637_mailbox_get_statistics(tm1637_mailbox_t *mailbox, uint32_t *published, uint32_t *dropped)
+{
+    if (mailbox == NULL)                                                  /* check mailbox */
+    {
+        return 2;                                                         /* return error */
+    }
+
+    *published = (uint32_t)atomic_load(&mailbox->published);              /* get published */
+    *dropped = (uint32_t)atomic_load(&mailbox->dropped);                  /* get dropped */
+
+    return 0;                                                             /* success return 0 */
+}
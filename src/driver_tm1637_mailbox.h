@@ -0,0 +1,157 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_mailbox.h
+ * @brief     driver tm1637 mailbox header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef DRIVER_TM1637_MAILBOX_H
+#define DRIVER_TM1637_MAILBOX_H
+
+#include "driver_tm1637.h"
+#if !defined(__STDC_VERSION__) || (__STDC_VERSION__ < 201112L) || defined(__STDC_NO_ATOMICS__)
+    #error "driver_tm1637_mailbox needs a c11 compiler with <stdatomic.h>"
+#endif
+#include <stdatomic.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup tm1637_mailbox_driver tm1637 mailbox driver function
+ * @brief    tm1637 mailbox driver modules
+ * @note     it uses the c11 atomics, so build it as c11 or later
+ * @ingroup  tm1637_driver
+ * @{
+ */
+
+/**
+ * @brief tm1637 mailbox max producer definition
+ * @note  the tasks which may publish at the same time, one slot each besides the latest and the read one
+ */
+#ifndef TM1637_MAILBOX_MAX_PRODUCER
+    #define TM1637_MAILBOX_MAX_PRODUCER        4        /**< 4 tasks */
+#endif
+#if (TM1637_MAILBOX_MAX_PRODUCER < 1) || (TM1637_MAILBOX_MAX_PRODUCER > 5)
+    #error "TM1637_MAILBOX_MAX_PRODUCER must be 1 - 5"
+#endif
+
+/**
+ * @brief tm1637 mailbox slot number definition
+ */
+#define TM1637_MAILBOX_SLOT        (TM1637_MAILBOX_MAX_PRODUCER + 2)        /**< latest, read and one per producer */
+
+/**
+ * @brief tm1637 mailbox slot structure definition
+ */
+typedef struct tm1637_mailbox_slot_s
+{
+    uint8_t ram[6];                                         /**< display frame */
+} tm1637_mailbox_slot_t;
+
+/**
+ * @brief tm1637 mailbox structure definition
+ */
+typedef struct tm1637_mailbox_s
+{
+    tm1637_handle_t *handle;                                /**< tm1637 handle */
+    tm1637_mailbox_slot_t slot[TM1637_MAILBOX_SLOT];        /**< frame slots */
+    atomic_uint_least32_t state;                            /**< latest, fresh, reading, claim and generation */
+    atomic_uint_least32_t published;                        /**< published frame counter */
+    atomic_uint_least32_t dropped;                          /**< dropped frame counter */
+    uint8_t frame[6];                                       /**< frame taken by the flusher */
+    uint8_t sent[6];                                        /**< frame sent to the chip */
+    uint8_t sent_valid;                                     /**< sent frame valid flag */
+} tm1637_mailbox_t;
+
+/**
+ * @brief     initialize the mailbox
+ * @param[in] *mailbox points to a tm1637 mailbox structure
+ * @param[in] *handle points to an initialized tm1637 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 mailbox or handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the first flush sends the whole frame
+ */
+uint8_t tm1637_mailbox_init(tm1637_mailbox_t *mailbox, tm1637_handle_t *handle);
+
+/**
+ * @brief     publish digits to the mailbox
+ * @param[in] *mailbox points to a tm1637 mailbox structure
+ * @param[in] addr is the start address
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 2 mailbox is NULL
+ *            - 4 addr + len > 6
+ * @note      up to TM1637_MAILBOX_MAX_PRODUCER tasks may call this function at the same time, it never touches
+ *            the bus and never fails, a single producer finishes in a bounded number of steps and with more
+ *            producers a retry only happens when another one published, len 6 publishes a whole frame
+ *            and the other digits keep their latest value
+ */
+uint8_t tm1637_mailbox_publish(tm1637_mailbox_t *mailbox, uint8_t addr, uint8_t *data, uint8_t len);
+
+/**
+ * @brief     flush the newest frame
+ * @param[in] *mailbox points to a tm1637 mailbox structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 flush failed
+ *            - 2 mailbox is NULL
+ * @note      only one flusher task may call this function, it sends the digits changed since the last flush
+ */
+uint8_t tm1637_mailbox_flush(tm1637_mailbox_t *mailbox);
+
+/**
+ * @brief      get the mailbox statistics
+ * @param[in]  *mailbox points to a tm1637 mailbox structure
+ * @param[out] *published points to a published frame counter buffer
+ * @param[out] *dropped points to a dropped frame counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 mailbox is NULL
+ * @note       a frame is dropped when a newer frame replaces it before the flusher takes it
+ */
+uint8_t tm1637_mailbox_get_statistics(tm1637_mailbox_t *mailbox, uint32_t *published, uint32_t *dropped);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
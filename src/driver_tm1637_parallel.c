@@ -0,0 +1,732 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_parallel.c
+ * @brief     driver tm1637 parallel source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+
+#include "driver_tm1637_parallel.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+/**
+ * @brief chip command definition
+ */
+#define TM1637_COMMAND_DATA           (1 << 6)        /**< data command setting */
+#define TM1637_COMMAND_DISPLAY        (2 << 6)        /**< display and control command setting */
+#define TM1637_COMMAND_ADDRESS        (3 << 6)        /**< address command setting */
+
+#if !defined(__SSE2__) && !(defined(__ARM_NEON) && defined(__aarch64__))
+/**
+ * @brief     transpose an 8x8 bit block
+ * @param[in] x is the block, bit j of byte i is element (i, j)
+ * @return    transposed block
+ * @note      it is its own inverse
+ */
+static uint64_t a_tm1637_parallel_transpose8x8(uint64_t x)
+{
+    uint64_t t;
+
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;        /* swap 1x1 blocks */
+    x = x ^ t ^ (t << 7);                              /* apply */
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;       /* swap 2x2 blocks */
+    x = x ^ t ^ (t << 14);                             /* apply */
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;       /* swap 4x4 blocks */
+    x = x ^ t ^ (t << 28);                             /* apply */
+
+    return x;                                          /* return the block */
+}
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+/**
+ * @brief      gather one bit of 16 bytes into 8 words
+ * @param[in]  x is 16 bytes
+ * @param[out] *word points to 8 words, bit j of word i is bit i of byte j
+ * @note       none
+ */
+static void a_tm1637_parallel_gather(uint8x16_t x, uint16_t word[8])
+{
+    static const int8_t gsc_position[16] = {0, 1, 2, 3, 4, 5, 6, 7,
+                                            0, 1, 2, 3, 4, 5, 6, 7};
+    uint8x16_t bits;
+    int8x16_t position;
+    uint8_t i;
+
+    position = vld1q_s8(gsc_position);                                      /* byte position in a half */
+    for (i = 0; i < 8; i++)                                                 /* lsb first */
+    {
+        bits = vshlq_u8(vandq_u8(x, vdupq_n_u8(1)), position);              /* move bit i to the byte position */
+        word[i] = (uint16_t)(vaddv_u8(vget_low_u8(bits)) |
+                             (vaddv_u8(vget_high_u8(bits)) << 8));          /* gather 16 bytes */
+        x = vshrq_n_u8(x, 1);                                               /* next bit */
+    }
+}
+#endif
+
+/**
+ * @brief      transpose one byte of each module into port words
+ * @param[in]  *lane points to 16 bytes, one byte of each module
+ * @param[out] *word points to 8 words, bit m of word b is bit b of lane m
+ * @note       it uses sse2 or neon when the compiler targets them and portable c otherwise
+ */
+void tm1637_parallel_transpose(const uint8_t lane[16], uint16_t word[8])
+{
+#if defined(__SSE2__)
+    __m128i x;
+    uint8_t i;
+
+    x = _mm_loadu_si128((const __m128i *)lane);                             /* load 16 lanes */
+    for (i = 0; i < 8; i++)                                                 /* msb first */
+    {
+        word[7 - i] = (uint16_t)_mm_movemask_epi8(x);                       /* gather the msb of each lane */
+        x = _mm_add_epi8(x, x);                                             /* shift each lane left */
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    a_tm1637_parallel_gather(vld1q_u8(lane), word);                         /* gather 16 lanes */
+#else
+    uint64_t x;
+    uint8_t half;
+    uint8_t i;
+
+    for (i = 0; i < 8; i++)                                                 /* clear words */
+    {
+        word[i] = 0;                                                        /* init 0 */
+    }
+    for (half = 0; half < 2; half++)                                        /* two 8x8 blocks */
+    {
+        x = 0;                                                              /* init 0 */
+        for (i = 0; i < 8; i++)                                             /* pack 8 lanes */
+        {
+            x |= (uint64_t)lane[half * 8 + i] << (i * 8);                   /* lane i is byte i */
+        }
+        x = a_tm1637_parallel_transpose8x8(x);                              /* transpose */
+        for (i = 0; i < 8; i++)                                             /* unpack 8 words */
+        {
+            word[i] |= (uint16_t)(((x >> (i * 8)) & 0xFF) << (half * 8));   /* byte i is bit i */
+        }
+    }
+#endif
+}
+
+/**
+ * @brief      transpose port words back into one byte of each module
+ * @param[in]  *word points to 8 words, bit m of word b is bit b of lane m
+ * @param[out] *lane points to 16 bytes, one byte of each module
+ * @note       it is the inverse of tm1637_parallel_transpose
+ */
+void tm1637_parallel_detranspose(const uint16_t word[8], uint8_t lane[16])
+{
+#if defined(__SSE2__)
+    __m128i v;
+    __m128i x;
+    uint16_t mask;
+    uint8_t i;
+
+    v = _mm_loadu_si128((const __m128i *)word);                             /* load 8 words */
+    x = _mm_packus_epi16(_mm_and_si128(v, _mm_set1_epi16(0x00FF)),
+                         _mm_srli_epi16(v, 8));                             /* low bytes then high bytes */
+    for (i = 0; i < 8; i++)                                                 /* msb first */
+    {
+        mask = (uint16_t)_mm_movemask_epi8(x);                              /* bit 7 - i of all words */
+        lane[7 - i] = (uint8_t)(mask & 0xFF);                               /* lane 7 - i */
+        lane[15 - i] = (uint8_t)(mask >> 8);                                /* lane 15 - i */
+        x = _mm_add_epi8(x, x);                                             /* shift each byte left */
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    uint16x8_t v;
+    uint16_t gather[8];
+    uint8_t i;
+
+    v = vld1q_u16(word);                                                    /* load 8 words */
+    a_tm1637_parallel_gather(vcombine_u8(vmovn_u16(v), vshrn_n_u16(v, 8)),
+                             gather);                                       /* low bytes then high bytes */
+    for (i = 0; i < 8; i++)                                                 /* unpack */
+    {
+        lane[i] = (uint8_t)(gather[i] & 0xFF);                              /* lane i */
+        lane[i + 8] = (uint8_t)(gather[i] >> 8);                            /* lane i + 8 */
+    }
+#else
+    uint64_t x;
+    uint8_t half;
+    uint8_t i;
+
+    for (half = 0; half < 2; half++)                                        /* two 8x8 blocks */
+    {
+        x = 0;                                                              /* init 0 */
+        for (i = 0; i < 8; i++)                                             /* pack 8 words */
+        {
+            x |= (uint64_t)((word[i] >> (half * 8)) & 0xFF) << (i * 8);     /* bit i is byte i */
+        }
+        x = a_tm1637_parallel_transpose8x8(x);                              /* transpose */
+        for (i = 0; i < 8; i++)                                             /* unpack 8 lanes */
+        {
+            lane[half * 8 + i] = (uint8_t)((x >> (i * 8)) & 0xFF);          /* byte i is lane i */
+        }
+    }
+#endif
+}
+
+/**
+ * @brief     send a start on the selected modules
+ * @param[in] *parallel points to a tm1637 parallel structure
+ * @param[in] select is the selected module mask
+ * @note      the other dio lines stay released and their chips ignore the clock
+ */
+static void a_tm1637_parallel_start(tm1637_parallel_t *parallel, uint16_t select)
+{
+    uint32_t lines;
+
+    lines = (uint32_t)select << parallel->dio_shift;            /* selected dio lines */
+    parallel->dio_write(lines, lines);                          /* release dio */
+    parallel->clk_write(1);                                     /* clk high */
+    parallel->delay_us(TM1637_PARALLEL_DELAY_US);               /* delay */
+    parallel->dio_write(lines, 0);                              /* dio low while clk high */
+    parallel->delay_us(TM1637_PARALLEL_DELAY_US);               /* delay */
+    parallel->clk_write(0);                                     /* clk low */
+    parallel->delay_us(TM1637_PARALLEL_DELAY_US);               /* delay */
+}
+
+/**
+ * @brief     send a stop on the selected modules
+ * @param[in] *parallel points to a tm1637 parallel structure
+ * @param[in] select is the selected module mask
+ * @note      none
+ */
+static void a_tm1637_parallel_stop(tm1637_parallel_t *parallel, uint16_t select)
+{
+    uint32_t lines;
+
+    lines = (uint32_t)select << parallel->dio_shift;            /* selected dio lines */
+    parallel->dio_write(lines, 0);                              /* dio low */
+    parallel->delay_us(TM1637_PARALLEL_DELAY_US);               /* delay */
+    parallel->clk_write(1);                                     /* clk high */
+    parallel->delay_us(TM1637_PARALLEL_DELAY_US);               /* delay */
+    parallel->dio_write(lines, lines);                          /* dio high while clk high */
+    parallel->delay_us(TM1637_PARALLEL_DELAY_US);               /* delay */
+}
+
+/**
+ * @brief     send one byte to the selected modules
+ * @param[in] *parallel points to a tm1637 parallel structure
+ * @param[in] select is the selected module mask
+ * @param[in] *word points to 8 port words, lsb first
+ * @return    no ack module mask
+ * @note      one port write per bit and one port read for all acks
+ */
+static uint16_t a_tm1637_parallel_byte(tm1637_parallel_t *parallel, uint16_t select, const uint16_t word[8])
+{
+    uint32_t lines;
+    uint32_t level;
+    uint8_t i;
+
+    lines = (uint32_t)select << parallel->dio_shift;                                   /* selected dio lines */
+    for (i = 0; i < 8; i++)                                                            /* lsb first */
+    {
+        parallel->dio_write(lines, (uint32_t)word[i] << parallel->dio_shift);          /* all dio lines */
+        parallel->delay_us(TM1637_PARALLEL_DELAY_US);                                  /* delay */
+        parallel->clk_write(1);                                                        /* clk high */
+        parallel->delay_us(TM1637_PARALLEL_DELAY_US);                                  /* delay */
+        parallel->clk_write(0);                                                        /* clk low */
+    }
+    parallel->dio_write(lines, lines);                                                 /* release dio */
+    parallel->delay_us(TM1637_PARALLEL_DELAY_US);                                      /* delay */
+    parallel->clk_write(1);                                                            /* ack clock */
+    parallel->delay_us(TM1637_PARALLEL_DELAY_US);                                      /* delay */
+    level = parallel->dio_read();                                                      /* read all acks */
+    parallel->clk_write(0);                                                            /* clk low */
+    parallel->delay_us(TM1637_PARALLEL_DELAY_US);                                      /* delay */
+
+    return (uint16_t)((level >> parallel->dio_shift) & select);                        /* released lines did not ack */
+}
+
+/**
+ * @brief      read one byte from all modules
+ * @param[in]  *parallel points to a tm1637 parallel structure
+ * @param[out] *word points to 8 port words, lsb first
+ * @note       one port read per bit samples all modules
+ */
+static void a_tm1637_parallel_read_byte(tm1637_parallel_t *parallel, uint16_t word[8])
+{
+    uint32_t level;
+    uint8_t i;
+
+    parallel->dio_write(parallel->dio_mask, parallel->dio_mask);                             /* release dio */
+    for (i = 0; i < 8; i++)                                                                  /* lsb first */
+    {
+        parallel->delay_us(TM1637_PARALLEL_DELAY_US);                                        /* delay */
+        parallel->clk_write(1);                                                              /* clk high */
+        parallel->delay_us(TM1637_PARALLEL_DELAY_US);                                        /* delay */
+        level = parallel->dio_read();                                                        /* sample all modules */
+        word[i] = (uint16_t)((level >> parallel->dio_shift) & parallel->module_mask);        /* keep the module bits */
+        parallel->clk_write(0);                                                              /* chips shift out the next bit */
+    }
+    parallel->delay_us(TM1637_PARALLEL_DELAY_US);                                            /* delay */
+    parallel->clk_write(1);                                                                  /* nack clock */
+    parallel->delay_us(TM1637_PARALLEL_DELAY_US);                                            /* delay */
+    parallel->clk_write(0);                                                                  /* clk low */
+    parallel->delay_us(TM1637_PARALLEL_DELAY_US);                                            /* delay */
+}
+
+/**
+ * @brief     send one command byte to the selected modules
+ * @param[in] *parallel points to a tm1637 parallel structure
+ * @param[in] select is the selected module mask
+ * @param[in] cmd is the command
+ * @return    no ack module mask
+ * @note      none
+ */
+static uint16_t a_tm1637_parallel_command(tm1637_parallel_t *parallel, uint16_t select, uint8_t cmd)
+{
+    uint16_t word[8];
+    uint8_t i;
+
+    for (i = 0; i < 8; i++)                                                              /* lsb first */
+    {
+        word[i] = ((cmd & (1 << i)) != 0) ? select : 0;                                  /* same bit on all lines */
+    }
+
+    return a_tm1637_parallel_byte(parallel, select, word);                               /* send */
+}
+
+/**
+ * @brief     initialize the parallel bus
+ * @param[in] *parallel points to a tm1637 parallel structure
+ * @param[in] modules is the module number
+ * @param[in] dio_shift is the dio pin of module 0, module m uses pin dio_shift + m
+ * @return    status code
+ *            - 0 success
+ *            - 1 port initialization failed
+ *            - 2 parallel is NULL
+ *            - 3 linked functions is NULL
+ *            - 4 modules or dio_shift is invalid
+ * @note      1 <= modules <= 16, all modules share one clock pin
+ */
+uint8_t tm1637_parallel_init(tm1637_parallel_t *parallel, uint8_t modules, uint8_t dio_shift)
+{
+    if (parallel == NULL)                                                           /* check parallel */
+    {
+        return 2;                                                                   /* return error */
+    }
+    if (parallel->debug_print == NULL)                                              /* check debug_print */
+    {
+        return 3;                                                                   /* return error */
+    }
+    if (parallel->port_init == NULL)                                                /* check port_init */
+    {
+        parallel->debug_print("tm1637: port_init is null.\n");                      /* port_init is null */
+
+        return 3;                                                                   /* return error */
+    }
+    if (parallel->port_deinit == NULL)                                              /* check port_deinit */
+    {
+        parallel->debug_print("tm1637: port_deinit is null.\n");                    /* port_deinit is null */
+
+        return 3;                                                                   /* return error */
+    }
+    if (parallel->clk_write == NULL)                                                /* check clk_write */
+    {
+        parallel->debug_print("tm1637: clk_write is null.\n");                      /* clk_write is null */
+
+        return 3;                                                                   /* return error */
+    }
+    if (parallel->dio_write == NULL)                                                /* check dio_write */
+    {
+        parallel->debug_print("tm1637: dio_write is null.\n");                      /* dio_write is null */
+
+        return 3;                                                                   /* return error */
+    }
+    if (parallel->dio_read == NULL)                                                 /* check dio_read */
+    {
+        parallel->debug_print("tm1637: dio_read is null.\n");                       /* dio_read is null */
+
+        return 3;                                                                   /* return error */
+    }
+    if (parallel->delay_us == NULL)                                                 /* check delay_us */
+    {
+        parallel->debug_print("tm1637: delay_us is null.\n");                       /* delay_us is null */
+
+        return 3;                                                                   /* return error */
+    }
+    if ((modules == 0) || (modules > TM1637_PARALLEL_MAX_MODULE) ||
+        ((dio_shift + modules) > 32))                                               /* check modules */
+    {
+        parallel->debug_print("tm1637: modules or dio_shift is invalid.\n");        /* modules or dio_shift is invalid */
+
+        return 4;                                                                   /* return error */
+    }
+
+    if (parallel->port_init() != 0)                                                 /* port init */
+    {
+        parallel->debug_print("tm1637: port init failed.\n");                      /* port init failed */
+
+        return 1;                                                                   /* return error */
+    }
+    parallel->modules = modules;                                                    /* set modules */
+    parallel->dio_shift = dio_shift;                                                /* set dio shift */
+    parallel->module_mask = (uint16_t)((1UL << modules) - 1);                       /* set module mask */
+    parallel->dio_mask = (uint32_t)parallel->module_mask << dio_shift;              /* set dio mask */
+    parallel->dio_write(parallel->dio_mask, parallel->dio_mask);                    /* release dio */
+    parallel->clk_write(1);                                                         /* clk idle high */
+    parallel->inited = 1;                                                           /* flag inited */
+
+    return 0;                                                                       /* success return 0 */
+}
+
+/**
+ * @brief     close the parallel bus
+ * @param[in] *parallel points to a tm1637 parallel structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 port deinit failed
+ *            - 2 parallel is NULL
+ *            - 3 parallel is not initialized
+ * @note      none
+ */
+uint8_t tm1637_parallel_deinit(tm1637_parallel_t *parallel)
+{
+    if (parallel == NULL)                                                /* check parallel */
+    {
+        return 2;                                                        /* return error */
+    }
+    if (parallel->inited != 1)                                           /* check parallel initialization */
+    {
+        return 3;                                                        /* return error */
+    }
+
+    if (parallel->port_deinit() != 0)                                    /* port deinit */
+    {
+        parallel->debug_print("tm1637: port deinit failed.\n");          /* port deinit failed */
+
+        return 1;                                                        /* return error */
+    }
+    parallel->inited = 0;                                                /* flag closed */
+
+    return 0;                                                            /* success return 0 */
+}
+
+/**
+ * @brief      write the segments of all modules at once
+ * @param[in]  *parallel points to a tm1637 parallel structure
+ * @param[in]  addr is the start address
+ * @param[in]  **data points to a frame of 6 digits for each module
+ * @param[in]  len is the data length
+ * @param[out] *nack points to a no ack module mask buffer, NULL is allowed
+ * @return     status code
+ *             - 0 success
+ *             - 1 write segment failed
+ *             - 2 parallel is NULL
+ *             - 3 parallel is not initialized
+ *             - 4 addr + len > 6
+ * @note       every module uses the auto increment 1 mode, data[m][addr + i] goes to digit addr + i of module m,
+ *             the write fails when a module does not ack and nack tells which ones
+ */
+uint8_t tm1637_parallel_write_segment(tm1637_parallel_t *parallel, uint8_t addr, uint8_t (*data)[6], uint8_t len, uint16_t *nack)
+{
+    uint8_t lane[16];
+    uint16_t word[8];
+    uint16_t select;
+    uint16_t fail;
+    uint8_t i;
+    uint8_t m;
+
+    if (parallel == NULL)                                                              /* check parallel */
+    {
+        return 2;                                                                      /* return error */
+    }
+    if (parallel->inited != 1)                                                         /* check parallel initialization */
+    {
+        return 3;                                                                      /* return error */
+    }
+    if (addr + len > 6)                                                                /* check range */
+    {
+        parallel->debug_print("tm1637: addr + len > 6.\n");                            /* addr + len > 6 */
+
+        return 4;                                                                      /* return error */
+    }
+
+    select = parallel->module_mask;                                                    /* all modules */
+    a_tm1637_parallel_start(parallel, select);                                         /* start */
+    fail = a_tm1637_parallel_command(parallel, select, TM1637_COMMAND_DATA);           /* auto increment 1 mode */
+    a_tm1637_parallel_stop(parallel, select);                                          /* stop */
+    a_tm1637_parallel_start(parallel, select);                                         /* start */
+    fail |= a_tm1637_parallel_command(parallel, select, TM1637_COMMAND_ADDRESS | addr);    /* set the address */
+    memset(lane, 0, sizeof(lane));                                                     /* unused lanes are 0 */
+    for (i = 0; i < len; i++)                                                          /* loop all digits */
+    {
+        for (m = 0; m < parallel->modules; m++)                                        /* gather one digit */
+        {
+            lane[m] = data[m][addr + i];                                               /* digit of module m */
+        }
+        tm1637_parallel_transpose(lane, word);                                         /* bit slice */
+        fail |= a_tm1637_parallel_byte(parallel, select, word);                        /* send */
+    }
+    a_tm1637_parallel_stop(parallel, select);                                          /* stop */
+    if (nack != NULL)                                                                  /* check nack */
+    {
+        *nack = fail;                                                                  /* set nack */
+    }
+    if (fail != 0)                                                                     /* check ack */
+    {
+        parallel->debug_print("tm1637: module 0x%04X no ack.\n", fail);                /* no ack */
+
+        return 1;                                                                      /* return error */
+    }
+
+    return 0;                                                                          /* success return 0 */
+}
+
+/**
+ * @brief      set the display of all modules at once
+ * @param[in]  *parallel points to a tm1637 parallel structure
+ * @param[in]  enable is a bool value
+ * @param[in]  width is the pulse width
+ * @param[out] *nack points to a no ack module mask buffer, NULL is allowed
+ * @return     status code
+ *             - 0 success
+ *             - 1 set display failed
+ *             - 2 parallel is NULL
+ *             - 3 parallel is not initialized
+ * @note       the write fails when a module does not ack and nack tells which ones
+ */
+uint8_t tm1637_parallel_set_display(tm1637_parallel_t *parallel, tm1637_bool_t enable, tm1637_pulse_width_t width, uint16_t *nack)
+{
+    uint16_t select;
+    uint16_t fail;
+
+    if (parallel == NULL)                                                                           /* check parallel */
+    {
+        return 2;                                                                                   /* return error */
+    }
+    if (parallel->inited != 1)                                                                      /* check parallel initialization */
+    {
+        return 3;                                                                                   /* return error */
+    }
+
+    select = parallel->module_mask;                                                                 /* all modules */
+    a_tm1637_parallel_start(parallel, select);                                                      /* start */
+    fail = a_tm1637_parallel_command(parallel, select, (uint8_t)(TM1637_COMMAND_DISPLAY |
+                                                         (enable << 3) | (width & 0x07)));          /* set the display */
+    a_tm1637_parallel_stop(parallel, select);                                                       /* stop */
+    if (nack != NULL)                                                                               /* check nack */
+    {
+        *nack = fail;                                                                               /* set nack */
+    }
+    if (fail != 0)                                                                                  /* check ack */
+    {
+        parallel->debug_print("tm1637: module 0x%04X no ack.\n", fail);                             /* no ack */
+
+        return 1;                                                                                   /* return error */
+    }
+
+    return 0;                                                                                       /* success return 0 */
+}
+
+/**
+ * @brief      read the keys of all modules at once
+ * @param[in]  *parallel points to a tm1637 parallel structure
+ * @param[out] *seg points to a seg buffer with one entry for each module
+ * @param[out] *k points to a k buffer with one entry for each module
+ * @param[out] *nack points to a no ack module mask buffer, NULL is allowed
+ * @return     status code
+ *             - 0 success
+ *             - 1 read segment failed
+ *             - 2 parallel is NULL
+ *             - 3 parallel is not initialized
+ * @note       one read command scans every module, seg[m] and k[m] decode like tm1637_read_segment,
+ *             the read fails when a module does not ack and nack tells which ones
+ */
+uint8_t tm1637_parallel_read_segment(tm1637_parallel_t *parallel, uint8_t *seg, uint8_t *k, uint16_t *nack)
+{
+    uint8_t lane[16];
+    uint16_t word[8];
+    uint16_t select;
+    uint16_t fail;
+    uint8_t m;
+
+    if (parallel == NULL)                                                              /* check parallel */
+    {
+        return 2;                                                                      /* return error */
+    }
+    if (parallel->inited != 1)                                                         /* check parallel initialization */
+    {
+        return 3;                                                                      /* return error */
+    }
+
+    select = parallel->module_mask;                                                    /* all modules */
+    a_tm1637_parallel_start(parallel, select);                                         /* start */
+    fail = a_tm1637_parallel_command(parallel, select, TM1637_COMMAND_DATA | (1 << 1));    /* read key command */
+    a_tm1637_parallel_read_byte(parallel, word);                                       /* sample all modules */
+    a_tm1637_parallel_stop(parallel, select);                                          /* stop */
+    tm1637_parallel_detranspose(word, lane);                                           /* one byte for each module */
+    for (m = 0; m < parallel->modules; m++)                                            /* loop all modules */
+    {
+        seg[m] = lane[m] & 0x7;                                                        /* get seg */
+        k[m] = (lane[m] >> 3) & 0x03;                                                  /* get k */
+    }
+    if (nack != NULL)                                                                  /* check nack */
+    {
+        *nack = fail;                                                                  /* set nack */
+    }
+    if (fail != 0)                                                                     /* check ack */
+    {
+        parallel->debug_print("tm1637: module 0x%04X no ack.\n", fail);                /* no ack */
+
+        return 1;                                                                      /* return error */
+    }
+
+    return 0;                                                                          /* success return 0 */
+}
+
+/**
+ * @brief      write the same segments to the selected modules
+ * @param[in]  *parallel points to a tm1637 parallel structure
+ * @param[in]  select is the selected module mask
+ * @param[in]  addr is the start address
+ * @param[in]  *data points to a data buffer
+ * @param[in]  len is the data length
+ * @param[out] *nack points to a no ack module mask buffer, NULL is allowed
+ * @return     status code
+ *             - 0 success
+ *             - 1 broadcast segment failed
+ *             - 2 parallel is NULL
+ *             - 3 parallel is not initialized
+ *             - 4 addr + len > 6
+ *             - 5 select is invalid
+ * @note       one transmission drives every selected dio line with the same bits,
+ *             the other modules see no start and ignore the clock
+ */
+uint8_t tm1637_parallel_broadcast_segment(tm1637_parallel_t *parallel, uint16_t select, uint8_t addr, uint8_t *data, uint8_t len, uint16_t *nack)
+{
+    uint16_t fail;
+    uint8_t i;
+
+    if (parallel == NULL)                                                                      /* check parallel */
+    {
+        return 2;                                                                              /* return error */
+    }
+    if (parallel->inited != 1)                                                                 /* check parallel initialization */
+    {
+        return 3;                                                                              /* return error */
+    }
+    if (addr + len > 6)                                                                        /* check range */
+    {
+        parallel->debug_print("tm1637: addr + len > 6.\n");                                    /* addr + len > 6 */
+
+        return 4;                                                                              /* return error */
+    }
+    if ((select == 0) || ((select & ~parallel->module_mask) != 0))                             /* check select */
+    {
+        parallel->debug_print("tm1637: select is invalid.\n");                                 /* select is invalid */
+
+        return 5;                                                                              /* return error */
+    }
+
+    a_tm1637_parallel_start(parallel, select);                                                 /* start */
+    fail = a_tm1637_parallel_command(parallel, select, TM1637_COMMAND_DATA);                   /* auto increment 1 mode */
+    a_tm1637_parallel_stop(parallel, select);                                                  /* stop */
+    a_tm1637_parallel_start(parallel, select);                                                 /* start */
+    fail |= a_tm1637_parallel_command(parallel, select, TM1637_COMMAND_ADDRESS | addr);        /* set the address */
+    for (i = 0; i < len; i++)                                                                  /* loop all digits */
+    {
+        fail |= a_tm1637_parallel_command(parallel, select, data[i]);                          /* same digit on all lines */
+    }
+    a_tm1637_parallel_stop(parallel, select);                                                  /* stop */
+    if (nack != NULL)                                                                          /* check nack */
+    {
+        *nack = fail;                                                                          /* set nack */
+    }
+    if (fail != 0)                                                                             /* check ack */
+    {
+        parallel->debug_print("tm1637: module 0x%04X no ack.\n", fail);                        /* no ack */
+
+        return 1;                                                                              /* return error */
+    }
+
+    return 0;                                                                                  /* success return 0 */
+}
+
+/**
+ * @brief      set the display of the selected modules
+ * @param[in]  *parallel points to a tm1637 parallel structure
+ * @param[in]  select is the selected module mask
+ * @param[in]  enable is a bool value
+ * @param[in]  width is the pulse width
+ * @param[out] *nack points to a no ack module mask buffer, NULL is allowed
+ * @return     status code
+ *             - 0 success
+ *             - 1 broadcast display failed
+ *             - 2 parallel is NULL
+ *             - 3 parallel is not initialized
+ *             - 5 select is invalid
+ * @note       none
+ */
+uint8_t tm1637_parallel_broadcast_display(tm1637_parallel_t *parallel, uint16_t select, tm1637_bool_t enable, tm1637_pulse_width_t width, uint16_t *nack)
+{
+    uint16_t fail;
+
+    if (parallel == NULL)                                                                                 /* check parallel */
+    {
+        return 2;                                                                                         /* return error */
+    }
+    if (parallel->inited != 1)                                                                            /* check parallel initialization */
+    {
+        return 3;                                                                                         /* return error */
+    }
+    if ((select == 0) || ((select & ~parallel->module_mask) != 0))                                        /* check select */
+    {
+        parallel->debug_print("tm1637: select is invalid.\n");                                            /* select is invalid */
+
+        return 5;                                                                                         /* return error */
+    }
+
+    a_tm1637_parallel_start(parallel, select);                                                            /* start */
+    fail = a_tm1637_parallel_command(parallel, select, (uint8_t)(TM1637_COMMAND_DISPLAY |
+                                                                 (enable << 3) | (width & 0x07)));        /* set the display */
+    a_tm1637_parallel_stop(parallel, select);                                                             /* stop */
+    if (nack != NULL)                                                                                     /* check nack */
+    {
+        *nack = fail;                                                                                     /* set nack */
+    }
+    if (fail != 0)                                                                                        /* check ack */
+    {
+        parallel->debug_print("tm1637: module 0x%04X no ack.\n", fail);                                   /* no ack */
+
+        return 1;                                                                                         /* return error */
+    }
+
+    return 0;                                                                                             /* success return 0 */
+}
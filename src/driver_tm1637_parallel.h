@@ -0,0 +1,304 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_parallel.h
+ * @brief     driver tm1637 parallel header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+
+#ifndef DRIVER_TM1637_PARALLEL_H
+#define DRIVER_TM1637_PARALLEL_H
+
+#include "driver_tm1637.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup tm1637_parallel_driver tm1637 parallel driver function
+ * @brief    tm1637 parallel driver modules
+ * @ingroup  tm1637_driver
+ * @{
+ */
+
+/**
+ * @brief tm1637 parallel definition
+ */
+#define TM1637_PARALLEL_MAX_MODULE        16        /**< 16 modules */
+#ifndef TM1637_PARALLEL_DELAY_US
+    #define TM1637_PARALLEL_DELAY_US      2         /**< 2us half clock period */
+#endif
+
+/**
+ * @brief tm1637 parallel structure definition
+ */
+typedef struct tm1637_parallel_s
+{
+    uint8_t (*port_init)(void);                                /**< point to a port_init function address */
+    uint8_t (*port_deinit)(void);                              /**< point to a port_deinit function address */
+    void (*clk_write)(uint8_t level);                          /**< point to a clk_write function address */
+    void (*dio_write)(uint32_t mask, uint32_t level);          /**< point to a dio_write function address */
+    uint32_t (*dio_read)(void);                                /**< point to a dio_read function address */
+    void (*delay_us)(uint32_t us);                             /**< point to a delay_us function address */
+    void (*debug_print)(const char *const fmt, ...);           /**< point to a debug_print function address */
+    uint32_t dio_mask;                                         /**< dio pins of all modules */
+    uint16_t module_mask;                                      /**< module mask */
+    uint8_t dio_shift;                                         /**< dio pin of module 0 */
+    uint8_t modules;                                           /**< module number */
+    uint8_t inited;                                            /**< inited flag */
+} tm1637_parallel_t;
+
+/**
+ * @}
+ */
+
+/**
+ * @defgroup tm1637_parallel_link_driver tm1637 parallel link driver function
+ * @brief    tm1637 parallel link driver modules
+ * @ingroup  tm1637_parallel_driver
+ * @{
+ */
+
+/**
+ * @brief     initialize tm1637_parallel_t structure
+ * @param[in] HANDLE points to a tm1637 parallel structure
+ * @param[in] STRUCTURE is tm1637_parallel_t
+ * @note      none
+ */
+#define DRIVER_TM1637_PARALLEL_LINK_INIT(HANDLE, STRUCTURE)      memset(HANDLE, 0, sizeof(STRUCTURE))
+
+/**
+ * @brief     link port_init function
+ * @param[in] HANDLE points to a tm1637 parallel structure
+ * @param[in] FUC points to a port_init function address
+ * @note      none
+ */
+#define DRIVER_TM1637_PARALLEL_LINK_PORT_INIT(HANDLE, FUC)       (HANDLE)->port_init = FUC
+
+/**
+ * @brief     link port_deinit function
+ * @param[in] HANDLE points to a tm1637 parallel structure
+ * @param[in] FUC points to a port_deinit function address
+ * @note      none
+ */
+#define DRIVER_TM1637_PARALLEL_LINK_PORT_DEINIT(HANDLE, FUC)     (HANDLE)->port_deinit = FUC
+
+/**
+ * @brief     link clk_write function
+ * @param[in] HANDLE points to a tm1637 parallel structure
+ * @param[in] FUC points to a clk_write function address
+ * @note      it drives the shared clock line
+ */
+#define DRIVER_TM1637_PARALLEL_LINK_CLK_WRITE(HANDLE, FUC)       (HANDLE)->clk_write = FUC
+
+/**
+ * @brief     link dio_write function
+ * @param[in] HANDLE points to a tm1637 parallel structure
+ * @param[in] FUC points to a dio_write function address
+ * @note      it sets the masked open drain dio pins of the port in one write, 1 releases the line
+ */
+#define DRIVER_TM1637_PARALLEL_LINK_DIO_WRITE(HANDLE, FUC)       (HANDLE)->dio_write = FUC
+
+/**
+ * @brief     link dio_read function
+ * @param[in] HANDLE points to a tm1637 parallel structure
+ * @param[in] FUC points to a dio_read function address
+ * @note      it returns the input register of the port
+ */
+#define DRIVER_TM1637_PARALLEL_LINK_DIO_READ(HANDLE, FUC)        (HANDLE)->dio_read = FUC
+
+/**
+ * @brief     link delay_us function
+ * @param[in] HANDLE points to a tm1637 parallel structure
+ * @param[in] FUC points to a delay_us function address
+ * @note      none
+ */
+#define DRIVER_TM1637_PARALLEL_LINK_DELAY_US(HANDLE, FUC)        (HANDLE)->delay_us = FUC
+
+/**
+ * @brief     link debug_print function
+ * @param[in] HANDLE points to a tm1637 parallel structure
+ * @param[in] FUC points to a debug_print function address
+ * @note      none
+ */
+#define DRIVER_TM1637_PARALLEL_LINK_DEBUG_PRINT(HANDLE, FUC)     (HANDLE)->debug_print = FUC
+
+/**
+ * @}
+ */
+
+/**
+ * @defgroup tm1637_parallel_base_driver tm1637 parallel base driver function
+ * @brief    tm1637 parallel base driver modules
+ * @ingroup  tm1637_parallel_driver
+ * @{
+ */
+
+/**
+ * @brief      transpose one byte of each module into port words
+ * @param[in]  *lane points to 16 bytes, one byte of each module
+ * @param[out] *word points to 8 words, bit m of word b is bit b of lane m
+ * @note       it uses sse2 or neon when the compiler targets them and portable c otherwise
+ */
+void tm1637_parallel_transpose(const uint8_t lane[16], uint16_t word[8]);
+
+/**
+ * @brief      transpose port words back into one byte of each module
+ * @param[in]  *word points to 8 words, bit m of word b is bit b of lane m
+ * @param[out] *lane points to 16 bytes, one byte of each module
+ * @note       it is the inverse of tm1637_parallel_transpose
+ */
+void tm1637_parallel_detranspose(const uint16_t word[8], uint8_t lane[16]);
+
+/**
+ * @brief     initialize the parallel bus
+ * @param[in] *parallel points to a tm1637 parallel structure
+ * @param[in] modules is the module number
+ * @param[in] dio_shift is the dio pin of module 0, module m uses pin dio_shift + m
+ * @return    status code
+ *            - 0 success
+ *            - 1 port initialization failed
+ *            - 2 parallel is NULL
+ *            - 3 linked functions is NULL
+ *            - 4 modules or dio_shift is invalid
+ * @note      1 <= modules <= 16, all modules share one clock pin
+ */
+uint8_t tm1637_parallel_init(tm1637_parallel_t *parallel, uint8_t modules, uint8_t dio_shift);
+
+/**
+ * @brief     close the parallel bus
+ * @param[in] *parallel points to a tm1637 parallel structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 port deinit failed
+ *            - 2 parallel is NULL
+ *            - 3 parallel is not initialized
+ * @note      none
+ */
+uint8_t tm1637_parallel_deinit(tm1637_parallel_t *parallel);
+
+/**
+ * @brief      write the segments of all modules at once
+ * @param[in]  *parallel points to a tm1637 parallel structure
+ * @param[in]  addr is the start address
+ * @param[in]  **data points to a frame of 6 digits for each module
+ * @param[in]  len is the data length
+ * @param[out] *nack points to a no ack module mask buffer, NULL is allowed
+ * @return     status code
+ *             - 0 success
+ *             - 1 write segment failed
+ *             - 2 parallel is NULL
+ *             - 3 parallel is not initialized
+ *             - 4 addr + len > 6
+ * @note       every module uses the auto increment 1 mode, data[m][addr + i] goes to digit addr + i of module m,
+ *             the write fails when a module does not ack and nack tells which ones
+ */
+uint8_t tm1637_parallel_write_segment(tm1637_parallel_t *parallel, uint8_t addr, uint8_t (*data)[6], uint8_t len, uint16_t *nack);
+
+/**
+ * @brief      set the display of all modules at once
+ * @param[in]  *parallel points to a tm1637 parallel structure
+ * @param[in]  enable is a bool value
+ * @param[in]  width is the pulse width
+ * @param[out] *nack points to a no ack module mask buffer, NULL is allowed
+ * @return     status code
+ *             - 0 success
+ *             - 1 set display failed
+ *             - 2 parallel is NULL
+ *             - 3 parallel is not initialized
+ * @note       the write fails when a module does not ack and nack tells which ones
+ */
+uint8_t tm1637_parallel_set_display(tm1637_parallel_t *parallel, tm1637_bool_t enable, tm1637_pulse_width_t width, uint16_t *nack);
+
+/**
+ * @brief      read the keys of all modules at once
+ * @param[in]  *parallel points to a tm1637 parallel structure
+ * @param[out] *seg points to a seg buffer with one entry for each module
+ * @param[out] *k points to a k buffer with one entry for each module
+ * @param[out] *nack points to a no ack module mask buffer, NULL is allowed
+ * @return     status code
+ *             - 0 success
+ *             - 1 read segment failed
+ *             - 2 parallel is NULL
+ *             - 3 parallel is not initialized
+ * @note       one read command scans every module, seg[m] and k[m] decode like tm1637_read_segment,
+ *             the read fails when a module does not ack and nack tells which ones
+ */
+uint8_t tm1637_parallel_read_segment(tm1637_parallel_t *parallel, uint8_t *seg, uint8_t *k, uint16_t *nack);
+
+/**
+ * @brief      write the same segments to the selected modules
+ * @param[in]  *parallel points to a tm1637 parallel structure
+ * @param[in]  select is the selected module mask
+ * @param[in]  addr is the start address
+ * @param[in]  *data points to a data buffer
+ * @param[in]  len is the data length
+ * @param[out] *nack points to a no ack module mask buffer, NULL is allowed
+ * @return     status code
+ *             - 0 success
+ *             - 1 broadcast segment failed
+ *             - 2 parallel is NULL
+ *             - 3 parallel is not initialized
+ *             - 4 addr + len > 6
+ *             - 5 select is invalid
+ * @note       one transmission drives every selected dio line with the same bits,
+ *             the other modules see no start and ignore the clock
+ */
+uint8_t tm1637_parallel_broadcast_segment(tm1637_parallel_t *parallel, uint16_t select, uint8_t addr, uint8_t *data, uint8_t len, uint16_t *nack);
+
+/**
+ * @brief      set the display of the selected modules
+ * @param[in]  *parallel points to a tm1637 parallel structure
+ * @param[in]  select is the selected module mask
+ * @param[in]  enable is a bool value
+ * @param[in]  width is the pulse width
+ * @param[out] *nack points to a no ack module mask buffer, NULL is allowed
+ * @return     status code
+ *             - 0 success
+ *             - 1 broadcast display failed
+ *             - 2 parallel is NULL
+ *             - 3 parallel is not initialized
+ *             - 5 select is invalid
+ * @note       none
+ */
+uint8_t tm1637_parallel_broadcast_display(tm1637_parallel_t *parallel, uint16_t select, tm1637_bool_t enable, tm1637_pulse_width_t width, uint16_t *nack);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,287 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_queue.c
+ * @brief     driver tm1637 queue source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+
+#include "driver_tm1637_queue.h"
+
+/**
+ * @brief     initialize the queue
+ * @param[in] *queue points to a tm1637 queue structure
+ * @param[in] *handle points to an initialized tm1637 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 queue or handle is NULL
+ *            - 3 handle is not initialized
+ * @note      none
+ */
+uint8_t tm1637_queue_init(tm1637_queue_t *queue, tm1637_handle_t *handle)
+{
+    uint32_t i;
+
+    if ((queue == NULL) || (handle == NULL))                     /* check queue */
+    {
+        return 2;                                                /* return error */
+    }
+    if (handle->inited != 1)                                     /* check handle initialization */
+    {
+        return 3;                                                /* return error */
+    }
+
+    for (i = 0; i < TM1637_QUEUE_DEPTH; i++)                     /* loop all cells */
+    {
+        atomic_init(&queue->cell[i].sequence, i);                /* cell i is free for position i */
+        queue->cell[i].mask = 0;                                 /* clear mask */
+    }
+    atomic_init(&queue->enqueue_pos, 0);                         /* init 0 */
+    atomic_init(&queue->full, 0);                                /* init 0 */
+    queue->dequeue_pos = 0;                                      /* init 0 */
+    queue->merged = 0;                                           /* init 0 */
+    queue->transmitted = 0;                                      /* init 0 */
+    queue->sent_mask = 0;                                        /* nothing is known */
+    queue->pending_mask = 0;                                     /* nothing is pending */
+    memset(queue->pending, 0, sizeof(queue->pending));           /* clear the pending digits */
+    queue->handle = handle;                                      /* save handle */
+
+    return 0;                                                    /* success return 0 */
+}
+
+/**
+ * @brief     push a digit update
+ * @param[in] *queue points to a tm1637 queue structure
+ * @param[in] mask is the digit mask, bit n selects data[n]
+ * @param[in] *data points to a 6 digits frame buffer
+ * @return    status code
+ *            - 0 success
+ *            - 2 queue is NULL
+ *            - 4 mask is invalid
+ *            - 5 queue is full
+ * @note      any task may call this function, it is lock free and never touches the bus
+ */
+uint8_t tm1637_queue_push(tm1637_queue_t *queue, uint8_t mask, uint8_t *data)
+{
+    tm1637_queue_cell_t *cell;
+    uint_least32_t pos;
+    uint_least32_t sequence;
+    int32_t diff;
+
+    if (queue == NULL)                                                                             /* check queue */
+    {
+        return 2;                                                                                  /* return error */
+    }
+    if ((mask == 0) || (mask > 0x3F))                                                              /* check mask */
+    {
+        return 4;                                                                                  /* return error */
+    }
+
+    pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);                         /* get position */
+    while (1)                                                                                      /* loop */
+    {
+        cell = &queue->cell[pos & (TM1637_QUEUE_DEPTH - 1)];                                       /* get cell */
+        sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);                    /* get sequence */
+        diff = (int32_t)(sequence - pos);                                                          /* get diff */
+        if (diff == 0)                                                                             /* cell is free */
+        {
+            if (atomic_compare_exchange_weak_explicit(&queue->enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) /* reserve the cell */
+            {
+                break;                                                                             /* break */
+            }
+        }
+        else if (diff < 0)                                                                         /* the flusher is behind */
+        {
+            atomic_fetch_add_explicit(&queue->full, 1, memory_order_relaxed);                      /* full++ */
+
+            return 5;                                                                              /* return error */
+        }
+        else                                                                                       /* another producer won */
+        {
+            pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);                 /* reload */
+        }
+    }
+    cell->mask = mask;                                                                             /* set mask */
+    memcpy(cell->data, data, 6);                                                                   /* copy data */
+    atomic_store_explicit(&cell->sequence, pos + 1, memory_order_release);                         /* publish the cell */
+
+    return 0;                                                                                      /* success return 0 */
+}
+
+/**
+ * @brief      drain the queue and send the merged updates
+ * @param[in]  *queue points to a tm1637 queue structure
+ * @param[out] *count points to a drained update counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 flush failed
+ *             - 2 queue is NULL
+ * @note       only one flusher task may call this function, all drained updates are merged,
+ *             gaps of already sent digits are bridged so each run is one auto increment burst,
+ *             the digits of a failed flush stay pending and the next flush sends them again
+ */
+uint8_t tm1637_queue_flush(tm1637_queue_t *queue, uint16_t *count)
+{
+    tm1637_queue_cell_t *cell;
+    uint_least32_t sequence;
+    uint8_t frame[6];
+    uint8_t mask;
+    uint8_t first;
+    uint8_t last;
+    uint8_t bridge;
+    uint16_t drained;
+    uint8_t i;
+
+    if (queue == NULL)                                                                             /* check queue */
+    {
+        return 2;                                                                                  /* return error */
+    }
+
+    /* drain one batch over the pending digits, later updates overwrite earlier ones */
+    memcpy(frame, queue->pending, 6);                                                              /* copy the pending digits */
+    mask = queue->pending_mask;                                                                    /* pending mask */
+    drained = 0;                                                                                   /* init 0 */
+    while (drained < TM1637_QUEUE_DEPTH)                                                           /* one batch */
+    {
+        cell = &queue->cell[queue->dequeue_pos & (TM1637_QUEUE_DEPTH - 1)];                        /* get cell */
+        sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);                    /* get sequence */
+        if (sequence != (uint_least32_t)(queue->dequeue_pos + 1))                                  /* not published */
+        {
+            break;                                                                                 /* break */
+        }
+        for (i = 0; i < 6; i++)                                                                    /* loop all digits */
+        {
+            if ((cell->mask & (1 << i)) != 0)                                                      /* selected */
+            {
+                frame[i] = cell->data[i];                                                          /* merge */
+            }
+        }
+        mask |= cell->mask;                                                                        /* merge mask */
+        atomic_store_explicit(&cell->sequence, queue->dequeue_pos + TM1637_QUEUE_DEPTH,
+                              memory_order_release);                                               /* free the cell */
+        queue->dequeue_pos++;                                                                      /* next */
+        drained++;                                                                                 /* drained++ */
+    }
+    if (count != NULL)                                                                             /* check count */
+    {
+        *count = drained;                                                                          /* set count */
+    }
+    if ((drained == 0) && (mask == 0))                                                             /* nothing to do */
+    {
+        return 0;                                                                                  /* success return 0 */
+    }
+    queue->merged += drained;                                                                      /* merged += drained */
+
+    /* drop digits equal to the sent ones */
+    for (i = 0; i < 6; i++)                                                                        /* loop all digits */
+    {
+        if (((mask & queue->sent_mask & (1 << i)) != 0) && (frame[i] == queue->sent[i]))           /* not changed */
+        {
+            mask &= (uint8_t)(~(1 << i));                                                          /* drop */
+        }
+    }
+    if (mask == 0)                                                                                 /* nothing changed */
+    {
+        return 0;                                                                                  /* success return 0 */
+    }
+
+    /* bridge the gaps with the sent digits so the whole update is one burst */
+    first = 0;                                                                                     /* init 0 */
+    while ((mask & (1 << first)) == 0)                                                             /* find the first */
+    {
+        first++;                                                                                   /* next */
+    }
+    last = 5;                                                                                      /* init 5 */
+    while ((mask & (1 << last)) == 0)                                                              /* find the last */
+    {
+        last--;                                                                                    /* next */
+    }
+    bridge = (uint8_t)((((1 << (last + 1)) - 1) & ~((1 << first) - 1)) & ~mask);                   /* gap digits */
+    if ((bridge & queue->sent_mask) == bridge)                                                     /* all gaps are known */
+    {
+        for (i = first; i <= last; i++)                                                            /* loop the gaps */
+        {
+            if ((bridge & (1 << i)) != 0)                                                          /* gap digit */
+            {
+                frame[i] = queue->sent[i];                                                         /* keep the sent value */
+            }
+        }
+        mask |= bridge;                                                                            /* one run */
+    }
+
+    if (tm1637_write_segment_mask(queue->handle, frame, mask) != 0)                                /* write the runs */
+    {
+        queue->sent_mask &= (uint8_t)(~mask);                                                      /* chip content is unknown */
+        memcpy(queue->pending, frame, 6);                                                          /* keep the digits */
+        queue->pending_mask = mask;                                                                /* retry them next time */
+
+        return 1;                                                                                  /* return error */
+    }
+    for (i = 0; i < 6; i++)                                                                        /* loop all digits */
+    {
+        if ((mask & (1 << i)) != 0)                                                                /* sent */
+        {
+            queue->sent[i] = frame[i];                                                             /* save */
+        }
+    }
+    queue->sent_mask |= mask;                                                                      /* known digits */
+    queue->pending_mask = 0;                                                                       /* nothing is pending */
+    queue->transmitted++;                                                                          /* transmitted++ */
+
+    return 0;                                                                                      /* success return 0 */
+}
+
+/**
+ * @brief      get the queue statistics
+ * @param[in]  *queue points to a tm1637 queue structure
+ * @param[out] *merged points to a merged update counter buffer
+ * @param[out] *transmitted points to a flush counter buffer
+ * @param[out] *full points to a rejected update counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 queue is NULL
+ * @note       none
+ */
+uint8_t tm1637_queue_get_statistics(tm1637_queue_t *queue, uint32_t *merged, uint32_t *transmitted, uint32_t *full)
+{
+    if (queue == NULL)                                            /* check queue */
+    {
+        return 2;                                                 /* return error */
+    }
+
+    *merged = queue->merged;                                      /* get merged */
+    *transmitted = queue->transmitted;                            /* get transmitted */
+    *full = (uint32_t)atomic_load(&queue->full);                  /* get full */
+
+    return 0;                                                     /* success return 0 */
+}
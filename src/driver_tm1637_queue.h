@@ -0,0 +1,158 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_queue.h
+ * @brief     driver tm1637 queue header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+
+#ifndef DRIVER_TM1637_QUEUE_H
+#define DRIVER_TM1637_QUEUE_H
+
+#include "driver_tm1637.h"
+#if !defined(__STDC_VERSION__) || (__STDC_VERSION__ < 201112L) || defined(__STDC_NO_ATOMICS__)
+    #error "driver_tm1637_queue needs a c11 compiler with <stdatomic.h>"
+#endif
+#include <stdatomic.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup tm1637_queue_driver tm1637 queue driver function
+ * @brief    tm1637 queue driver modules
+ * @note     it uses the c11 atomics, so build it as c11 or later
+ * @ingroup  tm1637_driver
+ * @{
+ */
+
+/**
+ * @brief tm1637 queue depth definition
+ */
+#ifndef TM1637_QUEUE_DEPTH
+    #define TM1637_QUEUE_DEPTH        16        /**< 16 updates, must be a power of 2 */
+#endif
+#if ((TM1637_QUEUE_DEPTH & (TM1637_QUEUE_DEPTH - 1)) != 0) || (TM1637_QUEUE_DEPTH < 2)
+    #error "TM1637_QUEUE_DEPTH must be a power of 2"
+#endif
+
+/**
+ * @brief tm1637 queue cell structure definition
+ */
+typedef struct tm1637_queue_cell_s
+{
+    atomic_uint_least32_t sequence;        /**< cell sequence */
+    uint8_t mask;                          /**< digit mask */
+    uint8_t data[6];                       /**< digits indexed by address */
+} tm1637_queue_cell_t;
+
+/**
+ * @brief tm1637 queue structure definition
+ */
+typedef struct tm1637_queue_s
+{
+    tm1637_handle_t *handle;                             /**< tm1637 handle */
+    tm1637_queue_cell_t cell[TM1637_QUEUE_DEPTH];        /**< update ring */
+    atomic_uint_least32_t enqueue_pos;                   /**< producer position */
+    atomic_uint_least32_t full;                          /**< rejected update counter */
+    uint32_t dequeue_pos;                                /**< flusher position */
+    uint32_t merged;                                     /**< merged update counter */
+    uint32_t transmitted;                                /**< flush counter */
+    uint8_t sent[6];                                     /**< digits sent to the chip */
+    uint8_t sent_mask;                                   /**< known sent digit mask */
+    uint8_t pending[6];                                  /**< digits of a failed flush */
+    uint8_t pending_mask;                                /**< pending digit mask */
+} tm1637_queue_t;
+
+/**
+ * @brief     initialize the queue
+ * @param[in] *queue points to a tm1637 queue structure
+ * @param[in] *handle points to an initialized tm1637 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 queue or handle is NULL
+ *            - 3 handle is not initialized
+ * @note      none
+ */
+uint8_t tm1637_queue_init(tm1637_queue_t *queue, tm1637_handle_t *handle);
+
+/**
+ * @brief     push a digit update
+ * @param[in] *queue points to a tm1637 queue structure
+ * @param[in] mask is the digit mask, bit n selects data[n]
+ * @param[in] *data points to a 6 digits frame buffer
+ * @return    status code
+ *            - 0 success
+ *            - 2 queue is NULL
+ *            - 4 mask is invalid
+ *            - 5 queue is full
+ * @note      any task may call this function, it is lock free and never touches the bus
+ */
+uint8_t tm1637_queue_push(tm1637_queue_t *queue, uint8_t mask, uint8_t *data);
+
+/**
+ * @brief      drain the queue and send the merged updates
+ * @param[in]  *queue points to a tm1637 queue structure
+ * @param[out] *count points to a drained update counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 flush failed
+ *             - 2 queue is NULL
+ * @note       only one flusher task may call this function, all drained updates are merged,
+ *             gaps of already sent digits are bridged so each run is one auto increment burst,
+ *             the digits of a failed flush stay pending and the next flush sends them again
+ */
+uint8_t tm1637_queue_flush(tm1637_queue_t *queue, uint16_t *count);
+
+/**
+ * @brief      get the queue statistics
+ * @param[in]  *queue points to a tm1637 queue structure
+ * @param[out] *merged points to a merged update counter buffer
+ * @param[out] *transmitted points to a flush counter buffer
+ * @param[out] *full points to a rejected update counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 queue is NULL
+ * @note       none
+ */
+uint8_t tm1637_queue_get_statistics(tm1637_queue_t *queue, uint32_t *merged, uint32_t *transmitted, uint32_t *full);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,196 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_remote.c
+ * @brief     driver tm1637 remote source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_tm1637_remote.h"
+
+/**
+ * @brief     reverse the bits of a byte
+ * @param[in] data is the input byte
+ * @return    reversed byte
+ * @note      the core sends the chip bytes lsb first, the bridge takes the logical bytes
+ */
+static uint8_t a_tm1637_remote_reverse(uint8_t data)
+{
+    data = (uint8_t)(((data & 0xF0) >> 4) | ((data & 0x0F) << 4));        /* swap nibbles */
+    data = (uint8_t)(((data & 0xCC) >> 2) | ((data & 0x33) << 2));        /* swap pairs */
+    data = (uint8_t)(((data & 0xAA) >> 1) | ((data & 0x55) << 1));        /* swap bits */
+
+    return data;                                                          /* return the result */
+}
+
+/**
+ * @brief     initialize a remote display
+ * @param[in] *remote points to a tm1637 remote structure
+ * @param[in] *client points to an initialized tm1637 link client structure
+ * @param[in] display is the display index on the bridge
+ * @return    status code
+ *            - 0 success
+ *            - 2 remote or client is NULL
+ * @note      link the tm1637_remote_iic_* functions in a tm1637 ops table and the remote as its ctx,
+ *            several remotes may share one client but only one task may use the client
+ */
+uint8_t tm1637_remote_init(tm1637_remote_t *remote, tm1637_link_client_t *client, uint8_t display)
+{
+    if ((remote == NULL) || (client == NULL))        /* check remote */
+    {
+        return 2;                                    /* return error */
+    }
+
+    remote->client = client;                         /* save client */
+    remote->display = display;                       /* save display */
+
+    return 0;                                        /* success return 0 */
+}
+
+/**
+ * @brief     remote iic init
+ * @param[in] *ctx points to a tm1637 remote structure
+ * @return    status code
+ *            - 0 success
+ * @note      the bridge owns the bus
+ */
+uint8_t tm1637_remote_iic_init(void *ctx)
+{
+    (void)ctx;
+
+    return 0;                                        /* success return 0 */
+}
+
+/**
+ * @brief     remote iic deinit
+ * @param[in] *ctx points to a tm1637 remote structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 a queued write failed
+ * @note      it waits for every queued write
+ */
+uint8_t tm1637_remote_iic_deinit(void *ctx)
+{
+    tm1637_remote_t *remote = (tm1637_remote_t *)ctx;
+
+    return tm1637_link_client_sync(remote->client);         /* wait for the writes */
+}
+
+/**
+ * @brief     remote iic write command
+ * @param[in] *ctx points to a tm1637 remote structure
+ * @param[in] addr is the iic register address
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 link failed
+ * @note      the write is queued and returns at once, a failure on the bridge is reported
+ *            by tm1637_remote_sync, the next read or the deinit
+ */
+uint8_t tm1637_remote_iic_write_cmd_custom(void *ctx, uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    tm1637_remote_t *remote = (tm1637_remote_t *)ctx;
+    uint8_t data[16];
+    uint16_t i;
+
+    if (len > 16)                                                                               /* check len */
+    {
+        return 1;                                                                               /* return error */
+    }
+    for (i = 0; i < len; i++)                                                                   /* loop all */
+    {
+        data[i] = a_tm1637_remote_reverse(buf[i]);                                              /* logical byte */
+    }
+    if (tm1637_link_client_set_reg(remote->client, remote->display,
+                                   a_tm1637_remote_reverse(addr), data, (uint8_t)len) != 0)     /* queue the write */
+    {
+        return 1;                                                                               /* return error */
+    }
+
+    return 0;                                                                                   /* success return 0 */
+}
+
+/**
+ * @brief      remote iic read command
+ * @param[in]  *ctx points to a tm1637 remote structure
+ * @param[in]  addr is the iic register address
+ * @param[out] *buf points to a data buffer
+ * @param[in]  len is the length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read or a queued write failed
+ * @note       the queued writes go out first, the call blocks for the response
+ */
+uint8_t tm1637_remote_iic_read_cmd_custom(void *ctx, uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    tm1637_remote_t *remote = (tm1637_remote_t *)ctx;
+    uint16_t i;
+
+    if (len > 16)                                                                               /* check len */
+    {
+        return 1;                                                                               /* return error */
+    }
+    if (tm1637_link_client_get_reg(remote->client, remote->display,
+                                   a_tm1637_remote_reverse(addr), buf, (uint8_t)len) != 0)      /* read */
+    {
+        return 1;                                                                               /* return error */
+    }
+    if (tm1637_link_client_sync(remote->client) != 0)                                           /* earlier writes failed */
+    {
+        return 1;                                                                               /* return error */
+    }
+    for (i = 0; i < len; i++)                                                                   /* loop all */
+    {
+        buf[i] = a_tm1637_remote_reverse(buf[i]);                                               /* bus byte */
+    }
+
+    return 0;                                                                                   /* success return 0 */
+}
+
+/**
+ * @brief     wait for the queued writes
+ * @param[in] *remote points to a tm1637 remote structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 a queued write failed
+ *            - 2 remote is NULL
+ * @note      it syncs the whole client, so it covers every remote sharing it
+ */
+uint8_t tm1637_remote_sync(tm1637_remote_t *remote)
+{
+    if (remote == NULL)                                             /* check remote */
+    {
+        return 2;                                                   /* return error */
+    }
+
+    return tm1637_link_client_sync(remote->client);                 /* wait for the writes */
+}
@@ -0,0 +1,140 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_remote.h
+ * @brief     driver tm1637 remote header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef DRIVER_TM1637_REMOTE_H
+#define DRIVER_TM1637_REMOTE_H
+
+#include "driver_tm1637_link.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup tm1637_remote_driver tm1637 remote driver function
+ * @brief    tm1637 remote driver modules
+ * @ingroup  tm1637_driver
+ * @{
+ */
+
+/**
+ * @brief tm1637 remote structure definition
+ */
+typedef struct tm1637_remote_s
+{
+    tm1637_link_client_t *client;        /**< link client of the bridge */
+    uint8_t display;                     /**< display index on the bridge */
+} tm1637_remote_t;
+
+/**
+ * @brief     initialize a remote display
+ * @param[in] *remote points to a tm1637 remote structure
+ * @param[in] *client points to an initialized tm1637 link client structure
+ * @param[in] display is the display index on the bridge
+ * @return    status code
+ *            - 0 success
+ *            - 2 remote or client is NULL
+ * @note      link the tm1637_remote_iic_* functions in a tm1637 ops table and the remote as its ctx,
+ *            several remotes may share one client but only one task may use the client
+ */
+uint8_t tm1637_remote_init(tm1637_remote_t *remote, tm1637_link_client_t *client, uint8_t display);
+
+/**
+ * @brief     remote iic init
+ * @param[in] *ctx points to a tm1637 remote structure
+ * @return    status code
+ *            - 0 success
+ * @note      the bridge owns the bus
+ */
+uint8_t tm1637_remote_iic_init(void *ctx);
+
+/**
+ * @brief     remote iic deinit
+ * @param[in] *ctx points to a tm1637 remote structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 a queued write failed
+ * @note      it waits for every queued write
+ */
+uint8_t tm1637_remote_iic_deinit(void *ctx);
+
+/**
+ * @brief     remote iic write command
+ * @param[in] *ctx points to a tm1637 remote structure
+ * @param[in] addr is the iic register address
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 link failed
+ * @note      the write is queued and returns at once, a failure on the bridge is reported
+ *            by tm1637_remote_sync, the next read or the deinit
+ */
+uint8_t tm1637_remote_iic_write_cmd_custom(void *ctx, uint8_t addr, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief      remote iic read command
+ * @param[in]  *ctx points to a tm1637 remote structure
+ * @param[in]  addr is the iic register address
+ * @param[out] *buf points to a data buffer
+ * @param[in]  len is the length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read or a queued write failed
+ * @note       the queued writes go out first, the call blocks for the response
+ */
+uint8_t tm1637_remote_iic_read_cmd_custom(void *ctx, uint8_t addr, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief     wait for the queued writes
+ * @param[in] *remote points to a tm1637 remote structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 a queued write failed
+ *            - 2 remote is NULL
+ * @note      it syncs the whole client, so it covers every remote sharing it
+ */
+uint8_t tm1637_remote_sync(tm1637_remote_t *remote);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,236 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_ring.c
+ * @brief     driver tm1637 ring source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_tm1637_ring.h"
+
+/**
+ * @brief     initialize the ring
+ * @param[in] *ring points to a tm1637 ring structure
+ * @param[in] *buf points to a byte buffer
+ * @param[in] size is the buffer size
+ * @return    status code
+ *            - 0 success
+ *            - 2 ring or buf is NULL
+ *            - 4 size is not a power of two
+ * @note      none
+ */
+uint8_t tm1637_ring_init(tm1637_ring_t *ring, uint8_t *buf, uint32_t size)
+{
+    if ((ring == NULL) || (buf == NULL))                                    /* check ring */
+    {
+        return 2;                                                           /* return error */
+    }
+    if ((size == 0) || (size > 0x80000000U) || ((size & (size - 1)) != 0))  /* check size */
+    {
+        return 4;                                                           /* return error */
+    }
+
+    ring->buf = buf;                                                        /* save buffer */
+    ring->size = size;                                                      /* save size */
+    atomic_init(&ring->head, 0);                                            /* init 0 */
+    atomic_init(&ring->tail, 0);                                            /* init 0 */
+    atomic_init(&ring->written, 0);                                         /* init 0 */
+    atomic_init(&ring->dropped, 0);                                         /* init 0 */
+
+    return 0;                                                               /* success return 0 */
+}
+
+/**
+ * @brief     write a message to the ring
+ * @param[in] *ring points to a tm1637 ring structure
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 2 ring is NULL
+ *            - 5 ring is full
+ * @note      only one writer may call this function, it never blocks,
+ *            a message which does not fit is dropped as a whole and counted
+ */
+uint8_t tm1637_ring_write(tm1637_ring_t *ring, const uint8_t *data, uint32_t len)
+{
+    uint_least32_t head;
+    uint_least32_t tail;
+    uint32_t pos;
+    uint32_t first;
+
+    if (ring == NULL)                                                                /* check ring */
+    {
+        return 2;                                                                    /* return error */
+    }
+
+    head = atomic_load_explicit(&ring->head, memory_order_relaxed);                  /* only the writer moves head */
+    tail = atomic_load_explicit(&ring->tail, memory_order_acquire);                  /* the reader is done with the bytes */
+    if (len > ring->size - (uint32_t)(head - tail))                                  /* check the free length */
+    {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);          /* dropped++ */
+
+        return 5;                                                                    /* return error */
+    }
+
+    pos = (uint32_t)head & (ring->size - 1);                                         /* write position */
+    first = ring->size - pos;                                                        /* length up to the end */
+    if (first > len)                                                                 /* no wrap */
+    {
+        first = len;                                                                 /* set length */
+    }
+    if (len != 0)                                                                    /* check length */
+    {
+        memcpy(&ring->buf[pos], data, first);                                        /* copy the first part */
+        memcpy(ring->buf, &data[first], len - first);                                /* copy the wrapped part */
+    }
+    atomic_store_explicit(&ring->head, head + len, memory_order_release);            /* publish the bytes */
+    atomic_fetch_add_explicit(&ring->written, 1, memory_order_relaxed);              /* written++ */
+
+    return 0;                                                                        /* success return 0 */
+}
+
+/**
+ * @brief      peek the oldest bytes of the ring
+ * @param[in]  *ring points to a tm1637 ring structure
+ * @param[out] **data points to a data pointer buffer
+ * @param[out] *len points to a data length buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 ring is NULL
+ * @note       only one reader may call this function, len is the contiguous part up to the end of the buffer,
+ *             so the bytes can be handed to a dma as they are and a wrapped message takes two peeks
+ */
+uint8_t tm1637_ring_peek(tm1637_ring_t *ring, uint8_t **data, uint32_t *len)
+{
+    uint_least32_t head;
+    uint_least32_t tail;
+    uint32_t used;
+    uint32_t pos;
+
+    if (ring == NULL)                                                            /* check ring */
+    {
+        return 2;                                                                /* return error */
+    }
+
+    tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);              /* only the reader moves tail */
+    head = atomic_load_explicit(&ring->head, memory_order_acquire);              /* the writer is done with the bytes */
+    used = (uint32_t)(head - tail);                                              /* used length */
+    pos = (uint32_t)tail & (ring->size - 1);                                     /* read position */
+    if (used > ring->size - pos)                                                 /* wrapped */
+    {
+        used = ring->size - pos;                                                 /* length up to the end */
+    }
+    *data = &ring->buf[pos];                                                     /* set data */
+    *len = used;                                                                 /* set length */
+
+    return 0;                                                                    /* success return 0 */
+}
+
+/**
+ * @brief     release bytes read from the ring
+ * @param[in] *ring points to a tm1637 ring structure
+ * @param[in] len is the released length
+ * @return    status code
+ *            - 0 success
+ *            - 2 ring is NULL
+ *            - 4 len is over the used length
+ * @note      only the reader may call this function
+ */
+uint8_t tm1637_ring_consume(tm1637_ring_t *ring, uint32_t len)
+{
+    uint_least32_t head;
+    uint_least32_t tail;
+
+    if (ring == NULL)                                                            /* check ring */
+    {
+        return 2;                                                                /* return error */
+    }
+
+    tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);              /* get tail */
+    head = atomic_load_explicit(&ring->head, memory_order_acquire);              /* get head */
+    if (len > (uint32_t)(head - tail))                                           /* check length */
+    {
+        return 4;                                                                /* return error */
+    }
+    atomic_store_explicit(&ring->tail, tail + len, memory_order_release);        /* give the bytes back */
+
+    return 0;                                                                    /* success return 0 */
+}
+
+/**
+ * @brief      get the ring used length
+ * @param[in]  *ring points to a tm1637 ring structure
+ * @param[out] *len points to a used length buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 ring is NULL
+ * @note       none
+ */
+uint8_t tm1637_ring_get_used(tm1637_ring_t *ring, uint32_t *len)
+{
+    uint_least32_t head;
+    uint_least32_t tail;
+
+    if (ring == NULL)                                                      /* check ring */
+    {
+        return 2;                                                          /* return error */
+    }
+
+    tail = atomic_load_explicit(&ring->tail, memory_order_acquire);        /* get tail */
+    head = atomic_load_explicit(&ring->head, memory_order_acquire);        /* get head */
+    *len = (uint32_t)(head - tail);                                        /* set length */
+
+    return 0;                                                              /* success return 0 */
+}
+
+/**
+ * @brief      get the ring statistics
+ * @param[in]  *ring points to a tm1637 ring structure
+ * @param[out] *written points to a written message counter buffer
+ * @param[out] *dropped points to a dropped message counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 ring is NULL
+ * @note       none
+ */
+uint8_t tm1637_ring_get_statistics(tm1637_ring_t *ring, uint32_t *written, uint32_t *dropped)
+{
+    if (ring == NULL)                                                                          /* check ring */
+    {
+        return 2;                                                                              /* return error */
+    }
+
+    *written = (uint32_t)atomic_load_explicit(&ring->written, memory_order_relaxed);           /* get written */
+    *dropped = (uint32_t)atomic_load_explicit(&ring->dropped, memory_order_relaxed);           /* get dropped */
+
+    return 0;                                                                                  /* success return 0 */
+}
@@ -0,0 +1,154 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_ring.h
+ * @brief     driver tm1637 ring header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef DRIVER_TM1637_RING_H
+#define DRIVER_TM1637_RING_H
+
+#include "driver_tm1637.h"
+#if !defined(__STDC_VERSION__) || (__STDC_VERSION__ < 201112L) || defined(__STDC_NO_ATOMICS__)
+    #error "driver_tm1637_ring needs a c11 compiler with <stdatomic.h>"
+#endif
+#include <stdatomic.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup tm1637_ring_driver tm1637 ring driver function
+ * @brief    tm1637 ring driver modules
+ * @note     it uses the c11 atomics, so build it as c11 or later
+ * @ingroup  tm1637_driver
+ * @{
+ */
+
+/**
+ * @brief tm1637 ring structure definition
+ */
+typedef struct tm1637_ring_s
+{
+    uint8_t *buf;                        /**< byte buffer */
+    uint32_t size;                       /**< buffer size */
+    atomic_uint_least32_t head;          /**< write counter */
+    atomic_uint_least32_t tail;          /**< read counter */
+    atomic_uint_least32_t written;       /**< written message counter */
+    atomic_uint_least32_t dropped;       /**< dropped message counter */
+} tm1637_ring_t;
+
+/**
+ * @brief     initialize the ring
+ * @param[in] *ring points to a tm1637 ring structure
+ * @param[in] *buf points to a byte buffer
+ * @param[in] size is the buffer size
+ * @return    status code
+ *            - 0 success
+ *            - 2 ring or buf is NULL
+ *            - 4 size is not a power of two
+ * @note      none
+ */
+uint8_t tm1637_ring_init(tm1637_ring_t *ring, uint8_t *buf, uint32_t size);
+
+/**
+ * @brief     write a message to the ring
+ * @param[in] *ring points to a tm1637 ring structure
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 2 ring is NULL
+ *            - 5 ring is full
+ * @note      only one writer may call this function, it never blocks,
+ *            a message which does not fit is dropped as a whole and counted
+ */
+uint8_t tm1637_ring_write(tm1637_ring_t *ring, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief      peek the oldest bytes of the ring
+ * @param[in]  *ring points to a tm1637 ring structure
+ * @param[out] **data points to a data pointer buffer
+ * @param[out] *len points to a data length buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 ring is NULL
+ * @note       only one reader may call this function, len is the contiguous part up to the end of the buffer,
+ *             so the bytes can be handed to a dma as they are and a wrapped message takes two peeks
+ */
+uint8_t tm1637_ring_peek(tm1637_ring_t *ring, uint8_t **data, uint32_t *len);
+
+/**
+ * @brief     release bytes read from the ring
+ * @param[in] *ring points to a tm1637 ring structure
+ * @param[in] len is the released length
+ * @return    status code
+ *            - 0 success
+ *            - 2 ring is NULL
+ *            - 4 len is over the used length
+ * @note      only the reader may call this function
+ */
+uint8_t tm1637_ring_consume(tm1637_ring_t *ring, uint32_t len);
+
+/**
+ * @brief      get the ring used length
+ * @param[in]  *ring points to a tm1637 ring structure
+ * @param[out] *len points to a used length buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 ring is NULL
+ * @note       none
+ */
+uint8_t tm1637_ring_get_used(tm1637_ring_t *ring, uint32_t *len);
+
+/**
+ * @brief      get the ring statistics
+ * @param[in]  *ring points to a tm1637 ring structure
+ * @param[out] *written points to a written message counter buffer
+ * @param[out] *dropped points to a dropped message counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 ring is NULL
+ * @note       none
+ */
+uint8_t tm1637_ring_get_statistics(tm1637_ring_t *ring, uint32_t *written, uint32_t *dropped);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
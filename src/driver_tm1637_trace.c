@@ -0,0 +1,489 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_trace.c
+ * @brief     driver tm1637 trace source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_tm1637_trace.h"
+
+/**
+ * @brief trace event buffer length definition
+ */
+#define TM1637_TRACE_EVENT_LEN        256        /**< 256 bytes */
+
+/**
+ * @brief trace modelled bus clock definition
+ */
+#define TM1637_TRACE_START_STOP       2          /**< start and stop take one clock each */
+#define TM1637_TRACE_BYTE             9          /**< 8 data clocks and 1 ack clock */
+
+/**
+ * @brief     get the later timestamp
+ * @param[in] a is a timestamp
+ * @param[in] b is a timestamp
+ * @return    the later timestamp
+ * @note      the timestamps may wrap around
+ */
+static uint32_t a_tm1637_trace_later(uint32_t a, uint32_t b)
+{
+    return ((int32_t)(a - b) > 0) ? a : b;        /* compare the distance */
+}
+
+/**
+ * @brief     widen a timestamp to 64 bits
+ * @param[in] *trace points to a tm1637 trace structure
+ * @param[in] us is a 32 bits timestamp
+ * @return    the 64 bits timestamp
+ * @note      the caller holds the trace lock, the timestamp must be within 35 minutes of the latest one,
+ *            the events of an api call come a little out of order and are placed before the latest one
+ */
+static uint64_t a_tm1637_trace_widen(tm1637_trace_t *trace, uint32_t us)
+{
+    int32_t diff;
+
+    if (trace->time_valid == 0)                                              /* first timestamp */
+    {
+        trace->time_us = us;                                                 /* save time */
+        trace->time_valid = 1;                                               /* flag valid */
+
+        return trace->time_us;                                               /* return the time */
+    }
+    diff = (int32_t)(us - (uint32_t)trace->time_us);                         /* distance to the latest */
+    if (diff > 0)                                                            /* later */
+    {
+        trace->time_us += (uint32_t)diff;                                    /* move the latest */
+
+        return trace->time_us;                                               /* return the time */
+    }
+    if ((uint64_t)(-(int64_t)diff) > trace->time_us)                         /* before the first one */
+    {
+        return 0;                                                            /* clamp to 0 */
+    }
+
+    return trace->time_us - (uint64_t)(-(int64_t)diff);                      /* earlier */
+}
+
+/**
+ * @brief     lock the trace
+ * @param[in] *trace points to a tm1637 trace structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock failed
+ * @note      none
+ */
+static uint8_t a_tm1637_trace_lock(tm1637_trace_t *trace)
+{
+    if (trace->lock == NULL)               /* no lock */
+    {
+        return 0;                          /* success return 0 */
+    }
+
+    return trace->lock(trace->ctx);        /* lock */
+}
+
+/**
+ * @brief     unlock the trace
+ * @param[in] *trace points to a tm1637 trace structure
+ * @note      none
+ */
+static void a_tm1637_trace_unlock(tm1637_trace_t *trace)
+{
+    if (trace->unlock != NULL)            /* check unlock */
+    {
+        trace->unlock(trace->ctx);        /* unlock */
+    }
+}
+
+/**
+ * @brief     write one event to the stream
+ * @param[in] *trace points to a tm1637 trace structure
+ * @param[in] *buf points to an event buffer, the event starts at buf[2]
+ * @param[in] len is the snprintf result
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the caller holds the trace lock, buf[0] and buf[1] take the separator of the json array
+ */
+static uint8_t a_tm1637_trace_write(tm1637_trace_t *trace, char *buf, int len)
+{
+    uint8_t res;
+
+    if ((len < 0) || (len >= (TM1637_TRACE_EVENT_LEN - 2)))              /* check the length */
+    {
+        trace->dropped++;                                                /* dropped++ */
+
+        return 1;                                                        /* return error */
+    }
+    if (trace->started != 0)                                             /* not the first event */
+    {
+        buf[0] = ',';                                                    /* separator */
+        buf[1] = '\n';                                                   /* one event a line */
+        res = trace->write(trace->ctx, buf, (uint16_t)(len + 2));        /* write the event */
+    }
+    else
+    {
+        res = trace->write(trace->ctx, &buf[2], (uint16_t)len);          /* write the event */
+    }
+    if (res != 0)                                                        /* check the result */
+    {
+        trace->dropped++;                                                /* dropped++ */
+
+        return 1;                                                        /* return error */
+    }
+    trace->started = 1;                                                  /* flag started */
+    trace->events++;                                                     /* events++ */
+
+    return 0;                                                            /* success return 0 */
+}
+
+/**
+ * @brief     write the track names
+ * @param[in] *trace points to a tm1637 trace structure
+ * @param[in] tid is the track id
+ * @param[in] *kind points to the track kind
+ * @param[in] index is the bus or display index
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the caller holds the trace lock
+ */
+static uint8_t a_tm1637_trace_name(tm1637_trace_t *trace, uint32_t tid, const char *kind, uint8_t index)
+{
+    char buf[TM1637_TRACE_EVENT_LEN];
+    int len;
+
+    len = snprintf(&buf[2], TM1637_TRACE_EVENT_LEN - 2,
+                   "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%lu,\"args\":{\"name\":\"%s %u\"}}",
+                   (unsigned long)tid, kind, (unsigned int)index);        /* track name */
+    if (a_tm1637_trace_write(trace, buf, len) != 0)                       /* write the name */
+    {
+        return 1;                                                         /* return error */
+    }
+    len = snprintf(&buf[2], TM1637_TRACE_EVENT_LEN - 2,
+                   "{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":%lu,\"args\":{\"sort_index\":%lu}}",
+                   (unsigned long)tid, (unsigned long)tid);               /* track order */
+    if (a_tm1637_trace_write(trace, buf, len) != 0)                       /* write the order */
+    {
+        return 1;                                                         /* return error */
+    }
+
+    return 0;                                                             /* success return 0 */
+}
+
+/**
+ * @brief     trace callback
+ * @param[in] *ctx points to a tm1637 trace track structure
+ * @param[in] *event points to a tm1637 trace event structure
+ * @note      it runs with the handle lock held
+ */
+static void a_tm1637_trace_callback(void *ctx, const tm1637_trace_event_t *event)
+{
+    tm1637_trace_track_t *track = (tm1637_trace_track_t *)ctx;
+    tm1637_trace_t *trace = track->trace;
+    char buf[TM1637_TRACE_EVENT_LEN];
+    uint32_t start_us;
+    uint32_t end_us;
+    uint64_t ts;
+    int len;
+
+    if (a_tm1637_trace_lock(trace) != 0)                                                     /* lock */
+    {
+        return;                                                                              /* return */
+    }
+    start_us = event->start_us;                                                              /* timestamp start */
+    end_us = event->end_us;                                                                  /* timestamp end */
+    if ((trace->bit_us != 0) && (event->type != TM1637_TRACE_TYPE_API))                      /* modelled transaction */
+    {
+        if ((trace->bus_valid & (1UL << track->bus)) != 0)                                   /* bus used before */
+        {
+            start_us = a_tm1637_trace_later(start_us, trace->bus_end_us[track->bus]);        /* wait for the bus */
+        }
+        end_us = start_us + (TM1637_TRACE_START_STOP + TM1637_TRACE_BYTE * (1 + (uint32_t)event->len)) *
+                 trace->bit_us;                                                              /* bus time */
+        trace->bus_end_us[track->bus] = end_us;                                              /* save bus end */
+        trace->bus_valid |= 1UL << track->bus;                                               /* flag valid */
+        track->bus_end_us = end_us;                                                          /* save track bus end */
+        track->valid |= 1 << 1;                                                              /* flag valid */
+    }
+    else if (trace->bit_us != 0)                                                             /* modelled api call */
+    {
+        if ((track->valid & (1 << 0)) != 0)                                                  /* api called before */
+        {
+            start_us = a_tm1637_trace_later(start_us, track->api_end_us);                    /* after the last call */
+        }
+        if ((track->valid & (1 << 1)) != 0)                                                  /* bus used before */
+        {
+            end_us = a_tm1637_trace_later(end_us, track->bus_end_us);                        /* cover the transactions */
+        }
+        end_us = a_tm1637_trace_later(end_us, start_us);                                     /* never negative */
+        track->api_end_us = end_us;                                                          /* save api end */
+        track->valid |= 1 << 0;                                                              /* flag valid */
+    }
+    else
+    {
+        /* use the timestamps */
+    }
+    ts = a_tm1637_trace_widen(trace, start_us);                                              /* 64 bits start */
+
+    if (event->type != TM1637_TRACE_TYPE_API)                                                /* transaction */
+    {
+        len = snprintf(&buf[2], TM1637_TRACE_EVENT_LEN - 2,
+                       "{\"name\":\"%s 0x%02X\",\"cat\":\"bus\",\"ph\":\"X\",\"pid\":1,\"tid\":%lu,\"ts\":%llu,\"dur\":%lu,"
+                       "\"args\":{\"api\":\"%s\",\"display\":%u,\"cmd\":\"0x%02X\",\"len\":%u,\"res\":%u}}",
+                       (event->type == TM1637_TRACE_TYPE_WRITE) ? "write" : "read", (unsigned int)event->cmd,
+                       (unsigned long)track->bus + 1, (unsigned long long)ts, (unsigned long)(end_us - start_us),
+                       event->name, (unsigned int)track->display, (unsigned int)event->cmd,
+                       (unsigned int)event->len, (unsigned int)event->res);                  /* bus track */
+    }
+    else
+    {
+        len = snprintf(&buf[2], TM1637_TRACE_EVENT_LEN - 2,
+                       "{\"name\":\"%s\",\"cat\":\"api\",\"ph\":\"X\",\"pid\":1,\"tid\":%lu,\"ts\":%llu,\"dur\":%lu,"
+                       "\"args\":{\"display\":%u,\"wait_us\":%lu}}",
+                       event->name, (unsigned long)TM1637_TRACE_MAX_BUS + 1 + track->display,
+                       (unsigned long long)ts, (unsigned long)(end_us - start_us),
+                       (unsigned int)track->display, (unsigned long)event->wait_us);         /* display track */
+    }
+    (void)a_tm1637_trace_write(trace, buf, len);                                             /* write the event */
+    a_tm1637_trace_unlock(trace);                                                            /* unlock */
+}
+
+/**
+ * @brief     initialize the trace
+ * @param[in] *trace points to a tm1637 trace structure
+ * @param[in] *write points to a stream write function, it returns 0 on success
+ * @param[in] *ctx is the stream context
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ *            - 2 trace or write is NULL
+ * @note      the trace is a chrome trace event json array, every event is written to the stream at once and nothing is kept,
+ *            chrome and perfetto also load a stream cut before tm1637_trace_deinit, the 32 bits timestamps are
+ *            widened to 64 bits, so a capture may run longer than the 71 minutes of one wrap
+ */
+uint8_t tm1637_trace_init(tm1637_trace_t *trace, uint8_t (*write)(void *ctx, const char *buf, uint16_t len), void *ctx)
+{
+    char buf[TM1637_TRACE_EVENT_LEN];
+    int len;
+
+    if ((trace == NULL) || (write == NULL))                                                                     /* check trace */
+    {
+        return 2;                                                                                               /* return error */
+    }
+
+    memset(trace, 0, sizeof(tm1637_trace_t));                                                                   /* clear the trace */
+    trace->write = write;                                                                                       /* save write */
+    trace->ctx = ctx;                                                                                           /* save context */
+    if (trace->write(trace->ctx, "[\n", 2) != 0)                                                                /* open the array */
+    {
+        return 1;                                                                                               /* return error */
+    }
+    len = snprintf(&buf[2], TM1637_TRACE_EVENT_LEN - 2,
+                   "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"tm1637\"}}");        /* process name */
+    if (a_tm1637_trace_write(trace, buf, len) != 0)                                                             /* write the name */
+    {
+        return 1;                                                                                               /* return error */
+    }
+
+    return 0;                                                                                                   /* success return 0 */
+}
+
+/**
+ * @brief     close the trace
+ * @param[in] *trace points to a tm1637 trace structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ *            - 2 trace is NULL
+ * @note      stop the trace of every attached handle before closing it
+ */
+uint8_t tm1637_trace_deinit(tm1637_trace_t *trace)
+{
+    uint8_t res;
+
+    if (trace == NULL)                                 /* check trace */
+    {
+        return 2;                                      /* return error */
+    }
+
+    if (a_tm1637_trace_lock(trace) != 0)               /* lock */
+    {
+        return 1;                                      /* return error */
+    }
+    res = trace->write(trace->ctx, "\n]\n", 3);        /* close the array */
+    a_tm1637_trace_unlock(trace);                      /* unlock */
+    if (res != 0)                                      /* check the result */
+    {
+        return 1;                                      /* return error */
+    }
+
+    return 0;                                          /* success return 0 */
+}
+
+/**
+ * @brief     set the trace lock
+ * @param[in] *trace points to a tm1637 trace structure
+ * @param[in] *lock points to a lock function, it gets the stream context
+ * @param[in] *unlock points to an unlock function, it gets the stream context
+ * @return    status code
+ *            - 0 success
+ *            - 2 trace is NULL
+ *            - 4 lock or unlock is NULL
+ * @note      it is needed when handles with different locks are traced by different tasks,
+ *            NULL lock and unlock remove it
+ */
+uint8_t tm1637_trace_set_lock(tm1637_trace_t *trace, uint8_t (*lock)(void *ctx), void (*unlock)(void *ctx))
+{
+    if (trace == NULL)                             /* check trace */
+    {
+        return 2;                                  /* return error */
+    }
+    if ((lock == NULL) != (unlock == NULL))        /* check lock and unlock */
+    {
+        return 4;                                  /* return error */
+    }
+
+    trace->lock = lock;                            /* save lock */
+    trace->unlock = unlock;                        /* save unlock */
+
+    return 0;                                      /* success return 0 */
+}
+
+/**
+ * @brief     set the modelled bus time
+ * @param[in] *trace points to a tm1637 trace structure
+ * @param[in] bit_us is the bus clock period, 0 uses the timestamps
+ * @return    status code
+ *            - 0 success
+ *            - 2 trace is NULL
+ * @note      a modelled transaction lasts start, stop and 9 clocks a byte,
+ *            it starts at its timestamp or when the last transaction on the same bus ends,
+ *            so a host run without the real bus timing still shows the bus time and the gaps
+ */
+uint8_t tm1637_trace_set_bus_model(tm1637_trace_t *trace, uint32_t bit_us)
+{
+    if (trace == NULL)             /* check trace */
+    {
+        return 2;                  /* return error */
+    }
+
+    trace->bit_us = bit_us;        /* save bit time */
+    trace->bus_valid = 0;          /* restart the model */
+
+    return 0;                      /* success return 0 */
+}
+
+/**
+ * @brief     trace a handle
+ * @param[in] *trace points to a tm1637 trace structure
+ * @param[in] *track points to a tm1637 trace track structure
+ * @param[in] *handle points to an initialized tm1637 handle structure
+ * @param[in] bus is the bus index
+ * @param[in] display is the display index
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ *            - 2 trace, track or handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 timestamp_us is NULL
+ *            - 5 bus is over TM1637_TRACE_MAX_BUS
+ * @note      the transactions go to the track of the bus and the api calls go to the track of the display,
+ *            handles on the same bus share the bus track, tm1637_set_trace(handle, NULL, NULL, NULL) stops it
+ */
+uint8_t tm1637_trace_attach(tm1637_trace_t *trace, tm1637_trace_track_t *track, tm1637_handle_t *handle,
+                            uint8_t bus, uint8_t display)
+{
+    uint8_t res;
+
+    if ((trace == NULL) || (track == NULL) || (handle == NULL))             /* check trace */
+    {
+        return 2;                                                           /* return error */
+    }
+    if (bus >= TM1637_TRACE_MAX_BUS)                                        /* check bus */
+    {
+        return 5;                                                           /* return error */
+    }
+
+    if (a_tm1637_trace_lock(trace) != 0)                                    /* lock */
+    {
+        return 1;                                                           /* return error */
+    }
+    res = a_tm1637_trace_name(trace, (uint32_t)bus + 1, "bus", bus);        /* bus track */
+    if (res == 0)                                                           /* check the result */
+    {
+        res = a_tm1637_trace_name(trace, TM1637_TRACE_MAX_BUS + 1 + (uint32_t)display,
+                                  "display", display);                      /* display track */
+    }
+    a_tm1637_trace_unlock(trace);                                           /* unlock */
+    if (res != 0)                                                           /* check the result */
+    {
+        return 1;                                                           /* return error */
+    }
+
+    memset(track, 0, sizeof(tm1637_trace_track_t));                         /* clear the track */
+    track->trace = trace;                                                   /* save trace */
+    track->bus = bus;                                                       /* save bus */
+    track->display = display;                                               /* save display */
+
+    return tm1637_set_trace(handle, &track->state,
+                            a_tm1637_trace_callback, track);                /* set the callback */
+}
+
+/**
+ * @brief      get the trace statistics
+ * @param[in]  *trace points to a tm1637 trace structure
+ * @param[out] *events points to a written event counter buffer
+ * @param[out] *dropped points to a dropped event counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 lock failed
+ *             - 2 trace is NULL
+ * @note       an event is dropped when the stream write fails
+ */
+uint8_t tm1637_trace_get_statistics(tm1637_trace_t *trace, uint32_t *events, uint32_t *dropped)
+{
+    if (trace == NULL)                          /* check trace */
+    {
+        return 2;                               /* return error */
+    }
+
+    if (a_tm1637_trace_lock(trace) != 0)        /* lock */
+    {
+        return 1;                               /* return error */
+    }
+    *events = trace->events;                    /* get events */
+    *dropped = trace->dropped;                  /* get dropped */
+    a_tm1637_trace_unlock(trace);               /* unlock */
+
+    return 0;                                   /* success return 0 */
+}
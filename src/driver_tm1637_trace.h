@@ -0,0 +1,187 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_trace.h
+ * @brief     driver tm1637 trace header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef DRIVER_TM1637_TRACE_H
+#define DRIVER_TM1637_TRACE_H
+
+#include "driver_tm1637.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup tm1637_trace_driver tm1637 trace driver function
+ * @brief    tm1637 trace driver modules
+ * @ingroup  tm1637_driver
+ * @{
+ */
+
+/**
+ * @brief tm1637 trace max bus definition
+ */
+#ifndef TM1637_TRACE_MAX_BUS
+    #define TM1637_TRACE_MAX_BUS        32        /**< 32 buses */
+#endif
+
+/**
+ * @brief tm1637 trace structure definition
+ */
+typedef struct tm1637_trace_s
+{
+    uint8_t (*write)(void *ctx, const char *buf, uint16_t len);        /**< point to a stream write function address */
+    uint8_t (*lock)(void *ctx);                                        /**< point to a lock function address */
+    void (*unlock)(void *ctx);                                         /**< point to an unlock function address */
+    void *ctx;                                                         /**< stream context */
+    uint32_t bit_us;                                                   /**< modelled bus bit time, 0 means the timestamps */
+    uint32_t bus_end_us[TM1637_TRACE_MAX_BUS];                         /**< modelled end of the last transaction of each bus */
+    uint32_t bus_valid;                                                /**< modelled end valid mask */
+    uint64_t time_us;                                                  /**< latest timestamp widened to 64 bits */
+    uint8_t time_valid;                                                /**< latest timestamp valid flag */
+    uint32_t events;                                                   /**< written event counter */
+    uint32_t dropped;                                                  /**< dropped event counter */
+    uint8_t started;                                                   /**< first event written flag */
+} tm1637_trace_t;
+
+/**
+ * @brief tm1637 trace track structure definition
+ */
+typedef struct tm1637_trace_track_s
+{
+    tm1637_trace_t *trace;          /**< trace */
+    tm1637_trace_state_t state;     /**< trace state of the handle */
+    uint32_t api_end_us;            /**< modelled end of the last api call */
+    uint32_t bus_end_us;            /**< modelled end of the last transaction */
+    uint8_t valid;                  /**< modelled end valid flag */
+    uint8_t bus;                    /**< bus index */
+    uint8_t display;                /**< display index */
+} tm1637_trace_track_t;
+
+/**
+ * @brief     initialize the trace
+ * @param[in] *trace points to a tm1637 trace structure
+ * @param[in] *write points to a stream write function, it returns 0 on success
+ * @param[in] *ctx is the stream context
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ *            - 2 trace or write is NULL
+ * @note      the trace is a chrome trace event json array, every event is written to the stream at once and nothing is kept,
+ *            chrome and perfetto also load a stream cut before tm1637_trace_deinit, the 32 bits timestamps are
+ *            widened to 64 bits, so a capture may run longer than the 71 minutes of one wrap
+ */
+uint8_t tm1637_trace_init(tm1637_trace_t *trace, uint8_t (*write)(void *ctx, const char *buf, uint16_t len), void *ctx);
+
+/**
+ * @brief     close the trace
+ * @param[in] *trace points to a tm1637 trace structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ *            - 2 trace is NULL
+ * @note      stop the trace of every attached handle before closing it
+ */
+uint8_t tm1637_trace_deinit(tm1637_trace_t *trace);
+
+/**
+ * @brief     set the trace lock
+ * @param[in] *trace points to a tm1637 trace structure
+ * @param[in] *lock points to a lock function, it gets the stream context
+ * @param[in] *unlock points to an unlock function, it gets the stream context
+ * @return    status code
+ *            - 0 success
+ *            - 2 trace is NULL
+ *            - 4 lock or unlock is NULL
+ * @note      it is needed when handles with different locks are traced by different tasks,
+ *            NULL lock and unlock remove it
+ */
+uint8_t tm1637_trace_set_lock(tm1637_trace_t *trace, uint8_t (*lock)(void *ctx), void (*unlock)(void *ctx));
+
+/**
+ * @brief     set the modelled bus time
+ * @param[in] *trace points to a tm1637 trace structure
+ * @param[in] bit_us is the bus clock period, 0 uses the timestamps
+ * @return    status code
+ *            - 0 success
+ *            - 2 trace is NULL
+ * @note      a modelled transaction lasts start, stop and 9 clocks a byte,
+ *            it starts at its timestamp or when the last transaction on the same bus ends,
+ *            so a host run without the real bus timing still shows the bus time and the gaps
+ */
+uint8_t tm1637_trace_set_bus_model(tm1637_trace_t *trace, uint32_t bit_us);
+
+/**
+ * @brief     trace a handle
+ * @param[in] *trace points to a tm1637 trace structure
+ * @param[in] *track points to a tm1637 trace track structure
+ * @param[in] *handle points to an initialized tm1637 handle structure
+ * @param[in] bus is the bus index
+ * @param[in] display is the display index
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ *            - 2 trace, track or handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 timestamp_us is NULL
+ *            - 5 bus is over TM1637_TRACE_MAX_BUS
+ * @note      the transactions go to the track of the bus and the api calls go to the track of the display,
+ *            handles on the same bus share the bus track, tm1637_set_trace(handle, NULL, NULL, NULL) stops it
+ */
+uint8_t tm1637_trace_attach(tm1637_trace_t *trace, tm1637_trace_track_t *track, tm1637_handle_t *handle,
+                            uint8_t bus, uint8_t display);
+
+/**
+ * @brief      get the trace statistics
+ * @param[in]  *trace points to a tm1637 trace structure
+ * @param[out] *events points to a written event counter buffer
+ * @param[out] *dropped points to a dropped event counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 lock failed
+ *             - 2 trace is NULL
+ * @note       an event is dropped when the stream write fails
+ */
+uint8_t tm1637_trace_get_statistics(tm1637_trace_t *trace, uint32_t *events, uint32_t *dropped);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,416 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_vdisplay.c
+ * @brief     driver tm1637 virtual display source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+
+#include "driver_tm1637_vdisplay.h"
+
+/**
+ * @brief segment definition
+ */
+#define SEGMENT_DP        0x80        /**< decimal point */
+#define SEGMENT_MINUS     0x40        /**< minus sign */
+
+/**
+ * @brief seven segment font from ' ' to '_', lower case letters use the upper case glyphs
+ */
+static const uint8_t gsc_tm1637_vdisplay_font[64] =
+{
+    0x00, 0x86, 0x22, 0x00, 0x6D, 0x00, 0x00, 0x02,        /* ' ' ! " # $ % & ' */
+    0x39, 0x0F, 0x00, 0x00, 0x04, 0x40, 0x80, 0x52,        /* ( ) * + , - . / */
+    0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07,        /* 0 1 2 3 4 5 6 7 */
+    0x7F, 0x6F, 0x00, 0x00, 0x00, 0x48, 0x00, 0x53,        /* 8 9 : ; < = > ? */
+    0x00, 0x77, 0x7C, 0x39, 0x5E, 0x79, 0x71, 0x3D,        /* @ A B C D E F G */
+    0x76, 0x30, 0x1E, 0x75, 0x38, 0x37, 0x54, 0x3F,        /* H I J K L M N O */
+    0x73, 0x67, 0x50, 0x6D, 0x78, 0x3E, 0x3E, 0x2A,        /* P Q R S T U V W */
+    0x76, 0x6E, 0x5B, 0x39, 0x64, 0x0F, 0x23, 0x08,        /* X Y Z [ \ ] ^ _ */
+};
+
+/**
+ * @brief     get the glyph of a character
+ * @param[in] c is the character
+ * @return    segments
+ * @note      none
+ */
+static uint8_t a_tm1637_vdisplay_glyph(char c)
+{
+    if ((c >= 'a') && (c <= 'z'))                               /* lower case */
+    {
+        c = (char)(c - 'a' + 'A');                              /* to upper case */
+    }
+    if ((c < ' ') || (c > '_'))                                 /* no glyph */
+    {
+        return 0x00;                                            /* blank */
+    }
+
+    return gsc_tm1637_vdisplay_font[c - ' '];                   /* return glyph */
+}
+
+/**
+ * @brief     flush one module
+ * @param[in] *vdisplay points to a tm1637 virtual display structure
+ * @param[in] *module points to a tm1637 virtual display module structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 flush failed
+ * @note      none
+ */
+static uint8_t a_tm1637_vdisplay_flush_module(tm1637_vdisplay_t *vdisplay, tm1637_vdisplay_module_t *module)
+{
+    uint8_t buf[6];
+    uint8_t mask;
+    uint8_t addr;
+    uint8_t i;
+
+    mask = 0;                                                                                     /* init 0 */
+    for (i = 0; i < module->digits; i++)                                                          /* loop the slice */
+    {
+        addr = module->map[i];                                                                    /* get chip address */
+        buf[addr] = vdisplay->frame[module->offset + i];                                          /* copy the digit */
+        if (((module->sent_mask & (1 << addr)) == 0) || (module->sent[addr] != buf[addr]))        /* changed */
+        {
+            mask |= (uint8_t)(1 << addr);                                                         /* set mask */
+        }
+    }
+    if (mask == 0)                                                                                /* slice unchanged */
+    {
+        return 0;                                                                                 /* success return 0 */
+    }
+    if (tm1637_write_segment_mask(module->handle, buf, mask) != 0)                                /* write the digits */
+    {
+        module->sent_mask &= (uint8_t)(~mask);                                                    /* chip content is unknown */
+
+        return 1;                                                                                 /* return error */
+    }
+    for (i = 0; i < 6; i++)                                                                       /* loop all addresses */
+    {
+        if ((mask & (1 << i)) != 0)                                                               /* sent */
+        {
+            module->sent[i] = buf[i];                                                             /* save */
+        }
+    }
+    module->sent_mask |= mask;                                                                    /* known digits */
+
+    return 0;                                                                                     /* success return 0 */
+}
+
+/**
+ * @brief     initialize the virtual display
+ * @param[in] *vdisplay points to a tm1637 virtual display structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 vdisplay is NULL
+ * @note      none
+ */
+uint8_t tm1637_vdisplay_init(tm1637_vdisplay_t *vdisplay)
+{
+    if (vdisplay == NULL)                                      /* check vdisplay */
+    {
+        return 2;                                              /* return error */
+    }
+
+    memset(vdisplay, 0, sizeof(tm1637_vdisplay_t));           /* clear the virtual display */
+
+    return 0;                                                  /* success return 0 */
+}
+
+/**
+ * @brief     append a module to the right end of the virtual display
+ * @param[in] *vdisplay points to a tm1637 virtual display structure
+ * @param[in] *handle points to an initialized tm1637 handle structure
+ * @param[in] digits is the digit number of the module
+ * @param[in] *map points to the chip address of each digit from left to right, NULL means 0, 1, 2 ...
+ * @param[in] bus is the bus id, modules with different ids may be flushed concurrently
+ * @return    status code
+ *            - 0 success
+ *            - 2 vdisplay or handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 digits or map is invalid
+ *            - 5 virtual display is full
+ * @note      bus TM1637_VDISPLAY_BUS_ALL is reserved
+ */
+uint8_t tm1637_vdisplay_add_module(tm1637_vdisplay_t *vdisplay, tm1637_handle_t *handle, uint8_t digits, const uint8_t *map, uint8_t bus)
+{
+    tm1637_vdisplay_module_t *module;
+    uint8_t used;
+    uint8_t i;
+
+    if ((vdisplay == NULL) || (handle == NULL))                                          /* check vdisplay */
+    {
+        return 2;                                                                        /* return error */
+    }
+    if (handle->inited != 1)                                                             /* check handle initialization */
+    {
+        return 3;                                                                        /* return error */
+    }
+    if ((digits == 0) || (digits > 6) || (bus == TM1637_VDISPLAY_BUS_ALL))               /* check digits */
+    {
+        return 4;                                                                        /* return error */
+    }
+    if ((vdisplay->module_num >= TM1637_VDISPLAY_MAX_MODULE) ||
+        ((vdisplay->digits + digits) > TM1637_VDISPLAY_MAX_DIGIT))                       /* check room */
+    {
+        return 5;                                                                        /* return error */
+    }
+
+    module = &vdisplay->module[vdisplay->module_num];                                    /* get module */
+    used = 0;                                                                            /* init 0 */
+    for (i = 0; i < digits; i++)                                                         /* loop all digits */
+    {
+        module->map[i] = (map != NULL) ? map[i] : i;                                     /* set address */
+        if ((module->map[i] > 5) || ((used & (1 << module->map[i])) != 0))               /* check address */
+        {
+            return 4;                                                                    /* return error */
+        }
+        used |= (uint8_t)(1 << module->map[i]);                                          /* mark used */
+    }
+    module->handle = handle;                                                             /* set handle */
+    module->offset = vdisplay->digits;                                                   /* set offset */
+    module->digits = digits;                                                             /* set digits */
+    module->bus = bus;                                                                   /* set bus */
+    module->sent_mask = 0;                                                               /* nothing is known */
+    vdisplay->digits += digits;                                                          /* grow */
+    vdisplay->module_num++;                                                              /* module_num++ */
+
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief      get the logical digit number
+ * @param[in]  *vdisplay points to a tm1637 virtual display structure
+ * @param[out] *digits points to a digit number buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 vdisplay is NULL
+ * @note       none
+ */
+uint8_t tm1637_vdisplay_get_digits(tm1637_vdisplay_t *vdisplay, uint8_t *digits)
+{
+    if (vdisplay == NULL)                   /* check vdisplay */
+    {
+        return 2;                           /* return error */
+    }
+
+    *digits = vdisplay->digits;             /* get digits */
+
+    return 0;                               /* success return 0 */
+}
+
+/**
+ * @brief     clear the framebuffer
+ * @param[in] *vdisplay points to a tm1637 virtual display structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 vdisplay is NULL
+ * @note      the modules are updated by the next flush
+ */
+uint8_t tm1637_vdisplay_clear(tm1637_vdisplay_t *vdisplay)
+{
+    if (vdisplay == NULL)                                          /* check vdisplay */
+    {
+        return 2;                                                  /* return error */
+    }
+
+    memset(vdisplay->frame, 0, sizeof(vdisplay->frame));           /* clear the frame */
+
+    return 0;                                                      /* success return 0 */
+}
+
+/**
+ * @brief     write raw segments to the framebuffer
+ * @param[in] *vdisplay points to a tm1637 virtual display structure
+ * @param[in] pos is the first logical digit
+ * @param[in] *data points to a segment buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 2 vdisplay is NULL
+ *            - 4 pos + len is over the display
+ * @note      the modules are updated by the next flush
+ */
+uint8_t tm1637_vdisplay_write(tm1637_vdisplay_t *vdisplay, uint8_t pos, uint8_t *data, uint8_t len)
+{
+    if (vdisplay == NULL)                                  /* check vdisplay */
+    {
+        return 2;                                          /* return error */
+    }
+    if ((pos + len) > vdisplay->digits)                    /* check range */
+    {
+        return 4;                                          /* return error */
+    }
+
+    memcpy(&vdisplay->frame[pos], data, len);              /* copy data */
+
+    return 0;                                              /* success return 0 */
+}
+
+/**
+ * @brief     print a text to the framebuffer
+ * @param[in] *vdisplay points to a tm1637 virtual display structure
+ * @param[in] pos is the first logical digit
+ * @param[in] *text points to a text string
+ * @return    status code
+ *            - 0 success
+ *            - 2 vdisplay or text is NULL
+ *            - 4 pos is over the display
+ * @note      a '.' is merged into the previous digit, characters over the right end are cut,
+ *            characters without a seven segment glyph are blank
+ */
+uint8_t tm1637_vdisplay_print_text(tm1637_vdisplay_t *vdisplay, uint8_t pos, const char *text)
+{
+    uint8_t start;
+
+    if ((vdisplay == NULL) || (text == NULL))                                         /* check vdisplay */
+    {
+        return 2;                                                                     /* return error */
+    }
+    if (pos >= vdisplay->digits)                                                      /* check range */
+    {
+        return 4;                                                                     /* return error */
+    }
+
+    start = pos;                                                                      /* save start */
+    while ((*text != '\0') && (pos < vdisplay->digits))                               /* loop all characters */
+    {
+        if ((*text == '.') && (pos > start) &&
+            ((vdisplay->frame[pos - 1] & SEGMENT_DP) == 0))                           /* decimal point */
+        {
+            vdisplay->frame[pos - 1] |= SEGMENT_DP;                                   /* merge into the previous */
+        }
+        else
+        {
+            vdisplay->frame[pos] = a_tm1637_vdisplay_glyph(*text);                    /* set glyph */
+            pos++;                                                                    /* next digit */
+        }
+        text++;                                                                       /* next character */
+    }
+
+    return 0;                                                                         /* success return 0 */
+}
+
+/**
+ * @brief     print a number to the framebuffer
+ * @param[in] *vdisplay points to a tm1637 virtual display structure
+ * @param[in] pos is the first logical digit of the field
+ * @param[in] width is the field width
+ * @param[in] number is the printed number
+ * @return    status code
+ *            - 0 success
+ *            - 2 vdisplay is NULL
+ *            - 4 field is over the display
+ *            - 5 number does not fit the field
+ * @note      the number is right aligned with blank padding, a number that does not fit fills the field with '-'
+ */
+uint8_t tm1637_vdisplay_print_number(tm1637_vdisplay_t *vdisplay, uint8_t pos, uint8_t width, int32_t number)
+{
+    uint32_t value;
+    uint8_t i;
+
+    if (vdisplay == NULL)                                                                     /* check vdisplay */
+    {
+        return 2;                                                                             /* return error */
+    }
+    if ((width == 0) || ((pos + width) > vdisplay->digits))                                   /* check range */
+    {
+        return 4;                                                                             /* return error */
+    }
+
+    value = (number < 0) ? (0U - (uint32_t)number) : (uint32_t)number;                        /* get absolute value */
+    i = width;                                                                                /* from the right end */
+    do
+    {
+        if (i == 0)                                                                           /* no room */
+        {
+            memset(&vdisplay->frame[pos], SEGMENT_MINUS, width);                              /* fill with '-' */
+
+            return 5;                                                                         /* return error */
+        }
+        i--;                                                                                  /* next digit */
+        vdisplay->frame[pos + i] = gsc_tm1637_vdisplay_font['0' - ' ' + (value % 10)];        /* set digit */
+        value /= 10;                                                                          /* next decade */
+    } while (value != 0);
+    if (number < 0)                                                                           /* negative */
+    {
+        if (i == 0)                                                                           /* no room */
+        {
+            memset(&vdisplay->frame[pos], SEGMENT_MINUS, width);                              /* fill with '-' */
+
+            return 5;                                                                         /* return error */
+        }
+        i--;                                                                                  /* next digit */
+        vdisplay->frame[pos + i] = SEGMENT_MINUS;                                             /* set sign */
+    }
+    memset(&vdisplay->frame[pos], 0x00, i);                                                   /* blank padding */
+
+    return 0;                                                                                 /* success return 0 */
+}
+
+/**
+ * @brief     flush the changed modules
+ * @param[in] *vdisplay points to a tm1637 virtual display structure
+ * @param[in] bus is the bus id, TM1637_VDISPLAY_BUS_ALL flushes all modules
+ * @return    status code
+ *            - 0 success
+ *            - 1 flush failed
+ *            - 2 vdisplay is NULL
+ * @note      only the changed digits of each module are sent, modules on different buses may be flushed
+ *            from one task per bus at the same time as they share no state, the framebuffer must not be
+ *            written while flushing
+ */
+uint8_t tm1637_vdisplay_flush(tm1637_vdisplay_t *vdisplay, uint8_t bus)
+{
+    uint8_t res;
+    uint8_t i;
+
+    if (vdisplay == NULL)                                                                  /* check vdisplay */
+    {
+        return 2;                                                                          /* return error */
+    }
+
+    res = 0;                                                                               /* init 0 */
+    for (i = 0; i < vdisplay->module_num; i++)                                             /* loop all modules */
+    {
+        if ((bus != TM1637_VDISPLAY_BUS_ALL) && (vdisplay->module[i].bus != bus))          /* other bus */
+        {
+            continue;                                                                      /* skip */
+        }
+        if (a_tm1637_vdisplay_flush_module(vdisplay, &vdisplay->module[i]) != 0)           /* flush the module */
+        {
+            res = 1;                                                                       /* keep the others going */
+        }
+    }
+
+    return res;                                                                            /* return the result */
+}
@@ -0,0 +1,207 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_vdisplay.h
+ * @brief     driver tm1637 virtual display header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+
+#ifndef DRIVER_TM1637_VDISPLAY_H
+#define DRIVER_TM1637_VDISPLAY_H
+
+#include "driver_tm1637.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup tm1637_vdisplay_driver tm1637 virtual display driver function
+ * @brief    tm1637 virtual display driver modules
+ * @ingroup  tm1637_driver
+ * @{
+ */
+
+/**
+ * @brief tm1637 virtual display size definition
+ */
+#ifndef TM1637_VDISPLAY_MAX_MODULE
+    #define TM1637_VDISPLAY_MAX_MODULE        8         /**< 8 modules */
+#endif
+#ifndef TM1637_VDISPLAY_MAX_DIGIT
+    #define TM1637_VDISPLAY_MAX_DIGIT         48        /**< 48 digits */
+#endif
+
+/**
+ * @brief tm1637 virtual display bus definition
+ */
+#define TM1637_VDISPLAY_BUS_ALL        0xFF        /**< all buses */
+
+/**
+ * @brief tm1637 virtual display module structure definition
+ */
+typedef struct tm1637_vdisplay_module_s
+{
+    tm1637_handle_t *handle;        /**< tm1637 handle */
+    uint8_t offset;                 /**< first logical digit */
+    uint8_t digits;                 /**< digit number */
+    uint8_t map[6];                 /**< chip address of each digit from left to right */
+    uint8_t bus;                    /**< bus id */
+    uint8_t sent[6];                /**< digits sent to the chip */
+    uint8_t sent_mask;              /**< known sent digit mask */
+} tm1637_vdisplay_module_t;
+
+/**
+ * @brief tm1637 virtual display structure definition
+ */
+typedef struct tm1637_vdisplay_s
+{
+    tm1637_vdisplay_module_t module[TM1637_VDISPLAY_MAX_MODULE];        /**< modules from left to right */
+    uint8_t frame[TM1637_VDISPLAY_MAX_DIGIT];                           /**< logical framebuffer */
+    uint8_t module_num;                                                 /**< module number */
+    uint8_t digits;                                                     /**< logical digit number */
+} tm1637_vdisplay_t;
+
+/**
+ * @brief     initialize the virtual display
+ * @param[in] *vdisplay points to a tm1637 virtual display structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 vdisplay is NULL
+ * @note      none
+ */
+uint8_t tm1637_vdisplay_init(tm1637_vdisplay_t *vdisplay);
+
+/**
+ * @brief     append a module to the right end of the virtual display
+ * @param[in] *vdisplay points to a tm1637 virtual display structure
+ * @param[in] *handle points to an initialized tm1637 handle structure
+ * @param[in] digits is the digit number of the module
+ * @param[in] *map points to the chip address of each digit from left to right, NULL means 0, 1, 2 ...
+ * @param[in] bus is the bus id, modules with different ids may be flushed concurrently
+ * @return    status code
+ *            - 0 success
+ *            - 2 vdisplay or handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 digits or map is invalid
+ *            - 5 virtual display is full
+ * @note      bus TM1637_VDISPLAY_BUS_ALL is reserved
+ */
+uint8_t tm1637_vdisplay_add_module(tm1637_vdisplay_t *vdisplay, tm1637_handle_t *handle, uint8_t digits, const uint8_t *map, uint8_t bus);
+
+/**
+ * @brief      get the logical digit number
+ * @param[in]  *vdisplay points to a tm1637 virtual display structure
+ * @param[out] *digits points to a digit number buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 vdisplay is NULL
+ * @note       none
+ */
+uint8_t tm1637_vdisplay_get_digits(tm1637_vdisplay_t *vdisplay, uint8_t *digits);
+
+/**
+ * @brief     clear the framebuffer
+ * @param[in] *vdisplay points to a tm1637 virtual display structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 vdisplay is NULL
+ * @note      the modules are updated by the next flush
+ */
+uint8_t tm1637_vdisplay_clear(tm1637_vdisplay_t *vdisplay);
+
+/**
+ * @brief     write raw segments to the framebuffer
+ * @param[in] *vdisplay points to a tm1637 virtual display structure
+ * @param[in] pos is the first logical digit
+ * @param[in] *data points to a segment buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 2 vdisplay is NULL
+ *            - 4 pos + len is over the display
+ * @note      the modules are updated by the next flush
+ */
+uint8_t tm1637_vdisplay_write(tm1637_vdisplay_t *vdisplay, uint8_t pos, uint8_t *data, uint8_t len);
+
+/**
+ * @brief     print a text to the framebuffer
+ * @param[in] *vdisplay points to a tm1637 virtual display structure
+ * @param[in] pos is the first logical digit
+ * @param[in] *text points to a text string
+ * @return    status code
+ *            - 0 success
+ *            - 2 vdisplay or text is NULL
+ *            - 4 pos is over the display
+ * @note      a '.' is merged into the previous digit, characters over the right end are cut,
+ *            characters without a seven segment glyph are blank
+ */
+uint8_t tm1637_vdisplay_print_text(tm1637_vdisplay_t *vdisplay, uint8_t pos, const char *text);
+
+/**
+ * @brief     print a number to the framebuffer
+ * @param[in] *vdisplay points to a tm1637 virtual display structure
+ * @param[in] pos is the first logical digit of the field
+ * @param[in] width is the field width
+ * @param[in] number is the printed number
+ * @return    status code
+ *            - 0 success
+ *            - 2 vdisplay is NULL
+ *            - 4 field is over the display
+ *            - 5 number does not fit the field
+ * @note      the number is right aligned with blank padding, a number that does not fit fills the field with '-'
+ */
+uint8_t tm1637_vdisplay_print_number(tm1637_vdisplay_t *vdisplay, uint8_t pos, uint8_t width, int32_t number);
+
+/**
+ * @brief     flush the changed modules
+ * @param[in] *vdisplay points to a tm1637 virtual display structure
+ * @param[in] bus is the bus id, TM1637_VDISPLAY_BUS_ALL flushes all modules
+ * @return    status code
+ *            - 0 success
+ *            - 1 flush failed
+ *            - 2 vdisplay is NULL
+ * @note      only the changed digits of each module are sent, modules on different buses may be flushed
+ *            from one task per bus at the same time as they share no state, the framebuffer must not be
+ *            written while flushing
+ */
+uint8_t tm1637_vdisplay_flush(tm1637_vdisplay_t *vdisplay, uint8_t bus);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
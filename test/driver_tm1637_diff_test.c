@@ -0,0 +1,243 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_diff_test.c
+ * @brief     driver tm1637 diff test source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_tm1637_diff_test.h"
+#include <stdlib.h>
+
+#define DIFF_TEST_MAX_MODULE        1024        /**< 6144 digits */
+#define DIFF_TEST_LOOP              1000        /**< benchmark loop */
+
+static uint8_t gs_frame[DIFF_TEST_MAX_MODULE * 6];                       /**< new framebuffer */
+static uint8_t gs_sent[DIFF_TEST_MAX_MODULE * 6];                        /**< sent framebuffer */
+static uint8_t gs_copy[DIFF_TEST_MAX_MODULE * 6];                        /**< transmitted framebuffer */
+static uint8_t gs_mask[DIFF_TEST_MAX_MODULE];                            /**< kernel mask */
+static uint8_t gs_ref[DIFF_TEST_MAX_MODULE];                             /**< reference mask */
+static tm1637_diff_run_t gs_run[DIFF_TEST_MAX_MODULE * 3];               /**< runs */
+
+/**
+ * @brief      bytewise reference diff
+ * @param[in]  *frame points to the new framebuffer
+ * @param[in]  *sent points to the sent framebuffer
+ * @param[in]  modules is the module number
+ * @param[out] *mask points to a changed digit bitmap buffer
+ * @note       none
+ */
+static void a_diff_reference(const uint8_t *frame, const uint8_t *sent, uint16_t modules, uint8_t *mask)
+{
+    uint32_t i;
+    
+    for (i = 0; i < (uint32_t)modules * 6; i++)
+    {
+        if (i % 6 == 0)
+        {
+            mask[i / 6] = 0;
+        }
+        if (frame[i] != sent[i])
+        {
+            mask[i / 6] |= (uint8_t)(1 << (i % 6));
+        }
+    }
+}
+
+/**
+ * @brief     test transmit
+ * @param[in] *ctx points to the transmitted framebuffer
+ * @param[in] module is the module index
+ * @param[in] addr is the start address
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+static uint8_t a_diff_transmit(void *ctx, uint16_t module, uint8_t addr, uint8_t *data, uint8_t len)
+{
+    memcpy((uint8_t *)ctx + module * 6 + addr, data, len);
+    
+    return 0;
+}
+
+/**
+ * @brief     fill the framebuffers
+ * @param[in] modules is the module number
+ * @param[in] percent is the changed digit percent
+ * @note      none
+ */
+static void a_diff_fill(uint16_t modules, uint8_t percent)
+{
+    uint32_t i;
+    
+    for (i = 0; i < (uint32_t)modules * 6; i++)
+    {
+        gs_sent[i] = (uint8_t)(rand() % 256);
+        gs_frame[i] = gs_sent[i];
+        if ((uint32_t)(rand() % 100) < percent)
+        {
+            gs_frame[i] = (uint8_t)(gs_sent[i] ^ (1 + rand() % 255));
+        }
+    }
+}
+
+/**
+ * @brief     diff test
+ * @param[in] times is the test times
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      it checks the diff kernel against a bytewise compare and prints the throughput
+ *            of both at several wall sizes and change densities
+ */
+uint8_t tm1637_diff_test(uint32_t times)
+{
+    uint8_t res;
+    uint8_t s;
+    uint8_t d;
+    uint8_t covered[6];
+    uint16_t modules;
+    uint32_t i;
+    uint32_t t;
+    uint32_t l;
+    uint32_t num;
+    uint32_t start;
+    uint32_t simd_us;
+    uint32_t byte_us;
+    uint64_t bytes;
+    const uint16_t size[] = {16, 96, 512, 1024};
+    const uint8_t percent[] = {0, 1, 10, 50, 100};
+    
+    /* start diff test */
+    tm1637_interface_debug_print("tm1637: start diff test.\n");
+    
+    /* check the kernel */
+    tm1637_interface_debug_print("tm1637: diff kernel test.\n");
+    for (t = 0; t < 256; t++)
+    {
+        modules = (uint16_t)(1 + rand() % DIFF_TEST_MAX_MODULE);
+        a_diff_fill(modules, (uint8_t)(rand() % 101));
+        a_diff_reference(gs_frame, gs_sent, modules, gs_ref);
+        res = tm1637_diff_mask(gs_frame, gs_sent, modules, gs_mask);
+        if ((res != 0) || (memcmp(gs_mask, gs_ref, modules) != 0))
+        {
+            tm1637_interface_debug_print("tm1637: diff mask check failed.\n");
+            
+            return 1;
+        }
+        res = tm1637_diff_scan(gs_frame, gs_sent, modules, gs_run, DIFF_TEST_MAX_MODULE * 3, &num);
+        if (res != 0)
+        {
+            tm1637_interface_debug_print("tm1637: diff scan failed.\n");
+            
+            return 1;
+        }
+        for (i = 0, l = 0; i < modules; i++)
+        {
+            memset(covered, 0, 6);
+            for (; (l < num) && (gs_run[l].module == i); l++)
+            {
+                if ((gs_run[l].len == 0) || (gs_run[l].addr + gs_run[l].len > 6))
+                {
+                    tm1637_interface_debug_print("tm1637: diff run crosses a module.\n");
+                    
+                    return 1;
+                }
+                memset(&covered[gs_run[l].addr], 1, gs_run[l].len);
+            }
+            for (d = 0; d < 6; d++)
+            {
+                if (((gs_ref[i] >> d) & 0x01) > covered[d])
+                {
+                    tm1637_interface_debug_print("tm1637: diff run misses a digit.\n");
+                    
+                    return 1;
+                }
+            }
+        }
+        if (l != num)
+        {
+            tm1637_interface_debug_print("tm1637: diff run order check failed.\n");
+            
+            return 1;
+        }
+        memcpy(gs_copy, gs_sent, (size_t)modules * 6);
+        res = tm1637_diff_transmit(gs_frame, gs_sent, modules, a_diff_transmit, gs_copy, &num);
+        if ((res != 0) || (memcmp(gs_copy, gs_frame, (size_t)modules * 6) != 0) ||
+            (memcmp(gs_sent, gs_frame, (size_t)modules * 6) != 0))
+        {
+            tm1637_interface_debug_print("tm1637: diff transmit check failed.\n");
+            
+            return 1;
+        }
+    }
+    tm1637_interface_debug_print("tm1637: check diff kernel ok.\n");
+    
+    /* benchmark */
+    tm1637_interface_debug_print("tm1637: diff benchmark test.\n");
+    for (t = 0; t < times; t++)
+    {
+        for (s = 0; s < sizeof(size) / sizeof(size[0]); s++)
+        {
+            for (d = 0; d < sizeof(percent) / sizeof(percent[0]); d++)
+            {
+                a_diff_fill(size[s], percent[d]);
+                bytes = (uint64_t)size[s] * 6 * DIFF_TEST_LOOP;
+                
+                start = tm1637_interface_timestamp_us();
+                for (l = 0; l < DIFF_TEST_LOOP; l++)
+                {
+                    (void)tm1637_diff_scan(gs_frame, gs_sent, size[s], gs_run, DIFF_TEST_MAX_MODULE * 3, &num);
+                }
+                simd_us = tm1637_interface_timestamp_us() - start;
+                
+                start = tm1637_interface_timestamp_us();
+                for (l = 0; l < DIFF_TEST_LOOP; l++)
+                {
+                    a_diff_reference(gs_frame, gs_sent, size[s], gs_ref);
+                }
+                byte_us = tm1637_interface_timestamp_us() - start;
+                
+                tm1637_interface_debug_print("tm1637: %d modules %d%% changed %d runs, diff %dMB/s bytewise %dMB/s.\n",
+                                             size[s], percent[d], num,
+                                             (uint32_t)(bytes / (simd_us != 0 ? simd_us : 1)),
+                                             (uint32_t)(bytes / (byte_us != 0 ? byte_us : 1)));
+            }
+        }
+    }
+    
+    /* finish diff test */
+    tm1637_interface_debug_print("tm1637: finish diff test.\n");
+    
+    return 0;
+}
@@ -0,0 +1,534 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_fleet_test.c
+ * @brief     driver tm1637 fleet test source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+#include "driver_tm1637_fleet_test.h"
+#include "driver_tm1637_fleet.h"
+#include <stddef.h>
+#include <stdlib.h>
+
+#define FLEET_TEST_MODULES        60            /**< module number of the flush test */
+#define FLEET_TEST_NONE           0xFFFF        /**< no lane fails */
+
+/**
+ * @brief fleet test fake bus structure definition
+ */
+typedef struct fleet_test_bus_s
+{
+    uint8_t ram[TM1637_FLEET_MAX_MODULE][6];        /**< chip ram of each lane */
+    uint8_t display[TM1637_FLEET_MAX_MODULE];       /**< display bits of each lane */
+    uint32_t segments;                              /**< segment writes */
+    uint32_t displays;                              /**< display writes */
+    uint16_t last_lane;                             /**< lane of the last segment write */
+    uint8_t last_addr;                              /**< address of the last segment write */
+    uint8_t last_len;                               /**< length of the last segment write */
+    uint16_t fail_lane;                             /**< lane whose writes fail */
+} fleet_test_bus_t;
+
+static tm1637_fleet_t gs_fleet;                                   /**< tm1637 fleet */
+static fleet_test_bus_t gs_bus[2];                                /**< fake buses */
+static uint8_t gs_config[TM1637_FLEET_MAX_MODULE];                /**< reference config */
+static uint8_t gs_frame[TM1637_FLEET_MAX_MODULE][6];              /**< framebuffer */
+
+/**
+ * @brief     fleet test fake bus write segment
+ * @param[in] *ctx points to a fake bus
+ * @param[in] lane is the lane of the module
+ * @param[in] addr is the start address
+ * @param[in] *data points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 the lane fails on purpose
+ * @note      none
+ */
+static uint8_t a_fleet_test_write_segment(void *ctx, uint16_t lane, uint8_t addr, uint8_t *data, uint8_t len)
+{
+    fleet_test_bus_t *bus = (fleet_test_bus_t *)ctx;
+    
+    if (lane == bus->fail_lane)
+    {
+        return 1;
+    }
+    memcpy(&bus->ram[lane][addr], data, len);
+    bus->segments++;
+    bus->last_lane = lane;
+    bus->last_addr = addr;
+    bus->last_len = len;
+    
+    return 0;
+}
+
+/**
+ * @brief     fleet test fake bus write display
+ * @param[in] *ctx points to a fake bus
+ * @param[in] lane is the lane of the module
+ * @param[in] display is the display bits
+ * @return    status code
+ *            - 0 success
+ *            - 1 the lane fails on purpose
+ * @note      none
+ */
+static uint8_t a_fleet_test_write_display(void *ctx, uint16_t lane, uint8_t display)
+{
+    fleet_test_bus_t *bus = (fleet_test_bus_t *)ctx;
+    
+    if (lane == bus->fail_lane)
+    {
+        return 1;
+    }
+    bus->display[lane] = display;
+    bus->displays++;
+    
+    return 0;
+}
+
+/**
+ * @brief fleet test fake bus ops
+ */
+static const tm1637_fleet_ops_t gsc_fleet_test_ops =
+{
+    a_fleet_test_write_segment,
+    a_fleet_test_write_display,
+};
+
+/**
+ * @brief     fleet test build a fleet on the two fake buses
+ * @param[in] modules is the module number
+ * @param[in] random is 1 to put the modules on random buses
+ * @return    status code
+ *            - 0 success
+ *            - 1 build failed
+ * @note      module m uses lane m of its bus
+ */
+static uint8_t a_fleet_test_build(uint16_t modules, uint8_t random)
+{
+    uint16_t m;
+    uint16_t id;
+    uint8_t bus;
+    
+    memset(gs_bus, 0, sizeof(gs_bus));
+    gs_bus[0].fail_lane = FLEET_TEST_NONE;
+    gs_bus[1].fail_lane = FLEET_TEST_NONE;
+    if ((tm1637_fleet_init(&gs_fleet, tm1637_interface_debug_print) != 0) ||
+        (tm1637_fleet_add_bus(&gs_fleet, &gsc_fleet_test_ops, &gs_bus[0], &bus) != 0) ||
+        (tm1637_fleet_add_bus(&gs_fleet, &gsc_fleet_test_ops, &gs_bus[1], &bus) != 0))
+    {
+        tm1637_interface_debug_print("tm1637: fleet init failed.\n");
+        
+        return 1;
+    }
+    for (m = 0; m < modules; m++)
+    {
+        bus = (uint8_t)((random != 0) ? (rand() % 2) : (m % 2));
+        if ((tm1637_fleet_add_module(&gs_fleet, bus, m, &id) != 0) || (id != m))
+        {
+            tm1637_interface_debug_print("tm1637: fleet add module failed.\n");
+            
+            return 1;
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     fleet test check the dirty modules
+ * @param[in] *name points to the check name
+ * @param[in] count is the expected dirty module number
+ * @param[in] module is the expected dirty module, used when count is 1
+ * @return    status code
+ *            - 0 success
+ *            - 1 check failed
+ * @note      none
+ */
+static uint8_t a_fleet_test_dirty(const char *name, uint16_t count, uint16_t module)
+{
+    uint64_t dirty[TM1637_FLEET_MAX_MODULE / 64];
+    uint16_t num;
+    
+    (void)tm1637_fleet_scan_dirty(&gs_fleet, dirty, &num);
+    if ((num != count) || ((count == 1) && (((dirty[module / 64] >> (module % 64)) & 1) == 0)))
+    {
+        tm1637_interface_debug_print("tm1637: %s has %d dirty modules instead of %d.\n", name, num, count);
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     fleet test the kernels against a scalar reference
+ * @param[in] times is the test times
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      the modules past the module number hold garbage which the kernels must ignore
+ */
+static uint8_t a_fleet_test_kernel(uint32_t times)
+{
+    uint64_t dirty[TM1637_FLEET_MAX_MODULE / 64];
+    uint64_t ref[TM1637_FLEET_MAX_MODULE / 64];
+    uint64_t select[TM1637_FLEET_MAX_MODULE / 64];
+    uint16_t modules;
+    uint16_t count;
+    uint16_t total;
+    uint16_t m;
+    uint16_t w;
+    uint8_t width;
+    uint8_t all;
+    uint32_t t;
+    
+    for (t = 0; t < times * 64; t++)
+    {
+        modules = (uint16_t)(1 + rand() % TM1637_FLEET_MAX_MODULE);
+        if (a_fleet_test_build(modules, 1) != 0)
+        {
+            return 1;
+        }
+        
+        /* a few changed digits and display bits, garbage past the module number */
+        for (m = 0; m < TM1637_FLEET_MAX_MODULE; m++)
+        {
+            if (m < modules)
+            {
+                gs_fleet.changed[m] = ((rand() % 4) == 0) ? (uint8_t)(rand() & 0x3F) : 0;
+                gs_fleet.config[m] = (uint8_t)(rand() & 0x0F);
+                gs_fleet.config_sent[m] = ((rand() % 3) == 0) ? (uint8_t)(rand() & 0x0F) : gs_fleet.config[m];
+            }
+            else
+            {
+                gs_fleet.changed[m] = (uint8_t)(1 + rand() % 255);
+                gs_fleet.config[m] = (uint8_t)(rand() % 256);
+                gs_fleet.config_sent[m] = (uint8_t)~gs_fleet.config[m];
+            }
+        }
+        
+        /* scalar dirty scan */
+        memset(ref, 0, sizeof(ref));
+        total = 0;
+        for (m = 0; m < modules; m++)
+        {
+            if ((gs_fleet.changed[m] != 0) || (gs_fleet.config[m] != gs_fleet.config_sent[m]))
+            {
+                ref[m / 64] |= 1ULL << (m % 64);
+                total++;
+            }
+        }
+        (void)tm1637_fleet_scan_dirty(&gs_fleet, dirty, &count);
+        if ((count != total) || (memcmp(dirty, ref, sizeof(ref)) != 0))
+        {
+            tm1637_interface_debug_print("tm1637: %d modules scan found %d dirty modules instead of %d.\n", modules, count, total);
+            
+            return 1;
+        }
+        
+        /* scalar brightness */
+        all = ((rand() % 4) == 0) ? 1 : 0;
+        width = (uint8_t)(rand() % 8);
+        for (w = 0; w < TM1637_FLEET_MAX_MODULE / 64; w++)
+        {
+            select[w] = ((uint64_t)rand() << 40) ^ ((uint64_t)rand() << 20) ^ (uint64_t)rand();
+        }
+        memcpy(gs_config, gs_fleet.config, sizeof(gs_config));
+        for (m = 0; m < modules; m++)
+        {
+            if ((all != 0) || (((select[m / 64] >> (m % 64)) & 1) != 0))
+            {
+                gs_config[m] = (uint8_t)((gs_config[m] & ~0x07) | width);
+            }
+        }
+        (void)tm1637_fleet_set_brightness(&gs_fleet, (all != 0) ? NULL : select, (tm1637_pulse_width_t)width);
+        if (memcmp(gs_config, gs_fleet.config, sizeof(gs_config)) != 0)
+        {
+            tm1637_interface_debug_print("tm1637: %d modules brightness check failed.\n", modules);
+            
+            return 1;
+        }
+    }
+#if defined(TM1637_FLEET_SSE2)
+    tm1637_interface_debug_print("tm1637: check sse2 kernels ok.\n");
+#else
+    tm1637_interface_debug_print("tm1637: check swar kernels ok.\n");
+#endif
+    
+    return 0;
+}
+
+/**
+ * @brief     fleet test check the fake buses
+ * @param[in] *name points to the check name
+ * @param[in] segments is the expected segment write number
+ * @param[in] displays is the expected display write number
+ * @return    status code
+ *            - 0 success
+ *            - 1 check failed
+ * @note      the chip ram of every module must match the fleet, the counters are cleared after the check
+ */
+static uint8_t a_fleet_test_bus(const char *name, uint32_t segments, uint32_t displays)
+{
+    fleet_test_bus_t *bus;
+    uint16_t m;
+    
+    if ((gs_bus[0].segments + gs_bus[1].segments != segments) ||
+        (gs_bus[0].displays + gs_bus[1].displays != displays))
+    {
+        tm1637_interface_debug_print("tm1637: %s sent %d segments and %d displays instead of %d and %d.\n", name,
+                                     gs_bus[0].segments + gs_bus[1].segments, gs_bus[0].displays + gs_bus[1].displays,
+                                     segments, displays);
+        
+        return 1;
+    }
+    for (m = 0; m < gs_fleet.module_num; m++)
+    {
+        bus = &gs_bus[gs_fleet.bus[m]];
+        if ((gs_fleet.changed[m] == 0) &&
+            ((memcmp(bus->ram[m], gs_fleet.ram[m], 6) != 0) || (bus->display[m] != gs_fleet.config[m])))
+        {
+            tm1637_interface_debug_print("tm1637: %s module %d does not match.\n", name, m);
+            
+            return 1;
+        }
+    }
+    gs_bus[0].segments = 0;
+    gs_bus[1].segments = 0;
+    gs_bus[0].displays = 0;
+    gs_bus[1].displays = 0;
+    
+    return 0;
+}
+
+/**
+ * @brief  fleet test the flush
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   module m is on bus m % 2
+ */
+static uint8_t a_fleet_test_flush(void)
+{
+    uint16_t m;
+    uint8_t i;
+    uint8_t data;
+    
+    /* the first flush sends the display and every digit */
+    if (a_fleet_test_build(FLEET_TEST_MODULES, 0) != 0)
+    {
+        return 1;
+    }
+    for (m = 0; m < FLEET_TEST_MODULES; m++)
+    {
+        for (i = 0; i < 6; i++)
+        {
+            gs_frame[m][i] = (uint8_t)(m + i);
+        }
+        (void)tm1637_fleet_write_segment(&gs_fleet, m, 0, gs_frame[m], 6);
+    }
+    if ((a_fleet_test_dirty("first write", FLEET_TEST_MODULES, 0) != 0) ||
+        (tm1637_fleet_flush(&gs_fleet, TM1637_FLEET_BUS_ALL) != 0) ||
+        (a_fleet_test_bus("first flush", FLEET_TEST_MODULES, FLEET_TEST_MODULES) != 0) ||
+        (a_fleet_test_dirty("first flush", 0, 0) != 0))
+    {
+        return 1;
+    }
+    
+    /* one digit goes out on its own bus only */
+    data = 0x5A;
+    if ((tm1637_fleet_write_segment(&gs_fleet, 37, 3, &data, 1) != 0) ||
+        (a_fleet_test_dirty("one digit", 1, 37) != 0) ||
+        (tm1637_fleet_flush(&gs_fleet, 0) != 0) ||
+        (a_fleet_test_bus("other bus", 0, 0) != 0) ||
+        (tm1637_fleet_flush(&gs_fleet, 1) != 0) ||
+        (gs_bus[1].last_lane != 37) || (gs_bus[1].last_addr != 3) || (gs_bus[1].last_len != 1) ||
+        (a_fleet_test_bus("one digit", 1, 0) != 0))
+    {
+        tm1637_interface_debug_print("tm1637: one digit flush failed.\n");
+        
+        return 1;
+    }
+    
+    /* a digit back at its sent value is clean again */
+    data = 0xA5;
+    if ((tm1637_fleet_write_segment(&gs_fleet, 12, 2, &data, 1) != 0) ||
+        (a_fleet_test_dirty("changed digit", 1, 12) != 0) ||
+        (tm1637_fleet_write_segment(&gs_fleet, 12, 2, &gs_frame[12][2], 1) != 0) ||
+        (a_fleet_test_dirty("digit back", 0, 0) != 0))
+    {
+        return 1;
+    }
+    
+    /* a frame marks exactly the digits which differ from the sent ones */
+    memcpy(gs_frame, gs_fleet.sent, sizeof(gs_frame));
+    gs_frame[20][0] ^= 0xFF;
+    gs_frame[21][1] ^= 0xFF;
+    gs_frame[21][4] ^= 0xFF;
+    if ((tm1637_fleet_write_frame(&gs_fleet, &gs_frame[0][0]) != 0) ||
+        (a_fleet_test_dirty("frame", 2, 0) != 0) || (gs_fleet.changed[20] != 0x01) || (gs_fleet.changed[21] != 0x12) ||
+        (tm1637_fleet_flush(&gs_fleet, TM1637_FLEET_BUS_ALL) != 0) ||
+        (gs_bus[1].last_addr != 1) || (gs_bus[1].last_len != 4) ||
+        (a_fleet_test_bus("frame", 2, 0) != 0))
+    {
+        tm1637_interface_debug_print("tm1637: frame flush failed.\n");
+        
+        return 1;
+    }
+    gs_frame[20][0] ^= 0xFF;
+    if ((tm1637_fleet_write_frame(&gs_fleet, &gs_frame[0][0]) != 0) ||
+        (a_fleet_test_dirty("frame change", 1, 20) != 0) ||
+        (tm1637_fleet_write_frame(&gs_fleet, &gs_fleet.sent[0][0]) != 0) ||
+        (a_fleet_test_dirty("frame back", 0, 0) != 0))
+    {
+        return 1;
+    }
+    
+    /* a failed module stays dirty and the others keep going */
+    data = 0x11;
+    gs_bus[1].fail_lane = 5;
+    if ((tm1637_fleet_write_segment(&gs_fleet, 5, 0, &data, 1) != 0) ||
+        (tm1637_fleet_write_segment(&gs_fleet, 6, 0, &data, 1) != 0) ||
+        (tm1637_fleet_write_segment(&gs_fleet, 7, 0, &data, 1) != 0) ||
+        (tm1637_fleet_flush(&gs_fleet, TM1637_FLEET_BUS_ALL) != 1) ||
+        (a_fleet_test_bus("failed module", 2, 0) != 0) ||
+        (a_fleet_test_dirty("failed module", 1, 5) != 0))
+    {
+        gs_bus[1].fail_lane = FLEET_TEST_NONE;
+        
+        return 1;
+    }
+    gs_bus[1].fail_lane = FLEET_TEST_NONE;
+    if ((tm1637_fleet_flush(&gs_fleet, TM1637_FLEET_BUS_ALL) != 0) ||
+        (a_fleet_test_bus("retry", 1, 0) != 0) ||
+        (a_fleet_test_dirty("retry", 0, 0) != 0))
+    {
+        return 1;
+    }
+    
+    /* a new brightness sends only the display */
+    if ((tm1637_fleet_set_brightness(&gs_fleet, NULL, TM1637_PULSE_WIDTH_2_DIV_16) != 0) ||
+        (a_fleet_test_dirty("brightness", FLEET_TEST_MODULES, 0) != 0) ||
+        (tm1637_fleet_flush(&gs_fleet, TM1637_FLEET_BUS_ALL) != 0) ||
+        (a_fleet_test_bus("brightness", 0, FLEET_TEST_MODULES) != 0))
+    {
+        return 1;
+    }
+    tm1637_interface_debug_print("tm1637: check flush ok.\n");
+    
+    return 0;
+}
+
+/**
+ * @brief  fleet test the footprint
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   the module arrays must be back to back and cache line aligned
+ */
+static uint8_t a_fleet_test_footprint(void)
+{
+    uint32_t per_module;
+    uint32_t total;
+    
+    if ((tm1637_fleet_get_footprint(&gs_fleet, &per_module, &total) != 0) ||
+        (per_module != 19) || (total != sizeof(tm1637_fleet_t)) ||
+        (total < per_module * TM1637_FLEET_MAX_MODULE))
+    {
+        tm1637_interface_debug_print("tm1637: footprint is %d bytes per module and %d bytes.\n", per_module, total);
+        
+        return 1;
+    }
+    if ((offsetof(tm1637_fleet_t, buses) != per_module * TM1637_FLEET_MAX_MODULE) ||
+        (offsetof(tm1637_fleet_t, lane) % TM1637_FLEET_ALIGN != 0) ||
+        (offsetof(tm1637_fleet_t, ram) % TM1637_FLEET_ALIGN != 0) ||
+        (offsetof(tm1637_fleet_t, sent) % TM1637_FLEET_ALIGN != 0))
+    {
+        tm1637_interface_debug_print("tm1637: module arrays are padded or not aligned.\n");
+        
+        return 1;
+    }
+#if defined(__GNUC__) || defined(__clang__) || defined(__CC_ARM) || defined(__ICCARM__)
+    if (((size_t)&gs_fleet % TM1637_FLEET_ALIGN) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: fleet is not cache line aligned.\n");
+        
+        return 1;
+    }
+#endif
+    tm1637_interface_debug_print("tm1637: footprint %d bytes per module, %d bytes for %d modules.\n",
+                                 per_module, total, TM1637_FLEET_MAX_MODULE);
+    
+    return 0;
+}
+
+/**
+ * @brief     fleet test
+ * @param[in] times is the test times
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      it checks the dirty scan and the brightness kernels against a scalar reference on random fleets,
+ *            then flushes a fleet on two fake buses and checks the changed digits, the failed modules and the footprint,
+ *            build with TM1637_FLEET_NO_SSE2 to check the swar kernels on a sse2 host
+ */
+uint8_t tm1637_fleet_test(uint32_t times)
+{
+    /* start fleet test */
+    tm1637_interface_debug_print("tm1637: start fleet test.\n");
+    
+    /* kernel */
+    tm1637_interface_debug_print("tm1637: fleet kernel test.\n");
+    if (a_fleet_test_kernel(times) != 0)
+    {
+        return 1;
+    }
+    
+    /* flush */
+    tm1637_interface_debug_print("tm1637: fleet flush test.\n");
+    if (a_fleet_test_flush() != 0)
+    {
+        return 1;
+    }
+    
+    /* footprint */
+    tm1637_interface_debug_print("tm1637: fleet footprint test.\n");
+    if (a_fleet_test_footprint() != 0)
+    {
+        return 1;
+    }
+    
+    /* finish fleet test */
+    tm1637_interface_debug_print("tm1637: finish fleet test.\n");
+    
+    return 0;
+}
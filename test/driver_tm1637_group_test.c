@@ -0,0 +1,504 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_group_test.c
+ * @brief     driver tm1637 group test source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+#include "driver_tm1637_group_test.h"
+#include "driver_tm1637_group.h"
+#include <string.h>
+
+#define GROUP_TEST_MODULES        4        /**< module number */
+#define GROUP_TEST_LOG            8        /**< max logged transactions of each module */
+
+/**
+ * @brief group test decoder structure definition
+ */
+typedef struct group_test_line_s
+{
+    uint8_t active;                            /**< inside a transaction */
+    uint8_t bit;                               /**< bit counter */
+    uint8_t shift;                             /**< shift register */
+    uint8_t bytes;                             /**< received bytes */
+    uint8_t byte[7];                           /**< received bytes of the transaction */
+    uint8_t num;                               /**< logged transaction number */
+    uint8_t cmd[GROUP_TEST_LOG];               /**< command byte of each logged transaction */
+    uint8_t len[GROUP_TEST_LOG];               /**< payload length of each logged transaction */
+    uint8_t ram[6];                            /**< chip ram seen on the line */
+} group_test_line_t;
+
+static tm1637_parallel_t gs_parallel;                             /**< tm1637 parallel structure */
+static tm1637_group_t gs_group[2];                                /**< tm1637 group structures */
+static group_test_line_t gs_line[GROUP_TEST_MODULES];             /**< decoder of every dio line */
+static uint32_t gs_dio;                                           /**< dio levels driven by the host */
+static uint8_t gs_clk;                                            /**< clk level */
+static uint16_t gs_silent;                                        /**< modules which stop acking */
+
+/**
+ * @brief     group test clk write
+ * @param[in] level is the clk level
+ * @note      every active line shifts in its dio level on the rising edge, the ninth clock ends a byte
+ */
+static void a_group_test_clk_write(uint8_t level)
+{
+    group_test_line_t *line;
+    uint8_t m;
+    
+    if ((gs_clk == 0) && (level != 0))
+    {
+        for (m = 0; m < GROUP_TEST_MODULES; m++)
+        {
+            line = &gs_line[m];
+            if (line->active == 0)
+            {
+                continue;
+            }
+            if (line->bit < 8)
+            {
+                line->shift |= (uint8_t)(((gs_dio >> m) & 0x01) << line->bit);
+                line->bit++;
+            }
+            else
+            {
+                if (line->bytes < 7)
+                {
+                    line->byte[line->bytes] = line->shift;
+                }
+                line->bytes++;
+                line->bit = 0;
+                line->shift = 0;
+            }
+        }
+    }
+    gs_clk = level;
+    tm1637_interface_parallel_clk_write(level);
+}
+
+/**
+ * @brief     group test dio write
+ * @param[in] mask is the dio line mask
+ * @param[in] level is the dio level
+ * @note      a falling line while clk is high starts a transaction and a rising one logs it
+ */
+static void a_group_test_dio_write(uint32_t mask, uint32_t level)
+{
+    group_test_line_t *line;
+    uint32_t dio;
+    uint8_t m;
+    uint8_t i;
+    
+    dio = (gs_dio & ~mask) | (level & mask);
+    for (m = 0; (m < GROUP_TEST_MODULES) && (gs_clk != 0); m++)
+    {
+        line = &gs_line[m];
+        if ((((gs_dio >> m) & 0x01) != 0) && (((dio >> m) & 0x01) == 0))
+        {
+            line->active = 1;
+            line->bit = 0;
+            line->shift = 0;
+            line->bytes = 0;
+        }
+        else if ((((gs_dio >> m) & 0x01) == 0) && (((dio >> m) & 0x01) != 0) && (line->active != 0))
+        {
+            line->active = 0;
+            if ((line->bytes == 0) || (line->bytes > 7))
+            {
+                continue;
+            }
+            if (line->num < GROUP_TEST_LOG)
+            {
+                line->cmd[line->num] = line->byte[0];
+                line->len[line->num] = (uint8_t)(line->bytes - 1);
+            }
+            line->num++;
+            if ((line->byte[0] & 0xC0) == 0xC0)
+            {
+                for (i = 1; (i < line->bytes) && ((line->byte[0] & 0x07) + i - 1 < 6); i++)
+                {
+                    line->ram[(line->byte[0] & 0x07) + i - 1] = line->byte[i];
+                }
+            }
+        }
+    }
+    gs_dio = dio;
+    tm1637_interface_parallel_dio_write(mask, level);
+}
+
+/**
+ * @brief  group test dio read
+ * @return dio levels
+ * @note   a silent module leaves its line released during the ack
+ */
+static uint32_t a_group_test_dio_read(void)
+{
+    return tm1637_interface_parallel_dio_read() | gs_silent;
+}
+
+/**
+ * @brief     group test check the transactions of every module
+ * @param[in] *name points to the check name
+ * @param[in] select is the module mask which must see the transactions
+ * @param[in] *cmd points to the expected command bytes
+ * @param[in] *len points to the expected payload lengths
+ * @param[in] num is the expected transaction number
+ * @return    status code
+ *            - 0 success
+ *            - 1 check failed
+ * @note      the other modules must see nothing, the logs are cleared after the check
+ */
+static uint8_t a_group_test_check(const char *name, uint16_t select, const uint8_t *cmd, const uint8_t *len, uint8_t num)
+{
+    group_test_line_t *line;
+    uint8_t res;
+    uint8_t want;
+    uint8_t m;
+    uint8_t i;
+    
+    res = 0;
+    for (m = 0; m < GROUP_TEST_MODULES; m++)
+    {
+        line = &gs_line[m];
+        want = ((select & (1 << m)) != 0) ? num : 0;
+        if (line->num != want)
+        {
+            tm1637_interface_debug_print("tm1637: %s module %d saw %d transactions instead of %d.\n", name, m, line->num, want);
+            res = 1;
+        }
+        for (i = 0; (res == 0) && (i < want); i++)
+        {
+            if ((line->cmd[i] != cmd[i]) || (line->len[i] != len[i]))
+            {
+                tm1637_interface_debug_print("tm1637: %s module %d transaction %d is 0x%02X len %d instead of 0x%02X len %d.\n",
+                                             name, m, i, line->cmd[i], line->len[i], cmd[i], len[i]);
+                res = 1;
+            }
+        }
+        line->num = 0;
+    }
+    
+    return res;
+}
+
+/**
+ * @brief     group test check the members
+ * @param[in] *name points to the check name
+ * @param[in] *group points to a tm1637 group structure
+ * @param[in] members is the expected member mask
+ * @param[in] dropped is the expected dropped mask
+ * @return    status code
+ *            - 0 success
+ *            - 1 check failed
+ * @note      none
+ */
+static uint8_t a_group_test_members(const char *name, tm1637_group_t *group, uint16_t members, uint16_t dropped)
+{
+    uint16_t m;
+    uint16_t d;
+    
+    if ((tm1637_group_get_members(group, &m, &d) != 0) || (m != members) || (d != dropped))
+    {
+        tm1637_interface_debug_print("tm1637: %s members 0x%04X dropped 0x%04X instead of 0x%04X 0x%04X.\n",
+                                     name, m, d, members, dropped);
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  group test the members and the changed span
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   none
+ */
+static uint8_t a_group_test_span(void)
+{
+    const uint8_t cmd0[3] = {0x8F, 0x40, 0xC0};
+    const uint8_t len0[3] = {0, 0, 6};
+    const uint8_t cmd1[2] = {0x40, 0xC1};
+    const uint8_t len1[2] = {0, 3};
+    const uint8_t cmd2[1] = {0x8A};
+    const uint8_t len2[1] = {0};
+    uint8_t frame[6] = {0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D};
+    uint8_t span[3] = {0x07, 0x5B, 0x7F};
+    uint8_t blank = 0x00;
+    
+    /* the first flush sends the display and the whole frame to the members only */
+    if ((tm1637_group_init(&gs_group[0], &gs_parallel, 0x0005) != 0) ||
+        (tm1637_group_write_segment(&gs_group[0], 0, frame, 6) != 0) ||
+        (tm1637_group_flush(&gs_group[0], NULL) != 0) ||
+        (a_group_test_check("first flush", 0x0005, cmd0, len0, 3) != 0))
+    {
+        return 1;
+    }
+    if (gs_group[0].transmissions != 2)
+    {
+        tm1637_interface_debug_print("tm1637: first flush took %d transmissions instead of 2.\n", gs_group[0].transmissions);
+        
+        return 1;
+    }
+    
+    /* nothing changed, nothing is sent */
+    if ((tm1637_group_flush(&gs_group[0], NULL) != 0) ||
+        (a_group_test_check("idle flush", 0, NULL, NULL, 0) != 0))
+    {
+        return 1;
+    }
+    
+    /* an unchanged digit inside the span goes out with it */
+    if ((tm1637_group_write_segment(&gs_group[0], 1, span, 3) != 0) ||
+        (tm1637_group_flush(&gs_group[0], NULL) != 0) ||
+        (a_group_test_check("span", 0x0005, cmd1, len1, 2) != 0))
+    {
+        return 1;
+    }
+    
+    /* a digit back at its sent value is not changed and the same display is not sent */
+    if ((tm1637_group_write_segment(&gs_group[0], 4, &blank, 1) != 0) ||
+        (tm1637_group_write_segment(&gs_group[0], 4, &frame[4], 1) != 0) ||
+        (tm1637_group_set_display(&gs_group[0], TM1637_BOOL_TRUE, TM1637_PULSE_WIDTH_14_DIV_16) != 0) ||
+        (tm1637_group_flush(&gs_group[0], NULL) != 0) ||
+        (a_group_test_check("back to sent", 0, NULL, NULL, 0) != 0))
+    {
+        return 1;
+    }
+    
+    /* a new display goes out alone */
+    if ((tm1637_group_set_display(&gs_group[0], TM1637_BOOL_TRUE, TM1637_PULSE_WIDTH_4_DIV_16) != 0) ||
+        (tm1637_group_flush(&gs_group[0], NULL) != 0) ||
+        (a_group_test_check("display", 0x0005, cmd2, len2, 1) != 0))
+    {
+        return 1;
+    }
+    tm1637_interface_debug_print("tm1637: check changed span ok.\n");
+    
+    return 0;
+}
+
+/**
+ * @brief  group test the dropout and the members
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   it runs after the span test
+ */
+static uint8_t a_group_test_dropout(void)
+{
+    const uint8_t cmd0[2] = {0x40, 0xC0};
+    const uint8_t len0[2] = {0, 1};
+    const uint8_t cmd1[2] = {0x40, 0xC5};
+    const uint8_t len1[2] = {0, 1};
+    const uint8_t cmd2[3] = {0x8A, 0x40, 0xC0};
+    const uint8_t len2[3] = {0, 0, 6};
+    const uint8_t cmd3[2] = {0x40, 0xC2};
+    const uint8_t cmd4[3] = {0x8F, 0x40, 0xC0};
+    const uint8_t ram0[6] = {0x71, 0x07, 0x5B, 0x7F, 0x66, 0x79};
+    const uint8_t ram1[6] = {0x76, 0x79, 0x38, 0x38, 0x3F, 0x00};
+    const uint8_t ram2[6] = {0x71, 0x07, 0x40, 0x7F, 0x66, 0x79};
+    const uint8_t ram3[6] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+    uint8_t hello[6] = {0x76, 0x79, 0x38, 0x38, 0x3F, 0x00};
+    uint8_t f = 0x71;
+    uint8_t e = 0x79;
+    uint8_t dash = 0x40;
+    uint16_t dropped;
+    
+    /* module 2 stops acking, the flush still reaches module 0 and drops module 2 */
+    gs_silent = 0x0004;
+    if ((tm1637_group_write_segment(&gs_group[0], 0, &f, 1) != 0) ||
+        (tm1637_group_flush(&gs_group[0], &dropped) != 1) || (dropped != 0x0004) ||
+        (a_group_test_check("dropout", 0x0005, cmd0, len0, 2) != 0) ||
+        (a_group_test_members("dropout", &gs_group[0], 0x0001, 0x0004) != 0))
+    {
+        gs_silent = 0;
+        
+        return 1;
+    }
+    
+    /* the dropped module is not selected any more */
+    if ((tm1637_group_write_segment(&gs_group[0], 5, &e, 1) != 0) ||
+        (tm1637_group_flush(&gs_group[0], &dropped) != 0) || (dropped != 0) ||
+        (a_group_test_check("after dropout", 0x0001, cmd1, len1, 2) != 0))
+    {
+        gs_silent = 0;
+        
+        return 1;
+    }
+    gs_silent = 0;
+    
+    /* the module comes back, every member gets the display and the whole frame */
+    if ((tm1637_group_add_member(&gs_group[0], 2) != 0) ||
+        (a_group_test_members("add member", &gs_group[0], 0x0005, 0x0000) != 0) ||
+        (tm1637_group_flush(&gs_group[0], NULL) != 0) ||
+        (a_group_test_check("add member", 0x0005, cmd2, len2, 3) != 0))
+    {
+        return 1;
+    }
+    
+    /* a removed module keeps its digits */
+    if ((tm1637_group_remove_member(&gs_group[0], 0) != 0) ||
+        (a_group_test_members("remove member", &gs_group[0], 0x0004, 0x0000) != 0) ||
+        (tm1637_group_write_segment(&gs_group[0], 2, &dash, 1) != 0) ||
+        (tm1637_group_flush(&gs_group[0], NULL) != 0) ||
+        (a_group_test_check("remove member", 0x0004, cmd3, len0, 2) != 0))
+    {
+        return 1;
+    }
+    
+    /* a second group on the same bus leaves the first one alone */
+    if ((tm1637_group_init(&gs_group[1], &gs_parallel, 0x0002) != 0) ||
+        (tm1637_group_write_segment(&gs_group[1], 0, hello, 6) != 0) ||
+        (tm1637_group_flush(&gs_group[1], NULL) != 0) ||
+        (a_group_test_check("second group", 0x0002, cmd4, len2, 3) != 0))
+    {
+        return 1;
+    }
+    if ((memcmp(gs_line[0].ram, ram0, 6) != 0) || (memcmp(gs_line[1].ram, ram1, 6) != 0) ||
+        (memcmp(gs_line[2].ram, ram2, 6) != 0) || (memcmp(gs_line[3].ram, ram3, 6) != 0))
+    {
+        tm1637_interface_debug_print("tm1637: group ram check failed.\n");
+        
+        return 1;
+    }
+    tm1637_interface_debug_print("tm1637: check members and dropout ok.\n");
+    
+    return 0;
+}
+
+/**
+ * @brief  group test the range checks
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   nothing may reach the bus
+ */
+static uint8_t a_group_test_range(void)
+{
+    uint8_t data[7] = {0};
+    uint16_t nack;
+    
+    if ((tm1637_group_init(&gs_group[1], &gs_parallel, 0x0010) != 4) ||
+        (tm1637_group_add_member(&gs_group[0], GROUP_TEST_MODULES) != 4) ||
+        (tm1637_group_remove_member(&gs_group[0], GROUP_TEST_MODULES) != 4) ||
+        (tm1637_group_write_segment(&gs_group[0], 1, data, 6) != 4) ||
+        (tm1637_parallel_broadcast_segment(&gs_parallel, 0x0000, 0, data, 1, &nack) != 5) ||
+        (tm1637_parallel_broadcast_segment(&gs_parallel, 0x0010, 0, data, 1, &nack) != 5) ||
+        (tm1637_parallel_broadcast_segment(&gs_parallel, 0x0001, 5, data, 2, &nack) != 4) ||
+        (tm1637_parallel_broadcast_display(&gs_parallel, 0x0000, TM1637_BOOL_TRUE,
+                                           TM1637_PULSE_WIDTH_1_DIV_16, &nack) != 5))
+    {
+        tm1637_interface_debug_print("tm1637: group range check failed.\n");
+        
+        return 1;
+    }
+    if (a_group_test_check("range", 0, NULL, NULL, 0) != 0)
+    {
+        return 1;
+    }
+    tm1637_interface_debug_print("tm1637: check range ok.\n");
+    
+    return 0;
+}
+
+/**
+ * @brief  group test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   it runs two broadcast groups on 4 parallel modules, decodes the transactions every module sees
+ *         and checks the members, the dropout of a module that stops acking, the changed span and the range checks
+ */
+uint8_t tm1637_group_test(void)
+{
+    uint8_t res;
+    
+    /* link interface function */
+    DRIVER_TM1637_PARALLEL_LINK_INIT(&gs_parallel, tm1637_parallel_t);
+    DRIVER_TM1637_PARALLEL_LINK_PORT_INIT(&gs_parallel, tm1637_interface_parallel_port_init);
+    DRIVER_TM1637_PARALLEL_LINK_PORT_DEINIT(&gs_parallel, tm1637_interface_parallel_port_deinit);
+    DRIVER_TM1637_PARALLEL_LINK_CLK_WRITE(&gs_parallel, a_group_test_clk_write);
+    DRIVER_TM1637_PARALLEL_LINK_DIO_WRITE(&gs_parallel, a_group_test_dio_write);
+    DRIVER_TM1637_PARALLEL_LINK_DIO_READ(&gs_parallel, a_group_test_dio_read);
+    DRIVER_TM1637_PARALLEL_LINK_DELAY_US(&gs_parallel, tm1637_interface_delay_us);
+    DRIVER_TM1637_PARALLEL_LINK_DEBUG_PRINT(&gs_parallel, tm1637_interface_debug_print);
+    memset(gs_line, 0, sizeof(gs_line));
+    gs_dio = 0xFFFFFFFFU;
+    gs_clk = 1;
+    gs_silent = 0;
+    
+    /* start group test */
+    tm1637_interface_debug_print("tm1637: start group test.\n");
+    
+    /* parallel init */
+    res = tm1637_parallel_init(&gs_parallel, GROUP_TEST_MODULES, 0);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: parallel init failed.\n");
+        
+        return 1;
+    }
+    (void)a_group_test_check("init", 0, NULL, NULL, 0);
+    
+    /* span */
+    tm1637_interface_debug_print("tm1637: group span test.\n");
+    if (a_group_test_span() != 0)
+    {
+        (void)tm1637_parallel_deinit(&gs_parallel);
+        
+        return 1;
+    }
+    
+    /* dropout */
+    tm1637_interface_debug_print("tm1637: group dropout test.\n");
+    if (a_group_test_dropout() != 0)
+    {
+        (void)tm1637_parallel_deinit(&gs_parallel);
+        
+        return 1;
+    }
+    
+    /* range */
+    tm1637_interface_debug_print("tm1637: group range test.\n");
+    if (a_group_test_range() != 0)
+    {
+        (void)tm1637_parallel_deinit(&gs_parallel);
+        
+        return 1;
+    }
+    
+    /* finish group test */
+    tm1637_interface_debug_print("tm1637: finish group test.\n");
+    (void)tm1637_parallel_deinit(&gs_parallel);
+    
+    return 0;
+}
@@ -0,0 +1,335 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_link_test.c
+ * @brief     driver tm1637 link test source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_tm1637_link_test.h"
+
+static tm1637_link_client_t gs_client;                                  /**< link client */
+static const uint8_t gsc_number[] = {TM1637_NUMBER_0, TM1637_NUMBER_1, TM1637_NUMBER_2,
+                                     TM1637_NUMBER_3, TM1637_NUMBER_4, TM1637_NUMBER_5,
+                                     TM1637_NUMBER_6, TM1637_NUMBER_7, TM1637_NUMBER_8,
+                                     TM1637_NUMBER_9};                  /**< number table */
+
+/**
+ * @brief  link test the frame codec
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   none
+ */
+static uint8_t a_tm1637_link_test_codec(void)
+{
+    tm1637_link_decoder_t decoder;
+    uint8_t payload[4] = {0x00, 0x02, 0x5B, 0x4F};
+    uint8_t buf[TM1637_LINK_MAX_FRAME];
+    uint8_t ready;
+    uint16_t size;
+    uint16_t i;
+    
+    (void)tm1637_link_decoder_init(&decoder);
+    if (tm1637_link_pack(buf, &size, 0x7E, TM1637_LINK_COMMAND_WRITE_SEGMENT, payload, 4) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: link pack failed.\n");
+        
+        return 1;
+    }
+    
+    /* one flipped bit is dropped */
+    buf[5] ^= 0x10;
+    ready = 0;
+    for (i = 0; i < size; i++)
+    {
+        ready |= tm1637_link_decode(&decoder, buf[i]);
+    }
+    if ((ready != 0) || (decoder.errors != 1))
+    {
+        tm1637_interface_debug_print("tm1637: corrupted frame is not dropped.\n");
+        
+        return 1;
+    }
+    
+    /* noise before the sof is skipped and the good frame decodes */
+    buf[5] ^= 0x10;
+    ready = tm1637_link_decode(&decoder, 0x00);
+    ready |= tm1637_link_decode(&decoder, 0x41);
+    for (i = 0; i < size; i++)
+    {
+        ready |= tm1637_link_decode(&decoder, buf[i]);
+    }
+    if ((ready != 1) || (decoder.frames != 1) || (decoder.seq != 0x7E) ||
+        (decoder.command != TM1637_LINK_COMMAND_WRITE_SEGMENT) || (decoder.len != 4) ||
+        (memcmp(decoder.payload, payload, 4) != 0))
+    {
+        tm1637_interface_debug_print("tm1637: good frame is not decoded.\n");
+        
+        return 1;
+    }
+    tm1637_interface_debug_print("tm1637: check codec ok.\n");
+    
+    return 0;
+}
+
+/**
+ * @brief     link test
+ * @param[in] *write points to a byte write function address
+ * @param[in] *read points to a byte read function address
+ * @param[in] *ctx is the transport context
+ * @param[in] window is the max in flight byte number
+ * @param[in] num is the display number of the server
+ * @param[in] times is the test times
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      display i finally shows (times - 1 + i + digit) % 10 with the display on at 14/16
+ */
+uint8_t tm1637_link_test(uint8_t (*write)(void *ctx, uint8_t *buf, uint16_t len),
+                         uint16_t (*read)(void *ctx, uint8_t *buf, uint16_t len, uint32_t timeout_ms),
+                         void *ctx, uint16_t window, uint8_t num, uint32_t times)
+{
+    uint8_t res;
+    uint8_t i;
+    uint8_t j;
+    uint8_t n;
+    uint8_t seg;
+    uint8_t k;
+    uint8_t data[16 * 6];
+    uint32_t t;
+    uint32_t start;
+    uint32_t us;
+    uint32_t sent;
+    uint32_t acked;
+    uint32_t errors;
+    tm1637_info_t info;
+    
+    /* check the param */
+    if ((num == 0) || (num > 16) || (times == 0))
+    {
+        tm1637_interface_debug_print("tm1637: param is invalid.\n");
+        
+        return 1;
+    }
+    
+    /* get information */
+    res = tm1637_info(&info);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: get info failed.\n");
+        
+        return 1;
+    }
+    else
+    {
+        /* print chip info */
+        tm1637_interface_debug_print("tm1637: chip is %s.\n", info.chip_name);
+        tm1637_interface_debug_print("tm1637: manufacturer is %s.\n", info.manufacturer_name);
+        tm1637_interface_debug_print("tm1637: interface is %s.\n", info.interface);
+        tm1637_interface_debug_print("tm1637: driver version is %d.%d.\n", info.driver_version / 1000, (info.driver_version % 1000) / 100);
+        tm1637_interface_debug_print("tm1637: min supply voltage is %0.1fV.\n", info.supply_voltage_min_v);
+        tm1637_interface_debug_print("tm1637: max supply voltage is %0.1fV.\n", info.supply_voltage_max_v);
+        tm1637_interface_debug_print("tm1637: max current is %0.2fmA.\n", info.max_current_ma);
+        tm1637_interface_debug_print("tm1637: max temperature is %0.1fC.\n", info.temperature_max);
+        tm1637_interface_debug_print("tm1637: min temperature is %0.1fC.\n", info.temperature_min);
+    }
+    
+    /* start link test */
+    tm1637_interface_debug_print("tm1637: start link test.\n");
+    
+    /* frame codec */
+    tm1637_interface_debug_print("tm1637: codec test.\n");
+    if (a_tm1637_link_test_codec() != 0)
+    {
+        return 1;
+    }
+    
+    /* link client init */
+    res = tm1637_link_client_init(&gs_client, write, read, ctx, window);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: link client init failed.\n");
+        
+        return 1;
+    }
+    
+    /* brightness of every display */
+    tm1637_interface_debug_print("tm1637: set display test.\n");
+    for (i = 0; i < num; i++)
+    {
+        res = tm1637_link_client_set_display(&gs_client, i, TM1637_BOOL_TRUE, TM1637_PULSE_WIDTH_14_DIV_16);
+        if (res != 0)
+        {
+            tm1637_interface_debug_print("tm1637: link set display failed.\n");
+            
+            return 1;
+        }
+    }
+    if (tm1637_link_client_sync(&gs_client) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: link sync failed.\n");
+        
+        return 1;
+    }
+    
+    /* one round trip per command */
+    tm1637_interface_debug_print("tm1637: round trip test.\n");
+    start = tm1637_interface_timestamp_us();
+    for (t = 0; t < times; t++)
+    {
+        for (i = 0; i < num; i++)
+        {
+            for (j = 0; j < 6; j++)
+            {
+                data[j] = gsc_number[(t + i + j) % 10];
+            }
+            res = tm1637_link_client_write_segment(&gs_client, i, 0, data, 6);
+            if ((res != 0) || (tm1637_link_client_sync(&gs_client) != 0))
+            {
+                tm1637_interface_debug_print("tm1637: link write segment failed.\n");
+                
+                return 1;
+            }
+        }
+    }
+    us = tm1637_interface_timestamp_us() - start;
+    tm1637_interface_debug_print("tm1637: %d round trip writes in %dus.\n", times * num, us);
+    
+    /* many commands in flight */
+    tm1637_interface_debug_print("tm1637: pipeline test.\n");
+    start = tm1637_interface_timestamp_us();
+    for (t = 0; t < times; t++)
+    {
+        for (i = 0; i < num; i++)
+        {
+            for (j = 0; j < 6; j++)
+            {
+                data[j] = gsc_number[(t + i + j) % 10];
+            }
+            res = tm1637_link_client_write_segment(&gs_client, i, 0, data, 6);
+            if (res != 0)
+            {
+                tm1637_interface_debug_print("tm1637: link write segment failed.\n");
+                
+                return 1;
+            }
+        }
+    }
+    if (tm1637_link_client_sync(&gs_client) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: link sync failed.\n");
+        
+        return 1;
+    }
+    us = tm1637_interface_timestamp_us() - start;
+    tm1637_interface_debug_print("tm1637: %d pipelined writes in %dus.\n", times * num, us);
+    
+    /* all displays in one frame */
+    tm1637_interface_debug_print("tm1637: bulk frame test.\n");
+    start = tm1637_interface_timestamp_us();
+    for (t = 0; t < times; t++)
+    {
+        for (i = 0; i < num; i++)
+        {
+            for (j = 0; j < 6; j++)
+            {
+                data[i * 6 + j] = gsc_number[(t + i + j) % 10];
+            }
+        }
+        for (i = 0; i < num; i = (uint8_t)(i + n))
+        {
+            n = (uint8_t)(num - i);
+            if (n > (TM1637_LINK_MAX_PAYLOAD - 1) / 6)
+            {
+                n = (TM1637_LINK_MAX_PAYLOAD - 1) / 6;
+            }
+            res = tm1637_link_client_write_frame(&gs_client, i, n, &data[i * 6]);
+            if (res != 0)
+            {
+                tm1637_interface_debug_print("tm1637: link write frame failed.\n");
+                
+                return 1;
+            }
+        }
+    }
+    if (tm1637_link_client_sync(&gs_client) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: link sync failed.\n");
+        
+        return 1;
+    }
+    us = tm1637_interface_timestamp_us() - start;
+    tm1637_interface_debug_print("tm1637: %d bulk frames of %d displays in %dus.\n", times, num, us);
+    
+    /* key reads block for their response */
+    tm1637_interface_debug_print("tm1637: read key test.\n");
+    for (i = 0; i < num; i++)
+    {
+        res = tm1637_link_client_read_key(&gs_client, i, &seg, &k);
+        if (res != 0)
+        {
+            tm1637_interface_debug_print("tm1637: link read key failed.\n");
+            
+            return 1;
+        }
+        tm1637_interface_debug_print("tm1637: display %d seg %d k %d.\n", i, seg, k);
+    }
+    
+    /* a failed command is reported by the next sync */
+    tm1637_interface_debug_print("tm1637: error report test.\n");
+    res = tm1637_link_client_write_segment(&gs_client, num, 0, data, 6);
+    if ((res != 0) || (tm1637_link_client_sync(&gs_client) != 1))
+    {
+        tm1637_interface_debug_print("tm1637: invalid display is not reported.\n");
+        
+        return 1;
+    }
+    if (tm1637_link_client_sync(&gs_client) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: sync status is not cleared.\n");
+        
+        return 1;
+    }
+    (void)tm1637_link_client_get_statistics(&gs_client, &sent, &acked, &errors);
+    tm1637_interface_debug_print("tm1637: link sent %d acked %d errors %d.\n", sent, acked, errors);
+    if ((sent != acked) || (errors != 1))
+    {
+        tm1637_interface_debug_print("tm1637: link statistics are wrong.\n");
+        
+        return 1;
+    }
+    
+    /* finish link test */
+    tm1637_interface_debug_print("tm1637: finish link test.\n");
+    
+    return 0;
+}
@@ -0,0 +1,457 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_mailbox_test.c
+ * @brief     driver tm1637 mailbox test source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+#include "driver_tm1637_mailbox_test.h"
+#include "driver_tm1637_mailbox.h"
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+#define MAILBOX_TEST_LOG         32            /**< max logged transactions */
+#define MAILBOX_TEST_TOP         120           /**< last value of every producer */
+
+/**
+ * @brief mailbox test producer structure definition
+ */
+typedef struct mailbox_test_producer_s
+{
+    pthread_t thread;            /**< thread */
+    uint8_t digit;               /**< owned digit */
+    uint32_t num;                /**< publish number */
+    uint32_t failed;             /**< failed publish number */
+} mailbox_test_producer_t;
+
+static tm1637_handle_t gs_handle;                                              /**< tm1637 handle */
+#if (TM1637_LINK_FUNCTION == 0)
+static tm1637_link_t gs_link;                                                  /**< tm1637 link */
+#endif
+static tm1637_mailbox_t gs_mailbox;                                            /**< tm1637 mailbox */
+static mailbox_test_producer_t gs_producer[TM1637_MAILBOX_MAX_PRODUCER];       /**< producers */
+static atomic_uint gs_done;                                                    /**< finished producer number */
+static uint8_t gs_ram[6];                                                      /**< chip ram seen on the bus */
+static uint8_t gs_addr;                                                        /**< chip address pointer */
+static uint8_t gs_log_cmd[MAILBOX_TEST_LOG];                                   /**< command byte of each logged transaction */
+static uint8_t gs_log_len[MAILBOX_TEST_LOG];                                   /**< payload length of each logged transaction */
+static uint32_t gs_log_num;                                                    /**< logged transaction number */
+static uint32_t gs_backwards;                                                  /**< digits which went backwards */
+
+/**
+ * @brief     mailbox test reverse a byte sent lsb first
+ * @param[in] data is the byte as sent
+ * @return    byte msb first like the datasheet
+ * @note      none
+ */
+static uint8_t a_mailbox_test_reverse(uint8_t data)
+{
+    uint8_t res = 0;
+    uint8_t i;
+    
+    for (i = 0; i < 8; i++)
+    {
+        res = (uint8_t)((res << 1) | ((data >> i) & 0x01));
+    }
+    
+    return res;
+}
+
+/**
+ * @brief     mailbox test write, log and update the chip ram
+ * @param[in] addr is the command byte
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic write failed
+ * @note      only the flusher writes, a digit owned by a producer must never go backwards
+ */
+static uint8_t a_mailbox_test_write(uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    uint8_t cmd;
+    uint8_t data;
+    uint16_t i;
+    
+    cmd = a_mailbox_test_reverse(addr);
+    if (gs_log_num < MAILBOX_TEST_LOG)
+    {
+        gs_log_cmd[gs_log_num] = cmd;
+        gs_log_len[gs_log_num] = (uint8_t)len;
+    }
+    gs_log_num++;
+    
+    /* address command with the digits */
+    if ((cmd & 0xC0) == 0xC0)
+    {
+        gs_addr = cmd & 0x07;
+        for (i = 0; (i < len) && (gs_addr < 6); i++)
+        {
+            data = a_mailbox_test_reverse(buf[i]);
+            if (data < gs_ram[gs_addr])
+            {
+                gs_backwards++;
+            }
+            gs_ram[gs_addr] = data;
+            gs_addr++;
+        }
+    }
+    
+    return tm1637_interface_iic_write_cmd_custom(addr, buf, len);
+}
+
+/**
+ * @brief     mailbox test check the logged transactions
+ * @param[in] *name points to the check name
+ * @param[in] *cmd points to the expected command bytes
+ * @param[in] *len points to the expected payload lengths
+ * @param[in] num is the expected transaction number
+ * @return    status code
+ *            - 0 success
+ *            - 1 check failed
+ * @note      the log is cleared after the check
+ */
+static uint8_t a_mailbox_test_check(const char *name, const uint8_t *cmd, const uint8_t *len, uint8_t num)
+{
+    uint8_t i;
+    
+    if (gs_log_num != num)
+    {
+        tm1637_interface_debug_print("tm1637: %s sent %d transactions instead of %d.\n", name, gs_log_num, num);
+        gs_log_num = 0;
+        
+        return 1;
+    }
+    for (i = 0; i < num; i++)
+    {
+        if ((gs_log_cmd[i] != cmd[i]) || (gs_log_len[i] != len[i]))
+        {
+            tm1637_interface_debug_print("tm1637: %s transaction %d is 0x%02X len %d instead of 0x%02X len %d.\n",
+                                         name, i, gs_log_cmd[i], gs_log_len[i], cmd[i], len[i]);
+            gs_log_num = 0;
+            
+            return 1;
+        }
+    }
+    gs_log_num = 0;
+    
+    return 0;
+}
+
+/**
+ * @brief  mailbox test the coalescing
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   none
+ */
+static uint8_t a_mailbox_test_coalesce(void)
+{
+    const uint8_t frame_cmd[2] = {0x40, 0xC0};
+    const uint8_t frame_len[2] = {0, 6};
+    const uint8_t digit_cmd[2] = {0x40, 0xC3};
+    const uint8_t digit_len[2] = {0, 1};
+    const uint8_t expect[6] = {1, 2, 9, 7, 5, 6};
+    uint8_t frame[6] = {1, 2, 3, 4, 5, 6};
+    uint8_t data;
+    uint32_t published;
+    uint32_t dropped;
+    
+    /* two publishes before a flush go out as one frame */
+    if (tm1637_mailbox_init(&gs_mailbox, &gs_handle) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: mailbox init failed.\n");
+        
+        return 1;
+    }
+    data = 9;
+    if ((tm1637_mailbox_publish(&gs_mailbox, 0, frame, 6) != 0) ||
+        (tm1637_mailbox_publish(&gs_mailbox, 2, &data, 1) != 0))
+    {
+        tm1637_interface_debug_print("tm1637: mailbox publish failed.\n");
+        
+        return 1;
+    }
+    gs_log_num = 0;
+    if (tm1637_mailbox_flush(&gs_mailbox) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: mailbox flush failed.\n");
+        
+        return 1;
+    }
+    if (a_mailbox_test_check("first flush", frame_cmd, frame_len, 2) != 0)
+    {
+        return 1;
+    }
+    
+    /* only the changed digit is sent */
+    data = 7;
+    if (tm1637_mailbox_publish(&gs_mailbox, 3, &data, 1) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: mailbox publish failed.\n");
+        
+        return 1;
+    }
+    if (tm1637_mailbox_flush(&gs_mailbox) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: mailbox flush failed.\n");
+        
+        return 1;
+    }
+    if (a_mailbox_test_check("digit flush", digit_cmd, digit_len, 2) != 0)
+    {
+        return 1;
+    }
+    if (memcmp(gs_ram, expect, 6) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: chip ram is %d %d %d %d %d %d.\n",
+                                     gs_ram[0], gs_ram[1], gs_ram[2], gs_ram[3], gs_ram[4], gs_ram[5]);
+        
+        return 1;
+    }
+    
+    /* an idle flush sends nothing */
+    if (tm1637_mailbox_flush(&gs_mailbox) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: mailbox flush failed.\n");
+        
+        return 1;
+    }
+    if (a_mailbox_test_check("idle flush", NULL, NULL, 0) != 0)
+    {
+        return 1;
+    }
+    
+    /* a range over the frame is refused */
+    if (tm1637_mailbox_publish(&gs_mailbox, 4, frame, 3) != 4)
+    {
+        tm1637_interface_debug_print("tm1637: mailbox range check failed.\n");
+        
+        return 1;
+    }
+    (void)tm1637_mailbox_get_statistics(&gs_mailbox, &published, &dropped);
+    if ((published != 3) || (dropped != 1))
+    {
+        tm1637_interface_debug_print("tm1637: mailbox published %d dropped %d instead of 3 1.\n", published, dropped);
+        
+        return 1;
+    }
+    tm1637_interface_debug_print("tm1637: check coalescing ok.\n");
+    
+    return 0;
+}
+
+/**
+ * @brief     mailbox test producer thread
+ * @param[in] *arg points to a producer
+ * @return    NULL
+ * @note      it publishes rising values of its own digit and yields after each one to interleave with the others
+ */
+static void *a_mailbox_test_producer(void *arg)
+{
+    mailbox_test_producer_t *self = (mailbox_test_producer_t *)arg;
+    uint32_t n;
+    uint8_t data;
+    
+    for (n = 1; n <= self->num; n++)
+    {
+        data = (uint8_t)((n * (uint64_t)MAILBOX_TEST_TOP) / self->num);
+        if (tm1637_mailbox_publish(&gs_mailbox, self->digit, &data, 1) != 0)
+        {
+            self->failed++;
+        }
+        (void)sched_yield();
+    }
+    (void)atomic_fetch_add(&gs_done, 1);
+    
+    return NULL;
+}
+
+/**
+ * @brief     mailbox test the producer threads
+ * @param[in] times is the publish number of each producer divided by 1000
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      none
+ */
+static uint8_t a_mailbox_test_thread(uint32_t times)
+{
+    uint8_t frame[6] = {0};
+    uint32_t flushes;
+    uint32_t published;
+    uint32_t dropped;
+    uint32_t failed;
+    uint8_t started;
+    uint8_t i;
+    
+    /* start from a blank frame */
+    if (tm1637_mailbox_init(&gs_mailbox, &gs_handle) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: mailbox init failed.\n");
+        
+        return 1;
+    }
+    if ((tm1637_mailbox_publish(&gs_mailbox, 0, frame, 6) != 0) || (tm1637_mailbox_flush(&gs_mailbox) != 0))
+    {
+        tm1637_interface_debug_print("tm1637: mailbox blank failed.\n");
+        
+        return 1;
+    }
+    atomic_init(&gs_done, 0);
+    gs_backwards = 0;
+    gs_log_num = 0;
+    
+    /* one producer per digit */
+    for (started = 0; started < TM1637_MAILBOX_MAX_PRODUCER; started++)
+    {
+        gs_producer[started].digit = started;
+        gs_producer[started].num = times * 1000;
+        gs_producer[started].failed = 0;
+        if (pthread_create(&gs_producer[started].thread, NULL, a_mailbox_test_producer, &gs_producer[started]) != 0)
+        {
+            tm1637_interface_debug_print("tm1637: create thread failed.\n");
+            
+            break;
+        }
+    }
+    
+    /* flush until every producer is done, then flush the last frame */
+    flushes = 0;
+    while (atomic_load(&gs_done) < started)
+    {
+        if (tm1637_mailbox_flush(&gs_mailbox) != 0)
+        {
+            tm1637_interface_debug_print("tm1637: mailbox flush failed.\n");
+        }
+        flushes++;
+        (void)sched_yield();
+    }
+    for (i = 0; i < started; i++)
+    {
+        (void)pthread_join(gs_producer[i].thread, NULL);
+    }
+    if ((started != TM1637_MAILBOX_MAX_PRODUCER) || (tm1637_mailbox_flush(&gs_mailbox) != 0))
+    {
+        return 1;
+    }
+    
+    /* check */
+    failed = 0;
+    for (i = 0; i < TM1637_MAILBOX_MAX_PRODUCER; i++)
+    {
+        failed += gs_producer[i].failed;
+        if (gs_ram[i] != MAILBOX_TEST_TOP)
+        {
+            tm1637_interface_debug_print("tm1637: digit %d ends at %d instead of %d.\n", i, gs_ram[i], MAILBOX_TEST_TOP);
+            
+            return 1;
+        }
+    }
+    (void)tm1637_mailbox_get_statistics(&gs_mailbox, &published, &dropped);
+    tm1637_interface_debug_print("tm1637: %d producers published %d frames, %d dropped, %d flushes, %d bus writes.\n",
+                                 TM1637_MAILBOX_MAX_PRODUCER, published - 1, dropped, flushes, gs_log_num / 2);
+    if ((failed != 0) || (published != TM1637_MAILBOX_MAX_PRODUCER * times * 1000 + 1) || (gs_backwards != 0))
+    {
+        tm1637_interface_debug_print("tm1637: %d publishes failed, %d digits went backwards.\n", failed, gs_backwards);
+        
+        return 1;
+    }
+    tm1637_interface_debug_print("tm1637: check producers ok.\n");
+    
+    return 0;
+}
+
+/**
+ * @brief     mailbox test
+ * @param[in] times is the publish number of each producer divided by 1000
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      it checks the coalescing of the publishes and the changed runs, then runs one producer
+ *            thread per digit against a flusher and checks that no digit is lost or goes backwards
+ */
+uint8_t tm1637_mailbox_test(uint32_t times)
+{
+    uint8_t res;
+    
+    /* link interface function */
+    DRIVER_TM1637_LINK_INIT(&gs_handle, tm1637_handle_t);
+#if (TM1637_LINK_FUNCTION == 0)
+    DRIVER_TM1637_LINK_FUNCTION(&gs_handle, &gs_link);
+#endif
+    DRIVER_TM1637_LINK_IIC_INIT(&gs_handle, tm1637_interface_iic_init);
+    DRIVER_TM1637_LINK_IIC_DEINIT(&gs_handle, tm1637_interface_iic_deinit);
+    DRIVER_TM1637_LINK_IIC_WRITE_COMMAND_CUSTOM(&gs_handle, a_mailbox_test_write);
+    DRIVER_TM1637_LINK_IIC_READ_COMMAND_CUSTOM(&gs_handle, tm1637_interface_iic_read_cmd_custom);
+    DRIVER_TM1637_LINK_DELAY_MS(&gs_handle, tm1637_interface_delay_ms);
+    DRIVER_TM1637_LINK_DEBUG_PRINT(&gs_handle, tm1637_interface_debug_print);
+    DRIVER_TM1637_LINK_TIMESTAMP_US(&gs_handle, tm1637_interface_timestamp_us);
+    DRIVER_TM1637_LINK_LOCK(&gs_handle, tm1637_interface_lock);
+    DRIVER_TM1637_LINK_UNLOCK(&gs_handle, tm1637_interface_unlock);
+    
+    /* start mailbox test */
+    tm1637_interface_debug_print("tm1637: start mailbox test.\n");
+    
+    /* tm1637 init */
+    res = tm1637_init(&gs_handle);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: init failed.\n");
+        
+        return 1;
+    }
+    
+    /* coalescing */
+    tm1637_interface_debug_print("tm1637: mailbox coalescing test.\n");
+    if (a_mailbox_test_coalesce() != 0)
+    {
+        (void)tm1637_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* producers */
+    tm1637_interface_debug_print("tm1637: mailbox producer test.\n");
+    if (a_mailbox_test_thread(times) != 0)
+    {
+        (void)tm1637_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* finish mailbox test */
+    tm1637_interface_debug_print("tm1637: finish mailbox test.\n");
+    (void)tm1637_deinit(&gs_handle);
+    
+    return 0;
+}
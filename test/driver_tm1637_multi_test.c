@@ -0,0 +1,213 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_multi_test.c
+ * @brief     driver tm1637 multi test source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+ 
+#include "driver_tm1637_multi_test.h"
+
+/**
+ * @brief shared interface ops
+ */
+static const tm1637_ops_t gc_ops =
+{
+    tm1637_interface_iic_init_ctx,
+    tm1637_interface_iic_deinit_ctx,
+    tm1637_interface_iic_write_cmd_custom_ctx,
+    tm1637_interface_iic_read_cmd_custom_ctx,
+    tm1637_interface_delay_ms_ctx,
+    tm1637_interface_timestamp_us_ctx,
+    tm1637_interface_lock_ctx,
+    tm1637_interface_unlock_ctx,
+};
+
+static tm1637_handle_t gs_handle[TM1637_MULTI_TEST_MAX_DISPLAY];        /**< tm1637 handles */
+static const uint8_t gsc_number[] = {TM1637_NUMBER_0, TM1637_NUMBER_1, TM1637_NUMBER_2,
+                                     TM1637_NUMBER_3, TM1637_NUMBER_4, TM1637_NUMBER_5,
+                                     TM1637_NUMBER_6, TM1637_NUMBER_7, TM1637_NUMBER_8,
+                                     TM1637_NUMBER_9};                  /**< number table */
+
+/**
+ * @brief     multi test close the opened displays
+ * @param[in] num is the opened display number
+ * @note      none
+ */
+static void a_tm1637_multi_test_close(uint8_t num)
+{
+    while (num != 0)
+    {
+        num--;
+        (void)tm1637_deinit(&gs_handle[num]);
+    }
+}
+
+/**
+ * @brief     multi test
+ * @param[in] **ctx points to a bus context array, display i is on ctx[i]
+ * @param[in] num is the display number
+ * @param[in] times is the test times
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      all handles stay open together, display i finally shows (times - 1 + i + digit) % 10
+ */
+uint8_t tm1637_multi_test(void **ctx, uint8_t num, uint32_t times)
+{
+    uint8_t res;
+    uint8_t i;
+    uint8_t j;
+    uint32_t t;
+    tm1637_info_t info;
+    
+    /* check the display number */
+    if ((ctx == NULL) || (num == 0) || (num > TM1637_MULTI_TEST_MAX_DISPLAY))
+    {
+        tm1637_interface_debug_print("tm1637: display number is invalid.\n");
+        
+        return 1;
+    }
+    
+    /* get information */
+    res = tm1637_info(&info);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: get info failed.\n");
+        
+        return 1;
+    }
+    else
+    {
+        /* print chip info */
+        tm1637_interface_debug_print("tm1637: chip is %s.\n", info.chip_name);
+        tm1637_interface_debug_print("tm1637: manufacturer is %s.\n", info.manufacturer_name);
+        tm1637_interface_debug_print("tm1637: interface is %s.\n", info.interface);
+        tm1637_interface_debug_print("tm1637: driver version is %d.%d.\n", info.driver_version / 1000, (info.driver_version % 1000) / 100);
+        tm1637_interface_debug_print("tm1637: min supply voltage is %0.1fV.\n", info.supply_voltage_min_v);
+        tm1637_interface_debug_print("tm1637: max supply voltage is %0.1fV.\n", info.supply_voltage_max_v);
+        tm1637_interface_debug_print("tm1637: max current is %0.2fmA.\n", info.max_current_ma);
+        tm1637_interface_debug_print("tm1637: max temperature is %0.1fC.\n", info.temperature_max);
+        tm1637_interface_debug_print("tm1637: min temperature is %0.1fC.\n", info.temperature_min);
+    }
+    
+    /* start multi test */
+    tm1637_interface_debug_print("tm1637: start multi test.\n");
+    tm1637_interface_debug_print("tm1637: %d displays share one ops table.\n", num);
+    
+    /* open every display */
+    for (i = 0; i < num; i++)
+    {
+        /* link the shared ops and the bus context */
+        DRIVER_TM1637_LINK_INIT(&gs_handle[i], tm1637_handle_t);
+        DRIVER_TM1637_LINK_OPS(&gs_handle[i], &gc_ops);
+        DRIVER_TM1637_LINK_CTX(&gs_handle[i], ctx[i]);
+        DRIVER_TM1637_LINK_DEBUG_PRINT(&gs_handle[i], tm1637_interface_debug_print);
+        
+        /* tm1637 init */
+        res = tm1637_init(&gs_handle[i]);
+        if (res != 0)
+        {
+            tm1637_interface_debug_print("tm1637: display %d init failed.\n", i);
+            a_tm1637_multi_test_close(i);
+            
+            return 1;
+        }
+        
+        /* set address mode inc */
+        res = tm1637_set_address_mode(&gs_handle[i], TM1637_ADDRESS_MODE_INC);
+        if (res != 0)
+        {
+            tm1637_interface_debug_print("tm1637: display %d set address mode failed.\n", i);
+            a_tm1637_multi_test_close(i + 1);
+            
+            return 1;
+        }
+        
+        /* enable display */
+        res = tm1637_set_display(&gs_handle[i], TM1637_BOOL_TRUE);
+        if (res != 0)
+        {
+            tm1637_interface_debug_print("tm1637: display %d set display failed.\n", i);
+            a_tm1637_multi_test_close(i + 1);
+            
+            return 1;
+        }
+    }
+    
+    for (t = 0; t < times; t++)
+    {
+        /* write a different number to every display */
+        for (i = 0; i < num; i++)
+        {
+            uint8_t data[6];
+            
+            for (j = 0; j < 6; j++)
+            {
+                data[j] = gsc_number[(t + i + j) % 10];
+            }
+            res = tm1637_write_segment(&gs_handle[i], 0x00, data, 6);
+            if (res != 0)
+            {
+                tm1637_interface_debug_print("tm1637: display %d write segment failed.\n", i);
+                a_tm1637_multi_test_close(num);
+                
+                return 1;
+            }
+        }
+        
+        /* read the keys of every display */
+        for (i = 0; i < num; i++)
+        {
+            uint8_t seg;
+            uint8_t k;
+            
+            res = tm1637_read_segment(&gs_handle[i], &seg, &k);
+            if (res != 0)
+            {
+                tm1637_interface_debug_print("tm1637: display %d read segment failed.\n", i);
+                a_tm1637_multi_test_close(num);
+                
+                return 1;
+            }
+            tm1637_interface_debug_print("tm1637: display %d seg: 0x%02X k: 0x%02X.\n", i, seg, k);
+        }
+        
+        /* delay 1000ms */
+        tm1637_interface_delay_ms(1000);
+    }
+    
+    /* finish multi test */
+    tm1637_interface_debug_print("tm1637: finish multi test.\n");
+    a_tm1637_multi_test_close(num);
+    
+    return 0;
+}
@@ -0,0 +1,207 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      driver_tm1637_parallel_test.c
+ * @brief     driver tm1637 parallel test source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_tm1637_parallel_test.h"
+#include <stdlib.h>
+
+static tm1637_parallel_t gs_parallel;        /**< tm1637 parallel structure */
+
+/**
+ * @brief     parallel test
+ * @param[in] modules is the module number
+ * @param[in] times is the test times
+ * @param[in] *key points to the pressed key data of every module, NULL only prints the keys
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      the seg and k of module m must decode from key[m]
+ */
+uint8_t tm1637_parallel_test(uint8_t modules, uint32_t times, const uint8_t *key)
+{
+    uint8_t res;
+    uint8_t i;
+    uint8_t m;
+    uint8_t b;
+    uint16_t nack;
+    uint16_t ref;
+    uint16_t word[8];
+    uint8_t lane[16];
+    uint8_t back[16];
+    uint8_t frame[TM1637_PARALLEL_MAX_MODULE][6];
+    uint8_t seg[TM1637_PARALLEL_MAX_MODULE];
+    uint8_t k[TM1637_PARALLEL_MAX_MODULE];
+    uint32_t t;
+    uint32_t start;
+    uint8_t number[] = {TM1637_NUMBER_0, TM1637_NUMBER_1, TM1637_NUMBER_2,
+                        TM1637_NUMBER_3, TM1637_NUMBER_4, TM1637_NUMBER_5,
+                        TM1637_NUMBER_6, TM1637_NUMBER_7, TM1637_NUMBER_8, TM1637_NUMBER_9};
+    
+    /* link interface function */
+    DRIVER_TM1637_PARALLEL_LINK_INIT(&gs_parallel, tm1637_parallel_t);
+    DRIVER_TM1637_PARALLEL_LINK_PORT_INIT(&gs_parallel, tm1637_interface_parallel_port_init);
+    DRIVER_TM1637_PARALLEL_LINK_PORT_DEINIT(&gs_parallel, tm1637_interface_parallel_port_deinit);
+    DRIVER_TM1637_PARALLEL_LINK_CLK_WRITE(&gs_parallel, tm1637_interface_parallel_clk_write);
+    DRIVER_TM1637_PARALLEL_LINK_DIO_WRITE(&gs_parallel, tm1637_interface_parallel_dio_write);
+    DRIVER_TM1637_PARALLEL_LINK_DIO_READ(&gs_parallel, tm1637_interface_parallel_dio_read);
+    DRIVER_TM1637_PARALLEL_LINK_DELAY_US(&gs_parallel, tm1637_interface_delay_us);
+    DRIVER_TM1637_PARALLEL_LINK_DEBUG_PRINT(&gs_parallel, tm1637_interface_debug_print);
+    
+    /* start parallel test */
+    tm1637_interface_debug_print("tm1637: start parallel test.\n");
+    
+    /* transpose test */
+    tm1637_interface_debug_print("tm1637: transpose test.\n");
+    for (t = 0; t < 256; t++)
+    {
+        for (m = 0; m < 16; m++)
+        {
+            lane[m] = (uint8_t)(rand() % 256);
+        }
+        tm1637_parallel_transpose(lane, word);
+        tm1637_parallel_detranspose(word, back);
+        if (memcmp(lane, back, 16) != 0)
+        {
+            tm1637_interface_debug_print("tm1637: detranspose check failed.\n");
+            
+            return 1;
+        }
+        for (b = 0; b < 8; b++)
+        {
+            ref = 0;
+            for (m = 0; m < 16; m++)
+            {
+                ref |= (uint16_t)(((lane[m] >> b) & 0x01) << m);
+            }
+            if (ref != word[b])
+            {
+                tm1637_interface_debug_print("tm1637: transpose check failed.\n");
+                
+                return 1;
+            }
+        }
+    }
+    tm1637_interface_debug_print("tm1637: check transpose ok.\n");
+    
+    /* parallel init */
+    res = tm1637_parallel_init(&gs_parallel, modules, 0);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: parallel init failed.\n");
+        
+        return 1;
+    }
+    
+    /* enable display */
+    res = tm1637_parallel_set_display(&gs_parallel, TM1637_BOOL_TRUE, TM1637_PULSE_WIDTH_14_DIV_16, &nack);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: set display failed.\n");
+        (void)tm1637_parallel_deinit(&gs_parallel);
+        
+        return 1;
+    }
+    
+    /* write segment test */
+    tm1637_interface_debug_print("tm1637: %d modules write segment test.\n", modules);
+    for (t = 0; t < times; t++)
+    {
+        for (m = 0; m < modules; m++)
+        {
+            for (i = 0; i < 6; i++)
+            {
+                frame[m][i] = number[(t + m + i) % 10];
+            }
+        }
+        start = tm1637_interface_timestamp_us();
+        res = tm1637_parallel_write_segment(&gs_parallel, 0x00, frame, 6, &nack);
+        if (res != 0)
+        {
+            tm1637_interface_debug_print("tm1637: write segment failed, no ack 0x%04X.\n", nack);
+            (void)tm1637_parallel_deinit(&gs_parallel);
+            
+            return 1;
+        }
+        tm1637_interface_debug_print("tm1637: refresh %d modules in %dus.\n", modules,
+                                     tm1637_interface_timestamp_us() - start);
+        
+        /* delay 1000ms */
+        tm1637_interface_delay_ms(1000);
+    }
+    
+    /* read segment test */
+    tm1637_interface_debug_print("tm1637: %d modules read segment test.\n", modules);
+    for (t = 0; t < times; t++)
+    {
+        start = tm1637_interface_timestamp_us();
+        res = tm1637_parallel_read_segment(&gs_parallel, seg, k, &nack);
+        if (res != 0)
+        {
+            tm1637_interface_debug_print("tm1637: read segment failed, no ack 0x%04X.\n", nack);
+            (void)tm1637_parallel_deinit(&gs_parallel);
+            
+            return 1;
+        }
+        tm1637_interface_debug_print("tm1637: scan %d modules in %dus.\n", modules,
+                                     tm1637_interface_timestamp_us() - start);
+        for (m = 0; m < modules; m++)
+        {
+            tm1637_interface_debug_print("tm1637: module %d seg: 0x%02X k: 0x%02X.\n", m, seg[m], k[m]);
+            
+            /* check the key of this module */
+            if ((key != NULL) && ((seg[m] != (key[m] & 0x07)) || (k[m] != ((key[m] >> 3) & 0x03))))
+            {
+                tm1637_interface_debug_print("tm1637: module %d key should be seg: 0x%02X k: 0x%02X.\n",
+                                             m, key[m] & 0x07, (key[m] >> 3) & 0x03);
+                (void)tm1637_parallel_deinit(&gs_parallel);
+                
+                return 1;
+            }
+        }
+        if (key != NULL)
+        {
+            tm1637_interface_debug_print("tm1637: check %d module keys ok.\n", modules);
+        }
+        
+        /* delay 1000ms */
+        tm1637_interface_delay_ms(1000);
+    }
+    
+    /* finish parallel test */
+    tm1637_interface_debug_print("tm1637: finish parallel test.\n");
+    (void)tm1637_parallel_deinit(&gs_parallel);
+    
+    return 0;
+}
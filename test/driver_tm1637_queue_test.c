@@ -0,0 +1,602 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_queue_test.c
+ * @brief     driver tm1637 queue test source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+#include "driver_tm1637_queue_test.h"
+#include "driver_tm1637_queue.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#define QUEUE_TEST_LOG             32            /**< max logged transactions */
+#define QUEUE_TEST_TOP             120           /**< last value of every producer */
+#define QUEUE_TEST_PRODUCER        4             /**< producer threads */
+#define QUEUE_TEST_FAIL_EVERY      7             /**< one failed run of 7 in the thread test */
+
+/**
+ * @brief queue test producer structure definition
+ */
+typedef struct queue_test_producer_s
+{
+    pthread_t thread;            /**< thread */
+    uint8_t digit;               /**< owned digit */
+    uint32_t num;                /**< push number */
+    uint32_t full;               /**< full queue retry number */
+} queue_test_producer_t;
+
+static tm1637_handle_t gs_handle;                                       /**< tm1637 handle */
+#if (TM1637_LINK_FUNCTION == 0)
+static tm1637_link_t gs_link;                                           /**< tm1637 link */
+#endif
+static tm1637_queue_t gs_queue;                                         /**< tm1637 queue */
+static queue_test_producer_t gs_producer[QUEUE_TEST_PRODUCER];          /**< producers */
+static atomic_uint gs_done;                                             /**< finished producer number */
+static uint8_t gs_ram[6];                                               /**< chip ram seen on the bus */
+static uint8_t gs_log_cmd[QUEUE_TEST_LOG];                              /**< command byte of each logged transaction */
+static uint8_t gs_log_len[QUEUE_TEST_LOG];                              /**< payload length of each logged transaction */
+static uint32_t gs_log_num;                                             /**< logged transaction number */
+static uint32_t gs_backwards;                                           /**< digits which went backwards */
+static uint32_t gs_fail_every;                                          /**< fail one run of n, 0 never fails */
+static uint32_t gs_runs;                                                /**< written run number */
+
+/**
+ * @brief     queue test reverse a byte sent lsb first
+ * @param[in] data is the byte as sent
+ * @return    byte msb first like the datasheet
+ * @note      none
+ */
+static uint8_t a_queue_test_reverse(uint8_t data)
+{
+    uint8_t res = 0;
+    uint8_t i;
+    
+    for (i = 0; i < 8; i++)
+    {
+        res = (uint8_t)((res << 1) | ((data >> i) & 0x01));
+    }
+    
+    return res;
+}
+
+/**
+ * @brief     queue test print
+ * @param[in] fmt is the format data
+ * @note      the driver prints of the failed runs are dropped while runs fail on purpose
+ */
+static void a_queue_test_print(const char *const fmt, ...)
+{
+    char str[256];
+    va_list args;
+    
+    if (gs_fail_every != 0)
+    {
+        return;
+    }
+    va_start(args, fmt);
+    (void)vsnprintf(str, sizeof(str), fmt, args);
+    va_end(args);
+    tm1637_interface_debug_print("%s", str);
+}
+
+/**
+ * @brief     queue test write, log and update the chip ram
+ * @param[in] addr is the command byte
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic write failed
+ * @note      a run may be failed on purpose and then leaves the chip ram alone
+ */
+static uint8_t a_queue_test_write(uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    uint8_t cmd;
+    uint8_t data;
+    uint8_t pos;
+    uint16_t i;
+    
+    cmd = a_queue_test_reverse(addr);
+    if (gs_log_num < QUEUE_TEST_LOG)
+    {
+        gs_log_cmd[gs_log_num] = cmd;
+        gs_log_len[gs_log_num] = (uint8_t)len;
+    }
+    gs_log_num++;
+    
+    /* address command with the digits */
+    if ((cmd & 0xC0) == 0xC0)
+    {
+        gs_runs++;
+        if ((gs_fail_every != 0) && ((gs_runs % gs_fail_every) == 0))
+        {
+            return 1;
+        }
+        pos = cmd & 0x07;
+        for (i = 0; (i < len) && (pos < 6); i++)
+        {
+            data = a_queue_test_reverse(buf[i]);
+            if (data < gs_ram[pos])
+            {
+                gs_backwards++;
+            }
+            gs_ram[pos] = data;
+            pos++;
+        }
+    }
+    
+    return tm1637_interface_iic_write_cmd_custom(addr, buf, len);
+}
+
+/**
+ * @brief     queue test check the logged transactions
+ * @param[in] *name points to the check name
+ * @param[in] *cmd points to the expected command bytes
+ * @param[in] *len points to the expected payload lengths
+ * @param[in] num is the expected transaction number
+ * @return    status code
+ *            - 0 success
+ *            - 1 check failed
+ * @note      the log is cleared after the check
+ */
+static uint8_t a_queue_test_check(const char *name, const uint8_t *cmd, const uint8_t *len, uint8_t num)
+{
+    uint8_t i;
+    
+    if (gs_log_num != num)
+    {
+        tm1637_interface_debug_print("tm1637: %s sent %d transactions instead of %d.\n", name, gs_log_num, num);
+        gs_log_num = 0;
+        
+        return 1;
+    }
+    for (i = 0; i < num; i++)
+    {
+        if ((gs_log_cmd[i] != cmd[i]) || (gs_log_len[i] != len[i]))
+        {
+            tm1637_interface_debug_print("tm1637: %s transaction %d is 0x%02X len %d instead of 0x%02X len %d.\n",
+                                         name, i, gs_log_cmd[i], gs_log_len[i], cmd[i], len[i]);
+            gs_log_num = 0;
+            
+            return 1;
+        }
+    }
+    gs_log_num = 0;
+    
+    return 0;
+}
+
+/**
+ * @brief     queue test push one digit
+ * @param[in] digit is the digit address
+ * @param[in] value is the digit value
+ * @return    status code of tm1637_queue_push
+ * @note      none
+ */
+static uint8_t a_queue_test_push(uint8_t digit, uint8_t value)
+{
+    uint8_t data[6] = {0};
+    
+    data[digit] = value;
+    
+    return tm1637_queue_push(&gs_queue, (uint8_t)(1 << digit), data);
+}
+
+/**
+ * @brief     queue test flush and check the drained update number and the transactions
+ * @param[in] *name points to the check name
+ * @param[in] res is the expected flush status
+ * @param[in] drained is the expected drained update number
+ * @param[in] *cmd points to the expected command bytes
+ * @param[in] *len points to the expected payload lengths
+ * @param[in] num is the expected transaction number
+ * @return    status code
+ *            - 0 success
+ *            - 1 check failed
+ * @note      none
+ */
+static uint8_t a_queue_test_flush(const char *name, uint8_t res, uint16_t drained,
+                                  const uint8_t *cmd, const uint8_t *len, uint8_t num)
+{
+    uint16_t count;
+    uint8_t ret;
+    
+    ret = tm1637_queue_flush(&gs_queue, &count);
+    if ((ret != res) || (count != drained))
+    {
+        tm1637_interface_debug_print("tm1637: %s flush returned %d with %d updates instead of %d with %d.\n",
+                                     name, ret, count, res, drained);
+        gs_log_num = 0;
+        
+        return 1;
+    }
+    
+    return a_queue_test_check(name, cmd, len, num);
+}
+
+/**
+ * @brief  queue test the merge, the full queue and the retry
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   none
+ */
+static uint8_t a_queue_test_merge(void)
+{
+    const uint8_t merge_cmd[2] = {0x40, 0xC0};
+    const uint8_t merge_len[2] = {0, 2};
+    const uint8_t last_cmd[2] = {0x40, 0xC5};
+    const uint8_t last_len[2] = {0, 1};
+    const uint8_t gap_cmd[2] = {0x40, 0xC2};
+    const uint8_t gap_len[2] = {0, 3};
+    const uint8_t bridge_cmd[2] = {0x40, 0xC0};
+    const uint8_t bridge_len[2] = {0, 6};
+    const uint8_t retry_cmd[2] = {0x40, 0xC2};
+    const uint8_t retry_len[2] = {0, 1};
+    const uint8_t full_cmd[2] = {0x40, 0xC1};
+    const uint8_t expect[6] = {10, 2, 11, 5, 8, 12};
+    uint8_t data[6] = {0};
+    uint32_t merged;
+    uint32_t transmitted;
+    uint32_t full;
+    uint32_t i;
+    
+    if (tm1637_queue_init(&gs_queue, &gs_handle) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: queue init failed.\n");
+        
+        return 1;
+    }
+    gs_fail_every = 0;
+    gs_log_num = 0;
+    
+    /* three updates of two digits go out as one run with the latest values */
+    if ((a_queue_test_push(0, 1) != 0) || (a_queue_test_push(1, 2) != 0) || (a_queue_test_push(0, 3) != 0))
+    {
+        tm1637_interface_debug_print("tm1637: queue push failed.\n");
+        
+        return 1;
+    }
+    if (a_queue_test_flush("merge", 0, 3, merge_cmd, merge_len, 2) != 0)
+    {
+        return 1;
+    }
+    
+    /* a digit after unknown ones is not bridged */
+    if (a_queue_test_push(5, 6) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: queue push failed.\n");
+        
+        return 1;
+    }
+    if (a_queue_test_flush("last digit", 0, 1, last_cmd, last_len, 2) != 0)
+    {
+        return 1;
+    }
+    data[2] = 4;
+    data[3] = 5;
+    data[4] = 8;
+    if (tm1637_queue_push(&gs_queue, 0x1C, data) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: queue push failed.\n");
+        
+        return 1;
+    }
+    if (a_queue_test_flush("gap", 0, 1, gap_cmd, gap_len, 2) != 0)
+    {
+        return 1;
+    }
+    
+    /* the first and the last digit are bridged by the sent ones */
+    if ((a_queue_test_push(0, 10) != 0) || (a_queue_test_push(5, 12) != 0))
+    {
+        tm1637_interface_debug_print("tm1637: queue push failed.\n");
+        
+        return 1;
+    }
+    if (a_queue_test_flush("bridge", 0, 2, bridge_cmd, bridge_len, 2) != 0)
+    {
+        return 1;
+    }
+    
+    /* a failed flush keeps the digit and the next flush sends it without a new update */
+    if (a_queue_test_push(2, 11) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: queue push failed.\n");
+        
+        return 1;
+    }
+    gs_fail_every = 1;
+    if (a_queue_test_flush("failed flush", 1, 1, retry_cmd, retry_len, 2) != 0)
+    {
+        return 1;
+    }
+    gs_fail_every = 0;
+    if (a_queue_test_flush("retry", 0, 0, retry_cmd, retry_len, 2) != 0)
+    {
+        return 1;
+    }
+    if (a_queue_test_flush("idle", 0, 0, NULL, NULL, 0) != 0)
+    {
+        return 1;
+    }
+    if (memcmp(gs_ram, expect, 6) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: chip ram is %d %d %d %d %d %d.\n",
+                                     gs_ram[0], gs_ram[1], gs_ram[2], gs_ram[3], gs_ram[4], gs_ram[5]);
+        
+        return 1;
+    }
+    tm1637_interface_debug_print("tm1637: check merge and retry ok.\n");
+    
+    /* a full queue refuses the update, an invalid mask is refused */
+    for (i = 0; i < TM1637_QUEUE_DEPTH; i++)
+    {
+        if (a_queue_test_push(1, (uint8_t)(20 + i)) != 0)
+        {
+            tm1637_interface_debug_print("tm1637: queue push failed.\n");
+            
+            return 1;
+        }
+    }
+    if ((a_queue_test_push(1, 99) != 5) || (tm1637_queue_push(&gs_queue, 0, data) != 4) ||
+        (tm1637_queue_push(&gs_queue, 0x40, data) != 4))
+    {
+        tm1637_interface_debug_print("tm1637: queue full or mask check failed.\n");
+        
+        return 1;
+    }
+    if (a_queue_test_flush("full", 0, TM1637_QUEUE_DEPTH, full_cmd, retry_len, 2) != 0)
+    {
+        return 1;
+    }
+    (void)tm1637_queue_get_statistics(&gs_queue, &merged, &transmitted, &full);
+    if ((merged != 8 + TM1637_QUEUE_DEPTH) || (transmitted != 6) || (full != 1))
+    {
+        tm1637_interface_debug_print("tm1637: queue merged %d transmitted %d full %d.\n", merged, transmitted, full);
+        
+        return 1;
+    }
+    tm1637_interface_debug_print("tm1637: check full queue ok.\n");
+    
+    return 0;
+}
+
+/**
+ * @brief     queue test producer thread
+ * @param[in] *arg points to a producer
+ * @return    NULL
+ * @note      it pushes rising values of its own digit and yields after each one to interleave with the others
+ */
+static void *a_queue_test_producer(void *arg)
+{
+    queue_test_producer_t *self = (queue_test_producer_t *)arg;
+    uint32_t n;
+    uint8_t value;
+    
+    for (n = 1; n <= self->num; n++)
+    {
+        value = (uint8_t)((n * (uint64_t)QUEUE_TEST_TOP) / self->num);
+        while (a_queue_test_push(self->digit, value) == 5)
+        {
+            self->full++;
+            (void)sched_yield();
+        }
+        (void)sched_yield();
+    }
+    (void)atomic_fetch_add(&gs_done, 1);
+    
+    return NULL;
+}
+
+/**
+ * @brief     queue test the producer threads
+ * @param[in] times is the push number of each producer divided by 1000
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      none
+ */
+static uint8_t a_queue_test_thread(uint32_t times)
+{
+    uint8_t frame[6] = {0};
+    uint32_t flushes;
+    uint32_t failed;
+    uint32_t merged;
+    uint32_t transmitted;
+    uint32_t full;
+    uint32_t retry;
+    uint16_t count;
+    uint8_t started;
+    uint8_t i;
+    
+    /* start from a blank frame */
+    if (tm1637_queue_init(&gs_queue, &gs_handle) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: queue init failed.\n");
+        
+        return 1;
+    }
+    gs_fail_every = 0;
+    if ((tm1637_queue_push(&gs_queue, 0x3F, frame) != 0) || (tm1637_queue_flush(&gs_queue, NULL) != 0))
+    {
+        tm1637_interface_debug_print("tm1637: queue blank failed.\n");
+        
+        return 1;
+    }
+    atomic_init(&gs_done, 0);
+    gs_backwards = 0;
+    gs_log_num = 0;
+    gs_runs = 0;
+    gs_fail_every = QUEUE_TEST_FAIL_EVERY;
+    
+    /* one producer per digit */
+    for (started = 0; started < QUEUE_TEST_PRODUCER; started++)
+    {
+        gs_producer[started].digit = started;
+        gs_producer[started].num = times * 1000;
+        gs_producer[started].full = 0;
+        if (pthread_create(&gs_producer[started].thread, NULL, a_queue_test_producer, &gs_producer[started]) != 0)
+        {
+            tm1637_interface_debug_print("tm1637: create thread failed.\n");
+            
+            break;
+        }
+    }
+    
+    /* flush until every producer is done, a failed flush is retried by the next one */
+    flushes = 0;
+    failed = 0;
+    while (atomic_load(&gs_done) < started)
+    {
+        if (tm1637_queue_flush(&gs_queue, NULL) != 0)
+        {
+            failed++;
+        }
+        flushes++;
+        (void)sched_yield();
+    }
+    for (i = 0; i < started; i++)
+    {
+        (void)pthread_join(gs_producer[i].thread, NULL);
+    }
+    if (started != QUEUE_TEST_PRODUCER)
+    {
+        return 1;
+    }
+    
+    /* drain the rest, the retries go on until a flush succeeds */
+    do
+    {
+        if (tm1637_queue_flush(&gs_queue, &count) != 0)
+        {
+            failed++;
+            count = 1;
+        }
+        flushes++;
+    } while (count != 0);
+    gs_fail_every = 0;
+    
+    /* check */
+    retry = 0;
+    for (i = 0; i < QUEUE_TEST_PRODUCER; i++)
+    {
+        retry += gs_producer[i].full;
+        if (gs_ram[i] != QUEUE_TEST_TOP)
+        {
+            tm1637_interface_debug_print("tm1637: digit %d ends at %d instead of %d.\n", i, gs_ram[i], QUEUE_TEST_TOP);
+            
+            return 1;
+        }
+    }
+    (void)tm1637_queue_get_statistics(&gs_queue, &merged, &transmitted, &full);
+    tm1637_interface_debug_print("tm1637: %d producers pushed %d updates, %d full retries, %d flushes, %d sent, %d failed.\n",
+                                 QUEUE_TEST_PRODUCER, merged - 1, retry, flushes, transmitted - 1, failed);
+    if ((merged != QUEUE_TEST_PRODUCER * times * 1000 + 1) || (full != retry) || (gs_backwards != 0))
+    {
+        tm1637_interface_debug_print("tm1637: %d digits went backwards.\n", gs_backwards);
+        
+        return 1;
+    }
+    tm1637_interface_debug_print("tm1637: check producers ok.\n");
+    
+    return 0;
+}
+
+/**
+ * @brief     queue test
+ * @param[in] times is the push number of each producer divided by 1000
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      it checks the merge of the updates, the bridged run, the full queue and the retry of a failed flush,
+ *            then runs producer threads against a flusher whose bus fails now and then and checks that no digit
+ *            is lost or goes backwards
+ */
+uint8_t tm1637_queue_test(uint32_t times)
+{
+    uint8_t res;
+    
+    /* link interface function */
+    DRIVER_TM1637_LINK_INIT(&gs_handle, tm1637_handle_t);
+#if (TM1637_LINK_FUNCTION == 0)
+    DRIVER_TM1637_LINK_FUNCTION(&gs_handle, &gs_link);
+#endif
+    DRIVER_TM1637_LINK_IIC_INIT(&gs_handle, tm1637_interface_iic_init);
+    DRIVER_TM1637_LINK_IIC_DEINIT(&gs_handle, tm1637_interface_iic_deinit);
+    DRIVER_TM1637_LINK_IIC_WRITE_COMMAND_CUSTOM(&gs_handle, a_queue_test_write);
+    DRIVER_TM1637_LINK_IIC_READ_COMMAND_CUSTOM(&gs_handle, tm1637_interface_iic_read_cmd_custom);
+    DRIVER_TM1637_LINK_DELAY_MS(&gs_handle, tm1637_interface_delay_ms);
+    DRIVER_TM1637_LINK_DEBUG_PRINT(&gs_handle, a_queue_test_print);
+    DRIVER_TM1637_LINK_TIMESTAMP_US(&gs_handle, tm1637_interface_timestamp_us);
+    DRIVER_TM1637_LINK_LOCK(&gs_handle, tm1637_interface_lock);
+    DRIVER_TM1637_LINK_UNLOCK(&gs_handle, tm1637_interface_unlock);
+    
+    /* start queue test */
+    tm1637_interface_debug_print("tm1637: start queue test.\n");
+    
+    /* tm1637 init */
+    res = tm1637_init(&gs_handle);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: init failed.\n");
+        
+        return 1;
+    }
+    
+    /* merge */
+    tm1637_interface_debug_print("tm1637: queue merge test.\n");
+    if (a_queue_test_merge() != 0)
+    {
+        (void)tm1637_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* producers */
+    tm1637_interface_debug_print("tm1637: queue producer test.\n");
+    if (a_queue_test_thread(times) != 0)
+    {
+        (void)tm1637_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* finish queue test */
+    tm1637_interface_debug_print("tm1637: finish queue test.\n");
+    (void)tm1637_deinit(&gs_handle);
+    
+    return 0;
+}
@@ -38,6 +38,9 @@
 #include <stdlib.h>
 
 static tm1637_handle_t gs_handle;        /**< tm1637 handle */
+#if (TM1637_LINK_FUNCTION == 0)
+static tm1637_link_t gs_link;            /**< tm1637 link */
+#endif
 
 /**
  * @brief     read test
@@ -55,12 +58,18 @@ uint8_t tm1637_read_test(uint32_t times)
 
     /* link interface function */
     DRIVER_TM1637_LINK_INIT(&gs_handle, tm1637_handle_t); 
+#if (TM1637_LINK_FUNCTION == 0)
+    DRIVER_TM1637_LINK_FUNCTION(&gs_handle, &gs_link);
+#endif
     DRIVER_TM1637_LINK_IIC_INIT(&gs_handle, tm1637_interface_iic_init);
     DRIVER_TM1637_LINK_IIC_DEINIT(&gs_handle, tm1637_interface_iic_deinit);
     DRIVER_TM1637_LINK_IIC_WRITE_COMMAND_CUSTOM(&gs_handle, tm1637_interface_iic_write_cmd_custom);
     DRIVER_TM1637_LINK_IIC_READ_COMMAND_CUSTOM(&gs_handle, tm1637_interface_iic_read_cmd_custom);
     DRIVER_TM1637_LINK_DELAY_MS(&gs_handle, tm1637_interface_delay_ms);
     DRIVER_TM1637_LINK_DEBUG_PRINT(&gs_handle, tm1637_interface_debug_print);
+    DRIVER_TM1637_LINK_TIMESTAMP_US(&gs_handle, tm1637_interface_timestamp_us);
+    DRIVER_TM1637_LINK_LOCK(&gs_handle, tm1637_interface_lock);
+    DRIVER_TM1637_LINK_UNLOCK(&gs_handle, tm1637_interface_unlock);
     
     /* get information */
     res = tm1637_info(&info);
@@ -0,0 +1,346 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_remote_test.c
+ * @brief     driver tm1637 remote test source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_tm1637_remote_test.h"
+
+/**
+ * @brief remote interface ops
+ */
+static const tm1637_ops_t gc_ops =
+{
+    tm1637_remote_iic_init,
+    tm1637_remote_iic_deinit,
+    tm1637_remote_iic_write_cmd_custom,
+    tm1637_remote_iic_read_cmd_custom,
+    tm1637_interface_delay_ms_ctx,
+    tm1637_interface_timestamp_us_ctx,
+    NULL,
+    NULL,
+};
+
+static tm1637_link_client_t gs_client;                                  /**< link client */
+static tm1637_remote_t gs_remote[16];                                   /**< remote displays */
+static tm1637_handle_t gs_handle[16];                                   /**< tm1637 handles */
+static uint8_t (*gs_write)(void *ctx, uint8_t *buf, uint16_t len);      /**< transport write */
+static uint32_t gs_writes;                                              /**< transport write counter */
+static const uint8_t gsc_number[] = {TM1637_NUMBER_0, TM1637_NUMBER_1, TM1637_NUMBER_2,
+                                     TM1637_NUMBER_3, TM1637_NUMBER_4, TM1637_NUMBER_5,
+                                     TM1637_NUMBER_6, TM1637_NUMBER_7, TM1637_NUMBER_8,
+                                     TM1637_NUMBER_9};                  /**< number table */
+
+/**
+ * @brief     remote test count the transport writes
+ * @param[in] *ctx is the transport context
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+static uint8_t a_tm1637_remote_test_write(void *ctx, uint8_t *buf, uint16_t len)
+{
+    gs_writes++;
+    
+    return gs_write(ctx, buf, len);
+}
+
+/**
+ * @brief     remote test close the opened displays
+ * @param[in] num is the opened display number
+ * @note      none
+ */
+static void a_tm1637_remote_test_close(uint8_t num)
+{
+    while (num != 0)
+    {
+        num--;
+        (void)tm1637_deinit(&gs_handle[num]);
+    }
+}
+
+/**
+ * @brief     remote test write all displays
+ * @param[in] num is the display number
+ * @param[in] times is the test times
+ * @param[in] round_trip is 1 when every call waits for the bridge
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      none
+ */
+static uint8_t a_tm1637_remote_test_write_all(uint8_t num, uint32_t times, uint8_t round_trip)
+{
+    uint8_t i;
+    uint8_t j;
+    uint8_t data[6];
+    uint32_t t;
+    uint32_t start;
+    uint32_t us;
+    uint32_t sent;
+    uint32_t acked;
+    uint32_t errors;
+    uint32_t frames;
+    uint32_t writes;
+    
+    (void)tm1637_link_client_get_statistics(&gs_client, &frames, &acked, &errors);
+    writes = gs_writes;
+    start = tm1637_interface_timestamp_us();
+    for (t = 0; t < times; t++)
+    {
+        for (i = 0; i < num; i++)
+        {
+            for (j = 0; j < 6; j++)
+            {
+                data[j] = gsc_number[(t + i + j) % 10];
+            }
+            if (tm1637_write_segment(&gs_handle[i], 0, data, 6) != 0)
+            {
+                tm1637_interface_debug_print("tm1637: write segment failed.\n");
+                
+                return 1;
+            }
+            if ((round_trip != 0) && (tm1637_remote_sync(&gs_remote[i]) != 0))
+            {
+                tm1637_interface_debug_print("tm1637: remote sync failed.\n");
+                
+                return 1;
+            }
+        }
+    }
+    if (tm1637_remote_sync(&gs_remote[0]) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: remote sync failed.\n");
+        
+        return 1;
+    }
+    us = tm1637_interface_timestamp_us() - start;
+    (void)tm1637_link_client_get_statistics(&gs_client, &sent, &acked, &errors);
+    tm1637_interface_debug_print("tm1637: %d writes, %d link frames, %d uart writes in %dus.\n",
+                                 times * num, sent - frames, gs_writes - writes, us);
+    
+    return 0;
+}
+
+/**
+ * @brief     remote test
+ * @param[in] *write points to a byte write function address
+ * @param[in] *read points to a byte read function address
+ * @param[in] *ctx is the transport context
+ * @param[in] window is the max in flight byte number
+ * @param[in] num is the display number of the bridge
+ * @param[in] times is the test times
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      display i finally shows (times - 1 + i + digit) % 10 at 14/16 and is off after the deinit
+ */
+uint8_t tm1637_remote_test(uint8_t (*write)(void *ctx, uint8_t *buf, uint16_t len),
+                           uint16_t (*read)(void *ctx, uint8_t *buf, uint16_t len, uint32_t timeout_ms),
+                           void *ctx, uint16_t window, uint8_t num, uint32_t times)
+{
+    uint8_t res;
+    uint8_t i;
+    uint8_t seg;
+    uint8_t k;
+    uint8_t data[6];
+    uint32_t sent;
+    uint32_t acked;
+    uint32_t errors;
+    tm1637_info_t info;
+    
+    /* check the param */
+    if ((write == NULL) || (read == NULL) || (num == 0) || (num > 16) || (times == 0))
+    {
+        tm1637_interface_debug_print("tm1637: param is invalid.\n");
+        
+        return 1;
+    }
+    
+    /* get information */
+    res = tm1637_info(&info);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: get info failed.\n");
+        
+        return 1;
+    }
+    else
+    {
+        /* print chip info */
+        tm1637_interface_debug_print("tm1637: chip is %s.\n", info.chip_name);
+        tm1637_interface_debug_print("tm1637: manufacturer is %s.\n", info.manufacturer_name);
+        tm1637_interface_debug_print("tm1637: interface is %s.\n", info.interface);
+        tm1637_interface_debug_print("tm1637: driver version is %d.%d.\n", info.driver_version / 1000, (info.driver_version % 1000) / 100);
+        tm1637_interface_debug_print("tm1637: min supply voltage is %0.1fV.\n", info.supply_voltage_min_v);
+        tm1637_interface_debug_print("tm1637: max supply voltage is %0.1fV.\n", info.supply_voltage_max_v);
+        tm1637_interface_debug_print("tm1637: max current is %0.2fmA.\n", info.max_current_ma);
+        tm1637_interface_debug_print("tm1637: max temperature is %0.1fC.\n", info.temperature_max);
+        tm1637_interface_debug_print("tm1637: min temperature is %0.1fC.\n", info.temperature_min);
+    }
+    
+    /* start remote test */
+    tm1637_interface_debug_print("tm1637: start remote test.\n");
+    
+    /* one client for every display of the bridge */
+    gs_write = write;
+    gs_writes = 0;
+    res = tm1637_link_client_init(&gs_client, a_tm1637_remote_test_write, read, ctx, window);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: link client init failed.\n");
+        
+        return 1;
+    }
+    for (i = 0; i < num; i++)
+    {
+        (void)tm1637_remote_init(&gs_remote[i], &gs_client, i);
+        DRIVER_TM1637_LINK_INIT(&gs_handle[i], tm1637_handle_t);
+        DRIVER_TM1637_LINK_OPS(&gs_handle[i], &gc_ops);
+        DRIVER_TM1637_LINK_CTX(&gs_handle[i], &gs_remote[i]);
+        DRIVER_TM1637_LINK_DEBUG_PRINT(&gs_handle[i], tm1637_interface_debug_print);
+        res = tm1637_init(&gs_handle[i]);
+        if (res != 0)
+        {
+            tm1637_interface_debug_print("tm1637: display %d init failed.\n", i);
+            a_tm1637_remote_test_close(i);
+            
+            return 1;
+        }
+        res = tm1637_set_address_mode(&gs_handle[i], TM1637_ADDRESS_MODE_INC);
+        if (res == 0)
+        {
+            res = tm1637_set_pulse_width(&gs_handle[i], TM1637_PULSE_WIDTH_14_DIV_16);
+        }
+        if (res == 0)
+        {
+            res = tm1637_set_display(&gs_handle[i], TM1637_BOOL_TRUE);
+        }
+        if (res != 0)
+        {
+            tm1637_interface_debug_print("tm1637: display %d set failed.\n", i);
+            a_tm1637_remote_test_close(i + 1);
+            
+            return 1;
+        }
+    }
+    if (tm1637_remote_sync(&gs_remote[0]) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: remote sync failed.\n");
+        a_tm1637_remote_test_close(num);
+        
+        return 1;
+    }
+    
+    /* wait for the bridge after every call */
+    tm1637_interface_debug_print("tm1637: round trip test.\n");
+    if (a_tm1637_remote_test_write_all(num, times, 1) != 0)
+    {
+        a_tm1637_remote_test_close(num);
+        
+        return 1;
+    }
+    
+    /* the writes are queued and batched */
+    tm1637_interface_debug_print("tm1637: pipeline test.\n");
+    if (a_tm1637_remote_test_write_all(num, times, 0) != 0)
+    {
+        a_tm1637_remote_test_close(num);
+        
+        return 1;
+    }
+    
+    /* a read blocks and sees every earlier write */
+    tm1637_interface_debug_print("tm1637: read segment test.\n");
+    for (i = 0; i < num; i++)
+    {
+        res = tm1637_read_segment(&gs_handle[i], &seg, &k);
+        if (res != 0)
+        {
+            tm1637_interface_debug_print("tm1637: display %d read segment failed.\n", i);
+            a_tm1637_remote_test_close(num);
+            
+            return 1;
+        }
+        tm1637_interface_debug_print("tm1637: display %d seg %d k %d.\n", i, seg, k);
+    }
+    
+    /* a bridge failure comes back at the sync */
+    tm1637_interface_debug_print("tm1637: error report test.\n");
+    data[0] = gsc_number[0];
+    res = tm1637_link_client_set_reg(&gs_client, num, 0xC0, data, 1);
+    if ((res != 0) || (tm1637_remote_sync(&gs_remote[0]) != 1))
+    {
+        tm1637_interface_debug_print("tm1637: invalid display is not reported.\n");
+        a_tm1637_remote_test_close(num);
+        
+        return 1;
+    }
+    
+    /* the final frame */
+    for (i = 0; i < num; i++)
+    {
+        uint8_t j;
+        
+        for (j = 0; j < 6; j++)
+        {
+            data[j] = gsc_number[(times - 1 + i + j) % 10];
+        }
+        if (tm1637_write_segment(&gs_handle[i], 0, data, 6) != 0)
+        {
+            tm1637_interface_debug_print("tm1637: write segment failed.\n");
+            a_tm1637_remote_test_close(num);
+            
+            return 1;
+        }
+    }
+    
+    /* deinit waits for the queued writes */
+    a_tm1637_remote_test_close(num);
+    (void)tm1637_link_client_get_statistics(&gs_client, &sent, &acked, &errors);
+    tm1637_interface_debug_print("tm1637: link sent %d acked %d errors %d.\n", sent, acked, errors);
+    if ((sent != acked) || (errors != 1))
+    {
+        tm1637_interface_debug_print("tm1637: link statistics are wrong.\n");
+        
+        return 1;
+    }
+    
+    /* finish remote test */
+    tm1637_interface_debug_print("tm1637: finish remote test.\n");
+    
+    return 0;
+}
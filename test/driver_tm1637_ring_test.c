@@ -0,0 +1,305 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_ring_test.c
+ * @brief     driver tm1637 ring test source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_tm1637_ring_test.h"
+#include <stdlib.h>
+
+#define RING_TEST_SIZE          64          /**< small ring for the wrap checks */
+#define RING_TEST_UART_SIZE     2048        /**< ring size of the stm32 uart */
+#define RING_TEST_LOOP          10000       /**< benchmark loop */
+
+static uint8_t gs_buf[RING_TEST_UART_SIZE];        /**< ring buffer */
+static tm1637_ring_t gs_ring;                      /**< ring */
+
+/**
+ * @brief  ring test the wrap and the drop
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   none
+ */
+static uint8_t a_ring_test_basic(void)
+{
+    uint8_t msg[RING_TEST_SIZE];
+    uint8_t *data;
+    uint32_t len;
+    uint32_t written;
+    uint32_t dropped;
+    uint32_t i;
+    
+    /* only a power of two size is accepted */
+    if (tm1637_ring_init(&gs_ring, gs_buf, 48) != 4)
+    {
+        tm1637_interface_debug_print("tm1637: ring size 48 is not rejected.\n");
+        
+        return 1;
+    }
+    if (tm1637_ring_init(&gs_ring, gs_buf, RING_TEST_SIZE) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: ring init failed.\n");
+        
+        return 1;
+    }
+    for (i = 0; i < RING_TEST_SIZE; i++)
+    {
+        msg[i] = (uint8_t)i;
+    }
+    
+    /* a message crossing the end is peeked in two parts */
+    (void)tm1637_ring_write(&gs_ring, msg, 40);
+    (void)tm1637_ring_peek(&gs_ring, &data, &len);
+    if ((data != gs_buf) || (len != 40))
+    {
+        tm1637_interface_debug_print("tm1637: ring peek check failed.\n");
+        
+        return 1;
+    }
+    (void)tm1637_ring_consume(&gs_ring, 40);
+    (void)tm1637_ring_write(&gs_ring, msg, 40);
+    (void)tm1637_ring_peek(&gs_ring, &data, &len);
+    if ((data != &gs_buf[40]) || (len != 24) || (memcmp(data, msg, 24) != 0))
+    {
+        tm1637_interface_debug_print("tm1637: ring wrap check failed.\n");
+        
+        return 1;
+    }
+    (void)tm1637_ring_consume(&gs_ring, 24);
+    (void)tm1637_ring_peek(&gs_ring, &data, &len);
+    if ((data != gs_buf) || (len != 16) || (memcmp(data, &msg[24], 16) != 0))
+    {
+        tm1637_interface_debug_print("tm1637: ring wrap check failed.\n");
+        
+        return 1;
+    }
+    (void)tm1637_ring_consume(&gs_ring, 16);
+    
+    /* a message which does not fit is dropped as a whole, an exact fit is kept */
+    if ((tm1637_ring_write(&gs_ring, msg, 60) != 0) || (tm1637_ring_write(&gs_ring, msg, 8) != 5))
+    {
+        tm1637_interface_debug_print("tm1637: ring full check failed.\n");
+        
+        return 1;
+    }
+    (void)tm1637_ring_get_used(&gs_ring, &len);
+    if ((len != 60) || (tm1637_ring_write(&gs_ring, msg, 4) != 0) || (tm1637_ring_write(&gs_ring, msg, 1) != 5))
+    {
+        tm1637_interface_debug_print("tm1637: ring exact fit check failed.\n");
+        
+        return 1;
+    }
+    if (tm1637_ring_consume(&gs_ring, RING_TEST_SIZE + 1) != 4)
+    {
+        tm1637_interface_debug_print("tm1637: ring consume check failed.\n");
+        
+        return 1;
+    }
+    (void)tm1637_ring_get_statistics(&gs_ring, &written, &dropped);
+    if ((written != 4) || (dropped != 2))
+    {
+        tm1637_interface_debug_print("tm1637: ring statistics check failed.\n");
+        
+        return 1;
+    }
+    tm1637_interface_debug_print("tm1637: check wrap and drop ok.\n");
+    
+    return 0;
+}
+
+/**
+ * @brief     ring test a byte stream against a dma like reader
+ * @param[in] times is the test times
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      the reader sends a random part of each peek like a dma transfer cut by the irq
+ */
+static uint8_t a_ring_test_stream(uint32_t times)
+{
+    uint8_t res;
+    uint8_t msg[48];
+    uint8_t *data;
+    uint8_t in;
+    uint8_t out;
+    uint32_t len;
+    uint32_t used;
+    uint32_t n;
+    uint32_t i;
+    uint32_t t;
+    uint32_t accepted;
+    uint32_t rejected;
+    uint32_t bytes;
+    uint32_t written;
+    uint32_t dropped;
+    
+    (void)tm1637_ring_init(&gs_ring, gs_buf, RING_TEST_SIZE);
+    in = 0;
+    out = 0;
+    accepted = 0;
+    rejected = 0;
+    bytes = 0;
+    for (t = 0; t < times * 10000; t++)
+    {
+        if ((rand() % 2) == 0)
+        {
+            /* writer */
+            len = 1 + (uint32_t)(rand() % 48);
+            for (i = 0; i < len; i++)
+            {
+                msg[i] = (uint8_t)(in + i);
+            }
+            (void)tm1637_ring_get_used(&gs_ring, &used);
+            res = tm1637_ring_write(&gs_ring, msg, len);
+            if (res != ((len > RING_TEST_SIZE - used) ? 5 : 0))
+            {
+                tm1637_interface_debug_print("tm1637: ring write check failed.\n");
+                
+                return 1;
+            }
+            if (res == 0)
+            {
+                in = (uint8_t)(in + len);
+                accepted++;
+            }
+            else
+            {
+                rejected++;
+            }
+        }
+        else
+        {
+            /* reader */
+            (void)tm1637_ring_peek(&gs_ring, &data, &len);
+            n = (len != 0) ? (1 + (uint32_t)rand() % len) : 0;
+            for (i = 0; i < n; i++)
+            {
+                if (data[i] != out++)
+                {
+                    tm1637_interface_debug_print("tm1637: ring byte order check failed.\n");
+                    
+                    return 1;
+                }
+            }
+            (void)tm1637_ring_consume(&gs_ring, n);
+            bytes += n;
+        }
+    }
+    
+    /* drain */
+    do
+    {
+        (void)tm1637_ring_peek(&gs_ring, &data, &len);
+        for (i = 0; i < len; i++)
+        {
+            if (data[i] != out++)
+            {
+                tm1637_interface_debug_print("tm1637: ring byte order check failed.\n");
+                
+                return 1;
+            }
+        }
+        (void)tm1637_ring_consume(&gs_ring, len);
+        bytes += len;
+    } while (len != 0);
+    (void)tm1637_ring_get_statistics(&gs_ring, &written, &dropped);
+    if ((in != out) || (written != accepted) || (dropped != rejected))
+    {
+        tm1637_interface_debug_print("tm1637: ring stream check failed.\n");
+        
+        return 1;
+    }
+    tm1637_interface_debug_print("tm1637: %d messages %d dropped, %d bytes in order.\n", accepted, rejected, bytes);
+    
+    return 0;
+}
+
+/**
+ * @brief     ring test
+ * @param[in] times is the test times
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      it checks the wrap, the drop and a byte stream against a dma like reader
+ *            and prints the cost of a queued message against a blocking 115200 baud write
+ */
+uint8_t tm1637_ring_test(uint32_t times)
+{
+    const char line[] = "tm1637: write address 2 number 7.\n";
+    uint32_t len;
+    uint32_t l;
+    uint32_t t;
+    uint32_t start;
+    uint32_t us;
+    
+    /* start ring test */
+    tm1637_interface_debug_print("tm1637: start ring test.\n");
+    
+    /* wrap and drop */
+    tm1637_interface_debug_print("tm1637: ring basic test.\n");
+    if (a_ring_test_basic() != 0)
+    {
+        return 1;
+    }
+    
+    /* byte stream */
+    tm1637_interface_debug_print("tm1637: ring stream test.\n");
+    if (a_ring_test_stream(times) != 0)
+    {
+        return 1;
+    }
+    
+    /* a queued line against the blocking write of the same line */
+    tm1637_interface_debug_print("tm1637: ring benchmark test.\n");
+    (void)tm1637_ring_init(&gs_ring, gs_buf, RING_TEST_UART_SIZE);
+    len = (uint32_t)strlen(line);
+    for (t = 0; t < times; t++)
+    {
+        start = tm1637_interface_timestamp_us();
+        for (l = 0; l < RING_TEST_LOOP; l++)
+        {
+            (void)tm1637_ring_write(&gs_ring, (const uint8_t *)line, len);
+            (void)tm1637_ring_consume(&gs_ring, len);
+        }
+        us = tm1637_interface_timestamp_us() - start;
+        tm1637_interface_debug_print("tm1637: %d byte line queued in %dns, a blocking 115200 baud write takes %dus.\n",
+                                     len, (uint32_t)((uint64_t)us * 1000 / RING_TEST_LOOP),
+                                     (uint32_t)((uint64_t)len * 10 * 1000000 / 115200));
+    }
+    
+    /* finish ring test */
+    tm1637_interface_debug_print("tm1637: finish ring test.\n");
+    
+    return 0;
+}
@@ -0,0 +1,933 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_scheduler_test.c
+ * @brief     driver tm1637 scheduler test source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_tm1637_scheduler_test.h"
+
+#define SCHEDULER_TEST_LOG         32            /**< max logged transactions */
+#define SCHEDULER_TEST_SLACK_US    10000         /**< max overshoot of a delay on the wall clock */
+
+static tm1637_handle_t gs_handle;                /**< tm1637 handle */
+#if (TM1637_LINK_FUNCTION == 0)
+static tm1637_link_t gs_link;                    /**< tm1637 link */
+#endif
+static tm1637_scheduler_t gs_scheduler;          /**< tm1637 scheduler */
+static uint8_t gs_log_cmd[SCHEDULER_TEST_LOG];   /**< command byte of each logged transaction */
+static uint8_t gs_log_len[SCHEDULER_TEST_LOG];   /**< payload length of each logged transaction */
+static uint8_t gs_log_num;                       /**< logged transaction number */
+static tm1637_handle_t gs_handle2;               /**< second tm1637 handle on the same bus */
+#if (TM1637_LINK_FUNCTION == 0)
+static tm1637_link_t gs_link2;                   /**< second tm1637 link */
+#endif
+static tm1637_scheduler_t gs_scheduler2;         /**< second tm1637 scheduler */
+static tm1637_pacer_t gs_pacer;                  /**< tm1637 pacer */
+static uint8_t gs_pacer_held;                    /**< pacer lock held flag */
+static uint32_t gs_pacer_lock_num;               /**< pacer lock number */
+static uint32_t gs_vsync_num;                    /**< vsync call number */
+static uint32_t gs_vsync_frame;                  /**< frame of the last vsync */
+static uint32_t gs_vsync_locked;                 /**< vsync calls with the pacer lock held */
+
+/**
+ * @brief     scheduler test log a transaction
+ * @param[in] addr is the command byte as sent lsb first
+ * @param[in] len is the payload length
+ * @note      the command byte is logged msb first like the datasheet
+ */
+static void a_scheduler_test_log(uint8_t addr, uint16_t len)
+{
+    uint8_t cmd = 0;
+    uint8_t i;
+    
+    for (i = 0; i < 8; i++)
+    {
+        cmd = (uint8_t)((cmd << 1) | ((addr >> i) & 0x01));
+    }
+    if (gs_log_num < SCHEDULER_TEST_LOG)
+    {
+        gs_log_cmd[gs_log_num] = cmd;
+        gs_log_len[gs_log_num] = (uint8_t)len;
+    }
+    gs_log_num++;
+}
+
+/**
+ * @brief     scheduler test write and log
+ * @param[in] addr is the command byte
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic write failed
+ * @note      none
+ */
+static uint8_t a_scheduler_test_write(uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    a_scheduler_test_log(addr, len);
+    
+    return tm1637_interface_iic_write_cmd_custom(addr, buf, len);
+}
+
+/**
+ * @brief      scheduler test read and log
+ * @param[in]  addr is the command byte
+ * @param[out] *buf points to a data buffer
+ * @param[in]  len is the length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 iic read failed
+ * @note       none
+ */
+static uint8_t a_scheduler_test_read(uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    a_scheduler_test_log(addr, len);
+    
+    return tm1637_interface_iic_read_cmd_custom(addr, buf, len);
+}
+
+/**
+ * @brief  scheduler test pacer lock
+ * @return status code
+ *         - 0 success
+ *         - 1 the lock is already held
+ * @note   a nested lock fails, so a pacer function which locks twice is caught
+ */
+static uint8_t a_scheduler_test_pacer_lock(void)
+{
+    if (gs_pacer_held != 0)
+    {
+        return 1;
+    }
+    gs_pacer_held = 1;
+    gs_pacer_lock_num++;
+    
+    return 0;
+}
+
+/**
+ * @brief scheduler test pacer unlock
+ * @note  none
+ */
+static void a_scheduler_test_pacer_unlock(void)
+{
+    gs_pacer_held = 0;
+}
+
+/**
+ * @brief     scheduler test vsync
+ * @param[in] frame is the new frame number
+ * @note      none
+ */
+static void a_scheduler_test_vsync(uint32_t frame)
+{
+    gs_vsync_num++;
+    gs_vsync_frame = frame;
+    if (gs_pacer_held != 0)
+    {
+        gs_vsync_locked++;
+    }
+}
+
+/**
+ * @brief  scheduler test iic init and deinit of the second handle
+ * @return status code
+ *         - 0 success
+ * @note   the first handle owns the bus
+ */
+static uint8_t a_scheduler_test_iic_none(void)
+{
+    return 0;
+}
+
+/**
+ * @brief     scheduler test tick the pacer and check the frame
+ * @param[in] *name points to the check name
+ * @param[in] frame is the expected frame number
+ * @return    status code
+ *            - 0 success
+ *            - 1 check failed
+ * @note      none
+ */
+static uint8_t a_scheduler_test_tick(const char *name, uint32_t frame)
+{
+    uint32_t now;
+    
+    if ((tm1637_pacer_tick(&gs_pacer, &now) != 0) || (now != frame))
+    {
+        tm1637_interface_debug_print("tm1637: %s tick is in frame %d instead of %d.\n", name, now, frame);
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     scheduler test check the logged transactions
+ * @param[in] *name points to the check name
+ * @param[in] *cmd points to the expected command bytes
+ * @param[in] *len points to the expected payload lengths
+ * @param[in] num is the expected transaction number
+ * @return    status code
+ *            - 0 success
+ *            - 1 check failed
+ * @note      the log is cleared after the check
+ */
+static uint8_t a_scheduler_test_check(const char *name, const uint8_t *cmd, const uint8_t *len, uint8_t num)
+{
+    uint8_t i;
+    
+    if (gs_log_num != num)
+    {
+        tm1637_interface_debug_print("tm1637: %s sent %d transactions instead of %d.\n", name, gs_log_num, num);
+        gs_log_num = 0;
+        
+        return 1;
+    }
+    for (i = 0; i < num; i++)
+    {
+        if ((gs_log_cmd[i] != cmd[i]) || (gs_log_len[i] != len[i]))
+        {
+            tm1637_interface_debug_print("tm1637: %s transaction %d is 0x%02X len %d instead of 0x%02X len %d.\n",
+                                         name, i, gs_log_cmd[i], gs_log_len[i], cmd[i], len[i]);
+            gs_log_num = 0;
+            
+            return 1;
+        }
+    }
+    gs_log_num = 0;
+    
+    return 0;
+}
+
+/**
+ * @brief      scheduler test run until nothing is pending
+ * @param[out] *runs points to a run counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 run failed
+ * @note       none
+ */
+static uint8_t a_scheduler_test_drain(uint8_t *runs)
+{
+    uint8_t pending;
+    
+    *runs = 0;
+    do
+    {
+        if (tm1637_scheduler_run(&gs_handle, &pending) != 0)
+        {
+            tm1637_interface_debug_print("tm1637: scheduler run failed.\n");
+            
+            return 1;
+        }
+        (*runs)++;
+    } while ((pending != 0) && (*runs < SCHEDULER_TEST_LOG));
+    
+    return 0;
+}
+
+/**
+ * @brief  scheduler test the timestamp
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   none
+ */
+static uint8_t a_scheduler_test_timestamp(void)
+{
+    uint32_t i;
+    uint32_t last;
+    uint32_t now;
+    uint32_t us;
+    uint32_t ms;
+    
+    /* it never runs backwards */
+    last = tm1637_interface_timestamp_us();
+    for (i = 0; i < 10000; i++)
+    {
+        now = tm1637_interface_timestamp_us();
+        if ((int32_t)(now - last) < 0)
+        {
+            tm1637_interface_debug_print("tm1637: timestamp runs backwards from %d to %d.\n", last, now);
+            
+            return 1;
+        }
+        last = now;
+    }
+    
+    /* it follows the delays */
+    last = tm1637_interface_timestamp_us();
+    tm1637_interface_delay_us(500);
+    us = tm1637_interface_timestamp_us() - last;
+    last = tm1637_interface_timestamp_us();
+    tm1637_interface_delay_ms(20);
+    ms = tm1637_interface_timestamp_us() - last;
+    tm1637_interface_debug_print("tm1637: delay 500us took %dus, delay 20ms took %dus.\n", us, ms);
+    if ((us < 500) || (us > 500 + SCHEDULER_TEST_SLACK_US) ||
+        (ms < 20000) || (ms > 20000 + SCHEDULER_TEST_SLACK_US))
+    {
+        tm1637_interface_debug_print("tm1637: timestamp does not follow the delays.\n");
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  scheduler test the class order
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   none
+ */
+static uint8_t a_scheduler_test_order(void)
+{
+    const uint8_t cmd0[] = {0x8F, 0x42, 0x40, 0xC0};
+    const uint8_t len0[] = {0, 1, 0, 6};
+    const uint8_t cmd1[] = {0xC2, 0x42};
+    const uint8_t len1[] = {2, 1};
+    const uint8_t cmd2[] = {0x40, 0xC5};
+    const uint8_t len2[] = {0, 1};
+    uint8_t data[6] = {TM1637_NUMBER_0, TM1637_NUMBER_1, TM1637_NUMBER_2,
+                       TM1637_NUMBER_3, TM1637_NUMBER_4, TM1637_NUMBER_5};
+    uint8_t runs;
+    uint8_t seg;
+    uint8_t k;
+    uint32_t served[3];
+    uint32_t miss[3];
+    uint8_t i;
+    
+    /* display data first, then a key read and a configuration 10ms later */
+    (void)tm1637_scheduler_set_latency_target(&gs_handle, TM1637_SCHEDULER_CLASS_CONFIG, 2000);
+    (void)tm1637_scheduler_set_latency_target(&gs_handle, TM1637_SCHEDULER_CLASS_KEY, 20000);
+    (void)tm1637_scheduler_set_latency_target(&gs_handle, TM1637_SCHEDULER_CLASS_DISPLAY, 50000);
+    gs_log_num = 0;
+    (void)tm1637_scheduler_write_segment(&gs_handle, 0, data, 6);
+    tm1637_interface_delay_ms(10);
+    (void)tm1637_scheduler_read_segment(&gs_handle);
+    (void)tm1637_scheduler_set_pulse_width(&gs_handle, TM1637_PULSE_WIDTH_14_DIV_16);
+    (void)tm1637_scheduler_set_display(&gs_handle, TM1637_BOOL_TRUE);
+    if (gs_log_num != 0)
+    {
+        tm1637_interface_debug_print("tm1637: queued work reached the bus.\n");
+        
+        return 1;
+    }
+    
+    /* the configuration is due at 12ms, the key at 30ms and the display at 50ms */
+    if (a_scheduler_test_drain(&runs) != 0)
+    {
+        return 1;
+    }
+    if ((runs != 4) || (a_scheduler_test_check("earliest deadline", cmd0, len0, 4) != 0))
+    {
+        tm1637_interface_debug_print("tm1637: earliest deadline order check failed.\n");
+        
+        return 1;
+    }
+    for (i = 0; i < 3; i++)
+    {
+        (void)tm1637_scheduler_get_statistics(&gs_handle, (tm1637_scheduler_class_t)i, &served[i], &miss[i]);
+    }
+    if ((served[0] != 1) || (served[1] != 1) || (served[2] != 2))
+    {
+        tm1637_interface_debug_print("tm1637: served %d %d %d instead of 1 1 2.\n", served[0], served[1], served[2]);
+        
+        return 1;
+    }
+    if ((tm1637_scheduler_get_key(&gs_handle, &seg, &k) != 0) || (tm1637_scheduler_get_key(&gs_handle, &seg, &k) != 5))
+    {
+        tm1637_interface_debug_print("tm1637: key result check failed.\n");
+        
+        return 1;
+    }
+    tm1637_interface_debug_print("tm1637: check earliest deadline order ok.\n");
+    
+    /* a tight display target overtakes a key read queued first, the chip is still in the write mode */
+    (void)tm1637_scheduler_set_latency_target(&gs_handle, TM1637_SCHEDULER_CLASS_DISPLAY, 100);
+    (void)tm1637_scheduler_read_segment(&gs_handle);
+    (void)tm1637_scheduler_write_segment(&gs_handle, 2, &data[4], 2);
+    if ((a_scheduler_test_drain(&runs) != 0) || (runs != 2) ||
+        (a_scheduler_test_check("display target", cmd1, len1, 2) != 0))
+    {
+        tm1637_interface_debug_print("tm1637: display target check failed.\n");
+        
+        return 1;
+    }
+    
+    /* the key read left the write mode, so the data command is sent again */
+    (void)tm1637_scheduler_write_segment(&gs_handle, 5, &data[0], 1);
+    if ((a_scheduler_test_drain(&runs) != 0) || (runs != 2) ||
+        (a_scheduler_test_check("data command", cmd2, len2, 2) != 0))
+    {
+        tm1637_interface_debug_print("tm1637: data command check failed.\n");
+        
+        return 1;
+    }
+    tm1637_interface_debug_print("tm1637: check skipped data command ok.\n");
+    
+    /* a configuration served 5ms late misses its 1ms target */
+    (void)tm1637_scheduler_set_latency_target(&gs_handle, TM1637_SCHEDULER_CLASS_CONFIG, 1000);
+    (void)tm1637_scheduler_get_statistics(&gs_handle, TM1637_SCHEDULER_CLASS_CONFIG, &served[0], &miss[0]);
+    (void)tm1637_scheduler_set_display(&gs_handle, TM1637_BOOL_TRUE);
+    tm1637_interface_delay_ms(5);
+    (void)a_scheduler_test_drain(&runs);
+    gs_log_num = 0;
+    (void)tm1637_scheduler_get_statistics(&gs_handle, TM1637_SCHEDULER_CLASS_CONFIG, &served[1], &miss[1]);
+    if ((served[1] != served[0] + 1) || (miss[1] != miss[0] + 1))
+    {
+        tm1637_interface_debug_print("tm1637: deadline miss check failed.\n");
+        
+        return 1;
+    }
+    tm1637_interface_debug_print("tm1637: check deadline miss ok.\n");
+    
+    return 0;
+}
+
+/**
+ * @brief  scheduler test the write combining and the direct writes
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   it runs after the order test, so the chip is in the write mode
+ */
+static uint8_t a_scheduler_test_combining(void)
+{
+    const uint8_t cmd0[] = {0xC0};
+    const uint8_t len0[] = {2};
+    const uint8_t cmd1[] = {0xC0};
+    const uint8_t len1[] = {6};
+    const uint8_t cmd2[] = {0xC3};
+    const uint8_t len2[] = {1};
+    const uint8_t cmd3[] = {0xC4};
+    const uint8_t len3[] = {1};
+    const uint8_t cmd4[] = {0x40, 0xC4};
+    const uint8_t len4[] = {0, 1};
+    uint8_t data[6] = {TM1637_NUMBER_0, TM1637_NUMBER_1, TM1637_NUMBER_2,
+                       TM1637_NUMBER_3, TM1637_NUMBER_4, TM1637_NUMBER_5};
+    uint32_t start;
+    uint32_t before;
+    uint32_t after;
+    uint8_t runs;
+    uint8_t n;
+    
+    /* every write path only merges while the 20ms window is open */
+    if (tm1637_scheduler_set_write_combining(&gs_handle, 20000, 50000) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: set write combining failed.\n");
+        
+        return 1;
+    }
+    gs_log_num = 0;
+    (void)tm1637_write_segment(&gs_handle, 0, &data[1], 1);
+    (void)tm1637_write_segment_mask(&gs_handle, data, 0x02);
+    (void)tm1637_scheduler_run(&gs_handle, NULL);
+    if (gs_log_num != 0)
+    {
+        tm1637_interface_debug_print("tm1637: combined writes reached the bus in the window.\n");
+        
+        return 1;
+    }
+    
+    /* the run after the window sends both digits as one burst */
+    tm1637_interface_delay_ms(20);
+    if ((a_scheduler_test_drain(&runs) != 0) || (runs != 1) ||
+        (a_scheduler_test_check("window", cmd0, len0, 1) != 0))
+    {
+        tm1637_interface_debug_print("tm1637: write combining window check failed.\n");
+        
+        return 1;
+    }
+    
+    /* a clear waits for the commit */
+    (void)tm1637_clear_segment(&gs_handle);
+    if (gs_log_num != 0)
+    {
+        tm1637_interface_debug_print("tm1637: combined clear reached the bus.\n");
+        
+        return 1;
+    }
+    (void)tm1637_scheduler_commit(&gs_handle);
+    if (a_scheduler_test_check("commit", cmd1, len1, 1) != 0)
+    {
+        return 1;
+    }
+    
+    /* a write every 10ms keeps the window open until the first digit is 50ms stale */
+    start = tm1637_interface_timestamp_us();
+    for (n = 0; n < 10; n++)
+    {
+        before = tm1637_interface_timestamp_us() - start;
+        (void)tm1637_write_segment(&gs_handle, 3, &data[n % 6], 1);
+        after = tm1637_interface_timestamp_us() - start;
+        if (gs_log_num != 0)
+        {
+            break;
+        }
+        if (after >= 50000 + SCHEDULER_TEST_SLACK_US)
+        {
+            tm1637_interface_debug_print("tm1637: stale digit was not flushed after %dus.\n", after);
+            
+            return 1;
+        }
+        tm1637_interface_delay_ms(10);
+    }
+    if ((n == 10) || (after < 50000) || (a_scheduler_test_check("max stale", cmd2, len2, 1) != 0))
+    {
+        tm1637_interface_debug_print("tm1637: max stale check failed at %dus.\n", before);
+        
+        return 1;
+    }
+    tm1637_interface_debug_print("tm1637: check write combining ok.\n");
+    
+    /* a direct write skips the data command while the chip is in the write mode */
+    (void)tm1637_scheduler_set_write_combining(&gs_handle, 0, 0);
+    (void)tm1637_write_segment(&gs_handle, 4, &data[0], 1);
+    if (a_scheduler_test_check("direct write", cmd3, len3, 1) != 0)
+    {
+        return 1;
+    }
+    
+    /* a key read leaves the write mode, so the next direct write sends the data command again */
+    (void)tm1637_scheduler_read_segment(&gs_handle);
+    (void)a_scheduler_test_drain(&runs);
+    gs_log_num = 0;
+    (void)tm1637_write_segment_mask(&gs_handle, data, 0x10);
+    if (a_scheduler_test_check("direct data command", cmd4, len4, 2) != 0)
+    {
+        return 1;
+    }
+    tm1637_interface_debug_print("tm1637: check direct data command ok.\n");
+    
+    return 0;
+}
+
+/**
+ * @brief  scheduler test the pacer
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   it runs after the write combining test with write combining disabled
+ */
+static uint8_t a_scheduler_test_pacer(void)
+{
+    const uint8_t cmd0[] = {0xC0};
+    const uint8_t len0[] = {6};
+    const uint8_t cmd1[] = {0xC1};
+    const uint8_t len1[] = {1};
+    const uint8_t cmd2[] = {0x40, 0xC0};
+    const uint8_t len2[] = {0, 6};
+    uint8_t data[6] = {TM1637_NUMBER_0, TM1637_NUMBER_1, TM1637_NUMBER_2,
+                       TM1637_NUMBER_3, TM1637_NUMBER_4, TM1637_NUMBER_5};
+    uint32_t frames;
+    uint32_t over_budget;
+    uint8_t runs;
+    
+    /* 100 fps with a lock which fails when nested */
+    gs_pacer_held = 0;
+    gs_pacer_lock_num = 0;
+    gs_vsync_num = 0;
+    gs_vsync_locked = 0;
+    if ((tm1637_pacer_init(&gs_pacer, tm1637_interface_timestamp_us, a_scheduler_test_vsync) != 0) ||
+        (tm1637_pacer_set_lock(&gs_pacer, a_scheduler_test_pacer_lock, a_scheduler_test_pacer_unlock) != 0) ||
+        (tm1637_pacer_set_fps(&gs_pacer, 100) != 0))
+    {
+        tm1637_interface_debug_print("tm1637: pacer init failed.\n");
+        
+        return 1;
+    }
+    if (tm1637_pacer_set_lock(&gs_pacer, a_scheduler_test_pacer_lock, NULL) != 4)
+    {
+        tm1637_interface_debug_print("tm1637: pacer lock pair check failed.\n");
+        
+        return 1;
+    }
+    
+    /* a frame starts every 10ms and a late tick resyncs instead of catching up */
+    if (a_scheduler_test_tick("first", 0) != 0)
+    {
+        return 1;
+    }
+    tm1637_interface_delay_ms(10);
+    if (a_scheduler_test_tick("period", 1) != 0)
+    {
+        return 1;
+    }
+    tm1637_interface_delay_ms(35);
+    if ((a_scheduler_test_tick("late", 2) != 0) || (a_scheduler_test_tick("resync", 2) != 0))
+    {
+        return 1;
+    }
+    tm1637_interface_delay_ms(10);
+    if (a_scheduler_test_tick("after resync", 3) != 0)
+    {
+        return 1;
+    }
+    if ((gs_vsync_num != 3) || (gs_vsync_frame != 3))
+    {
+        tm1637_interface_debug_print("tm1637: vsync ran %d times up to frame %d instead of 3 times up to 3.\n",
+                                     gs_vsync_num, gs_vsync_frame);
+        
+        return 1;
+    }
+    tm1637_interface_debug_print("tm1637: check pacer frame ok.\n");
+    
+    /* a paced display flushes once per frame, the next write waits for the next frame */
+    gs_log_num = 0;
+    (void)tm1637_scheduler_set_pacer(&gs_handle, &gs_pacer);
+    (void)tm1637_write_segment(&gs_handle, 0, data, 6);
+    if (a_scheduler_test_check("paced write", cmd0, len0, 1) != 0)
+    {
+        return 1;
+    }
+    (void)tm1637_write_segment(&gs_handle, 1, &data[2], 1);
+    (void)tm1637_scheduler_run(&gs_handle, NULL);
+    if (gs_log_num != 0)
+    {
+        tm1637_interface_debug_print("tm1637: paced display flushed twice in a frame.\n");
+        
+        return 1;
+    }
+    tm1637_interface_delay_ms(10);
+    if ((a_scheduler_test_tick("paced", 4) != 0) || (a_scheduler_test_drain(&runs) != 0) ||
+        (a_scheduler_test_check("next frame", cmd1, len1, 1) != 0))
+    {
+        return 1;
+    }
+    
+    /* with a 1% share the first display spends the 100us budget, the second one waits for the next frame */
+    DRIVER_TM1637_LINK_INIT(&gs_handle2, tm1637_handle_t);
+#if (TM1637_LINK_FUNCTION == 0)
+    DRIVER_TM1637_LINK_FUNCTION(&gs_handle2, &gs_link2);
+#endif
+    DRIVER_TM1637_LINK_IIC_INIT(&gs_handle2, a_scheduler_test_iic_none);
+    DRIVER_TM1637_LINK_IIC_DEINIT(&gs_handle2, a_scheduler_test_iic_none);
+    DRIVER_TM1637_LINK_IIC_WRITE_COMMAND_CUSTOM(&gs_handle2, a_scheduler_test_write);
+    DRIVER_TM1637_LINK_IIC_READ_COMMAND_CUSTOM(&gs_handle2, a_scheduler_test_read);
+    DRIVER_TM1637_LINK_DELAY_MS(&gs_handle2, tm1637_interface_delay_ms);
+    DRIVER_TM1637_LINK_DEBUG_PRINT(&gs_handle2, tm1637_interface_debug_print);
+    DRIVER_TM1637_LINK_TIMESTAMP_US(&gs_handle2, tm1637_interface_timestamp_us);
+    DRIVER_TM1637_LINK_LOCK(&gs_handle2, tm1637_interface_lock);
+    DRIVER_TM1637_LINK_UNLOCK(&gs_handle2, tm1637_interface_unlock);
+    if ((tm1637_init(&gs_handle2) != 0) || (tm1637_scheduler_init(&gs_handle2, &gs_scheduler2) != 0) ||
+        (tm1637_scheduler_set_pacer(&gs_handle2, &gs_pacer) != 0) || (tm1637_pacer_set_bus_share(&gs_pacer, 1) != 0))
+    {
+        tm1637_interface_debug_print("tm1637: second display init failed.\n");
+        (void)tm1637_deinit(&gs_handle2);
+        
+        return 1;
+    }
+    tm1637_interface_delay_ms(10);
+    (void)a_scheduler_test_tick("budget", 5);
+    (void)tm1637_write_segment(&gs_handle, 0, data, 6);
+    (void)tm1637_write_segment(&gs_handle2, 0, data, 6);
+    (void)tm1637_pacer_get_statistics(&gs_pacer, &frames, &over_budget);
+    if ((frames != 5) || (over_budget != 1) || (a_scheduler_test_check("over budget", cmd0, len0, 1) != 0))
+    {
+        tm1637_interface_debug_print("tm1637: over budget check failed in frame %d with %d.\n", frames, over_budget);
+        (void)tm1637_deinit(&gs_handle2);
+        
+        return 1;
+    }
+    tm1637_interface_delay_ms(10);
+    (void)a_scheduler_test_tick("second display", 6);
+    if ((tm1637_scheduler_run(&gs_handle2, NULL) != 0) || (tm1637_scheduler_run(&gs_handle2, NULL) != 0) ||
+        (a_scheduler_test_check("second display", cmd2, len2, 2) != 0))
+    {
+        (void)tm1637_deinit(&gs_handle2);
+        
+        return 1;
+    }
+    (void)tm1637_scheduler_set_pacer(&gs_handle, NULL);
+    (void)tm1637_deinit(&gs_handle2);
+    
+    /* every pacer access took the pacer lock and the vsync ran outside of it */
+    if ((gs_pacer_lock_num == 0) || (gs_pacer_held != 0) || (gs_vsync_locked != 0))
+    {
+        tm1637_interface_debug_print("tm1637: pacer lock taken %d times, held %d, vsync locked %d.\n",
+                                     gs_pacer_lock_num, gs_pacer_held, gs_vsync_locked);
+        
+        return 1;
+    }
+    tm1637_interface_debug_print("tm1637: check pacer budget ok.\n");
+    
+    return 0;
+}
+
+/**
+ * @brief  scheduler test the flush step budget
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   none
+ */
+static uint8_t a_scheduler_test_budget(void)
+{
+    uint8_t data[6] = {TM1637_NUMBER_0, TM1637_NUMBER_1, TM1637_NUMBER_2,
+                       TM1637_NUMBER_3, TM1637_NUMBER_4, TM1637_NUMBER_5};
+    uint8_t remaining;
+    uint8_t last;
+    uint8_t calls;
+    
+    /* two runs of digits and a configuration */
+    (void)tm1637_scheduler_write_segment(&gs_handle, 0, data, 2);
+    (void)tm1637_scheduler_write_segment(&gs_handle, 4, &data[4], 2);
+    (void)tm1637_scheduler_set_display(&gs_handle, TM1637_BOOL_TRUE);
+    
+    /* a 1us budget is shorter than any transaction, every call still runs exactly one */
+    gs_log_num = 0;
+    last = 0xFF;
+    calls = 0;
+    do
+    {
+        if (tm1637_flush_step(&gs_handle, 1, &remaining) != 0)
+        {
+            tm1637_interface_debug_print("tm1637: flush step failed.\n");
+            
+            return 1;
+        }
+        calls++;
+        if ((gs_log_num != calls) || ((last != 0xFF) && (remaining != last - 1)))
+        {
+            tm1637_interface_debug_print("tm1637: short budget call %d sent %d transactions with %d remaining.\n",
+                                         calls, gs_log_num, remaining);
+            
+            return 1;
+        }
+        last = remaining;
+    } while ((remaining != 0) && (calls < SCHEDULER_TEST_LOG));
+    if ((remaining != 0) || (calls < 3))
+    {
+        tm1637_interface_debug_print("tm1637: short budget left %d after %d calls.\n", remaining, calls);
+        
+        return 1;
+    }
+    
+    /* a long budget sends the same work in one call */
+    (void)tm1637_scheduler_write_segment(&gs_handle, 0, &data[2], 2);
+    (void)tm1637_scheduler_write_segment(&gs_handle, 4, data, 2);
+    (void)tm1637_scheduler_set_display(&gs_handle, TM1637_BOOL_TRUE);
+    gs_log_num = 0;
+    if ((tm1637_flush_step(&gs_handle, 1000000, &remaining) != 0) || (remaining != 0) || (gs_log_num < 3))
+    {
+        tm1637_interface_debug_print("tm1637: long budget sent %d transactions with %d remaining.\n",
+                                     gs_log_num, remaining);
+        
+        return 1;
+    }
+    gs_log_num = 0;
+    tm1637_interface_debug_print("tm1637: check flush step budget ok.\n");
+    
+    return 0;
+}
+
+/**
+ * @brief  scheduler test the direct setters between the queued ones
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   none
+ */
+static uint8_t a_scheduler_test_mixed(void)
+{
+    const uint8_t cmd0[] = {0x87, 0x85, 0x85};
+    const uint8_t len0[] = {0, 0, 0};
+    const uint8_t cmd1[] = {0x8D, 0x89};
+    const uint8_t len1[] = {0, 0};
+    tm1637_pulse_width_t width;
+    tm1637_bool_t enable;
+    uint8_t runs;
+    
+    /* start from a known conf */
+    (void)tm1637_set_pulse_width(&gs_handle, TM1637_PULSE_WIDTH_14_DIV_16);
+    (void)tm1637_set_display(&gs_handle, TM1637_BOOL_TRUE);
+    gs_log_num = 0;
+    
+    /* the direct writes after a queued width win over it */
+    (void)tm1637_scheduler_set_pulse_width(&gs_handle, TM1637_PULSE_WIDTH_4_DIV_16);
+    (void)tm1637_set_display(&gs_handle, TM1637_BOOL_FALSE);
+    (void)tm1637_set_pulse_width(&gs_handle, TM1637_PULSE_WIDTH_12_DIV_16);
+    if (a_scheduler_test_drain(&runs) != 0)
+    {
+        return 1;
+    }
+    if (a_scheduler_test_check("direct after queued", cmd0, len0, 3) != 0)
+    {
+        return 1;
+    }
+    (void)tm1637_get_pulse_width(&gs_handle, &width);
+    (void)tm1637_get_display(&gs_handle, &enable);
+    if ((width != TM1637_PULSE_WIDTH_12_DIV_16) || (enable != TM1637_BOOL_FALSE))
+    {
+        tm1637_interface_debug_print("tm1637: direct after queued left width %d display %d.\n", width, enable);
+        
+        return 1;
+    }
+    
+    /* a direct display switch keeps the queued width */
+    (void)tm1637_scheduler_set_pulse_width(&gs_handle, TM1637_PULSE_WIDTH_2_DIV_16);
+    (void)tm1637_set_display(&gs_handle, TM1637_BOOL_TRUE);
+    if (a_scheduler_test_drain(&runs) != 0)
+    {
+        return 1;
+    }
+    if (a_scheduler_test_check("direct display", cmd1, len1, 2) != 0)
+    {
+        return 1;
+    }
+    tm1637_interface_debug_print("tm1637: check direct and queued conf ok.\n");
+    
+    return 0;
+}
+
+/**
+ * @brief  scheduler test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   it checks the timestamp against the delays, then logs every bus transaction and checks the earliest
+ *         deadline order of the classes, the skipped data command, the write combining of every write path
+ *         the frames, the bus budget and the lock of the pacer, a flush step budget shorter than a transaction
+ *         and the direct setters between the queued ones
+ */
+uint8_t tm1637_scheduler_test(void)
+{
+    uint8_t res;
+    
+    /* link interface function */
+    DRIVER_TM1637_LINK_INIT(&gs_handle, tm1637_handle_t);
+#if (TM1637_LINK_FUNCTION == 0)
+    DRIVER_TM1637_LINK_FUNCTION(&gs_handle, &gs_link);
+#endif
+    DRIVER_TM1637_LINK_IIC_INIT(&gs_handle, tm1637_interface_iic_init);
+    DRIVER_TM1637_LINK_IIC_DEINIT(&gs_handle, tm1637_interface_iic_deinit);
+    DRIVER_TM1637_LINK_IIC_WRITE_COMMAND_CUSTOM(&gs_handle, a_scheduler_test_write);
+    DRIVER_TM1637_LINK_IIC_READ_COMMAND_CUSTOM(&gs_handle, a_scheduler_test_read);
+    DRIVER_TM1637_LINK_DELAY_MS(&gs_handle, tm1637_interface_delay_ms);
+    DRIVER_TM1637_LINK_DEBUG_PRINT(&gs_handle, tm1637_interface_debug_print);
+    DRIVER_TM1637_LINK_TIMESTAMP_US(&gs_handle, tm1637_interface_timestamp_us);
+    DRIVER_TM1637_LINK_LOCK(&gs_handle, tm1637_interface_lock);
+    DRIVER_TM1637_LINK_UNLOCK(&gs_handle, tm1637_interface_unlock);
+    
+    /* start scheduler test */
+    tm1637_interface_debug_print("tm1637: start scheduler test.\n");
+    
+    /* timestamp */
+    tm1637_interface_debug_print("tm1637: timestamp test.\n");
+    if (a_scheduler_test_timestamp() != 0)
+    {
+        return 1;
+    }
+    
+    /* tm1637 init */
+    res = tm1637_init(&gs_handle);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: init failed.\n");
+        
+        return 1;
+    }
+    res = tm1637_scheduler_init(&gs_handle, &gs_scheduler);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: scheduler init failed.\n");
+        (void)tm1637_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* class order */
+    tm1637_interface_debug_print("tm1637: scheduler order test.\n");
+    if (a_scheduler_test_order() != 0)
+    {
+        (void)tm1637_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* write combining */
+    tm1637_interface_debug_print("tm1637: scheduler write combining test.\n");
+    if (a_scheduler_test_combining() != 0)
+    {
+        (void)tm1637_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* pacer */
+    tm1637_interface_debug_print("tm1637: scheduler pacer test.\n");
+    if (a_scheduler_test_pacer() != 0)
+    {
+        (void)tm1637_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* flush step budget */
+    tm1637_interface_debug_print("tm1637: scheduler budget test.\n");
+    if (a_scheduler_test_budget() != 0)
+    {
+        (void)tm1637_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* direct and queued conf */
+    tm1637_interface_debug_print("tm1637: scheduler mixed test.\n");
+    if (a_scheduler_test_mixed() != 0)
+    {
+        (void)tm1637_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* a detached scheduler is refused */
+    (void)tm1637_scheduler_deinit(&gs_handle);
+    if (tm1637_scheduler_run(&gs_handle, NULL) != 4)
+    {
+        tm1637_interface_debug_print("tm1637: detached scheduler check failed.\n");
+        (void)tm1637_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* finish scheduler test */
+    tm1637_interface_debug_print("tm1637: finish scheduler test.\n");
+    (void)tm1637_deinit(&gs_handle);
+    
+    return 0;
+}
@@ -0,0 +1,543 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_trace_test.c
+ * @brief     driver tm1637 trace test source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_tm1637_trace_test.h"
+#include <stdlib.h>
+
+#define TRACE_TEST_BIT_US         10          /**< modelled bus clock period of the check */
+#define TRACE_TEST_CAPTURE        4096        /**< capture length of the check */
+#define TRACE_TEST_WRAP_US        1000        /**< clock step of the wrap check */
+
+/**
+ * @brief shared interface ops
+ */
+static const tm1637_ops_t gc_ops =
+{
+    tm1637_interface_iic_init_ctx,
+    tm1637_interface_iic_deinit_ctx,
+    tm1637_interface_iic_write_cmd_custom_ctx,
+    tm1637_interface_iic_read_cmd_custom_ctx,
+    tm1637_interface_delay_ms_ctx,
+    tm1637_interface_timestamp_us_ctx,
+    tm1637_interface_lock_ctx,
+    tm1637_interface_unlock_ctx,
+};
+
+/**
+ * @brief     trace test read a clock which is about to wrap
+ * @param[in] *ctx is not used
+ * @return    the timestamp
+ * @note      none
+ */
+static uint32_t a_trace_test_timestamp_us(void *ctx);
+
+/**
+ * @brief interface ops with a clock which is about to wrap
+ */
+static const tm1637_ops_t gc_wrap_ops =
+{
+    tm1637_interface_iic_init_ctx,
+    tm1637_interface_iic_deinit_ctx,
+    tm1637_interface_iic_write_cmd_custom_ctx,
+    tm1637_interface_iic_read_cmd_custom_ctx,
+    tm1637_interface_delay_ms_ctx,
+    a_trace_test_timestamp_us,
+    tm1637_interface_lock_ctx,
+    tm1637_interface_unlock_ctx,
+};
+
+static tm1637_handle_t gs_handle[TM1637_TRACE_TEST_MAX_DISPLAY];             /**< tm1637 handles */
+static tm1637_trace_track_t gs_track[TM1637_TRACE_TEST_MAX_DISPLAY];         /**< trace tracks */
+static tm1637_trace_t gs_trace;                                              /**< trace */
+static char gs_capture[TRACE_TEST_CAPTURE + 1];                              /**< captured stream of the check */
+static uint32_t gs_capture_len;                                              /**< captured length */
+static uint8_t (*gs_write)(void *file, const char *buf, uint16_t len);       /**< stream write of the export */
+static uint32_t gs_bytes;                                                    /**< streamed bytes */
+static uint16_t gs_max_len;                                                  /**< longest write */
+static uint32_t gs_now;                                                      /**< clock of the wrap check */
+static const uint8_t gsc_number[] = {TM1637_NUMBER_0, TM1637_NUMBER_1, TM1637_NUMBER_2,
+                                     TM1637_NUMBER_3, TM1637_NUMBER_4, TM1637_NUMBER_5,
+                                     TM1637_NUMBER_6, TM1637_NUMBER_7, TM1637_NUMBER_8,
+                                     TM1637_NUMBER_9};                       /**< number table */
+
+static uint32_t a_trace_test_timestamp_us(void *ctx)
+{
+    (void)ctx;
+    
+    gs_now += TRACE_TEST_WRAP_US;
+    
+    return gs_now;
+}
+
+/**
+ * @brief     trace test capture the stream
+ * @param[in] *ctx is not used
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 capture is full
+ * @note      none
+ */
+static uint8_t a_trace_test_capture(void *ctx, const char *buf, uint16_t len)
+{
+    (void)ctx;
+    
+    if (gs_capture_len + len > TRACE_TEST_CAPTURE)
+    {
+        return 1;
+    }
+    memcpy(&gs_capture[gs_capture_len], buf, len);
+    gs_capture_len += len;
+    gs_capture[gs_capture_len] = '\0';
+    
+    return 0;
+}
+
+/**
+ * @brief     trace test count the stream and pass it on
+ * @param[in] *ctx is the stream context
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+static uint8_t a_trace_test_stream(void *ctx, const char *buf, uint16_t len)
+{
+    gs_bytes += len;
+    if (len > gs_max_len)
+    {
+        gs_max_len = len;
+    }
+    
+    return gs_write(ctx, buf, len);
+}
+
+/**
+ * @brief      trace test find a field of a captured event
+ * @param[in]  *name points to the event name
+ * @param[in]  *key points to the field name
+ * @param[out] *value points to a value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 not found
+ * @note       the first event with the name is used, every event is one line
+ */
+static uint8_t a_trace_test_find(const char *name, const char *key, uint32_t *value)
+{
+    char pattern[64];
+    char *event;
+    char *end;
+    char *field;
+    
+    (void)snprintf(pattern, sizeof(pattern), "{\"name\":\"%s\"", name);
+    event = strstr(gs_capture, pattern);
+    if (event == NULL)
+    {
+        return 1;
+    }
+    end = strchr(event, '\n');
+    (void)snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    field = strstr(event, pattern);
+    if ((field == NULL) || ((end != NULL) && (field > end)))
+    {
+        return 1;
+    }
+    *value = (uint32_t)strtoul(field + strlen(pattern), NULL, 10);
+    
+    return 0;
+}
+
+/**
+ * @brief  trace test check the events of display 0
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   none
+ */
+static uint8_t a_trace_test_check(void)
+{
+    uint8_t data[6];
+    uint8_t seg;
+    uint8_t k;
+    uint8_t i;
+    uint32_t events;
+    uint32_t dropped;
+    uint32_t ts[5];
+    uint32_t dur[5];
+    
+    /* capture the stream */
+    gs_capture_len = 0;
+    gs_capture[0] = '\0';
+    if (tm1637_trace_init(&gs_trace, a_trace_test_capture, NULL) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: trace init failed.\n");
+        
+        return 1;
+    }
+    (void)tm1637_trace_set_bus_model(&gs_trace, TRACE_TEST_BIT_US);
+    if (tm1637_trace_attach(&gs_trace, &gs_track[0], &gs_handle[0], TM1637_TRACE_MAX_BUS, 0) != 5)
+    {
+        tm1637_interface_debug_print("tm1637: trace bus check failed.\n");
+        
+        return 1;
+    }
+    if (tm1637_trace_attach(&gs_trace, &gs_track[0], &gs_handle[0], 0, 0) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: trace attach failed.\n");
+        
+        return 1;
+    }
+    
+    /* one write and one key read */
+    for (i = 0; i < 6; i++)
+    {
+        data[i] = gsc_number[i];
+    }
+    if ((tm1637_write_segment(&gs_handle[0], 0x00, data, 6) != 0) ||
+        (tm1637_read_segment(&gs_handle[0], &seg, &k) != 0))
+    {
+        tm1637_interface_debug_print("tm1637: traced call failed.\n");
+        
+        return 1;
+    }
+    
+    /* a stopped trace gets nothing */
+    (void)tm1637_set_trace(&gs_handle[0], NULL, NULL, NULL);
+    (void)tm1637_write_segment(&gs_handle[0], 0x00, data, 6);
+    (void)tm1637_trace_get_statistics(&gs_trace, &events, &dropped);
+    if (tm1637_trace_deinit(&gs_trace) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: trace deinit failed.\n");
+        
+        return 1;
+    }
+    
+    /* process name, 2 track names and 2 track orders, 3 transactions and 2 api calls */
+    if ((events != 10) || (dropped != 0))
+    {
+        tm1637_interface_debug_print("tm1637: trace event count %d dropped %d.\n", events, dropped);
+        
+        return 1;
+    }
+    if ((strncmp(gs_capture, "[\n{", 3) != 0) || (strcmp(&gs_capture[gs_capture_len - 3], "\n]\n") != 0))
+    {
+        tm1637_interface_debug_print("tm1637: trace array check failed.\n");
+        
+        return 1;
+    }
+    
+    /* the transactions last start, stop and 9 clocks a byte back to back, the api calls cover them */
+    if ((a_trace_test_find("write 0x40", "ts", &ts[0]) != 0) || (a_trace_test_find("write 0x40", "dur", &dur[0]) != 0) ||
+        (a_trace_test_find("write 0xC0", "ts", &ts[1]) != 0) || (a_trace_test_find("write 0xC0", "dur", &dur[1]) != 0) ||
+        (a_trace_test_find("read 0x42", "ts", &ts[2]) != 0) || (a_trace_test_find("read 0x42", "dur", &dur[2]) != 0) ||
+        (a_trace_test_find("tm1637_write_segment", "ts", &ts[3]) != 0) ||
+        (a_trace_test_find("tm1637_write_segment", "dur", &dur[3]) != 0) ||
+        (a_trace_test_find("tm1637_read_segment", "ts", &ts[4]) != 0) ||
+        (a_trace_test_find("tm1637_read_segment", "dur", &dur[4]) != 0))
+    {
+        tm1637_interface_debug_print("tm1637: trace event is missing.\n");
+        
+        return 1;
+    }
+    if ((dur[0] != (2 + 9 * 1) * TRACE_TEST_BIT_US) || (dur[1] != (2 + 9 * 7) * TRACE_TEST_BIT_US) ||
+        (dur[2] != (2 + 9 * 2) * TRACE_TEST_BIT_US))
+    {
+        tm1637_interface_debug_print("tm1637: trace bus time check failed.\n");
+        
+        return 1;
+    }
+    if (((int32_t)(ts[1] - (ts[0] + dur[0])) < 0) || ((int32_t)(ts[2] - (ts[1] + dur[1])) < 0) ||
+        ((int32_t)(ts[0] - ts[3]) < 0) || ((int32_t)((ts[3] + dur[3]) - (ts[1] + dur[1])) < 0) ||
+        ((int32_t)(ts[4] - (ts[3] + dur[3])) < 0) || ((int32_t)((ts[4] + dur[4]) - (ts[2] + dur[2])) < 0))
+    {
+        tm1637_interface_debug_print("tm1637: trace order check failed.\n");
+        
+        return 1;
+    }
+    tm1637_interface_debug_print("tm1637: check %d events ok.\n", events);
+    
+    return 0;
+}
+
+/**
+ * @brief  trace test the timestamps across the 32 bits wrap
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   display 0 reads a clock 4ms before the wrap, so its events must go on past 2^32us
+ */
+static uint8_t a_trace_test_wrap(void)
+{
+    uint8_t data[6];
+    uint8_t i;
+    uint64_t ts;
+    uint64_t start;
+    uint64_t last;
+    char *field;
+    
+    /* capture the stream with the wrapping clock */
+    gs_capture_len = 0;
+    gs_capture[0] = '\0';
+    gs_now = 0xFFFFFFFFU - 4 * TRACE_TEST_WRAP_US;
+    start = gs_now;
+    DRIVER_TM1637_LINK_OPS(&gs_handle[0], &gc_wrap_ops);
+    if ((tm1637_trace_init(&gs_trace, a_trace_test_capture, NULL) != 0) ||
+        (tm1637_trace_attach(&gs_trace, &gs_track[0], &gs_handle[0], 0, 0) != 0))
+    {
+        tm1637_interface_debug_print("tm1637: trace init failed.\n");
+        DRIVER_TM1637_LINK_OPS(&gs_handle[0], &gc_ops);
+        
+        return 1;
+    }
+    for (i = 0; i < 6; i++)
+    {
+        data[i] = gsc_number[i];
+    }
+    for (i = 0; i < 4; i++)
+    {
+        if (tm1637_write_segment(&gs_handle[0], 0x00, data, 6) != 0)
+        {
+            tm1637_interface_debug_print("tm1637: traced call failed.\n");
+            (void)tm1637_set_trace(&gs_handle[0], NULL, NULL, NULL);
+            DRIVER_TM1637_LINK_OPS(&gs_handle[0], &gc_ops);
+            
+            return 1;
+        }
+    }
+    (void)tm1637_set_trace(&gs_handle[0], NULL, NULL, NULL);
+    DRIVER_TM1637_LINK_OPS(&gs_handle[0], &gc_ops);
+    if (tm1637_trace_deinit(&gs_trace) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: trace deinit failed.\n");
+        
+        return 1;
+    }
+    
+    /* the timestamps go on past the wrap and never go back before the start */
+    last = 0;
+    field = strstr(gs_capture, "\"ts\":");
+    while (field != NULL)
+    {
+        ts = (uint64_t)strtoull(field + 5, NULL, 10);
+        if (ts < start)
+        {
+            tm1637_interface_debug_print("tm1637: trace timestamp went back after the wrap.\n");
+            
+            return 1;
+        }
+        last = ts;
+        field = strstr(field + 5, "\"ts\":");
+    }
+    if (last <= 0xFFFFFFFFU)
+    {
+        tm1637_interface_debug_print("tm1637: trace timestamp did not pass the wrap.\n");
+        
+        return 1;
+    }
+    tm1637_interface_debug_print("tm1637: check wrap from %llu to %lluus ok.\n",
+                                 (unsigned long long)start, (unsigned long long)last);
+    
+    return 0;
+}
+
+/**
+ * @brief     trace test close the opened displays
+ * @param[in] num is the opened display number
+ * @note      none
+ */
+static void a_trace_test_close(uint8_t num)
+{
+    while (num != 0)
+    {
+        num--;
+        (void)tm1637_deinit(&gs_handle[num]);
+    }
+}
+
+/**
+ * @brief     trace test
+ * @param[in] **ctx points to a bus context array, display i is on ctx[i] and bus i
+ * @param[in] num is the display number
+ * @param[in] bit_us is the modelled bus clock period of the export, 0 uses the timestamps
+ * @param[in] times is the test times
+ * @param[in] *write points to a stream write function of the export, NULL skips the export
+ * @param[in] *file is the stream context
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      it checks the events of display 0 against the modelled bus time,
+ *            then streams times rounds of writes and key reads on every display to the stream
+ */
+uint8_t tm1637_trace_test(void **ctx, uint8_t num, uint32_t bit_us, uint32_t times,
+                          uint8_t (*write)(void *file, const char *buf, uint16_t len), void *file)
+{
+    uint8_t res;
+    uint8_t i;
+    uint8_t j;
+    uint32_t t;
+    uint32_t calls;
+    uint32_t events;
+    uint32_t dropped;
+    uint32_t start;
+    uint32_t us;
+    
+    /* check the display number */
+    if ((ctx == NULL) || (num == 0) || (num > TM1637_TRACE_TEST_MAX_DISPLAY))
+    {
+        tm1637_interface_debug_print("tm1637: display number is invalid.\n");
+        
+        return 1;
+    }
+    
+    /* start trace test */
+    tm1637_interface_debug_print("tm1637: start trace test.\n");
+    
+    /* open every display */
+    for (i = 0; i < num; i++)
+    {
+        DRIVER_TM1637_LINK_INIT(&gs_handle[i], tm1637_handle_t);
+        DRIVER_TM1637_LINK_OPS(&gs_handle[i], &gc_ops);
+        DRIVER_TM1637_LINK_CTX(&gs_handle[i], ctx[i]);
+        DRIVER_TM1637_LINK_DEBUG_PRINT(&gs_handle[i], tm1637_interface_debug_print);
+        res = tm1637_init(&gs_handle[i]);
+        if (res != 0)
+        {
+            tm1637_interface_debug_print("tm1637: display %d init failed.\n", i);
+            a_trace_test_close(i);
+            
+            return 1;
+        }
+    }
+    
+    /* check the events */
+    tm1637_interface_debug_print("tm1637: trace check test.\n");
+    if (a_trace_test_check() != 0)
+    {
+        a_trace_test_close(num);
+        
+        return 1;
+    }
+    
+    /* check the wrap */
+    tm1637_interface_debug_print("tm1637: trace wrap test.\n");
+    if (a_trace_test_wrap() != 0)
+    {
+        a_trace_test_close(num);
+        
+        return 1;
+    }
+    
+    /* stream a long capture */
+    if (write != NULL)
+    {
+        tm1637_interface_debug_print("tm1637: trace export test.\n");
+        gs_write = write;
+        gs_bytes = 0;
+        gs_max_len = 0;
+        if (tm1637_trace_init(&gs_trace, a_trace_test_stream, file) != 0)
+        {
+            tm1637_interface_debug_print("tm1637: trace init failed.\n");
+            a_trace_test_close(num);
+            
+            return 1;
+        }
+        (void)tm1637_trace_set_bus_model(&gs_trace, bit_us);
+        for (i = 0; i < num; i++)
+        {
+            if (tm1637_trace_attach(&gs_trace, &gs_track[i], &gs_handle[i], i, i) != 0)
+            {
+                tm1637_interface_debug_print("tm1637: display %d trace attach failed.\n", i);
+                a_trace_test_close(num);
+                
+                return 1;
+            }
+        }
+        calls = 0;
+        start = tm1637_interface_timestamp_us();
+        for (t = 0; t < times; t++)
+        {
+            for (i = 0; i < num; i++)
+            {
+                uint8_t data[6];
+                uint8_t seg;
+                uint8_t k;
+                
+                for (j = 0; j < 6; j++)
+                {
+                    data[j] = gsc_number[(t + i + j) % 10];
+                }
+                res = tm1637_write_segment(&gs_handle[i], 0x00, data, 6);
+                res |= tm1637_set_pulse_width(&gs_handle[i], (tm1637_pulse_width_t)((t + i) % 8));
+                res |= tm1637_set_display(&gs_handle[i], TM1637_BOOL_TRUE);
+                res |= tm1637_read_segment(&gs_handle[i], &seg, &k);
+                if (res != 0)
+                {
+                    tm1637_interface_debug_print("tm1637: display %d traced call failed.\n", i);
+                    a_trace_test_close(num);
+                    
+                    return 1;
+                }
+                calls += 4;
+            }
+        }
+        us = tm1637_interface_timestamp_us() - start;
+        for (i = 0; i < num; i++)
+        {
+            (void)tm1637_set_trace(&gs_handle[i], NULL, NULL, NULL);
+        }
+        (void)tm1637_trace_get_statistics(&gs_trace, &events, &dropped);
+        if ((tm1637_trace_deinit(&gs_trace) != 0) || (dropped != 0))
+        {
+            tm1637_interface_debug_print("tm1637: trace stream failed, %d events dropped.\n", dropped);
+            a_trace_test_close(num);
+            
+            return 1;
+        }
+        tm1637_interface_debug_print("tm1637: %d displays %d calls in %dus, %s bus time.\n",
+                                     num, calls, us, (bit_us != 0) ? "modelled" : "measured");
+        tm1637_interface_debug_print("tm1637: %d events %d bytes streamed, the longest write is %d bytes.\n",
+                                     events, gs_bytes, gs_max_len);
+    }
+    
+    /* finish trace test */
+    tm1637_interface_debug_print("tm1637: finish trace test.\n");
+    a_trace_test_close(num);
+    
+    return 0;
+}
@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_trace_test.h
+ * @brief     driver tm1637 trace test header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef DRIVER_TM1637_TRACE_TEST_H
+#define DRIVER_TM1637_TRACE_TEST_H
+
+#include "driver_tm1637_interface.h"
+#include "driver_tm1637_trace.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @addtogroup tm1637_test_driver
+ * @{
+ */
+
+/**
+ * @brief tm1637 trace test max display definition
+ */
+#define TM1637_TRACE_TEST_MAX_DISPLAY        16        /**< 16 displays */
+
+/**
+ * @brief     trace test
+ * @param[in] **ctx points to a bus context array, display i is on ctx[i] and bus i
+ * @param[in] num is the display number
+ * @param[in] bit_us is the modelled bus clock period of the export, 0 uses the timestamps
+ * @param[in] times is the test times
+ * @param[in] *write points to a stream write function of the export, NULL skips the export
+ * @param[in] *file is the stream context
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      it checks the events of display 0 against the modelled bus time,
+ *            then streams times rounds of writes and key reads on every display to the stream
+ */
+uint8_t tm1637_trace_test(void **ctx, uint8_t num, uint32_t bit_us, uint32_t times,
+                          uint8_t (*write)(void *file, const char *buf, uint16_t len), void *file);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,476 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_tm1637_vdisplay_test.c
+ * @brief     driver tm1637 vdisplay test source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2024-03-31
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2024/03/31  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+#include "driver_tm1637_vdisplay_test.h"
+#include "driver_tm1637_vdisplay.h"
+#include <string.h>
+
+#define VDISPLAY_TEST_LOG         16            /**< max logged transactions */
+#define VDISPLAY_TEST_NONE        0xFF          /**< no module fails */
+
+static tm1637_handle_t gs_handle[2];                      /**< tm1637 handle of each module */
+#if (TM1637_LINK_FUNCTION == 0)
+static tm1637_link_t gs_link[2];                          /**< tm1637 link of each module */
+#endif
+static tm1637_vdisplay_t gs_vdisplay;                     /**< tm1637 virtual display */
+static uint8_t gs_ram[2][6];                              /**< chip ram of each module seen on the bus */
+static uint8_t gs_log_id[VDISPLAY_TEST_LOG];              /**< module of each logged transaction */
+static uint8_t gs_log_cmd[VDISPLAY_TEST_LOG];             /**< command byte of each logged transaction */
+static uint8_t gs_log_len[VDISPLAY_TEST_LOG];             /**< payload length of each logged transaction */
+static uint8_t gs_log_num;                                /**< logged transaction number */
+static uint8_t gs_fail_id;                                /**< module whose digit writes fail */
+
+/**
+ * @brief     vdisplay test reverse a byte sent lsb first
+ * @param[in] data is the byte as sent
+ * @return    byte msb first like the datasheet
+ * @note      none
+ */
+static uint8_t a_vdisplay_test_reverse(uint8_t data)
+{
+    uint8_t res = 0;
+    uint8_t i;
+    
+    for (i = 0; i < 8; i++)
+    {
+        res = (uint8_t)((res << 1) | ((data >> i) & 0x01));
+    }
+    
+    return res;
+}
+
+/**
+ * @brief     vdisplay test log a write and update the chip ram
+ * @param[in] id is the module index
+ * @param[in] addr is the command byte
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 the digit write fails on purpose
+ * @note      none
+ */
+static uint8_t a_vdisplay_test_log(uint8_t id, uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    uint8_t cmd;
+    uint8_t pos;
+    uint16_t i;
+    
+    cmd = a_vdisplay_test_reverse(addr);
+    if (gs_log_num < VDISPLAY_TEST_LOG)
+    {
+        gs_log_id[gs_log_num] = id;
+        gs_log_cmd[gs_log_num] = cmd;
+        gs_log_len[gs_log_num] = (uint8_t)len;
+    }
+    gs_log_num++;
+    if ((cmd & 0xC0) == 0xC0)
+    {
+        if (id == gs_fail_id)
+        {
+            return 1;
+        }
+        pos = cmd & 0x07;
+        for (i = 0; (i < len) && (pos < 6); i++)
+        {
+            gs_ram[id][pos] = a_vdisplay_test_reverse(buf[i]);
+            pos++;
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     vdisplay test write of module 0
+ * @param[in] addr is the command byte
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic write failed
+ * @note      module 0 owns the iic port
+ */
+static uint8_t a_vdisplay_test_write0(uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    if (a_vdisplay_test_log(0, addr, buf, len) != 0)
+    {
+        return 1;
+    }
+    
+    return tm1637_interface_iic_write_cmd_custom(addr, buf, len);
+}
+
+/**
+ * @brief     vdisplay test write of module 1
+ * @param[in] addr is the command byte
+ * @param[in] *buf points to a data buffer
+ * @param[in] len is the length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic write failed
+ * @note      module 1 is only logged
+ */
+static uint8_t a_vdisplay_test_write1(uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    return a_vdisplay_test_log(1, addr, buf, len);
+}
+
+/**
+ * @brief  vdisplay test iic init and deinit of module 1
+ * @return status code
+ *         - 0 success
+ * @note   none
+ */
+static uint8_t a_vdisplay_test_iic_none(void)
+{
+    return 0;
+}
+
+/**
+ * @brief     vdisplay test check the logged transactions
+ * @param[in] *name points to the check name
+ * @param[in] *id points to the expected module indexes
+ * @param[in] *cmd points to the expected command bytes
+ * @param[in] *len points to the expected payload lengths
+ * @param[in] num is the expected transaction number
+ * @return    status code
+ *            - 0 success
+ *            - 1 check failed
+ * @note      the log is cleared after the check
+ */
+static uint8_t a_vdisplay_test_check(const char *name, const uint8_t *id, const uint8_t *cmd, const uint8_t *len, uint8_t num)
+{
+    uint8_t i;
+    
+    if (gs_log_num != num)
+    {
+        tm1637_interface_debug_print("tm1637: %s sent %d transactions instead of %d.\n", name, gs_log_num, num);
+        gs_log_num = 0;
+        
+        return 1;
+    }
+    for (i = 0; i < num; i++)
+    {
+        if ((gs_log_id[i] != id[i]) || (gs_log_cmd[i] != cmd[i]) || (gs_log_len[i] != len[i]))
+        {
+            tm1637_interface_debug_print("tm1637: %s transaction %d is module %d 0x%02X len %d instead of module %d 0x%02X len %d.\n",
+                                         name, i, gs_log_id[i], gs_log_cmd[i], gs_log_len[i], id[i], cmd[i], len[i]);
+            gs_log_num = 0;
+            
+            return 1;
+        }
+    }
+    gs_log_num = 0;
+    
+    return 0;
+}
+
+/**
+ * @brief     vdisplay test check the chip ram of a module
+ * @param[in] *name points to the check name
+ * @param[in] id is the module index
+ * @param[in] *ram points to the expected chip ram
+ * @return    status code
+ *            - 0 success
+ *            - 1 check failed
+ * @note      none
+ */
+static uint8_t a_vdisplay_test_ram(const char *name, uint8_t id, const uint8_t *ram)
+{
+    if (memcmp(gs_ram[id], ram, 6) != 0)
+    {
+        tm1637_interface_debug_print("tm1637: %s module %d ram is %02X %02X %02X %02X %02X %02X.\n", name, id,
+                                     gs_ram[id][0], gs_ram[id][1], gs_ram[id][2],
+                                     gs_ram[id][3], gs_ram[id][4], gs_ram[id][5]);
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  vdisplay test the modules and the text
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   none
+ */
+static uint8_t a_vdisplay_test_text(void)
+{
+    const uint8_t map[6] = {5, 4, 3, 2, 1, 0};
+    const uint8_t bad[2] = {1, 1};
+    const uint8_t id0[4] = {0, 0, 1, 1};
+    const uint8_t cmd0[4] = {0x40, 0xC0, 0x40, 0xC0};
+    const uint8_t len0[4] = {0, 4, 0, 6};
+    const uint8_t ram00[6] = {0x06, 0xDB, 0xCF, 0x66, 0x00, 0x00};
+    const uint8_t ram01[6] = {0x76, 0x00, 0x7C, 0x80, 0xF7, 0x80};
+    uint8_t digits;
+    
+    /* four digits left to right, then six digits wired right to left on another bus */
+    if ((tm1637_vdisplay_init(&gs_vdisplay) != 0) ||
+        (tm1637_vdisplay_add_module(&gs_vdisplay, &gs_handle[0], 4, NULL, 0) != 0) ||
+        (tm1637_vdisplay_add_module(&gs_vdisplay, &gs_handle[1], 6, map, 1) != 0))
+    {
+        tm1637_interface_debug_print("tm1637: vdisplay add module failed.\n");
+        
+        return 1;
+    }
+    if ((tm1637_vdisplay_add_module(&gs_vdisplay, &gs_handle[1], 0, NULL, 1) != 4) ||
+        (tm1637_vdisplay_add_module(&gs_vdisplay, &gs_handle[1], 2, bad, 1) != 4) ||
+        (tm1637_vdisplay_add_module(&gs_vdisplay, &gs_handle[1], 2, NULL, TM1637_VDISPLAY_BUS_ALL) != 4))
+    {
+        tm1637_interface_debug_print("tm1637: vdisplay module check failed.\n");
+        
+        return 1;
+    }
+    if ((tm1637_vdisplay_get_digits(&gs_vdisplay, &digits) != 0) || (digits != 10))
+    {
+        tm1637_interface_debug_print("tm1637: vdisplay has %d digits instead of 10.\n", digits);
+        
+        return 1;
+    }
+    
+    /* a '.' merges into the previous digit once, a leading or a second '.' takes a digit of its own,
+       lower case uses the upper case glyph, a character without a glyph is blank and the rest is cut */
+    if ((tm1637_vdisplay_print_text(&gs_vdisplay, 0, "12.3.4") != 0) ||
+        (tm1637_vdisplay_print_text(&gs_vdisplay, 4, ".a..b~") != 0) ||
+        (tm1637_vdisplay_print_text(&gs_vdisplay, 9, "xyz") != 0))
+    {
+        tm1637_interface_debug_print("tm1637: vdisplay print text failed.\n");
+        
+        return 1;
+    }
+    gs_log_num = 0;
+    if ((tm1637_vdisplay_flush(&gs_vdisplay, TM1637_VDISPLAY_BUS_ALL) != 0) ||
+        (a_vdisplay_test_check("first flush", id0, cmd0, len0, 4) != 0) ||
+        (a_vdisplay_test_ram("first flush", 0, ram00) != 0) || (a_vdisplay_test_ram("first flush", 1, ram01) != 0))
+    {
+        return 1;
+    }
+    
+    /* nothing changed, nothing is sent */
+    if ((tm1637_vdisplay_flush(&gs_vdisplay, TM1637_VDISPLAY_BUS_ALL) != 0) ||
+        (a_vdisplay_test_check("idle flush", NULL, NULL, NULL, 0) != 0))
+    {
+        return 1;
+    }
+    tm1637_interface_debug_print("tm1637: check text ok.\n");
+    
+    return 0;
+}
+
+/**
+ * @brief  vdisplay test the numbers and the flush masks
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   it runs after the text test
+ */
+static uint8_t a_vdisplay_test_flush(void)
+{
+    const uint8_t id0[2] = {0, 0};
+    const uint8_t cmd0[2] = {0x40, 0xC2};
+    const uint8_t len0[2] = {0, 2};
+    const uint8_t id1[3] = {1, 1, 1};
+    const uint8_t cmd1[3] = {0x40, 0xC0, 0xC5};
+    const uint8_t len1[3] = {0, 1, 1};
+    const uint8_t cmd2[2] = {0x40, 0xC0};
+    const uint8_t len2[2] = {0, 3};
+    const uint8_t id3[4] = {0, 0, 1, 1};
+    const uint8_t cmd3[4] = {0x40, 0xC0, 0x40, 0xC5};
+    const uint8_t len3[4] = {0, 1, 0, 1};
+    const uint8_t id4[2] = {1, 1};
+    const uint8_t cmd4[2] = {0x40, 0xC5};
+    const uint8_t len4[2] = {0, 1};
+    const uint8_t ram00[6] = {0x40, 0x06, 0x5B, 0x07, 0x00, 0x00};
+    const uint8_t ram01[6] = {0x06, 0x00, 0x7C, 0x80, 0xF7, 0x3F};
+    const uint8_t ram10[6] = {0x7F, 0x06, 0x5B, 0x07, 0x00, 0x00};
+    const uint8_t ram11[6] = {0x06, 0x00, 0x7C, 0x80, 0xF7, 0x7F};
+    uint8_t data[2] = {0x3F, 0x06};
+    
+    /* a number right aligned in two digits changes one contiguous run */
+    if ((tm1637_vdisplay_print_number(&gs_vdisplay, 2, 2, 7) != 0) ||
+        (tm1637_vdisplay_flush(&gs_vdisplay, TM1637_VDISPLAY_BUS_ALL) != 0) ||
+        (a_vdisplay_test_check("number", id0, cmd0, len0, 2) != 0))
+    {
+        return 1;
+    }
+    
+    /* both ends of the reversed module change, only its bus is flushed and the two runs share the data command */
+    if ((tm1637_vdisplay_write(&gs_vdisplay, 4, &data[0], 1) != 0) ||
+        (tm1637_vdisplay_write(&gs_vdisplay, 9, &data[1], 1) != 0) ||
+        (tm1637_vdisplay_flush(&gs_vdisplay, 0) != 0) ||
+        (a_vdisplay_test_check("other bus", NULL, NULL, NULL, 0) != 0) ||
+        (tm1637_vdisplay_flush(&gs_vdisplay, 1) != 0) ||
+        (a_vdisplay_test_check("two runs", id1, cmd1, len1, 3) != 0))
+    {
+        return 1;
+    }
+    
+    /* a number over the field is refused and dashed, a negative number takes a sign */
+    if ((tm1637_vdisplay_print_number(&gs_vdisplay, 0, 2, 123) != 5) ||
+        (tm1637_vdisplay_print_number(&gs_vdisplay, 0, 3, -12) != 0) ||
+        (tm1637_vdisplay_flush(&gs_vdisplay, TM1637_VDISPLAY_BUS_ALL) != 0) ||
+        (a_vdisplay_test_check("negative", id0, cmd2, len2, 2) != 0) ||
+        (a_vdisplay_test_ram("negative", 0, ram00) != 0) || (a_vdisplay_test_ram("negative", 1, ram01) != 0))
+    {
+        return 1;
+    }
+    
+    /* the range checks */
+    if ((tm1637_vdisplay_write(&gs_vdisplay, 9, data, 2) != 4) ||
+        (tm1637_vdisplay_print_text(&gs_vdisplay, 10, "1") != 4) ||
+        (tm1637_vdisplay_print_number(&gs_vdisplay, 8, 3, 1) != 4) ||
+        (tm1637_vdisplay_print_number(&gs_vdisplay, 0, 0, 1) != 4))
+    {
+        tm1637_interface_debug_print("tm1637: vdisplay range check failed.\n");
+        
+        return 1;
+    }
+    
+    /* a failed module does not stop the others and is sent again by the next flush */
+    gs_fail_id = 1;
+    if ((tm1637_vdisplay_print_text(&gs_vdisplay, 0, "8") != 0) ||
+        (tm1637_vdisplay_print_text(&gs_vdisplay, 4, "8") != 0) ||
+        (tm1637_vdisplay_flush(&gs_vdisplay, TM1637_VDISPLAY_BUS_ALL) != 1) ||
+        (a_vdisplay_test_check("failed flush", id3, cmd3, len3, 4) != 0))
+    {
+        gs_fail_id = VDISPLAY_TEST_NONE;
+        
+        return 1;
+    }
+    gs_fail_id = VDISPLAY_TEST_NONE;
+    if ((tm1637_vdisplay_flush(&gs_vdisplay, TM1637_VDISPLAY_BUS_ALL) != 0) ||
+        (a_vdisplay_test_check("retry", id4, cmd4, len4, 2) != 0) ||
+        (a_vdisplay_test_ram("retry", 0, ram10) != 0) || (a_vdisplay_test_ram("retry", 1, ram11) != 0))
+    {
+        return 1;
+    }
+    tm1637_interface_debug_print("tm1637: check flush masks ok.\n");
+    
+    return 0;
+}
+
+/**
+ * @brief  vdisplay test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   it spans a virtual display over two modules, one of them wired right to left, and checks the text,
+ *         the merged '.', the numbers, the range checks and the transactions and chip ram of every flush
+ */
+uint8_t tm1637_vdisplay_test(void)
+{
+    uint8_t res;
+    
+    /* link interface function */
+    DRIVER_TM1637_LINK_INIT(&gs_handle[0], tm1637_handle_t);
+#if (TM1637_LINK_FUNCTION == 0)
+    DRIVER_TM1637_LINK_FUNCTION(&gs_handle[0], &gs_link[0]);
+#endif
+    DRIVER_TM1637_LINK_IIC_INIT(&gs_handle[0], tm1637_interface_iic_init);
+    DRIVER_TM1637_LINK_IIC_DEINIT(&gs_handle[0], tm1637_interface_iic_deinit);
+    DRIVER_TM1637_LINK_IIC_WRITE_COMMAND_CUSTOM(&gs_handle[0], a_vdisplay_test_write0);
+    DRIVER_TM1637_LINK_IIC_READ_COMMAND_CUSTOM(&gs_handle[0], tm1637_interface_iic_read_cmd_custom);
+    DRIVER_TM1637_LINK_DELAY_MS(&gs_handle[0], tm1637_interface_delay_ms);
+    DRIVER_TM1637_LINK_DEBUG_PRINT(&gs_handle[0], tm1637_interface_debug_print);
+    DRIVER_TM1637_LINK_TIMESTAMP_US(&gs_handle[0], tm1637_interface_timestamp_us);
+    DRIVER_TM1637_LINK_LOCK(&gs_handle[0], tm1637_interface_lock);
+    DRIVER_TM1637_LINK_UNLOCK(&gs_handle[0], tm1637_interface_unlock);
+    DRIVER_TM1637_LINK_INIT(&gs_handle[1], tm1637_handle_t);
+#if (TM1637_LINK_FUNCTION == 0)
+    DRIVER_TM1637_LINK_FUNCTION(&gs_handle[1], &gs_link[1]);
+#endif
+    DRIVER_TM1637_LINK_IIC_INIT(&gs_handle[1], a_vdisplay_test_iic_none);
+    DRIVER_TM1637_LINK_IIC_DEINIT(&gs_handle[1], a_vdisplay_test_iic_none);
+    DRIVER_TM1637_LINK_IIC_WRITE_COMMAND_CUSTOM(&gs_handle[1], a_vdisplay_test_write1);
+    DRIVER_TM1637_LINK_IIC_READ_COMMAND_CUSTOM(&gs_handle[1], tm1637_interface_iic_read_cmd_custom);
+    DRIVER_TM1637_LINK_DELAY_MS(&gs_handle[1], tm1637_interface_delay_ms);
+    DRIVER_TM1637_LINK_DEBUG_PRINT(&gs_handle[1], tm1637_interface_debug_print);
+    DRIVER_TM1637_LINK_TIMESTAMP_US(&gs_handle[1], tm1637_interface_timestamp_us);
+    DRIVER_TM1637_LINK_LOCK(&gs_handle[1], tm1637_interface_lock);
+    DRIVER_TM1637_LINK_UNLOCK(&gs_handle[1], tm1637_interface_unlock);
+    gs_fail_id = VDISPLAY_TEST_NONE;
+    memset(gs_ram, 0, sizeof(gs_ram));
+    
+    /* start vdisplay test */
+    tm1637_interface_debug_print("tm1637: start vdisplay test.\n");
+    
+    /* tm1637 init */
+    res = tm1637_init(&gs_handle[0]);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: init failed.\n");
+        
+        return 1;
+    }
+    res = tm1637_init(&gs_handle[1]);
+    if (res != 0)
+    {
+        tm1637_interface_debug_print("tm1637: init failed.\n");
+        (void)tm1637_deinit(&gs_handle[0]);
+        
+        return 1;
+    }
+    
+    /* text */
+    tm1637_interface_debug_print("tm1637: vdisplay text test.\n");
+    if (a_vdisplay_test_text() != 0)
+    {
+        (void)tm1637_deinit(&gs_handle[0]);
+        (void)tm1637_deinit(&gs_handle[1]);
+        
+        return 1;
+    }
+    
+    /* flush */
+    tm1637_interface_debug_print("tm1637: vdisplay flush test.\n");
+    if (a_vdisplay_test_flush() != 0)
+    {
+        (void)tm1637_deinit(&gs_handle[0]);
+        (void)tm1637_deinit(&gs_handle[1]);
+        
+        return 1;
+    }
+    
+    /* finish vdisplay test */
+    tm1637_interface_debug_print("tm1637: finish vdisplay test.\n");
+    (void)tm1637_deinit(&gs_handle[0]);
+    (void)tm1637_deinit(&gs_handle[1]);
+    
+    return 0;
+}